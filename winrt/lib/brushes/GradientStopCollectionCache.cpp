@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "GradientStopCollectionCache.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Brushes
+{
+    bool GradientStopCollectionCache::Key::operator==(Key const& other) const
+    {
+        if (PreInterpolationSpace != other.PreInterpolationSpace ||
+            PostInterpolationSpace != other.PostInterpolationSpace ||
+            BufferPrecision != other.BufferPrecision ||
+            ExtendMode != other.ExtendMode ||
+            InterpolationMode != other.InterpolationMode ||
+            Stops.size() != other.Stops.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < Stops.size(); ++i)
+        {
+            auto& a = Stops[i];
+            auto& b = other.Stops[i];
+
+            if (a.position != b.position ||
+                a.color.r != b.color.r ||
+                a.color.g != b.color.g ||
+                a.color.b != b.color.b ||
+                a.color.a != b.color.a)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    GradientStopCollectionCache::GradientStopCollectionCache(uint32_t maximumEntryCount)
+        : m_maximumEntryCount(maximumEntryCount)
+        , m_hitCount(0)
+        , m_missCount(0)
+        , m_evictionCount(0)
+    {
+    }
+
+
+    uint32_t GradientStopCollectionCache::GetMaximumEntryCount()
+    {
+        Lock lock(m_mutex);
+        return m_maximumEntryCount;
+    }
+
+
+    void GradientStopCollectionCache::SetMaximumEntryCount(uint32_t value)
+    {
+        Lock lock(m_mutex);
+        m_maximumEntryCount = value;
+        EvictTo(m_maximumEntryCount);
+    }
+
+
+    CanvasGradientStopCollectionCacheStatistics GradientStopCollectionCache::GetStatistics()
+    {
+        Lock lock(m_mutex);
+
+        CanvasGradientStopCollectionCacheStatistics statistics{};
+        statistics.HitCount = m_hitCount;
+        statistics.MissCount = m_missCount;
+        statistics.EvictionCount = m_evictionCount;
+        statistics.EntryCount = static_cast<uint32_t>(m_entries.size());
+        return statistics;
+    }
+
+
+    void GradientStopCollectionCache::Clear()
+    {
+        EntryList entries;
+
+        {
+            Lock lock(m_mutex);
+            entries.swap(m_entries);
+            m_index.clear();
+        }
+
+        // The stop collections are released here, outside the lock.
+    }
+
+
+    uint64_t GradientStopCollectionCache::GetHash(Key const& key)
+    {
+        // 64 bit FNV-1a.
+        const uint64_t offsetBasis = 14695981039346656037ull;
+        const uint64_t prime = 1099511628211ull;
+
+        uint64_t hash = offsetBasis;
+
+        auto combine = [&](void const* data, size_t size)
+        {
+            auto bytes = static_cast<uint8_t const*>(data);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= prime;
+            }
+        };
+
+        // Adding zero turns -0 into +0, since the two compare equal.
+        auto combineFloat = [&](float value)
+        {
+            value += 0.0f;
+            combine(&value, sizeof(value));
+        };
+
+        combine(&key.PreInterpolationSpace, sizeof(key.PreInterpolationSpace));
+        combine(&key.PostInterpolationSpace, sizeof(key.PostInterpolationSpace));
+        combine(&key.BufferPrecision, sizeof(key.BufferPrecision));
+        combine(&key.ExtendMode, sizeof(key.ExtendMode));
+        combine(&key.InterpolationMode, sizeof(key.InterpolationMode));
+
+        for (auto& stop : key.Stops)
+        {
+            combineFloat(stop.position);
+            combineFloat(stop.color.r);
+            combineFloat(stop.color.g);
+            combineFloat(stop.color.b);
+            combineFloat(stop.color.a);
+        }
+
+        return hash;
+    }
+
+
+    ComPtr<ID2D1GradientStopCollection1> GradientStopCollectionCache::TryGet(uint64_t hash, Key const& key)
+    {
+        Lock lock(m_mutex);
+
+        auto entry = Find(hash, key);
+
+        if (entry == m_entries.end())
+        {
+            ++m_missCount;
+            return nullptr;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+
+        ++m_hitCount;
+        return entry->StopCollection;
+    }
+
+
+    ComPtr<ID2D1GradientStopCollection1> GradientStopCollectionCache::Add(
+        uint64_t hash,
+        Key&& key,
+        ComPtr<ID2D1GradientStopCollection1> const& stopCollection)
+    {
+        Lock lock(m_mutex);
+
+        // Another thread may have added the same collection in the meantime.
+        auto existing = Find(hash, key);
+
+        if (existing != m_entries.end())
+        {
+            m_entries.splice(m_entries.begin(), m_entries, existing);
+            return existing->StopCollection;
+        }
+
+        m_entries.push_front(Entry{ hash, std::move(key), stopCollection });
+        m_index.emplace(hash, m_entries.begin());
+
+        EvictTo(m_maximumEntryCount);
+
+        return stopCollection;
+    }
+
+
+    GradientStopCollectionCache::EntryList::iterator GradientStopCollectionCache::Find(uint64_t hash, Key const& key)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(hash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            if (it->second->EntryKey == key)
+                return it->second;
+        }
+
+        return m_entries.end();
+    }
+
+
+    void GradientStopCollectionCache::Remove(EntryList::iterator entry)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(entry->Hash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            if (it->second == entry)
+            {
+                m_index.erase(it);
+                break;
+            }
+        }
+
+        m_entries.erase(entry);
+    }
+
+
+    void GradientStopCollectionCache::EvictTo(uint32_t maximumEntryCount)
+    {
+        // Caller must hold m_mutex.
+
+        while (m_entries.size() > maximumEntryCount)
+        {
+            Remove(std::prev(m_entries.end()));
+            ++m_evictionCount;
+        }
+    }
+}}}}}
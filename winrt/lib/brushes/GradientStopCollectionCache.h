@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Brushes
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // Keeps the ID2D1GradientStopCollections created for gradient brushes,
+    // so that apps creating brushes with the same stops over and over (for
+    // example, one per chart series per frame) share a single collection
+    // rather than allocating a new one each time.
+    //
+    // Stop collections can't be modified once created, so sharing them
+    // between brushes is invisible to apps.  Collections are looked up by the
+    // full contents of their stops and creation options; a hash of these is
+    // only used to find the candidates to compare.
+    //
+    // The cache is shared by everything that creates brushes on a device, so
+    // it may be used from several threads at once.  It is disabled until a
+    // maximum entry count is set, and evicts entries in least-recently-used
+    // order once there are more than that.  IsEnabled doesn't take the lock,
+    // so while the cache is disabled (the default) creating a brush pays a
+    // single atomic load.
+    //
+    class GradientStopCollectionCache
+    {
+    public:
+        static const uint32_t DefaultMaximumEntryCount = 0;
+
+        struct Key
+        {
+            std::vector<D2D1_GRADIENT_STOP> Stops;
+            D2D1_COLOR_SPACE PreInterpolationSpace;
+            D2D1_COLOR_SPACE PostInterpolationSpace;
+            D2D1_BUFFER_PRECISION BufferPrecision;
+            D2D1_EXTEND_MODE ExtendMode;
+            D2D1_COLOR_INTERPOLATION_MODE InterpolationMode;
+
+            bool operator==(Key const& other) const;
+        };
+
+    private:
+        struct Entry
+        {
+            uint64_t Hash;
+            Key EntryKey;
+            ComPtr<ID2D1GradientStopCollection1> StopCollection;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_mutex;
+
+        // Most recently used at the front.
+        EntryList m_entries;
+
+        // Indexes m_entries by hash.  Different keys may have the same hash,
+        // so lookups compare each candidate in full.
+        std::unordered_multimap<uint64_t, EntryList::iterator> m_index;
+
+        // Only changed while holding m_mutex, but read without it to
+        // quickly reject requests when the cache is disabled.
+        std::atomic<uint32_t> m_maximumEntryCount;
+
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+        uint64_t m_evictionCount;
+
+    public:
+        GradientStopCollectionCache(uint32_t maximumEntryCount = DefaultMaximumEntryCount);
+
+        GradientStopCollectionCache(GradientStopCollectionCache const&) = delete;
+        GradientStopCollectionCache& operator=(GradientStopCollectionCache const&) = delete;
+
+        bool IsEnabled()
+        {
+            return m_maximumEntryCount.load(std::memory_order_relaxed) != 0;
+        }
+
+        //
+        // Returns the cached stop collection matching the key, or calls
+        // createFn to make a new one and adds that to the cache.  When the
+        // cache is disabled this just calls createFn.
+        //
+        template<typename FN>
+        ComPtr<ID2D1GradientStopCollection1> GetOrCreate(Key&& key, FN&& createFn)
+        {
+            if (!IsEnabled())
+                return createFn(key);
+
+            auto hash = GetHash(key);
+
+            if (auto stopCollection = TryGet(hash, key))
+                return stopCollection;
+
+            // Creating the collection is done without holding the lock.
+            ComPtr<ID2D1GradientStopCollection1> stopCollection = createFn(key);
+
+            return Add(hash, std::move(key), stopCollection);
+        }
+
+        uint32_t GetMaximumEntryCount();
+        void SetMaximumEntryCount(uint32_t value);
+
+        CanvasGradientStopCollectionCacheStatistics GetStatistics();
+
+        // Releases all cached stop collections.
+        void Clear();
+
+        static uint64_t GetHash(Key const& key);
+
+    private:
+        ComPtr<ID2D1GradientStopCollection1> TryGet(uint64_t hash, Key const& key);
+
+        ComPtr<ID2D1GradientStopCollection1> Add(
+            uint64_t hash,
+            Key&& key,
+            ComPtr<ID2D1GradientStopCollection1> const& stopCollection);
+
+        EntryList::iterator Find(uint64_t hash, Key const& key);
+
+        void Remove(EntryList::iterator entry);
+        void EvictTo(uint32_t maximumEntryCount);
+    };
+}}}}}
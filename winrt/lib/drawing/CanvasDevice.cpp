@@ -451,6 +451,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         , m_dxgiDevice(dxgiDevice)
         , m_sharedState(SharedDeviceState::GetInstance())
         , m_deviceContextPool(d2dDevice)
+        , m_stagingBitmapCache(std::make_shared<StagingBitmapCache>())
+        , m_textLayoutCache(std::make_shared<Text::TextLayoutCache>())
+        , m_geometryRealizationCache(std::make_shared<Geometry::GeometryRealizationCache>())
+        , m_gradientStopCollectionCache(std::make_shared<Brushes::GradientStopCollectionCache>())
 #if WINVER > _WIN32_WINNT_WINBLUE
         , m_spriteBatchQuirk(SpriteBatchQuirk::NeedsCheck)
 #endif
@@ -633,6 +637,202 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             });
     }
 
+    IFACEMETHODIMP CanvasDevice::get_MaximumDeviceContextPoolSize(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // this ensures that Close() hasn't been called
+
+                *value = static_cast<int32_t>(m_deviceContextPool.GetMaximumSize());
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_MaximumDeviceContextPoolSize(int32_t value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();  // this ensures that Close() hasn't been called
+
+                if (value < 0)
+                    ThrowHR(E_INVALIDARG);
+
+                m_deviceContextPool.SetMaximumSize(static_cast<uint32_t>(value));
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_DeviceContextPoolStatistics(CanvasDeviceContextPoolStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_deviceContextPool.GetStatistics();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumStagingBitmapCacheSize(UINT64* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // this ensures that Close() hasn't been called
+
+                *value = m_stagingBitmapCache->GetMaximumSize();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_MaximumStagingBitmapCacheSize(UINT64 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();  // this ensures that Close() hasn't been called
+
+                m_stagingBitmapCache->SetMaximumSize(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_StagingBitmapCacheStatistics(CanvasStagingBitmapCacheStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_stagingBitmapCache->GetStatistics();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumTextLayoutCacheEntryCount(UINT32* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // this ensures that Close() hasn't been called
+
+                *value = m_textLayoutCache->GetMaximumEntryCount();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_MaximumTextLayoutCacheEntryCount(UINT32 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();  // this ensures that Close() hasn't been called
+
+                m_textLayoutCache->SetMaximumEntryCount(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumTextLayoutCacheSize(UINT64* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // this ensures that Close() hasn't been called
+
+                *value = m_textLayoutCache->GetMaximumSize();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_MaximumTextLayoutCacheSize(UINT64 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();  // this ensures that Close() hasn't been called
+
+                m_textLayoutCache->SetMaximumSize(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_TextLayoutCacheStatistics(CanvasTextLayoutCacheStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_textLayoutCache->GetStatistics();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumGeometryRealizationCacheSize(UINT64* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // this ensures that Close() hasn't been called
+
+                *value = m_geometryRealizationCache->GetMaximumSize();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_MaximumGeometryRealizationCacheSize(UINT64 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();  // this ensures that Close() hasn't been called
+
+                m_geometryRealizationCache->SetMaximumSize(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_GeometryRealizationCacheStatistics(CanvasGeometryRealizationCacheStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_geometryRealizationCache->GetStatistics();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_MaximumGradientStopCollectionCacheEntryCount(UINT32* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                GetResource();  // this ensures that Close() hasn't been called
+
+                *value = m_gradientStopCollectionCache->GetMaximumEntryCount();
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::put_MaximumGradientStopCollectionCacheEntryCount(UINT32 value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                GetResource();  // this ensures that Close() hasn't been called
+
+                m_gradientStopCollectionCache->SetMaximumEntryCount(value);
+            });
+    }
+
+    IFACEMETHODIMP CanvasDevice::get_GradientStopCollectionCacheStatistics(CanvasGradientStopCollectionCacheStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                *value = m_gradientStopCollectionCache->GetStatistics();
+            });
+    }
+
     IFACEMETHODIMP CanvasDevice::add_DeviceLost(
         DeviceLostHandlerType* value, 
         EventRegistrationToken* token)
@@ -718,13 +918,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             [&]
             {
                 m_deviceContextPool.Close();
+                m_stagingBitmapCache->Clear();
+                m_textLayoutCache->Clear();
+                m_geometryRealizationCache->Clear();
+                m_gradientStopCollectionCache->Clear();
                 ThrowIfFailed(this->ResourceWrapper::Close()); // 'this->' is workaround for VS2013 calling with bad 'this' pointer
 
                 m_dxgiDevice.Close();
                 m_primaryOutput.Reset();
                 m_sharedState.reset();
-                m_histogramEffect.Reset();
-                m_atlasEffect.Reset();
+
+                Lock lock(m_histogramEffectsMutex);
+                m_histogramEffects.clear();
         });
     }
 
@@ -1020,6 +1225,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
                 d2dDevice->ClearResources();
 
+                m_deviceContextPool.Trim();
+                m_stagingBitmapCache->Clear();
+                m_textLayoutCache->Clear();
+                m_geometryRealizationCache->Clear();
+                m_gradientStopCollectionCache->Clear();
+
                 dxgiDevice->Trim();
             });
     }
@@ -1043,20 +1254,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         D2D1_EXTEND_MODE extendMode,
         D2D1_COLOR_INTERPOLATION_MODE interpolationMode)
     {
-        auto deviceContext = GetResourceCreationDeviceContext();
+        typedef Brushes::GradientStopCollectionCache::Key Key;
 
-        ComPtr<ID2D1GradientStopCollection1> gradientStopCollection;
-        ThrowIfFailed(deviceContext->CreateGradientStopCollection(
-            stops.data(),
-            static_cast<uint32_t>(stops.size()),
-            preInterpolationSpace,
-            postInterpolationSpace,
-            bufferPrecision,
-            extendMode,
-            interpolationMode,
-            &gradientStopCollection));
+        return m_gradientStopCollectionCache->GetOrCreate(
+            Key{ std::move(stops), preInterpolationSpace, postInterpolationSpace, bufferPrecision, extendMode, interpolationMode },
+            [&] (Key const& key)
+            {
+                auto deviceContext = GetResourceCreationDeviceContext();
 
-        return gradientStopCollection;
+                ComPtr<ID2D1GradientStopCollection1> gradientStopCollection;
+                ThrowIfFailed(deviceContext->CreateGradientStopCollection(
+                    key.Stops.data(),
+                    static_cast<uint32_t>(key.Stops.size()),
+                    key.PreInterpolationSpace,
+                    key.PostInterpolationSpace,
+                    key.BufferPrecision,
+                    key.ExtendMode,
+                    key.InterpolationMode,
+                    &gradientStopCollection));
+
+                return gradientStopCollection;
+            });
     }
 
     ComPtr<ID2D1LinearGradientBrush> CanvasDevice::CreateLinearGradientBrush(
@@ -1106,6 +1324,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         DirectXPixelFormat format,
         int32_t bufferCount,
         CanvasAlphaMode alphaMode,
+        bool frameLatencyWaitable,
         FN&& createFn)
     {
         auto& d2dDevice = GetResource();
@@ -1135,6 +1354,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
         swapChainDesc.AlphaMode = ToDxgiAlphaMode(alphaMode);
 
+        if (frameLatencyWaitable)
+            swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
         ComPtr<IDXGISwapChain1> swapChain;
         ThrowIfCreateSurfaceFailed(
             createFn(dxgiFactory.Get(), dxgiDevice.Get(), &swapChainDesc, &swapChain),
@@ -1150,9 +1372,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         int32_t heightInPixels,
         DirectXPixelFormat format,
         int32_t bufferCount,
-        CanvasAlphaMode alphaMode)
+        CanvasAlphaMode alphaMode,
+        bool frameLatencyWaitable)
     {
-        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode,
+        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode, frameLatencyWaitable,
             [] (IDXGIFactory2* factory, IDXGIDevice3* device, DXGI_SWAP_CHAIN_DESC1* desc, IDXGISwapChain1** swapChain)
             {
                 return factory->CreateSwapChainForComposition(
@@ -1171,7 +1394,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         int32_t bufferCount,
         CanvasAlphaMode alphaMode)
     {
-        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode,
+        return CreateSwapChain(widthInPixels, heightInPixels, format, bufferCount, alphaMode, false,
             [coreWindow] (IDXGIFactory2* factory, IDXGIDevice3* device, DXGI_SWAP_CHAIN_DESC1* desc, IDXGISwapChain1** swapChain)
             {
                 return factory->CreateSwapChainForCoreWindow(
@@ -1258,6 +1481,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         return m_deviceContextPool.TakeLease();
     }
 
+    std::shared_ptr<StagingBitmapCache> CanvasDevice::GetStagingBitmapCache()
+    {
+        GetResource();  // this ensures that Close() hasn't been called
+
+        return m_stagingBitmapCache;
+    }
+
+    std::shared_ptr<Text::TextLayoutCache> CanvasDevice::GetTextLayoutCache()
+    {
+        GetResource();  // this ensures that Close() hasn't been called
+
+        return m_textLayoutCache;
+    }
+
+    std::shared_ptr<Geometry::GeometryRealizationCache> CanvasDevice::GetGeometryRealizationCache()
+    {
+        GetResource();  // this ensures that Close() hasn't been called
+
+        return m_geometryRealizationCache;
+    }
+
     void CanvasDevice::InitializePrimaryOutput(IDXGIDevice3* dxgiDevice)
     {
         D2DResourceLock lock(GetResource().Get());
@@ -1316,40 +1560,37 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ThrowIfFailed(hr);
     }
 
-    static ComPtr<ID2D1Effect> InterlockedExchangeComPtr(ComPtr<ID2D1Effect>& target, ComPtr<ID2D1Effect>&& value)
-    {
-        auto addressOfTarget = reinterpret_cast<void* volatile*>(target.GetAddressOf());
-
-        auto exchanged = InterlockedExchangePointer(addressOfTarget, value.Detach());
-
-        ComPtr<ID2D1Effect> result;
-        result.Attach(reinterpret_cast<ID2D1Effect*>(exchanged));
-        return result;
-    }
-
     CanvasDevice::HistogramAndAtlasEffects CanvasDevice::LeaseHistogramEffect(ID2D1DeviceContext* d2dContext)
     {
-        ComPtr<ID2D1Effect> histogram = InterlockedExchangeComPtr(m_histogramEffect, nullptr);
-
-        if (!histogram)
         {
-            ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Histogram, &histogram));
+            Lock lock(m_histogramEffectsMutex);
+
+            if (!m_histogramEffects.empty())
+            {
+                auto effects = std::move(m_histogramEffects.back());
+                m_histogramEffects.pop_back();
+                return effects;
+            }
         }
 
-        ComPtr<ID2D1Effect> atlas = InterlockedExchangeComPtr(m_atlasEffect, nullptr);
+        HistogramAndAtlasEffects effects;
 
-        if (!atlas)
-        {
-            ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Atlas, &atlas));
-        }
+        ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Histogram, &effects.HistogramEffect));
+        ThrowIfFailed(d2dContext->CreateEffect(CLSID_D2D1Atlas, &effects.AtlasEffect));
 
-        return HistogramAndAtlasEffects{ histogram, atlas };
+        return effects;
     }
 
     void CanvasDevice::ReleaseHistogramEffect(HistogramAndAtlasEffects&& effects)
     {
-        InterlockedExchangeComPtr(m_histogramEffect, std::move(effects.HistogramEffect));
-        InterlockedExchangeComPtr(m_atlasEffect, std::move(effects.AtlasEffect));
+        HistogramAndAtlasEffects released(std::move(effects));
+
+        Lock lock(m_histogramEffectsMutex);
+
+        if (m_histogramEffects.size() < MaximumPooledHistogramEffects)
+            m_histogramEffects.push_back(std::move(released));
+
+        // Otherwise the effects are released when 'released' goes out of scope.
     }
 
 #if WINVER > _WIN32_WINNT_WINBLUE
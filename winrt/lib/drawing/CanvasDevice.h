@@ -5,6 +5,7 @@
 #pragma once
 
 #include "DeviceContextPool.h"
+#include "images/StagingBitmapCache.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -13,6 +14,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     using namespace ABI::Windows::UI::Core;
     using namespace ABI::Windows::ApplicationModel::Core;
 
+    namespace Text
+    {
+        class TextLayoutCache;
+    }
+
+    namespace Geometry
+    {
+        class GeometryRealizationCache;
+    }
+
+    namespace Brushes
+    {
+        class GradientStopCollectionCache;
+    }
+
     class CanvasDevice;
     class SharedDeviceState;
     class DefaultDeviceAdapter;
@@ -129,7 +145,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             int32_t heightInPixels,
             DirectXPixelFormat format,
             int32_t bufferCount,
-            CanvasAlphaMode alphaMode) = 0;
+            CanvasAlphaMode alphaMode,
+            bool frameLatencyWaitable) = 0;
 
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCoreWindow(
             ICoreWindow* coreWindow,
@@ -152,6 +169,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         virtual DeviceContextLease GetResourceCreationDeviceContext() = 0;
 
+        virtual std::shared_ptr<StagingBitmapCache> GetStagingBitmapCache() = 0;
+
+        virtual std::shared_ptr<Text::TextLayoutCache> GetTextLayoutCache() = 0;
+
+        virtual std::shared_ptr<Geometry::GeometryRealizationCache> GetGeometryRealizationCache() = 0;
+
         virtual ComPtr<IDXGIOutput> GetPrimaryDisplayOutput() = 0;
 
         virtual void ThrowIfCreateSurfaceFailed(HRESULT hr, wchar_t const* typeName, uint32_t width, uint32_t height) = 0;
@@ -160,8 +183,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         {
             ComPtr<ID2D1Effect> HistogramEffect;
             ComPtr<ID2D1Effect> AtlasEffect;
+
+            // Created on demand by whoever needs a luminance histogram.
+            ComPtr<ID2D1Effect> LuminanceEffect;
         };
 
+        // The device keeps up to this many released effect chains for reuse.
+        static const uint32_t MaximumPooledHistogramEffects = 8;
+
         virtual HistogramAndAtlasEffects LeaseHistogramEffect(ID2D1DeviceContext* d2dContext) = 0;
         virtual void ReleaseHistogramEffect(HistogramAndAtlasEffects&& effects) = 0;
 
@@ -207,9 +236,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         std::shared_ptr<SharedDeviceState> m_sharedState;
 
         DeviceContextPool m_deviceContextPool;
+        std::shared_ptr<StagingBitmapCache> m_stagingBitmapCache;
+        std::shared_ptr<Text::TextLayoutCache> m_textLayoutCache;
+        std::shared_ptr<Geometry::GeometryRealizationCache> m_geometryRealizationCache;
+        std::shared_ptr<Brushes::GradientStopCollectionCache> m_gradientStopCollectionCache;
 
-        ComPtr<ID2D1Effect> m_histogramEffect;
-        ComPtr<ID2D1Effect> m_atlasEffect;
+        std::mutex m_histogramEffectsMutex;
+        std::vector<HistogramAndAtlasEffects> m_histogramEffects;
 
 #if WINVER > _WIN32_WINNT_WINBLUE
         std::mutex m_quirkMutex;
@@ -251,6 +284,34 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHOD(get_LowPriority)(boolean* value) override;
         IFACEMETHOD(put_LowPriority)(boolean value) override;
 
+        IFACEMETHOD(get_MaximumDeviceContextPoolSize)(int32_t* value) override;
+        IFACEMETHOD(put_MaximumDeviceContextPoolSize)(int32_t value) override;
+
+        IFACEMETHOD(get_DeviceContextPoolStatistics)(CanvasDeviceContextPoolStatistics* value) override;
+
+        IFACEMETHOD(get_MaximumStagingBitmapCacheSize)(UINT64* value) override;
+        IFACEMETHOD(put_MaximumStagingBitmapCacheSize)(UINT64 value) override;
+
+        IFACEMETHOD(get_StagingBitmapCacheStatistics)(CanvasStagingBitmapCacheStatistics* value) override;
+
+        IFACEMETHOD(get_MaximumTextLayoutCacheEntryCount)(UINT32* value) override;
+        IFACEMETHOD(put_MaximumTextLayoutCacheEntryCount)(UINT32 value) override;
+
+        IFACEMETHOD(get_MaximumTextLayoutCacheSize)(UINT64* value) override;
+        IFACEMETHOD(put_MaximumTextLayoutCacheSize)(UINT64 value) override;
+
+        IFACEMETHOD(get_TextLayoutCacheStatistics)(CanvasTextLayoutCacheStatistics* value) override;
+
+        IFACEMETHOD(get_MaximumGeometryRealizationCacheSize)(UINT64* value) override;
+        IFACEMETHOD(put_MaximumGeometryRealizationCacheSize)(UINT64 value) override;
+
+        IFACEMETHOD(get_GeometryRealizationCacheStatistics)(CanvasGeometryRealizationCacheStatistics* value) override;
+
+        IFACEMETHOD(get_MaximumGradientStopCollectionCacheEntryCount)(UINT32* value) override;
+        IFACEMETHOD(put_MaximumGradientStopCollectionCacheEntryCount)(UINT32 value) override;
+
+        IFACEMETHOD(get_GradientStopCollectionCacheStatistics)(CanvasGradientStopCollectionCacheStatistics* value) override;
+
         IFACEMETHOD(add_DeviceLost)(DeviceLostHandlerType* value, EventRegistrationToken* token) override;
 
         IFACEMETHOD(remove_DeviceLost)(EventRegistrationToken token) override;
@@ -332,7 +393,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             int32_t heightInPixels,
             DirectXPixelFormat format,
             int32_t bufferCount,
-            CanvasAlphaMode alphaMode) override;
+            CanvasAlphaMode alphaMode,
+            bool frameLatencyWaitable) override;
 
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCoreWindow(
             ICoreWindow* coreWindow,
@@ -357,6 +419,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         virtual DeviceContextLease GetResourceCreationDeviceContext() override final;
 
+        virtual std::shared_ptr<StagingBitmapCache> GetStagingBitmapCache() override;
+
+        virtual std::shared_ptr<Text::TextLayoutCache> GetTextLayoutCache() override;
+
+        virtual std::shared_ptr<Geometry::GeometryRealizationCache> GetGeometryRealizationCache() override;
+
         virtual ComPtr<IDXGIOutput> GetPrimaryDisplayOutput() override;
 
         virtual void ThrowIfCreateSurfaceFailed(HRESULT hr, wchar_t const* typeName, uint32_t width, uint32_t height) override;
@@ -399,6 +467,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             DirectXPixelFormat format,
             int32_t bufferCount,
             CanvasAlphaMode alphaMode,
+            bool frameLatencyWaitable,
             FN&& createFn);
 
         ComPtr<ID2D1Factory2> GetD2DFactory();
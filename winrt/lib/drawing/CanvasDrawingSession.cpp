@@ -75,8 +75,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         std::shared_ptr<ICanvasDrawingSessionAdapter> drawingSessionAdapter,
         ICanvasDevice* owner,
         std::shared_ptr<bool> targetHasActiveDrawingSession,
-        D2D1_POINT_2F offset)
+        D2D1_POINT_2F offset,
+        std::shared_ptr<DirtyRegion> dirtyRegion)
     {
+        EventWrite_CanvasDrawingSession_Create_Start();
+        auto createEnd = MakeScopeWarden([] { EventWrite_CanvasDrawingSession_Create_Stop(); });
+
         InitializeDefaultState(deviceContext);
 
         auto drawingSession = Make<CanvasDrawingSession>(
@@ -84,7 +88,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             drawingSessionAdapter,
             owner,
             std::move(targetHasActiveDrawingSession),
-            offset);
+            offset,
+            std::move(dirtyRegion));
         CheckMakeResult(drawingSession);
 
         return drawingSession;
@@ -133,11 +138,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         std::shared_ptr<ICanvasDrawingSessionAdapter> adapter,
         ICanvasDevice* owner,
         std::shared_ptr<bool> targetHasActiveDrawingSession,
-        D2D1_POINT_2F offset)
+        D2D1_POINT_2F offset,
+        std::shared_ptr<DirtyRegion> dirtyRegion)
         : ResourceWrapper(deviceContext)
         , m_adapter(adapter ? adapter : std::make_shared<NoopCanvasDrawingSessionAdapter>())
         , m_targetHasActiveDrawingSession(std::move(targetHasActiveDrawingSession))
         , m_offset(offset)
+        , m_dirtyRegion(std::move(dirtyRegion))
         , m_nextLayerId(0)
         , m_owner(owner)
     {
@@ -159,6 +166,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             [&]
             {
                 auto deviceContext = MaybeGetResource();
+
+                // Only trace the close that actually ends the session, not
+                // later ones such as the one from our destructor.
+                bool wasOpen = static_cast<bool>(deviceContext);
+
+                if (wasOpen)
+                    EventWrite_CanvasDrawingSession_Close_Start();
+
+                auto closeEnd = MakeScopeWarden([=] { if (wasOpen) EventWrite_CanvasDrawingSession_Close_Stop(); });
         
                 ReleaseResource();
 
@@ -183,6 +199,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 m_solidColorBrush.Reset();
                 m_defaultTextFormat.Reset();
                 m_owner.Reset();
+                m_dirtyRegion.reset();
 #if WINVER > _WIN32_WINNT_WINBLUE
                 m_inkD2DRenderer.Reset();
                 m_inkStateBlock.Reset();
@@ -198,6 +215,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             [&]
             {
                 GetResource()->Clear(ToD2DColor(color));
+                AddDirtyEverything();
             });
     }
 
@@ -209,6 +227,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             [&]
             {
                 GetResource()->Clear(ToD2DColor(color));
+                AddDirtyEverything();
             });
     }
 
@@ -736,6 +755,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CheckInPointer(image);
 
             DrawImageWorker(GetDevice().Get(), deviceContext.Get(), offset, destinationRect, sourceRect, opacity, interpolation).DrawImage(image, composite);
+
+            AddDirtyEverything();
         });
 
     }
@@ -755,6 +776,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CheckInPointer(bitmap);
 
             DrawImageWorker(GetDevice().Get(), deviceContext.Get(), offset, destinationRect, sourceRect, opacity, interpolation).DrawBitmap(bitmap, perspective);
+
+            AddDirtyEverything();
         });
     }
 
@@ -978,6 +1001,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        AddDirtyBounds(deviceContext.Get(), D2D1_RECT_F{ point0.X, point0.Y, point1.X, point1.Y }, strokeWidth, strokeStyle);
     }
 
 
@@ -1183,6 +1208,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        AddDirtyBounds(deviceContext.Get(), d2dRect, strokeWidth, strokeStyle);
     }
 
 
@@ -1256,6 +1283,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->FillRectangle(
             &d2dRect,
             brush);
+
+        AddDirtyBounds(deviceContext.Get(), d2dRect);
     }
 
 
@@ -1373,6 +1402,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                         deviceContext->PopLayer();
                     }
                 }
+
+                AddDirtyBounds(deviceContext.Get(), d2dRect);
         });
     }
 
@@ -1644,6 +1675,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        AddDirtyBounds(deviceContext.Get(), d2dRoundedRect.rect, strokeWidth, strokeStyle);
     }
 
 
@@ -1735,6 +1768,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->FillRoundedRectangle(
             &d2dRoundedRect,
             brush);
+
+        AddDirtyBounds(deviceContext.Get(), d2dRoundedRect.rect);
     }
 
 
@@ -1960,6 +1995,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    static D2D1_RECT_F GetEllipseBounds(D2D1_ELLIPSE const& ellipse)
+    {
+        return D2D1_RECT_F
+        {
+            ellipse.point.x - ellipse.radiusX,
+            ellipse.point.y - ellipse.radiusY,
+            ellipse.point.x + ellipse.radiusX,
+            ellipse.point.y + ellipse.radiusY
+        };
+    }
+
+
     void CanvasDrawingSession::DrawEllipseImpl(
         Vector2 const& centerPoint,
         float radiusX,
@@ -1978,6 +2025,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             brush,
             strokeWidth,
             ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+
+        AddDirtyBounds(deviceContext.Get(), GetEllipseBounds(d2dEllipse), strokeWidth, strokeStyle);
     }
 
 
@@ -2065,6 +2114,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->FillEllipse(
             &d2dEllipse,
             brush);
+
+        AddDirtyBounds(deviceContext.Get(), GetEllipseBounds(d2dEllipse));
     }
 
 
@@ -2570,6 +2621,36 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         auto textBuffer = WindowsGetStringRawBuffer(text, &textLength);
         ThrowIfNullPointer(textBuffer, E_INVALIDARG);
 
+        // Text can overhang its layout box, so isn't worth bounding.
+        AddDirtyEverything();
+
+        //
+        // DrawText lays the text out in a box the size of the rect, and draws
+        // the layout at the top left corner.  If the device has a text layout
+        // cache we do the same, but with a layout that may have been created
+        // by an earlier call.  The cache is disabled by default, so check for
+        // that before going to the device for it.
+        //
+
+        if (rect.Width >= 0 && rect.Height >= 0 && Text::TextLayoutCache::IsAnyEnabled())
+        {
+            auto textLayoutCache = As<ICanvasDeviceInternal>(GetDevice())->GetTextLayoutCache();
+
+            auto layout = textLayoutCache->GetOrCreateLayout(
+                CustomFontManager::GetInstance()->GetSharedFactory().Get(),
+                textBuffer,
+                textLength,
+                realizedFormat,
+                rect.Width,
+                rect.Height);
+
+            if (layout)
+            {
+                deviceContext->DrawTextLayout(D2D1_POINT_2F{ rect.X, rect.Y }, layout.Get(), brush, drawTextOptions);
+                return;
+            }
+        }
+
         auto d2dRect = ToD2DRect(rect);
 
         deviceContext->DrawText(textBuffer, textLength, realizedFormat, &d2dRect, brush, drawTextOptions);
@@ -2626,6 +2707,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     GetWrappedResource<IDWriteTextLayout>(textLayout).Get(),
                     ToD2DBrush(brush).Get(),
                     StaticCastAs<D2D1_DRAW_TEXT_OPTIONS>(drawTextOptions));
+
+                AddDirtyEverything();
             });
     }
 
@@ -2663,6 +2746,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     GetWrappedResource<IDWriteTextLayout>(textLayout).Get(),
                     GetColorBrush(color),
                     StaticCastAs<D2D1_DRAW_TEXT_OPTIONS>(drawTextOptions));
+
+                AddDirtyEverything();
             });
     }
 
@@ -2966,11 +3051,47 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         CheckInPointer(geometry);
         CheckInPointer(brush);
 
-        deviceContext->DrawGeometry(
-            GetWrappedResource<ID2D1Geometry>(geometry).Get(),
-            brush,
-            strokeWidth,
-            ToD2DStrokeStyle(strokeStyle, deviceContext.Get()).Get());
+        auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometry);
+        auto d2dStrokeStyle = ToD2DStrokeStyle(strokeStyle, deviceContext.Get());
+
+        // If the device has a geometry realization cache, geometries that are
+        // drawn repeatedly are only tessellated once.  The cache is disabled by
+        // default, so check for that before going to the device for it.
+        ComPtr<ID2D1GeometryRealization> realization;
+
+        if (Geometry::GeometryRealizationCache::IsAnyEnabled())
+        {
+            auto geometryRealizationCache = As<ICanvasDeviceInternal>(GetDevice())->GetGeometryRealizationCache();
+
+            realization = geometryRealizationCache->GetStrokedRealization(
+                deviceContext.Get(),
+                d2dGeometry.Get(),
+                strokeWidth,
+                d2dStrokeStyle.Get());
+        }
+
+        if (realization)
+        {
+            deviceContext->DrawGeometryRealization(realization.Get(), brush);
+        }
+        else
+        {
+            deviceContext->DrawGeometry(
+                d2dGeometry.Get(),
+                brush,
+                strokeWidth,
+                d2dStrokeStyle.Get());
+        }
+
+        if (m_dirtyRegion)
+        {
+            // The widened bounds take the stroke's joins and caps into account.
+            D2D1_RECT_F bounds;
+            ThrowIfFailed(d2dGeometry->GetWidenedBounds(strokeWidth, d2dStrokeStyle.Get(), nullptr, &bounds));
+
+            if (bounds.left <= bounds.right && bounds.top <= bounds.bottom)
+                AddDirtyBounds(deviceContext.Get(), bounds, 0, strokeStyle);
+        }
     }
 
 
@@ -3144,10 +3265,27 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         {
             // Fast path: if there is no opacity brush, or if our color brush is
             // a clamped bitmap, D2D can fill the geometry directly in a single call.
-            deviceContext->FillGeometry(
-                d2dGeometry.Get(),
-                brush,
-                opacityBrush);
+            // Realizations can't be drawn with an opacity brush.
+            ComPtr<ID2D1GeometryRealization> realization;
+
+            if (!opacityBrush && Geometry::GeometryRealizationCache::IsAnyEnabled())
+            {
+                auto geometryRealizationCache = As<ICanvasDeviceInternal>(GetDevice())->GetGeometryRealizationCache();
+
+                realization = geometryRealizationCache->GetFilledRealization(deviceContext.Get(), d2dGeometry.Get());
+            }
+
+            if (realization)
+            {
+                deviceContext->DrawGeometryRealization(realization.Get(), brush);
+            }
+            else
+            {
+                deviceContext->FillGeometry(
+                    d2dGeometry.Get(),
+                    brush,
+                    opacityBrush);
+            }
         }
         else
         {
@@ -3165,6 +3303,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
             deviceContext->PopLayer();
         }
+
+        if (m_dirtyRegion)
+        {
+            D2D1_RECT_F bounds;
+            ThrowIfFailed(d2dGeometry->GetBounds(nullptr, &bounds));
+
+            if (bounds.left <= bounds.right && bounds.top <= bounds.bottom)
+                AddDirtyBounds(deviceContext.Get(), bounds);
+        }
     }
 
 
@@ -3274,6 +3421,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         deviceContext->DrawGeometryRealization(
             GetWrappedResource<ID2D1GeometryRealization>(cachedGeometry).Get(),
             brush);
+
+        AddDirtyEverything();
     }
 
 #if WINVER > _WIN32_WINNT_WINBLUE
@@ -3328,6 +3477,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             deviceContext.Get(), 
             inkStrokeCollectionAsIUnknown.Get(), 
             highContrast));
+
+        AddDirtyEverything();
     }
 
     IFACEMETHODIMP CanvasDrawingSession::DrawGradientMeshAtOrigin(ICanvasGradientMesh* gradientMesh)
@@ -3342,6 +3493,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
                 deviceContext2->DrawGradientMesh(
                     GetWrappedResource<ID2D1GradientMesh>(gradientMesh).Get());
+
+                AddDirtyEverything();
             });
     }
 
@@ -3359,6 +3512,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
                 deviceContext2->DrawGradientMesh(
                     GetWrappedResource<ID2D1GradientMesh>(gradientMesh).Get());
+
+                AddDirtyEverything();
             });
     }
 
@@ -3376,6 +3531,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
                 deviceContext2->DrawGradientMesh(
                     GetWrappedResource<ID2D1GradientMesh>(gradientMesh).Get());
+
+                AddDirtyEverything();
             });
     }
 
@@ -3963,6 +4120,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     &helper.DWriteGlyphRunDescription,
                     d2dBrush.Get(),
                     helper.MeasuringMode);
+
+                AddDirtyEverything();
             });
     }
 
@@ -4086,6 +4245,110 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         }
     }
 
+    void CanvasDrawingSession::AddDirtyBounds(
+        ID2D1DeviceContext1* deviceContext,
+        D2D1_RECT_F const& bounds,
+        float strokeWidth,
+        ICanvasStrokeStyle* strokeStyle)
+    {
+        if (!m_dirtyRegion)
+            return;
+
+        // Strokes that don't scale with the transform can't be bounded in the
+        // current coordinate space.
+        if (strokeStyle)
+        {
+            CanvasStrokeTransformBehavior transformBehavior;
+            ThrowIfFailed(strokeStyle->get_TransformBehavior(&transformBehavior));
+
+            if (transformBehavior != CanvasStrokeTransformBehavior::Normal)
+            {
+                m_dirtyRegion->AddEverything();
+                return;
+            }
+        }
+
+        //
+        // Half the stroke width covers the stroke itself, but square caps and
+        // miter joins at right angles reach further than that.  The whole width
+        // is enough for those.
+        //
+        auto inflate = fabsf(strokeWidth);
+
+        float left = std::min(bounds.left, bounds.right) - inflate;
+        float top = std::min(bounds.top, bounds.bottom) - inflate;
+        float right = std::max(bounds.left, bounds.right) + inflate;
+        float bottom = std::max(bounds.top, bounds.bottom) + inflate;
+
+        D2D1_MATRIX_3X2_F transform;
+        deviceContext->GetTransform(&transform);
+
+        // The transform maps to DIPs, unless the session is using pixel units.
+        float scaleX = 1;
+        float scaleY = 1;
+
+        if (deviceContext->GetUnitMode() == D2D1_UNIT_MODE_DIPS)
+        {
+            float dpiX, dpiY;
+            deviceContext->GetDpi(&dpiX, &dpiY);
+
+            scaleX = dpiX / DEFAULT_DPI;
+            scaleY = dpiY / DEFAULT_DPI;
+        }
+
+        D2D1_POINT_2F corners[] =
+        {
+            { left,  top },
+            { right, top },
+            { left,  bottom },
+            { right, bottom },
+        };
+
+        float minX = FLT_MAX;
+        float minY = FLT_MAX;
+        float maxX = -FLT_MAX;
+        float maxY = -FLT_MAX;
+
+        for (auto& corner : corners)
+        {
+            auto x = (corner.x * transform._11 + corner.y * transform._21 + transform._31) * scaleX;
+            auto y = (corner.x * transform._12 + corner.y * transform._22 + transform._32) * scaleY;
+
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+
+        if (!isfinite(minX) || !isfinite(minY) || !isfinite(maxX) || !isfinite(maxY))
+        {
+            m_dirtyRegion->AddEverything();
+            return;
+        }
+
+        // Keep well clear of the LONG range; the region clips to the surface anyway.
+        auto toPixels = [](float value)
+        {
+            const float limit = 1 << 30;
+            return static_cast<LONG>(std::max(-limit, std::min(limit, value)));
+        };
+
+        // Antialiasing can touch one more pixel on each side.
+        m_dirtyRegion->Add(D2D1_RECT_L
+        {
+            toPixels(floorf(minX)) - 1,
+            toPixels(floorf(minY)) - 1,
+            toPixels(ceilf(maxX)) + 1,
+            toPixels(ceilf(maxY)) + 1
+        });
+    }
+
+    void CanvasDrawingSession::AddDirtyEverything()
+    {
+        if (m_dirtyRegion)
+            m_dirtyRegion->AddEverything();
+    }
+
 #if WINVER > _WIN32_WINNT_WINBLUE
 
     IFACEMETHODIMP CanvasDrawingSession::CreateSpriteBatch(
@@ -4167,6 +4430,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             CheckMakeResult(newSpriteBatch);
 
             ThrowIfFailed(newSpriteBatch.CopyTo(spriteBatch));
+
+            // The sprites are drawn when the batch is closed.
+            AddDirtyEverything();
         });
     }
 
@@ -4201,6 +4467,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                 TemporaryViewportSize viewportSizer(d2dSvgDocument.Get(), viewportSize);
 
                 deviceContext5->DrawSvgDocument(d2dSvgDocument.Get());
+
+                AddDirtyEverything();
             });
     }
     
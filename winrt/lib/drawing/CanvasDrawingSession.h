@@ -60,6 +60,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         std::shared_ptr<ICanvasDrawingSessionAdapter> m_adapter;
         std::shared_ptr<bool> m_targetHasActiveDrawingSession;
         D2D1_POINT_2F const m_offset;
+
+        // When set, the bounds of everything drawn are added to this region.
+        std::shared_ptr<DirtyRegion> m_dirtyRegion;
         
         ComPtr<ID2D1SolidColorBrush> m_solidColorBrush;
         ComPtr<ICanvasTextFormat> m_defaultTextFormat;
@@ -91,14 +94,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             std::shared_ptr<ICanvasDrawingSessionAdapter> drawingSessionAdapter,
             ICanvasDevice* owner = nullptr,
             std::shared_ptr<bool> targetHasActiveDrawingSession = nullptr,
-            D2D1_POINT_2F offset = D2D1_POINT_2F{ 0, 0 });
+            D2D1_POINT_2F offset = D2D1_POINT_2F{ 0, 0 },
+            std::shared_ptr<DirtyRegion> dirtyRegion = nullptr);
 
         CanvasDrawingSession(
             ID2D1DeviceContext1* deviceContext,
             std::shared_ptr<ICanvasDrawingSessionAdapter> drawingSessionAdapter = nullptr,
             ICanvasDevice* owner = nullptr,
             std::shared_ptr<bool> targetHasActiveDrawingSession = nullptr,
-            D2D1_POINT_2F offset = D2D1_POINT_2F{ 0, 0 });
+            D2D1_POINT_2F offset = D2D1_POINT_2F{ 0, 0 },
+            std::shared_ptr<DirtyRegion> dirtyRegion = nullptr);
 
 
         virtual ~CanvasDrawingSession();
@@ -1465,6 +1470,17 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         void PopLayer(int layerId, bool isAxisAlignedClip);
 
+        // Adds the bounds of a shape, in the current coordinate space, to the
+        // dirty region.  Does nothing if the session isn't tracking one.
+        void AddDirtyBounds(
+            ID2D1DeviceContext1* deviceContext,
+            D2D1_RECT_F const& bounds,
+            float strokeWidth = 0,
+            ICanvasStrokeStyle* strokeStyle = nullptr);
+
+        // For drawing whose bounds aren't cheap to work out.
+        void AddDirtyEverything();
+
 #if WINVER > _WIN32_WINNT_WINBLUE
         void DrawInkImpl(IIterable<InkStroke*>* inkStrokeCollection, bool highContrast);
 #endif
@@ -34,6 +34,224 @@ IFACEMETHODIMP CanvasSpriteBatchStatics::IsSupported(ICanvasDevice* device, bool
 }
 
 
+//
+// SpriteBatchStorage implementation
+//
+
+
+static std::mutex gRecycledStorageMutex;
+static std::unique_ptr<SpriteBatchStorage> gRecycledStorage[2];
+
+
+std::unique_ptr<SpriteBatchStorage> SpriteBatchStorage::Acquire()
+{
+    {
+        Lock lock(gRecycledStorageMutex);
+
+        for (auto& storage : gRecycledStorage)
+        {
+            if (storage)
+                return std::move(storage);
+        }
+    }
+
+    return std::make_unique<SpriteBatchStorage>();
+}
+
+
+void SpriteBatchStorage::Recycle(std::unique_ptr<SpriteBatchStorage>&& storage)
+{
+    if (!storage)
+        return;
+
+    if (storage->BitmapIndices.capacity() > MaxRecycledSpriteCount)
+    {
+        storage.reset();
+        return;
+    }
+
+    storage->Clear();
+
+    Lock lock(gRecycledStorageMutex);
+
+    for (auto& slot : gRecycledStorage)
+    {
+        if (!slot)
+        {
+            slot = std::move(storage);
+            return;
+        }
+    }
+
+    // The recycle bin is full; let this one go.
+    storage.reset();
+}
+
+
+SpriteBatchStorage::SpriteBatchStorage()
+    : m_lastBitmap(nullptr)
+    , m_lastBitmapIndex(0)
+{
+}
+
+
+uint32_t SpriteBatchStorage::GetBitmapIndex(ID2D1Bitmap* bitmap)
+{
+    // Apps usually draw runs of sprites from the same bitmap, so it is worth
+    // avoiding the hash lookup for these.
+    if (bitmap == m_lastBitmap)
+        return m_lastBitmapIndex;
+
+    auto it = m_bitmapLookup.find(bitmap);
+
+    uint32_t index;
+
+    if (it != m_bitmapLookup.end())
+    {
+        index = it->second;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(Bitmaps.size());
+        Bitmaps.emplace_back(bitmap);
+        m_bitmapLookup.emplace(bitmap, index);
+    }
+
+    m_lastBitmap = bitmap;
+    m_lastBitmapIndex = index;
+
+    return index;
+}
+
+
+void SpriteBatchStorage::Add(
+    uint32_t bitmapIndex,
+    D2D1_RECT_F const& destinationRect,
+    D2D1_RECT_U const& sourceRect,
+    D2D1_COLOR_F const& color,
+    D2D1_MATRIX_3X2_F const& transform)
+{
+    assert(bitmapIndex < Bitmaps.size());
+
+    DestinationRects.push_back(destinationRect);
+    SourceRects.push_back(sourceRect);
+    Colors.push_back(color);
+    Transforms.push_back(transform);
+    BitmapIndices.push_back(bitmapIndex);
+}
+
+
+void SpriteBatchStorage::Reserve(size_t count)
+{
+    DestinationRects.reserve(count);
+    SourceRects.reserve(count);
+    Colors.reserve(count);
+    Transforms.reserve(count);
+    BitmapIndices.reserve(count);
+}
+
+
+size_t SpriteBatchStorage::Append(uint32_t bitmapIndex, size_t count)
+{
+    assert(bitmapIndex < Bitmaps.size());
+
+    auto first = Size();
+    auto newSize = first + count;
+
+    DestinationRects.resize(newSize, D2D1_RECT_F{});
+    SourceRects.resize(newSize, D2D1_RECT_U{});
+    Colors.resize(newSize, D2D1_COLOR_F{ 1, 1, 1, 1 });
+    Transforms.resize(newSize, D2D1::IdentityMatrix());
+    BitmapIndices.resize(newSize, bitmapIndex);
+
+    return first;
+}
+
+
+void SpriteBatchStorage::Truncate(size_t size)
+{
+    if (size >= Size())
+        return;
+
+    DestinationRects.resize(size);
+    SourceRects.resize(size);
+    Colors.resize(size);
+    Transforms.resize(size);
+    BitmapIndices.resize(size);
+}
+
+
+void SpriteBatchStorage::SortByBitmap()
+{
+    if (Bitmaps.size() <= 1)
+        return;
+
+    if (std::is_sorted(BitmapIndices.begin(), BitmapIndices.end()))
+        return;
+
+    //
+    // Bitmap indices are dense, so a counting sort does this in two linear
+    // passes.  Indices were assigned in the order bitmaps were first drawn, so
+    // this also preserves that order between the groups.
+    //
+
+    auto spriteCount = BitmapIndices.size();
+
+    m_bucketStarts.assign(Bitmaps.size(), 0);
+
+    for (auto bitmapIndex : BitmapIndices)
+        ++m_bucketStarts[bitmapIndex];
+
+    uint32_t start = 0;
+    for (auto& bucketStart : m_bucketStarts)
+    {
+        auto count = bucketStart;
+        bucketStart = start;
+        start += count;
+    }
+
+    m_sortOrder.resize(spriteCount);
+
+    for (uint32_t i = 0; i < spriteCount; ++i)
+        m_sortOrder[m_bucketStarts[BitmapIndices[i]]++] = i;
+
+    ApplySortOrder(DestinationRects, m_sortedDestinationRects);
+    ApplySortOrder(SourceRects, m_sortedSourceRects);
+    ApplySortOrder(Colors, m_sortedColors);
+    ApplySortOrder(Transforms, m_sortedTransforms);
+    ApplySortOrder(BitmapIndices, m_sortedBitmapIndices);
+}
+
+
+template<typename T>
+void SpriteBatchStorage::ApplySortOrder(std::vector<T>& values, std::vector<T>& scratch)
+{
+    assert(values.size() == m_sortOrder.size());
+
+    scratch.resize(values.size());
+
+    for (size_t i = 0; i < m_sortOrder.size(); ++i)
+        scratch[i] = values[m_sortOrder[i]];
+
+    values.swap(scratch);
+}
+
+
+void SpriteBatchStorage::Clear()
+{
+    DestinationRects.clear();
+    SourceRects.clear();
+    Colors.clear();
+    Transforms.clear();
+    BitmapIndices.clear();
+
+    Bitmaps.clear();
+    m_bitmapLookup.clear();
+    m_lastBitmap = nullptr;
+    m_lastBitmapIndex = 0;
+}
+
+
 //
 // CanvasSpriteBatch implementation
 //
@@ -77,13 +295,19 @@ static D2D1_RECT_U MakeSourceRect(ComPtr<ID2D1Bitmap> const& d2dBitmap, CanvasSp
 }
 
 
-static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, D2D1_UNIT_MODE unitMode, ICanvasBitmap* bitmap, Rect sourceRect)
+static float GetSourceRectDpi(D2D1_UNIT_MODE unitMode, ICanvasBitmap* bitmap)
 {
     float dpi = 96.0f;
 
     if (unitMode == D2D1_UNIT_MODE_DIPS)
         ThrowIfFailed(As<ICanvasResourceCreatorWithDpi>(bitmap)->get_Dpi(&dpi));
-    
+
+    return dpi;
+}
+
+
+static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, float dpi, Rect const& sourceRect)
+{
     auto sourceLeft   = DipsToPixels(sourceRect.X,      dpi, CanvasDpiRounding::Round);
     auto sourceTop    = DipsToPixels(sourceRect.Y,      dpi, CanvasDpiRounding::Round);
     auto sourceWidth  = DipsToPixels(sourceRect.Width,  dpi, CanvasDpiRounding::Round);
@@ -101,6 +325,12 @@ static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, D2D1_UNIT_MODE unitMode
 }
 
 
+static D2D1_RECT_U MakeSourceRect(CanvasSpriteFlip flip, D2D1_UNIT_MODE unitMode, ICanvasBitmap* bitmap, Rect sourceRect)
+{
+    return MakeSourceRect(flip, GetSourceRectDpi(unitMode, bitmap), sourceRect);
+}
+
+
 static float3x2 MakeTransform(Vector2 const& origin, float rotation, Vector2 const& scale, Vector2 const& offset)
 {
     return
@@ -121,6 +351,7 @@ CanvasSpriteBatch::CanvasSpriteBatch(
     , m_interpolationMode(interpolation)
     , m_spriteOptions(options)
     , m_unitMode(deviceContext->GetUnitMode())
+    , m_sprites(SpriteBatchStorage::Acquire())
 {
     assert(m_sortMode == CanvasSpriteSortMode::None
         || m_sortMode == CanvasSpriteSortMode::Bitmap);
@@ -139,6 +370,24 @@ CanvasSpriteBatch::~CanvasSpriteBatch()
 }
 
 
+void CanvasSpriteBatch::AddSprite(
+    ID2D1Bitmap* bitmap,
+    D2D1_RECT_F const& destinationRect,
+    D2D1_RECT_U const& sourceRect,
+    Vector4 const& tint,
+    Matrix3x2 const& transform)
+{
+    auto bitmapIndex = m_sprites->GetBitmapIndex(bitmap);
+
+    m_sprites->Add(
+        bitmapIndex,
+        destinationRect,
+        sourceRect,
+        *ReinterpretAs<D2D1_COLOR_F const*>(&tint),
+        *ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform));
+}
+
+
 IFACEMETHODIMP CanvasSpriteBatch::DrawToRect( 
     ICanvasBitmap* bitmap,
     Rect destRect)
@@ -186,11 +435,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawAtOffsetWithTint(
         auto d2dDestRect = MakeDestRect(d2dBitmap, offset);
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, CanvasSpriteFlip::None);
         
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            d2dDestRect,
-            d2dSourceRect,
-            tint);
+        AddSprite(d2dBitmap.Get(), d2dDestRect, d2dSourceRect, tint);
     });
 }
 
@@ -218,11 +463,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawToRectWithTintAndFlip(
         auto d2dBitmap = GetWrappedResource<ID2D1Bitmap>(bitmap);
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, flip);
         
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            ToD2DRect(destRect),
-            d2dSourceRect,
-            tint);
+        AddSprite(d2dBitmap.Get(), ToD2DRect(destRect), d2dSourceRect, tint);
     });
 }
 
@@ -242,12 +483,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawWithTransformAndTintAndFlip(
         auto d2dDestRect = MakeDestRect(d2dBitmap);
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, flip);
 
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            d2dDestRect,
-            d2dSourceRect,
-            tint,
-            transform);
+        AddSprite(d2dBitmap.Get(), d2dDestRect, d2dSourceRect, tint, transform);
     });
 }
 
@@ -271,12 +507,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawAtOffsetWithTintAndTransform(
         auto d2dSourceRect = MakeSourceRect(d2dBitmap, flip);
         auto transform = MakeTransform(origin, rotation, scale, offset);
 
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            d2dDestRect,
-            d2dSourceRect,
-            tint,
-            transform);
+        AddSprite(d2dBitmap.Get(), d2dDestRect, d2dSourceRect, tint, transform);
     });
 }
 
@@ -333,11 +564,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetAtOffsetWithTint(
         auto d2dDestRect = MakeDestRect(sourceRect, offset);
         auto d2dSourceRect = MakeSourceRect(CanvasSpriteFlip::None, m_unitMode, bitmap, sourceRect);
         
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            d2dDestRect,
-            d2dSourceRect,
-            tint);
+        AddSprite(d2dBitmap.Get(), d2dDestRect, d2dSourceRect, tint);
     });
 }
 
@@ -367,11 +594,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetToRectWithTintAndFlip(
         auto d2dBitmap = GetWrappedResource<ID2D1Bitmap>(bitmap);
         auto d2dSourceRect = MakeSourceRect(flip, m_unitMode, bitmap, sourceRect);
         
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            ToD2DRect(destRect),
-            d2dSourceRect,
-            tint);
+        AddSprite(d2dBitmap.Get(), ToD2DRect(destRect), d2dSourceRect, tint);
     });
 }
 
@@ -392,12 +615,7 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetWithTransformAndTintAndFlip
         auto d2dDestRect = MakeDestRect(sourceRect);
         auto d2dSourceRect = MakeSourceRect(flip, m_unitMode, bitmap, sourceRect);
         
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            d2dDestRect,
-            d2dSourceRect,
-            tint,
-            transform);
+        AddSprite(d2dBitmap.Get(), d2dDestRect, d2dSourceRect, tint, transform);
     });
 }
 
@@ -422,33 +640,221 @@ IFACEMETHODIMP CanvasSpriteBatch::DrawFromSpriteSheetAtOffsetWithTintAndTransfor
         auto d2dSourceRect = MakeSourceRect(flip, m_unitMode, bitmap, sourceRect);
         auto transform = MakeTransform(origin, rotation, scale, offset);
 
-        m_sprites.emplace_back(
-            std::move(d2dBitmap),
-            d2dDestRect,
-            d2dSourceRect,
-            tint,
-            transform);
+        AddSprite(d2dBitmap.Get(), d2dDestRect, d2dSourceRect, tint, transform);
     });
 }
 
 
-template<typename T>
+IFACEMETHODIMP CanvasSpriteBatch::DrawManyToRects(
+    ICanvasBitmap* bitmap,
+    uint32_t destRectCount,
+    Rect* destRects)
+{
+    return ExceptionBoundary([&]
+    {
+        AddSprites(bitmap, destRectCount, destRects, nullptr, nullptr, 0, nullptr);
+    });
+}
+
+
+IFACEMETHODIMP CanvasSpriteBatch::DrawManyWithTransforms(
+    ICanvasBitmap* bitmap,
+    uint32_t transformCount,
+    Matrix3x2* transforms)
+{
+    return ExceptionBoundary([&]
+    {
+        AddSprites(bitmap, transformCount, nullptr, transforms, nullptr, 0, nullptr);
+    });
+}
+
+
+IFACEMETHODIMP CanvasSpriteBatch::DrawManyToRectsWithTints(
+    ICanvasBitmap* bitmap,
+    uint32_t destRectCount,
+    Rect* destRects,
+    uint32_t tintCount,
+    Vector4* tints)
+{
+    return ExceptionBoundary([&]
+    {
+        AddSprites(bitmap, destRectCount, destRects, nullptr, nullptr, tintCount, tints);
+    });
+}
+
+
+IFACEMETHODIMP CanvasSpriteBatch::DrawManyWithTransformsAndTints(
+    ICanvasBitmap* bitmap,
+    uint32_t transformCount,
+    Matrix3x2* transforms,
+    uint32_t tintCount,
+    Vector4* tints)
+{
+    return ExceptionBoundary([&]
+    {
+        AddSprites(bitmap, transformCount, nullptr, transforms, nullptr, tintCount, tints);
+    });
+}
+
+
+IFACEMETHODIMP CanvasSpriteBatch::DrawManyFromSpriteSheetToRectsWithTints(
+    ICanvasBitmap* bitmap,
+    uint32_t destRectCount,
+    Rect* destRects,
+    uint32_t sourceRectCount,
+    Rect* sourceRects,
+    uint32_t tintCount,
+    Vector4* tints)
+{
+    return ExceptionBoundary([&]
+    {
+        if (sourceRectCount != destRectCount)
+            ThrowHR(E_INVALIDARG);
+
+        if (sourceRectCount != 0)
+            CheckInPointer(sourceRects);
+
+        AddSprites(bitmap, destRectCount, destRects, nullptr, sourceRects, tintCount, tints);
+    });
+}
+
+
+IFACEMETHODIMP CanvasSpriteBatch::DrawManyFromSpriteSheetWithTransformsAndTints(
+    ICanvasBitmap* bitmap,
+    uint32_t transformCount,
+    Matrix3x2* transforms,
+    uint32_t sourceRectCount,
+    Rect* sourceRects,
+    uint32_t tintCount,
+    Vector4* tints)
+{
+    return ExceptionBoundary([&]
+    {
+        if (sourceRectCount != transformCount)
+            ThrowHR(E_INVALIDARG);
+
+        if (sourceRectCount != 0)
+            CheckInPointer(sourceRects);
+
+        AddSprites(bitmap, transformCount, nullptr, transforms, sourceRects, tintCount, tints);
+    });
+}
+
+
+void CanvasSpriteBatch::AddSprites(
+    ICanvasBitmap* bitmap,
+    uint32_t count,
+    Rect const* destRects,
+    Matrix3x2 const* transforms,
+    Rect const* sourceRects,
+    uint32_t tintCount,
+    Vector4 const* tints)
+{
+    assert(!destRects || !transforms);
+
+    CheckInPointer(bitmap);
+    EnsureNotClosed();
+
+    //
+    // Validate everything up front, so that a bad argument doesn't leave
+    // some of the sprites added.
+    //
+
+    if (count == 0)
+        return;
+
+    if (!destRects && !transforms)
+        ThrowHR(E_INVALIDARG);
+
+    bool hasSourceRects = (sourceRects != nullptr);
+
+    if (tintCount != 0 && tintCount != 1 && tintCount != count)
+        ThrowHR(E_INVALIDARG);
+
+    if (tintCount != 0)
+        CheckInPointer(tints);
+
+    auto& sprites = *m_sprites;
+
+    if (count > std::numeric_limits<uint32_t>::max() - sprites.Size())
+        ThrowHR(E_INVALIDARG);
+
+    auto d2dBitmap = GetWrappedResource<ID2D1Bitmap>(bitmap);
+    auto sourceRectDpi = hasSourceRects ? GetSourceRectDpi(m_unitMode, bitmap) : 0.0f;
+
+    //
+    // Now fill in the new sprites one column at a time.
+    //
+
+    auto bitmapIndex = sprites.GetBitmapIndex(d2dBitmap.Get());
+    auto first = sprites.Append(bitmapIndex, count);
+
+    auto truncateWarden = MakeScopeWarden([&] { sprites.Truncate(first); });
+
+    auto destinationRectsOut = &sprites.DestinationRects[first];
+    auto sourceRectsOut = &sprites.SourceRects[first];
+
+    if (hasSourceRects)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            sourceRectsOut[i] = MakeSourceRect(CanvasSpriteFlip::None, sourceRectDpi, sourceRects[i]);
+    }
+    else
+    {
+        std::fill_n(sourceRectsOut, count, MakeSourceRect(d2dBitmap, CanvasSpriteFlip::None));
+    }
+
+    if (destRects)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            destinationRectsOut[i] = ToD2DRect(destRects[i]);
+    }
+    else if (hasSourceRects)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            destinationRectsOut[i] = MakeDestRect(sourceRects[i]);
+    }
+    else
+    {
+        std::fill_n(destinationRectsOut, count, MakeDestRect(d2dBitmap));
+    }
+
+    if (transforms)
+    {
+        std::copy_n(ReinterpretAs<D2D1_MATRIX_3X2_F const*>(transforms), count, &sprites.Transforms[first]);
+    }
+
+    if (tintCount == 1)
+    {
+        std::fill_n(&sprites.Colors[first], count, *ReinterpretAs<D2D1_COLOR_F const*>(tints));
+    }
+    else if (tintCount != 0)
+    {
+        std::copy_n(ReinterpretAs<D2D1_COLOR_F const*>(tints), count, &sprites.Colors[first]);
+    }
+
+    truncateWarden.Dismiss();
+}
+
+
 class BatchFinder
 {
-    std::vector<T> const& m_sprites;
+    std::vector<uint32_t> const& m_bitmapIndices;
     uint32_t const m_maxSpritesPerBatch;
 
     uint32_t m_startIndex;
     uint32_t m_endIndex;
-    ID2D1Bitmap* m_bitmap;
+    uint32_t m_bitmapIndex;
+    bool m_done;
 
 public:
-    BatchFinder(std::vector<T> const& sprites, uint32_t maxSpritesPerBatch) noexcept
-        : m_sprites(sprites)
+    BatchFinder(std::vector<uint32_t> const& bitmapIndices, uint32_t maxSpritesPerBatch) noexcept
+        : m_bitmapIndices(bitmapIndices)
         , m_maxSpritesPerBatch(maxSpritesPerBatch)
         , m_startIndex(0)
         , m_endIndex(0)
-        , m_bitmap(nullptr)
+        , m_bitmapIndex(0)
+        , m_done(false)
     {
         FindNext();
     }
@@ -456,13 +862,13 @@ public:
     void FindNext() noexcept
     {
         m_startIndex = m_endIndex;
-        if (m_endIndex >= m_sprites.size())
+        if (m_endIndex >= m_bitmapIndices.size())
         {
-            m_bitmap = nullptr;
+            m_done = true;
             return;
         }
 
-        m_bitmap = m_sprites[m_endIndex].Bitmap.Get();
+        m_bitmapIndex = m_bitmapIndices[m_endIndex];
 
         for (; InCurrentBatch(); ++m_endIndex)
         {
@@ -472,7 +878,7 @@ public:
 
     bool Done() const noexcept
     {
-        return (m_bitmap == nullptr);
+        return m_done;
     }
 
     uint32_t CurrentStartIndex() const noexcept
@@ -485,9 +891,9 @@ public:
         return m_endIndex - m_startIndex;
     }
 
-    ID2D1Bitmap* CurrentBitmap() const noexcept
+    uint32_t CurrentBitmapIndex() const noexcept
     {
-        return m_bitmap;
+        return m_bitmapIndex;
     }
 
 
@@ -500,7 +906,7 @@ private:
         if (m_endIndex - m_startIndex >= m_maxSpritesPerBatch)
             return false;
         
-        return m_endIndex != m_sprites.size() && m_sprites[m_endIndex].Bitmap.Get() == m_bitmap;
+        return m_endIndex != m_bitmapIndices.size() && m_bitmapIndices[m_endIndex] == m_bitmapIndex;
     }
 };
 
@@ -512,106 +918,102 @@ IFACEMETHODIMP CanvasSpriteBatch::Close()
         if (!deviceContext)
             return;
 
-        if (m_sprites.empty()) // early out if there's nothing to draw
-            return;
+        // Whatever happens, hand our working memory back so the next sprite
+        // batch can reuse it.
+        auto recycleWarden = MakeScopeWarden([&] { SpriteBatchStorage::Recycle(std::move(m_sprites)); });
 
-        //
-        // Sort the sprites
-        //
-        
-        if (m_sortMode == CanvasSpriteSortMode::Bitmap)
-        {
-            std::stable_sort(m_sprites.begin(), m_sprites.end(),
-                [] (auto const& a, auto const& b)
-                {
-                    return a.Bitmap.Get() < b.Bitmap.Get();
-                });
-        }
+        if (m_sprites->Empty()) // early out if there's nothing to draw
+            return;
 
-        //
-        // Build up a D2D sprite batch from our sprites
-        //
-        
-        ComPtr<ID2D1SpriteBatch> spriteBatch;
-        ThrowIfFailed(deviceContext->CreateSpriteBatch(&spriteBatch));
-
-        assert(m_sprites.size() < std::numeric_limits<uint32_t>::max());
-
-        auto firstSprite = &m_sprites.front();
-        auto stride = static_cast<uint32_t>(sizeof(Sprite));
-
-        ThrowIfFailed(spriteBatch->AddSprites(
-            static_cast<uint32_t>(m_sprites.size()),
-            &firstSprite->DestinationRect,
-            &firstSprite->SourceRect,
-            &firstSprite->Color,
-            &firstSprite->Transform,
-            stride,
-            stride,
-            stride,
-            stride));
-
-        //
-        // Get the device context into the right state
-        //
-        
-        auto originalAntialiasMode = deviceContext->GetAntialiasMode();
+        DrawSprites(deviceContext.Get());
+    });
+}
 
-        if (originalAntialiasMode == D2D1_ANTIALIAS_MODE_PER_PRIMITIVE)
-            deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
 
-        auto originalUnitMode = deviceContext->GetUnitMode();
-        if (originalUnitMode != m_unitMode)
-            deviceContext->SetUnitMode(m_unitMode);
+void CanvasSpriteBatch::DrawSprites(ID2D1DeviceContext3* deviceContext)
+{
+    auto& sprites = *m_sprites;
 
-        //
-        // Draw the sprites - one DrawSpriteBatch call for each bitmap
-        //
+    //
+    // Sort the sprites
+    //
+    
+    if (m_sortMode == CanvasSpriteSortMode::Bitmap)
+        sprites.SortByBitmap();
 
-        // Figure out if we need to quirk the batch size to workaround an issue
-        // with older Qualcomm drivers.
-        ComPtr<ID2D1Device> d2dDevice;
-        deviceContext->GetDevice(&d2dDevice);
-        auto device = ResourceManager::GetOrCreate<ICanvasDeviceInternal>(d2dDevice.Get());
-        bool quirked = device->IsSpriteBatchQuirkRequired();
-        uint32_t maxSpritesPerBatch = quirked ? 256 : std::numeric_limits<uint32_t>::max();
-        
-        for (BatchFinder<Sprite> batchFinder(m_sprites, maxSpritesPerBatch); !batchFinder.Done(); batchFinder.FindNext())
+    //
+    // Build up a D2D sprite batch from our sprites
+    //
+    
+    ComPtr<ID2D1SpriteBatch> spriteBatch;
+    ThrowIfFailed(deviceContext->CreateSpriteBatch(&spriteBatch));
+
+    assert(sprites.Size() < std::numeric_limits<uint32_t>::max());
+
+    ThrowIfFailed(spriteBatch->AddSprites(
+        static_cast<uint32_t>(sprites.Size()),
+        sprites.DestinationRects.data(),
+        sprites.SourceRects.data(),
+        sprites.Colors.data(),
+        sprites.Transforms.data(),
+        static_cast<uint32_t>(sizeof(D2D1_RECT_F)),
+        static_cast<uint32_t>(sizeof(D2D1_RECT_U)),
+        static_cast<uint32_t>(sizeof(D2D1_COLOR_F)),
+        static_cast<uint32_t>(sizeof(D2D1_MATRIX_3X2_F))));
+
+    //
+    // Get the device context into the right state
+    //
+    
+    auto originalAntialiasMode = deviceContext->GetAntialiasMode();
+
+    if (originalAntialiasMode == D2D1_ANTIALIAS_MODE_PER_PRIMITIVE)
+        deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+
+    auto originalUnitMode = deviceContext->GetUnitMode();
+    if (originalUnitMode != m_unitMode)
+        deviceContext->SetUnitMode(m_unitMode);
+
+    //
+    // Draw the sprites - one DrawSpriteBatch call for each bitmap
+    //
+
+    // Figure out if we need to quirk the batch size to workaround an issue
+    // with older Qualcomm drivers.
+    ComPtr<ID2D1Device> d2dDevice;
+    deviceContext->GetDevice(&d2dDevice);
+    auto device = ResourceManager::GetOrCreate<ICanvasDeviceInternal>(d2dDevice.Get());
+    bool quirked = device->IsSpriteBatchQuirkRequired();
+    uint32_t maxSpritesPerBatch = quirked ? 256 : std::numeric_limits<uint32_t>::max();
+    
+    for (BatchFinder batchFinder(sprites.BitmapIndices, maxSpritesPerBatch); !batchFinder.Done(); batchFinder.FindNext())
+    {
+        deviceContext->DrawSpriteBatch(
+            spriteBatch.Get(),
+            batchFinder.CurrentStartIndex(),
+            batchFinder.CurrentSpriteCount(),
+            sprites.Bitmaps[batchFinder.CurrentBitmapIndex()].Get(),
+            m_interpolationMode,
+            m_spriteOptions);
+
+        if (quirked)
         {
-            deviceContext->DrawSpriteBatch(
-                spriteBatch.Get(),
-                batchFinder.CurrentStartIndex(),
-                batchFinder.CurrentSpriteCount(),
-                batchFinder.CurrentBitmap(),
-                m_interpolationMode,
-                m_spriteOptions);
-
-            if (quirked)
-            {
-                // Direct2D will helpfully batch up our DrawSpriteBatch calls - when
-                // we're manually unbatching them to avoid limits of the maximum sprites per batch!
-                // An explicit Flush here prevents that from happening.
-                deviceContext->Flush();
-            }
+            // Direct2D will helpfully batch up our DrawSpriteBatch calls - when
+            // we're manually unbatching them to avoid limits of the maximum sprites per batch!
+            // An explicit Flush here prevents that from happening.
+            deviceContext->Flush();
         }
+    }
 
-        //
-        // Restore the state we may have changed
-        //
-
-        if (originalUnitMode != m_unitMode)
-            deviceContext->SetUnitMode(originalUnitMode);
-
-        if (originalAntialiasMode == D2D1_ANTIALIAS_MODE_PER_PRIMITIVE)
-            deviceContext->SetAntialiasMode(originalAntialiasMode);
+    //
+    // Restore the state we may have changed
+    //
 
-        //
-        // Release our working memory
-        //
+    if (originalUnitMode != m_unitMode)
+        deviceContext->SetUnitMode(originalUnitMode);
 
-        m_sprites.clear();
-        m_sprites.shrink_to_fit();
-    });
+    if (originalAntialiasMode == D2D1_ANTIALIAS_MODE_PER_PRIMITIVE)
+        deviceContext->SetAntialiasMode(originalAntialiasMode);
 }
 
 
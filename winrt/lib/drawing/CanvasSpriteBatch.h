@@ -18,6 +18,100 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     };
 
     
+    //
+    // Sprites are stored structure-of-arrays style, which lets the whole batch
+    // be passed to ID2D1SpriteBatch::AddSprites in a single call.  Rather than
+    // each sprite holding a reference to its bitmap, sprites store an index
+    // into a table of the distinct bitmaps used by the batch.
+    //
+    // Storage is recycled between sprite batches, so apps that draw a similar
+    // number of sprites each frame don't keep reallocating these arrays.
+    //
+    class SpriteBatchStorage
+    {
+    public:
+        //
+        // Storage that grew beyond this many sprites is released rather than
+        // recycled, so that one unusually large batch doesn't pin its memory
+        // forever.  This is set well above the 100k+ sprite particle and tile
+        // workloads that benefit most from recycling.  The sprite arrays take
+        // around 76 bytes per sprite, so an unsorted storage stays under 20MB.
+        // Sorting keeps a second copy of every array, plus the sort order, as
+        // scratch space, so a storage that has been sorted takes around 156
+        // bytes per sprite and may be up to 40MB.
+        //
+        static const size_t MaxRecycledSpriteCount = 256 * 1024;
+
+        std::vector<D2D1_RECT_F> DestinationRects;
+        std::vector<D2D1_RECT_U> SourceRects;
+        std::vector<D2D1_COLOR_F> Colors;
+        std::vector<D2D1_MATRIX_3X2_F> Transforms;
+        std::vector<uint32_t> BitmapIndices;
+
+        std::vector<ComPtr<ID2D1Bitmap>> Bitmaps;
+
+        static std::unique_ptr<SpriteBatchStorage> Acquire();
+        static void Recycle(std::unique_ptr<SpriteBatchStorage>&& storage);
+
+        SpriteBatchStorage();
+
+        SpriteBatchStorage(SpriteBatchStorage const&) = delete;
+        SpriteBatchStorage& operator=(SpriteBatchStorage const&) = delete;
+
+        uint32_t GetBitmapIndex(ID2D1Bitmap* bitmap);
+
+        void Add(
+            uint32_t bitmapIndex,
+            D2D1_RECT_F const& destinationRect,
+            D2D1_RECT_U const& sourceRect,
+            D2D1_COLOR_F const& color,
+            D2D1_MATRIX_3X2_F const& transform);
+
+        size_t Size() const
+        {
+            return BitmapIndices.size();
+        }
+
+        bool Empty() const
+        {
+            return BitmapIndices.empty();
+        }
+
+        void Reserve(size_t count);
+
+        // Appends count sprites using the given bitmap, initialized to fill
+        // the origin with no tint or transform.  Returns the index of the
+        // first new sprite.
+        size_t Append(uint32_t bitmapIndex, size_t count);
+
+        // Discards any sprites at or after the given index.
+        void Truncate(size_t size);
+
+        // Stable sort by bitmap index, so bitmaps are grouped in the order they were first drawn.
+        void SortByBitmap();
+
+        // Releases the bitmaps, but keeps the allocated capacity.
+        void Clear();
+
+    private:
+        std::unordered_map<ID2D1Bitmap*, uint32_t> m_bitmapLookup;
+        ID2D1Bitmap* m_lastBitmap;
+        uint32_t m_lastBitmapIndex;
+
+        // Scratch space for SortByBitmap.
+        std::vector<uint32_t> m_sortOrder;
+        std::vector<uint32_t> m_bucketStarts;
+        std::vector<D2D1_RECT_F> m_sortedDestinationRects;
+        std::vector<D2D1_RECT_U> m_sortedSourceRects;
+        std::vector<D2D1_COLOR_F> m_sortedColors;
+        std::vector<D2D1_MATRIX_3X2_F> m_sortedTransforms;
+        std::vector<uint32_t> m_sortedBitmapIndices;
+
+        template<typename T>
+        void ApplySortOrder(std::vector<T>& values, std::vector<T>& scratch);
+    };
+
+    
     class CanvasSpriteBatch
         : public RuntimeClass<ICanvasSpriteBatch, IClosable, ICanvasResourceCreator, ICanvasResourceCreatorWithDpi>
         , private LifespanTracker<CanvasSpriteBatch>
@@ -30,39 +124,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         D2D1_SPRITE_OPTIONS m_spriteOptions;
         D2D1_UNIT_MODE m_unitMode;
         
-        struct Sprite
-        {
-            ComPtr<ID2D1Bitmap> Bitmap;
-            D2D1_RECT_F DestinationRect;
-            D2D1_RECT_U SourceRect;
-            D2D1_COLOR_F Color;
-            D2D1_MATRIX_3X2_F Transform;
-
-            Sprite(
-                ComPtr<ID2D1Bitmap>&& bitmap,
-                D2D1_RECT_F const& destinationRect,
-                D2D1_RECT_U const& sourceRect,
-                Vector4 const& tint,
-                Matrix3x2 const& transform)
-                : Bitmap(std::move(bitmap))
-                , DestinationRect(destinationRect)
-                , SourceRect(sourceRect)
-                , Color(*ReinterpretAs<D2D1_COLOR_F const*>(&tint))
-                , Transform(*ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform))
-            {
-            }
-
-            Sprite(
-                ComPtr<ID2D1Bitmap>&& bitmap,
-                D2D1_RECT_F const& destinationRect,
-                D2D1_RECT_U const& sourceRect,
-                Vector4 const& tint)
-                : Sprite(std::move(bitmap), destinationRect, sourceRect, tint, Identity3x2())
-            {
-            }
-        };
-
-        std::vector<Sprite> m_sprites;
+        std::unique_ptr<SpriteBatchStorage> m_sprites;
 
     public:
         static Vector4 const DEFAULT_TINT;
@@ -184,6 +246,48 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             Vector2 scale,
             CanvasSpriteFlip flip) override;
 
+        IFACEMETHODIMP DrawManyToRects(
+            ICanvasBitmap* bitmap,
+            uint32_t destRectCount,
+            Rect* destRects) override;
+
+        IFACEMETHODIMP DrawManyWithTransforms(
+            ICanvasBitmap* bitmap,
+            uint32_t transformCount,
+            Matrix3x2* transforms) override;
+
+        IFACEMETHODIMP DrawManyToRectsWithTints(
+            ICanvasBitmap* bitmap,
+            uint32_t destRectCount,
+            Rect* destRects,
+            uint32_t tintCount,
+            Vector4* tints) override;
+
+        IFACEMETHODIMP DrawManyWithTransformsAndTints(
+            ICanvasBitmap* bitmap,
+            uint32_t transformCount,
+            Matrix3x2* transforms,
+            uint32_t tintCount,
+            Vector4* tints) override;
+
+        IFACEMETHODIMP DrawManyFromSpriteSheetToRectsWithTints(
+            ICanvasBitmap* bitmap,
+            uint32_t destRectCount,
+            Rect* destRects,
+            uint32_t sourceRectCount,
+            Rect* sourceRects,
+            uint32_t tintCount,
+            Vector4* tints) override;
+
+        IFACEMETHODIMP DrawManyFromSpriteSheetWithTransformsAndTints(
+            ICanvasBitmap* bitmap,
+            uint32_t transformCount,
+            Matrix3x2* transforms,
+            uint32_t sourceRectCount,
+            Rect* sourceRects,
+            uint32_t tintCount,
+            Vector4* tints) override;
+
         //
         // IClosable
         //
@@ -216,6 +320,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
     private:
         void EnsureNotClosed();
+
+        void AddSprite(
+            ID2D1Bitmap* bitmap,
+            D2D1_RECT_F const& destinationRect,
+            D2D1_RECT_U const& sourceRect,
+            Vector4 const& tint,
+            Matrix3x2 const& transform = Identity3x2());
+
+        // Exactly one of destRects and transforms must be set.  sourceRects
+        // may be null, in which case the whole bitmap is drawn.
+        void AddSprites(
+            ICanvasBitmap* bitmap,
+            uint32_t count,
+            Rect const* destRects,
+            Matrix3x2 const* transforms,
+            Rect const* sourceRects,
+            uint32_t tintCount,
+            Vector4 const* tints);
+
+        void DrawSprites(ID2D1DeviceContext3* deviceContext);
     };
 
 } } } }
@@ -174,6 +174,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         , m_dpi(dpi)
         , m_adapter(CanvasSwapChainAdapter::GetInstance())
         , m_hasActiveDrawingSession(std::make_shared<bool>())
+        , m_maximumFrameLatency(0)
     {
     }
 
@@ -447,10 +448,151 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             [&]
             {
                 auto lock = GetResourceLock();
-                auto& resource = GetResource();
 
-                DXGI_PRESENT_PARAMETERS presentParameters = { 0 };
-                ThrowIfFailed(resource->Present1(syncInterval, 0, &presentParameters));
+                std::vector<RECT> dirtyRects;
+
+                if (m_dirtyRegion)
+                {
+                    auto desc = GetSwapChainDesc(lock);
+                    dirtyRects = m_dirtyRegion->TakeRectangles(desc.Width, desc.Height);
+                }
+
+                PresentImpl(lock, syncInterval, dirtyRects, nullptr, nullptr);
+            });
+    }
+
+    // Dirty rectangles are rounded outwards, so that they cover every pixel
+    // that was touched.
+    static RECT ToDirtyRECT(Rect const& rect, float dpi)
+    {
+        return RECT
+        {
+            DipsToPixels(rect.X, dpi, CanvasDpiRounding::Floor),
+            DipsToPixels(rect.Y, dpi, CanvasDpiRounding::Floor),
+            DipsToPixels(rect.X + rect.Width, dpi, CanvasDpiRounding::Ceiling),
+            DipsToPixels(rect.Y + rect.Height, dpi, CanvasDpiRounding::Ceiling)
+        };
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::PresentWithDirtyRects(
+        int32_t syncInterval,
+        uint32_t dirtyRectCount,
+        Rect* dirtyRects)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (dirtyRectCount)
+                    CheckInPointer(dirtyRects);
+
+                auto lock = GetResourceLock();
+
+                std::vector<RECT> pixelDirtyRects;
+                pixelDirtyRects.reserve(dirtyRectCount);
+
+                for (uint32_t i = 0; i < dirtyRectCount; ++i)
+                    pixelDirtyRects.push_back(ToDirtyRECT(dirtyRects[i], m_dpi));
+
+                // The caller's rectangles replace any that were tracked.
+                if (m_dirtyRegion)
+                    m_dirtyRegion->Clear();
+
+                PresentImpl(lock, syncInterval, pixelDirtyRects, nullptr, nullptr);
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::PresentWithDirtyRectsAndScroll(
+        int32_t syncInterval,
+        uint32_t dirtyRectCount,
+        Rect* dirtyRects,
+        Rect scrollRect,
+        Vector2 scrollOffset)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                if (dirtyRectCount)
+                    CheckInPointer(dirtyRects);
+
+                auto lock = GetResourceLock();
+
+                std::vector<RECT> pixelDirtyRects;
+                pixelDirtyRects.reserve(dirtyRectCount);
+
+                for (uint32_t i = 0; i < dirtyRectCount; ++i)
+                    pixelDirtyRects.push_back(ToDirtyRECT(dirtyRects[i], m_dpi));
+
+                auto pixelScrollRect = ToRECT(scrollRect, m_dpi);
+
+                POINT pixelScrollOffset
+                {
+                    DipsToPixels(scrollOffset.X, m_dpi, CanvasDpiRounding::Round),
+                    DipsToPixels(scrollOffset.Y, m_dpi, CanvasDpiRounding::Round)
+                };
+
+                if (m_dirtyRegion)
+                    m_dirtyRegion->Clear();
+
+                PresentImpl(lock, syncInterval, pixelDirtyRects, &pixelScrollRect, &pixelScrollOffset);
+            });
+    }
+
+    void CanvasSwapChain::PresentImpl(
+        D2DResourceLock const&,
+        int32_t syncInterval,
+        std::vector<RECT>& dirtyRects,
+        RECT* scrollRect,
+        POINT* scrollOffset)
+    {
+        auto& resource = GetResource();
+
+        EventWrite_CanvasSwapChain_Present_Start();
+        auto presentEnd = MakeScopeWarden([] { EventWrite_CanvasSwapChain_Present_Stop(); });
+
+        DXGI_PRESENT_PARAMETERS presentParameters = { 0 };
+
+        if (!dirtyRects.empty())
+        {
+            presentParameters.DirtyRectsCount = static_cast<UINT>(dirtyRects.size());
+            presentParameters.pDirtyRects = dirtyRects.data();
+        }
+
+        presentParameters.pScrollRect = scrollRect;
+        presentParameters.pScrollOffset = scrollOffset;
+
+        ThrowIfFailed(resource->Present1(syncInterval, 0, &presentParameters));
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::get_TrackDirtyRegions(boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                auto lock = GetResourceLock();
+
+                *value = static_cast<bool>(m_dirtyRegion);
+            });
+    }
+
+    IFACEMETHODIMP CanvasSwapChain::put_TrackDirtyRegions(boolean value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto lock = GetResourceLock();
+
+                if (!value)
+                {
+                    m_dirtyRegion.reset();
+                }
+                else if (!m_dirtyRegion)
+                {
+                    // Nothing is known about what was drawn before tracking
+                    // started, so the first present is of the whole surface.
+                    m_dirtyRegion = std::make_shared<DirtyRegion>();
+                }
             });
     }
 
@@ -541,12 +683,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         ThrowIfNegative(widthInPixels);
         ThrowIfNegative(heightInPixels);
 
+        // DXGI requires the frame latency flag to be passed on every resize.
+        UINT flags = m_frameLatencyWaitableObject.IsValid() ? DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT : 0;
+
         ThrowIfFailed(swapChain->ResizeBuffers(
             bufferCount, 
             widthInPixels,
             heightInPixels,
             static_cast<DXGI_FORMAT>(newFormat), 
-            0));
+            flags));
 
         if (m_isCoreWindowSwapChain)
         {
@@ -560,6 +705,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             m_dpi = newDpi;
             SetMatrixInternal(lock, swapChain, &dpiIndependentTransform);
         }
+
+        // The new buffers have to be presented in full.
+        if (m_dirtyRegion)
+            m_dirtyRegion->AddEverything();
     }
 
     // IClosable
@@ -571,9 +720,55 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             return hr;
 
         m_device.Close();
+        m_frameLatencyWaitableObject.Close();
         return S_OK;
     }
 
+
+    void CanvasSwapChain::InitializeFrameLatencyWaitableObject(uint32_t maximumFrameLatency)
+    {
+        assert(maximumFrameLatency > 0);
+        assert(!m_frameLatencyWaitableObject.IsValid());
+
+        auto swapChain = As<IDXGISwapChain2>(GetResource());
+
+        ThrowIfFailed(swapChain->SetMaximumFrameLatency(maximumFrameLatency));
+
+        // The caller owns the returned handle.
+        m_frameLatencyWaitableObject.Attach(swapChain->GetFrameLatencyWaitableObject());
+
+        if (!m_frameLatencyWaitableObject.IsValid())
+            ThrowHR(E_UNEXPECTED);
+
+        m_maximumFrameLatency = maximumFrameLatency;
+    }
+
+
+    uint32_t CanvasSwapChain::GetMaximumFrameLatency() const
+    {
+        return m_maximumFrameLatency;
+    }
+
+
+    bool CanvasSwapChain::WaitForFrameLatency(DWORD timeoutInMs)
+    {
+        // Throws if the swap chain has been closed.
+        GetResource();
+
+        if (!m_frameLatencyWaitableObject.IsValid())
+            ThrowHR(E_UNEXPECTED);
+
+        auto result = WaitForSingleObjectEx(m_frameLatencyWaitableObject.Get(), timeoutInMs, false);
+
+        if (result == WAIT_TIMEOUT)
+            return false;
+
+        if (result != WAIT_OBJECT_0)
+            ThrowHR(E_UNEXPECTED);
+
+        return true;
+    }
+
     IFACEMETHODIMP CanvasSwapChain::get_Device(ICanvasDevice** value)
     {
         return ExceptionBoundary(
@@ -691,7 +886,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
                     m_dpi,
                     &deviceContext);
                 
-                auto newDrawingSession = CanvasDrawingSession::CreateNew(deviceContext.Get(), adapter, device.Get(), m_hasActiveDrawingSession);
+                auto newDrawingSession = CanvasDrawingSession::CreateNew(
+                    deviceContext.Get(),
+                    adapter,
+                    device.Get(),
+                    m_hasActiveDrawingSession,
+                    D2D1_POINT_2F{ 0, 0 },
+                    m_dirtyRegion);
 
                 ThrowIfFailed(newDrawingSession.CopyTo(drawingSession));
             });
@@ -733,18 +934,34 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         DirectXPixelFormat format,
         int32_t bufferCount,
         CanvasAlphaMode alphaMode)
+    {
+        return CreateNew(device, width, height, dpi, format, bufferCount, alphaMode, 0);
+    }
+
+    ComPtr<CanvasSwapChain> CanvasSwapChain::CreateNew(
+        ICanvasDevice* device,
+        float width,
+        float height,
+        float dpi,
+        DirectXPixelFormat format,
+        int32_t bufferCount,
+        CanvasAlphaMode alphaMode,
+        uint32_t maximumFrameLatency)
     {
         auto deviceInternal = As<ICanvasDeviceInternal>(device);
 
         int widthInPixels = SizeDipsToPixels(width, dpi);
         int heightInPixels = SizeDipsToPixels(height, dpi);
 
+        bool frameLatencyWaitable = (maximumFrameLatency > 0);
+
         ComPtr<IDXGISwapChain1> dxgiSwapChain = deviceInternal->CreateSwapChainForComposition(
             widthInPixels,
             heightInPixels,
             format,
             bufferCount,
-            alphaMode);
+            alphaMode,
+            frameLatencyWaitable);
 
         auto canvasSwapChain = Make<CanvasSwapChain>(
             device,
@@ -755,6 +972,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         ThrowIfFailed(canvasSwapChain->put_TransformMatrix(Matrix3x2{ 1, 0, 0, 1, 0, 0 }));
 
+        if (frameLatencyWaitable)
+            canvasSwapChain->InitializeFrameLatencyWaitableObject(maximumFrameLatency);
+
         return canvasSwapChain;
     }
 
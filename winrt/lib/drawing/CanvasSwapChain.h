@@ -115,6 +115,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         std::shared_ptr<CanvasSwapChainAdapter> m_adapter;
         std::shared_ptr<bool> m_hasActiveDrawingSession;
 
+        // Set while TrackDirtyRegions is enabled.  Shared with the drawing
+        // sessions, which add the bounds of what they draw to it.
+        std::shared_ptr<DirtyRegion> m_dirtyRegion;
+
+        // Only valid for swap chains created with a maximum frame latency.
+        Wrappers::Event m_frameLatencyWaitableObject;
+        uint32_t m_maximumFrameLatency;
+
     public:
         static DirectXPixelFormat const DefaultPixelFormat = PIXEL_FORMAT(B8G8R8A8UIntNormalized);
         static int32_t const DefaultBufferCount = 2;
@@ -130,6 +138,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             int32_t bufferCount,
             CanvasAlphaMode alphaMode);
 
+        // Creates a swap chain with a frame latency waitable object, which
+        // allows at most maximumFrameLatency frames to be queued.
+        static ComPtr<CanvasSwapChain> CreateNew(
+            ICanvasDevice* device,
+            float width,
+            float height,
+            float dpi,
+            DirectXPixelFormat format,
+            int32_t bufferCount,
+            CanvasAlphaMode alphaMode,
+            uint32_t maximumFrameLatency);
+
         static ComPtr<CanvasSwapChain> CreateNew(
             ICanvasDevice* device,
             ICoreWindow* coreWindow,
@@ -183,6 +203,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         IFACEMETHOD(Present)() override;
         IFACEMETHOD(PresentWithSyncInterval)(int32_t syncInterval) override;
 
+        IFACEMETHOD(PresentWithDirtyRects)(
+            int32_t syncInterval,
+            uint32_t dirtyRectCount,
+            Rect* dirtyRects) override;
+
+        IFACEMETHOD(PresentWithDirtyRectsAndScroll)(
+            int32_t syncInterval,
+            uint32_t dirtyRectCount,
+            Rect* dirtyRects,
+            Rect scrollRect,
+            Vector2 scrollOffset) override;
+
+        IFACEMETHOD(get_TrackDirtyRegions)(boolean* value) override;
+        IFACEMETHOD(put_TrackDirtyRegions)(boolean value) override;
+
         IFACEMETHOD(ResizeBuffersWithSize)(
             Size newSize) override;
 
@@ -207,6 +242,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         // IClosable
         IFACEMETHOD(Close)() override;
 
+        //
+        // Frame latency waitable object support.  These are only used
+        // internally, by CanvasAnimatedControl.
+        //
+
+        // The swap chain must have been created with the
+        // DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT flag.
+        void InitializeFrameLatencyWaitableObject(uint32_t maximumFrameLatency);
+
+        // Returns 0 if the swap chain has no frame latency waitable object.
+        uint32_t GetMaximumFrameLatency() const;
+
+        // Blocks until the swap chain is ready to accept another frame.
+        // Returns false if this timed out.
+        bool WaitForFrameLatency(DWORD timeoutInMs);
+
     private:
         D2DResourceLock GetResourceLock();
 
@@ -221,6 +272,13 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             ComPtr<IDXGISwapChain2> const& resource, 
             DXGI_MATRIX_3X2_F* transform);
 
+        void PresentImpl(
+            D2DResourceLock const& lock,
+            int32_t syncInterval,
+            std::vector<RECT>& dirtyRects,
+            RECT* scrollRect,
+            POINT* scrollOffset);
+
         void ResizeBuffersImpl(
             D2DResourceLock const& lock,
             float newWidth,
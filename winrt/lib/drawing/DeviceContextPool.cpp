@@ -12,33 +12,95 @@
 //
 
 
+//
+// The default maximum pool size is picked from number of CPUs - reasoning
+// being that you should expect to be able to have that many threads running
+// and reusing contexts without recreating them.
+//
+static uint32_t GetDefaultMaximumSize()
+{
+    return std::min(std::max(std::thread::hardware_concurrency(), 1U), DeviceContextPool::MaxSlotCount);
+}
+
+
 DeviceContextPool::DeviceContextPool(ID2D1Device1* d2dDevice)
     : m_d2dDevice(d2dDevice)
+    , m_closed(false)
+    , m_slots(new Slot[MaxSlotCount])
+    , m_maximumSize(GetDefaultMaximumSize())
+    , m_activeLeaseCount(0)
+    , m_peakActiveLeaseCount(0)
+    , m_previousPeakActiveLeaseCount(0)
+    , m_returnsSinceTrim(0)
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_createCount(0)
+    , m_discardCount(0)
 {
 }
 
 
+DeviceContextPool::~DeviceContextPool()
+{
+    DiscardSlots(0, MaxSlotCount);
+}
+
+
 DeviceContextLease DeviceContextPool::TakeLease()
+{
+    if (m_closed)
+        ThrowHR(RO_E_CLOSED);
+
+    //
+    // Look in this thread's preferred slot first, which will usually hold the
+    // context that this thread returned last time.  If that is empty we'll
+    // take an idle context from any other slot before resorting to creating a
+    // new one.
+    //
+    auto maximumSize = m_maximumSize.load();
+    auto preferredSlot = GetPreferredSlot(maximumSize);
+
+    for (uint32_t i = 0; i < maximumSize; ++i)
+    {
+        auto& slot = m_slots[(preferredSlot + i) % maximumSize].DeviceContext;
+
+        if (!slot.load(std::memory_order_relaxed))
+            continue;
+
+        if (auto rawDeviceContext = slot.exchange(nullptr))
+        {
+            ComPtr<ID2D1DeviceContext1> deviceContext;
+            deviceContext.Attach(rawDeviceContext);
+
+            ++m_hitCount;
+            OnLeaseTaken();
+            return DeviceContextLease(this, std::move(deviceContext));
+        }
+    }
+
+    ++m_missCount;
+
+    auto deviceContext = CreateDeviceContext();
+    OnLeaseTaken();
+    return DeviceContextLease(this, std::move(deviceContext));
+}
+
+
+ComPtr<ID2D1DeviceContext1> DeviceContextPool::CreateDeviceContext()
 {
     Lock lock(m_mutex);
 
     if (!m_d2dDevice)
         ThrowHR(RO_E_CLOSED);
-    
-    if (m_deviceContexts.empty())
-    {
-        ComPtr<ID2D1DeviceContext1> deviceContext;
-        ThrowIfFailed(m_d2dDevice->CreateDeviceContext(
-            D2D1_DEVICE_CONTEXT_OPTIONS_NONE,
-            &deviceContext));
-        return DeviceContextLease(this, std::move(deviceContext));
-    }
-    else
-    {
-        DeviceContextLease newLease(this, std::move(m_deviceContexts.back()));
-        m_deviceContexts.pop_back();
-        return newLease;
-    }
+
+    ComPtr<ID2D1DeviceContext1> deviceContext;
+    ThrowIfFailed(m_d2dDevice->CreateDeviceContext(
+        D2D1_DEVICE_CONTEXT_OPTIONS_NONE,
+        &deviceContext));
+
+    ++m_createCount;
+
+    return deviceContext;
 }
 
 
@@ -46,29 +108,192 @@ void DeviceContextPool::ReturnLease(ComPtr<ID2D1DeviceContext1>&& deviceContext)
 {
     if (!deviceContext)
         return;
-        
-    Lock lock(m_mutex);
+
+    OnLeaseReturned();
 
     //
     // If the pool has been closed we just discard the context
     //
-    if (!m_d2dDevice)
+    if (m_closed)
+    {
+        deviceContext.Reset();
         return;
+    }
 
     //
-    // When a leased device context is returned it is added back to the pool,
-    // unless the pool has reached its maximum size, in which the context is
-    // destroyed.  This is to give the pool a chance to shrink back down to a
-    // reasonable size if there is ever any large scale concurrency going on.
+    // When a leased device context is returned it is added back to the pool
+    // (preferably in this thread's own slot, so that the next lease taken on
+    // this thread gets it back), unless all the slots are full, in which case
+    // the context is destroyed.  This is to give the pool a chance to shrink
+    // back down to a reasonable size if there is ever any large scale
+    // concurrency going on.
     //
-    // Max pool size is picked from number of CPUs - reasoning being that you
-    // should expect to be able to have that many threads running and reusing
-    // contexts without recreating them.
+    auto maximumSize = m_maximumSize.load();
+    auto preferredSlot = GetPreferredSlot(maximumSize);
+
+    bool wasPooled = false;
+
+    for (uint32_t i = 0; i < maximumSize; ++i)
+    {
+        auto& slot = m_slots[(preferredSlot + i) % maximumSize].DeviceContext;
+
+        if (slot.load(std::memory_order_relaxed))
+            continue;
+
+        ID2D1DeviceContext1* expected = nullptr;
+
+        if (slot.compare_exchange_strong(expected, deviceContext.Get()))
+        {
+            deviceContext.Detach();
+            wasPooled = true;
+            break;
+        }
+    }
+
+    if (!wasPooled)
+    {
+        ++m_discardCount;
+        deviceContext.Reset();
+    }
+    else if (m_closed)
+    {
+        //
+        // If Close() ran while we were putting the context back it may have
+        // missed it, so we need to empty the slots again.
+        //
+        DiscardSlots(0, MaxSlotCount);
+        return;
+    }
+
     //
-    static auto maxPoolSize = std::max(std::thread::hardware_concurrency(), 1U);
+    // Every return counts towards the trim interval, including the ones that
+    // were just discarded - those are exactly the returns that happen during
+    // a burst of concurrency.
+    //
+    TrimIfIdle();
+}
 
-    if (m_deviceContexts.size() < maxPoolSize)
-        m_deviceContexts.emplace_back(std::move(deviceContext));
+
+void DeviceContextPool::OnLeaseTaken()
+{
+    auto activeLeaseCount = ++m_activeLeaseCount;
+    auto peak = m_peakActiveLeaseCount.load();
+
+    while (activeLeaseCount > peak && !m_peakActiveLeaseCount.compare_exchange_weak(peak, activeLeaseCount))
+    {
+    }
+}
+
+
+void DeviceContextPool::OnLeaseReturned()
+{
+    --m_activeLeaseCount;
+}
+
+
+void DeviceContextPool::TrimIfIdle()
+{
+    if (++m_returnsSinceTrim < TrimInterval)
+        return;
+
+    m_returnsSinceTrim = 0;
+
+    //
+    // Keep enough idle contexts around to satisfy the highest concurrency seen
+    // during the last two trim intervals.  Looking back over two intervals,
+    // rather than just one, means that a short lull between bursts of work
+    // doesn't throw away contexts that the next burst is going to need.
+    //
+    auto peak = m_peakActiveLeaseCount.exchange(m_activeLeaseCount);
+    auto previousPeak = m_previousPeakActiveLeaseCount.exchange(peak);
+
+    TrimTo(std::max(std::max(peak, previousPeak), 1U));
+}
+
+
+void DeviceContextPool::TrimTo(uint32_t idleCount)
+{
+    uint32_t keptCount = 0;
+
+    for (uint32_t i = 0; i < MaxSlotCount; ++i)
+    {
+        auto& slot = m_slots[i].DeviceContext;
+
+        if (!slot.load(std::memory_order_relaxed))
+            continue;
+
+        if (keptCount < idleCount)
+        {
+            ++keptCount;
+            continue;
+        }
+
+        if (auto rawDeviceContext = slot.exchange(nullptr))
+        {
+            rawDeviceContext->Release();
+        }
+    }
+}
+
+
+void DeviceContextPool::DiscardSlots(uint32_t firstSlot, uint32_t endSlot)
+{
+    for (uint32_t i = firstSlot; i < endSlot; ++i)
+    {
+        if (auto rawDeviceContext = m_slots[i].DeviceContext.exchange(nullptr))
+        {
+            rawDeviceContext->Release();
+        }
+    }
+}
+
+
+uint32_t DeviceContextPool::GetPreferredSlot(uint32_t maximumSize)
+{
+    if (maximumSize == 0)
+        return 0;
+
+    return static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()) % maximumSize);
+}
+
+
+uint32_t DeviceContextPool::GetMaximumSize() const
+{
+    return m_maximumSize;
+}
+
+
+void DeviceContextPool::SetMaximumSize(uint32_t value)
+{
+    if (value > MaxSlotCount)
+        ThrowHR(E_INVALIDARG);
+
+    m_maximumSize = value;
+
+    //
+    // Contexts that were pooled in slots beyond the new maximum size would
+    // never be handed out again, so we release them now.
+    //
+    DiscardSlots(value, MaxSlotCount);
+}
+
+
+CanvasDeviceContextPoolStatistics DeviceContextPool::GetStatistics() const
+{
+    CanvasDeviceContextPoolStatistics statistics;
+
+    statistics.HitCount = m_hitCount;
+    statistics.MissCount = m_missCount;
+    statistics.CreateCount = m_createCount;
+    statistics.DiscardCount = m_discardCount;
+
+    return statistics;
+}
+
+
+void DeviceContextPool::Trim()
+{
+    DiscardSlots(0, MaxSlotCount);
 }
 
 
@@ -76,6 +301,8 @@ void DeviceContextPool::Close()
 {
     Lock lock(m_mutex);
 
-    m_deviceContexts.clear();
+    m_closed = true;
     m_d2dDevice = nullptr;
+
+    DiscardSlots(0, MaxSlotCount);
 }
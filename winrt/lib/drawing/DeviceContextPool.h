@@ -11,26 +11,94 @@ using namespace ABI::Microsoft::Graphics::Canvas;
 
 class DeviceContextLease;
 
+//
+// Hands out device contexts for short-lived resource creation work.
+//
+// Idle contexts are kept in a fixed array of slots.  Each thread has a
+// preferred slot (picked by hashing its thread id), so a thread that takes and
+// returns leases in a loop keeps getting back the same context without
+// touching any other thread's slots.  Taking and returning a lease only
+// requires atomic exchanges; the mutex is only taken when a brand new context
+// needs to be created, or when the pool is closed.
+//
 class DeviceContextPool
 {
-    ID2D1Device1* m_d2dDevice;
+public:
+    // Upper bound for the configurable maximum pool size.
+    static const uint32_t MaxSlotCount = 256;
+
+    // How many returned leases between automatic trims.
+    static const uint32_t TrimInterval = 256;
+
+private:
+    //
+    // Each slot is padded out to a cache line, so that threads working on
+    // different slots don't contend with each other.
+    //
+    struct Slot
+    {
+        std::atomic<ID2D1DeviceContext1*> DeviceContext;
+        char Padding[64 - sizeof(std::atomic<ID2D1DeviceContext1*>)];
+
+        Slot()
+            : DeviceContext(nullptr)
+        {
+        }
+    };
 
     std::mutex m_mutex;
-    std::vector<ComPtr<ID2D1DeviceContext1>> m_deviceContexts;
-    
+    ID2D1Device1* m_d2dDevice;
+    std::atomic<bool> m_closed;
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<uint32_t> m_maximumSize;
+
+    std::atomic<uint32_t> m_activeLeaseCount;
+    std::atomic<uint32_t> m_peakActiveLeaseCount;
+    std::atomic<uint32_t> m_previousPeakActiveLeaseCount;
+    std::atomic<uint32_t> m_returnsSinceTrim;
+
+    std::atomic<uint64_t> m_hitCount;
+    std::atomic<uint64_t> m_missCount;
+    std::atomic<uint64_t> m_createCount;
+
+    // Counts returned contexts that were destroyed because the pool was full.
+    // Idle contexts released by Trim, Close or automatic trimming aren't
+    // included.
+    std::atomic<uint64_t> m_discardCount;
+
 public:
     DeviceContextPool(ID2D1Device1* d2dDevice);
+    ~DeviceContextPool();
 
     DeviceContextPool(DeviceContextPool const&) = delete;
     DeviceContextPool& operator=(DeviceContextPool const&) = delete;
 
     DeviceContextLease TakeLease();
 
+    uint32_t GetMaximumSize() const;
+    void SetMaximumSize(uint32_t value);
+
+    CanvasDeviceContextPoolStatistics GetStatistics() const;
+
+    // Releases all idle device contexts.
+    void Trim();
+
     void Close();
 
 private:
     void ReturnLease(ComPtr<ID2D1DeviceContext1>&& deviceContext);
 
+    ComPtr<ID2D1DeviceContext1> CreateDeviceContext();
+
+    void OnLeaseTaken();
+    void OnLeaseReturned();
+    void TrimIfIdle();
+    void TrimTo(uint32_t idleCount);
+    void DiscardSlots(uint32_t firstSlot, uint32_t endSlot);
+
+    static uint32_t GetPreferredSlot(uint32_t maximumSize);
+
     friend class DeviceContextLease;
 };
 
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "DirtyRegion.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    static bool IsEmpty(D2D1_RECT_L const& rectangle)
+    {
+        return rectangle.right <= rectangle.left || rectangle.bottom <= rectangle.top;
+    }
+
+
+    static bool OverlapsOrTouches(D2D1_RECT_L const& rectangle1, D2D1_RECT_L const& rectangle2)
+    {
+        return rectangle1.left <= rectangle2.right &&
+               rectangle2.left <= rectangle1.right &&
+               rectangle1.top <= rectangle2.bottom &&
+               rectangle2.top <= rectangle1.bottom;
+    }
+
+
+    DirtyRegion::DirtyRegion()
+        : m_isEverythingDirty(true)
+    {
+    }
+
+
+    void DirtyRegion::Add(D2D1_RECT_L const& rectangle)
+    {
+        if (IsEmpty(rectangle))
+            return;
+
+        Lock lock(m_mutex);
+
+        if (m_isEverythingDirty)
+            return;
+
+        auto merged = rectangle;
+
+        // Merging two rectangles can make the result overlap others that
+        // neither overlapped on its own, so keep going until nothing changes.
+        for (auto it = m_rectangles.begin(); it != m_rectangles.end(); )
+        {
+            if (OverlapsOrTouches(*it, merged))
+            {
+                merged = RectangleUnion(*it, merged);
+                m_rectangles.erase(it);
+                it = m_rectangles.begin();
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        m_rectangles.push_back(merged);
+
+        if (m_rectangles.size() > MaximumRectangleCount)
+        {
+            auto bounds = m_rectangles.front();
+
+            for (auto& r : m_rectangles)
+                bounds = RectangleUnion(bounds, r);
+
+            m_rectangles.assign(1, bounds);
+        }
+    }
+
+
+    void DirtyRegion::AddEverything()
+    {
+        Lock lock(m_mutex);
+
+        m_isEverythingDirty = true;
+        m_rectangles.clear();
+    }
+
+
+    void DirtyRegion::Clear()
+    {
+        Lock lock(m_mutex);
+
+        m_isEverythingDirty = false;
+        m_rectangles.clear();
+    }
+
+
+    std::vector<RECT> DirtyRegion::TakeRectangles(uint32_t width, uint32_t height)
+    {
+        Lock lock(m_mutex);
+
+        bool isEverythingDirty = m_isEverythingDirty;
+
+        std::vector<D2D1_RECT_L> rectangles;
+        rectangles.swap(m_rectangles);
+        m_isEverythingDirty = false;
+
+        lock.unlock();
+
+        std::vector<RECT> result;
+
+        if (isEverythingDirty)
+            return result;
+
+        auto surfaceWidth = static_cast<LONG>(std::min<uint32_t>(width, LONG_MAX));
+        auto surfaceHeight = static_cast<LONG>(std::min<uint32_t>(height, LONG_MAX));
+
+        for (auto& r : rectangles)
+        {
+            RECT clipped
+            {
+                std::max<LONG>(r.left, 0),
+                std::max<LONG>(r.top, 0),
+                std::min<LONG>(r.right, surfaceWidth),
+                std::min<LONG>(r.bottom, surfaceHeight)
+            };
+
+            if (clipped.right <= clipped.left || clipped.bottom <= clipped.top)
+                continue;
+
+            // A rectangle covering the whole surface is the same as no
+            // rectangles at all, which DXGI handles more cheaply.
+            if (clipped.left == 0 && clipped.top == 0 && clipped.right == surfaceWidth && clipped.bottom == surfaceHeight)
+                return std::vector<RECT>();
+
+            result.push_back(clipped);
+        }
+
+        return result;
+    }
+}}}}
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // Accumulates the parts of a swap chain's back buffer that have been drawn
+    // to since it was last presented, so that they can be passed to Present1
+    // as dirty rectangles.
+    //
+    // Rectangles are in pixels.  Overlapping or touching rectangles are merged
+    // as they are added, and once there are more than MaximumRectangleCount of
+    // them they are collapsed into their bounding rectangle, so the cost of
+    // tracking stays small however many draw calls are made.
+    //
+    // A region starts out with everything dirty, since the first present of a
+    // back buffer has to update all of it.
+    //
+    class DirtyRegion
+    {
+        std::mutex m_mutex;
+        bool m_isEverythingDirty;
+        std::vector<D2D1_RECT_L> m_rectangles;
+
+    public:
+        static const size_t MaximumRectangleCount = 8;
+
+        DirtyRegion();
+
+        DirtyRegion(DirtyRegion const&) = delete;
+        DirtyRegion& operator=(DirtyRegion const&) = delete;
+
+        void Add(D2D1_RECT_L const& rectangle);
+        void AddEverything();
+
+        // Marks nothing as dirty, for when the caller has presented some other
+        // way.
+        void Clear();
+
+        //
+        // Returns the dirty rectangles, clipped to a surface of the given size,
+        // and resets the region.  An empty result means that the whole surface
+        // should be presented.
+        //
+        std::vector<RECT> TakeRectangles(uint32_t width, uint32_t height);
+    };
+}}}}
@@ -8,6 +8,30 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects 
 {
+    // Identifies each call to InvalidateGraph, so effects reached along more
+    // than one path through a graph only propagate the change once.
+    static std::atomic<uint64_t> s_invalidationCount(0);
+
+
+    // State of the graph walk currently running on this thread.
+    struct EffectGraphWalk
+    {
+        int Depth;
+        CanvasEffectGraphStatistics Statistics;
+
+        // The effect that is asking for this source, if any.
+        CanvasEffect* Parent;
+
+        // Set while walking below an effect whose D2D resource is exposed through interop.
+        bool InsideExposedGraph;
+
+        // Set by the sources of the effect being validated, if any of them contain exposed effects.
+        bool FoundExposedEffects;
+    };
+
+    static thread_local EffectGraphWalk t_effectGraphWalk;
+
+
     CanvasEffect::CanvasEffect(IID const& effectId, unsigned int propertiesSize, unsigned int sourcesSize, bool isSourcesSizeFixed, ICanvasDevice* device, ID2D1Effect* effect, IInspectable* outerInspectable)
         : ResourceWrapper(effect, outerInspectable)
         , m_closed(false)
@@ -17,6 +41,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         , m_sources(sourcesSize)
         , m_cacheOutput(false)
         , m_bufferPrecision(D2D1_BUFFER_PRECISION_UNKNOWN)
+        , m_generation(1)
+        , m_lastInvalidation(0)
+        , m_validatedGeneration(0)
+        , m_validatedFlags(GetImageFlags::None)
+        , m_validatedDpi(0)
+        , m_interopExposed(effect != nullptr)
+        , m_containsExposedEffects(effect != nullptr)
+        , m_graphStatistics{}
     {
         // If this effect has a variable number of inputs, expose them as an IVector<>.
         if (!isSourcesSizeFixed)
@@ -122,6 +154,32 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         m_insideGetImage = true;
         auto clearFlagWarden = MakeScopeWarden([&] { m_insideGetImage = false; });
 
+        // The outermost effect of a walk records how many nodes it visited.
+        auto& walk = t_effectGraphWalk;
+        bool isRootOfWalk = (walk.Depth++ == 0);
+        auto walkDepthWarden = MakeScopeWarden([&] { walk.Depth--; });
+
+        if (isRootOfWalk)
+            walk.Statistics = CanvasEffectGraphStatistics{};
+
+        // Remember who is using us as a source, so they see any changes we make later.
+        auto parent = walk.Parent;
+        auto insideExposedGraph = walk.InsideExposedGraph;
+        auto parentFoundExposedEffects = walk.FoundExposedEffects;
+
+        auto walkParentWarden = MakeScopeWarden([&]
+        {
+            walk.Parent = parent;
+            walk.InsideExposedGraph = insideExposedGraph;
+            walk.FoundExposedEffects = parentFoundExposedEffects || m_containsExposedEffects;
+        });
+
+        walk.Parent = nullptr;
+        walk.FoundExposedEffects = false;
+
+        if (parent)
+            AddParent(parent);
+
         // Lock after the cycle detection, because m_mutex is not recursive.
         // Cycle checks don't need to be threadsafe because that's just a developer error.
         auto lock = Lock(m_mutex);
@@ -160,6 +218,18 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             m_realizationDevice.Set(d2dDevice.Get(), device);
         }
 
+        // Anything below an exposed effect can be reached through ID2D1Effect::GetInput.
+        // This comes after any Unrealize, which would otherwise clear it again.
+        if (insideExposedGraph)
+            MarkInteropExposed();
+
+        EventWrite_CanvasEffect_Realize_Start();
+        auto realizeEnd = MakeScopeWarden([] { EventWrite_CanvasEffect_Realize_Stop(); });
+
+        // Read the generation before doing any work, so changes made while
+        // we recurse cause the next draw to validate again.
+        auto generation = m_generation.load(std::memory_order_acquire);
+
         if (!HasResource())
         {
             // Create resource if not created yet.
@@ -167,13 +237,32 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             {
                 return nullptr;
             }
+
+            walk.Statistics.NodesVisited++;
+            MarkInputsValidated(generation, flags, targetDpi);
+            UpdateContainsExposedEffects(walk.FoundExposedEffects);
         }
         else if ((flags & GetImageFlags::MinimalRealization) == GetImageFlags::None)
         {
-            // Recurse through the effect graph to make sure child nodes are properly realized.
-            RefreshInputs(flags, targetDpi, deviceContext);
+            if (AreInputsValidated(flags, targetDpi))
+            {
+                // Nothing below this node has changed since it was last validated.
+                walk.Statistics.NodesSkipped++;
+            }
+            else
+            {
+                // Recurse through the effect graph to make sure child nodes are properly realized.
+                RefreshInputs(flags, targetDpi, deviceContext);
+
+                walk.Statistics.NodesVisited++;
+                MarkInputsValidated(generation, flags, targetDpi);
+                UpdateContainsExposedEffects(walk.FoundExposedEffects);
+            }
         }
 
+        if (isRootOfWalk)
+            m_graphStatistics = walk.Statistics;
+
         if (realizedDpi)
             *realizedDpi = 0;
 
@@ -205,7 +294,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                     flags |= GetImageFlags::AlwaysInsertDpiCompensation;
                 }
 
+                // Once the caller has the D2D effect they can change its inputs without telling us.
+                // Marking first means our sources are marked by this walk. Realizing on a new
+                // device clears the mark, so it is set again afterward.
+                MarkInteropExposed();
+
                 auto realizedEffect = GetD2DImage(device, nullptr, flags, dpi);
+
+                MarkInteropExposed();
                 
                 ThrowIfFailed(realizedEffect.CopyTo(iid, resource));
             });
@@ -218,6 +314,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     IFACEMETHODIMP CanvasEffect::Close()
     {
+        InvalidateGraph();
+
         ReleaseResource();
 
         m_realizationDevice.Reset();
@@ -301,7 +399,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             [&]
             {
                 CheckInPointer(count);
-                *count = static_cast<UINT>(m_properties.size());
+                *count = m_properties.GetCount();
             });
     }
 
@@ -313,7 +411,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             {
                 CheckAndClearOutPointer(value);
         
-                if (index >= m_properties.size())
+                if (index >= m_properties.GetCount())
                     ThrowHR(E_BOUNDS);
 
                 ThrowIfFailed(GetProperty(index).CopyTo(value));
@@ -668,6 +766,20 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
+    IFACEMETHODIMP CanvasEffect::get_GraphStatistics(CanvasEffectGraphStatistics* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+
+                auto lock = Lock(m_mutex);
+
+                *value = m_graphStatistics;
+            });
+    }
+
+
     unsigned int CanvasEffect::GetSourceCount()
     {
         auto lock = Lock(m_mutex);
@@ -724,6 +836,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         auto lock = Lock(m_mutex);
 
+        InvalidateGraph();
+
         auto& d2dEffect = MaybeGetResource();
 
         if (d2dEffect)
@@ -748,6 +862,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::InsertSource(unsigned int index, IGraphicsEffectSource* source)
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateGraph();
         
         auto& d2dEffect = MaybeGetResource();
 
@@ -788,6 +904,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::RemoveSource(unsigned int index)
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateGraph();
         
         auto& d2dEffect = MaybeGetResource();
 
@@ -835,6 +953,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::AppendSource(IGraphicsEffectSource* source)
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateGraph();
         
         auto& d2dEffect = MaybeGetResource();
 
@@ -858,6 +978,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     void CanvasEffect::ClearSources()
     {
         auto lock = Lock(m_mutex);
+
+        InvalidateGraph();
         
         // Effects with variable number of inputs don't allow zero of them,
         // so we must unrealize before we can clear the collection.
@@ -995,7 +1117,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             {
                 // Get the underlying D2D interface. This call recurses through the effect graph.
                 float realizedDpi;
-                auto realizedSource = As<ICanvasImageInternal>(source)->GetD2DImage(RealizationDevice(), deviceContext, flags, targetDpi, &realizedDpi);
+                auto realizedSource = GetSourceImage(As<ICanvasImageInternal>(source).Get(), flags, targetDpi, deviceContext, &realizedDpi);
 
                 bool resourceChanged = sourceInfo.UpdateResource(realizedSource.Get());
 
@@ -1011,6 +1133,175 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
+    ComPtr<ID2D1Image> CanvasEffect::GetSourceImage(ICanvasImageInternal* source, GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext, float* realizedDpi)
+    {
+        // Tell the source who is asking, so it can link back to us. This is restored
+        // afterward in case the source is not an effect and so never consumes it.
+        auto& walk = t_effectGraphWalk;
+
+        auto previousParent = walk.Parent;
+        auto previousInsideExposedGraph = walk.InsideExposedGraph;
+
+        auto walkWarden = MakeScopeWarden([&]
+        {
+            walk.Parent = previousParent;
+            walk.InsideExposedGraph = previousInsideExposedGraph;
+        });
+
+        walk.Parent = this;
+        walk.InsideExposedGraph = previousInsideExposedGraph || m_interopExposed;
+
+        return source->GetD2DImage(RealizationDevice(), deviceContext, flags, targetDpi, realizedDpi);
+    }
+
+
+    void CanvasEffect::AddParent(CanvasEffect* parent)
+    {
+        {
+            auto lock = Lock(m_parentsMutex);
+
+            auto it = std::find_if(m_parents.begin(), m_parents.end(), [&](ParentLink const& link) { return link.Effect == parent; });
+
+            // A dead link with the same address belongs to a parent that has since been destroyed.
+            if (it == m_parents.end() || !LockWeakRef<ICanvasEffect>(it->Weak))
+            {
+                // Drop links to parents that have gone away, so the list doesn't grow forever.
+                m_parents.erase(std::remove_if(m_parents.begin(), m_parents.end(), [](ParentLink& link) { return !LockWeakRef<ICanvasEffect>(link.Weak); }), m_parents.end());
+
+                m_parents.push_back(ParentLink{ AsWeak(static_cast<ICanvasEffect*>(parent)), parent });
+            }
+        }
+
+        // Parents of an exposed effect can't prove their inputs are unchanged either.
+        if (m_containsExposedEffects)
+            parent->MarkContainsExposedEffects();
+    }
+
+
+    std::vector<std::pair<ComPtr<ICanvasEffect>, CanvasEffect*>> CanvasEffect::GetParents()
+    {
+        auto lock = Lock(m_parentsMutex);
+
+        std::vector<std::pair<ComPtr<ICanvasEffect>, CanvasEffect*>> parents;
+
+        for (auto& link : m_parents)
+        {
+            // The strong reference keeps the parent alive while the caller uses the raw pointer.
+            auto strongParent = LockWeakRef<ICanvasEffect>(link.Weak);
+
+            if (strongParent)
+                parents.emplace_back(std::move(strongParent), link.Effect);
+        }
+
+        return parents;
+    }
+
+
+    void CanvasEffect::InvalidateGraph()
+    {
+        InvalidateGraph(++s_invalidationCount);
+    }
+
+
+    void CanvasEffect::InvalidateGraph(uint64_t invalidation)
+    {
+        // Effects reached along more than one path only need bumping once.
+        if (m_lastInvalidation.exchange(invalidation) == invalidation)
+            return;
+
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+
+        // Recurse without holding m_parentsMutex, as the graph may contain cycles.
+        for (auto& parent : GetParents())
+        {
+            parent.second->InvalidateGraph(invalidation);
+        }
+    }
+
+
+    void CanvasEffect::MarkInteropExposed()
+    {
+        // Effects above us may be partway through validating, having already
+        // seen that we weren't exposed. Invalidating makes them look again.
+        if (!m_interopExposed.exchange(true))
+            InvalidateGraph();
+
+        MarkContainsExposedEffects();
+    }
+
+
+    void CanvasEffect::MarkContainsExposedEffects()
+    {
+        if (m_containsExposedEffects.exchange(true))
+            return;
+
+        for (auto& parent : GetParents())
+        {
+            parent.second->MarkContainsExposedEffects();
+        }
+    }
+
+
+    // Called after all our sources have been walked, so we know exactly which of
+    // them contain exposed effects. This clears the flag once an exposed effect
+    // is no longer anywhere below us.
+    void CanvasEffect::UpdateContainsExposedEffects(bool sourcesContainExposedEffects)
+    {
+        m_containsExposedEffects = m_interopExposed || sourcesContainExposedEffects;
+    }
+
+
+    bool CanvasEffect::AreInputsValidated(GetImageFlags flags, float targetDpi)
+    {
+        if (m_validatedGeneration != m_generation.load(std::memory_order_acquire) ||
+            m_validatedFlags != flags ||
+            m_validatedDpi != targetDpi)
+        {
+            return false;
+        }
+
+        // If anything below this effect can be reached through interop, we can't
+        // know what might have changed, so it must always be fully revalidated.
+        if (m_containsExposedEffects)
+            return false;
+
+        // Make sure the D2D inputs still match what we last set. This
+        // is cheap compared to revalidating, so is worth double checking.
+        auto& d2dEffect = GetResource();
+
+        if (d2dEffect->GetInputCount() != m_sources.size())
+            return false;
+
+        for (unsigned int i = 0; i < m_sources.size(); ++i)
+        {
+            ComPtr<ID2D1Image> input;
+            d2dEffect->GetInput(i, &input);
+
+            auto& sourceInfo = m_sources[i];
+
+            IUnknown* expectedInput = sourceInfo.DpiCompensator ? sourceInfo.DpiCompensator.Get()
+                                                                : sourceInfo.GetResource();
+
+            if (!IsSameInstance(input.Get(), expectedInput))
+                return false;
+        }
+
+        return true;
+    }
+
+
+    void CanvasEffect::MarkInputsValidated(uint64_t generation, GetImageFlags flags, float targetDpi)
+    {
+        // Minimal realizations skip input validation, so there is nothing to remember.
+        if ((flags & GetImageFlags::MinimalRealization) != GetImageFlags::None)
+            return;
+
+        m_validatedGeneration = generation;
+        m_validatedFlags = flags;
+        m_validatedDpi = targetDpi;
+    }
+
+
     bool CanvasEffect::SetD2DInput(ID2D1Effect* d2dEffect, unsigned int index, IGraphicsEffectSource* source, GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext)
     {
         ComPtr<ID2D1Image> realizedSource;
@@ -1057,7 +1348,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             }
 
             // Get the underlying D2D interface. This call recurses through the effect graph.
-            realizedSource = internalSource->GetD2DImage(RealizationDevice(), deviceContext, flags, targetDpi, &realizedDpi);
+            realizedSource = GetSourceImage(internalSource.Get(), flags, targetDpi, deviceContext, &realizedDpi);
 
             if (!realizedSource)
             {
@@ -1116,95 +1407,183 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void CanvasEffect::SetProperty(unsigned int index, IPropertyValue* propertyValue)
+    void CanvasEffect::SetRawProperty(unsigned int index, EffectPropertyType type, void const* data, uint32_t size)
     {
         auto lock = Lock(m_mutex);
 
-        assert(index < m_properties.size());
+        assert(index < m_properties.GetCount());
 
         auto& d2dEffect = MaybeGetResource();
 
         if (d2dEffect)
         {
             // If we are realized, set the property value through to the underlying D2D resource.
-            SetD2DProperty(d2dEffect.Get(), index, propertyValue);
+            ThrowIfFailed(d2dEffect->SetValue(index, D2D1_PROPERTY_TYPE_UNKNOWN, static_cast<BYTE const*>(data), size));
         }
         else
         {
             // If we are not realized, directly store the property value.
-            m_properties[index] = propertyValue;
+            m_properties.SetValue(index, type, data, size);
         }
     }
 
 
-    void CanvasEffect::SetD2DProperty(ID2D1Effect* d2dEffect, unsigned int index, IPropertyValue* propertyValue)
+    void CanvasEffect::GetRawProperty(unsigned int index, void* data, uint32_t size)
     {
-        PropertyType propertyType;
-        ThrowIfFailed(propertyValue->get_Type(&propertyType));
+        auto lock = Lock(m_mutex);
 
-        switch (propertyType)
+        assert(index < m_properties.GetCount());
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
         {
-        case PropertyType_Boolean:
-            {
-                boolean value;
-                ThrowIfFailed(propertyValue->GetBoolean(&value));
-                ThrowIfFailed(d2dEffect->SetValue(index, static_cast<BOOL>(value)));
-            }
-            break;
+            // If we are realized, read the property value from the underlying D2D resource.
+            ThrowIfFailed(d2dEffect->GetValue(index, D2D1_PROPERTY_TYPE_UNKNOWN, static_cast<BYTE*>(data), size));
+        }
+        else
+        {
+            // If we are not realized, directly return the property value.
+            m_properties.GetValue(index, data, size);
+        }
+    }
 
-        case PropertyType_Int32:
-            {
-                INT32 value;
-                ThrowIfFailed(propertyValue->GetInt32(&value));
-                ThrowIfFailed(d2dEffect->SetValue(index, value));
-            }
-            break;
 
-        case PropertyType_UInt32:
-            {
-                UINT32 value;
-                ThrowIfFailed(propertyValue->GetUInt32(&value));
-                ThrowIfFailed(d2dEffect->SetValue(index, value));
-            }
-            break;
+    void CanvasEffect::GetSingleArrayProperty(unsigned int index, uint32_t* valueCount, float** value)
+    {
+        auto lock = Lock(m_mutex);
 
-        case PropertyType_Single:
-            {
-                float value;
-                ThrowIfFailed(propertyValue->GetSingle(&value));
-                ThrowIfFailed(d2dEffect->SetValue(index, value));
-            }
-            break;
+        assert(index < m_properties.GetCount());
 
-        case PropertyType_SingleArray:
-            {
-                ComArray<float> value;
-                ThrowIfFailed(propertyValue->GetSingleArray(value.GetAddressOfSize(), value.GetAddressOfData()));
-                ThrowIfFailed(d2dEffect->SetValue(index, reinterpret_cast<BYTE*>(value.GetData()), value.GetSize() * sizeof(float)));
-            }
+        auto& d2dEffect = MaybeGetResource();
+
+        auto sizeInBytes = d2dEffect ? d2dEffect->GetValueSize(index) : m_properties.GetValueSize(index);
+
+        ComArray<float> array(sizeInBytes / sizeof(float));
+
+        if (d2dEffect)
+            ThrowIfFailed(d2dEffect->GetValue(index, D2D1_PROPERTY_TYPE_UNKNOWN, reinterpret_cast<BYTE*>(array.GetData()), sizeInBytes));
+        else
+            m_properties.GetValue(index, array.GetData(), sizeInBytes);
+
+        array.Detach(valueCount, value);
+    }
+
+
+    void CanvasEffect::SetInspectableProperty(unsigned int index, IInspectable* value)
+    {
+        auto lock = Lock(m_mutex);
+
+        assert(index < m_properties.GetCount());
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+            SetD2DInspectableProperty(d2dEffect.Get(), index, value);
+        else
+            m_properties.SetInspectable(index, value);
+    }
+
+
+    ComPtr<IInspectable> CanvasEffect::GetInspectableProperty(unsigned int index)
+    {
+        auto lock = Lock(m_mutex);
+
+        assert(index < m_properties.GetCount());
+
+        auto& d2dEffect = MaybeGetResource();
+
+        if (d2dEffect)
+            return GetD2DInspectableProperty(d2dEffect.Get(), index);
+        else
+            return m_properties.GetInspectable(index);
+    }
+
+
+    void CanvasEffect::SetD2DInspectableProperty(ID2D1Effect* d2dEffect, unsigned int index, IInspectable* value)
+    {
+        auto d2dResource = value ? GetWrappedResource<IUnknown>(value, m_realizationDevice.GetWrapper()) : nullptr;
+
+        ThrowIfFailed(d2dEffect->SetValue(index, d2dResource.Get()));
+
+        // Windows has a bug that prevents reading back DESTINATION_COLOR_CONTEXT from a CLSID_D2D1ColorManagement effect.
+        // As a partial workaround, we cache this property value in the Win2D wrapper.
+        if (IsEqualGUID(m_effectId, CLSID_D2D1ColorManagement) && index == D2D1_COLORMANAGEMENT_PROP_DESTINATION_COLOR_CONTEXT)
+        {
+            m_workaround6146411 = d2dResource;
+        }
+    }
+
+
+    ComPtr<IInspectable> CanvasEffect::GetD2DInspectableProperty(ID2D1Effect* d2dEffect, unsigned int index)
+    {
+        ComPtr<IUnknown> d2dResource;
+
+        if (IsEqualGUID(m_effectId, CLSID_D2D1ColorManagement) && index == D2D1_COLORMANAGEMENT_PROP_DESTINATION_COLOR_CONTEXT)
+        {
+            // Windows has a bug that prevents reading back DESTINATION_COLOR_CONTEXT from a CLSID_D2D1ColorManagement effect.
+            // As a partial workaround, we cache this property value in the Win2D wrapper and return that instead.
+            // This is correct as long as the Win2D wrapper is kept alive, and the property is not changed via D2D interop.
+            d2dResource = m_workaround6146411;
+        }
+        else
+        {
+            d2dResource.Attach(d2dEffect->GetValue<IUnknown*>(index));
+        }
+
+        return d2dResource ? ResourceManager::GetOrCreate(m_realizationDevice.GetWrapper(), d2dResource.Get(), 0) : nullptr;
+    }
+
+
+    // Reads a property value back from the D2D effect into m_properties, using the
+    // same representation that GetD2DProperty would box it as.
+    void CanvasEffect::StoreD2DProperty(ID2D1Effect* d2dEffect, unsigned int index)
+    {
+        EffectPropertyType type;
+        uint32_t size = sizeof(uint32_t);
+
+        switch (d2dEffect->GetType(index))
+        {
+        case D2D1_PROPERTY_TYPE_BOOL:
+            type = EffectPropertyType::Boolean;
             break;
 
-        case PropertyType_InspectableArray:
-            {
-                ComPtr<IInspectable> wrapper;
-                GetValueOfProperty(propertyValue, wrapper.GetAddressOf());
+        case D2D1_PROPERTY_TYPE_INT32:
+        case D2D1_PROPERTY_TYPE_UINT32:     // Not a mistake: unsigned DImage properties are exposed in WinRT as signed.
+            type = EffectPropertyType::Int32;
+            break;
 
-                auto d2dResource = wrapper ? GetWrappedResource<IUnknown>(wrapper, m_realizationDevice.GetWrapper()) : nullptr;
+        case D2D1_PROPERTY_TYPE_ENUM:
+            type = EffectPropertyType::UInt32;
+            break;
 
-                ThrowIfFailed(d2dEffect->SetValue(index, d2dResource.Get()));
+        case D2D1_PROPERTY_TYPE_FLOAT:
+            type = EffectPropertyType::Single;
+            break;
 
-                // Windows has a bug that prevents reading back DESTINATION_COLOR_CONTEXT from a CLSID_D2D1ColorManagement effect.
-                // As a partial workaround, we cache this property value in the Win2D wrapper.
-                if (IsEqualGUID(m_effectId, CLSID_D2D1ColorManagement) && index == D2D1_COLORMANAGEMENT_PROP_DESTINATION_COLOR_CONTEXT)
-                {
-                    m_workaround6146411 = d2dResource;
-                }
-            }
+        case D2D1_PROPERTY_TYPE_VECTOR2:
+        case D2D1_PROPERTY_TYPE_VECTOR3:
+        case D2D1_PROPERTY_TYPE_VECTOR4:
+        case D2D1_PROPERTY_TYPE_MATRIX_3X2:
+        case D2D1_PROPERTY_TYPE_MATRIX_4X4:
+        case D2D1_PROPERTY_TYPE_MATRIX_5X4:
+        case D2D1_PROPERTY_TYPE_BLOB:
+            type = EffectPropertyType::SingleArray;
+            size = d2dEffect->GetValueSize(index);
             break;
 
+        case D2D1_PROPERTY_TYPE_IUNKNOWN:
+        case D2D1_PROPERTY_TYPE_COLOR_CONTEXT:
+            m_properties.SetInspectable(index, GetD2DInspectableProperty(d2dEffect, index).Get());
+            return;
+
         default:
             ThrowHR(E_NOTIMPL);
         }
+
+        auto data = m_properties.AllocateValue(index, type, size);
+
+        ThrowIfFailed(d2dEffect->GetValue(index, D2D1_PROPERTY_TYPE_UNKNOWN, data, size));
     }
 
 
@@ -1212,31 +1591,33 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         auto lock = Lock(m_mutex);
 
-        assert(index < m_properties.size());
+        assert(index < m_properties.GetCount());
 
         auto& d2dEffect = MaybeGetResource();
 
         if (d2dEffect)
         {
-            // If we are realized, read the property value from the underlying D2D resource.
+            // If we are realized, box the property value read from the underlying D2D resource.
             return GetD2DProperty(d2dEffect.Get(), index);
         }
         else
         {
-            // If we are not realized, directly return the property value.
-            return m_properties[index];
+            // If we are not realized, box the stored property value.
+            return m_properties.Box(m_propertyValueFactory.Get(), index);
         }
     }
 
 
     ComPtr<IPropertyValue> CanvasEffect::GetD2DProperty(ID2D1Effect* d2dEffect, unsigned int index)
     {
+        ComPtr<IPropertyValue> propertyValue;
+
         switch (d2dEffect->GetType(index))
         {
         case D2D1_PROPERTY_TYPE_BOOL:
             {
                 BOOL value = d2dEffect->GetValue<BOOL>(index);
-                return CreateProperty(m_propertyValueFactory.Get(), static_cast<boolean>(value));
+                ThrowIfFailed(m_propertyValueFactory->CreateBoolean(static_cast<boolean>(value), &propertyValue));
             }
             break;
 
@@ -1244,21 +1625,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         case D2D1_PROPERTY_TYPE_UINT32:     // Not a mistake: unsigned DImage properties are exposed in WinRT as signed.
             {
                 INT32 value = d2dEffect->GetValue<INT32>(index);
-                return CreateProperty(m_propertyValueFactory.Get(), value);
+                ThrowIfFailed(m_propertyValueFactory->CreateInt32(value, &propertyValue));
             }
             break;
 
         case D2D1_PROPERTY_TYPE_ENUM:
             {
                 UINT32 value = d2dEffect->GetValue<UINT32>(index);
-                return CreateProperty(m_propertyValueFactory.Get(), value);
+                ThrowIfFailed(m_propertyValueFactory->CreateUInt32(value, &propertyValue));
             }
             break;
 
         case D2D1_PROPERTY_TYPE_FLOAT:
             {
                 float value = d2dEffect->GetValue<float>(index);
-                return CreateProperty(m_propertyValueFactory.Get(), value);
+                ThrowIfFailed(m_propertyValueFactory->CreateSingle(value, &propertyValue));
             }
             break;
 
@@ -1276,36 +1657,26 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 std::vector<BYTE> value(sizeInBytes);
                 ThrowIfFailed(d2dEffect->GetValue(index, value.data(), sizeInBytes));
 
-                return CreateProperty(m_propertyValueFactory.Get(), sizeInFloats, reinterpret_cast<float*>(value.data()));
+                ThrowIfFailed(m_propertyValueFactory->CreateSingleArray(sizeInFloats, reinterpret_cast<float*>(value.data()), &propertyValue));
             }
             break;
 
         case D2D1_PROPERTY_TYPE_IUNKNOWN:
         case D2D1_PROPERTY_TYPE_COLOR_CONTEXT:
             {
-                ComPtr<IUnknown> d2dResource;
-
-                if (IsEqualGUID(m_effectId, CLSID_D2D1ColorManagement) && index == D2D1_COLORMANAGEMENT_PROP_DESTINATION_COLOR_CONTEXT)
-                {
-                    // Windows has a bug that prevents reading back DESTINATION_COLOR_CONTEXT from a CLSID_D2D1ColorManagement effect.
-                    // As a partial workaround, we cache this property value in the Win2D wrapper and return that instead.
-                    // This is correct as long as the Win2D wrapper is kept alive, and the property is not changed via D2D interop.
-                    d2dResource = m_workaround6146411;
-                }
-                else
-                {
-                    d2dResource.Attach(d2dEffect->GetValue<IUnknown*>(index));
-                }
+                // IPropertyValue provides CreateInspectableArray, but not CreateInspectable.
+                auto wrapper = GetD2DInspectableProperty(d2dEffect, index);
+                auto wrapperPtr = wrapper.Get();
 
-                auto wrapper = d2dResource ? ResourceManager::GetOrCreate(m_realizationDevice.GetWrapper(), d2dResource.Get(), 0) : nullptr;
-
-                return CreateProperty(m_propertyValueFactory.Get(), wrapper.Get());
+                ThrowIfFailed(m_propertyValueFactory->CreateInspectableArray(1, &wrapperPtr, &propertyValue));
             }
             break;
 
         default:
             ThrowHR(E_NOTIMPL);
         }
+
+        return propertyValue;
     }
 
 
@@ -1323,9 +1694,22 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         auto d2dEffect = CreateD2DEffect(deviceContext, m_effectId);
 
         // Transfer property values from our resource independent m_properties store to the D2D effect.
-        for (unsigned i = 0; i < m_properties.size(); ++i)
+        // Properties that were never set keep their D2D defaults.
+        for (unsigned i = 0; i < m_properties.GetCount(); ++i)
         {
-            SetD2DProperty(d2dEffect.Get(), i, m_properties[i].Get());
+            switch (m_properties.GetType(i))
+            {
+            case EffectPropertyType::Unset:
+                break;
+
+            case EffectPropertyType::Inspectable:
+                SetD2DInspectableProperty(d2dEffect.Get(), i, m_properties.GetInspectable(i).Get());
+                break;
+
+            default:
+                ThrowIfFailed(d2dEffect->SetValue(i, D2D1_PROPERTY_TYPE_UNKNOWN, m_properties.GetValueData(i), m_properties.GetValueSize(i)));
+                break;
+            }
         }
 
         // Also transfer the special properties that are common to all effects (CacheOutput and BufferPrecision).
@@ -1345,7 +1729,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
 
         // Wipe m_properties, as the D2D effect is now the One True Source Of Authoritativeness.
-        m_properties.assign(m_properties.size(), nullptr);
+        m_properties.Clear();
 
         // Store the new effect.
         SetResource(d2dEffect.Get());
@@ -1356,14 +1740,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     void CanvasEffect::Unrealize(unsigned int skipSourceIndex, bool skipAllSources)
     {
+        // Any effects that use this one as a source will need to pick up its new D2D resource.
+        InvalidateGraph();
+
+        // Interop callers can't reach the D2D resource we create next. If this effect is
+        // still below an exposed one, the next graph walk will mark it exposed again.
+        m_interopExposed = false;
+
         auto& d2dEffect = MaybeGetResource();
 
         if (d2dEffect)
         {
             // Transfer property values from the D2D effect to our resource independent m_properties store.
-            for (unsigned i = 0; i < m_properties.size(); ++i)
+            for (unsigned i = 0; i < m_properties.GetCount(); ++i)
             {
-                m_properties[i] = GetD2DProperty(d2dEffect.Get(), i);
+                StoreD2DProperty(d2dEffect.Get(), i);
             }
 
             // Also transfer the special properties that are common to all effects (CacheOutput and BufferPrecision).
@@ -57,7 +57,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         CachedResourceReference<ID2D1Device, ICanvasDevice> m_realizationDevice;
 
         // Effect property values (only used when the effect is not realized).
-        std::vector<ComPtr<IPropertyValue>> m_properties;
+        EffectPropertyStore m_properties;
 
         boolean m_cacheOutput;
         D2D1_BUFFER_PRECISION m_bufferPrecision;
@@ -125,6 +125,42 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         static std::pair<IID, MakeEffectFunction> m_effectMakers[];
 
 
+        // Incremental revalidation of effect graphs. Any change that could alter the
+        // D2D inputs of an effect (setting sources, unrealizing, or closing) bumps its
+        // generation, and that of every effect which has used it as a source. An effect
+        // whose inputs were validated at its current generation, with the same flags and
+        // DPI, need not recurse into its sources. This also means shared subgraphs are
+        // only walked once per draw.
+        std::atomic<uint64_t> m_generation;
+        std::atomic<uint64_t> m_lastInvalidation;
+
+        uint64_t m_validatedGeneration;
+        GetImageFlags m_validatedFlags;
+        float m_validatedDpi;
+
+        // Effects whose D2D resource is reachable through interop can have their inputs
+        // changed behind our back, as can everything below them. m_containsExposedEffects
+        // is set on those and everything above them, which must then always revalidate.
+        // It is recomputed each time our inputs are fully revalidated, so it clears once no
+        // exposed effect is left below us. m_interopExposed clears when we unrealize.
+        std::atomic<bool> m_interopExposed;
+        std::atomic<bool> m_containsExposedEffects;
+
+        // Effects that have used this one as a source. Links are added the first time a
+        // parent realizes or validates us, and are only dropped when the parent goes away.
+        struct ParentLink
+        {
+            WeakRef Weak;
+            CanvasEffect* Effect;
+        };
+
+        std::mutex m_parentsMutex;
+        std::vector<ParentLink> m_parents;
+
+        // How much of the graph was walked the last time it was realized starting from this effect.
+        CanvasEffectGraphStatistics m_graphStatistics;
+
+
     protected:
         // Constructor.
         CanvasEffect(IID const& m_effectId, unsigned int propertiesSize, unsigned int sourcesSize, bool isSourcesSizeFixed, ICanvasDevice* device, ID2D1Effect* effect, IInspectable* outerInspectable);
@@ -199,6 +235,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHOD(GetInvalidRectangles)(ICanvasResourceCreatorWithDpi* resourceCreator, uint32_t* valueCount, Rect** valueElements) override;
         IFACEMETHOD(GetRequiredSourceRectangle)(ICanvasResourceCreatorWithDpi* resourceCreator, Rect outputRectangle, ICanvasEffect* sourceEffect, uint32_t sourceIndex, Rect sourceBounds, Rect* value) override;
         IFACEMETHOD(GetRequiredSourceRectangles)(ICanvasResourceCreatorWithDpi* resourceCreator, Rect outputRectangle, uint32_t sourceEffectCount, ICanvasEffect** sourceEffects, uint32_t sourceIndexCount, uint32_t* sourceIndices, uint32_t sourceBoundsCount, Rect* sourceBounds, uint32_t* valueCount, Rect** valueElements) override;
+        IFACEMETHOD(get_GraphStatistics)(CanvasEffectGraphStatistics* value) override;
 
 
     protected:
@@ -208,31 +245,43 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // enums are stored as unsigned integers, vectors and matrices as float arrays, and
         // colors as float[3] or float[4] depending on whether they include alpha.
         //
+        // Despite the names, values are not actually boxed: they are converted to the raw
+        // form D2D expects and either written straight through to the realized D2D effect,
+        // or kept in m_properties until it is realized. Only the IGraphicsEffectD2D1Interop
+        // GetProperty path creates IPropertyValue objects.
+        //
 
         template<typename TBoxed, typename TPublic>
         void SetBoxedProperty(unsigned int index, TPublic const& value)
         {
-            auto boxedValue = PropertyTypeConverter<TBoxed, TPublic>::Box(m_propertyValueFactory.Get(), value);
+            typedef PropertyTypeConverter<TBoxed, TPublic> Converter;
 
-            SetProperty(index, boxedValue.Get());
+            SetRawProperty(index, Converter::Type, Converter::ToRaw(value));
         }
 
         template<typename TBoxed, typename TPublic>
         void GetBoxedProperty(unsigned int index, TPublic* value)
         {
+            typedef PropertyTypeConverter<TBoxed, TPublic> Converter;
+
             CheckInPointer(value);
 
-            auto boxedValue = GetProperty(index);
+            typename Converter::RawType rawValue{};
+
+            GetRawProperty(index, &rawValue);
 
-            PropertyTypeConverter<TBoxed, TPublic>::Unbox(boxedValue.Get(), value);
+            Converter::FromRaw(rawValue, value);
         }
 
         template<typename T>
         void SetArrayProperty(unsigned int index, uint32_t valueCount, T const* value)
         {
-            auto boxedValue = CreateProperty(m_propertyValueFactory.Get(), valueCount, value);
+            static_assert(std::is_same<T, float>::value, "Only float array properties are supported");
 
-            SetProperty(index, boxedValue.Get());
+            if (valueCount)
+                CheckInPointer(value);
+
+            SetRawProperty(index, EffectPropertyType::SingleArray, value, static_cast<uint32_t>(valueCount * sizeof(float)));
         }
 
         template<typename T>
@@ -244,12 +293,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         template<typename T>
         void GetArrayProperty(unsigned int index, uint32_t* valueCount, T** value)
         {
+            static_assert(std::is_same<T, float>::value, "Only float array properties are supported");
+
             CheckInPointer(valueCount);
             CheckAndClearOutPointer(value);
 
-            auto boxedValue = GetProperty(index);
-
-            GetValueOfProperty(boxedValue.Get(), valueCount, value);
+            GetSingleArrayProperty(index, valueCount, value);
         }
 
 
@@ -277,13 +326,64 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<ID2D1Effect> CreateD2DEffect(ID2D1DeviceContext* deviceContext, IID const& effectId);
         bool ApplyDpiCompensation(unsigned int index, ComPtr<ID2D1Image>& inputImage, float inputDpi, GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext);
         void RefreshInputs(GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext);
+
+        ComPtr<ID2D1Image> GetSourceImage(ICanvasImageInternal* source, GetImageFlags flags, float targetDpi, ID2D1DeviceContext* deviceContext, float* realizedDpi);
+
+        void AddParent(CanvasEffect* parent);
+        std::vector<std::pair<ComPtr<ICanvasEffect>, CanvasEffect*>> GetParents();
+
+        void InvalidateGraph();
+        void InvalidateGraph(uint64_t invalidation);
+        void MarkInteropExposed();
+        void MarkContainsExposedEffects();
+        void UpdateContainsExposedEffects(bool sourcesContainExposedEffects);
+
+        bool AreInputsValidated(GetImageFlags flags, float targetDpi);
+        void MarkInputsValidated(uint64_t generation, GetImageFlags flags, float targetDpi);
         
         bool SetD2DInput(ID2D1Effect* d2dEffect, unsigned int index, IGraphicsEffectSource* source, GetImageFlags flags, float targetDpi = 0, ID2D1DeviceContext* deviceContext = nullptr);
         ComPtr<IGraphicsEffectSource> GetD2DInput(ID2D1Effect* d2dEffect, unsigned int index);
 
-        void SetProperty(unsigned int index, IPropertyValue* propertyValue);
-        void SetD2DProperty(ID2D1Effect* d2dEffect, unsigned int index, IPropertyValue* propertyValue);
+        void SetRawProperty(unsigned int index, EffectPropertyType type, void const* data, uint32_t size);
+        void GetRawProperty(unsigned int index, void* data, uint32_t size);
+        void GetSingleArrayProperty(unsigned int index, uint32_t* valueCount, float** value);
 
+        void SetInspectableProperty(unsigned int index, IInspectable* value);
+        ComPtr<IInspectable> GetInspectableProperty(unsigned int index);
+
+        // Overloads used by SetBoxedProperty and GetBoxedProperty to select between plain data and interface values.
+        template<typename TRaw>
+        void SetRawProperty(unsigned int index, EffectPropertyType type, TRaw const& value)
+        {
+            static_assert(std::is_pod<TRaw>::value, "Raw property values must be plain-old-data");
+
+            SetRawProperty(index, type, &value, sizeof(value));
+        }
+
+        void SetRawProperty(unsigned int index, EffectPropertyType, ComPtr<IInspectable> const& value)
+        {
+            SetInspectableProperty(index, value.Get());
+        }
+
+        template<typename TRaw>
+        void GetRawProperty(unsigned int index, TRaw* value)
+        {
+            static_assert(std::is_pod<TRaw>::value, "Raw property values must be plain-old-data");
+
+            GetRawProperty(index, value, sizeof(*value));
+        }
+
+        void GetRawProperty(unsigned int index, ComPtr<IInspectable>* value)
+        {
+            *value = GetInspectableProperty(index);
+        }
+
+        void SetD2DInspectableProperty(ID2D1Effect* d2dEffect, unsigned int index, IInspectable* value);
+        ComPtr<IInspectable> GetD2DInspectableProperty(ID2D1Effect* d2dEffect, unsigned int index);
+
+        void StoreD2DProperty(ID2D1Effect* d2dEffect, unsigned int index);
+
+        // Boxes a property value, for IGraphicsEffectD2D1Interop::GetProperty.
         ComPtr<IPropertyValue> GetProperty(unsigned int index);
         ComPtr<IPropertyValue> GetD2DProperty(ID2D1Effect* d2dEffect, unsigned int index);
 
@@ -304,44 +404,38 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // PropertyTypeConverter is responsible for converting values between TBoxed and TPublic forms.
         // This is designed to produce compile errors if incompatible types are specified.
         //
+        // Each converter exposes the RawType that is passed to ID2D1Effect::SetValue, the
+        // EffectPropertyType it is stored as, and ToRaw/FromRaw conversion functions.
+        //
 
         template<typename TBoxed, typename TPublic, typename Enable = void>
-        struct PropertyTypeConverter
+        struct PropertyTypeConverter : public RawPropertyTraits<TBoxed>
         {
             static_assert(std::is_same<TBoxed, TPublic>::value, "Default PropertyTypeConverter should only be used when TBoxed = TPublic");
-
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, TPublic const& value)
-            {
-                return CreateProperty(factory, value);
-            }
-
-            static void Unbox(IPropertyValue* propertyValue, TPublic* result)
-            {
-                GetValueOfProperty(propertyValue, result);
-            }
         };
 
 
-        // Enum values are boxed as unsigned integers.
+        // Enum values are stored as unsigned integers.
         template<typename TPublic>
         struct PropertyTypeConverter<uint32_t, TPublic,
                                      typename std::enable_if<std::is_enum<TPublic>::value>::type>
         {
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, TPublic value)
+            typedef uint32_t RawType;
+            static const EffectPropertyType Type = EffectPropertyType::UInt32;
+
+            static RawType ToRaw(TPublic value)
             {
-                return CreateProperty(factory, static_cast<uint32_t>(value));
+                return static_cast<uint32_t>(value);
             }
 
-            static void Unbox(IPropertyValue* propertyValue, TPublic* result)
+            static void FromRaw(RawType value, TPublic* result)
             {
-                uint32_t value;
-                GetValueOfProperty(propertyValue, &value);
                 *result = static_cast<TPublic>(value);
             }
         };
 
 
-        // Vectors and matrices are boxed as float arrays.
+        // Vectors and matrices are stored as float arrays, which have the same layout.
         template<int N, typename TPublic>
         struct PropertyTypeConverter<float[N], TPublic>
         {
@@ -351,108 +445,97 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                           std::is_same<TPublic, Numerics::Matrix3x2>::value ||
                           std::is_same<TPublic, Numerics::Matrix4x4>::value ||
                           std::is_same<TPublic, Matrix5x4>::value,
-                          "This type cannot be boxed as a float array");
+                          "This type cannot be stored as a float array");
 
             static_assert(sizeof(TPublic) == sizeof(float[N]), "Wrong array size");
 
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, TPublic const& value)
+            typedef TPublic RawType;
+            static const EffectPropertyType Type = EffectPropertyType::SingleArray;
+
+            static RawType ToRaw(TPublic const& value)
             {
-                ComPtr<IPropertyValue> propertyValue;
-                ThrowIfFailed(factory->CreateSingleArray(N, (float*)&value, &propertyValue));
-                return propertyValue;
+                return value;
             }
 
-            static void Unbox(IPropertyValue* propertyValue, TPublic* result)
+            static void FromRaw(RawType const& value, TPublic* result)
             {
-                ComArray<float> value;
-
-                ThrowIfFailed(propertyValue->GetSingleArray(value.GetAddressOfSize(), value.GetAddressOfData()));
-
-                if (value.GetSize() != N)
-                    ThrowHR(E_BOUNDS);
-
-                *result = *reinterpret_cast<TPublic*>(value.GetData());
+                *result = value;
             }
         };
 
 
-        // Color can be boxed as a float4 (for properties that include alpha).
+        // Color can be stored as a float4 (for properties that include alpha).
         template<>
         struct PropertyTypeConverter<float[4], Color>
         {
-            typedef PropertyTypeConverter<float[4], Numerics::Vector4> VectorConverter;
+            typedef Numerics::Vector4 RawType;
+            static const EffectPropertyType Type = EffectPropertyType::SingleArray;
 
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, Color const& value)
+            static RawType ToRaw(Color const& value)
             {
-                return VectorConverter::Box(factory, ToVector4(value));
+                return ToVector4(value);
             }
 
-            static void Unbox(IPropertyValue* propertyValue, Color* result)
+            static void FromRaw(RawType const& value, Color* result)
             {
-                Numerics::Vector4 value;
-                VectorConverter::Unbox(propertyValue, &value);
                 *result = ToWindowsColor(value);
             }
         };
 
 
-        // Color can also be boxed as float3 (for properties that only use rgb).
+        // Color can also be stored as float3 (for properties that only use rgb).
         template<>
         struct PropertyTypeConverter<float[3], Color>
         {
-            typedef PropertyTypeConverter<float[3], Numerics::Vector3> VectorConverter;
+            typedef Numerics::Vector3 RawType;
+            static const EffectPropertyType Type = EffectPropertyType::SingleArray;
 
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, Color const& value)
+            static RawType ToRaw(Color const& value)
             {
-                return VectorConverter::Box(factory, ToVector3(value));
+                return ToVector3(value);
             }
 
-            static void Unbox(IPropertyValue* propertyValue, Color* result)
+            static void FromRaw(RawType const& value, Color* result)
             {
-                Numerics::Vector3 value;
-                VectorConverter::Unbox(propertyValue, &value);
                 *result = ToWindowsColor(value);
             }
         };
 
 
-        // HDR color (Vector4) can be boxed as a float3 (for properties that only use rgb).
+        // HDR color (Vector4) can be stored as a float3 (for properties that only use rgb).
         template<>
         struct PropertyTypeConverter<ConvertColorHdrToVector3, Numerics::Vector4>
         {
-            typedef PropertyTypeConverter<float[3], Numerics::Vector3> VectorConverter;
+            typedef Numerics::Vector3 RawType;
+            static const EffectPropertyType Type = EffectPropertyType::SingleArray;
 
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, Numerics::Vector4 const& value)
+            static RawType ToRaw(Numerics::Vector4 const& value)
             {
-                return VectorConverter::Box(factory, Numerics::Vector3{ value.X, value.Y, value.Z });
+                return Numerics::Vector3{ value.X, value.Y, value.Z };
             }
 
-            static void  Unbox(IPropertyValue* propertyValue, Numerics::Vector4* result)
+            static void FromRaw(RawType const& value, Numerics::Vector4* result)
             {
-                Numerics::Vector3 value;
-                VectorConverter::Unbox(propertyValue, &value);
                 *result = Numerics::Vector4{ value.X, value.Y, value.Z, 1.0f };
             }
         };
 
 
-        // Rect is boxed as a float4, after converting WinRT x/y/w/h format to D2D left/top/right/bottom.
+        // Rect is stored as a float4, after converting WinRT x/y/w/h format to D2D left/top/right/bottom.
         template<>
         struct PropertyTypeConverter<float[4], Rect>
         {
-            typedef PropertyTypeConverter<float[4], Numerics::Vector4> VectorConverter;
+            typedef D2D1_RECT_F RawType;
+            static const EffectPropertyType Type = EffectPropertyType::SingleArray;
 
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, Rect const& value)
+            static RawType ToRaw(Rect const& value)
             {
-                auto d2dRect = ToD2DRect(value);
-                return VectorConverter::Box(factory, *ReinterpretAs<Numerics::Vector4*>(&d2dRect));
+                return ToD2DRect(value);
             }
 
-            static void Unbox(IPropertyValue* propertyValue, Rect* result)
+            static void FromRaw(RawType const& value, Rect* result)
             {
-                Numerics::Vector4 value;
-                VectorConverter::Unbox(propertyValue, &value);
-                *result = FromD2DRect(*ReinterpretAs<D2D1_RECT_F*>(&value));
+                *result = FromD2DRect(value);
             }
         };
 
@@ -461,15 +544,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         template<>
         struct PropertyTypeConverter<ConvertRadiansToDegrees, float>
         {
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, float value)
+            typedef float RawType;
+            static const EffectPropertyType Type = EffectPropertyType::Single;
+
+            static RawType ToRaw(float value)
             {
-                return CreateProperty(factory, ::DirectX::XMConvertToDegrees(value));
+                return ::DirectX::XMConvertToDegrees(value);
             }
 
-            static void Unbox(IPropertyValue* propertyValue, float* result)
+            static void FromRaw(RawType degrees, float* result)
             {
-                float degrees;
-                GetValueOfProperty(propertyValue, &degrees);
                 *result = ::DirectX::XMConvertToRadians(degrees);
             }
         };
@@ -482,92 +566,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             static_assert(D2D1_COLORMATRIX_ALPHA_MODE_PREMULTIPLIED == D2D1_ALPHA_MODE_PREMULTIPLIED, "Enum values should match");
             static_assert(D2D1_COLORMATRIX_ALPHA_MODE_STRAIGHT == D2D1_ALPHA_MODE_STRAIGHT, "Enum values should match");
 
-            static ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, CanvasAlphaMode value)
+            typedef uint32_t RawType;
+            static const EffectPropertyType Type = EffectPropertyType::UInt32;
+
+            static RawType ToRaw(CanvasAlphaMode value)
             {
                 if (value == CanvasAlphaMode::Ignore)
                     ThrowHR(E_INVALIDARG);
 
-                return CreateProperty(factory, static_cast<uint32_t>(ToD2DAlphaMode(value)));
+                return static_cast<uint32_t>(ToD2DAlphaMode(value));
             }
 
-            static void Unbox(IPropertyValue* propertyValue, CanvasAlphaMode* result)
+            static void FromRaw(RawType value, CanvasAlphaMode* result)
             {
-                uint32_t value;
-                GetValueOfProperty(propertyValue, &value);
                 *result = FromD2DAlphaMode(static_cast<D2D1_ALPHA_MODE>(value));
             }
         };
 
 
-        //
-        // Wrap the IPropertyValue accessors (which use different method names for each type) with
-        // overloaded C++ versions that can be used by generic PropertyTypeConverter implementations.
-        //
-
-#define PROPERTY_TYPE_ACCESSOR(TYPE, WINRT_NAME)                                                        \
-        static ComPtr<IPropertyValue> CreateProperty(IPropertyValueStatics* factory, TYPE const& value) \
-        {                                                                                               \
-            ComPtr<IPropertyValue> propertyValue;                                                       \
-            ThrowIfFailed(factory->Create##WINRT_NAME(value, &propertyValue));                          \
-            return propertyValue;                                                                       \
-        }                                                                                               \
-                                                                                                        \
-        static void GetValueOfProperty(IPropertyValue* propertyValue, TYPE* result)                     \
-        {                                                                                               \
-            ThrowIfFailed(propertyValue->Get##WINRT_NAME(result));                                      \
-        }
-
-#define ARRAY_PROPERTY_TYPE_ACCESSOR(TYPE, WINRT_NAME)                                                                          \
-        static ComPtr<IPropertyValue> CreateProperty(IPropertyValueStatics* factory, uint32_t valueCount, TYPE const* value)    \
-        {                                                                                                                       \
-            ComPtr<IPropertyValue> propertyValue;                                                                               \
-            ThrowIfFailed(factory->Create##WINRT_NAME##Array(valueCount, const_cast<TYPE*>(value), &propertyValue));            \
-            return propertyValue;                                                                                               \
-        }                                                                                                                       \
-                                                                                                                                \
-        static void GetValueOfProperty(IPropertyValue* propertyValue, uint32_t* valueCount, TYPE** value)                       \
-        {                                                                                                                       \
-            ThrowIfFailed(propertyValue->Get##WINRT_NAME##Array(valueCount, value));                                            \
-        }
-
-        PROPERTY_TYPE_ACCESSOR(float,    Single)
-        PROPERTY_TYPE_ACCESSOR(int32_t,  Int32)
-        PROPERTY_TYPE_ACCESSOR(uint32_t, UInt32)
-        PROPERTY_TYPE_ACCESSOR(boolean,  Boolean)
-        
-        ARRAY_PROPERTY_TYPE_ACCESSOR(float, Single)
-
-#undef PROPERTY_TYPE_ACCESSOR
-#undef ARRAY_PROPERTY_TYPE_ACCESSOR
-
-
-        // Interface types are stored as a PropertyType_InspectableArray containing a single IInspectable.
-        // This is because IPropertyValue provides CreateInspectableArray, but not CreateInspectable.
-        static ComPtr<IPropertyValue> CreateProperty(IPropertyValueStatics* factory, IInspectable* value)
-        {
-            ComPtr<IPropertyValue> propertyValue;
-            ThrowIfFailed(factory->CreateInspectableArray(1, &value, &propertyValue));
-            return propertyValue;
-        }
-
-        template<typename T>
-        static void GetValueOfProperty(IPropertyValue* propertyValue, T** result)
-        {
-            static_assert(std::is_base_of<IInspectable, T>::value, "Interface types must be IInspectable");
-            
-            ComArray<ComPtr<IInspectable>> value;
-            ThrowIfFailed(propertyValue->GetInspectableArray(value.GetAddressOfSize(), value.GetAddressOfData()));
-
-            if (value.GetSize() != 1)
-                ThrowHR(E_NOTIMPL);
-
-            if (value[0])
-                ThrowIfFailed(value[0].CopyTo(result));
-            else
-                *result = nullptr;
-        }
-
-
         //
         // Macros used by the generated strongly typed effect subclasses
         // 
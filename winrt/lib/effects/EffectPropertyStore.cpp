@@ -0,0 +1,219 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    // Most effect properties are scalars or small vectors, so this is usually
+    // enough to hold all the values without ever growing the buffer.
+    static const uint32_t ExpectedBytesPerProperty = 4 * sizeof(float);
+
+
+    EffectPropertyStore::EffectPropertyStore(unsigned int propertyCount)
+        : m_slots(propertyCount, Slot{ EffectPropertyType::Unset, 0, 0, 0 })
+    {
+        m_values.reserve(propertyCount * ExpectedBytesPerProperty);
+    }
+
+
+    void EffectPropertyStore::SetValue(unsigned int index, EffectPropertyType type, void const* data, uint32_t size)
+    {
+        auto destination = AllocateValue(index, type, size);
+
+        if (size)
+            memcpy(destination, data, size);
+    }
+
+
+    BYTE* EffectPropertyStore::AllocateValue(unsigned int index, EffectPropertyType type, uint32_t size)
+    {
+        assert(index < m_slots.size());
+        assert(type != EffectPropertyType::Unset && type != EffectPropertyType::Inspectable);
+
+        auto& slot = m_slots[index];
+
+        if (slot.Type == EffectPropertyType::Inspectable)
+        {
+            m_objects[slot.Offset].Reset();
+            slot.Capacity = 0;
+        }
+
+        // Values that fit in the slot's existing storage are updated in place.
+        // Otherwise the slot moves to the end of the buffer. The space it leaves
+        // behind is reclaimed by Clear.
+        if (slot.Type == EffectPropertyType::Unset || slot.Type == EffectPropertyType::Inspectable || size > slot.Capacity)
+        {
+            slot.Offset = static_cast<uint32_t>(m_values.size());
+            slot.Capacity = size;
+
+            m_values.resize(m_values.size() + size);
+        }
+
+        slot.Type = type;
+        slot.Size = size;
+
+        return m_values.data() + slot.Offset;
+    }
+
+
+    void EffectPropertyStore::GetValue(unsigned int index, void* data, uint32_t size) const
+    {
+        assert(index < m_slots.size());
+
+        auto& slot = m_slots[index];
+
+        switch (slot.Type)
+        {
+        case EffectPropertyType::Unset:
+            ZeroMemory(data, size);
+            break;
+
+        case EffectPropertyType::Inspectable:
+            ThrowHR(E_NOTIMPL);
+
+        default:
+            if (slot.Size != size)
+                ThrowHR(E_BOUNDS);
+
+            if (size)
+                memcpy(data, m_values.data() + slot.Offset, size);
+            break;
+        }
+    }
+
+
+    BYTE const* EffectPropertyStore::GetValueData(unsigned int index) const
+    {
+        assert(index < m_slots.size());
+        assert(m_slots[index].Type != EffectPropertyType::Inspectable);
+
+        return m_values.data() + m_slots[index].Offset;
+    }
+
+
+    void EffectPropertyStore::SetInspectable(unsigned int index, IInspectable* value)
+    {
+        assert(index < m_slots.size());
+
+        auto& slot = m_slots[index];
+
+        if (slot.Type != EffectPropertyType::Inspectable)
+        {
+            slot.Type = EffectPropertyType::Inspectable;
+            slot.Offset = static_cast<uint32_t>(m_objects.size());
+            slot.Size = 0;
+            slot.Capacity = 0;
+
+            m_objects.emplace_back();
+        }
+
+        m_objects[slot.Offset] = value;
+    }
+
+
+    ComPtr<IInspectable> EffectPropertyStore::GetInspectable(unsigned int index) const
+    {
+        assert(index < m_slots.size());
+
+        auto& slot = m_slots[index];
+
+        switch (slot.Type)
+        {
+        case EffectPropertyType::Unset:
+            return nullptr;
+
+        case EffectPropertyType::Inspectable:
+            return m_objects[slot.Offset];
+
+        default:
+            ThrowHR(E_NOTIMPL);
+        }
+    }
+
+
+    void EffectPropertyStore::Clear()
+    {
+        for (auto& slot : m_slots)
+        {
+            slot = Slot{ EffectPropertyType::Unset, 0, 0, 0 };
+        }
+
+        m_values.clear();
+        m_objects.clear();
+    }
+
+
+    ComPtr<IPropertyValue> EffectPropertyStore::Box(IPropertyValueStatics* factory, unsigned int index) const
+    {
+        assert(index < m_slots.size());
+
+        auto& slot = m_slots[index];
+        auto data = m_values.data() + slot.Offset;
+
+        ComPtr<IPropertyValue> propertyValue;
+
+        switch (slot.Type)
+        {
+        case EffectPropertyType::Unset:
+            return nullptr;
+
+        case EffectPropertyType::Boolean:
+            {
+                BOOL value;
+                memcpy(&value, data, sizeof(value));
+                ThrowIfFailed(factory->CreateBoolean(static_cast<boolean>(value != FALSE), &propertyValue));
+            }
+            break;
+
+        case EffectPropertyType::Int32:
+            {
+                INT32 value;
+                memcpy(&value, data, sizeof(value));
+                ThrowIfFailed(factory->CreateInt32(value, &propertyValue));
+            }
+            break;
+
+        case EffectPropertyType::UInt32:
+            {
+                UINT32 value;
+                memcpy(&value, data, sizeof(value));
+                ThrowIfFailed(factory->CreateUInt32(value, &propertyValue));
+            }
+            break;
+
+        case EffectPropertyType::Single:
+            {
+                float value;
+                memcpy(&value, data, sizeof(value));
+                ThrowIfFailed(factory->CreateSingle(value, &propertyValue));
+            }
+            break;
+
+        case EffectPropertyType::SingleArray:
+            {
+                std::vector<float> value(slot.Size / sizeof(float));
+
+                if (!value.empty())
+                    memcpy(value.data(), data, value.size() * sizeof(float));
+
+                ThrowIfFailed(factory->CreateSingleArray(static_cast<UINT32>(value.size()), value.data(), &propertyValue));
+            }
+            break;
+
+        case EffectPropertyType::Inspectable:
+            {
+                // IPropertyValue provides CreateInspectableArray, but not CreateInspectable.
+                auto value = m_objects[slot.Offset].Get();
+                ThrowIfFailed(factory->CreateInspectableArray(1, &value, &propertyValue));
+            }
+            break;
+
+        default:
+            ThrowHR(E_NOTIMPL);
+        }
+
+        return propertyValue;
+    }
+}}}}}
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    using namespace ::Microsoft::WRL;
+    using namespace ABI::Windows::Foundation;
+
+    // How a property value is represented. This decides which PropertyType
+    // it is boxed as when read through IGraphicsEffectD2D1Interop::GetProperty.
+    enum class EffectPropertyType : uint8_t
+    {
+        Unset,
+        Boolean,        // BOOL
+        Int32,          // int32_t
+        UInt32,         // uint32_t
+        Single,         // float
+        SingleArray,    // float[]
+        Inspectable     // IInspectable*
+    };
+
+
+    //
+    // Holds the property values of an effect while it is not realized.
+    //
+    // Values are kept in their raw form, exactly as they will be passed to
+    // ID2D1Effect::SetValue, packed into a single buffer.  Each property gets
+    // its slot in the buffer the first time it is set (generated effects set
+    // every property from their constructor, so the layout follows the order
+    // of the codegen'd property table), and later sets of the same size are
+    // copied in place.  Interface values are stored separately, as they need
+    // reference counting.
+    //
+    // Properties that were never set stay Unset, and are skipped when the
+    // values are transferred to a D2D effect.
+    //
+    class EffectPropertyStore
+    {
+        struct Slot
+        {
+            EffectPropertyType Type;
+            uint32_t Offset;        // Into m_values, or m_objects for Inspectable slots.
+            uint32_t Size;
+            uint32_t Capacity;
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<BYTE> m_values;
+        std::vector<ComPtr<IInspectable>> m_objects;
+
+    public:
+        EffectPropertyStore(unsigned int propertyCount);
+
+        unsigned int GetCount() const { return static_cast<unsigned int>(m_slots.size()); }
+
+        EffectPropertyType GetType(unsigned int index) const { return m_slots[index].Type; }
+
+        // Size of the stored value in bytes (zero if unset).
+        uint32_t GetValueSize(unsigned int index) const { return m_slots[index].Size; }
+
+        void SetValue(unsigned int index, EffectPropertyType type, void const* data, uint32_t size);
+
+        // Returns storage for a value of the given size, for the caller to fill in.
+        // The pointer is only valid until the store is next modified.
+        BYTE* AllocateValue(unsigned int index, EffectPropertyType type, uint32_t size);
+
+        // Unset values read back as zero.
+        void GetValue(unsigned int index, void* data, uint32_t size) const;
+
+        BYTE const* GetValueData(unsigned int index) const;
+
+        void SetInspectable(unsigned int index, IInspectable* value);
+        ComPtr<IInspectable> GetInspectable(unsigned int index) const;
+
+        // Resets every property to Unset, keeping the allocated storage.
+        void Clear();
+
+        // Returns null for unset properties.
+        ComPtr<IPropertyValue> Box(IPropertyValueStatics* factory, unsigned int index) const;
+    };
+
+
+    //
+    // Describes how values of each TBoxed type used by CanvasEffect properties are stored.
+    // Specialized for each supported type; anything else is a compile error.
+    //
+
+    template<typename T, typename Enable = void>
+    struct RawPropertyTraits;
+
+    template<>
+    struct RawPropertyTraits<float>
+    {
+        typedef float RawType;
+        static const EffectPropertyType Type = EffectPropertyType::Single;
+
+        static RawType ToRaw(float value)                   { return value; }
+        static void FromRaw(RawType raw, float* result)     { *result = raw; }
+    };
+
+    template<>
+    struct RawPropertyTraits<int32_t>
+    {
+        typedef int32_t RawType;
+        static const EffectPropertyType Type = EffectPropertyType::Int32;
+
+        static RawType ToRaw(int32_t value)                 { return value; }
+        static void FromRaw(RawType raw, int32_t* result)   { *result = raw; }
+    };
+
+    template<>
+    struct RawPropertyTraits<uint32_t>
+    {
+        typedef uint32_t RawType;
+        static const EffectPropertyType Type = EffectPropertyType::UInt32;
+
+        static RawType ToRaw(uint32_t value)                { return value; }
+        static void FromRaw(RawType raw, uint32_t* result)  { *result = raw; }
+    };
+
+    // D2D stores booleans as 32 bit BOOL.
+    template<>
+    struct RawPropertyTraits<boolean>
+    {
+        typedef BOOL RawType;
+        static const EffectPropertyType Type = EffectPropertyType::Boolean;
+
+        static RawType ToRaw(boolean value)                 { return static_cast<BOOL>(value); }
+        static void FromRaw(RawType raw, boolean* result)   { *result = static_cast<boolean>(raw != FALSE); }
+    };
+
+    // Interface types hold a reference to the Win2D object, which is only
+    // converted to its D2D resource when the effect is realized.
+    template<typename T>
+    struct RawPropertyTraits<T*, typename std::enable_if<std::is_base_of<IInspectable, T>::value>::type>
+    {
+        typedef ComPtr<IInspectable> RawType;
+        static const EffectPropertyType Type = EffectPropertyType::Inspectable;
+
+        static RawType ToRaw(T* value)
+        {
+            return value;
+        }
+
+        static void FromRaw(RawType const& raw, T** result)
+        {
+            if (raw)
+                ThrowIfFailed(raw.CopyTo(result));
+            else
+                *result = nullptr;
+        }
+    };
+}}}}}
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "InternedShaderTable.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    size_t InternedShaderTable::GetShaderCount()
+    {
+        Lock lock(m_mutex);
+
+        RemoveExpired();
+
+        return m_shaders.size();
+    }
+
+
+    uint64_t InternedShaderTable::GetCodeHash(BYTE const* code, size_t codeSize)
+    {
+        // 64 bit FNV-1a.  This only has to pick out the candidates to compare,
+        // so it doesn't need to be as strong as the SHA-1 used for the
+        // shader's own hash.
+        const uint64_t offsetBasis = 14695981039346656037ull;
+        const uint64_t prime = 1099511628211ull;
+
+        uint64_t hash = offsetBasis;
+
+        for (size_t i = 0; i < codeSize; ++i)
+        {
+            hash ^= code[i];
+            hash *= prime;
+        }
+
+        return hash;
+    }
+
+
+    std::shared_ptr<ReflectedShader const> InternedShaderTable::TryGet(uint64_t codeHash, BYTE const* code, size_t codeSize)
+    {
+        Lock lock(m_mutex);
+
+        return Find(codeHash, code, codeSize);
+    }
+
+
+    std::shared_ptr<ReflectedShader const> InternedShaderTable::Add(uint64_t codeHash, std::shared_ptr<ReflectedShader>&& shader)
+    {
+        Lock lock(m_mutex);
+
+        // Another thread may have added the same shader in the meantime.
+        auto& code = shader->Shader.Code;
+
+        if (auto existing = Find(codeHash, code.data(), code.size()))
+            return existing;
+
+        RemoveExpired();
+
+        shader->Table = shared_from_this();
+
+        m_shaders.emplace(codeHash, shader);
+
+        return std::move(shader);
+    }
+
+
+    std::shared_ptr<ReflectedShader const> InternedShaderTable::Find(uint64_t codeHash, BYTE const* code, size_t codeSize)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_shaders.equal_range(codeHash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            auto shader = it->second.lock();
+
+            if (!shader)
+                continue;
+
+            auto& candidateCode = shader->Shader.Code;
+
+            if (candidateCode.size() == codeSize &&
+                memcmp(candidateCode.data(), code, codeSize) == 0)
+            {
+                return shader;
+            }
+        }
+
+        return nullptr;
+    }
+
+
+    void InternedShaderTable::RemoveExpired()
+    {
+        // Caller must hold m_mutex.
+
+        for (auto it = m_shaders.begin(); it != m_shaders.end(); )
+        {
+            if (it->second.expired())
+                it = m_shaders.erase(it);
+            else
+                ++it;
+        }
+    }
+
+}}}}}
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "SharedShaderState.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
+{
+    class InternedShaderTable;
+
+
+    // Everything learned by hashing and reflecting over a shader.  Never
+    // modified once it is in the table.
+    struct ReflectedShader
+    {
+        ShaderDescription Shader;
+
+        // Initial state for each new SharedShaderState using this shader.
+        std::vector<BYTE> DefaultConstants;
+        CoordinateMappingState DefaultCoordinateMapping;
+
+        // Keeps the table alive for as long as any of its shaders are in use.
+        std::shared_ptr<InternedShaderTable> Table;
+    };
+
+
+    //
+    // Process-wide table of the shaders that PixelShaderEffects are using.
+    //
+    // Apps commonly create many effects from the same few shaders.  The table
+    // makes sure that each distinct shader is only hashed and reflected once,
+    // with the effects sharing the results.
+    //
+    // The table only holds weak references, so a shader is dropped once the
+    // last effect using it goes away.
+    //
+    class InternedShaderTable : public Singleton<InternedShaderTable>
+                              , public std::enable_shared_from_this<InternedShaderTable>
+    {
+        std::mutex m_mutex;
+
+        // Indexed by GetCodeHash.  Different shaders may have the same code
+        // hash, so lookups compare the code of each candidate in full.
+        std::unordered_multimap<uint64_t, std::weak_ptr<ReflectedShader const>> m_shaders;
+
+    public:
+        //
+        // Returns the shader matching the code, or calls reflectFn to make a
+        // new std::shared_ptr<ReflectedShader> and adds that to the table.
+        //
+        template<typename FN>
+        std::shared_ptr<ReflectedShader const> GetOrCreate(BYTE const* code, size_t codeSize, FN&& reflectFn)
+        {
+            auto codeHash = GetCodeHash(code, codeSize);
+
+            if (auto shader = TryGet(codeHash, code, codeSize))
+                return shader;
+
+            // Reflection is done without holding the lock.
+            std::shared_ptr<ReflectedShader> shader = reflectFn();
+
+            return Add(codeHash, std::move(shader));
+        }
+
+        // Number of shaders that are still in use.
+        size_t GetShaderCount();
+
+        static uint64_t GetCodeHash(BYTE const* code, size_t codeSize);
+
+    private:
+        std::shared_ptr<ReflectedShader const> TryGet(uint64_t codeHash, BYTE const* code, size_t codeSize);
+        std::shared_ptr<ReflectedShader const> Add(uint64_t codeHash, std::shared_ptr<ReflectedShader>&& shader);
+
+        std::shared_ptr<ReflectedShader const> Find(uint64_t codeHash, BYTE const* code, size_t codeSize);
+        void RemoveExpired();
+    };
+
+}}}}}
@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include "SharedShaderState.h"
+#include "InternedShaderTable.h"
 #include "utils/HashUtilities.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Effects
@@ -29,6 +30,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
 
     SharedShaderState::SharedShaderState(ShaderDescription const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation)
+        : SharedShaderState(std::make_shared<ShaderDescription>(shader), constants, coordinateMapping, sourceInterpolation)
+    { }
+
+
+    SharedShaderState::SharedShaderState(std::shared_ptr<ShaderDescription const> const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation)
         : m_shader(shader)
         , m_constants(constants)
         , m_coordinateMapping(coordinateMapping)
@@ -36,39 +42,93 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     { }
 
 
+    // Shader reflection (done the first time each shader is used).
+    static void ReflectOverShader(ReflectedShader& reflected);
+
+
     SharedShaderState::SharedShaderState(BYTE* shaderCode, uint32_t shaderCodeSize)
     {
-        // Store the shader program code.
-        m_shader.Code.assign(shaderCode, shaderCode + shaderCodeSize);
+        // Apps often create many effects from the same shader, so the slow
+        // work of hashing and reflecting is only done once per shader.
+        auto reflected = InternedShaderTable::GetInstance()->GetOrCreate(shaderCode, shaderCodeSize,
+            [&]
+            {
+                auto newShader = std::make_shared<ReflectedShader>();
+
+                // Store the shader program code.
+                newShader->Shader.Code.assign(shaderCode, shaderCode + shaderCodeSize);
+
+                // Hash it to generate a unique ID.
+                static const IID salt{ 0x489257f6, 0x6544, 0x4277, 0x89, 0x82, 0xea, 0xd1, 0x69, 0x39, 0x1f, 0x3d };
+
+                newShader->Shader.Hash = GetVersion5Uuid(salt, shaderCode, shaderCodeSize);
+
+                // Look up shader metadata.
+                ReflectOverShader(*newShader);
+
+                return newShader;
+            });
+
+        m_shader = std::shared_ptr<ShaderDescription const>(reflected, &reflected->Shader);
+        m_constants = reflected->DefaultConstants;
+        m_coordinateMapping = reflected->DefaultCoordinateMapping;
+    }
+
+
+    static std::atomic<uint64_t> g_cloneCount;
+    static std::atomic<uint64_t> g_cloneSharedBytes;
+    static std::atomic<uint64_t> g_cloneDuplicatedBytes;
+
+
+    static uint64_t GetSizeInBytes(ShaderDescription const& shader)
+    {
+        uint64_t size = sizeof(ShaderDescription) + shader.Code.size();
 
-        // Hash it to generate a unique ID.
-        static const IID salt{ 0x489257f6, 0x6544, 0x4277, 0x89, 0x82, 0xea, 0xd1, 0x69, 0x39, 0x1f, 0x3d };
+        for (auto& variable : shader.Variables)
+        {
+            UINT32 nameLength;
+            WindowsGetStringRawBuffer(variable.Name, &nameLength);
 
-        m_shader.Hash = GetVersion5Uuid(salt, shaderCode, shaderCodeSize);
+            size += sizeof(ShaderVariable) + nameLength * sizeof(wchar_t);
+        }
 
-        // Look up shader metadata.
-        ReflectOverShader();
+        return size;
     }
 
 
     ComPtr<ISharedShaderState> SharedShaderState::Clone()
     {
+        // Only the mutable state is copied.
         auto clone = Make<SharedShaderState>(m_shader, m_constants, m_coordinateMapping, m_sourceInterpolation);
         CheckMakeResult(clone);
 
+        ++g_cloneCount;
+        g_cloneSharedBytes += GetSizeInBytes(*m_shader);
+        g_cloneDuplicatedBytes += sizeof(SharedShaderState) + m_constants.size();
+
         return clone;
     }
 
 
+    ShaderStateCloneStatistics SharedShaderState::GetCloneStatistics()
+    {
+        ShaderStateCloneStatistics statistics{};
+        statistics.CloneCount = g_cloneCount;
+        statistics.SharedBytes = g_cloneSharedBytes;
+        statistics.DuplicatedBytes = g_cloneDuplicatedBytes;
+        return statistics;
+    }
+
+
     unsigned SharedShaderState::GetPropertyCount()
     {
-        return static_cast<unsigned>(m_shader.Variables.size());
+        return static_cast<unsigned>(m_shader->Variables.size());
     }
 
 
     bool SharedShaderState::HasProperty(HSTRING name)
     {
-        return std::binary_search(m_shader.Variables.begin(), m_shader.Variables.end(), name, VariableNameComparison());
+        return std::binary_search(m_shader->Variables.begin(), m_shader->Variables.end(), name, VariableNameComparison());
     }
 
 
@@ -210,9 +270,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         std::vector<StringObjectPair> properties;
 
-        properties.reserve(m_shader.Variables.size());
+        properties.reserve(m_shader->Variables.size());
 
-        for (auto& variable : m_shader.Variables)
+        for (auto& variable : m_shader->Variables)
         {
             properties.emplace_back(variable.Name, GetProperty(variable));
         }
@@ -225,9 +285,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         VariableNameComparison comparison;
 
-        auto it = std::lower_bound(m_shader.Variables.begin(), m_shader.Variables.end(), name, comparison);
+        auto it = std::lower_bound(m_shader->Variables.begin(), m_shader->Variables.end(), name, comparison);
 
-        if (it == m_shader.Variables.end() || comparison(name, *it))
+        if (it == m_shader->Variables.end() || comparison(name, *it))
         {
             WinStringBuilder message;
             message.Format(Strings::CustomEffectUnknownProperty, WindowsGetStringRawBuffer(name, nullptr));
@@ -460,49 +520,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void SharedShaderState::ReflectOverShader()
-    {
-        // Create the shader reflection interface.
-        ComPtr<ID3D11ShaderReflection> reflector;
-
-        HRESULT hr = D3DReflect(m_shader.Code.data(), m_shader.Code.size(), IID_PPV_ARGS(&reflector));
-
-        if (FAILED(hr))
-            ThrowHR(E_INVALIDARG, Strings::CustomEffectBadShader);
-
-        D3D11_SHADER_DESC desc;
-        ThrowIfFailed(reflector->GetDesc(&desc));
-
-        // Make sure this is a pixel shader.
-        auto shaderType = D3D11_SHVER_GET_TYPE(desc.Version);
-        auto shaderModel = D3D11_SHVER_GET_MAJOR(desc.Version);
-
-        if (shaderType != D3D11_SHVER_PIXEL_SHADER || 
-            shaderModel != 4)
-        {
-            ThrowHR(E_INVALIDARG, Strings::CustomEffectBadShader);
-        }
-
-        // Examine the input bindings.
-        ReflectOverBindings(reflector.Get(), desc);
-
-        // Store the mapping from named constants to buffer locations.
-        if (desc.ConstantBuffers)
-        {
-            ReflectOverConstantBuffer(reflector->GetConstantBufferByIndex(0));
-        }
-
-        // Grab some other metadata.
-        m_shader.InstructionCount = desc.InstructionCount;
-
-        ThrowIfFailed(reflector->GetMinFeatureLevel(&m_shader.MinFeatureLevel));
-
-        // If this shader was compiled to support shader linking, we can also determine which inputs are simple vs. complex.
-        ReflectOverShaderLinkingFunction();
-    }
-
-
-    void SharedShaderState::ReflectOverBindings(ID3D11ShaderReflection* reflector, D3D11_SHADER_DESC const& desc)
+    static void ReflectOverBindings(ReflectedShader& reflected, ID3D11ShaderReflection* reflector, D3D11_SHADER_DESC const& desc)
     {
         for (unsigned i = 0; i < desc.BoundResources; i++)
         {
@@ -516,7 +534,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                     ThrowHR(E_INVALIDARG, Strings::CustomEffectTooManyTextures);
 
                 // Record how many input textures this shader uses.
-                m_shader.InputCount = std::max(m_shader.InputCount, inputDesc.BindPoint + 1);
+                reflected.Shader.InputCount = std::max(reflected.Shader.InputCount, inputDesc.BindPoint + 1);
                 break;
 
             case D3D_SIT_CBUFFER:
@@ -529,24 +547,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void SharedShaderState::ReflectOverConstantBuffer(ID3D11ShaderReflectionConstantBuffer* constantBuffer)
+    static void ReflectOverConstantBuffer(ReflectedShader& reflected, ID3D11ShaderReflectionConstantBuffer* constantBuffer)
     {
         D3D11_SHADER_BUFFER_DESC desc;
         ThrowIfFailed(constantBuffer->GetDesc(&desc));
 
         // Resize our constant buffer to match the shader.
-        m_constants.resize(desc.Size);
+        reflected.DefaultConstants.resize(desc.Size);
 
         // Look up variable metadata.
-        m_shader.Variables.reserve(desc.Variables);
+        reflected.Shader.Variables.reserve(desc.Variables);
 
         for (unsigned i = 0; i < desc.Variables; i++)
         {
-            ReflectOverVariable(constantBuffer->GetVariableByIndex(i));
+            ReflectOverVariable(reflected, constantBuffer->GetVariableByIndex(i));
         }
 
         // Sort the variables by name.
-        std::sort(m_shader.Variables.begin(), m_shader.Variables.end(), VariableNameComparison());
+        std::sort(reflected.Shader.Variables.begin(), reflected.Shader.Variables.end(), VariableNameComparison());
     }
 
 
@@ -629,7 +647,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     }
 
 
-    void SharedShaderState::ReflectOverVariable(ID3D11ShaderReflectionVariable* variable)
+    static void ReflectOverVariable(ReflectedShader& reflected, ID3D11ShaderReflectionVariable* variable)
     {
         D3D11_SHADER_VARIABLE_DESC desc;
         ThrowIfFailed(variable->GetDesc(&desc));
@@ -652,7 +670,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // This can only fail if the shader blob is corrupted.
         auto endOffset = desc.StartOffset + desc.Size;
 
-        if (endOffset > m_constants.size() || endOffset < desc.StartOffset)
+        if (endOffset > reflected.DefaultConstants.size() || endOffset < desc.StartOffset)
         {
             ThrowHR(E_UNEXPECTED);
         }
@@ -660,15 +678,15 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // Initialize our constant buffer with the default value of the variable.
         if (desc.DefaultValue)
         {
-            CopyDefaultValue(m_constants.data() + desc.StartOffset, desc, type);
+            CopyDefaultValue(reflected.DefaultConstants.data() + desc.StartOffset, desc, type);
         }
 
         // Store metadata about this variable.
-        m_shader.Variables.emplace_back(desc, type);
+        reflected.Shader.Variables.emplace_back(desc, type);
     }
 
 
-    void SharedShaderState::ReflectOverShaderLinkingFunction()
+    static void ReflectOverShaderLinkingFunction(ReflectedShader& reflected)
     {
         // If this shader was compiled to support shader linking, we can get extra information
         // (telling us which inputs are simple vs. complex) from the shader linking function.
@@ -676,7 +694,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         // It's valid to use shaders that don't support linking, so we return on failure rather than throwing.
         ComPtr<ID3DBlob> privateData;
 
-        if (FAILED(D3DGetBlobPart(m_shader.Code.data(), m_shader.Code.size(), D3D_BLOB_PRIVATE_DATA, 0, &privateData)))
+        if (FAILED(D3DGetBlobPart(reflected.Shader.Code.data(), reflected.Shader.Code.size(), D3D_BLOB_PRIVATE_DATA, 0, &privateData)))
             return;
 
         ComPtr<ID3D11LibraryReflection> reflector;
@@ -711,9 +729,51 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             else if (strstr(parameterDesc.SemanticName, "INPUT"))
             {
                 // INPUT semantic means a simple input, so select passthrough coordinate mapping mode.
-                m_coordinateMapping.Mapping[inputCount++] = SamplerCoordinateMapping::OneToOne;
+                reflected.DefaultCoordinateMapping.Mapping[inputCount++] = SamplerCoordinateMapping::OneToOne;
             }
         }
     }
 
+
+    static void ReflectOverShader(ReflectedShader& reflected)
+    {
+        // Create the shader reflection interface.
+        ComPtr<ID3D11ShaderReflection> reflector;
+
+        HRESULT hr = D3DReflect(reflected.Shader.Code.data(), reflected.Shader.Code.size(), IID_PPV_ARGS(&reflector));
+
+        if (FAILED(hr))
+            ThrowHR(E_INVALIDARG, Strings::CustomEffectBadShader);
+
+        D3D11_SHADER_DESC desc;
+        ThrowIfFailed(reflector->GetDesc(&desc));
+
+        // Make sure this is a pixel shader.
+        auto shaderType = D3D11_SHVER_GET_TYPE(desc.Version);
+        auto shaderModel = D3D11_SHVER_GET_MAJOR(desc.Version);
+
+        if (shaderType != D3D11_SHVER_PIXEL_SHADER || 
+            shaderModel != 4)
+        {
+            ThrowHR(E_INVALIDARG, Strings::CustomEffectBadShader);
+        }
+
+        // Examine the input bindings.
+        ReflectOverBindings(reflected, reflector.Get(), desc);
+
+        // Store the mapping from named constants to buffer locations.
+        if (desc.ConstantBuffers)
+        {
+            ReflectOverConstantBuffer(reflected, reflector->GetConstantBufferByIndex(0));
+        }
+
+        // Grab some other metadata.
+        reflected.Shader.InstructionCount = desc.InstructionCount;
+
+        ThrowIfFailed(reflector->GetMinFeatureLevel(&reflected.Shader.MinFeatureLevel));
+
+        // If this shader was compiled to support shader linking, we can also determine which inputs are simple vs. complex.
+        ReflectOverShaderLinkingFunction(reflected);
+    }
+
 }}}}}
@@ -35,6 +35,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     };
 
 
+    // Running totals of the memory involved in SharedShaderState::Clone.
+    struct ShaderStateCloneStatistics
+    {
+        uint64_t CloneCount;
+
+        // Shader code and metadata that clones referenced rather than copied.
+        uint64_t SharedBytes;
+
+        // Constant buffers and other per-instance state that clones copied.
+        uint64_t DuplicatedBytes;
+    };
+
+
     // Implementation state shared between PixelShaderEffect and PixelShaderEffectImpl.
     // This stores the compiled shader code, metadata obtained via shader reflection,
     // and app-specified state such as the current constant buffer.
@@ -68,18 +81,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     class SharedShaderState : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ISharedShaderState>
                             , private LifespanTracker<SharedShaderState>
     {
-        ShaderDescription m_shader;
+        // Immutable, so clones share it rather than copying the shader code.
+        std::shared_ptr<ShaderDescription const> m_shader;
+
         std::vector<BYTE> m_constants;
         CoordinateMappingState m_coordinateMapping;
         SourceInterpolationState m_sourceInterpolation;
 
     public:
         SharedShaderState(ShaderDescription const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation);
+        SharedShaderState(std::shared_ptr<ShaderDescription const> const& shader, std::vector<BYTE> const& constants, CoordinateMappingState const& coordinateMapping, SourceInterpolationState const& sourceInterpolation);
         SharedShaderState(BYTE* shaderCode, uint32_t shaderCodeSize);
 
         virtual ComPtr<ISharedShaderState> Clone() override;
 
-        virtual ShaderDescription const& Shader() override { return m_shader; }
+        virtual ShaderDescription const& Shader() override { return *m_shader; }
         virtual std::vector<BYTE> const& Constants() override { return m_constants; }
         virtual CoordinateMappingState& CoordinateMapping() override { return m_coordinateMapping; }
         virtual SourceInterpolationState& SourceInterpolation() { return m_sourceInterpolation; }
@@ -91,6 +107,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual void SetProperty(HSTRING name, IInspectable* boxedValue) override;
         virtual std::vector<StringObjectPair> EnumerateProperties() override;
 
+        static ShaderStateCloneStatistics GetCloneStatistics();
+
     private:
         ComPtr<IInspectable> GetProperty(ShaderVariable const& variable);
         ShaderVariable const& FindVariable(HSTRING name);
@@ -105,14 +123,6 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         template<CopyDirection Direction, typename TComponent>
         void CopyConstantData(ShaderVariable const& variable, TComponent* values);
-
-
-        // Shader reflection (done at init time).
-        void ReflectOverShader();
-        void ReflectOverBindings(ID3D11ShaderReflection* reflector, D3D11_SHADER_DESC const& desc);
-        void ReflectOverConstantBuffer(ID3D11ShaderReflectionConstantBuffer* constantBuffer);
-        void ReflectOverVariable(ID3D11ShaderReflectionVariable* variable);
-        void ReflectOverShaderLinkingFunction();
     };
 
 }}}}}
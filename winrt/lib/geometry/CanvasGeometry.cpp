@@ -408,32 +408,6 @@ IFACEMETHODIMP CanvasGeometryFactory::ComputeFlatteningTolerance(
     return ComputeFlatteningToleranceWithTransform(dpi, maximumZoomFactor, Identity3x2(), flatteningTolerance);
 }
 
-// Ideally we would just call D2D1::ComputeFlatteningTolerance here, which internally uses
-// D2D1ComputeMaximumScaleFactor, but unfortunately that DLL entrypoint is not marked as
-// valid for Windows Phone 8.1 apps (an oversight). Using it would make Win2D Phone apps
-// fail certification, so instead we must do the calculation directly here ourselves.
-static float ComputeMaximumScaleFactor(D2D1_MATRIX_3X2_F const& m)
-{
-    if (m._12 == 0.0f && m._21 == 0.0f)
-    {
-        // Simple scale matrix.
-        return std::max(fabs(m._11), fabs(m._22));
-    }
-    else
-    {
-        // Solve a quadratic.
-        float a = m._11 * m._11 + m._12 * m._12;
-        float b = m._11 * m._21 + m._12 * m._22;
-        float c = m._21 * m._21 + m._22 * m._22;
-
-        float d = a - c;
-
-        float r = sqrtf(d * d + b * b * 4);
-
-        return sqrtf((a + c + r) * 0.5f);
-    }
-}
-
 IFACEMETHODIMP CanvasGeometryFactory::ComputeFlatteningToleranceWithTransform(
     float dpi,
     float maximumZoomFactor,
@@ -1101,21 +1075,136 @@ IFACEMETHODIMP CanvasGeometry::TessellateWithTransformAndFlatteningTolerance(
         CheckInPointer(trianglesCount);
         CheckAndClearOutPointer(triangles);
 
-        auto& resource = GetResource();
-
         auto tessellationSink = Make<TessellationSink>();
         CheckMakeResult(tessellationSink);
 
-        ThrowIfFailed(resource->Tessellate(
-            ReinterpretAs<D2D1_MATRIX_3X2_F*>(&transform),
-            flatteningTolerance,
-            tessellationSink.Get()));
+        TessellateImpl(transform, flatteningTolerance, tessellationSink.Get());
 
         auto outputArray = tessellationSink->GetTriangles();
         outputArray.Detach(trianglesCount, triangles);
     });
 }
 
+IFACEMETHODIMP CanvasGeometry::ComputeTessellationTriangleCount(
+    UINT64* trianglesCount)
+{
+    return ComputeTessellationTriangleCountWithTransformAndFlatteningTolerance(
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        trianglesCount);
+}
+
+IFACEMETHODIMP CanvasGeometry::ComputeTessellationTriangleCountWithTransformAndFlatteningTolerance(
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    UINT64* trianglesCount)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(trianglesCount);
+
+        auto countingSink = Make<CountingTessellationSink>();
+        CheckMakeResult(countingSink);
+
+        TessellateImpl(transform, flatteningTolerance, countingSink.Get());
+
+        *trianglesCount = countingSink->GetTriangleCount();
+    });
+}
+
+IFACEMETHODIMP CanvasGeometry::TessellateToBuffer(
+    IBuffer* buffer,
+    UINT32* trianglesCount)
+{
+    return TessellateToBufferWithTransformAndFlatteningTolerance(
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        buffer,
+        trianglesCount);
+}
+
+IFACEMETHODIMP CanvasGeometry::TessellateToBufferWithTransformAndFlatteningTolerance(
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    IBuffer* buffer,
+    UINT32* trianglesCount)
+{
+    using ::Windows::Storage::Streams::IBufferByteAccess;
+
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(buffer);
+        CheckInPointer(trianglesCount);
+
+        auto byteAccess = As<IBufferByteAccess>(buffer);
+
+        uint32_t capacity;
+        ThrowIfFailed(buffer->get_Capacity(&capacity));
+
+        uint8_t* destination;
+        ThrowIfFailed(byteAccess->Buffer(&destination));
+
+        auto bufferSink = Make<BufferTessellationSink>(destination, capacity / sizeof(CanvasTriangleVertices));
+        CheckMakeResult(bufferSink);
+
+        TessellateImpl(transform, flatteningTolerance, bufferSink.Get());
+
+        auto requiredBytes = bufferSink->GetTriangleCount() * sizeof(CanvasTriangleVertices);
+
+        if (bufferSink->Overflowed())
+        {
+            WinStringBuilder message;
+            message.Format(Strings::TessellationBufferTooSmall, static_cast<unsigned long long>(requiredBytes), capacity);
+            ThrowHR(E_INVALIDARG, message.Get());
+        }
+
+        ThrowIfFailed(buffer->put_Length(static_cast<uint32_t>(requiredBytes)));
+
+        *trianglesCount = static_cast<uint32_t>(bufferSink->GetTriangleCount());
+    });
+}
+
+IFACEMETHODIMP CanvasGeometry::SendTrianglesTo(
+    ICanvasTessellationReceiver* receiver)
+{
+    return SendTrianglesToWithTransformAndFlatteningTolerance(
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        receiver);
+}
+
+IFACEMETHODIMP CanvasGeometry::SendTrianglesToWithTransformAndFlatteningTolerance(
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    ICanvasTessellationReceiver* receiver)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(receiver);
+
+        auto streamingSink = Make<StreamingTessellationSink>(receiver);
+        CheckMakeResult(streamingSink);
+
+        TessellateImpl(transform, flatteningTolerance, streamingSink.Get());
+    });
+}
+
+template<typename SINK>
+void CanvasGeometry::TessellateImpl(
+    Matrix3x2 const& transform,
+    float flatteningTolerance,
+    SINK* sink)
+{
+    auto& resource = GetResource();
+
+    ThrowIfFailed(resource->Tessellate(
+        ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform),
+        flatteningTolerance,
+        sink));
+
+    sink->Finish();
+}
+
 IFACEMETHODIMP CanvasGeometry::SendPathTo(
     ICanvasPathReceiver* streamReader)
 {
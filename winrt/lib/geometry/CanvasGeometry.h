@@ -10,6 +10,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 {
     using namespace ::Microsoft::WRL;
     using namespace Numerics;
+    using ABI::Windows::Storage::Streams::IBuffer;
 
     class GeometryAdapter;
     class DefaultGeometryAdapter;
@@ -304,6 +305,32 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             UINT32* trianglesCount,
             CanvasTriangleVertices** triangles) override;
 
+        IFACEMETHOD(ComputeTessellationTriangleCount)(
+            UINT64* trianglesCount) override;
+
+        IFACEMETHOD(ComputeTessellationTriangleCountWithTransformAndFlatteningTolerance)(
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            UINT64* trianglesCount) override;
+
+        IFACEMETHOD(TessellateToBuffer)(
+            IBuffer* buffer,
+            UINT32* trianglesCount) override;
+
+        IFACEMETHOD(TessellateToBufferWithTransformAndFlatteningTolerance)(
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            IBuffer* buffer,
+            UINT32* trianglesCount) override;
+
+        IFACEMETHOD(SendTrianglesTo)(
+            ICanvasTessellationReceiver* receiver) override;
+
+        IFACEMETHOD(SendTrianglesToWithTransformAndFlatteningTolerance)(
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            ICanvasTessellationReceiver* receiver) override;
+
         IFACEMETHOD(SendPathTo)(
             ICanvasPathReceiver* streamReader) override;
 
@@ -351,6 +378,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float flatteningTolerance,
             Vector2* tangent,
             Vector2* point);
+
+        template<typename SINK>
+        void TessellateImpl(
+            Matrix3x2 const& transform,
+            float flatteningTolerance,
+            SINK* sink);
     };
 
 
@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "CanvasGeometryIndex.h"
+#include "GeometrySink.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+IFACEMETHODIMP CanvasGeometryIndexFactory::Create(
+    uint32_t geometryCount,
+    ICanvasGeometry** geometries,
+    ICanvasGeometryIndex** geometryIndex)
+{
+    return CreateWithTransformAndFlatteningTolerance(
+        geometryCount,
+        geometries,
+        Identity3x2(),
+        D2D1_DEFAULT_FLATTENING_TOLERANCE,
+        geometryIndex);
+}
+
+IFACEMETHODIMP CanvasGeometryIndexFactory::CreateWithTransformAndFlatteningTolerance(
+    uint32_t geometryCount,
+    ICanvasGeometry** geometries,
+    Matrix3x2 transform,
+    float flatteningTolerance,
+    ICanvasGeometryIndex** geometryIndex)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (geometryCount > 0)
+                CheckInPointer(geometries);
+
+            CheckAndClearOutPointer(geometryIndex);
+
+            if (!(flatteningTolerance > 0))
+                ThrowHR(E_INVALIDARG);
+
+            auto newCanvasGeometryIndex = CanvasGeometryIndex::CreateNew(geometryCount, geometries, transform, flatteningTolerance);
+
+            ThrowIfFailed(newCanvasGeometryIndex.CopyTo(geometryIndex));
+        });
+}
+
+
+ComPtr<CanvasGeometryIndex> CanvasGeometryIndex::CreateNew(
+    uint32_t geometryCount,
+    ICanvasGeometry** geometries,
+    Matrix3x2 const& transform,
+    float flatteningTolerance)
+{
+    auto index = std::make_unique<GeometryIndex>(flatteningTolerance);
+
+    auto receiver = index->CreatePathReceiver();
+
+    //
+    // Each geometry is flattened once, here, with the transform applied.
+    // Simplify streams the resulting lines through a GeometrySink into the
+    // index, which adds them to the feature for this geometry.
+    //
+    for (uint32_t i = 0; i < geometryCount; ++i)
+    {
+        CheckInPointer(geometries[i]);
+
+        auto d2dGeometry = GetWrappedResource<ID2D1Geometry>(geometries[i]);
+
+        auto geometrySink = Make<GeometrySink>(receiver);
+        CheckMakeResult(geometrySink);
+
+        index->BeginFeature();
+
+        ThrowIfFailed(d2dGeometry->Simplify(
+            D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES,
+            ReinterpretAs<D2D1_MATRIX_3X2_F const*>(&transform),
+            flatteningTolerance,
+            geometrySink.Get()));
+
+        ThrowIfFailed(geometrySink->Close());
+
+        index->EndFeature();
+    }
+
+    index->Build();
+
+    auto canvasGeometryIndex = Make<CanvasGeometryIndex>(std::move(index));
+    CheckMakeResult(canvasGeometryIndex);
+
+    return canvasGeometryIndex;
+}
+
+
+CanvasGeometryIndex::CanvasGeometryIndex(std::unique_ptr<GeometryIndex>&& index)
+    : m_index(std::move(index))
+{
+}
+
+
+IFACEMETHODIMP CanvasGeometryIndex::get_GeometryCount(int32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = static_cast<int32_t>(m_index->GetFeatureCount());
+        });
+}
+
+
+IFACEMETHODIMP CanvasGeometryIndex::FillContainsPoints(
+    uint32_t pointsCount,
+    Vector2* points,
+    uint32_t* geometryIndicesCount,
+    int32_t** geometryIndices)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (pointsCount > 0)
+                CheckInPointer(points);
+
+            CheckInPointer(geometryIndicesCount);
+            CheckAndClearOutPointer(geometryIndices);
+
+            ComArray<int32_t> array(pointsCount);
+
+            for (uint32_t i = 0; i < pointsCount; ++i)
+            {
+                array[i] = m_index->FillContainsPoint(ToD2DPoint(points[i]));
+            }
+
+            array.Detach(geometryIndicesCount, geometryIndices);
+        });
+}
+
+
+IFACEMETHODIMP CanvasGeometryIndex::StrokeContainsPoints(
+    uint32_t pointsCount,
+    Vector2* points,
+    float strokeWidth,
+    uint32_t* geometryIndicesCount,
+    int32_t** geometryIndices)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (pointsCount > 0)
+                CheckInPointer(points);
+
+            CheckInPointer(geometryIndicesCount);
+            CheckAndClearOutPointer(geometryIndices);
+
+            ComArray<int32_t> array(pointsCount);
+
+            for (uint32_t i = 0; i < pointsCount; ++i)
+            {
+                array[i] = m_index->StrokeContainsPoint(ToD2DPoint(points[i]), strokeWidth);
+            }
+
+            array.Detach(geometryIndicesCount, geometryIndices);
+        });
+}
+
+
+IFACEMETHODIMP CanvasGeometryIndex::GetGeometriesIntersectingRectangle(
+    Rect rectangle,
+    uint32_t* geometryIndicesCount,
+    int32_t** geometryIndices)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(geometryIndicesCount);
+            CheckAndClearOutPointer(geometryIndices);
+
+            auto indices = m_index->GetFeaturesIntersectingRectangle(ToD2DRect(rectangle));
+
+            ComArray<int32_t> array(indices.begin(), indices.end());
+            array.Detach(geometryIndicesCount, geometryIndices);
+        });
+}
+
+
+ActivatableClassWithFactory(CanvasGeometryIndex, CanvasGeometryIndexFactory);
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "GeometryIndex.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    class CanvasGeometryIndex
+        : public RuntimeClass<ICanvasGeometryIndex>
+        , private LifespanTracker<CanvasGeometryIndex>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasGeometryIndex, BaseTrust);
+
+        // The index is never modified after it is built, so queries don't
+        // need to be synchronized.
+        std::unique_ptr<GeometryIndex> m_index;
+
+    public:
+        static ComPtr<CanvasGeometryIndex> CreateNew(
+            uint32_t geometryCount,
+            ICanvasGeometry** geometries,
+            Matrix3x2 const& transform,
+            float flatteningTolerance);
+
+        CanvasGeometryIndex(std::unique_ptr<GeometryIndex>&& index);
+
+        IFACEMETHOD(get_GeometryCount)(int32_t* value) override;
+
+        IFACEMETHOD(FillContainsPoints)(
+            uint32_t pointsCount,
+            Vector2* points,
+            uint32_t* geometryIndicesCount,
+            int32_t** geometryIndices) override;
+
+        IFACEMETHOD(StrokeContainsPoints)(
+            uint32_t pointsCount,
+            Vector2* points,
+            float strokeWidth,
+            uint32_t* geometryIndicesCount,
+            int32_t** geometryIndices) override;
+
+        IFACEMETHOD(GetGeometriesIntersectingRectangle)(
+            Rect rectangle,
+            uint32_t* geometryIndicesCount,
+            int32_t** geometryIndices) override;
+    };
+
+
+    class CanvasGeometryIndexFactory
+        : public AgileActivationFactory<ICanvasGeometryIndexStatics>
+        , private LifespanTracker<CanvasGeometryIndexFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Geometry_CanvasGeometryIndex, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            uint32_t geometryCount,
+            ICanvasGeometry** geometries,
+            ICanvasGeometryIndex** geometryIndex) override;
+
+        IFACEMETHOD(CreateWithTransformAndFlatteningTolerance)(
+            uint32_t geometryCount,
+            ICanvasGeometry** geometries,
+            Matrix3x2 transform,
+            float flatteningTolerance,
+            ICanvasGeometryIndex** geometryIndex) override;
+    };
+}}}}}
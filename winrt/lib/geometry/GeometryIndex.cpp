@@ -0,0 +1,729 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "GeometryIndex.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+
+namespace
+{
+    typedef GeometryIndex::Node Node;
+
+    D2D1_RECT_F GetSegmentBounds(D2D1_POINT_2F const& start, D2D1_POINT_2F const& end)
+    {
+        return D2D1_RECT_F
+        {
+            std::min(start.x, end.x),
+            std::min(start.y, end.y),
+            std::max(start.x, end.x),
+            std::max(start.y, end.y)
+        };
+    }
+
+    D2D1_RECT_F BoundsUnion(D2D1_RECT_F const& a, D2D1_RECT_F const& b)
+    {
+        return D2D1_RECT_F
+        {
+            std::min(a.left, b.left),
+            std::min(a.top, b.top),
+            std::max(a.right, b.right),
+            std::max(a.bottom, b.bottom)
+        };
+    }
+
+    bool BoundsOverlap(D2D1_RECT_F const& a, D2D1_RECT_F const& b)
+    {
+        return a.left <= b.right &&
+               b.left <= a.right &&
+               a.top <= b.bottom &&
+               b.top <= a.bottom;
+    }
+
+    bool BoundsContain(D2D1_RECT_F const& bounds, D2D1_POINT_2F const& point, float margin = 0)
+    {
+        return point.x >= bounds.left - margin &&
+               point.x <= bounds.right + margin &&
+               point.y >= bounds.top - margin &&
+               point.y <= bounds.bottom + margin;
+    }
+
+    //
+    // Builds a hierarchy over items[first, first + count), reordering the
+    // items so that each leaf covers a contiguous range of them.  Nodes are
+    // split at the median of their longest axis, which keeps the tree
+    // balanced however the items are distributed.  Returns the index of the
+    // root node.
+    //
+    template<typename T, typename GET_BOUNDS>
+    uint32_t BuildNodes(
+        std::vector<Node>& nodes,
+        T* items,
+        uint32_t first,
+        uint32_t count,
+        GET_BOUNDS const& getBounds)
+    {
+        auto nodeIndex = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{});
+
+        auto bounds = getBounds(items[first]);
+
+        for (uint32_t i = first + 1; i < first + count; ++i)
+            bounds = BoundsUnion(bounds, getBounds(items[i]));
+
+        if (count <= GeometryIndex::MaximumItemsPerLeaf)
+        {
+            nodes[nodeIndex] = Node{ bounds, first, count };
+            return nodeIndex;
+        }
+
+        bool splitHorizontally = (bounds.right - bounds.left) >= (bounds.bottom - bounds.top);
+
+        auto getCenter = [&](T const& item)
+        {
+            auto itemBounds = getBounds(item);
+
+            return splitHorizontally ? itemBounds.left + itemBounds.right
+                                     : itemBounds.top + itemBounds.bottom;
+        };
+
+        auto half = count / 2;
+
+        std::nth_element(
+            items + first,
+            items + first + half,
+            items + first + count,
+            [&](T const& a, T const& b) { return getCenter(a) < getCenter(b); });
+
+        BuildNodes(nodes, items, first, half, getBounds);
+        auto right = BuildNodes(nodes, items, first + half, count - half, getBounds);
+
+        nodes[nodeIndex] = Node{ bounds, right, 0 };
+        return nodeIndex;
+    }
+
+    //
+    // Visits the items in every leaf below root for which shouldVisit returns
+    // true of the leaf and all its ancestors.  visitItem returns false to stop
+    // the traversal early.
+    //
+    template<typename SHOULD_VISIT, typename VISIT_ITEM>
+    void VisitNodes(
+        std::vector<Node> const& nodes,
+        uint32_t root,
+        SHOULD_VISIT const& shouldVisit,
+        VISIT_ITEM const& visitItem)
+    {
+        // The median split halves the item count at each level, so this is
+        // deep enough for any number of items that fits in a uint32_t.
+        uint32_t stack[64];
+        uint32_t stackSize = 0;
+
+        stack[stackSize++] = root;
+
+        while (stackSize > 0)
+        {
+            auto& node = nodes[stack[--stackSize]];
+
+            if (!shouldVisit(node.Bounds))
+                continue;
+
+            if (node.Count == 0)
+            {
+                auto nodeIndex = static_cast<uint32_t>(&node - nodes.data());
+
+                stack[stackSize++] = node.First;
+                stack[stackSize++] = nodeIndex + 1;
+            }
+            else
+            {
+                for (uint32_t i = node.First; i < node.First + node.Count; ++i)
+                {
+                    if (!visitItem(i))
+                        return;
+                }
+            }
+        }
+    }
+
+    // Liang-Barsky clipping of the segment against the rectangle.
+    bool SegmentIntersectsRectangle(D2D1_POINT_2F const& start, D2D1_POINT_2F const& end, D2D1_RECT_F const& rectangle)
+    {
+        float t0 = 0;
+        float t1 = 1;
+
+        auto clip = [&](float p, float q)
+        {
+            if (p == 0)
+                return q >= 0;
+
+            auto t = q / p;
+
+            if (p < 0)
+            {
+                if (t > t1)
+                    return false;
+
+                t0 = std::max(t0, t);
+            }
+            else
+            {
+                if (t < t0)
+                    return false;
+
+                t1 = std::min(t1, t);
+            }
+
+            return true;
+        };
+
+        float dx = end.x - start.x;
+        float dy = end.y - start.y;
+
+        return clip(-dx, start.x - rectangle.left) &&
+               clip(dx, rectangle.right - start.x) &&
+               clip(-dy, start.y - rectangle.top) &&
+               clip(dy, rectangle.bottom - start.y);
+    }
+
+    float DistanceSquaredToSegment(D2D1_POINT_2F const& point, D2D1_POINT_2F const& start, D2D1_POINT_2F const& end)
+    {
+        float dx = end.x - start.x;
+        float dy = end.y - start.y;
+
+        float t = ((point.x - start.x) * dx + (point.y - start.y) * dy) / (dx * dx + dy * dy);
+        t = std::min(std::max(t, 0.0f), 1.0f);
+
+        float x = start.x + t * dx - point.x;
+        float y = start.y + t * dy - point.y;
+
+        return x * x + y * y;
+    }
+
+    //
+    // Wang's formula: the number of line segments needed to keep a polynomial
+    // curve within tolerance, given the largest second difference of its
+    // control points.  The factor is n(n-1)/8 for a curve of degree n.
+    //
+    uint32_t GetSubdivisionCount(float maximumSecondDifference, float factor, float tolerance)
+    {
+        auto count = ceilf(sqrtf(factor * maximumSecondDifference / tolerance));
+
+        if (!(count > 1))
+            return 1;
+
+        return static_cast<uint32_t>(std::min(count, 1024.0f));
+    }
+
+    float Length(float x, float y)
+    {
+        return sqrtf(x * x + y * y);
+    }
+
+
+    class GeometryIndexPathReceiver
+        : public RuntimeClass<RuntimeClassFlags<WinRtClassicComMix>, ICanvasPathReceiver>
+        , private LifespanTracker<GeometryIndexPathReceiver>
+    {
+        GeometryIndex* m_index;
+
+    public:
+        GeometryIndexPathReceiver(GeometryIndex* index)
+            : m_index(index)
+        {
+        }
+
+        IFACEMETHODIMP BeginFigure(Vector2 startPoint, CanvasFigureFill figureFill) override
+        {
+            return ExceptionBoundary([&]
+            {
+                m_index->BeginFigure(ToD2DPoint(startPoint), static_cast<D2D1_FIGURE_BEGIN>(figureFill));
+            });
+        }
+
+        IFACEMETHODIMP AddArc(Vector2, float, float, float, CanvasSweepDirection, CanvasArcSize) override
+        {
+            // The index is fed from ID2D1Geometry::Simplify, which never
+            // produces arcs.
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP AddCubicBezier(Vector2 controlPoint1, Vector2 controlPoint2, Vector2 endPoint) override
+        {
+            return ExceptionBoundary([&]
+            {
+                m_index->AddCubicBezier(ToD2DPoint(controlPoint1), ToD2DPoint(controlPoint2), ToD2DPoint(endPoint));
+            });
+        }
+
+        IFACEMETHODIMP AddLine(Vector2 endPoint) override
+        {
+            return ExceptionBoundary([&]
+            {
+                m_index->AddLine(ToD2DPoint(endPoint));
+            });
+        }
+
+        IFACEMETHODIMP AddQuadraticBezier(Vector2 controlPoint, Vector2 endPoint) override
+        {
+            return ExceptionBoundary([&]
+            {
+                m_index->AddQuadraticBezier(ToD2DPoint(controlPoint), ToD2DPoint(endPoint));
+            });
+        }
+
+        IFACEMETHODIMP SetFilledRegionDetermination(CanvasFilledRegionDetermination filledRegionDetermination) override
+        {
+            return ExceptionBoundary([&]
+            {
+                m_index->SetFillMode(static_cast<D2D1_FILL_MODE>(filledRegionDetermination));
+            });
+        }
+
+        IFACEMETHODIMP SetSegmentOptions(CanvasFigureSegmentOptions figureSegmentOptions) override
+        {
+            return ExceptionBoundary([&]
+            {
+                m_index->SetSegmentFlags(static_cast<D2D1_PATH_SEGMENT>(figureSegmentOptions));
+            });
+        }
+
+        IFACEMETHODIMP EndFigure(CanvasFigureLoop figureLoop) override
+        {
+            return ExceptionBoundary([&]
+            {
+                m_index->EndFigure(static_cast<D2D1_FIGURE_END>(figureLoop));
+            });
+        }
+    };
+}
+
+
+GeometryIndex::GeometryIndex(float flatteningTolerance)
+    : m_flatteningTolerance(flatteningTolerance)
+    , m_isInFeature(false)
+    , m_isInFigure(false)
+    , m_isFigureFilled(false)
+    , m_isStroked(true)
+    , m_figureStart{}
+    , m_currentPoint{}
+{
+}
+
+
+void GeometryIndex::BeginFeature()
+{
+    if (m_isInFeature)
+        ThrowHR(E_UNEXPECTED);
+
+    m_isInFeature = true;
+    m_isStroked = true;
+
+    m_features.push_back(Feature
+    {
+        D2D1_RECT_F{},
+        D2D1_FILL_MODE_ALTERNATE,
+        static_cast<uint32_t>(m_segments.size()),
+        0,
+        0
+    });
+}
+
+
+void GeometryIndex::EndFeature()
+{
+    if (!m_isInFeature || m_isInFigure)
+        ThrowHR(E_UNEXPECTED);
+
+    m_isInFeature = false;
+
+    auto& feature = m_features.back();
+
+    feature.SegmentCount = static_cast<uint32_t>(m_segments.size()) - feature.FirstSegment;
+
+    if (feature.SegmentCount == 0)
+        return;
+
+    auto& first = m_segments[feature.FirstSegment];
+    feature.Bounds = GetSegmentBounds(first.Start, first.End);
+
+    for (uint32_t i = feature.FirstSegment + 1; i < feature.FirstSegment + feature.SegmentCount; ++i)
+    {
+        feature.Bounds = BoundsUnion(feature.Bounds, GetSegmentBounds(m_segments[i].Start, m_segments[i].End));
+    }
+}
+
+
+ComPtr<ICanvasPathReceiver> GeometryIndex::CreatePathReceiver()
+{
+    auto receiver = Make<GeometryIndexPathReceiver>(this);
+    CheckMakeResult(receiver);
+
+    return receiver;
+}
+
+
+void GeometryIndex::SetFillMode(D2D1_FILL_MODE fillMode)
+{
+    if (!m_isInFeature)
+        ThrowHR(E_UNEXPECTED);
+
+    m_features.back().FillMode = fillMode;
+}
+
+
+void GeometryIndex::SetSegmentFlags(D2D1_PATH_SEGMENT segmentFlags)
+{
+    m_isStroked = (segmentFlags & D2D1_PATH_SEGMENT_FORCE_UNSTROKED) == 0;
+}
+
+
+void GeometryIndex::BeginFigure(D2D1_POINT_2F startPoint, D2D1_FIGURE_BEGIN figureBegin)
+{
+    if (!m_isInFeature || m_isInFigure)
+        ThrowHR(E_UNEXPECTED);
+
+    m_isInFigure = true;
+    m_isFigureFilled = (figureBegin == D2D1_FIGURE_BEGIN_FILLED);
+    m_figureStart = startPoint;
+    m_currentPoint = startPoint;
+}
+
+
+void GeometryIndex::AddLine(D2D1_POINT_2F point)
+{
+    if (!m_isInFigure)
+        ThrowHR(E_UNEXPECTED);
+
+    AddSegment(m_currentPoint, point, GetSegmentFlags());
+    m_currentPoint = point;
+}
+
+
+void GeometryIndex::AddQuadraticBezier(D2D1_POINT_2F controlPoint, D2D1_POINT_2F endPoint)
+{
+    auto start = m_currentPoint;
+
+    auto count = GetSubdivisionCount(
+        Length(start.x - 2 * controlPoint.x + endPoint.x, start.y - 2 * controlPoint.y + endPoint.y),
+        0.25f,
+        m_flatteningTolerance);
+
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        float t = static_cast<float>(i) / count;
+        float u = 1 - t;
+
+        AddLine(D2D1::Point2F(
+            u * u * start.x + 2 * u * t * controlPoint.x + t * t * endPoint.x,
+            u * u * start.y + 2 * u * t * controlPoint.y + t * t * endPoint.y));
+    }
+
+    AddLine(endPoint);
+}
+
+
+void GeometryIndex::AddCubicBezier(D2D1_POINT_2F controlPoint1, D2D1_POINT_2F controlPoint2, D2D1_POINT_2F endPoint)
+{
+    auto start = m_currentPoint;
+
+    auto count = GetSubdivisionCount(
+        std::max(
+            Length(start.x - 2 * controlPoint1.x + controlPoint2.x, start.y - 2 * controlPoint1.y + controlPoint2.y),
+            Length(controlPoint1.x - 2 * controlPoint2.x + endPoint.x, controlPoint1.y - 2 * controlPoint2.y + endPoint.y)),
+        0.75f,
+        m_flatteningTolerance);
+
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        float t = static_cast<float>(i) / count;
+        float u = 1 - t;
+
+        float a = u * u * u;
+        float b = 3 * u * u * t;
+        float c = 3 * u * t * t;
+        float d = t * t * t;
+
+        AddLine(D2D1::Point2F(
+            a * start.x + b * controlPoint1.x + c * controlPoint2.x + d * endPoint.x,
+            a * start.y + b * controlPoint1.y + c * controlPoint2.y + d * endPoint.y));
+    }
+
+    AddLine(endPoint);
+}
+
+
+void GeometryIndex::EndFigure(D2D1_FIGURE_END figureEnd)
+{
+    if (!m_isInFigure)
+        ThrowHR(E_UNEXPECTED);
+
+    m_isInFigure = false;
+
+    // Open figures are filled as if they were closed, but the closing
+    // segment isn't stroked.
+    uint8_t flags = m_isFigureFilled ? ContributesToFill : 0;
+
+    if (figureEnd == D2D1_FIGURE_END_CLOSED && m_isStroked)
+        flags |= ContributesToStroke;
+
+    AddSegment(m_currentPoint, m_figureStart, flags);
+}
+
+
+void GeometryIndex::AddSegment(D2D1_POINT_2F start, D2D1_POINT_2F end, uint8_t flags)
+{
+    if (flags == 0)
+        return;
+
+    if (start.x == end.x && start.y == end.y)
+        return;
+
+    m_segments.push_back(Segment{ start, end, flags });
+}
+
+
+uint8_t GeometryIndex::GetSegmentFlags() const
+{
+    uint8_t flags = 0;
+
+    if (m_isFigureFilled)
+        flags |= ContributesToFill;
+
+    if (m_isStroked)
+        flags |= ContributesToStroke;
+
+    return flags;
+}
+
+
+void GeometryIndex::Build()
+{
+    if (m_isInFeature)
+        ThrowHR(E_UNEXPECTED);
+
+    m_segmentNodes.clear();
+    m_featureNodes.clear();
+    m_featureOrder.clear();
+
+    auto getSegmentBounds = [](Segment const& segment) { return GetSegmentBounds(segment.Start, segment.End); };
+
+    for (uint32_t i = 0; i < m_features.size(); ++i)
+    {
+        auto& feature = m_features[i];
+
+        // Features with no segments can never be hit, so are left out.
+        if (feature.SegmentCount == 0)
+            continue;
+
+        feature.RootNode = BuildNodes(m_segmentNodes, m_segments.data(), feature.FirstSegment, feature.SegmentCount, getSegmentBounds);
+
+        m_featureOrder.push_back(i);
+    }
+
+    if (m_featureOrder.empty())
+        return;
+
+    BuildNodes(
+        m_featureNodes,
+        m_featureOrder.data(),
+        0,
+        static_cast<uint32_t>(m_featureOrder.size()),
+        [&](uint32_t featureIndex) { return m_features[featureIndex].Bounds; });
+}
+
+
+uint32_t GeometryIndex::GetFeatureCount() const
+{
+    return static_cast<uint32_t>(m_features.size());
+}
+
+
+int32_t GeometryIndex::FillContainsPoint(D2D1_POINT_2F point) const
+{
+    int32_t result = -1;
+
+    if (m_featureNodes.empty())
+        return result;
+
+    VisitNodes(
+        m_featureNodes,
+        0,
+        [&](D2D1_RECT_F const& bounds) { return BoundsContain(bounds, point); },
+        [&](uint32_t i)
+        {
+            auto featureIndex = static_cast<int32_t>(m_featureOrder[i]);
+
+            if (featureIndex > result && FillContainsPoint(m_features[featureIndex], point))
+                result = featureIndex;
+
+            return true;
+        });
+
+    return result;
+}
+
+
+int32_t GeometryIndex::StrokeContainsPoint(D2D1_POINT_2F point, float strokeWidth) const
+{
+    int32_t result = -1;
+
+    if (m_featureNodes.empty())
+        return result;
+
+    auto halfStrokeWidth = fabsf(strokeWidth) / 2;
+
+    VisitNodes(
+        m_featureNodes,
+        0,
+        [&](D2D1_RECT_F const& bounds) { return BoundsContain(bounds, point, halfStrokeWidth); },
+        [&](uint32_t i)
+        {
+            auto featureIndex = static_cast<int32_t>(m_featureOrder[i]);
+
+            if (featureIndex > result && StrokeContainsPoint(m_features[featureIndex], point, halfStrokeWidth))
+                result = featureIndex;
+
+            return true;
+        });
+
+    return result;
+}
+
+
+std::vector<int32_t> GeometryIndex::GetFeaturesIntersectingRectangle(D2D1_RECT_F const& rectangle) const
+{
+    std::vector<int32_t> result;
+
+    if (m_featureNodes.empty())
+        return result;
+
+    VisitNodes(
+        m_featureNodes,
+        0,
+        [&](D2D1_RECT_F const& bounds) { return BoundsOverlap(bounds, rectangle); },
+        [&](uint32_t i)
+        {
+            auto featureIndex = m_featureOrder[i];
+            auto& feature = m_features[featureIndex];
+
+            // If no segment crosses the rectangle then it is either wholly
+            // inside or wholly outside the fill, so testing one corner is
+            // enough.
+            if (OutlineIntersectsRectangle(feature, rectangle) ||
+                FillContainsPoint(feature, D2D1::Point2F(rectangle.left, rectangle.top)))
+            {
+                result.push_back(static_cast<int32_t>(featureIndex));
+            }
+
+            return true;
+        });
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+
+int GeometryIndex::WindingNumber(Feature const& feature, D2D1_POINT_2F point) const
+{
+    int windingNumber = 0;
+
+    // Counts crossings of a ray from the point towards +x.
+    VisitNodes(
+        m_segmentNodes,
+        feature.RootNode,
+        [&](D2D1_RECT_F const& bounds)
+        {
+            return point.y >= bounds.top && point.y <= bounds.bottom && point.x <= bounds.right;
+        },
+        [&](uint32_t i)
+        {
+            auto& segment = m_segments[i];
+
+            if ((segment.Flags & ContributesToFill) == 0)
+                return true;
+
+            auto& a = segment.Start;
+            auto& b = segment.End;
+
+            if ((a.y <= point.y) != (b.y <= point.y))
+            {
+                auto x = a.x + (point.y - a.y) * (b.x - a.x) / (b.y - a.y);
+
+                if (x > point.x)
+                    windingNumber += (b.y > a.y) ? 1 : -1;
+            }
+
+            return true;
+        });
+
+    return windingNumber;
+}
+
+
+bool GeometryIndex::FillContainsPoint(Feature const& feature, D2D1_POINT_2F point) const
+{
+    if (!BoundsContain(feature.Bounds, point))
+        return false;
+
+    auto windingNumber = WindingNumber(feature, point);
+
+    if (feature.FillMode == D2D1_FILL_MODE_ALTERNATE)
+        return (windingNumber & 1) != 0;
+    else
+        return windingNumber != 0;
+}
+
+
+bool GeometryIndex::StrokeContainsPoint(Feature const& feature, D2D1_POINT_2F point, float halfStrokeWidth) const
+{
+    bool containsPoint = false;
+    auto maximumDistanceSquared = halfStrokeWidth * halfStrokeWidth;
+
+    VisitNodes(
+        m_segmentNodes,
+        feature.RootNode,
+        [&](D2D1_RECT_F const& bounds) { return BoundsContain(bounds, point, halfStrokeWidth); },
+        [&](uint32_t i)
+        {
+            auto& segment = m_segments[i];
+
+            if ((segment.Flags & ContributesToStroke) != 0 &&
+                DistanceSquaredToSegment(point, segment.Start, segment.End) <= maximumDistanceSquared)
+            {
+                containsPoint = true;
+                return false;
+            }
+
+            return true;
+        });
+
+    return containsPoint;
+}
+
+
+bool GeometryIndex::OutlineIntersectsRectangle(Feature const& feature, D2D1_RECT_F const& rectangle) const
+{
+    bool intersects = false;
+
+    VisitNodes(
+        m_segmentNodes,
+        feature.RootNode,
+        [&](D2D1_RECT_F const& bounds) { return BoundsOverlap(bounds, rectangle); },
+        [&](uint32_t i)
+        {
+            auto& segment = m_segments[i];
+
+            if (SegmentIntersectsRectangle(segment.Start, segment.End, rectangle))
+            {
+                intersects = true;
+                return false;
+            }
+
+            return true;
+        });
+
+    return intersects;
+}
@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // A spatial index over the flattened outlines of many geometries, used to
+    // answer hit-tests without going back to D2D for each geometry and point.
+    //
+    // Each geometry (a "feature") is added as a sequence of figures made of
+    // line segments, normally by streaming the output of
+    // ID2D1Geometry::Simplify through a GeometrySink into the receiver
+    // returned by CreatePathReceiver.  Once all features have been added,
+    // Build sorts each feature's segments into a bounding volume hierarchy,
+    // and builds another hierarchy over the bounds of the features.
+    //
+    // Queries are made in the same coordinate space as the segments were
+    // added in.  Point queries report the topmost match, which is the one
+    // with the highest feature index.
+    //
+    class GeometryIndex
+    {
+    public:
+        static const uint32_t MaximumItemsPerLeaf = 4;
+
+        struct Node
+        {
+            D2D1_RECT_F Bounds;
+
+            // For leaves, Count items starting at First.  For interior nodes
+            // Count is zero, the left child immediately follows this node,
+            // and First is the index of the right child.
+            uint32_t First;
+            uint32_t Count;
+        };
+
+    private:
+        enum SegmentFlags : uint8_t
+        {
+            ContributesToFill = 1,
+            ContributesToStroke = 2,
+        };
+
+        struct Segment
+        {
+            D2D1_POINT_2F Start;
+            D2D1_POINT_2F End;
+            uint8_t Flags;
+        };
+
+        struct Feature
+        {
+            D2D1_RECT_F Bounds;
+            D2D1_FILL_MODE FillMode;
+            uint32_t FirstSegment;
+            uint32_t SegmentCount;
+            uint32_t RootNode;
+        };
+
+        float m_flatteningTolerance;
+
+        std::vector<Segment> m_segments;
+        std::vector<Feature> m_features;
+        std::vector<Node> m_segmentNodes;
+        std::vector<Node> m_featureNodes;
+        std::vector<uint32_t> m_featureOrder;
+
+        bool m_isInFeature;
+        bool m_isInFigure;
+        bool m_isFigureFilled;
+        bool m_isStroked;
+        D2D1_POINT_2F m_figureStart;
+        D2D1_POINT_2F m_currentPoint;
+
+    public:
+        GeometryIndex(float flatteningTolerance = D2D1_DEFAULT_FLATTENING_TOLERANCE);
+
+        GeometryIndex(GeometryIndex const&) = delete;
+        GeometryIndex& operator=(GeometryIndex const&) = delete;
+
+        //
+        // Adding features.  Each BeginFeature/EndFeature pair adds one
+        // feature, whose index is the number of features added before it.
+        //
+        void BeginFeature();
+        void EndFeature();
+
+        // Returns a receiver that adds figures to the current feature.
+        ComPtr<ICanvasPathReceiver> CreatePathReceiver();
+
+        void SetFillMode(D2D1_FILL_MODE fillMode);
+        void SetSegmentFlags(D2D1_PATH_SEGMENT segmentFlags);
+        void BeginFigure(D2D1_POINT_2F startPoint, D2D1_FIGURE_BEGIN figureBegin);
+        void AddLine(D2D1_POINT_2F point);
+        void AddQuadraticBezier(D2D1_POINT_2F controlPoint, D2D1_POINT_2F endPoint);
+        void AddCubicBezier(D2D1_POINT_2F controlPoint1, D2D1_POINT_2F controlPoint2, D2D1_POINT_2F endPoint);
+        void EndFigure(D2D1_FIGURE_END figureEnd);
+
+        // Must be called after the last feature is added, before any queries.
+        void Build();
+
+        //
+        // Queries.
+        //
+        uint32_t GetFeatureCount() const;
+
+        // Returns the index of the topmost feature whose fill contains the
+        // point, or -1 if there isn't one.
+        int32_t FillContainsPoint(D2D1_POINT_2F point) const;
+
+        // Returns the index of the topmost feature whose outline, stroked
+        // with round joins and caps, contains the point, or -1.
+        int32_t StrokeContainsPoint(D2D1_POINT_2F point, float strokeWidth) const;
+
+        // Returns the indices, in ascending order, of the features whose fill
+        // or outline intersects the rectangle.
+        std::vector<int32_t> GetFeaturesIntersectingRectangle(D2D1_RECT_F const& rectangle) const;
+
+    private:
+        void AddSegment(D2D1_POINT_2F start, D2D1_POINT_2F end, uint8_t flags);
+        uint8_t GetSegmentFlags() const;
+
+        int WindingNumber(Feature const& feature, D2D1_POINT_2F point) const;
+        bool FillContainsPoint(Feature const& feature, D2D1_POINT_2F point) const;
+        bool StrokeContainsPoint(Feature const& feature, D2D1_POINT_2F point, float halfStrokeWidth) const;
+        bool OutlineIntersectsRectangle(Feature const& feature, D2D1_RECT_F const& rectangle) const;
+    };
+}}}}}
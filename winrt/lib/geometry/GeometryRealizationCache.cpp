@@ -0,0 +1,371 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "GeometryRealizationCache.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    std::atomic<uint32_t> GeometryRealizationCache::s_enabledCacheCount(0);
+
+
+    GeometryRealizationCache::GeometryRealizationCache(uint64_t maximumSizeInBytes)
+        : m_maximumSizeInBytes(maximumSizeInBytes)
+        , m_currentSizeInBytes(0)
+        , m_realizationCount(0)
+        , m_hitCount(0)
+        , m_missCount(0)
+        , m_evictionCount(0)
+    {
+        if (maximumSizeInBytes != 0)
+            ++s_enabledCacheCount;
+    }
+
+
+    GeometryRealizationCache::~GeometryRealizationCache()
+    {
+        if (m_maximumSizeInBytes != 0)
+            --s_enabledCacheCount;
+    }
+
+
+    static float GetFlatteningToleranceForCurrentTransform(ID2D1DeviceContext1* deviceContext)
+    {
+        D2D1_MATRIX_3X2_F transform;
+        deviceContext->GetTransform(&transform);
+
+        float dpiX, dpiY;
+        deviceContext->GetDpi(&dpiX, &dpiY);
+
+        return GeometryRealizationCache::GetFlatteningTolerance(transform, dpiX, dpiY);
+    }
+
+
+    ComPtr<ID2D1GeometryRealization> GeometryRealizationCache::GetFilledRealization(
+        ID2D1DeviceContext1* deviceContext,
+        ID2D1Geometry* geometry)
+    {
+        // Checked first so that a disabled cache doesn't touch the device context.
+        if (!IsEnabled())
+            return nullptr;
+
+        auto flatteningTolerance = GetFlatteningToleranceForCurrentTransform(deviceContext);
+
+        if (flatteningTolerance == 0)
+            return nullptr;
+
+        return GetRealization(deviceContext, Key{ geometry, false, 0, nullptr, flatteningTolerance });
+    }
+
+
+    ComPtr<ID2D1GeometryRealization> GeometryRealizationCache::GetStrokedRealization(
+        ID2D1DeviceContext1* deviceContext,
+        ID2D1Geometry* geometry,
+        float strokeWidth,
+        ID2D1StrokeStyle* strokeStyle)
+    {
+        if (!IsEnabled())
+            return nullptr;
+
+        // Realized strokes are widened in geometry space, so they can't
+        // represent strokes that keep their width however they are transformed.
+        if (auto strokeStyle1 = MaybeAs<ID2D1StrokeStyle1>(strokeStyle))
+        {
+            if (strokeStyle1->GetStrokeTransformType() != D2D1_STROKE_TRANSFORM_TYPE_NORMAL)
+                return nullptr;
+        }
+
+        auto flatteningTolerance = GetFlatteningToleranceForCurrentTransform(deviceContext);
+
+        if (flatteningTolerance == 0)
+            return nullptr;
+
+        return GetRealization(deviceContext, Key{ geometry, true, strokeWidth, strokeStyle, flatteningTolerance });
+    }
+
+
+    ComPtr<ID2D1GeometryRealization> GeometryRealizationCache::GetRealization(
+        ID2D1DeviceContext1* deviceContext,
+        Key&& key)
+    {
+        auto sizeInBytes = GetEstimatedSizeInBytes(key.Geometry.Get(), key.IsStroke);
+
+        Lock lock(m_mutex);
+
+        auto entry = Find(key);
+
+        if (entry != m_entries.end() && entry->Realization)
+        {
+            m_entries.splice(m_entries.begin(), m_entries, entry);
+
+            ++m_hitCount;
+            return entry->Realization;
+        }
+
+        ++m_missCount;
+
+        // Realizations that could never fit would just flush everything else out.
+        if (sizeInBytes > m_maximumSizeInBytes)
+            return nullptr;
+
+        if (entry == m_entries.end())
+        {
+            // The first time a geometry is seen we only remember it.
+            auto geometry = key.Geometry.Get();
+
+            m_entries.push_front(Entry{ std::move(key), nullptr, CandidateSizeInBytes });
+            m_index.emplace(geometry, m_entries.begin());
+            m_currentSizeInBytes += CandidateSizeInBytes;
+
+            EvictTo(m_maximumSizeInBytes);
+            return nullptr;
+        }
+
+        lock.unlock();
+
+        //
+        // Creating the realization is the slow part, so it is done without
+        // holding the lock.
+        //
+
+        ComPtr<ID2D1GeometryRealization> realization;
+
+        if (key.IsStroke)
+        {
+            ThrowIfFailed(deviceContext->CreateStrokedGeometryRealization(
+                key.Geometry.Get(),
+                key.FlatteningTolerance,
+                key.StrokeWidth,
+                key.StrokeStyle.Get(),
+                &realization));
+        }
+        else
+        {
+            ThrowIfFailed(deviceContext->CreateFilledGeometryRealization(
+                key.Geometry.Get(),
+                key.FlatteningTolerance,
+                &realization));
+        }
+
+        lock.lock();
+
+        // The entry may have been evicted, or realized by another thread, in
+        // the meantime.
+        entry = Find(key);
+
+        if (entry == m_entries.end())
+        {
+            auto geometry = key.Geometry.Get();
+
+            m_entries.push_front(Entry{ std::move(key), nullptr, 0 });
+            m_index.emplace(geometry, m_entries.begin());
+            entry = m_entries.begin();
+        }
+        else
+        {
+            m_entries.splice(m_entries.begin(), m_entries, entry);
+
+            if (entry->Realization)
+                return entry->Realization;
+        }
+
+        entry->Realization = realization;
+        m_currentSizeInBytes += sizeInBytes - entry->SizeInBytes;
+        entry->SizeInBytes = sizeInBytes;
+        ++m_realizationCount;
+
+        EvictTo(m_maximumSizeInBytes);
+
+        return realization;
+    }
+
+
+    uint64_t GeometryRealizationCache::GetMaximumSize()
+    {
+        Lock lock(m_mutex);
+        return m_maximumSizeInBytes;
+    }
+
+
+    void GeometryRealizationCache::SetMaximumSize(uint64_t value)
+    {
+        Lock lock(m_mutex);
+
+        if (m_maximumSizeInBytes == 0 && value != 0)
+            ++s_enabledCacheCount;
+        else if (m_maximumSizeInBytes != 0 && value == 0)
+            --s_enabledCacheCount;
+
+        m_maximumSizeInBytes = value;
+        EvictTo(m_maximumSizeInBytes);
+    }
+
+
+    CanvasGeometryRealizationCacheStatistics GeometryRealizationCache::GetStatistics()
+    {
+        Lock lock(m_mutex);
+
+        CanvasGeometryRealizationCacheStatistics statistics{};
+        statistics.HitCount = m_hitCount;
+        statistics.MissCount = m_missCount;
+        statistics.EvictionCount = m_evictionCount;
+        statistics.RealizationCount = m_realizationCount;
+        statistics.SizeInBytes = m_currentSizeInBytes;
+        return statistics;
+    }
+
+
+    void GeometryRealizationCache::Clear()
+    {
+        EntryList entries;
+
+        {
+            Lock lock(m_mutex);
+            entries.swap(m_entries);
+            m_index.clear();
+            m_currentSizeInBytes = 0;
+            m_realizationCount = 0;
+        }
+
+        // The realizations and geometries are released here, outside the lock.
+    }
+
+
+    float GeometryRealizationCache::GetFlatteningTolerance(D2D1_MATRIX_3X2_F const& transform, float dpiX, float dpiY)
+    {
+        auto dpiDependentTransform = transform * D2D1::Matrix3x2F::Scale(dpiX / DEFAULT_DPI, dpiY / DEFAULT_DPI);
+
+        auto scale = ComputeMaximumScaleFactor(dpiDependentTransform);
+
+        if (!(scale > 0) || isinf(scale))
+            return 0;
+
+        // Rounding the scale up means the realization is at least as precise
+        // as D2D would have made it for this transform.
+        auto exponent = static_cast<int>(ceilf(log2f(scale)));
+        exponent = std::min(std::max(exponent, MinimumScaleExponent), MaximumScaleExponent);
+
+        return D2D1_DEFAULT_FLATTENING_TOLERANCE / ldexpf(1.0f, exponent);
+    }
+
+
+    static uint64_t GetEstimatedSegmentCount(ID2D1Geometry* geometry)
+    {
+        if (auto pathGeometry = MaybeAs<ID2D1PathGeometry>(geometry))
+        {
+            UINT32 segmentCount;
+
+            if (SUCCEEDED(pathGeometry->GetSegmentCount(&segmentCount)))
+                return segmentCount;
+        }
+        else if (auto geometryGroup = MaybeAs<ID2D1GeometryGroup>(geometry))
+        {
+            auto sourceCount = geometryGroup->GetSourceGeometryCount();
+
+            std::vector<ID2D1Geometry*> sources(sourceCount);
+            geometryGroup->GetSourceGeometries(sources.data(), sourceCount);
+
+            uint64_t segmentCount = 0;
+
+            for (auto source : sources)
+            {
+                ComPtr<ID2D1Geometry> ownedSource;
+                ownedSource.Attach(source);
+
+                segmentCount += GetEstimatedSegmentCount(ownedSource.Get());
+            }
+
+            return segmentCount;
+        }
+        else if (auto transformedGeometry = MaybeAs<ID2D1TransformedGeometry>(geometry))
+        {
+            ComPtr<ID2D1Geometry> source;
+            transformedGeometry->GetSourceGeometry(&source);
+
+            return GetEstimatedSegmentCount(source.Get());
+        }
+
+        // Rectangles, rounded rectangles and ellipses.
+        return 8;
+    }
+
+
+    uint64_t GeometryRealizationCache::GetEstimatedSizeInBytes(ID2D1Geometry* geometry, bool isStroke)
+    {
+        //
+        // A realization holds the triangles that the geometry tessellates to,
+        // including the extra ones used for antialiasing.  Curves are
+        // flattened into several triangles each, and strokes take about
+        // twice as many triangles as fills.
+        //
+        const uint64_t bytesPerRealization = 1024;
+        const uint64_t bytesPerFilledSegment = 512;
+        const uint64_t bytesPerStrokedSegment = 1024;
+
+        auto bytesPerSegment = isStroke ? bytesPerStrokedSegment : bytesPerFilledSegment;
+
+        return bytesPerRealization + bytesPerSegment * GetEstimatedSegmentCount(geometry);
+    }
+
+
+    bool GeometryRealizationCache::IsEnabled()
+    {
+        return m_maximumSizeInBytes.load(std::memory_order_relaxed) != 0;
+    }
+
+
+    GeometryRealizationCache::EntryList::iterator GeometryRealizationCache::Find(Key const& key)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(key.Geometry.Get());
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            if (it->second->EntryKey == key)
+                return it->second;
+        }
+
+        return m_entries.end();
+    }
+
+
+    void GeometryRealizationCache::Remove(EntryList::iterator entry)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(entry->EntryKey.Geometry.Get());
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            if (it->second == entry)
+            {
+                m_index.erase(it);
+                break;
+            }
+        }
+
+        if (entry->Realization)
+            --m_realizationCount;
+
+        m_currentSizeInBytes -= entry->SizeInBytes;
+        m_entries.erase(entry);
+    }
+
+
+    void GeometryRealizationCache::EvictTo(uint64_t maximumSizeInBytes)
+    {
+        // Caller must hold m_mutex.
+
+        while (!m_entries.empty() && m_currentSizeInBytes > maximumSizeInBytes)
+        {
+            auto last = std::prev(m_entries.end());
+
+            if (last->Realization)
+                ++m_evictionCount;
+
+            Remove(last);
+        }
+    }
+}}}}}
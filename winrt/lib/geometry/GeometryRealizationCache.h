@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // Keeps ID2D1GeometryRealizations for geometries that are drawn with
+    // FillGeometry or DrawGeometry over and over, so that D2D doesn't have to
+    // tessellate them again each time.  This does automatically what apps can
+    // do by hand with CanvasCachedGeometry.
+    //
+    // Realizations are looked up by geometry identity, whether it is a fill
+    // or a stroke, the stroke width and style, and the flattening tolerance.
+    // The tolerance is picked from the scale of the drawing transform, rounded
+    // up to a power of two, so that a realization can be reused while an app
+    // zooms smoothly and is only replaced when the scale changes a lot.
+    //
+    // Creating a realization costs more than drawing the geometry directly,
+    // so a geometry has to be drawn twice with the same parameters before it
+    // is realized; the first draw just records that it has been seen.
+    // Entries hold a reference to the geometry, which is immutable, so its
+    // identity can't be reused while it is in the cache.
+    //
+    // The cache is shared by all drawing sessions of a device.  It is disabled
+    // until a maximum size is set, and evicts entries in least-recently-used
+    // order once their estimated size exceeds it.  FillGeometry and
+    // DrawGeometry check IsAnyEnabled before looking up the device's cache,
+    // so while every cache is disabled (the default) it costs a single
+    // atomic load.
+    //
+    class GeometryRealizationCache
+    {
+    public:
+        static const uint64_t DefaultMaximumSizeInBytes = 0;
+
+        // Transform scales are rounded to a power of two within this range.
+        static const int MinimumScaleExponent = -16;
+        static const int MaximumScaleExponent = 16;
+
+        // What a geometry that has been seen but not yet realized costs.
+        static const uint64_t CandidateSizeInBytes = 128;
+
+    private:
+        struct Key
+        {
+            ComPtr<ID2D1Geometry> Geometry;
+            bool IsStroke;
+            float StrokeWidth;
+            ComPtr<ID2D1StrokeStyle> StrokeStyle;
+            float FlatteningTolerance;
+
+            bool operator==(Key const& other) const
+            {
+                return Geometry == other.Geometry
+                    && IsStroke == other.IsStroke
+                    && StrokeWidth == other.StrokeWidth
+                    && StrokeStyle == other.StrokeStyle
+                    && FlatteningTolerance == other.FlatteningTolerance;
+            }
+        };
+
+        struct Entry
+        {
+            Key EntryKey;
+
+            // Null until the geometry has been drawn a second time.
+            ComPtr<ID2D1GeometryRealization> Realization;
+
+            uint64_t SizeInBytes;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_mutex;
+
+        // Most recently used at the front.
+        EntryList m_entries;
+
+        // Indexes m_entries by geometry.  Each geometry may have several
+        // entries, for different strokes and scales.
+        std::unordered_multimap<ID2D1Geometry*, EntryList::iterator> m_index;
+
+        // Only changed while holding m_mutex, but read without it to
+        // quickly reject requests when the cache is disabled.
+        std::atomic<uint64_t> m_maximumSizeInBytes;
+
+        uint64_t m_currentSizeInBytes;
+        uint32_t m_realizationCount;
+
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+        uint64_t m_evictionCount;
+
+        // How many caches in the process have a non-zero maximum size.
+        static std::atomic<uint32_t> s_enabledCacheCount;
+
+    public:
+        GeometryRealizationCache(uint64_t maximumSizeInBytes = DefaultMaximumSizeInBytes);
+
+        ~GeometryRealizationCache();
+
+        GeometryRealizationCache(GeometryRealizationCache const&) = delete;
+        GeometryRealizationCache& operator=(GeometryRealizationCache const&) = delete;
+
+        // False if every cache is disabled, in which case there is no
+        // point asking a device for its cache.
+        static bool IsAnyEnabled()
+        {
+            return s_enabledCacheCount.load(std::memory_order_relaxed) != 0;
+        }
+
+        //
+        // Return a realization of the geometry suitable for drawing with the
+        // device context's current transform and DPI, using the cached one if
+        // there is one.  Returns null if the cache is disabled or the geometry
+        // should not be realized yet, in which case the caller should draw
+        // the geometry directly.
+        //
+        ComPtr<ID2D1GeometryRealization> GetFilledRealization(
+            ID2D1DeviceContext1* deviceContext,
+            ID2D1Geometry* geometry);
+
+        ComPtr<ID2D1GeometryRealization> GetStrokedRealization(
+            ID2D1DeviceContext1* deviceContext,
+            ID2D1Geometry* geometry,
+            float strokeWidth,
+            ID2D1StrokeStyle* strokeStyle);
+
+        uint64_t GetMaximumSize();
+        void SetMaximumSize(uint64_t value);
+
+        CanvasGeometryRealizationCacheStatistics GetStatistics();
+
+        // Releases all cached realizations.
+        void Clear();
+
+        //
+        // Returns the flattening tolerance to realize geometry with, so that
+        // it looks right when drawn with the given transform and DPI, or zero
+        // if the transform is degenerate.
+        //
+        static float GetFlatteningTolerance(D2D1_MATRIX_3X2_F const& transform, float dpiX, float dpiY);
+
+        // D2D doesn't report how much memory a realization uses, so this is
+        // an estimate based on the number of segments in the geometry.
+        static uint64_t GetEstimatedSizeInBytes(ID2D1Geometry* geometry, bool isStroke);
+
+    private:
+        ComPtr<ID2D1GeometryRealization> GetRealization(
+            ID2D1DeviceContext1* deviceContext,
+            Key&& key);
+
+        bool IsEnabled();
+
+        EntryList::iterator Find(Key const& key);
+
+        void Remove(EntryList::iterator entry);
+        void EvictTo(uint64_t maximumSizeInBytes);
+    };
+}}}}}
@@ -6,18 +6,31 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Geometry
 {
-    class TessellationSink : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1TessellationSink>,
-                             private LifespanTracker<TessellationSink>
+    //
+    // Tessellation can produce millions of triangles, so the sinks below
+    // avoid growing a single vector: triangles are either counted, written
+    // straight to their destination, or gathered in fixed size chunks.
+    //
+    const uint32_t TessellationChunkSize = 4096;
+
+    //
+    // Shared plumbing for the tessellation sinks.  D2D gives the sink no way
+    // to report errors, so the first failure is remembered and every
+    // subsequent triangle is ignored.  Callers invoke Finish once
+    // ID2D1Geometry::Tessellate has returned, to flush any buffered triangles
+    // and rethrow the remembered failure.
+    //
+    template<typename DERIVED>
+    class TessellationSinkBase : public RuntimeClass<RuntimeClassFlags<ClassicCom>, ID2D1TessellationSink>
     {
-        std::vector<CanvasTriangleVertices> m_triangles;
         HRESULT m_result;
 
     public:
-        TessellationSink()
+        TessellationSinkBase()
             : m_result(S_OK)
         { }
 
-        IFACEMETHODIMP_(void) AddTriangles(D2D1_TRIANGLE const* triangles, UINT32 trianglesCount)
+        IFACEMETHODIMP_(void) AddTriangles(D2D1_TRIANGLE const* triangles, UINT32 trianglesCount) override
         {
             if (FAILED(m_result))
                 return;
@@ -26,20 +39,191 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             {
                 auto canvasTriangles = ReinterpretAs<CanvasTriangleVertices const*>(triangles);
 
-                m_triangles.insert(m_triangles.end(), canvasTriangles, canvasTriangles + trianglesCount);
+                static_cast<DERIVED*>(this)->Add(canvasTriangles, trianglesCount);
             });
         }
 
-        IFACEMETHODIMP Close()
+        IFACEMETHODIMP Close() override
         {
             return m_result;
         }
 
-        ComArray<CanvasTriangleVertices> GetTriangles()
+        void Finish()
         {
             ThrowIfFailed(m_result);
 
-            return ComArray<CanvasTriangleVertices>(m_triangles.begin(), m_triangles.end());
+            static_cast<DERIVED*>(this)->Flush();
+        }
+
+        // Sinks that buffer triangles hide this with their own version.
+        void Flush()
+        { }
+    };
+
+
+    // Gathers triangles in memory, for CanvasGeometry.Tessellate.
+    class TessellationSink : public TessellationSinkBase<TessellationSink>,
+                             private LifespanTracker<TessellationSink>
+    {
+        std::vector<std::vector<CanvasTriangleVertices>> m_chunks;
+        size_t m_triangleCount;
+
+    public:
+        TessellationSink()
+            : m_triangleCount(0)
+        { }
+
+        void Add(CanvasTriangleVertices const* triangles, uint32_t trianglesCount)
+        {
+            while (trianglesCount > 0)
+            {
+                if (m_chunks.empty() || m_chunks.back().size() == TessellationChunkSize)
+                {
+                    m_chunks.emplace_back();
+                    m_chunks.back().reserve(TessellationChunkSize);
+                }
+
+                auto& chunk = m_chunks.back();
+                auto count = std::min(trianglesCount, static_cast<uint32_t>(TessellationChunkSize - chunk.size()));
+
+                chunk.insert(chunk.end(), triangles, triangles + count);
+
+                triangles += count;
+                trianglesCount -= count;
+                m_triangleCount += count;
+            }
+        }
+
+        ComArray<CanvasTriangleVertices> GetTriangles()
+        {
+            Finish();
+
+            if (m_triangleCount > UINT_MAX / sizeof(CanvasTriangleVertices))
+                ThrowHR(E_OUTOFMEMORY);
+
+            ComArray<CanvasTriangleVertices> triangles(m_triangleCount);
+
+            auto destination = triangles.GetData();
+
+            for (auto& chunk : m_chunks)
+            {
+                destination = std::copy(chunk.begin(), chunk.end(), destination);
+            }
+
+            return triangles;
+        }
+    };
+
+
+    // Counts triangles without storing them, to size the destination for a
+    // subsequent tessellation.
+    class CountingTessellationSink : public TessellationSinkBase<CountingTessellationSink>,
+                                     private LifespanTracker<CountingTessellationSink>
+    {
+        uint64_t m_triangleCount;
+
+    public:
+        CountingTessellationSink()
+            : m_triangleCount(0)
+        { }
+
+        void Add(CanvasTriangleVertices const*, uint32_t trianglesCount)
+        {
+            m_triangleCount += trianglesCount;
+        }
+
+        uint64_t GetTriangleCount() const
+        {
+            return m_triangleCount;
+        }
+    };
+
+
+    //
+    // Writes triangles directly into caller-supplied memory.  Triangles that
+    // do not fit are still counted, so that the caller can report how much
+    // space was needed.
+    //
+    class BufferTessellationSink : public TessellationSinkBase<BufferTessellationSink>,
+                                   private LifespanTracker<BufferTessellationSink>
+    {
+        uint8_t* m_destination;
+        uint64_t m_capacity;
+        uint64_t m_triangleCount;
+
+    public:
+        BufferTessellationSink(uint8_t* destination, uint64_t capacityInTriangles)
+            : m_destination(destination)
+            , m_capacity(capacityInTriangles)
+            , m_triangleCount(0)
+        { }
+
+        void Add(CanvasTriangleVertices const* triangles, uint32_t trianglesCount)
+        {
+            if (m_triangleCount < m_capacity)
+            {
+                auto count = std::min(static_cast<uint64_t>(trianglesCount), m_capacity - m_triangleCount);
+
+                // The buffer is not necessarily aligned, so copy bytes.
+                memcpy(m_destination + m_triangleCount * sizeof(CanvasTriangleVertices),
+                       triangles,
+                       static_cast<size_t>(count) * sizeof(CanvasTriangleVertices));
+            }
+
+            m_triangleCount += trianglesCount;
+        }
+
+        uint64_t GetTriangleCount() const
+        {
+            return m_triangleCount;
+        }
+
+        bool Overflowed() const
+        {
+            return m_triangleCount > m_capacity;
+        }
+    };
+
+
+    // Forwards triangles to an app-implemented receiver, in chunks of up to
+    // TessellationChunkSize triangles.
+    class StreamingTessellationSink : public TessellationSinkBase<StreamingTessellationSink>,
+                                      private LifespanTracker<StreamingTessellationSink>
+    {
+        ComPtr<ICanvasTessellationReceiver> m_receiver;
+        std::vector<CanvasTriangleVertices> m_chunk;
+
+    public:
+        StreamingTessellationSink(ComPtr<ICanvasTessellationReceiver> const& receiver)
+            : m_receiver(receiver)
+        {
+            m_chunk.reserve(TessellationChunkSize);
+        }
+
+        void Add(CanvasTriangleVertices const* triangles, uint32_t trianglesCount)
+        {
+            while (trianglesCount > 0)
+            {
+                auto count = std::min(trianglesCount, static_cast<uint32_t>(TessellationChunkSize - m_chunk.size()));
+
+                m_chunk.insert(m_chunk.end(), triangles, triangles + count);
+
+                triangles += count;
+                trianglesCount -= count;
+
+                if (m_chunk.size() == TessellationChunkSize)
+                    Flush();
+            }
+        }
+
+        void Flush()
+        {
+            if (m_chunk.empty())
+                return;
+
+            ThrowIfFailed(m_receiver->AddTriangles(static_cast<uint32_t>(m_chunk.size()), m_chunk.data()));
+
+            m_chunk.clear();
         }
     };
 }}}}}
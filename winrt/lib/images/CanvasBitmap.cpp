@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include <propkey.h>
+#include "utils/PixelConversion.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -364,6 +365,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         float dpi,
         CanvasAlphaMode alpha)
     {
+        EventWrite_CanvasBitmap_Load_Start();
+        auto loadEnd = MakeScopeWarden([] { EventWrite_CanvasBitmap_Load_Stop(); });
+
         ComPtr<ICanvasDeviceInternal> canvasDeviceInternal;
         ThrowIfFailed(canvasDevice->QueryInterface(canvasDeviceInternal.GetAddressOf()));
 
@@ -386,6 +390,9 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         float dpi,
         CanvasAlphaMode alpha)
     {
+        EventWrite_CanvasBitmap_Load_Start();
+        auto loadEnd = MakeScopeWarden([] { EventWrite_CanvasBitmap_Load_Stop(); });
+
         ComPtr<ICanvasDeviceInternal> canvasDeviceInternal;
         ThrowIfFailed(canvasDevice->QueryInterface(canvasDeviceInternal.GetAddressOf()));
 
@@ -1116,7 +1123,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
     static void CopyPixelBytes(
-        BitmapSubRectangle const& r,
+        uint32_t bytesPerRow,
+        uint32_t blocksHigh,
         uint32_t sourceStride,
         uint32_t destinationStride,
         stdext::checked_array_iterator<uint8_t*> const& source,
@@ -1124,20 +1132,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
 #ifdef NDEBUG
         // Skip the iterator validation in release builds.
-        auto s = source.base();
-        auto d = destination.base();
+        PixelConversion::CopyRows(source.base(), sourceStride, destination.base(), destinationStride, bytesPerRow, blocksHigh);
 #else
         auto s = source;
         auto d = destination;
-#endif
 
-        for (auto i = 0u; i < r.GetBlocksHigh(); ++i)
+        for (auto i = 0u; i < blocksHigh; ++i)
         {
-            std::copy(s, s + r.GetBytesPerRow(), d);
+            std::copy(s, s + bytesPerRow, d);
 
             s += sourceStride;
             d += destinationStride;
         }
+#endif
     }
 
     void GetPixelBytesImpl(
@@ -1150,26 +1157,69 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         CheckInPointer(valueCount);
         CheckAndClearOutPointer(valueElements);
 
+        ReadPendingPixelBytes(
+            QueuePixelBytesCopy(device, d2dBitmap, subRectangle),
+            valueCount,
+            valueElements);
+    }
+
+    void GetPixelBytesImpl(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle,
+        IBuffer* buffer)
+    {
+        CheckInPointer(buffer);
+
+        ReadPendingPixelBytes(
+            QueuePixelBytesCopy(device, d2dBitmap, subRectangle),
+            buffer);
+    }
+
+    PendingPixelBytes QueuePixelBytesCopy(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle)
+    {
         BitmapSubRectangle r(d2dBitmap, subRectangle);
 
-        ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), d2dBitmap.Get(), &subRectangle);
+        PendingPixelBytes pending;
+
+        pending.StagingBitmap = ScopedBitmapMappedPixelAccess::CopyToStagingBitmap(device.Get(), d2dBitmap.Get(), &subRectangle);
+        pending.BytesPerRow = r.GetBytesPerRow();
+        pending.BlocksHigh = r.GetBlocksHigh();
+        pending.PixelHeight = subRectangle.bottom - subRectangle.top;
+
+        return pending;
+    }
 
-        ComArray<BYTE> array(r.GetTotalBytes());
+    void ReadPendingPixelBytes(
+        PendingPixelBytes&& pending,
+        uint32_t* valueCount,
+        uint8_t** valueElements)
+    {
+        CheckInPointer(valueCount);
+        CheckAndClearOutPointer(valueElements);
+
+        auto totalBytes = pending.GetTotalBytes();
+
+        ScopedBitmapMappedPixelAccess bitmapPixelAccess(std::move(pending.StagingBitmap), pending.PixelHeight);
+
+        ComArray<BYTE> array(totalBytes);
 
         CopyPixelBytes(
-            r, 
+            pending.BytesPerRow,
+            pending.BlocksHigh,
             bitmapPixelAccess.GetStride(), 
-            r.GetBytesPerRow(),
+            pending.BytesPerRow,
             begin(bitmapPixelAccess),
             begin(array));
 
         array.Detach(valueCount, valueElements);
     }
 
-    void GetPixelBytesImpl(
-        ComPtr<ICanvasDevice> const& device,
-        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
-        D2D1_RECT_U const& subRectangle,
+    void ReadPendingPixelBytes(
+        PendingPixelBytes&& pending,
         IBuffer* buffer)
     {
         using ::Windows::Storage::Streams::IBufferByteAccess;
@@ -1178,29 +1228,30 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
         auto byteAccess = As<IBufferByteAccess>(buffer);
 
-        BitmapSubRectangle r(d2dBitmap, subRectangle);
-
-        ScopedBitmapMappedPixelAccess bitmapPixelAccess(device.Get(), d2dBitmap.Get(), &subRectangle);
+        auto totalBytes = pending.GetTotalBytes();
 
         uint32_t capacity;
         ThrowIfFailed(buffer->get_Capacity(&capacity));
 
-        if (capacity < r.GetTotalBytes())
+        if (capacity < totalBytes)
         {
             WinStringBuilder message;
-            message.Format(Strings::WrongArrayLength, r.GetTotalBytes(), capacity);
+            message.Format(Strings::WrongArrayLength, totalBytes, capacity);
             ThrowHR(E_INVALIDARG, message.Get());
         }
 
-        ThrowIfFailed(buffer->put_Length(r.GetTotalBytes()));
+        ScopedBitmapMappedPixelAccess bitmapPixelAccess(std::move(pending.StagingBitmap), pending.PixelHeight);
+
+        ThrowIfFailed(buffer->put_Length(totalBytes));
 
         uint8_t* destination;
         ThrowIfFailed(byteAccess->Buffer(&destination));
 
         CopyPixelBytes(
-            r,
+            pending.BytesPerRow,
+            pending.BlocksHigh,
             bitmapPixelAccess.GetStride(),
-            r.GetBytesPerRow(),
+            pending.BytesPerRow,
             begin(bitmapPixelAccess),
             stdext::make_checked_array_iterator(destination, capacity));
     }
@@ -1229,21 +1280,16 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         const unsigned int destSizeInPixels = subRectangleWidth * subRectangleHeight;
         ComArray<Color> array(destSizeInPixels);
 
-        byte* sourceRowStart = bitmapPixelAccess.GetLockedData();
+        // Color stores its channels as A, R, G, B, the reverse of B8G8R8A8.
+        static_assert(sizeof(Color) == 4, "Color must be tightly packed");
 
-        for (unsigned int y = 0; y < subRectangleHeight; y++)
-        {
-            for (unsigned int x = 0; x < subRectangleWidth; x++)
-            {
-                uint32_t sourcePixel = *(reinterpret_cast<uint32_t*>(&sourceRowStart[x * 4]));
-                Color& destColor = array[y * subRectangleWidth + x];
-                destColor.B = (sourcePixel >> 0) & 0xFF;
-                destColor.G = (sourcePixel >> 8) & 0xFF;
-                destColor.R = (sourcePixel >> 16) & 0xFF;
-                destColor.A = (sourcePixel >> 24) & 0xFF;
-            }
-            sourceRowStart += bitmapPixelAccess.GetStride();
-        }
+        PixelConversion::SwapByteOrderRows(
+            bitmapPixelAccess.GetLockedData(),
+            bitmapPixelAccess.GetStride(),
+            reinterpret_cast<uint8_t*>(array.GetData()),
+            subRectangleWidth * 4,
+            subRectangleWidth,
+            subRectangleHeight);
 
         array.Detach(valueCount, valueElements);
     }
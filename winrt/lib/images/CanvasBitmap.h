@@ -269,6 +269,35 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         D2D1_RECT_U const& subRectangle,
         IBuffer* buffer);
 
+    //
+    // GetPixelBytes split into two halves: QueuePixelBytesCopy starts the GPU
+    // copy into a staging bitmap, and ReadPendingPixelBytes later maps it and
+    // copies the pixels out.  Used by CanvasPixelReadback to avoid stalling.
+    //
+    struct PendingPixelBytes
+    {
+        StagingBitmapCache::Lease StagingBitmap;
+        uint32_t BytesPerRow;
+        uint32_t BlocksHigh;
+        uint32_t PixelHeight;
+
+        uint32_t GetTotalBytes() const { return BytesPerRow * BlocksHigh; }
+    };
+
+    PendingPixelBytes QueuePixelBytesCopy(
+        ComPtr<ICanvasDevice> const& device,
+        ComPtr<ID2D1Bitmap1> const& d2dBitmap,
+        D2D1_RECT_U const& subRectangle);
+
+    void ReadPendingPixelBytes(
+        PendingPixelBytes&& pending,
+        uint32_t* valueCount,
+        uint8_t** valueElements);
+
+    void ReadPendingPixelBytes(
+        PendingPixelBytes&& pending,
+        IBuffer* buffer);
+
     void GetPixelColorsImpl(
         ComPtr<ICanvasDevice> const& device,
         ComPtr<ID2D1Bitmap1> const& d2dBitmap,
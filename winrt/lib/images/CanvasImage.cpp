@@ -3,10 +3,12 @@
 // Licensed under the MIT License. See LICENSE.txt in the project root for license information.
 
 #include "pch.h"
+#include "HistogramBatch.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     using namespace ABI::Windows::Foundation;
+    using namespace ::collections;
 
     DeviceContextLease GetDeviceContextForGetBounds(ICanvasDevice* device, ICanvasResourceCreator* resourceCreator)
     {
@@ -298,6 +300,79 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    IFACEMETHODIMP CanvasImageFactory::ComputeHistogramsAsync(
+        ICanvasResourceCreator* resourceCreator,
+        uint32_t imageCount,
+        ICanvasImage** images,
+        uint32_t regionCount,
+        CanvasHistogramRegion* regions,
+        IAsyncOperation<IVectorView<float>*>** operation)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(resourceCreator);
+                CheckAndClearOutPointer(operation);
+
+                if (imageCount != regionCount)
+                    ThrowHR(E_INVALIDARG);
+
+                if (imageCount > 0)
+                {
+                    CheckInPointer(images);
+                    CheckInPointer(regions);
+                }
+
+                for (uint32_t i = 0; i < regionCount; ++i)
+                {
+                    CheckInPointer(images[i]);
+                    HistogramBatch::ValidateRegion(regions[i]);
+                }
+
+                ComPtr<ICanvasDevice> device;
+                ThrowIfFailed(resourceCreator->get_Device(&device));
+
+                auto deviceInternal = As<ICanvasDeviceInternal>(device);
+
+                // The images are realized here, since effect graphs must not
+                // be realized on another thread while the app may be
+                // changing them.
+                std::vector<HistogramBatch::Region> batchRegions;
+                batchRegions.reserve(regionCount);
+
+                {
+                    auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
+
+                    for (uint32_t i = 0; i < regionCount; ++i)
+                    {
+                        float realizedDpi;
+                        auto d2dImage = As<ICanvasImageInternal>(images[i])->GetD2DImage(device.Get(), deviceContext.Get(), GetImageFlags::None, DEFAULT_DPI, &realizedDpi);
+
+                        batchRegions.push_back(HistogramBatch::Region{ d2dImage, realizedDpi, ToD2DRect(regions[i].SourceRectangle), regions[i].Channels, regions[i].NumberOfBins });
+                    }
+                }
+
+                auto batch = std::make_shared<HistogramBatch>(deviceInternal, std::move(batchRegions));
+
+                auto newOperation = Make<AsyncOperation<IVectorView<float>>>(
+                    [=]
+                    {
+                        auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
+
+                        auto results = Make<Vector<float>>(true, batch->Evaluate(deviceContext.Get()));
+                        CheckMakeResult(results);
+
+                        ComPtr<IVectorView<float>> view;
+                        ThrowIfFailed(results->GetView(&view));
+                        return view;
+                    });
+
+                CheckMakeResult(newOperation);
+                ThrowIfFailed(newOperation.CopyTo(operation));
+            });
+    }
+
+
     IFACEMETHODIMP CanvasImageFactory::IsHistogramSupported(
         ICanvasDevice* device,
         boolean* result)
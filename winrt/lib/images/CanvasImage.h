@@ -12,6 +12,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     using namespace ::Microsoft::WRL;
     using namespace ABI::Windows::Foundation;
+    using namespace ABI::Windows::Foundation::Collections;
     using namespace ABI::Windows::Storage::Streams;
 
 
@@ -163,6 +164,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
             uint32_t* valueCount,
             float** valueElements) override;
 
+        IFACEMETHODIMP ComputeHistogramsAsync(
+            ICanvasResourceCreator* resourceCreator,
+            uint32_t imageCount,
+            ICanvasImage** images,
+            uint32_t regionCount,
+            CanvasHistogramRegion* regions,
+            IAsyncOperation<IVectorView<float>*>** operation) override;
+
         IFACEMETHODIMP IsHistogramSupported(
             ICanvasDevice* device,
             boolean* result) override;
@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "CanvasPixelReadback.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // CanvasPixelReadbackFactory
+    //
+
+    static ComPtr<CanvasPixelReadback> CreatePixelReadback(
+        ICanvasResourceCreator* resourceCreator,
+        int32_t latency)
+    {
+        CheckInPointer(resourceCreator);
+
+        if (latency < 0 || latency > CanvasPixelReadback::MaximumLatency)
+            ThrowHR(E_INVALIDARG);
+
+        ComPtr<ICanvasDevice> device;
+        ThrowIfFailed(resourceCreator->get_Device(&device));
+
+        auto pixelReadback = Make<CanvasPixelReadback>(device.Get(), latency);
+        CheckMakeResult(pixelReadback);
+
+        return pixelReadback;
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadbackFactory::Create(
+        ICanvasResourceCreator* resourceCreator,
+        ICanvasPixelReadback** pixelReadback)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(pixelReadback);
+
+                auto newPixelReadback = CreatePixelReadback(resourceCreator, CanvasPixelReadback::DefaultLatency);
+
+                ThrowIfFailed(newPixelReadback.CopyTo(pixelReadback));
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadbackFactory::CreateWithLatency(
+        ICanvasResourceCreator* resourceCreator,
+        int32_t latency,
+        ICanvasPixelReadback** pixelReadback)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(pixelReadback);
+
+                auto newPixelReadback = CreatePixelReadback(resourceCreator, latency);
+
+                ThrowIfFailed(newPixelReadback.CopyTo(pixelReadback));
+            });
+    }
+
+
+    //
+    // CanvasPixelReadback
+    //
+
+    CanvasPixelReadback::CanvasPixelReadback(ICanvasDevice* device, int32_t latency)
+        : m_device(device)
+        , m_latency(latency)
+        , m_frame(0)
+    {
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::get_Latency(int32_t* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                m_device.EnsureNotClosed();
+
+                *value = m_latency;
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::get_IsReady(boolean* value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(value);
+                m_device.EnsureNotClosed();
+
+                *value = !m_queue.empty() && IsRetired(m_queue.front());
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::Enqueue(
+        ICanvasBitmap* bitmap)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                EnqueueImpl(bitmap, nullptr);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::EnqueueWithSubrectangle(
+        ICanvasBitmap* bitmap,
+        int32_t left,
+        int32_t top,
+        int32_t width,
+        int32_t height)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                auto subRectangle = ToD2DRectU(left, top, width, height);
+
+                EnqueueImpl(bitmap, &subRectangle);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::TryGetPixelBytes(
+        uint32_t* valueCount,
+        uint8_t** valueElements,
+        boolean* succeeded)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(valueCount);
+                CheckAndClearOutPointer(valueElements);
+                CheckInPointer(succeeded);
+                m_device.EnsureNotClosed();
+
+                *valueCount = 0;
+
+                PendingPixelBytes pixels;
+
+                *succeeded = TryDequeue(&pixels);
+
+                if (*succeeded)
+                    ReadPendingPixelBytes(std::move(pixels), valueCount, valueElements);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::TryGetPixelBytesWithBuffer(
+        IBuffer* buffer,
+        boolean* succeeded)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckInPointer(buffer);
+                CheckInPointer(succeeded);
+                m_device.EnsureNotClosed();
+
+                PendingPixelBytes pixels;
+
+                *succeeded = TryDequeue(&pixels);
+
+                if (*succeeded)
+                    ReadPendingPixelBytes(std::move(pixels), buffer);
+            });
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::Close()
+    {
+        m_queue.clear();
+        m_device.Close();
+        return S_OK;
+    }
+
+
+    IFACEMETHODIMP CanvasPixelReadback::get_Device(ICanvasDevice** value)
+    {
+        return ExceptionBoundary(
+            [&]
+            {
+                CheckAndClearOutPointer(value);
+
+                auto& device = m_device.EnsureNotClosed();
+
+                ThrowIfFailed(device.CopyTo(value));
+            });
+    }
+
+
+    void CanvasPixelReadback::EnqueueImpl(ICanvasBitmap* bitmap, D2D1_RECT_U const* subRectangle)
+    {
+        CheckInPointer(bitmap);
+
+        auto& device = m_device.EnsureNotClosed();
+
+        ComPtr<ICanvasDevice> bitmapDevice;
+        ThrowIfFailed(As<ICanvasResourceCreator>(bitmap)->get_Device(&bitmapDevice));
+
+        if (!IsSameInstance(device.Get(), bitmapDevice.Get()))
+            ThrowHR(E_INVALIDARG, Strings::PixelReadbackWrongDevice);
+
+        auto d2dBitmap = As<ICanvasBitmapInternal>(bitmap)->GetD2DBitmap();
+
+        D2D1_RECT_U extents;
+
+        if (!subRectangle)
+        {
+            auto size = d2dBitmap->GetPixelSize();
+            extents = D2D1_RECT_U{ 0, 0, size.width, size.height };
+            subRectangle = &extents;
+        }
+
+        auto pixels = QueuePixelBytesCopy(device, d2dBitmap, *subRectangle);
+
+        m_queue.push_back(QueuedReadback{ m_frame, std::move(pixels) });
+        ++m_frame;
+
+        //
+        // Nobody is going to ask for a retired readback once a newer one has
+        // retired, so hand its staging bitmap straight back to the cache.
+        //
+        while (m_queue.size() > 1 && IsRetired(m_queue[1]))
+        {
+            m_queue.pop_front();
+        }
+    }
+
+
+    bool CanvasPixelReadback::IsRetired(QueuedReadback const& readback) const
+    {
+        return m_frame - readback.Frame > static_cast<uint64_t>(m_latency);
+    }
+
+
+    bool CanvasPixelReadback::TryDequeue(PendingPixelBytes* pixels)
+    {
+        if (m_queue.empty() || !IsRetired(m_queue.front()))
+            return false;
+
+        // EnqueueImpl guarantees that only the front entry can be retired.
+        assert(m_queue.size() == 1 || !IsRetired(m_queue[1]));
+
+        *pixels = std::move(m_queue.front().Pixels);
+        m_queue.pop_front();
+
+        return true;
+    }
+
+
+    ActivatableClassWithFactory(CanvasPixelReadback, CanvasPixelReadbackFactory);
+}}}}
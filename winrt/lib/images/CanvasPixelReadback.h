@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "CanvasBitmap.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    class CanvasPixelReadback
+        : public RuntimeClass<ICanvasPixelReadback, IClosable, ICanvasResourceCreator>
+        , private LifespanTracker<CanvasPixelReadback>
+    {
+        InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_CanvasPixelReadback, BaseTrust);
+
+        struct QueuedReadback
+        {
+            uint64_t Frame;
+            PendingPixelBytes Pixels;
+        };
+
+        ClosablePtr<ICanvasDevice> m_device;
+        int32_t m_latency;
+
+        // Counts calls to Enqueue.
+        uint64_t m_frame;
+
+        // Oldest first.  Holds at most one retired readback, followed by up
+        // to m_latency that the GPU may still be working on.
+        std::deque<QueuedReadback> m_queue;
+
+    public:
+        static const int32_t DefaultLatency = 2;
+        static const int32_t MaximumLatency = 8;
+
+        CanvasPixelReadback(ICanvasDevice* device, int32_t latency);
+
+        // ICanvasPixelReadback
+
+        IFACEMETHOD(get_Latency)(int32_t* value) override;
+
+        IFACEMETHOD(get_IsReady)(boolean* value) override;
+
+        IFACEMETHOD(Enqueue)(
+            ICanvasBitmap* bitmap) override;
+
+        IFACEMETHOD(EnqueueWithSubrectangle)(
+            ICanvasBitmap* bitmap,
+            int32_t left,
+            int32_t top,
+            int32_t width,
+            int32_t height) override;
+
+        IFACEMETHOD(TryGetPixelBytes)(
+            uint32_t* valueCount,
+            uint8_t** valueElements,
+            boolean* succeeded) override;
+
+        IFACEMETHOD(TryGetPixelBytesWithBuffer)(
+            IBuffer* buffer,
+            boolean* succeeded) override;
+
+        // IClosable
+
+        IFACEMETHOD(Close)() override;
+
+        // ICanvasResourceCreator
+
+        IFACEMETHOD(get_Device)(ICanvasDevice** value) override;
+
+    private:
+        void EnqueueImpl(ICanvasBitmap* bitmap, D2D1_RECT_U const* subRectangle);
+
+        bool IsRetired(QueuedReadback const& readback) const;
+
+        // Removes and returns the most recent retired readback, if any.
+        bool TryDequeue(PendingPixelBytes* pixels);
+    };
+
+
+    class CanvasPixelReadbackFactory
+        : public AgileActivationFactory<ICanvasPixelReadbackFactory>
+        , private LifespanTracker<CanvasPixelReadbackFactory>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasPixelReadback, BaseTrust);
+
+    public:
+        IFACEMETHOD(Create)(
+            ICanvasResourceCreator* resourceCreator,
+            ICanvasPixelReadback** pixelReadback) override;
+
+        IFACEMETHOD(CreateWithLatency)(
+            ICanvasResourceCreator* resourceCreator,
+            int32_t latency,
+            ICanvasPixelReadback** pixelReadback) override;
+    };
+}}}}
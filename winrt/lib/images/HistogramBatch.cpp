@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "HistogramBatch.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    static const struct
+    {
+        CanvasHistogramChannels Channel;
+        D2D1_CHANNEL_SELECTOR ChannelSelect;
+        bool IsLuminance;
+    } ChannelOrder[] =
+    {
+        { CanvasHistogramChannels::Red,       D2D1_CHANNEL_SELECTOR_R, false },
+        { CanvasHistogramChannels::Green,     D2D1_CHANNEL_SELECTOR_G, false },
+        { CanvasHistogramChannels::Blue,      D2D1_CHANNEL_SELECTOR_B, false },
+        { CanvasHistogramChannels::Alpha,     D2D1_CHANNEL_SELECTOR_A, false },
+
+        // Luminance is computed into the red channel by a color matrix effect.
+        { CanvasHistogramChannels::Luminance, D2D1_CHANNEL_SELECTOR_R, true  },
+    };
+
+
+    void HistogramBatch::ValidateRegion(CanvasHistogramRegion const& region)
+    {
+        auto allChannels = CanvasHistogramChannels::Red |
+                           CanvasHistogramChannels::Green |
+                           CanvasHistogramChannels::Blue |
+                           CanvasHistogramChannels::Alpha |
+                           CanvasHistogramChannels::Luminance;
+
+        if (region.Channels == CanvasHistogramChannels::None ||
+            (region.Channels & ~allChannels) != CanvasHistogramChannels::None)
+        {
+            ThrowHR(E_INVALIDARG);
+        }
+
+        if (region.NumberOfBins < 2 || region.NumberOfBins > 1024)
+            ThrowHR(E_INVALIDARG);
+    }
+
+
+    HistogramBatch::HistogramBatch(ComPtr<ICanvasDeviceInternal> const& device, std::vector<Region>&& regions)
+        : m_device(device)
+        , m_regions(std::move(regions))
+        , m_resultCount(0)
+    {
+        for (auto& region : m_regions)
+        {
+            for (auto& channel : ChannelOrder)
+            {
+                if ((region.Channels & channel.Channel) == CanvasHistogramChannels::None)
+                    continue;
+
+                m_jobs.push_back(Job{ &region, channel.ChannelSelect, channel.IsLuminance, m_resultCount });
+                m_resultCount += region.NumberOfBins;
+            }
+        }
+    }
+
+
+    std::vector<float> HistogramBatch::Evaluate(ID2D1DeviceContext* deviceContext)
+    {
+        std::vector<float> results(m_resultCount);
+
+        for (size_t i = 0; i < m_jobs.size(); i += CanvasDevice::MaximumPooledHistogramEffects)
+        {
+            auto jobCount = std::min<size_t>(m_jobs.size() - i, CanvasDevice::MaximumPooledHistogramEffects);
+
+            EvaluatePass(deviceContext, &m_jobs[i], jobCount, results.data());
+        }
+
+        return results;
+    }
+
+
+    static ComPtr<ID2D1Effect> CreateLuminanceEffect(ID2D1DeviceContext* deviceContext)
+    {
+        ComPtr<ID2D1Effect> effect;
+        ThrowIfFailed(deviceContext->CreateEffect(CLSID_D2D1ColorMatrix, &effect));
+
+        // Rec. 709 luminance goes into the red channel, keeping alpha unchanged.
+        auto matrix = D2D1::Matrix5x4F(0.2126f, 0, 0, 0,
+                                       0.7152f, 0, 0, 0,
+                                       0.0722f, 0, 0, 0,
+                                       0,       0, 0, 1,
+                                       0,       0, 0, 0);
+
+        ThrowIfFailed(effect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, matrix));
+
+        return effect;
+    }
+
+
+    void HistogramBatch::EvaluatePass(
+        ID2D1DeviceContext* deviceContext,
+        Job const* jobs,
+        size_t jobCount,
+        float* results)
+    {
+        std::vector<CanvasDevice::HistogramAndAtlasEffects> chains;
+        chains.reserve(jobCount);
+
+        auto releaseChains = MakeScopeWarden(
+            [&]
+            {
+                for (auto& chain : chains)
+                {
+                    chain.AtlasEffect->SetInput(0, nullptr);
+                    m_device->ReleaseHistogramEffect(std::move(chain));
+                }
+            });
+
+        // Configure one effect chain per job.
+        for (size_t i = 0; i < jobCount; ++i)
+        {
+            auto& job = jobs[i];
+
+            chains.push_back(m_device->LeaseHistogramEffect(deviceContext));
+            auto& chain = chains.back();
+
+            if (job.Source->RealizedDpi != 0 && job.Source->RealizedDpi != DEFAULT_DPI)
+            {
+                ThrowIfFailed(D2D1::SetDpiCompensatedEffectInput(deviceContext, chain.AtlasEffect.Get(), 0, As<ID2D1Bitmap>(job.Source->Image).Get()));
+            }
+            else
+            {
+                chain.AtlasEffect->SetInput(0, job.Source->Image.Get());
+            }
+
+            ThrowIfFailed(chain.AtlasEffect->SetValue(D2D1_ATLAS_PROP_INPUT_RECT, job.Source->SourceRectangle));
+
+            if (job.IsLuminance)
+            {
+                if (!chain.LuminanceEffect)
+                    chain.LuminanceEffect = CreateLuminanceEffect(deviceContext);
+
+                chain.LuminanceEffect->SetInputEffect(0, chain.AtlasEffect.Get());
+                chain.HistogramEffect->SetInputEffect(0, chain.LuminanceEffect.Get());
+            }
+            else
+            {
+                chain.HistogramEffect->SetInputEffect(0, chain.AtlasEffect.Get());
+            }
+
+            ThrowIfFailed(chain.HistogramEffect->SetValue(D2D1_HISTOGRAM_PROP_CHANNEL_SELECT, job.ChannelSelect));
+            ThrowIfFailed(chain.HistogramEffect->SetValue(D2D1_HISTOGRAM_PROP_NUM_BINS, job.Source->NumberOfBins));
+        }
+
+        // Evaluate all the histograms in a single pass.
+        deviceContext->BeginDraw();
+
+        for (auto& chain : chains)
+        {
+            deviceContext->DrawImage(As<ID2D1Image>(chain.HistogramEffect).Get());
+        }
+
+        ThrowIfFailed(deviceContext->EndDraw());
+
+        // Read back the results.
+        for (size_t i = 0; i < jobCount; ++i)
+        {
+            auto& job = jobs[i];
+
+            ThrowIfFailed(chains[i].HistogramEffect->GetValue(D2D1_HISTOGRAM_PROP_HISTOGRAM_OUTPUT,
+                                                              reinterpret_cast<BYTE*>(results + job.ResultOffset),
+                                                              job.Source->NumberOfBins * sizeof(float)));
+        }
+    }
+}}}}
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // Computes the histograms requested by CanvasImage.ComputeHistogramsAsync.
+    //
+    // Each selected channel of each region needs its own D2D histogram
+    // effect.  Rather than drawing these one at a time, the batch leases
+    // several effect chains from the device and evaluates them all inside a
+    // single BeginDraw/EndDraw, so a region's red, green, blue and luminance
+    // histograms cost one GPU round trip rather than four.
+    //
+    // The images are realized when the batch is created, on the calling
+    // thread.  Evaluate may then be called from any thread.
+    //
+    class HistogramBatch
+    {
+    public:
+        struct Region
+        {
+            ComPtr<ID2D1Image> Image;
+            float RealizedDpi;
+            D2D1_RECT_F SourceRectangle;
+            CanvasHistogramChannels Channels;
+            int32_t NumberOfBins;
+        };
+
+    private:
+        // One histogram effect's worth of work.
+        struct Job
+        {
+            Region const* Source;
+            D2D1_CHANNEL_SELECTOR ChannelSelect;
+            bool IsLuminance;
+            size_t ResultOffset;
+        };
+
+        ComPtr<ICanvasDeviceInternal> m_device;
+        std::vector<Region> m_regions;
+        std::vector<Job> m_jobs;
+        size_t m_resultCount;
+
+    public:
+        HistogramBatch(ComPtr<ICanvasDeviceInternal> const& device, std::vector<Region>&& regions);
+
+        HistogramBatch(HistogramBatch const&) = delete;
+        HistogramBatch& operator=(HistogramBatch const&) = delete;
+
+        size_t GetResultCount() const { return m_resultCount; }
+
+        // Evaluates every histogram, using at most
+        // CanvasDevice::MaximumPooledHistogramEffects effect chains per pass.
+        std::vector<float> Evaluate(ID2D1DeviceContext* deviceContext);
+
+        static void ValidateRegion(CanvasHistogramRegion const& region);
+
+    private:
+        void EvaluatePass(
+            ID2D1DeviceContext* deviceContext,
+            Job const* jobs,
+            size_t jobCount,
+            float* results);
+    };
+}}}}
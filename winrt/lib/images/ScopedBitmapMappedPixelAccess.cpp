@@ -7,54 +7,94 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
-    ScopedBitmapMappedPixelAccess::ScopedBitmapMappedPixelAccess(ICanvasDevice* device, ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle)
+    static D2D1_SIZE_U GetCopySize(ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle)
     {
-        auto bitmapSize = d2dBitmap->GetPixelSize();
-        
-        auto bitmapOptions = D2D1_BITMAP_OPTIONS_CPU_READ | 
-                             D2D1_BITMAP_OPTIONS_CANNOT_DRAW;
-        
-        D2D1_BITMAP_PROPERTIES1 bitmapProperties = D2D1::BitmapProperties1(bitmapOptions, d2dBitmap->GetPixelFormat());
-
-        if (optionalSubRectangle)
+        if (!optionalSubRectangle)
+            return d2dBitmap->GetPixelSize();
+
+        assert(optionalSubRectangle->right > optionalSubRectangle->left);
+        assert(optionalSubRectangle->bottom > optionalSubRectangle->top);
+
+        return D2D1_SIZE_U
         {
-            assert(optionalSubRectangle->right > optionalSubRectangle->left);
-            assert(optionalSubRectangle->bottom > optionalSubRectangle->top);
+            optionalSubRectangle->right - optionalSubRectangle->left,
+            optionalSubRectangle->bottom - optionalSubRectangle->top
+        };
+    }
+
+
+    ScopedBitmapMappedPixelAccess::ScopedBitmapMappedPixelAccess(ICanvasDevice* device, ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle)
+        : m_stagingResource(CopyToStagingBitmap(device, d2dBitmap, optionalSubRectangle))
+    {
+        Map(GetCopySize(d2dBitmap, optionalSubRectangle).height);
+    }
 
-            bitmapSize.width = optionalSubRectangle->right - optionalSubRectangle->left;
-            bitmapSize.height = optionalSubRectangle->bottom - optionalSubRectangle->top;
-        }
 
-        auto deviceContext = As<ICanvasDeviceInternal>(device)->GetResourceCreationDeviceContext();
+    ScopedBitmapMappedPixelAccess::ScopedBitmapMappedPixelAccess(StagingBitmapCache::Lease&& stagingBitmap, unsigned int height)
+        : m_stagingResource(std::move(stagingBitmap))
+    {
+        assert(m_stagingResource.Get());
+
+        Map(height);
+    }
+
+
+    ScopedBitmapMappedPixelAccess::~ScopedBitmapMappedPixelAccess()
+    {
+        HRESULT hr = m_stagingResource->Unmap();
+
+        // Don't hand a bitmap we couldn't unmap back to the cache.
+        if (FAILED(hr))
+            m_stagingResource.Discard();
+
+        ThrowIfFailed(hr);
+    }
 
-        ThrowIfFailed(deviceContext->CreateBitmap(
-            bitmapSize, 
-            nullptr,
-            0,
-            &bitmapProperties,
-            &m_stagingResource));
+
+    StagingBitmapCache::Lease ScopedBitmapMappedPixelAccess::CopyToStagingBitmap(ICanvasDevice* device, ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle)
+    {
+        auto bitmapSize = GetCopySize(d2dBitmap, optionalSubRectangle);
+
+        //
+        // The staging bitmap comes from the device's cache, so it may be
+        // larger than bitmapSize.  Only the top-left bitmapSize pixels of it
+        // are ever looked at.
+        //
+        auto deviceInternal = As<ICanvasDeviceInternal>(device);
+        auto stagingBitmapCache = deviceInternal->GetStagingBitmapCache();
+
+        StagingBitmapCache::Lease stagingResource;
+
+        {
+            auto deviceContext = deviceInternal->GetResourceCreationDeviceContext();
+
+            stagingResource = stagingBitmapCache->Acquire(
+                deviceContext.Get(),
+                d2dBitmap->GetPixelFormat(),
+                bitmapSize);
+        }
 
         // 
         // This class copies only the requested subrectangle, not the
         // whole texture, in the interest of a small perf gain.
         // The copied area is located at (0,0).
         //
-        ThrowIfFailed(m_stagingResource->CopyFromBitmap(
+        ThrowIfFailed(stagingResource->CopyFromBitmap(
             nullptr, 
             d2dBitmap,
             optionalSubRectangle));
 
-        ThrowIfFailed(m_stagingResource->Map(
-            D2D1_MAP_OPTIONS_READ,
-            &m_mappedSubresource));
-
-        m_lockedBufferSize = m_mappedSubresource.pitch * bitmapSize.height;
+        return stagingResource;
     }
 
 
-    ScopedBitmapMappedPixelAccess::~ScopedBitmapMappedPixelAccess()
+    void ScopedBitmapMappedPixelAccess::Map(unsigned int height)
     {
-        ThrowIfFailed(m_stagingResource->Unmap());
+        ThrowIfFailed(m_stagingResource->Map(
+            D2D1_MAP_OPTIONS_READ,
+            &m_mappedSubresource));
+
+        m_lockedBufferSize = m_mappedSubresource.pitch * height;
     }
 
 }}}}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "utils/D2DResourceLock.h"
+#include "StagingBitmapCache.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -12,15 +13,29 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     {
         D2D1_MAPPED_RECT m_mappedSubresource;
         unsigned int m_lockedBufferSize;
-        ComPtr<ID2D1Bitmap1> m_stagingResource;
+        StagingBitmapCache::Lease m_stagingResource;
 
     public:
         ScopedBitmapMappedPixelAccess(ICanvasDevice* device, ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle = nullptr);
+
+        // Maps a staging bitmap previously filled by CopyToStagingBitmap.
+        ScopedBitmapMappedPixelAccess(StagingBitmapCache::Lease&& stagingBitmap, unsigned int height);
+
         ~ScopedBitmapMappedPixelAccess();
 
+        //
+        // Queues a copy of the requested pixels (or the whole bitmap) to the
+        // top-left of a CPU readable staging bitmap.  This does not wait for
+        // the GPU; that only happens once the staging bitmap is mapped.
+        //
+        static StagingBitmapCache::Lease CopyToStagingBitmap(ICanvasDevice* device, ID2D1Bitmap1* d2dBitmap, D2D1_RECT_U const* optionalSubRectangle = nullptr);
+
         uint8_t* GetLockedData()           const { return m_mappedSubresource.bits; }
         unsigned int GetLockedBufferSize() const { return m_lockedBufferSize; }
         unsigned int GetStride()           const { return m_mappedSubresource.pitch; }
+
+    private:
+        void Map(unsigned int height);
     };
 
 
@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "StagingBitmapCache.h"
+
+
+StagingBitmapCache::StagingBitmapCache(uint64_t maximumSizeInBytes)
+    : m_maximumSizeInBytes(maximumSizeInBytes)
+    , m_currentSizeInBytes(0)
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_evictionCount(0)
+{
+}
+
+
+StagingBitmapCache::Lease StagingBitmapCache::Acquire(
+    ID2D1DeviceContext* deviceContext,
+    D2D1_PIXEL_FORMAT const& pixelFormat,
+    D2D1_SIZE_U const& size)
+{
+    auto key = GetBucketKey(pixelFormat, size);
+
+    auto bitmap = TryTake(key);
+
+    if (!bitmap)
+    {
+        auto bitmapProperties = D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_CPU_READ | D2D1_BITMAP_OPTIONS_CANNOT_DRAW,
+            pixelFormat);
+
+        ThrowIfFailed(deviceContext->CreateBitmap(
+            D2D1_SIZE_U{ key.Width, key.Height },
+            nullptr,
+            0,
+            &bitmapProperties,
+            &bitmap));
+    }
+
+    return Lease(shared_from_this(), key, std::move(bitmap));
+}
+
+
+uint64_t StagingBitmapCache::GetMaximumSize()
+{
+    Lock lock(m_mutex);
+    return m_maximumSizeInBytes;
+}
+
+
+void StagingBitmapCache::SetMaximumSize(uint64_t value)
+{
+    Lock lock(m_mutex);
+    m_maximumSizeInBytes = value;
+    EvictTo(m_maximumSizeInBytes);
+}
+
+
+CanvasStagingBitmapCacheStatistics StagingBitmapCache::GetStatistics()
+{
+    Lock lock(m_mutex);
+
+    CanvasStagingBitmapCacheStatistics statistics{};
+    statistics.HitCount = m_hitCount;
+    statistics.MissCount = m_missCount;
+    statistics.EvictionCount = m_evictionCount;
+    statistics.SizeInBytes = m_currentSizeInBytes;
+    return statistics;
+}
+
+
+void StagingBitmapCache::Clear()
+{
+    std::list<Entry> entries;
+
+    {
+        Lock lock(m_mutex);
+        entries.swap(m_entries);
+        m_currentSizeInBytes = 0;
+    }
+
+    // The bitmaps are released here, outside the lock.
+}
+
+
+StagingBitmapCache::Key StagingBitmapCache::GetBucketKey(D2D1_PIXEL_FORMAT const& pixelFormat, D2D1_SIZE_U const& size)
+{
+    return Key
+    {
+        pixelFormat.format,
+        pixelFormat.alphaMode,
+        GetBucketSize(size.width),
+        GetBucketSize(size.height)
+    };
+}
+
+
+uint32_t StagingBitmapCache::GetBucketSize(uint32_t size)
+{
+    const uint32_t largeBucketThreshold = 1024;
+    const uint32_t largeBucketGranularity = 256;
+
+    if (size <= MinimumBucketSize)
+        return MinimumBucketSize;
+
+    //
+    // Small sizes are rounded up to a power of two.  Above that, rounding up
+    // to the next power of two would waste too much memory, so we round up to
+    // a multiple of 256 instead.  Every D3D maximum texture size is a
+    // multiple of 256, so this never rounds a valid size up to an invalid one.
+    //
+
+    if (size <= largeBucketThreshold)
+    {
+        uint32_t bucket = MinimumBucketSize;
+        while (bucket < size)
+            bucket *= 2;
+        return bucket;
+    }
+
+    return (size + largeBucketGranularity - 1) / largeBucketGranularity * largeBucketGranularity;
+}
+
+
+uint64_t StagingBitmapCache::GetSizeInBytes(Key const& key)
+{
+    auto blockSize = GetBlockSize(key.Format);
+    auto bytesPerBlock = GetBytesPerBlock(key.Format);
+
+    uint64_t blocksWide = (key.Width + blockSize - 1) / blockSize;
+    uint64_t blocksHigh = (key.Height + blockSize - 1) / blockSize;
+
+    return blocksWide * blocksHigh * bytesPerBlock;
+}
+
+
+ComPtr<ID2D1Bitmap1> StagingBitmapCache::TryTake(Key const& key)
+{
+    Lock lock(m_mutex);
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (it->BucketKey == key)
+        {
+            auto bitmap = std::move(it->Bitmap);
+            m_currentSizeInBytes -= it->SizeInBytes;
+            m_entries.erase(it);
+
+            ++m_hitCount;
+            return bitmap;
+        }
+    }
+
+    ++m_missCount;
+    return nullptr;
+}
+
+
+void StagingBitmapCache::Return(Key const& key, ComPtr<ID2D1Bitmap1>&& bitmap)
+{
+    auto sizeInBytes = GetSizeInBytes(key);
+
+    Lock lock(m_mutex);
+
+    m_entries.push_front(Entry{ key, std::move(bitmap), sizeInBytes });
+    m_currentSizeInBytes += sizeInBytes;
+
+    EvictTo(m_maximumSizeInBytes);
+}
+
+
+void StagingBitmapCache::EvictTo(uint64_t maximumSizeInBytes)
+{
+    // Caller must hold m_mutex.
+
+    while (m_currentSizeInBytes > maximumSizeInBytes && !m_entries.empty())
+    {
+        m_currentSizeInBytes -= m_entries.back().SizeInBytes;
+        m_entries.pop_back();
+        ++m_evictionCount;
+    }
+}
@@ -0,0 +1,175 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+using namespace Microsoft::WRL;
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+//
+// Keeps CPU-readable staging bitmaps around between pixel readbacks, so that
+// apps calling GetPixelBytes / GetPixelColors many times per second don't pay
+// for creating a new staging surface each time.
+//
+// Requested sizes are rounded up to a bucket, so reads of slightly different
+// sizes can share a surface.  A staging bitmap that has been acquired is owned
+// exclusively by the caller until it is released back to the cache; released
+// bitmaps are kept in least-recently-used order and evicted once the total size
+// of the idle bitmaps exceeds the budget.
+//
+class StagingBitmapCache : public std::enable_shared_from_this<StagingBitmapCache>
+{
+public:
+    static const uint64_t DefaultMaximumSizeInBytes = 16 * 1024 * 1024;
+
+    // Requested sizes are never rounded down below this.
+    static const uint32_t MinimumBucketSize = 64;
+
+    struct Key
+    {
+        DXGI_FORMAT Format;
+        D2D1_ALPHA_MODE AlphaMode;
+        uint32_t Width;
+        uint32_t Height;
+
+        bool operator==(Key const& other) const
+        {
+            return Format == other.Format
+                && AlphaMode == other.AlphaMode
+                && Width == other.Width
+                && Height == other.Height;
+        }
+    };
+
+    class Lease;
+
+private:
+    struct Entry
+    {
+        Key BucketKey;
+        ComPtr<ID2D1Bitmap1> Bitmap;
+        uint64_t SizeInBytes;
+    };
+
+    std::mutex m_mutex;
+
+    // Most recently used at the front.  The budget keeps this list short, so
+    // a linear search is cheaper than maintaining an index alongside it.
+    std::list<Entry> m_entries;
+
+    uint64_t m_maximumSizeInBytes;
+    uint64_t m_currentSizeInBytes;
+
+    uint64_t m_hitCount;
+    uint64_t m_missCount;
+    uint64_t m_evictionCount;
+
+public:
+    StagingBitmapCache(uint64_t maximumSizeInBytes = DefaultMaximumSizeInBytes);
+
+    StagingBitmapCache(StagingBitmapCache const&) = delete;
+    StagingBitmapCache& operator=(StagingBitmapCache const&) = delete;
+
+    //
+    // Returns a CPU-readable bitmap that is at least as large as the
+    // requested size.  The bitmap is handed back to the cache when the
+    // returned lease is destroyed.  The cache must be owned by a shared_ptr.
+    //
+    Lease Acquire(
+        ID2D1DeviceContext* deviceContext,
+        D2D1_PIXEL_FORMAT const& pixelFormat,
+        D2D1_SIZE_U const& size);
+
+    uint64_t GetMaximumSize();
+    void SetMaximumSize(uint64_t value);
+
+    CanvasStagingBitmapCacheStatistics GetStatistics();
+
+    // Releases all idle staging bitmaps.
+    void Clear();
+
+    static Key GetBucketKey(D2D1_PIXEL_FORMAT const& pixelFormat, D2D1_SIZE_U const& size);
+    static uint32_t GetBucketSize(uint32_t size);
+    static uint64_t GetSizeInBytes(Key const& key);
+
+private:
+    ComPtr<ID2D1Bitmap1> TryTake(Key const& key);
+    void Return(Key const& key, ComPtr<ID2D1Bitmap1>&& bitmap);
+    void EvictTo(uint64_t maximumSizeInBytes);
+};
+
+
+class StagingBitmapCache::Lease
+{
+    std::shared_ptr<StagingBitmapCache> m_owner;
+    Key m_key;
+    ComPtr<ID2D1Bitmap1> m_bitmap;
+
+public:
+    Lease()
+        : m_key{}
+    {
+    }
+
+    Lease(std::shared_ptr<StagingBitmapCache> const& owner, Key const& key, ComPtr<ID2D1Bitmap1>&& bitmap)
+        : m_owner(owner)
+        , m_key(key)
+        , m_bitmap(std::move(bitmap))
+    {
+    }
+
+    Lease(Lease&& other)
+        : m_owner(std::move(other.m_owner))
+        , m_key(other.m_key)
+        , m_bitmap(std::move(other.m_bitmap))
+    {
+    }
+
+    Lease& operator=(Lease&& other)
+    {
+        Return();
+        m_owner = std::move(other.m_owner);
+        m_key = other.m_key;
+        m_bitmap = std::move(other.m_bitmap);
+        return *this;
+    }
+
+    Lease(Lease const&) = delete;
+    Lease& operator=(Lease const&) = delete;
+
+    ~Lease()
+    {
+        Return();
+    }
+
+    ID2D1Bitmap1* Get() const
+    {
+        return m_bitmap.Get();
+    }
+
+    ID2D1Bitmap1* operator->() const
+    {
+        return m_bitmap.Get();
+    }
+
+    // Drops the bitmap rather than returning it to the cache, eg. because it
+    // was left in an unknown state.
+    void Discard()
+    {
+        m_owner.reset();
+        m_bitmap.Reset();
+    }
+
+private:
+    void Return()
+    {
+        if (m_owner && m_bitmap)
+            m_owner->Return(m_key, std::move(m_bitmap));
+
+        m_owner.reset();
+        m_bitmap.Reset();
+    }
+};
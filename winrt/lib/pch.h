@@ -18,6 +18,7 @@
 
 // Standard C++
 #include <algorithm>
+#include <array>
 #include <assert.h>
 #include <atomic>
 #include <condition_variable>
@@ -25,6 +26,7 @@
 #include <functional>
 #include <future>
 #include <iterator>
+#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -115,6 +117,7 @@
 #pragma warning(disable:4459)   // declaration hides global declaration
 #include <win2d.etw.h>
 #pragma warning(pop)
+#include "utils/Tracing.h"
 
 // Pick up the inbox or local WinRT DirectX types as appropriate
 #include "UapApis.h"
@@ -130,16 +133,21 @@
 #include "images/CanvasImage.h"
 #include "images/CanvasBitmap.h"
 #include "images/CanvasRenderTarget.h"
+#include "effects/EffectPropertyStore.h"
 #include "effects/CanvasEffect.h"
 #include "brushes/CanvasBrush.h"
 #include "brushes/CanvasImageBrush.h"
+#include "brushes/GradientStopCollectionCache.h"
 #include "drawing/CanvasDevice.h"
 #include "drawing/CanvasGradientMesh.h"
+#include "drawing/DirtyRegion.h"
 #include "drawing/CanvasDrawingSession.h"
 #include "drawing/CanvasStrokeStyle.h"
 #include "drawing/CanvasSwapChain.h"
 #include "geometry/CanvasGeometry.h"
+#include "geometry/GeometryRealizationCache.h"
 #include "text/CanvasTextFormat.h"
+#include "text/TextLayoutCache.h"
 #include "xaml/RecreatableDeviceManager.h"
 #include "xaml/CanvasAnimatedControl.h"
 #include "xaml/CanvasImageSource.h"
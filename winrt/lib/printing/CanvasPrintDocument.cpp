@@ -181,6 +181,31 @@ IFACEMETHODIMP CanvasPrintDocument::SetIntermediatePageCount(uint32_t count)
 }
 
 
+IFACEMETHODIMP CanvasPrintDocument::get_MaximumConcurrentPages(uint32_t* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = m_scheduler.GetMaximumConcurrentTasks();
+        });
+}
+
+
+IFACEMETHODIMP CanvasPrintDocument::put_MaximumConcurrentPages(uint32_t value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            if (value < 1)
+                ThrowHR(E_INVALIDARG);
+
+            m_scheduler.SetMaximumConcurrentTasks(value);
+        });
+}
+
+
 HRESULT CanvasPrintDocument::SetJobPageCount(PageCountType type, uint32_t count)
 {
     return ExceptionBoundary(
@@ -285,7 +310,7 @@ IFACEMETHODIMP CanvasPrintDocument::MakePage(uint32_t pageNumber, float width, f
     return ExceptionBoundary(
         [&]
         {
-            RunOnUIThread([=] (CanvasPrintDocument* doc, DeferrableTask* task) { doc->MakePageImpl(task, pageNumber, width, height); });
+            RunPageOnUIThread(pageNumber, [=] (CanvasPrintDocument* doc, DeferrableTask* task) { doc->MakePageImpl(task, pageNumber, width, height); });
         });
 }
 
@@ -444,7 +469,7 @@ void CanvasPrintDocument::MakeDocumentImpl(
     //
     // Raise the Print event
     //
-    auto args = Make<CanvasPrintEventArgs>(task, m_device.EnsureNotClosed(), target, printTaskOptions, dpi);
+    auto args = Make<CanvasPrintEventArgs>(task, m_device.EnsureNotClosed(), target, printTaskOptions, dpi, m_scheduler.GetMaximumConcurrentTasks());
     CheckMakeResult(args);
 
     task->SetCompletionFn(
@@ -495,11 +520,11 @@ std::shared_ptr<CanvasPrintDocument::EventSources> CanvasPrintDocument::GetEvent
 }
 
 
-void CanvasPrintDocument::RunOnUIThread(std::function<void(CanvasPrintDocument*, DeferrableTask*)>&& fn)
+std::unique_ptr<DeferrableTask> CanvasPrintDocument::CreateUIThreadTask(UIThreadFn&& fn)
 {
     auto weakSelf = AsWeak(this);
 
-    auto task = m_scheduler.CreateTask(
+    return m_scheduler.CreateTask(
         [weakSelf, fn](DeferrableTask* task) mutable
         {
             auto strongSelf = LockWeakRef<ICanvasPrintDocument>(weakSelf);
@@ -508,6 +533,14 @@ void CanvasPrintDocument::RunOnUIThread(std::function<void(CanvasPrintDocument*,
             if (self)
                 fn(self, task);
         });
+}
+
+
+void CanvasPrintDocument::RunOnUIThread(UIThreadFn&& fn)
+{
+    ThrowIfBackgroundPageFailed();
+
+    auto task = CreateUIThreadTask(std::move(fn));
 
     auto future = task->GetFuture();
     m_scheduler.Schedule(std::move(task));
@@ -517,7 +550,65 @@ void CanvasPrintDocument::RunOnUIThread(std::function<void(CanvasPrintDocument*,
         // If the task failed then the exception will be stashed in the future.
         // Calling get() will cause it to rethrow the exception.
         future.get();
+
+        // The task didn't start until every earlier page had completed, so
+        // this picks up a failure from the last of them.
+        ThrowIfBackgroundPageFailed();
     }
 }
 
+
+void CanvasPrintDocument::RunPageOnUIThread(uint32_t pageNumber, UIThreadFn&& fn)
+{
+    ThrowIfBackgroundPageFailed();
+
+    auto task = CreateUIThreadTask(std::move(fn));
+
+    auto future = task->GetFuture();
+
+    //
+    // The print preview asks for the page it is about to show, so the pages
+    // nearest the one most recently asked for are the ones most likely to be
+    // visible, and are drawn first.
+    //
+    m_scheduler.SetFocus(pageNumber);
+    m_scheduler.ScheduleConcurrent(std::move(task), pageNumber);
+
+    //
+    // Waiting for the page to be drawn would stop the print system asking for
+    // the next one, so pages could never be drawn at the same time.  When
+    // that's allowed we let the page complete in the background, and keep
+    // its future so that a failure is still reported.
+    //
+    if (m_scheduler.GetMaximumConcurrentTasks() > 1)
+    {
+        Lock lock(m_mutex);
+        m_backgroundPages.push_back(std::move(future));
+    }
+    else if (m_waitForUIThread)
+    {
+        future.get();
+    }
+}
+
+
+void CanvasPrintDocument::ThrowIfBackgroundPageFailed()
+{
+    std::vector<std::future<void>> completedPages;
+
+    {
+        Lock lock(m_mutex);
+
+        auto firstCompleted = std::partition(m_backgroundPages.begin(), m_backgroundPages.end(),
+            [] (std::future<void> const& page) { return page.wait_for(std::chrono::seconds(0)) != std::future_status::ready; });
+
+        std::move(firstCompleted, m_backgroundPages.end(), std::back_inserter(completedPages));
+        m_backgroundPages.erase(firstCompleted, m_backgroundPages.end());
+    }
+
+    // get() rethrows the exception from a page that failed.
+    for (auto& page : completedPages)
+        page.get();
+}
+
 #endif
@@ -46,7 +46,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     {
         InspectableClass(RuntimeClass_Microsoft_Graphics_Canvas_Printing_CanvasPrintDocument, BaseTrust);
 
-        // These members are only modified on construction
+        // These members are only modified on construction.  (The scheduler
+        // is threadsafe.)
         DeferrableTaskScheduler m_scheduler;
         float const m_displayDpi;
         bool const m_waitForUIThread;
@@ -57,6 +58,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ClosablePtr<ICanvasDevice> m_device;
         ComPtr<IPrintPreviewDxgiPackageTarget> m_previewTarget;
 
+        // Pages that MakePage didn't wait for, because MaximumConcurrentPages
+        // is more than one.  A failure is reported by the next call that
+        // schedules work on the UI thread.
+        std::vector<std::future<void>> m_backgroundPages;
+
         // Event sources are stored in a shared_ptr so we can destroy them when
         // Close() is called.  Although the event sources are threadsafe, we
         // hold the mutex when accessing m_eventSources.
@@ -91,6 +97,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         IFACEMETHODIMP InvalidatePreview() override;
         IFACEMETHODIMP SetPageCount(uint32_t) override;
         IFACEMETHODIMP SetIntermediatePageCount(uint32_t) override;
+        IFACEMETHODIMP get_MaximumConcurrentPages(uint32_t*) override;
+        IFACEMETHODIMP put_MaximumConcurrentPages(uint32_t) override;
       
         //
         // IClosable
@@ -126,7 +134,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         HRESULT SetJobPageCount(PageCountType type, uint32_t count);
 
-        void RunOnUIThread(std::function<void(CanvasPrintDocument*, DeferrableTask*)>&& fn);
+        typedef std::function<void(CanvasPrintDocument*, DeferrableTask*)> UIThreadFn;
+
+        std::unique_ptr<DeferrableTask> CreateUIThreadTask(UIThreadFn&& fn);
+        void RunOnUIThread(UIThreadFn&& fn);
+        void RunPageOnUIThread(uint32_t pageNumber, UIThreadFn&& fn);
+        void ThrowIfBackgroundPageFailed();
 
         void PaginateImpl(
             DeferrableTask* task,
@@ -15,14 +15,17 @@ CanvasPrintEventArgs::CanvasPrintEventArgs(
     ComPtr<ICanvasDevice> const& device,
     ComPtr<IPrintDocumentPackageTarget> const& target,
     ComPtr<IPrintTaskOptionsCore> const& printTaskOptions,
-    float initialDpi)
+    float initialDpi,
+    uint32_t maximumConcurrentPages)
     : m_task(task)
     , m_device(device)
     , m_printTaskOptions(printTaskOptions)
     , m_dpi(initialDpi)
     , m_target(target)
-    , m_currentPage(0)
+    , m_maximumPendingPages(maximumConcurrentPages)
+    , m_lastCreatedPage(0)
 {
+    assert(m_maximumPendingPages >= 1);
 }
 
 
@@ -117,18 +120,20 @@ void CanvasPrintEventArgs::EndPrinting()
 class CanvasPrintEventArgs::DrawingSessionAdapter : public SimpleCanvasDrawingSessionAdapter
 {
     ComPtr<CanvasPrintEventArgs> m_args;
+    int m_pageNumber;
                 
 public:
-    DrawingSessionAdapter(ID2D1DeviceContext1* d2dDeviceContext, CanvasPrintEventArgs* args)
+    DrawingSessionAdapter(ID2D1DeviceContext1* d2dDeviceContext, CanvasPrintEventArgs* args, int pageNumber)
         : SimpleCanvasDrawingSessionAdapter(d2dDeviceContext)
         , m_args(args)
+        , m_pageNumber(pageNumber)
     {
     }
 
     virtual void EndDraw(ID2D1DeviceContext1* deviceContext) override
     {
         __super::EndDraw(deviceContext);
-        m_args->DrawingSessionClosed();
+        m_args->DrawingSessionClosed(m_pageNumber);
     }
 };
 
@@ -154,7 +159,10 @@ ComPtr<ICanvasDrawingSession> CanvasPrintEventArgs::CreateDrawingSessionImpl()
     // list and create our own drawing session on top of it.
     //
 
-    if (m_currentCommandList)
+    // Pages that have been closed but are waiting for an earlier one count
+    // against the limit, so that a slow page can't leave an unbounded number
+    // of finished ones queued up behind it.
+    if (m_pendingPages.size() >= m_maximumPendingPages)
         ThrowHR(E_FAIL, Strings::CannotCreateDrawingSessionUntilPreviousOneClosed);
 
     auto d2dCommandList = deviceInternal->CreateCommandList();
@@ -162,33 +170,45 @@ ComPtr<ICanvasDrawingSession> CanvasPrintEventArgs::CreateDrawingSessionImpl()
     d2dDeviceContext->SetTarget(d2dCommandList.Get());
     d2dDeviceContext->SetDpi(m_dpi, m_dpi);
 
-    auto adapter = std::make_shared<DrawingSessionAdapter>(d2dDeviceContext.Get(), this);
+    auto pageNumber = m_lastCreatedPage + 1;
+
+    auto adapter = std::make_shared<DrawingSessionAdapter>(d2dDeviceContext.Get(), this, pageNumber);
     auto ds = CanvasDrawingSession::CreateNew(d2dDeviceContext.Get(), adapter, m_device.Get());
 
-    m_currentCommandList = d2dCommandList;
-    m_currentPage++;
+    m_pendingPages[pageNumber] = PendingPage{ d2dCommandList, false };
+    m_lastCreatedPage = pageNumber;
 
     return ds;
 }
 
 
-void CanvasPrintEventArgs::DrawingSessionClosed()
+void CanvasPrintEventArgs::DrawingSessionClosed(int pageNumber)
 {
     Lock lock(m_mutex);
-            
-    assert(m_currentPage > 0);
-    assert(m_currentCommandList);
 
-    ThrowIfFailed(m_currentCommandList->Close());
+    auto closedPage = m_pendingPages.find(pageNumber);
+    assert(closedPage != m_pendingPages.end());
+
+    ThrowIfFailed(closedPage->second.CommandList->Close());
+    closedPage->second.IsClosed = true;
+
+    //
+    // Hand every page that is now complete, and has no incomplete page before
+    // it, over to the print control.
+    //
+    while (!m_pendingPages.empty() && m_pendingPages.begin()->second.IsClosed)
+    {
+        auto page = m_pendingPages.begin();
             
-    PrintPageDescription desc;
-    ThrowIfFailed(m_printTaskOptions->GetPageDescription(m_currentPage, &desc));
+        PrintPageDescription desc;
+        ThrowIfFailed(m_printTaskOptions->GetPageDescription(page->first, &desc));
 
-    auto pageSize = D2D1_SIZE_F{ desc.PageSize.Width, desc.PageSize.Height };
+        auto pageSize = D2D1_SIZE_F{ desc.PageSize.Width, desc.PageSize.Height };
 
-    ThrowIfFailed(m_printControl->AddPage(m_currentCommandList.Get(), pageSize, nullptr, nullptr, nullptr));
+        ThrowIfFailed(m_printControl->AddPage(page->second.CommandList.Get(), pageSize, nullptr, nullptr, nullptr));
 
-    m_currentCommandList.Reset();
+        m_pendingPages.erase(page);
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
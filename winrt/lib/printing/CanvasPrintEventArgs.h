@@ -31,8 +31,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<IPrintDocumentPackageTarget> m_target;
         ComPtr<ID2D1PrintControl> m_printControl;
 
-        ComPtr<ID2D1CommandList> m_currentCommandList;
-        int m_currentPage;
+        //
+        // Pages that have been created but not yet passed to the print
+        // control, by page number.  Several of these may be drawn at once, but
+        // AddPage() must see them in order, so a page that is closed before an
+        // earlier one waits here until the earlier one has been added.
+        //
+        struct PendingPage
+        {
+            ComPtr<ID2D1CommandList> CommandList;
+            bool IsClosed;
+        };
+
+        std::map<int, PendingPage> m_pendingPages;
+        uint32_t const m_maximumPendingPages;
+        int m_lastCreatedPage;
         
     public:
         CanvasPrintEventArgs(
@@ -40,7 +53,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             ComPtr<ICanvasDevice> const& device,
             ComPtr<IPrintDocumentPackageTarget> const& target,
             ComPtr<IPrintTaskOptionsCore> const& printTaskOptions,
-            float initialDpi);
+            float initialDpi,
+            uint32_t maximumConcurrentPages = 1);
         
         void EndPrinting();
 
@@ -52,7 +66,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
     private:
         ComPtr<ICanvasDrawingSession> CreateDrawingSessionImpl();
-        void DrawingSessionClosed();
+        void DrawingSessionClosed(int pageNumber);
 
         class DrawingSessionAdapter;
     };
@@ -45,7 +45,7 @@ void DeferrableTask::NonDeferredComplete()
 {
     if (!m_deferred)
     {
-        Completed();
+        m_owner->TaskReadyToComplete(this);
     }
 }
 
@@ -7,18 +7,52 @@
 #include "CanvasPrintDeferral.h"
 #include "DeferrableTask.h"
 
+//
+// Runs DeferrableTasks on the UI thread, via the dispatcher.
+//
+// Tasks passed to Schedule() run exclusively: each one waits for every
+// earlier task to complete, and no later task starts until it has completed.
+//
+// Tasks passed to ScheduleConcurrent() may overlap each other.  While a
+// concurrent task is deferred (eg because the app is drawing a page on a
+// worker thread) more of them can be started, as long as no more than
+// MaximumConcurrentTasks are in progress in total.
+// Their completions still run in the order the tasks were started, so
+// anything handed off by a completion function is seen in that order.
+//
+// Pending concurrent tasks are started closest-to-the-focus first, where the
+// focus is a key (eg a page number) set with SetFocus.
+//
 class DeferrableTaskScheduler
     : private LifespanTracker<DeferrableTaskScheduler>
 {
+    struct PendingTask
+    {
+        std::unique_ptr<DeferrableTask> Task;
+        bool IsConcurrent;
+        uint32_t Key;
+    };
+
+    struct RunningTask
+    {
+        std::unique_ptr<DeferrableTask> Task;
+        bool IsReadyToComplete;
+    };
+
     ComPtr<ICoreDispatcher> const m_dispatcher;
 
     std::mutex m_mutex;
     std::unique_ptr<DeferrableTask> m_currentTask;
-    std::queue<std::unique_ptr<DeferrableTask>> m_pending;
+    std::deque<RunningTask> m_concurrentTasks;      // in the order they were started
+    std::deque<PendingTask> m_pending;
+    uint32_t m_maximumConcurrentTasks;
+    uint32_t m_focus;
     
 public:    
     explicit DeferrableTaskScheduler(ComPtr<ICoreDispatcher> const& dispatcher)
         : m_dispatcher(dispatcher)
+        , m_maximumConcurrentTasks(1)
+        , m_focus(0)
     {
     }
 
@@ -31,28 +65,52 @@ public:
     {
         Lock lock(m_mutex);
 
-        if (m_currentTask)
-        {
-            m_pending.push(std::move(task));
-        }
-        else
-        {
-            RunAsync(std::move(task));
-        }
+        m_pending.push_back(PendingTask{ std::move(task), false, 0 });
+        StartPendingTasks(lock);
+    }
+
+    void ScheduleConcurrent(std::unique_ptr<DeferrableTask> task, uint32_t key)
+    {
+        Lock lock(m_mutex);
+
+        m_pending.push_back(PendingTask{ std::move(task), true, key });
+        StartPendingTasks(lock);
+    }
+
+    void SetFocus(uint32_t key)
+    {
+        Lock lock(m_mutex);
+        m_focus = key;
+    }
+
+    uint32_t GetMaximumConcurrentTasks()
+    {
+        Lock lock(m_mutex);
+        return m_maximumConcurrentTasks;
+    }
+
+    void SetMaximumConcurrentTasks(uint32_t value)
+    {
+        assert(value >= 1);
+
+        Lock lock(m_mutex);
+
+        m_maximumConcurrentTasks = value;
+        StartPendingTasks(lock);
     }
 
     void DeferredTaskCompleted(DeferrableTask* task)
     {
-        assert(task == m_currentTask.get());
+        assert(IsRunning(task));
         
         // Deferred completed tasks we dispatch via the dispatcher
         auto handler = Callback<AddFtmBase<IDispatchedHandler>::Type>(
-            [task]() mutable
+            [this, task]() mutable
             {
                 return ExceptionBoundary(
                     [&]
                     {
-                        task->Completed();
+                        TaskReadyToComplete(task);
                     });
             });
         CheckMakeResult(handler);
@@ -61,41 +119,144 @@ public:
         ThrowIfFailed(m_dispatcher->RunAsync(CoreDispatcherPriority_Normal, handler.Get(), &asyncAction));
     }
 
-    void TaskCompleted(DeferrableTask* task)
+    void TaskReadyToComplete(DeferrableTask* task)
     {
-        UNREFERENCED_PARAMETER(task); // task is only referenced in an assert
+        bool isConcurrent;
 
-        Lock lock(m_mutex);
+        {
+            Lock lock(m_mutex);
+
+            isConcurrent = (task != m_currentTask.get());
+
+            if (isConcurrent)
+            {
+                auto it = FindConcurrentTask(task);
+                assert(it != m_concurrentTasks.end());
+
+                it->IsReadyToComplete = true;
+
+                // Concurrent tasks complete in the order they were started.
+                if (it != m_concurrentTasks.begin())
+                    return;
+            }
+        }
+
+        if (isConcurrent)
+            CompleteReadyTasks();
+        else
+            task->Completed();
+    }
 
-        assert(m_currentTask.get() == task);
-        m_currentTask.reset();
+    void TaskCompleted(DeferrableTask* task)
+    {
+        Lock lock(m_mutex);
 
-        if (!m_pending.empty())
+        if (task == m_currentTask.get())
         {
-            // It would be possible to immediately execute the pending task,
-            // rather than go via the dispatcher.  However, this complicates the
-            // code for a minimal (to non-existent) perf gain.
-            RunAsync(std::move(m_pending.front()));
-            m_pending.pop();
+            m_currentTask.reset();
         }
+        else
+        {
+            auto it = FindConcurrentTask(task);
+            assert(it != m_concurrentTasks.end());
+
+            m_concurrentTasks.erase(it);
+        }
+
+        // It would be possible to immediately execute the pending task, rather
+        // than go via the dispatcher.  However, this complicates the code for a
+        // minimal (to non-existent) perf gain.
+        StartPendingTasks(lock);
     }
 
 
 private:
-    void RunAsync(std::unique_ptr<DeferrableTask> task)
+    bool IsRunning(DeferrableTask* task)
+    {
+        Lock lock(m_mutex);
+        return task == m_currentTask.get() || FindConcurrentTask(task) != m_concurrentTasks.end();
+    }
+
+    std::deque<RunningTask>::iterator FindConcurrentTask(DeferrableTask* task)
     {
-        assert(!m_currentTask);
-        m_currentTask = std::move(task);
+        return std::find_if(m_concurrentTasks.begin(), m_concurrentTasks.end(),
+            [=] (RunningTask const& runningTask) { return runningTask.Task.get() == task; });
+    }
 
-        DeferrableTask* t = m_currentTask.get();
-        
+    uint32_t DistanceFromFocus(uint32_t key) const
+    {
+        return (key > m_focus) ? key - m_focus : m_focus - key;
+    }
+
+    void StartPendingTasks(Lock const&)
+    {
+        while (!m_pending.empty() && !m_currentTask)
+        {
+            if (!m_pending.front().IsConcurrent)
+            {
+                if (!m_concurrentTasks.empty())
+                    return;
+
+                m_currentTask = std::move(m_pending.front().Task);
+                m_pending.pop_front();
+
+                RunAsync(m_currentTask.get());
+                return;
+            }
+
+            if (m_concurrentTasks.size() >= m_maximumConcurrentTasks)
+                return;
+
+            // Concurrent tasks can't be reordered past an exclusive task, so
+            // only the ones ahead of the next exclusive task are candidates.
+            auto next = m_pending.begin();
+
+            for (auto it = next + 1; it != m_pending.end() && it->IsConcurrent; ++it)
+            {
+                if (DistanceFromFocus(it->Key) < DistanceFromFocus(next->Key))
+                    next = it;
+            }
+
+            m_concurrentTasks.push_back(RunningTask{ std::move(next->Task), false });
+            m_pending.erase(next);
+
+            RunAsync(m_concurrentTasks.back().Task.get());
+        }
+    }
+
+    void CompleteReadyTasks()
+    {
+        for (;;)
+        {
+            DeferrableTask* task = nullptr;
+
+            {
+                Lock lock(m_mutex);
+
+                if (m_concurrentTasks.empty() || !m_concurrentTasks.front().IsReadyToComplete)
+                    return;
+
+                task = m_concurrentTasks.front().Task.get();
+            }
+
+            // This removes the task from m_concurrentTasks.
+            task->Completed();
+        }
+    }
+
+    void RunAsync(DeferrableTask* t)
+    {
         auto handler = Callback<AddFtmBase<IDispatchedHandler>::Type>(
-            [t]() mutable
+            [this, t]() mutable
             {
                 return ExceptionBoundary(
                     [&]
                     {
                         t->Invoke();
+
+                        // If the task failed it is removed without completing,
+                        // which may leave later tasks ready to complete.
+                        CompleteReadyTasks();
                     });
             });
         CheckMakeResult(handler);
@@ -163,6 +163,108 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         }
     };
 
+    // Passes everything written to it on to a callback, so that it can be consumed
+    // as it is produced rather than accumulated in a growable buffer first.
+    class CallbackStreamWrapper : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IStream>
+        , private LifespanTracker<CallbackStreamWrapper>
+    {
+        StreamWriteCallback m_callback;
+        uint64_t m_position;
+
+    public:
+        CallbackStreamWrapper(StreamWriteCallback callback)
+            : m_callback(std::move(callback))
+            , m_position(0)
+        {}
+
+        // ISequentialStream Interface
+
+        virtual HRESULT STDMETHODCALLTYPE Read(void*, ULONG, ULONG*)
+        {
+            return E_NOTIMPL; // This stream supports write only.
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE Write(void const* source, ULONG numberOfBytes, ULONG* outputNumberOfBytesWritten)
+        {
+            if (!source)
+                return STG_E_INVALIDPOINTER;
+
+            return ExceptionBoundary(
+                [&]
+                {
+                    if (numberOfBytes > 0)
+                        m_callback(static_cast<byte const*>(source), numberOfBytes);
+
+                    m_position += numberOfBytes;
+
+                    if (outputNumberOfBytesWritten)
+                        *outputNumberOfBytesWritten = numberOfBytes;
+                });
+        }
+
+        // IStream Interface  
+
+        virtual HRESULT STDMETHODCALLTYPE SetSize(ULARGE_INTEGER)
+        {
+            return E_NOTIMPL; // This stream is not resizable.
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE CopyTo(IStream*, ULARGE_INTEGER, ULARGE_INTEGER*,
+            ULARGE_INTEGER*)
+        {
+            return E_NOTIMPL; // Copying to other streams is not supported
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE Commit(DWORD)
+        {
+            return S_OK; // Everything is passed to the callback as soon as it is written.
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE Revert(void)
+        {
+            return S_OK; // Nothing is transacted, so this has no effect.
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE LockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD)
+        {
+            return E_NOTIMPL; // Region locking is not supported
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE UnlockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD)
+        {
+            return E_NOTIMPL; // Region locking is not supported
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE Clone(IStream **)
+        {
+            return E_NOTIMPL; // Nothing should be cloning this stream.
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE Seek(LARGE_INTEGER liDistanceToMove, DWORD dwOrigin,
+            ULARGE_INTEGER* newSeekLocation)
+        {
+            // Data can't be rewritten once it has been passed to the callback, so
+            // the only seeks supported are the ones that stay where we are.
+            bool staysAtCurrentPosition =
+                (dwOrigin == STREAM_SEEK_CUR && liDistanceToMove.QuadPart == 0) ||
+                (dwOrigin == STREAM_SEEK_END && liDistanceToMove.QuadPart == 0) ||
+                (dwOrigin == STREAM_SEEK_SET && static_cast<uint64_t>(liDistanceToMove.QuadPart) == m_position);
+
+            if (!staysAtCurrentPosition)
+                return STG_E_INVALIDFUNCTION;
+
+            if (newSeekLocation)
+                newSeekLocation->QuadPart = m_position;
+
+            return S_OK;
+        }
+
+        virtual HRESULT STDMETHODCALLTYPE Stat(STATSTG*, DWORD)
+        {
+            return E_NOTIMPL; // Not supported
+        }
+    };
+
     ComPtr<IStream> WrapSvgStringInStream(HSTRING sourceString)
     {
         uint32_t textLength;
@@ -178,6 +280,151 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         return stream;
     }
 
+    ComPtr<IStream> MakeCallbackStream(StreamWriteCallback callback)
+    {
+        auto stream = Make<CallbackStreamWrapper>(std::move(callback));
+        CheckMakeResult(stream);
+
+        return stream;
+    }
+
+    static bool IsContinuationByte(byte value)
+    {
+        return (value & 0xC0) == 0x80;
+    }
+
+    // The number of bytes in the UTF-8 sequence introduced by a lead byte.  Bytes
+    // that can't start a sequence count as one, and are left for
+    // MultiByteToWideChar to replace.
+    static uint32_t GetSequenceLength(byte leadByte)
+    {
+        if ((leadByte & 0xE0) == 0xC0)
+            return 2;
+        else if ((leadByte & 0xF0) == 0xE0)
+            return 3;
+        else if ((leadByte & 0xF8) == 0xF0)
+            return 4;
+        else
+            return 1;
+    }
+
+    Utf8ToUtf16Converter::Utf8ToUtf16Converter(size_t estimatedLength)
+        : m_capacity(0)
+        , m_length(0)
+        , m_pending{}
+        , m_pendingCount(0)
+        , m_pendingSequenceLength(0)
+    {
+        Reserve(estimatedLength);
+    }
+
+    void Utf8ToUtf16Converter::Append(byte const* data, size_t dataSize)
+    {
+        if (dataSize > INT_MAX)
+            ThrowHR(E_INVALIDARG);
+
+        // Finish off a sequence that was split across the end of the previous chunk.
+        while (m_pendingCount > 0 && dataSize > 0)
+        {
+            if (IsContinuationByte(*data))
+            {
+                m_pending[m_pendingCount++] = *data++;
+                --dataSize;
+            }
+
+            // A sequence cut short by anything other than a continuation byte
+            // is invalid, and is converted as it is so it gets replaced.
+            if (m_pendingCount == m_pendingSequenceLength || (dataSize > 0 && !IsContinuationByte(*data)))
+            {
+                Convert(m_pending, m_pendingCount);
+                m_pendingCount = 0;
+            }
+        }
+
+        if (dataSize == 0)
+            return;
+
+        // Hold back a sequence at the end of this chunk that isn't complete yet.
+        size_t completeSize = dataSize;
+        uint32_t trailingSequenceLength = 0;
+
+        for (size_t i = dataSize; i > 0 && dataSize - i < 3; --i)
+        {
+            auto value = data[i - 1];
+
+            if (IsContinuationByte(value))
+                continue;
+
+            auto sequenceLength = GetSequenceLength(value);
+
+            if (i - 1 + sequenceLength > dataSize)
+            {
+                completeSize = i - 1;
+                trailingSequenceLength = sequenceLength;
+            }
+
+            break;
+        }
+
+        Convert(data, completeSize);
+
+        auto pendingCount = static_cast<uint32_t>(dataSize - completeSize);
+        if (pendingCount > 0)
+        {
+            memcpy(m_pending, data + completeSize, pendingCount);
+            m_pendingCount = pendingCount;
+            m_pendingSequenceLength = trailingSequenceLength;
+        }
+    }
+
+    size_t Utf8ToUtf16Converter::Finish()
+    {
+        if (m_pendingCount > 0)
+        {
+            Convert(m_pending, m_pendingCount);
+            m_pendingCount = 0;
+        }
+
+        return m_length;
+    }
+
+    void Utf8ToUtf16Converter::Convert(byte const* data, size_t dataSize)
+    {
+        if (dataSize == 0)
+            return;
+
+        // Every UTF-8 byte becomes at most one UTF-16 code unit.
+        Reserve(m_length + dataSize);
+
+        int convertedCount = MultiByteToWideChar(
+            CP_UTF8,
+            0, // Default flags
+            reinterpret_cast<char const*>(data),
+            static_cast<int>(dataSize),
+            m_buffer.get() + m_length,
+            static_cast<int>(dataSize));
+
+        if (convertedCount == 0)
+            ThrowHR(E_INVALIDARG);
+
+        m_length += convertedCount;
+    }
+
+    void Utf8ToUtf16Converter::Reserve(size_t length)
+    {
+        if (length <= m_capacity)
+            return;
+
+        auto newCapacity = std::max(length, m_capacity * 2);
+        std::unique_ptr<wchar_t[]> newBuffer(new wchar_t[newCapacity]);
+
+        if (m_length > 0)
+            memcpy(newBuffer.get(), m_buffer.get(), m_length * sizeof(wchar_t));
+
+        m_buffer = std::move(newBuffer);
+        m_capacity = newCapacity;
+    }
+
 }}}}}
 
 #endif
\ No newline at end of file
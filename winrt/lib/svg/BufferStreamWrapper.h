@@ -8,4 +8,49 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 {    
     ComPtr<IStream> WrapSvgStringInStream(HSTRING sourceString);
 
-}}}}}
\ No newline at end of file
+    // Wraps a write-only IStream around a callback, which is passed each chunk
+    // of data as it is written, so nothing is buffered by the stream itself.
+    typedef std::function<void(byte const* data, ULONG dataSize)> StreamWriteCallback;
+
+    ComPtr<IStream> MakeCallbackStream(StreamWriteCallback callback);
+
+    //
+    // Converts UTF-8 text to UTF-16 in a single pass, a chunk at a time, as it
+    // is written by ID2D1SvgDocument::Serialize.  A multi-byte sequence that is
+    // split across two chunks is held back until the rest of it arrives.
+    //
+    // Each UTF-8 byte produces at most one UTF-16 code unit, so the output
+    // buffer never needs more room than the number of bytes appended.  It is
+    // sized up front from an estimate, and only grows if that was too small.
+    //
+    class Utf8ToUtf16Converter
+    {
+        std::unique_ptr<wchar_t[]> m_buffer;
+        size_t m_capacity;
+        size_t m_length;
+
+        byte m_pending[4];
+        uint32_t m_pendingCount;
+        uint32_t m_pendingSequenceLength;
+
+    public:
+        explicit Utf8ToUtf16Converter(size_t estimatedLength);
+
+        Utf8ToUtf16Converter(Utf8ToUtf16Converter const&) = delete;
+        Utf8ToUtf16Converter& operator=(Utf8ToUtf16Converter const&) = delete;
+
+        void Append(byte const* data, size_t dataSize);
+
+        // Converts anything still held back (an incomplete sequence at the
+        // end of the text becomes U+FFFD) and returns the number of UTF-16
+        // code units written.
+        size_t Finish();
+
+        wchar_t const* GetBuffer() const { return m_buffer.get(); }
+
+    private:
+        void Convert(byte const* data, size_t dataSize);
+        void Reserve(size_t length);
+    };
+
+}}}}}
@@ -44,6 +44,7 @@ CanvasSvgDocument::CanvasSvgDocument(
     ID2D1SvgDocument* d2dSvgDocument)
     : ResourceWrapper(d2dSvgDocument)
     , m_canvasDevice(canvasDevice)
+    , m_xmlLengthEstimate(DefaultXmlLengthEstimate)
 {
 }
 
@@ -73,60 +74,37 @@ IFACEMETHODIMP CanvasSvgDocument::GetXml(HSTRING* result)
 
             auto& resource = GetResource();
 
-            ComPtr<IStream> outputStream;
-            ThrowIfFailed(CreateStreamOnHGlobal(nullptr, TRUE, &outputStream));
+            // D2D serializes to UTF-8, a chunk at a time.  Rather than collecting the
+            // whole document and then converting it, each chunk is converted to UTF-16
+            // as it is written, into a buffer sized from the last time this was called.
+            Utf8ToUtf16Converter converter(m_xmlLengthEstimate.load(std::memory_order_relaxed));
+
+            auto outputStream = MakeCallbackStream(
+                [&](byte const* data, ULONG dataSize)
+                {
+                    converter.Append(data, dataSize);
+                });
 
             ThrowIfFailed(resource->Serialize(outputStream.Get()));
-            
-            HGLOBAL globalHandle;
-            ThrowIfFailed(GetHGlobalFromStream(outputStream.Get(), &globalHandle));
 
-            void* lockedBytes = GlobalLock(globalHandle);
-            if (!lockedBytes)
+            auto length = converter.Finish();
+            if (length == 0)
             {
                 ThrowHR(E_INVALIDARG);
             }
 
-            auto unlockBytes = MakeScopeWarden([&] { GlobalUnlock(globalHandle); });
+            m_xmlLengthEstimate.store(length, std::memory_order_relaxed);
 
-            auto lockedBytesLength = GlobalSize(globalHandle);
-            if (lockedBytesLength == 0)
-            {
-                ThrowHR(E_INVALIDARG);
-            }
-            
-            // The string is returned from D2D in a multi-byte UTF-8 format. We need to convert it to a wide
-            // character format to return it through the platform.
-
-            // Note that the string pointed at by lockedBytes is not null terminated. Therefore, we need to 
-            // pass the locked size to the function below.
-            
-            assert(lockedBytesLength <= INT_MAX);
-            int wideCharacterCount = MultiByteToWideChar(
-                CP_UTF8,
-                0, // Default flags
-                reinterpret_cast<char* const>(lockedBytes),
-                static_cast<int32_t>(lockedBytesLength),
-                nullptr,
-                0); // Write nothing, and retrieve size
+            // GetXml has always returned a string whose contents end with a null
+            // character, one longer than the document text. Apps may depend on
+            // that length, so keep it.
+            assert(length < UINT32_MAX);
 
             WinStringBuilder stringBuilder;
-            wideCharacterCount++; // Account for null terminator
-            auto buffer = stringBuilder.Allocate(wideCharacterCount);
-
-            if (MultiByteToWideChar(
-                CP_UTF8,
-                0, // Default flags
-                reinterpret_cast<char* const>(lockedBytes),
-                static_cast<int32_t>(lockedBytesLength),
-                buffer,
-                wideCharacterCount) == 0)
-            {
-                ThrowHR(E_INVALIDARG);
-            }
+            auto buffer = stringBuilder.Allocate(static_cast<uint32_t>(length + 1));
 
-            // MultiByteToWideChar does not null-terminate the string, so we do it ourselves here.
-            buffer[wideCharacterCount - 1] = 0;
+            std::copy(converter.GetBuffer(), converter.GetBuffer() + length, buffer);
+            buffer[length] = 0;
 
             stringBuilder.Get().CopyTo(result);
         });
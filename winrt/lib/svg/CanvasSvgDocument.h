@@ -18,6 +18,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         ClosablePtr<ICanvasDevice> m_canvasDevice;
 
+        // How many characters GetXml converted last time, used to size the
+        // buffer for the next call. Atomic because GetXml may be called
+        // from several threads at once.
+        static const size_t DefaultXmlLengthEstimate = 4096;
+        std::atomic<size_t> m_xmlLengthEstimate;
+
     public:
         
         static ComPtr<CanvasSvgDocument> CreateNew(ICanvasResourceCreator* resourceCreator, IStream* stream);
@@ -428,6 +428,7 @@ CanvasTextAnalyzer::CanvasTextAnalyzer(
     , m_defaultVerticalGlyphOrientation(CanvasVerticalGlyphOrientation::Default)
     , m_defaultBidiLevel(0)
     , m_customFontManager(CustomFontManager::GetInstance())
+    , m_shapingCache(ShapingCache::GetInstance())
 {
     CreateTextAnalysisSourceAndSink();
 }
@@ -444,6 +445,7 @@ CanvasTextAnalyzer::CanvasTextAnalyzer(
     , m_defaultNumberSubstitution(numberSubstitution)
     , m_defaultVerticalGlyphOrientation(verticalGlyphOrientation)
     , m_customFontManager(CustomFontManager::GetInstance())
+    , m_shapingCache(ShapingCache::GetInstance())
 {
     if (bidiLevel > UINT8_MAX)
         ThrowHR(E_INVALIDARG);
@@ -856,9 +858,10 @@ static void GetDWriteTypographyRanges(
     *typographyRangeCountResult = typographyRangeCount;
 }
 
+template<typename FN>
 static void RetryWithIncreasingGlyphCount(
     uint32_t textLength, 
-    std::function<HRESULT(uint32_t)> fn)
+    FN&& fn)
 {
     //
     // A text span can map to a (theoretically) unbounded number of glyphs, and there
@@ -895,6 +898,68 @@ static void RetryWithIncreasingGlyphCount(
     ThrowIfFailed(result);
 }
 
+
+//
+// GetGlyphs needs half a dozen buffers sized to the text and glyph counts.
+// Apps shaping many short runs would spend a good part of each call
+// allocating them, so each thread keeps a set to reuse.
+//
+struct ShapingScratch
+{
+    ShapedGlyphRun Run;
+    bool InUse;
+};
+
+static thread_local ShapingScratch t_shapingScratch;
+
+
+// Lends out this thread's scratch run for the duration of a GetGlyphs call.
+class ScratchGlyphRun
+{
+    // Buffers grown past this by an unusually long run are released afterwards
+    // rather than held on to by the thread.
+    static const size_t MaximumRetainedLength = 4096;
+
+    ShapedGlyphRun m_localRun;
+    ShapedGlyphRun* m_run;
+
+public:
+    ScratchGlyphRun()
+    {
+        // Shaping never calls back into app code, so this is only a
+        // safeguard against the scratch run being handed out twice.
+        if (t_shapingScratch.InUse)
+        {
+            m_run = &m_localRun;
+        }
+        else
+        {
+            t_shapingScratch.InUse = true;
+            m_run = &t_shapingScratch.Run;
+        }
+    }
+
+    ~ScratchGlyphRun()
+    {
+        if (m_run != &t_shapingScratch.Run)
+            return;
+
+        if (m_run->ClusterMap.capacity() > MaximumRetainedLength ||
+            m_run->GlyphIndices.capacity() > MaximumRetainedLength)
+        {
+            *m_run = ShapedGlyphRun();
+        }
+
+        t_shapingScratch.InUse = false;
+    }
+
+    ScratchGlyphRun(ScratchGlyphRun const&) = delete;
+    ScratchGlyphRun& operator=(ScratchGlyphRun const&) = delete;
+
+    ShapedGlyphRun& Get() { return *m_run; }
+};
+
+
 static void ThrowIfInvalidCharacterRange(uint32_t textLength, CanvasCharacterRange characterRange)
 {
     if (textLength > 0 && characterRange.CharacterIndex >= static_cast<int>(textLength))
@@ -904,6 +969,67 @@ static void ThrowIfInvalidCharacterRange(uint32_t textLength, CanvasCharacterRan
         ThrowHR(E_INVALIDARG);
 }
 
+static void ShapeGlyphs(
+    IDWriteTextAnalyzer2* textAnalyzer,
+    ShapingParameters const& parameters,
+    ShapedGlyphRun* run)
+{
+    // resize() keeps the existing capacity, so a reused run only allocates
+    // when this run is longer than any before it.
+    run->ClusterMap.resize(parameters.TextLength);
+    run->TextProperties.resize(parameters.TextLength);
+
+    RetryWithIncreasingGlyphCount(
+        parameters.TextLength,
+        [&](uint32_t maxGlyphCount)
+        {
+            run->GlyphIndices.resize(maxGlyphCount);
+            run->GlyphProperties.resize(maxGlyphCount);
+
+            return textAnalyzer->GetGlyphs(
+                parameters.Text,
+                parameters.TextLength,
+                parameters.FontFace,
+                parameters.IsSideways,
+                parameters.IsRightToLeft,
+                &parameters.Script,
+                parameters.Locale,
+                parameters.NumberSubstitution,
+                parameters.Features,
+                parameters.FeatureRangeLengths,
+                parameters.FeatureRangeCount,
+                maxGlyphCount,
+                run->ClusterMap.data(),
+                run->TextProperties.data(),
+                run->GlyphIndices.data(),
+                run->GlyphProperties.data(),
+                &run->GlyphCount);
+        });
+
+    run->GlyphAdvances.resize(run->GlyphCount);
+    run->GlyphOffsets.resize(run->GlyphCount);
+
+    ThrowIfFailed(textAnalyzer->GetGlyphPlacements(
+        parameters.Text,
+        run->ClusterMap.data(),
+        run->TextProperties.data(),
+        parameters.TextLength,
+        run->GlyphIndices.data(),
+        run->GlyphProperties.data(),
+        run->GlyphCount,
+        parameters.FontFace,
+        parameters.FontSize,
+        parameters.IsSideways,
+        parameters.IsRightToLeft,
+        &parameters.Script,
+        parameters.Locale,
+        parameters.Features,
+        parameters.FeatureRangeLengths,
+        parameters.FeatureRangeCount,
+        run->GlyphAdvances.data(),
+        run->GlyphOffsets.data()));
+}
+
 IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
     CanvasCharacterRange characterRange,
     ICanvasFontFace* fontFace,
@@ -942,14 +1068,6 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
             text += characterRange.CharacterIndex;
             textLength = characterRange.CharacterCount;
 
-            auto dwriteScriptAnalysis = ToDWriteScriptAnalysis(script);
-
-            std::vector<uint16_t> clusterMap;
-            clusterMap.resize(textLength);
-
-            std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> shapingTextProperties;
-            shapingTextProperties.resize(textLength);
-
             auto dwriteFontFace = As<ICanvasFontFaceInternal>(fontFace)->GetRealizedFontFace();
             
             ComPtr<IDWriteNumberSubstitution> dwriteNumberSubstitution;
@@ -963,80 +1081,57 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
                 GetDWriteTypographyRanges(characterRange, typographyRanges, &typographyRangeCount, &dwriteTypographyRangeData);
             }
 
-            std::vector<DWRITE_TYPOGRAPHIC_FEATURES> featuresPerSpan;
-
-            std::vector<uint16_t> glyphIndices;
-
-            std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> shapingGlyphProperties;
-
-            uint32_t actualGlyphCount{};    
-            RetryWithIncreasingGlyphCount(
-                textLength,
-                [&](uint32_t maxGlyphCount)
-                {
-                    glyphIndices.resize(maxGlyphCount);
-
-                    shapingGlyphProperties.resize(maxGlyphCount);
+            ShapingParameters parameters{};
+            parameters.Text = text;
+            parameters.TextLength = textLength;
+            parameters.FontFace = dwriteFontFace.Get();
+            parameters.FontSize = fontSize;
+            parameters.IsSideways = !!isSideways;
+            parameters.IsRightToLeft = !!isRightToLeft;
+            parameters.Script = ToDWriteScriptAnalysis(script);
+            parameters.Locale = WindowsGetStringRawBuffer(locale, nullptr);
+            parameters.NumberSubstitution = dwriteNumberSubstitution.Get();
+            parameters.Features = typographyRanges ? dwriteTypographyRangeData.FeatureDataPointers.data() : nullptr;
+            parameters.FeatureRangeLengths = typographyRanges ? dwriteTypographyRangeData.FeatureRangeLengths.data() : nullptr;
+            parameters.FeatureRangeCount = typographyRangeCount;
+
+            std::shared_ptr<ShapedGlyphRun const> cachedRun;
+            uint64_t hash = 0;
+
+            bool useCache = m_shapingCache->IsEnabled();
+
+            if (useCache)
+            {
+                hash = ShapingCache::GetHash(parameters);
+                cachedRun = m_shapingCache->TryGet(hash, parameters);
+            }
 
-                    return m_customFontManager->GetTextAnalyzer()->GetGlyphs(
-                        text,
-                        textLength,
-                        dwriteFontFace.Get(),
-                        isSideways,
-                        isRightToLeft,
-                        &dwriteScriptAnalysis,
-                        WindowsGetStringRawBuffer(locale, nullptr),
-                        dwriteNumberSubstitution.Get(),
-                        typographyRanges ? dwriteTypographyRangeData.FeatureDataPointers.data() : nullptr,
-                        typographyRanges ? dwriteTypographyRangeData.FeatureRangeLengths.data() : nullptr,
-                        typographyRangeCount,
-                        maxGlyphCount,
-                        clusterMap.data(),
-                        shapingTextProperties.data(),
-                        glyphIndices.data(),
-                        shapingGlyphProperties.data(),
-                        &actualGlyphCount);
-                });
+            ScratchGlyphRun scratch;
 
-            std::vector<float> glyphAdvances;
-            glyphAdvances.resize(actualGlyphCount);
+            if (!cachedRun)
+            {
+                ShapeGlyphs(m_customFontManager->GetTextAnalyzer().Get(), parameters, &scratch.Get());
 
-            std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
-            glyphOffsets.resize(actualGlyphCount);
+                if (useCache)
+                    m_shapingCache->Add(hash, parameters, scratch.Get());
+            }
 
-            ThrowIfFailed(m_customFontManager->GetTextAnalyzer()->GetGlyphPlacements(
-                text,
-                clusterMap.data(),
-                shapingTextProperties.data(),
-                textLength,
-                glyphIndices.data(),
-                shapingGlyphProperties.data(),
-                actualGlyphCount,
-                dwriteFontFace.Get(),
-                fontSize,
-                isSideways,
-                isRightToLeft,
-                &dwriteScriptAnalysis,
-                WindowsGetStringRawBuffer(locale, nullptr),
-                typographyRanges ? dwriteTypographyRangeData.FeatureDataPointers.data() : nullptr,
-                typographyRanges ? dwriteTypographyRangeData.FeatureRangeLengths.data() : nullptr,
-                typographyRangeCount,
-                glyphAdvances.data(),
-                glyphOffsets.data()));
+            auto& run = cachedRun ? *cachedRun : scratch.Get();
+            auto actualGlyphCount = run.GlyphCount;
 
             ComArray<CanvasGlyph> glyphs(actualGlyphCount);
             for (uint32_t i = 0; i < actualGlyphCount; ++i)
             {
-                glyphs[i].Index = glyphIndices[i];
-                glyphs[i].Advance = glyphAdvances[i];
-                glyphs[i].AdvanceOffset = glyphOffsets[i].advanceOffset;
-                glyphs[i].AscenderOffset = glyphOffsets[i].ascenderOffset;
+                glyphs[i].Index = run.GlyphIndices[i];
+                glyphs[i].Advance = run.GlyphAdvances[i];
+                glyphs[i].AdvanceOffset = run.GlyphOffsets[i].advanceOffset;
+                glyphs[i].AscenderOffset = run.GlyphOffsets[i].ascenderOffset;
             }
             glyphs.Detach(valueCount, valueElements);
 
             if (clusterMapIndexElements)
             {
-                auto clusterMapResult = TransformToComArray<int>(clusterMap.begin(), clusterMap.end(), 
+                auto clusterMapResult = TransformToComArray<int>(run.ClusterMap.begin(), run.ClusterMap.end(), 
                     [](uint16_t value)
                     {
                         return static_cast<int>(value);
@@ -1046,7 +1141,7 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
 
             if (isShapedAloneElements)
             {
-                auto isShapedAloneResult = TransformToComArray<boolean>(shapingTextProperties.begin(), shapingTextProperties.end(),
+                auto isShapedAloneResult = TransformToComArray<boolean>(run.TextProperties.begin(), run.TextProperties.end(),
                     [](DWRITE_SHAPING_TEXT_PROPERTIES const& value)
                     {
                         return !!value.isShapedAlone;
@@ -1056,7 +1151,7 @@ IFACEMETHODIMP CanvasTextAnalyzer::GetGlyphsWithAllOptions(
 
             if (glyphShapingElements)
             {
-                auto glyphShaping = TransformToComArray<CanvasGlyphShaping>(shapingGlyphProperties.begin(), shapingGlyphProperties.begin() + actualGlyphCount,
+                auto glyphShaping = TransformToComArray<CanvasGlyphShaping>(run.GlyphProperties.begin(), run.GlyphProperties.begin() + actualGlyphCount,
                     [](DWRITE_SHAPING_GLYPH_PROPERTIES const& dwriteValue)
                     {
                         CanvasGlyphShaping result{};
@@ -1384,6 +1479,12 @@ IFACEMETHODIMP CanvasTextAnalyzer::AddGlyphsAfterJustificationWithClusterMap(
         });
 }
 
+CanvasTextAnalyzerFactory::CanvasTextAnalyzerFactory()
+    : m_shapingCache(ShapingCache::GetInstance())
+{
+}
+
+
 HRESULT CanvasTextAnalyzerFactory::Create(
     HSTRING text,
     CanvasTextDirection textDirection,
@@ -1427,4 +1528,70 @@ HRESULT CanvasTextAnalyzerFactory::CreateWithOptions(
 }
 
 
+IFACEMETHODIMP CanvasTextAnalyzerFactory::get_MaximumShapingCacheEntryCount(UINT32* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = m_shapingCache->GetMaximumEntryCount();
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::put_MaximumShapingCacheEntryCount(UINT32 value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            m_shapingCache->SetMaximumEntryCount(value);
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::get_MaximumShapingCacheSize(UINT64* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = m_shapingCache->GetMaximumSize();
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::put_MaximumShapingCacheSize(UINT64 value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            m_shapingCache->SetMaximumSize(value);
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::get_ShapingCacheStatistics(CanvasShapingCacheStatistics* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = m_shapingCache->GetStatistics();
+        });
+}
+
+
+IFACEMETHODIMP CanvasTextAnalyzerFactory::ClearShapingCache()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            m_shapingCache->Clear();
+        });
+}
+
+
 ActivatableClassWithFactory(CanvasTextAnalyzer, CanvasTextAnalyzerFactory);
\ No newline at end of file
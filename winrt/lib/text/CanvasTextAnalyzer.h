@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "ShapingCache.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
 {
     class DWriteTextAnalysisSource : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IDWriteTextAnalysisSource1>,
@@ -146,6 +148,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         uint32_t m_defaultBidiLevel;
 
         std::shared_ptr<CustomFontManager> m_customFontManager;
+        std::shared_ptr<ShapingCache> m_shapingCache;
 
         ComPtr<DWriteTextAnalysisSource> m_dwriteTextAnalysisSource;
         ComPtr<DWriteTextAnalysisSink> m_dwriteTextAnalysisSink;
@@ -302,13 +305,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
     //
 
     class CanvasTextAnalyzerFactory
-        : public AgileActivationFactory<ICanvasTextAnalyzerFactory>
+        : public AgileActivationFactory<ICanvasTextAnalyzerFactory, ICanvasTextAnalyzerStatics>
         , private LifespanTracker<CanvasTextAnalyzerFactory>
     {
         InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_Text_CanvasTextAnalyzer, BaseTrust);
 
+        // Keeps the cache, and the limits set on it, alive while no text
+        // analyzers exist.
+        std::shared_ptr<ShapingCache> m_shapingCache;
+
     public:
+        CanvasTextAnalyzerFactory();
 
+        //
+        // ICanvasTextAnalyzerFactory
+        //
         IFACEMETHOD(Create)(
             HSTRING text,
             CanvasTextDirection textDirection,
@@ -327,6 +338,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             CanvasTextDirection textDirection,
             ICanvasTextAnalyzerOptions* source,
             ICanvasTextAnalyzer** textAnalyzer);
+
+        //
+        // ICanvasTextAnalyzerStatics
+        //
+        IFACEMETHOD(get_MaximumShapingCacheEntryCount)(UINT32* value);
+        IFACEMETHOD(put_MaximumShapingCacheEntryCount)(UINT32 value);
+
+        IFACEMETHOD(get_MaximumShapingCacheSize)(UINT64* value);
+        IFACEMETHOD(put_MaximumShapingCacheSize)(UINT64 value);
+
+        IFACEMETHOD(get_ShapingCacheStatistics)(CanvasShapingCacheStatistics* value);
+
+        IFACEMETHOD(ClearShapingCache)();
     };
     
 }}}}}
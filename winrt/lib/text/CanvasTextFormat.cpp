@@ -95,6 +95,8 @@ IFACEMETHODIMP CanvasTextFormatFactory::ActivateInstance(IInspectable** object)
 // CanvasTextFormat implementation
 //
 
+std::atomic<uint32_t> CanvasTextFormat::s_createdTextFormatCount;
+
 
 CanvasTextFormat::CanvasTextFormat()
     : ResourceWrapper(nullptr)
@@ -136,6 +138,11 @@ CanvasTextFormat::CanvasTextFormat(IDWriteTextFormat1* format)
 
 IFACEMETHODIMP CanvasTextFormat::Close()
 {
+    {
+        auto lock = GetLock();
+        m_noWrapTextFormat.Reset();
+    }
+
     m_closed = true;
     return ResourceWrapper::Close();
 }
@@ -211,6 +218,8 @@ ComPtr<IDWriteTextFormat1> CanvasTextFormat::CreateRealizedTextFormat(bool skipW
         static_cast<const wchar_t*>(m_localeName),
         &textFormatBase));
 
+    ++s_createdTextFormatCount;
+
     auto textFormat = As<IDWriteTextFormat1>(textFormatBase);
 
     RealizeDirection(textFormat.Get());
@@ -247,11 +256,26 @@ ComPtr<IDWriteTextFormat> CanvasTextFormat::GetRealizedTextFormatClone(CanvasWor
     // thread to interfere with a DrawText on another thread using the same text
     // format.
     //
+    // The NoWrap clone is reused until the format changes.  DrawText never
+    // modifies the format it is given, so threads can safely share it.
+    //
 
     ThrowIfInvalid<CanvasWordWrapping>(overrideWordWrapping);
 
     auto lock = GetLock();
 
+    bool isNoWrap = (overrideWordWrapping == CanvasWordWrapping::NoWrap);
+
+    if (isNoWrap && m_noWrapTextFormat)
+    {
+        auto& realizedFormat = MaybeGetResource();
+
+        if (!realizedFormat || HasSameMutableProperties(realizedFormat.Get(), m_noWrapTextFormat.Get()))
+            return m_noWrapTextFormat;
+
+        m_noWrapTextFormat.Reset();
+    }
+
     if (HasResource())
     {
         SetShadowPropertiesFromDWrite();
@@ -261,10 +285,38 @@ ComPtr<IDWriteTextFormat> CanvasTextFormat::GetRealizedTextFormatClone(CanvasWor
 
     ThrowIfFailed(newFormat->SetWordWrapping(ToWordWrapping(overrideWordWrapping)));
 
+    if (isNoWrap)
+        m_noWrapTextFormat = newFormat;
+
     return newFormat;
 }
 
 
+//
+// Checks whether the properties that can be changed on an existing
+// IDWriteTextFormat match between two formats.  The others (font family,
+// collection, size, weight, style, stretch and locale) are fixed when the
+// format is created, so only change when we recreate it ourselves.  Word
+// wrapping is deliberately not compared.
+//
+// The trimming signs are only compared for presence, since each format gets
+// its own ellipsis trimming sign object.
+//
+/* static */
+bool CanvasTextFormat::HasSameMutableProperties(IDWriteTextFormat1* format1, IDWriteTextFormat1* format2)
+{
+    DWriteMutableFormatProperties properties1(format1);
+    DWriteMutableFormatProperties properties2(format2);
+
+    properties2.WordWrapping = properties1.WordWrapping;
+
+    if (properties1.Trimming.Sign && properties2.Trimming.Sign)
+        properties2.Trimming.Sign = properties1.Trimming.Sign;
+
+    return properties1 == properties2;
+}
+
+
 D2D1_DRAW_TEXT_OPTIONS CanvasTextFormat::GetDrawTextOptions()
 {
     return static_cast<D2D1_DRAW_TEXT_OPTIONS>(m_drawTextOptions);
@@ -273,6 +325,8 @@ D2D1_DRAW_TEXT_OPTIONS CanvasTextFormat::GetDrawTextOptions()
 
 void CanvasTextFormat::Unrealize()
 {
+    m_noWrapTextFormat.Reset();
+
     //
     // We're about to throw away our resource, so we need to extract all the
     // values stored on it into our shadow copies.
@@ -476,6 +530,9 @@ HRESULT __declspec(nothrow) CanvasTextFormat::PropertyPut(T value, TT* dest, FNV
             // Set the shadow value
             SetFrom(dest, value);
 
+            // Any cached clone no longer matches
+            m_noWrapTextFormat.Reset();
+
             // Realize the value on the dwrite object, if we can
             auto& textFormat = MaybeGetResource();
 
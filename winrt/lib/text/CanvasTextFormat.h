@@ -127,6 +127,19 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         //
         CanvasLineSpacingMode m_lineSpacingMode;
 
+        //
+        // DrawText at a point asks for a NoWrap clone of the format on every
+        // call, so the clone is kept until the shadow state changes.  Interop
+        // can modify the realized format directly, so the clone is also
+        // checked against that before it is reused.  Protected by the mutex.
+        //
+        ComPtr<IDWriteTextFormat1> m_noWrapTextFormat;
+
+        //
+        // Counts every IDWriteTextFormat created by any CanvasTextFormat.
+        //
+        static std::atomic<uint32_t> s_createdTextFormatCount;
+
     public:
         CanvasTextFormat();
         CanvasTextFormat(IDWriteTextFormat1* format);
@@ -181,6 +194,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         virtual ComPtr<IDWriteTextFormat> GetRealizedTextFormatClone(CanvasWordWrapping overrideWordWrapping) override;
         virtual D2D1_DRAW_TEXT_OPTIONS GetDrawTextOptions() override;
 
+        static uint32_t GetCreatedTextFormatCount() { return s_createdTextFormatCount.load(); }
+
         //
         // ICanvasResourceWrapperNative
         //
@@ -222,6 +237,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         void RealizeCustomTrimmingSign(IDWriteTextFormat1* textFormat);
 
         ComPtr<IDWriteTextFormat1> CreateRealizedTextFormat(bool skipWordWrapping = false);
+
+        static bool HasSameMutableProperties(IDWriteTextFormat1* format1, IDWriteTextFormat1* format2);
 };
 
 
@@ -340,6 +357,66 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         ComPtr<IDWriteInlineObject> Sign;
     };
 
+
+    // Snapshot of the properties that can be changed on an existing
+    // IDWriteTextFormat.  The others (font family, collection, size, weight,
+    // style, stretch and locale) are fixed when the format is created.
+    struct DWriteMutableFormatProperties
+    {
+        DWriteMutableFormatProperties(IDWriteTextFormat1* format)
+            : ReadingDirection(format->GetReadingDirection())
+            , FlowDirection(format->GetFlowDirection())
+            , IncrementalTabStop(format->GetIncrementalTabStop())
+            , ParagraphAlignment(format->GetParagraphAlignment())
+            , TextAlignment(format->GetTextAlignment())
+            , WordWrapping(format->GetWordWrapping())
+            , VerticalGlyphOrientation(format->GetVerticalGlyphOrientation())
+            , OpticalAlignment(format->GetOpticalAlignment())
+            , LastLineWrapping(!!format->GetLastLineWrapping())
+            , LineSpacing(format)
+            , Trimming(format)
+        {
+        }
+
+        DWRITE_READING_DIRECTION ReadingDirection;
+        DWRITE_FLOW_DIRECTION FlowDirection;
+        float IncrementalTabStop;
+        DWRITE_PARAGRAPH_ALIGNMENT ParagraphAlignment;
+        DWRITE_TEXT_ALIGNMENT TextAlignment;
+        DWRITE_WORD_WRAPPING WordWrapping;
+        DWRITE_VERTICAL_GLYPH_ORIENTATION VerticalGlyphOrientation;
+        DWRITE_OPTICAL_ALIGNMENT OpticalAlignment;
+        bool LastLineWrapping;
+        DWriteLineSpacing LineSpacing;
+        DWriteTrimming Trimming;
+
+        // Trimming signs are compared by identity.
+        bool operator==(DWriteMutableFormatProperties const& other) const
+        {
+            return ReadingDirection == other.ReadingDirection &&
+                   FlowDirection == other.FlowDirection &&
+                   IncrementalTabStop == other.IncrementalTabStop &&
+                   ParagraphAlignment == other.ParagraphAlignment &&
+                   TextAlignment == other.TextAlignment &&
+                   WordWrapping == other.WordWrapping &&
+                   VerticalGlyphOrientation == other.VerticalGlyphOrientation &&
+                   OpticalAlignment == other.OpticalAlignment &&
+                   LastLineWrapping == other.LastLineWrapping &&
+                   LineSpacing.Method == other.LineSpacing.Method &&
+                   LineSpacing.Spacing == other.LineSpacing.Spacing &&
+                   LineSpacing.Baseline == other.LineSpacing.Baseline &&
+                   Trimming.Options.granularity == other.Trimming.Options.granularity &&
+                   Trimming.Options.delimiter == other.Trimming.Options.delimiter &&
+                   Trimming.Options.delimiterCount == other.Trimming.Options.delimiterCount &&
+                   Trimming.Sign == other.Trimming.Sign;
+        }
+
+        bool operator!=(DWriteMutableFormatProperties const& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
     // Struct that maps CanvasTextDirection to DWRITE_READING|FLOW_DIRECTION
     struct DWriteToCanvasTextDirection
     {
@@ -0,0 +1,343 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "ShapingCache.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    ShapingCache::ShapingCache(uint32_t maximumEntryCount, uint64_t maximumSizeInBytes)
+        : m_maximumEntryCount(maximumEntryCount)
+        , m_maximumSizeInBytes(maximumSizeInBytes)
+        , m_currentSizeInBytes(0)
+        , m_hitCount(0)
+        , m_missCount(0)
+        , m_evictionCount(0)
+    {
+    }
+
+
+    std::shared_ptr<ShapedGlyphRun const> ShapingCache::TryGet(uint64_t hash, ShapingParameters const& parameters)
+    {
+        Lock lock(m_mutex);
+
+        auto entry = Find(hash, parameters);
+
+        if (entry == m_entries.end())
+        {
+            ++m_missCount;
+            return nullptr;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+
+        ++m_hitCount;
+        return entry->Run;
+    }
+
+
+    static size_t GetFeatureCount(ShapingParameters const& parameters)
+    {
+        size_t featureCount = 0;
+
+        for (uint32_t i = 0; i < parameters.FeatureRangeCount; ++i)
+        {
+            if (parameters.Features[i])
+                featureCount += parameters.Features[i]->featureCount;
+        }
+
+        return featureCount;
+    }
+
+
+    void ShapingCache::Add(uint64_t hash, ShapingParameters const& parameters, ShapedGlyphRun const& run)
+    {
+        auto glyphCount = run.GlyphCount;
+        auto featureCount = GetFeatureCount(parameters);
+        auto sizeInBytes = GetSizeInBytes(parameters.TextLength, glyphCount, featureCount);
+
+        if (!IsEnabled())
+            return;
+
+        // Runs that could never fit would just flush everything else out.
+        if (sizeInBytes > m_maximumSizeInBytes.load(std::memory_order_relaxed))
+            return;
+
+        //
+        // Copying is done without holding the lock.  The copy is trimmed to
+        // the glyphs that were actually produced.
+        //
+
+        auto cachedRun = std::make_shared<ShapedGlyphRun>();
+        cachedRun->ClusterMap = run.ClusterMap;
+        cachedRun->TextProperties = run.TextProperties;
+        cachedRun->GlyphIndices.assign(run.GlyphIndices.begin(), run.GlyphIndices.begin() + glyphCount);
+        cachedRun->GlyphProperties.assign(run.GlyphProperties.begin(), run.GlyphProperties.begin() + glyphCount);
+        cachedRun->GlyphAdvances.assign(run.GlyphAdvances.begin(), run.GlyphAdvances.begin() + glyphCount);
+        cachedRun->GlyphOffsets.assign(run.GlyphOffsets.begin(), run.GlyphOffsets.begin() + glyphCount);
+        cachedRun->GlyphCount = glyphCount;
+
+        Entry entry
+        {
+            hash,
+            std::wstring(parameters.Text, parameters.TextLength),
+            parameters.FontFace,
+            parameters.FontSize,
+            parameters.IsSideways,
+            parameters.IsRightToLeft,
+            parameters.Script,
+            std::wstring(parameters.Locale),
+            parameters.NumberSubstitution,
+            std::vector<uint32_t>(parameters.FeatureRangeLengths, parameters.FeatureRangeLengths + parameters.FeatureRangeCount),
+            std::vector<uint32_t>(),
+            std::vector<DWRITE_FONT_FEATURE>(),
+            std::move(cachedRun),
+            sizeInBytes
+        };
+
+        entry.FeatureCounts.reserve(parameters.FeatureRangeCount);
+        entry.Features.reserve(featureCount);
+
+        for (uint32_t i = 0; i < parameters.FeatureRangeCount; ++i)
+        {
+            auto features = parameters.Features[i];
+            auto count = features ? features->featureCount : 0;
+
+            entry.FeatureCounts.push_back(count);
+
+            if (count > 0)
+                entry.Features.insert(entry.Features.end(), features->features, features->features + count);
+        }
+
+        Lock lock(m_mutex);
+
+        // Another thread may have added the same run in the meantime.
+        auto existing = Find(hash, parameters);
+
+        if (existing != m_entries.end())
+        {
+            m_entries.splice(m_entries.begin(), m_entries, existing);
+            return;
+        }
+
+        m_entries.push_front(std::move(entry));
+
+        m_index.emplace(hash, m_entries.begin());
+        m_currentSizeInBytes += sizeInBytes;
+
+        EvictTo(m_maximumEntryCount, m_maximumSizeInBytes);
+    }
+
+
+    uint32_t ShapingCache::GetMaximumEntryCount()
+    {
+        Lock lock(m_mutex);
+        return m_maximumEntryCount;
+    }
+
+
+    void ShapingCache::SetMaximumEntryCount(uint32_t value)
+    {
+        Lock lock(m_mutex);
+        m_maximumEntryCount = value;
+        EvictTo(m_maximumEntryCount, m_maximumSizeInBytes);
+    }
+
+
+    uint64_t ShapingCache::GetMaximumSize()
+    {
+        Lock lock(m_mutex);
+        return m_maximumSizeInBytes;
+    }
+
+
+    void ShapingCache::SetMaximumSize(uint64_t value)
+    {
+        Lock lock(m_mutex);
+        m_maximumSizeInBytes = value;
+        EvictTo(m_maximumEntryCount, m_maximumSizeInBytes);
+    }
+
+
+    CanvasShapingCacheStatistics ShapingCache::GetStatistics()
+    {
+        Lock lock(m_mutex);
+
+        CanvasShapingCacheStatistics statistics{};
+        statistics.HitCount = m_hitCount;
+        statistics.MissCount = m_missCount;
+        statistics.EvictionCount = m_evictionCount;
+        statistics.EntryCount = static_cast<uint32_t>(m_entries.size());
+        statistics.SizeInBytes = m_currentSizeInBytes;
+        return statistics;
+    }
+
+
+    void ShapingCache::Clear()
+    {
+        EntryList entries;
+
+        {
+            Lock lock(m_mutex);
+            entries.swap(m_entries);
+            m_index.clear();
+            m_currentSizeInBytes = 0;
+        }
+
+        // The font faces and number substitutions are released here, outside
+        // the lock.
+    }
+
+
+    uint64_t ShapingCache::GetHash(ShapingParameters const& parameters)
+    {
+        // 64 bit FNV-1a.
+        const uint64_t offsetBasis = 14695981039346656037ull;
+        const uint64_t prime = 1099511628211ull;
+
+        uint64_t hash = offsetBasis;
+
+        auto combine = [&](void const* data, size_t size)
+        {
+            auto bytes = static_cast<uint8_t const*>(data);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= prime;
+            }
+        };
+
+        combine(parameters.Text, parameters.TextLength * sizeof(wchar_t));
+        combine(&parameters.FontFace, sizeof(parameters.FontFace));
+        combine(&parameters.FontSize, sizeof(parameters.FontSize));
+        combine(&parameters.Script.script, sizeof(parameters.Script.script));
+
+        uint8_t flags = (parameters.IsSideways ? 1 : 0) | (parameters.IsRightToLeft ? 2 : 0);
+        combine(&flags, sizeof(flags));
+
+        // The locale, number substitution and features are left to Find to
+        // compare, since runs that differ in only those are rare.
+
+        return hash;
+    }
+
+
+    uint64_t ShapingCache::GetSizeInBytes(uint32_t textLength, uint32_t glyphCount, size_t featureCount)
+    {
+        // Covers the entry, its list and index nodes, and the heap blocks
+        // of its vectors and strings.
+        const uint64_t bytesPerEntry = 256;
+
+        const uint64_t bytesPerCharacter =
+            sizeof(wchar_t) +                           // Text
+            sizeof(uint16_t) +                          // ClusterMap
+            sizeof(DWRITE_SHAPING_TEXT_PROPERTIES);     // TextProperties
+
+        const uint64_t bytesPerGlyph =
+            sizeof(uint16_t) +                          // GlyphIndices
+            sizeof(DWRITE_SHAPING_GLYPH_PROPERTIES) +   // GlyphProperties
+            sizeof(float) +                             // GlyphAdvances
+            sizeof(DWRITE_GLYPH_OFFSET);                // GlyphOffsets
+
+        return bytesPerEntry +
+               bytesPerCharacter * textLength +
+               bytesPerGlyph * glyphCount +
+               sizeof(DWRITE_FONT_FEATURE) * featureCount;
+    }
+
+
+    static bool FeaturesMatch(
+        std::vector<uint32_t> const& featureCounts,
+        std::vector<DWRITE_FONT_FEATURE> const& cachedFeatures,
+        ShapingParameters const& parameters)
+    {
+        auto cachedFeature = cachedFeatures.begin();
+
+        for (uint32_t i = 0; i < parameters.FeatureRangeCount; ++i)
+        {
+            auto features = parameters.Features[i];
+            auto count = features ? features->featureCount : 0;
+
+            if (featureCounts[i] != count)
+                return false;
+
+            for (uint32_t j = 0; j < count; ++j, ++cachedFeature)
+            {
+                if (cachedFeature->nameTag != features->features[j].nameTag ||
+                    cachedFeature->parameter != features->features[j].parameter)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+
+    ShapingCache::EntryList::iterator ShapingCache::Find(uint64_t hash, ShapingParameters const& parameters)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(hash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            auto& entry = *it->second;
+
+            if (entry.FontFace.Get() == parameters.FontFace &&
+                entry.FontSize == parameters.FontSize &&
+                entry.IsSideways == parameters.IsSideways &&
+                entry.IsRightToLeft == parameters.IsRightToLeft &&
+                entry.Script.script == parameters.Script.script &&
+                entry.Script.shapes == parameters.Script.shapes &&
+                entry.NumberSubstitution.Get() == parameters.NumberSubstitution &&
+                entry.Text.size() == parameters.TextLength &&
+                wmemcmp(entry.Text.data(), parameters.Text, parameters.TextLength) == 0 &&
+                entry.Locale == parameters.Locale &&
+                entry.FeatureRangeLengths.size() == parameters.FeatureRangeCount &&
+                std::equal(entry.FeatureRangeLengths.begin(), entry.FeatureRangeLengths.end(), parameters.FeatureRangeLengths) &&
+                FeaturesMatch(entry.FeatureCounts, entry.Features, parameters))
+            {
+                return it->second;
+            }
+        }
+
+        return m_entries.end();
+    }
+
+
+    void ShapingCache::Remove(EntryList::iterator entry)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(entry->Hash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            if (it->second == entry)
+            {
+                m_index.erase(it);
+                break;
+            }
+        }
+
+        m_currentSizeInBytes -= entry->SizeInBytes;
+        m_entries.erase(entry);
+    }
+
+
+    void ShapingCache::EvictTo(uint32_t maximumEntryCount, uint64_t maximumSizeInBytes)
+    {
+        // Caller must hold m_mutex.
+
+        while (!m_entries.empty() &&
+               (m_entries.size() > maximumEntryCount || m_currentSizeInBytes > maximumSizeInBytes))
+        {
+            Remove(std::prev(m_entries.end()));
+            ++m_evictionCount;
+        }
+    }
+}}}}}
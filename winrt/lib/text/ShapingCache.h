@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // The arguments that CanvasTextAnalyzer.GetGlyphs passes to
+    // IDWriteTextAnalyzer::GetGlyphs and GetGlyphPlacements.
+    //
+    struct ShapingParameters
+    {
+        wchar_t const* Text;
+        uint32_t TextLength;
+        IDWriteFontFace* FontFace;
+        float FontSize;
+        bool IsSideways;
+        bool IsRightToLeft;
+        DWRITE_SCRIPT_ANALYSIS Script;
+        wchar_t const* Locale;
+        IDWriteNumberSubstitution* NumberSubstitution;
+        DWRITE_TYPOGRAPHIC_FEATURES const** Features;
+        uint32_t const* FeatureRangeLengths;
+        uint32_t FeatureRangeCount;
+    };
+
+
+    //
+    // The results of shaping a run of text.  While shaping, GlyphIndices and
+    // GlyphProperties are sized to the maximum glyph count passed to DWrite,
+    // so only the first GlyphCount elements are valid.
+    //
+    struct ShapedGlyphRun
+    {
+        std::vector<uint16_t> ClusterMap;
+        std::vector<DWRITE_SHAPING_TEXT_PROPERTIES> TextProperties;
+        std::vector<uint16_t> GlyphIndices;
+        std::vector<DWRITE_SHAPING_GLYPH_PROPERTIES> GlyphProperties;
+        std::vector<float> GlyphAdvances;
+        std::vector<DWRITE_GLYPH_OFFSET> GlyphOffsets;
+        uint32_t GlyphCount;
+
+        ShapedGlyphRun()
+            : GlyphCount(0)
+        { }
+    };
+
+
+    //
+    // Keeps the glyph runs produced by CanvasTextAnalyzer.GetGlyphs, so that
+    // apps shaping the same runs over and over (for instance a text engine
+    // that reshapes each visible line every frame) don't pay DWrite to shape
+    // them again each time.
+    //
+    // Runs are looked up by all of the shaping parameters.  The text, locale
+    // and typography features are matched by value; the font face and number
+    // substitution by identity, with the entry holding a reference so that
+    // their addresses can't be reused while cached.
+    //
+    // The cache is shared by every text analyzer in the process, so it may be
+    // used from several threads at once.  Cached runs are never modified.
+    //
+    // The cache is disabled until a maximum entry count is set.  Entries are
+    // evicted in least-recently-used order once either the entry count or the
+    // size exceeds its budget.  IsEnabled doesn't take the lock, so while the
+    // cache is disabled (the default) GetGlyphs pays a single atomic load.
+    //
+    class ShapingCache : public Singleton<ShapingCache>
+    {
+    public:
+        static const uint32_t DefaultMaximumEntryCount = 0;
+        static const uint64_t DefaultMaximumSizeInBytes = 4 * 1024 * 1024;
+
+    private:
+        struct Entry
+        {
+            uint64_t Hash;
+            std::wstring Text;
+            ComPtr<IDWriteFontFace> FontFace;
+            float FontSize;
+            bool IsSideways;
+            bool IsRightToLeft;
+            DWRITE_SCRIPT_ANALYSIS Script;
+            std::wstring Locale;
+            ComPtr<IDWriteNumberSubstitution> NumberSubstitution;
+
+            // Flattened copy of the typography ranges: the length and number
+            // of features of each range, followed by all the features.
+            std::vector<uint32_t> FeatureRangeLengths;
+            std::vector<uint32_t> FeatureCounts;
+            std::vector<DWRITE_FONT_FEATURE> Features;
+
+            std::shared_ptr<ShapedGlyphRun const> Run;
+            uint64_t SizeInBytes;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_mutex;
+
+        // Most recently used at the front.
+        EntryList m_entries;
+
+        // Indexes m_entries by hash.  Different keys may have the same hash,
+        // so lookups compare each candidate in full.
+        std::unordered_multimap<uint64_t, EntryList::iterator> m_index;
+
+        // Only changed while holding m_mutex, but read without it to
+        // quickly reject requests when the cache is disabled.
+        std::atomic<uint32_t> m_maximumEntryCount;
+        std::atomic<uint64_t> m_maximumSizeInBytes;
+
+        uint64_t m_currentSizeInBytes;
+
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+        uint64_t m_evictionCount;
+
+    public:
+        ShapingCache(
+            uint32_t maximumEntryCount = DefaultMaximumEntryCount,
+            uint64_t maximumSizeInBytes = DefaultMaximumSizeInBytes);
+
+        ShapingCache(ShapingCache const&) = delete;
+        ShapingCache& operator=(ShapingCache const&) = delete;
+
+        bool IsEnabled()
+        {
+            return m_maximumEntryCount.load(std::memory_order_relaxed) != 0;
+        }
+
+        //
+        // Returns the cached run for these parameters, or null if there isn't
+        // one.  hash must come from GetHash.
+        //
+        std::shared_ptr<ShapedGlyphRun const> TryGet(uint64_t hash, ShapingParameters const& parameters);
+
+        // Adds a copy of the first run.GlyphCount glyphs of run.
+        void Add(uint64_t hash, ShapingParameters const& parameters, ShapedGlyphRun const& run);
+
+        uint32_t GetMaximumEntryCount();
+        void SetMaximumEntryCount(uint32_t value);
+
+        uint64_t GetMaximumSize();
+        void SetMaximumSize(uint64_t value);
+
+        CanvasShapingCacheStatistics GetStatistics();
+
+        // Releases all cached runs.
+        void Clear();
+
+        static uint64_t GetHash(ShapingParameters const& parameters);
+
+        static uint64_t GetSizeInBytes(uint32_t textLength, uint32_t glyphCount, size_t featureCount);
+
+    private:
+        EntryList::iterator Find(uint64_t hash, ShapingParameters const& parameters);
+
+        void Remove(EntryList::iterator entry);
+        void EvictTo(uint32_t maximumEntryCount, uint64_t maximumSizeInBytes);
+    };
+}}}}}
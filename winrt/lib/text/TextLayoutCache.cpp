@@ -0,0 +1,303 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "TextLayoutCache.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    std::atomic<uint32_t> TextLayoutCache::s_enabledCacheCount(0);
+
+
+    TextLayoutCache::TextLayoutCache(uint32_t maximumEntryCount, uint64_t maximumSizeInBytes)
+        : m_maximumEntryCount(maximumEntryCount)
+        , m_maximumSizeInBytes(maximumSizeInBytes)
+        , m_currentSizeInBytes(0)
+        , m_hitCount(0)
+        , m_missCount(0)
+        , m_evictionCount(0)
+    {
+        if (maximumEntryCount != 0)
+            ++s_enabledCacheCount;
+    }
+
+
+    TextLayoutCache::~TextLayoutCache()
+    {
+        if (m_maximumEntryCount != 0)
+            --s_enabledCacheCount;
+    }
+
+
+    ComPtr<IDWriteTextLayout> TextLayoutCache::GetOrCreateLayout(
+        IDWriteFactory* factory,
+        wchar_t const* text,
+        uint32_t textLength,
+        IDWriteTextFormat* format,
+        float width,
+        float height)
+    {
+        if (m_maximumEntryCount.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        // Layouts that could never fit would just flush everything else out.
+        auto sizeInBytes = GetEstimatedSizeInBytes(textLength);
+
+        if (sizeInBytes > m_maximumSizeInBytes.load(std::memory_order_relaxed))
+            return nullptr;
+
+        auto format1 = MaybeAs<IDWriteTextFormat1>(format);
+
+        if (!format1)
+            return nullptr;
+
+        DWriteMutableFormatProperties formatProperties(format1.Get());
+        auto hash = GetHash(text, textLength, format1.Get(), width, height);
+
+        if (auto layout = TryGet(hash, text, textLength, format1.Get(), formatProperties, width, height))
+            return layout;
+
+        //
+        // Creating the layout is the slow part, so it is done without holding
+        // the lock.  GetMetrics forces DWrite to shape and line break the text
+        // now; otherwise this would happen lazily the first time the layout is
+        // drawn, which could then be on several threads at once.
+        //
+
+        ComPtr<IDWriteTextLayout> layout;
+        ThrowIfFailed(factory->CreateTextLayout(text, textLength, format, width, height, &layout));
+
+        DWRITE_TEXT_METRICS metrics;
+        ThrowIfFailed(layout->GetMetrics(&metrics));
+
+        Lock lock(m_mutex);
+
+        // Another thread may have added the same layout in the meantime.
+        auto existing = Find(hash, text, textLength, format1.Get(), formatProperties, width, height);
+
+        if (existing != m_entries.end())
+        {
+            m_entries.splice(m_entries.begin(), m_entries, existing);
+            return existing->Layout;
+        }
+
+        m_entries.push_front(Entry
+        {
+            hash,
+            std::wstring(text, textLength),
+            format1,
+            formatProperties,
+            width,
+            height,
+            layout,
+            sizeInBytes
+        });
+
+        m_index.emplace(hash, m_entries.begin());
+        m_currentSizeInBytes += sizeInBytes;
+
+        EvictTo(m_maximumEntryCount, m_maximumSizeInBytes);
+
+        return layout;
+    }
+
+
+    uint32_t TextLayoutCache::GetMaximumEntryCount()
+    {
+        Lock lock(m_mutex);
+        return m_maximumEntryCount;
+    }
+
+
+    void TextLayoutCache::SetMaximumEntryCount(uint32_t value)
+    {
+        Lock lock(m_mutex);
+
+        if (m_maximumEntryCount == 0 && value != 0)
+            ++s_enabledCacheCount;
+        else if (m_maximumEntryCount != 0 && value == 0)
+            --s_enabledCacheCount;
+
+        m_maximumEntryCount = value;
+        EvictTo(m_maximumEntryCount, m_maximumSizeInBytes);
+    }
+
+
+    uint64_t TextLayoutCache::GetMaximumSize()
+    {
+        Lock lock(m_mutex);
+        return m_maximumSizeInBytes;
+    }
+
+
+    void TextLayoutCache::SetMaximumSize(uint64_t value)
+    {
+        Lock lock(m_mutex);
+        m_maximumSizeInBytes = value;
+        EvictTo(m_maximumEntryCount, m_maximumSizeInBytes);
+    }
+
+
+    CanvasTextLayoutCacheStatistics TextLayoutCache::GetStatistics()
+    {
+        Lock lock(m_mutex);
+
+        CanvasTextLayoutCacheStatistics statistics{};
+        statistics.HitCount = m_hitCount;
+        statistics.MissCount = m_missCount;
+        statistics.EvictionCount = m_evictionCount;
+        statistics.EntryCount = static_cast<uint32_t>(m_entries.size());
+        statistics.SizeInBytes = m_currentSizeInBytes;
+        return statistics;
+    }
+
+
+    void TextLayoutCache::Clear()
+    {
+        EntryList entries;
+
+        {
+            Lock lock(m_mutex);
+            entries.swap(m_entries);
+            m_index.clear();
+            m_currentSizeInBytes = 0;
+        }
+
+        // The layouts are released here, outside the lock.
+    }
+
+
+    uint64_t TextLayoutCache::GetHash(wchar_t const* text, uint32_t textLength, IDWriteTextFormat1* format, float width, float height)
+    {
+        // 64 bit FNV-1a.
+        const uint64_t offsetBasis = 14695981039346656037ull;
+        const uint64_t prime = 1099511628211ull;
+
+        uint64_t hash = offsetBasis;
+
+        auto combine = [&](void const* data, size_t size)
+        {
+            auto bytes = static_cast<uint8_t const*>(data);
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= prime;
+            }
+        };
+
+        combine(text, textLength * sizeof(wchar_t));
+        combine(&format, sizeof(format));
+        combine(&width, sizeof(width));
+        combine(&height, sizeof(height));
+
+        return hash;
+    }
+
+
+    uint64_t TextLayoutCache::GetEstimatedSizeInBytes(uint32_t textLength)
+    {
+        //
+        // A layout holds a handful of fixed-size structures, plus per-character
+        // cluster and glyph data (glyph indices, advances, offsets and cluster
+        // maps), roughly in proportion to the length of the text.  We keep a
+        // copy of the text ourselves, too.
+        //
+        const uint64_t bytesPerLayout = 1024;
+        const uint64_t bytesPerCharacter = 64 + sizeof(wchar_t);
+
+        return bytesPerLayout + bytesPerCharacter * textLength;
+    }
+
+
+    ComPtr<IDWriteTextLayout> TextLayoutCache::TryGet(
+        uint64_t hash,
+        wchar_t const* text,
+        uint32_t textLength,
+        IDWriteTextFormat1* format,
+        DWriteMutableFormatProperties const& formatProperties,
+        float width,
+        float height)
+    {
+        Lock lock(m_mutex);
+
+        auto entry = Find(hash, text, textLength, format, formatProperties, width, height);
+
+        if (entry == m_entries.end())
+        {
+            ++m_missCount;
+            return nullptr;
+        }
+
+        m_entries.splice(m_entries.begin(), m_entries, entry);
+
+        ++m_hitCount;
+        return entry->Layout;
+    }
+
+
+    TextLayoutCache::EntryList::iterator TextLayoutCache::Find(
+        uint64_t hash,
+        wchar_t const* text,
+        uint32_t textLength,
+        IDWriteTextFormat1* format,
+        DWriteMutableFormatProperties const& formatProperties,
+        float width,
+        float height)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(hash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            auto& entry = *it->second;
+
+            if (entry.Format.Get() == format &&
+                entry.Width == width &&
+                entry.Height == height &&
+                entry.Text.size() == textLength &&
+                wmemcmp(entry.Text.data(), text, textLength) == 0 &&
+                entry.FormatProperties == formatProperties)
+            {
+                return it->second;
+            }
+        }
+
+        return m_entries.end();
+    }
+
+
+    void TextLayoutCache::Remove(EntryList::iterator entry)
+    {
+        // Caller must hold m_mutex.
+
+        auto candidates = m_index.equal_range(entry->Hash);
+
+        for (auto it = candidates.first; it != candidates.second; ++it)
+        {
+            if (it->second == entry)
+            {
+                m_index.erase(it);
+                break;
+            }
+        }
+
+        m_currentSizeInBytes -= entry->SizeInBytes;
+        m_entries.erase(entry);
+    }
+
+
+    void TextLayoutCache::EvictTo(uint32_t maximumEntryCount, uint64_t maximumSizeInBytes)
+    {
+        // Caller must hold m_mutex.
+
+        while (!m_entries.empty() &&
+               (m_entries.size() > maximumEntryCount || m_currentSizeInBytes > maximumSizeInBytes))
+        {
+            Remove(std::prev(m_entries.end()));
+            ++m_evictionCount;
+        }
+    }
+}}}}}
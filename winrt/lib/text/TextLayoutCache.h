@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "utils/LockUtilities.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace Text
+{
+    using namespace ::Microsoft::WRL;
+
+    //
+    // Keeps the IDWriteTextLayouts created for DrawText calls, so that apps
+    // drawing the same strings every frame don't pay for shaping and line
+    // breaking them again each time.
+    //
+    // Layouts are looked up by the text, the realized text format and the
+    // size of the layout box.  The format is matched by identity, and also by
+    // the values of the properties that can be changed on an existing
+    // IDWriteTextFormat, since both CanvasTextFormat and interop callers may
+    // modify a realized format in place.
+    //
+    // The cache is shared by all drawing sessions of a device, so it may be
+    // used from several threads at once.  Layouts are fully formatted before
+    // they are added, after which drawing them doesn't modify them.
+    //
+    // The cache is disabled until a maximum entry count is set.  Entries are
+    // evicted in least-recently-used order once either the entry count or the
+    // estimated size exceeds its budget.  DrawText checks IsAnyEnabled before
+    // looking up the device's cache, so while every cache is disabled (the
+    // default) it costs a single atomic load.
+    //
+    class TextLayoutCache
+    {
+    public:
+        static const uint32_t DefaultMaximumEntryCount = 0;
+        static const uint64_t DefaultMaximumSizeInBytes = 4 * 1024 * 1024;
+
+    private:
+        struct Entry
+        {
+            uint64_t Hash;
+            std::wstring Text;
+            ComPtr<IDWriteTextFormat1> Format;
+            DWriteMutableFormatProperties FormatProperties;
+            float Width;
+            float Height;
+            ComPtr<IDWriteTextLayout> Layout;
+            uint64_t SizeInBytes;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        std::mutex m_mutex;
+
+        // Most recently used at the front.
+        EntryList m_entries;
+
+        // Indexes m_entries by hash.  Different keys may have the same hash,
+        // so lookups compare each candidate in full.
+        std::unordered_multimap<uint64_t, EntryList::iterator> m_index;
+
+        // Only changed while holding m_mutex, but read without it to
+        // quickly reject requests when the cache is disabled.
+        std::atomic<uint32_t> m_maximumEntryCount;
+        std::atomic<uint64_t> m_maximumSizeInBytes;
+
+        uint64_t m_currentSizeInBytes;
+
+        uint64_t m_hitCount;
+        uint64_t m_missCount;
+        uint64_t m_evictionCount;
+
+        // How many caches in the process have a non-zero maximum entry count.
+        static std::atomic<uint32_t> s_enabledCacheCount;
+
+    public:
+        TextLayoutCache(
+            uint32_t maximumEntryCount = DefaultMaximumEntryCount,
+            uint64_t maximumSizeInBytes = DefaultMaximumSizeInBytes);
+
+        ~TextLayoutCache();
+
+        TextLayoutCache(TextLayoutCache const&) = delete;
+        TextLayoutCache& operator=(TextLayoutCache const&) = delete;
+
+        // False if every cache is disabled, in which case there is no
+        // point asking a device for its cache.
+        static bool IsAnyEnabled()
+        {
+            return s_enabledCacheCount.load(std::memory_order_relaxed) != 0;
+        }
+
+        //
+        // Returns a layout of the text with the given format and size, using
+        // the cached one if there is one.  Returns null if the cache is
+        // disabled, in which case the caller should draw the text directly.
+        //
+        ComPtr<IDWriteTextLayout> GetOrCreateLayout(
+            IDWriteFactory* factory,
+            wchar_t const* text,
+            uint32_t textLength,
+            IDWriteTextFormat* format,
+            float width,
+            float height);
+
+        uint32_t GetMaximumEntryCount();
+        void SetMaximumEntryCount(uint32_t value);
+
+        uint64_t GetMaximumSize();
+        void SetMaximumSize(uint64_t value);
+
+        CanvasTextLayoutCacheStatistics GetStatistics();
+
+        // Releases all cached layouts.
+        void Clear();
+
+        static uint64_t GetHash(wchar_t const* text, uint32_t textLength, IDWriteTextFormat1* format, float width, float height);
+
+        // DWrite doesn't report how much memory a layout uses, so this is
+        // an estimate based on the length of the text.
+        static uint64_t GetEstimatedSizeInBytes(uint32_t textLength);
+
+    private:
+        ComPtr<IDWriteTextLayout> TryGet(
+            uint64_t hash,
+            wchar_t const* text,
+            uint32_t textLength,
+            IDWriteTextFormat1* format,
+            DWriteMutableFormatProperties const& formatProperties,
+            float width,
+            float height);
+
+        EntryList::iterator Find(
+            uint64_t hash,
+            wchar_t const* text,
+            uint32_t textLength,
+            IDWriteTextFormat1* format,
+            DWriteMutableFormatProperties const& formatProperties,
+            float width,
+            float height);
+
+        void Remove(EntryList::iterator entry);
+        void EvictTo(uint32_t maximumEntryCount, uint64_t maximumSizeInBytes);
+    };
+}}}}}
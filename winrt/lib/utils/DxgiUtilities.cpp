@@ -3,6 +3,7 @@
 // Licensed under the MIT License. See LICENSE.txt in the project root for license information.
 
 #include "pch.h"
+#include "PixelConversion.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
@@ -186,15 +187,12 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     // Converts color array to bytes according to the default format, B8G8R8A8_UNORM.
     std::vector<uint8_t> ConvertColorsToBgra(uint32_t colorCount, Color* colors)
     {
+        static_assert(sizeof(Color) == 4, "Color must be tightly packed");
+
         std::vector<uint8_t> convertedBytes(colorCount * 4);
 
-        for (uint32_t i = 0; i < colorCount; i++)
-        {
-            convertedBytes[i * 4 + 0] = colors[i].B;
-            convertedBytes[i * 4 + 1] = colors[i].G;
-            convertedBytes[i * 4 + 2] = colors[i].R;
-            convertedBytes[i * 4 + 3] = colors[i].A;
-        }
+        // Color stores its channels as A, R, G, B, the reverse of B8G8R8A8.
+        PixelConversion::GetKernels().SwapByteOrder(reinterpret_cast<uint8_t const*>(colors), convertedBytes.data(), colorCount);
 
         assert(convertedBytes.size() <= UINT_MAX);
 
@@ -5,48 +5,170 @@
 #include "pch.h"
 #include "HashUtilities.h"
 
-using namespace ABI::Windows::Security::Cryptography;
-using namespace ABI::Windows::Security::Cryptography::Core;
-using namespace ABI::Windows::Storage::Streams;
-
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
-    ComArray<BYTE> GetSha1Hash(BYTE const* data, size_t dataSize)
+    static uint32_t RotateLeft(uint32_t value, int bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+
+    static uint32_t LoadBigEndian(BYTE const* bytes)
+    {
+        return (static_cast<uint32_t>(bytes[0]) << 24) |
+               (static_cast<uint32_t>(bytes[1]) << 16) |
+               (static_cast<uint32_t>(bytes[2]) << 8) |
+               (static_cast<uint32_t>(bytes[3]));
+    }
+
+
+    static void StoreBigEndian(BYTE* bytes, uint32_t value)
     {
-        // Look up WinRT activation factories.
-        ComPtr<ICryptographicBufferStatics> bufferStatics;
-        ThrowIfFailed(GetActivationFactory(Wrappers::HStringReference(RuntimeClass_Windows_Security_Cryptography_CryptographicBuffer).Get(), &bufferStatics));
+        bytes[0] = static_cast<BYTE>(value >> 24);
+        bytes[1] = static_cast<BYTE>(value >> 16);
+        bytes[2] = static_cast<BYTE>(value >> 8);
+        bytes[3] = static_cast<BYTE>(value);
+    }
 
-        ComPtr<IHashAlgorithmNamesStatics> algorithmNames;
-        ThrowIfFailed(GetActivationFactory(Wrappers::HStringReference(RuntimeClass_Windows_Security_Cryptography_Core_HashAlgorithmNames).Get(), &algorithmNames));
 
-        ComPtr<IHashAlgorithmProviderStatics> algorithmStatics;
-        ThrowIfFailed(GetActivationFactory(Wrappers::HStringReference(RuntimeClass_Windows_Security_Cryptography_Core_HashAlgorithmProvider).Get(), &algorithmStatics));
+    Sha1Hasher::Sha1Hasher()
+        : m_state{ 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 }
+        , m_totalSize(0)
+        , m_pendingSize(0)
+    {
+    }
+
 
-        // Convert the input data to an IBuffer.
-        ComPtr<IBuffer> dataBuffer;
-        ThrowIfFailed(bufferStatics->CreateFromByteArray(static_cast<UINT32>(dataSize), const_cast<BYTE*>(data), &dataBuffer));
+    void Sha1Hasher::Append(BYTE const* data, size_t dataSize)
+    {
+        m_totalSize += dataSize;
+
+        // Top up any partial block left over from the last call.
+        if (m_pendingSize > 0)
+        {
+            auto count = std::min(dataSize, BlockSize - m_pendingSize);
+
+            memcpy(m_pendingBlock + m_pendingSize, data, count);
+            m_pendingSize += count;
+            data += count;
+            dataSize -= count;
+
+            if (m_pendingSize < BlockSize)
+                return;
+
+            ProcessBlock(m_pendingBlock);
+            m_pendingSize = 0;
+        }
+
+        // Whole blocks are hashed straight from the caller's buffer.
+        while (dataSize >= BlockSize)
+        {
+            ProcessBlock(data);
+            data += BlockSize;
+            dataSize -= BlockSize;
+        }
+
+        memcpy(m_pendingBlock, data, dataSize);
+        m_pendingSize = dataSize;
+    }
 
-        // Look up the name of the SHA1 hashing algorithm.
-        WinString sha1Name;
-        ThrowIfFailed(algorithmNames->get_Sha1(sha1Name.GetAddressOf()));
 
-        // Instantiate the hashing algorithm.
-        ComPtr<IHashAlgorithmProvider> algorithm;
-        ThrowIfFailed(algorithmStatics->OpenAlgorithm(sha1Name, &algorithm));
+    Sha1Hash Sha1Hasher::Finish()
+    {
+        auto totalBits = m_totalSize * 8;
 
-        // Hash our data.
-        ComPtr<IBuffer> resultBuffer;
-        ThrowIfFailed(algorithm->HashData(dataBuffer.Get(), &resultBuffer));
+        // Pad with a single 1 bit, then zeros up to 8 bytes short of a block
+        // boundary, then the message length in bits.
+        BYTE padding[BlockSize * 2] = { 0x80 };
 
-        // Convert IBuffer -> ComArray.
-        ComArray<BYTE> result;
-        ThrowIfFailed(bufferStatics->CopyToByteArray(resultBuffer.Get(), result.GetAddressOfSize(), result.GetAddressOfData()));
+        auto paddingSize = BlockSize - ((m_pendingSize + 8) % BlockSize);
+
+        for (int i = 0; i < 8; ++i)
+        {
+            padding[paddingSize + i] = static_cast<BYTE>(totalBits >> (56 - i * 8));
+        }
+
+        Append(padding, paddingSize + 8);
+
+        assert(m_pendingSize == 0);
+
+        Sha1Hash result;
+
+        for (int i = 0; i < 5; ++i)
+        {
+            StoreBigEndian(&result[i * 4], m_state[i]);
+        }
 
         return result;
     }
 
 
+    void Sha1Hasher::ProcessBlock(BYTE const* block)
+    {
+        // The message schedule only ever looks 16 words back, so it is kept
+        // in a circular buffer rather than expanded to all 80 words.
+        uint32_t w[16];
+
+        for (int i = 0; i < 16; ++i)
+        {
+            w[i] = LoadBigEndian(block + i * 4);
+        }
+
+        auto schedule = [&](int i)
+        {
+            if (i >= 16)
+                w[i & 15] = RotateLeft(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+
+            return w[i & 15];
+        };
+
+        auto a = m_state[0];
+        auto b = m_state[1];
+        auto c = m_state[2];
+        auto d = m_state[3];
+        auto e = m_state[4];
+
+        auto round = [&](uint32_t f, uint32_t k, int i)
+        {
+            auto temp = RotateLeft(a, 5) + f + e + k + schedule(i);
+
+            e = d;
+            d = c;
+            c = RotateLeft(b, 30);
+            b = a;
+            a = temp;
+        };
+
+        // Each group of 20 rounds uses a different mixing function, so they
+        // are separate loops to keep the branches out of the inner loop.
+        for (int i = 0; i < 20; ++i)
+            round(d ^ (b & (c ^ d)), 0x5A827999, i);
+
+        for (int i = 20; i < 40; ++i)
+            round(b ^ c ^ d, 0x6ED9EBA1, i);
+
+        for (int i = 40; i < 60; ++i)
+            round((b & c) | (d & (b | c)), 0x8F1BBCDC, i);
+
+        for (int i = 60; i < 80; ++i)
+            round(b ^ c ^ d, 0xCA62C1D6, i);
+
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+    }
+
+
+    Sha1Hash GetSha1Hash(BYTE const* data, size_t dataSize)
+    {
+        Sha1Hasher hasher;
+        hasher.Append(data, dataSize);
+        return hasher.Finish();
+    }
+
+
     // Swaps a UUID between local and network byte ordering.
     static void SwapUuidByteOrder(BYTE* uuid)
     {
@@ -67,21 +189,21 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     // based on an input name, so the same name always produces the same UUID .
     IID GetVersion5Uuid(IID const& namespaceId, BYTE const* name, size_t nameSize)
     {
-        // Convert the namespace to a byte array.
-        auto namespaceBytes = reinterpret_cast<BYTE const*>(&namespaceId);
-
-        std::vector<BYTE> buffer(namespaceBytes, namespaceBytes + sizeof(IID));
+        // Convert the namespace to network byte ordering.
+        BYTE namespaceBytes[sizeof(IID)];
+        memcpy(namespaceBytes, &namespaceId, sizeof(IID));
 
-        // Convert to network byte ordering.
-        SwapUuidByteOrder(buffer.data());
+        SwapUuidByteOrder(namespaceBytes);
 
-        // Concatenate the name onto the namespace.
-        buffer.insert(buffer.end(), name, name + nameSize);
+        // Hash the namespace followed by the name.
+        Sha1Hasher hasher;
+        hasher.Append(namespaceBytes, sizeof(namespaceBytes));
+        hasher.Append(name, nameSize);
 
         // Take the first 16 bytes of the SHA-1 hash.
-        auto result = GetSha1Hash(buffer.data(), buffer.size());
-    
-        assert(result.GetSize() >= sizeof(IID));
+        auto result = hasher.Finish();
+
+        static_assert(Sha1HashSize >= sizeof(IID), "SHA-1 hash is too small for a UUID");
 
         // Set the variant bits (MSB0-1 = 2 means standard RFC 4122 UUID).
         result[8] &= 0x3F;
@@ -92,9 +214,11 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         result[6] |= 5 << 4;
 
         // Convert to local byte ordering.
-        SwapUuidByteOrder(result.GetData());
+        SwapUuidByteOrder(result.data());
 
-        return *reinterpret_cast<IID*>(result.GetData());
+        IID uuid;
+        memcpy(&uuid, result.data(), sizeof(IID));
+        return uuid;
     }
 
 }}}}
@@ -6,8 +6,37 @@
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
-    ComArray<BYTE> GetSha1Hash(BYTE const* data, size_t dataSize);
+    const size_t Sha1HashSize = 20;
+
+    typedef std::array<BYTE, Sha1HashSize> Sha1Hash;
+
+
+    // Computes a SHA-1 hash (FIPS 180-4) of data supplied in one or more pieces.
+    class Sha1Hasher
+    {
+        static const size_t BlockSize = 64;
+
+        uint32_t m_state[5];
+        uint64_t m_totalSize;
+
+        BYTE m_pendingBlock[BlockSize];
+        size_t m_pendingSize;
+
+    public:
+        Sha1Hasher();
+
+        void Append(BYTE const* data, size_t dataSize);
+
+        // Returns the hash of everything appended so far.
+        Sha1Hash Finish();
+
+    private:
+        void ProcessBlock(BYTE const* block);
+    };
+
+
+    Sha1Hash GetSha1Hash(BYTE const* data, size_t dataSize);
 
     IID GetVersion5Uuid(IID const& namespaceId, BYTE const* name, size_t nameSize);
-    
+
 }}}}
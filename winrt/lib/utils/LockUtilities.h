@@ -9,6 +9,53 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     typedef std::unique_lock<std::mutex> Lock;
     typedef std::unique_lock<std::recursive_mutex> RecursiveLock;
 
+    //
+    // Slim reader/writer lock, for data that is read much more often than it
+    // is written.  Satisfies the standard Lockable requirements (so it can be
+    // used with std::unique_lock) for exclusive access, and works with
+    // SharedLock for concurrent read access.
+    //
+    class ReaderWriterLock
+    {
+        SRWLOCK m_lock;
+
+    public:
+        ReaderWriterLock()
+        {
+            InitializeSRWLock(&m_lock);
+        }
+
+        ReaderWriterLock(ReaderWriterLock const&) = delete;
+        ReaderWriterLock& operator=(ReaderWriterLock const&) = delete;
+
+        void lock()          { AcquireSRWLockExclusive(&m_lock); }
+        void unlock()        { ReleaseSRWLockExclusive(&m_lock); }
+        void lock_shared()   { AcquireSRWLockShared(&m_lock); }
+        void unlock_shared() { ReleaseSRWLockShared(&m_lock); }
+    };
+
+    typedef std::unique_lock<ReaderWriterLock> ExclusiveLock;
+
+    class SharedLock
+    {
+        ReaderWriterLock& m_lock;
+
+    public:
+        explicit SharedLock(ReaderWriterLock& lock)
+            : m_lock(lock)
+        {
+            m_lock.lock_shared();
+        }
+
+        ~SharedLock()
+        {
+            m_lock.unlock_shared();
+        }
+
+        SharedLock(SharedLock const&) = delete;
+        SharedLock& operator=(SharedLock const&) = delete;
+    };
+
     template<typename LOCK>
     inline void MustOwnLock(LOCK const& lock)
     {
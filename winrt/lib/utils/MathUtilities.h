@@ -40,6 +40,33 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
     }
 
 
+    // Ideally we would just call D2D1::ComputeFlatteningTolerance where this is
+    // used, which internally uses D2D1ComputeMaximumScaleFactor, but unfortunately
+    // that DLL entrypoint is not marked as valid for Windows Phone 8.1 apps (an
+    // oversight). Using it would make Win2D Phone apps fail certification, so
+    // instead we must do the calculation directly here ourselves.
+    inline float ComputeMaximumScaleFactor(D2D1_MATRIX_3X2_F const& m)
+    {
+        if (m._12 == 0.0f && m._21 == 0.0f)
+        {
+            // Simple scale matrix.
+            return std::max(fabs(m._11), fabs(m._22));
+        }
+        else
+        {
+            // Solve a quadratic.
+            float a = m._11 * m._11 + m._12 * m._12;
+            float b = m._11 * m._21 + m._12 * m._22;
+            float c = m._21 * m._21 + m._22 * m._22;
+
+            float d = a - c;
+
+            float r = sqrtf(d * d + b * b * 4);
+
+            return sqrtf((a + c + r) * 0.5f);
+        }
+    }
+
     inline Numerics::Matrix3x2 const& Identity3x2()
     {
         static Numerics::Matrix3x2 identity{ 1, 0, 0, 1, 0, 0 };
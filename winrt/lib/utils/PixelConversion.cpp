@@ -0,0 +1,489 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "PixelConversion.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define PIXEL_CONVERSION_X86
+#endif
+
+#ifdef PIXEL_CONVERSION_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//
+// MSVC lets any function use any intrinsic, while GCC and Clang only allow
+// intrinsics for instruction sets that the function has been compiled for.
+//
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXEL_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#else
+#define PIXEL_TARGET(instructionSet)
+#endif
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace PixelConversion
+{
+    //
+    // Scalar implementations.  These are the reference that the vector
+    // implementations must match, and also handle the pixels left over at the
+    // end of a buffer that do not fill a whole vector.
+    //
+
+    static void SwapByteOrderScalar(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            uint8_t b0 = source[0];
+            uint8_t b1 = source[1];
+            uint8_t b2 = source[2];
+            uint8_t b3 = source[3];
+
+            destination[0] = b3;
+            destination[1] = b2;
+            destination[2] = b1;
+            destination[3] = b0;
+
+            source += 4;
+            destination += 4;
+        }
+    }
+
+    static inline uint8_t PremultiplyChannel(uint32_t color, uint32_t alpha)
+    {
+        // Exact round(color * alpha / 255), without a division.
+        uint32_t t = color * alpha + 128;
+        return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+    }
+
+    static inline uint8_t UnpremultiplyChannel(uint32_t color, uint32_t alpha)
+    {
+        if (alpha == 0)
+            return 0;
+
+        uint32_t value = (color * 255 + alpha / 2) / alpha;
+        return static_cast<uint8_t>(value < 255 ? value : 255);
+    }
+
+    static void PremultiplyScalar(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            uint8_t alpha = source[3];
+
+            destination[0] = PremultiplyChannel(source[0], alpha);
+            destination[1] = PremultiplyChannel(source[1], alpha);
+            destination[2] = PremultiplyChannel(source[2], alpha);
+            destination[3] = alpha;
+
+            source += 4;
+            destination += 4;
+        }
+    }
+
+    static void UnpremultiplyScalar(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            uint8_t alpha = source[3];
+
+            destination[0] = UnpremultiplyChannel(source[0], alpha);
+            destination[1] = UnpremultiplyChannel(source[1], alpha);
+            destination[2] = UnpremultiplyChannel(source[2], alpha);
+            destination[3] = alpha;
+
+            source += 4;
+            destination += 4;
+        }
+    }
+
+#ifdef PIXEL_CONVERSION_X86
+
+    //
+    // SSE2 implementations, four pixels at a time.
+    //
+
+    PIXEL_TARGET("sse2")
+    static void SwapByteOrderSse2(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        __m128i const byte1 = _mm_set1_epi32(0x0000FF00);
+        __m128i const byte2 = _mm_set1_epi32(0x00FF0000);
+
+        size_t i = 0;
+
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i * 4));
+
+            __m128i result = _mm_or_si128(
+                _mm_or_si128(_mm_slli_epi32(v, 24), _mm_srli_epi32(v, 24)),
+                _mm_or_si128(_mm_and_si128(_mm_slli_epi32(v, 8), byte2), _mm_and_si128(_mm_srli_epi32(v, 8), byte1)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), result);
+        }
+
+        SwapByteOrderScalar(source + i * 4, destination + i * 4, pixelCount - i);
+    }
+
+    // Premultiplies two pixels that have been widened to 16 bits per channel.
+    PIXEL_TARGET("sse2")
+    static inline __m128i PremultiplyWidePixelsSse2(__m128i pixels)
+    {
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xFF), 0xFF);
+        __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    PIXEL_TARGET("sse2")
+    static void PremultiplySse2(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        __m128i const zero = _mm_setzero_si128();
+        __m128i const alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+        size_t i = 0;
+
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i * 4));
+
+            __m128i lo = PremultiplyWidePixelsSse2(_mm_unpacklo_epi8(v, zero));
+            __m128i hi = PremultiplyWidePixelsSse2(_mm_unpackhi_epi8(v, zero));
+
+            __m128i result = _mm_or_si128(
+                _mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi)),
+                _mm_and_si128(alphaMask, v));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), result);
+        }
+
+        PremultiplyScalar(source + i * 4, destination + i * 4, pixelCount - i);
+    }
+
+    //
+    // Unpremultiplies one pixel that has been widened to 32 bits per channel.
+    // The numerator never exceeds 2^24, so the single precision division is
+    // exact enough for truncation to give the same answer as integer division.
+    //
+    PIXEL_TARGET("sse2")
+    static inline __m128i UnpremultiplyWidePixelSse2(__m128i pixel)
+    {
+        __m128i alpha = _mm_shuffle_epi32(pixel, 0xFF);
+
+        __m128i numerator = _mm_add_epi32(
+            _mm_sub_epi32(_mm_slli_epi32(pixel, 8), pixel),
+            _mm_srli_epi32(alpha, 1));
+
+        // Avoid dividing by zero; these pixels are cleared by the caller.
+        __m128i divisor = _mm_or_si128(alpha, _mm_and_si128(_mm_cmpeq_epi32(alpha, _mm_setzero_si128()), _mm_set1_epi32(1)));
+
+        return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(numerator), _mm_cvtepi32_ps(divisor)));
+    }
+
+    PIXEL_TARGET("sse2")
+    static void UnpremultiplySse2(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        __m128i const zero = _mm_setzero_si128();
+        __m128i const alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+        size_t i = 0;
+
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i * 4));
+
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+            __m128i p0 = UnpremultiplyWidePixelSse2(_mm_unpacklo_epi16(lo, zero));
+            __m128i p1 = UnpremultiplyWidePixelSse2(_mm_unpackhi_epi16(lo, zero));
+            __m128i p2 = UnpremultiplyWidePixelSse2(_mm_unpacklo_epi16(hi, zero));
+            __m128i p3 = UnpremultiplyWidePixelSse2(_mm_unpackhi_epi16(hi, zero));
+
+            // Saturating packs clamp the results to 255.
+            __m128i packed = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+
+            __m128i alpha = _mm_and_si128(alphaMask, v);
+            __m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+
+            __m128i result = _mm_andnot_si128(
+                transparent,
+                _mm_or_si128(_mm_andnot_si128(alphaMask, packed), alpha));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 4), result);
+        }
+
+        UnpremultiplyScalar(source + i * 4, destination + i * 4, pixelCount - i);
+    }
+
+    //
+    // AVX2 implementations, eight pixels at a time.
+    //
+
+    PIXEL_TARGET("avx2")
+    static void SwapByteOrderAvx2(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        __m256i const shuffle = _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+        size_t i = 0;
+
+        for (; i + 8 <= pixelCount; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4), _mm256_shuffle_epi8(v, shuffle));
+        }
+
+        SwapByteOrderScalar(source + i * 4, destination + i * 4, pixelCount - i);
+    }
+
+    PIXEL_TARGET("avx2")
+    static inline __m256i PremultiplyWidePixelsAvx2(__m256i pixels)
+    {
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, 0xFF), 0xFF);
+        __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    PIXEL_TARGET("avx2")
+    static void PremultiplyAvx2(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        __m256i const zero = _mm256_setzero_si256();
+        __m256i const alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+
+        size_t i = 0;
+
+        for (; i + 8 <= pixelCount; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i * 4));
+
+            // Unpacking and packing both work within 128 bit lanes, so the
+            // pixels come back out in their original order.
+            __m256i lo = PremultiplyWidePixelsAvx2(_mm256_unpacklo_epi8(v, zero));
+            __m256i hi = PremultiplyWidePixelsAvx2(_mm256_unpackhi_epi8(v, zero));
+
+            __m256i result = _mm256_or_si256(
+                _mm256_andnot_si256(alphaMask, _mm256_packus_epi16(lo, hi)),
+                _mm256_and_si256(alphaMask, v));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4), result);
+        }
+
+        PremultiplyScalar(source + i * 4, destination + i * 4, pixelCount - i);
+    }
+
+    // Unpremultiplies two pixels that have been widened to 32 bits per channel.
+    PIXEL_TARGET("avx2")
+    static inline __m256i UnpremultiplyWidePixelsAvx2(__m256i pixels)
+    {
+        __m256i alpha = _mm256_shuffle_epi32(pixels, 0xFF);
+
+        __m256i numerator = _mm256_add_epi32(
+            _mm256_sub_epi32(_mm256_slli_epi32(pixels, 8), pixels),
+            _mm256_srli_epi32(alpha, 1));
+
+        __m256i divisor = _mm256_max_epi32(alpha, _mm256_set1_epi32(1));
+
+        return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(numerator), _mm256_cvtepi32_ps(divisor)));
+    }
+
+    PIXEL_TARGET("avx2")
+    static void UnpremultiplyAvx2(uint8_t const* source, uint8_t* destination, size_t pixelCount)
+    {
+        __m256i const zero = _mm256_setzero_si256();
+        __m256i const alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+        __m256i const order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        size_t i = 0;
+
+        for (; i + 8 <= pixelCount; i += 8)
+        {
+            uint8_t const* s = source + i * 4;
+
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(s));
+
+            __m256i p01 = UnpremultiplyWidePixelsAvx2(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(s))));
+            __m256i p23 = UnpremultiplyWidePixelsAvx2(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(s + 8))));
+            __m256i p45 = UnpremultiplyWidePixelsAvx2(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(s + 16))));
+            __m256i p67 = UnpremultiplyWidePixelsAvx2(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(s + 24))));
+
+            // The lane-wise packs leave the pixels in the order 0 2 4 6 1 3 5 7.
+            __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(p01, p23), _mm256_packs_epi32(p45, p67));
+            packed = _mm256_permutevar8x32_epi32(packed, order);
+
+            __m256i alpha = _mm256_and_si256(alphaMask, v);
+            __m256i transparent = _mm256_cmpeq_epi32(alpha, zero);
+
+            __m256i result = _mm256_andnot_si256(
+                transparent,
+                _mm256_or_si256(_mm256_andnot_si256(alphaMask, packed), alpha));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * 4), result);
+        }
+
+        UnpremultiplyScalar(source + i * 4, destination + i * 4, pixelCount - i);
+    }
+
+    struct CpuFeatures
+    {
+        bool Sse2;
+        bool Avx2;
+    };
+
+    static CpuFeatures DetectCpuFeatures()
+    {
+        CpuFeatures features{};
+
+#ifdef _MSC_VER
+        int info[4];
+
+        __cpuid(info, 0);
+        int maximumLeaf = info[0];
+
+        __cpuid(info, 1);
+        features.Sse2 = (info[3] & (1 << 26)) != 0;
+
+        bool osSavesAvxState = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+
+        // The OS must also save the YMM registers on context switches.
+        if (avx && osSavesAvxState && maximumLeaf >= 7)
+        {
+            if ((_xgetbv(0) & 6) == 6)
+            {
+                __cpuidex(info, 7, 0);
+                features.Avx2 = (info[1] & (1 << 5)) != 0;
+            }
+        }
+#else
+        __builtin_cpu_init();
+        features.Sse2 = __builtin_cpu_supports("sse2") != 0;
+        features.Avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+
+        return features;
+    }
+
+    static CpuFeatures const& GetCpuFeatures()
+    {
+        static CpuFeatures const features = DetectCpuFeatures();
+        return features;
+    }
+
+#endif // PIXEL_CONVERSION_X86
+
+    bool IsSupported(InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+        case InstructionSet::Scalar:
+            return true;
+
+#ifdef PIXEL_CONVERSION_X86
+        case InstructionSet::Sse2:
+            return GetCpuFeatures().Sse2;
+
+        case InstructionSet::Avx2:
+            return GetCpuFeatures().Avx2;
+#endif
+
+        default:
+            return false;
+        }
+    }
+
+    InstructionSet GetBestInstructionSet()
+    {
+        if (IsSupported(InstructionSet::Avx2))
+            return InstructionSet::Avx2;
+
+        if (IsSupported(InstructionSet::Sse2))
+            return InstructionSet::Sse2;
+
+        return InstructionSet::Scalar;
+    }
+
+    Kernels const& GetKernels(InstructionSet instructionSet)
+    {
+        static Kernels const scalarKernels{ SwapByteOrderScalar, PremultiplyScalar, UnpremultiplyScalar };
+
+#ifdef PIXEL_CONVERSION_X86
+        static Kernels const sse2Kernels{ SwapByteOrderSse2, PremultiplySse2, UnpremultiplySse2 };
+        static Kernels const avx2Kernels{ SwapByteOrderAvx2, PremultiplyAvx2, UnpremultiplyAvx2 };
+
+        if (IsSupported(instructionSet))
+        {
+            switch (instructionSet)
+            {
+            case InstructionSet::Sse2: return sse2Kernels;
+            case InstructionSet::Avx2: return avx2Kernels;
+            default: break;
+            }
+        }
+#else
+        UNREFERENCED_PARAMETER(instructionSet);
+#endif
+
+        return scalarKernels;
+    }
+
+    Kernels const& GetKernels()
+    {
+        static Kernels const& kernels = GetKernels(GetBestInstructionSet());
+        return kernels;
+    }
+
+    void CopyRows(
+        uint8_t const* source,
+        uint32_t sourceStride,
+        uint8_t* destination,
+        uint32_t destinationStride,
+        uint32_t bytesPerRow,
+        uint32_t rowCount)
+    {
+        if (sourceStride == bytesPerRow && destinationStride == bytesPerRow)
+        {
+            memcpy(destination, source, static_cast<size_t>(bytesPerRow) * rowCount);
+            return;
+        }
+
+        for (uint32_t row = 0; row < rowCount; ++row)
+        {
+            memcpy(destination, source, bytesPerRow);
+
+            source += sourceStride;
+            destination += destinationStride;
+        }
+    }
+
+    void SwapByteOrderRows(
+        uint8_t const* source,
+        uint32_t sourceStride,
+        uint8_t* destination,
+        uint32_t destinationStride,
+        uint32_t widthInPixels,
+        uint32_t rowCount)
+    {
+        auto swapByteOrder = GetKernels().SwapByteOrder;
+
+        uint32_t bytesPerRow = widthInPixels * 4;
+
+        if (sourceStride == bytesPerRow && destinationStride == bytesPerRow)
+        {
+            swapByteOrder(source, destination, static_cast<size_t>(widthInPixels) * rowCount);
+            return;
+        }
+
+        for (uint32_t row = 0; row < rowCount; ++row)
+        {
+            swapByteOrder(source, destination, widthInPixels);
+
+            source += sourceStride;
+            destination += destinationStride;
+        }
+    }
+}}}}}
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // Kernels for converting 32 bit per pixel formats on the CPU, with SSE2
+    // and AVX2 implementations chosen at runtime according to what the CPU
+    // supports.  Every implementation produces bit-identical results.
+    //
+    // The kernels only depend on the C++ standard library and compiler
+    // intrinsics, so they can be built and tested outside of Win2D.
+    //
+    namespace PixelConversion
+    {
+        enum class InstructionSet
+        {
+            Scalar,
+            Sse2,
+            Avx2,
+        };
+
+        struct Kernels
+        {
+            //
+            // Reverses the order of the four bytes in each pixel.  This
+            // converts B8G8R8A8 to the A,R,G,B layout of Windows.UI.Color, and
+            // back again.
+            //
+            void (*SwapByteOrder)(uint8_t const* source, uint8_t* destination, size_t pixelCount);
+
+            //
+            // Convert between straight and premultiplied alpha, for formats
+            // that store alpha in the last byte (B8G8R8A8 or R8G8B8A8).
+            //
+            // Premultiply computes round(color * alpha / 255).  Unpremultiply
+            // computes round(color * 255 / alpha), clamped to 255, and sets
+            // color to zero when alpha is zero.
+            //
+            void (*Premultiply)(uint8_t const* source, uint8_t* destination, size_t pixelCount);
+            void (*Unpremultiply)(uint8_t const* source, uint8_t* destination, size_t pixelCount);
+        };
+
+        //
+        // Source and destination may be the same buffer, but must not
+        // otherwise overlap.  Neither needs to be aligned.
+        //
+        Kernels const& GetKernels();
+        Kernels const& GetKernels(InstructionSet instructionSet);
+
+        bool IsSupported(InstructionSet instructionSet);
+        InstructionSet GetBestInstructionSet();
+
+        //
+        // Copies rowCount rows of bytesPerRow bytes.  This collapses into a
+        // single copy when neither image has padding at the end of its rows.
+        //
+        void CopyRows(
+            uint8_t const* source,
+            uint32_t sourceStride,
+            uint8_t* destination,
+            uint32_t destinationStride,
+            uint32_t bytesPerRow,
+            uint32_t rowCount);
+
+        //
+        // SwapByteOrder applied to a rectangle of pixels.
+        //
+        void SwapByteOrderRows(
+            uint8_t const* source,
+            uint32_t sourceStride,
+            uint8_t* destination,
+            uint32_t destinationStride,
+            uint32_t widthInPixels,
+            uint32_t rowCount);
+    }
+}}}}
@@ -27,67 +27,81 @@
 #include "svg/CanvasSvgStrokeDashArrayAttribute.h"
 
 
-std::unordered_map<IUnknown*, WeakRef> ResourceManager::m_resources;
-std::recursive_mutex ResourceManager::m_mutex;
+ResourceManager::Shard ResourceManager::m_shards[ResourceManager::ShardCount];
+std::recursive_mutex ResourceManager::m_creationMutex;
+
+std::unordered_map<void const*, std::vector<size_t>> ResourceManager::m_probeCache;
+ReaderWriterLock ResourceManager::m_probeCacheLock;
 
 // When adding new types here, please also update the "Types that support interop" table in winrt\docsrc\Interop.aml.
-std::vector<ResourceManager::TryCreateFunction> ResourceManager::tryCreateFunctions =
+std::vector<ResourceManager::TypeEntry> ResourceManager::m_typeTable =
 {
-    TryCreate<ID2D1Device1,                CanvasDevice,                      MakeWrapper>,
-    TryCreate<ID2D1DeviceContext1,         CanvasDrawingSession,              MakeWrapper>,
-    TryCreate<ID2D1Bitmap1,                CanvasRenderTarget,                MakeWrapperWithDevice,  IsRenderTargetBitmap>,
-    TryCreate<ID2D1Bitmap1,                CanvasBitmap,                      MakeWrapperWithDevice>,
-    TryCreate<ID2D1CommandList,            CanvasCommandList,                 MakeWrapperWithDevice>,
-    TryCreate<IDXGISwapChain1,             CanvasSwapChain,                   MakeWrapperWithDeviceAndDpi>,
-    TryCreate<ID2D1Geometry,               CanvasGeometry,                    MakeWrapperWithDevice>,
-    TryCreate<ID2D1GeometryRealization,    CanvasCachedGeometry,              MakeWrapperWithDevice>,
-    TryCreate<DWriteTextLayoutType,        CanvasTextLayout,                  MakeWrapperWithDevice>,
-    TryCreate<IDWriteTextFormat1,          CanvasTextFormat,                  MakeWrapper>,
-    TryCreate<ID2D1StrokeStyle1,           CanvasStrokeStyle,                 MakeWrapper>,
-    TryCreate<ID2D1SolidColorBrush,        CanvasSolidColorBrush,             MakeWrapperWithDevice>,
-    TryCreate<ID2D1LinearGradientBrush,    CanvasLinearGradientBrush,         MakeWrapperWithDevice>,
-    TryCreate<ID2D1RadialGradientBrush,    CanvasRadialGradientBrush,         MakeWrapperWithDevice>,
-    TryCreate<ID2D1ImageBrush,             CanvasImageBrush,                  MakeWrapperWithDevice>,
-    TryCreate<ID2D1BitmapBrush1,           CanvasImageBrush,                  MakeWrapperWithDevice>,
+    Entry<ID2D1Device1,                CanvasDevice,                      MakeWrapper>(),
+    Entry<ID2D1DeviceContext1,         CanvasDrawingSession,              MakeWrapper>(),
+    Entry<ID2D1Bitmap1,                CanvasRenderTarget,                MakeWrapperWithDevice,  IsRenderTargetBitmap>(),
+    Entry<ID2D1Bitmap1,                CanvasBitmap,                      MakeWrapperWithDevice>(),
+    Entry<ID2D1CommandList,            CanvasCommandList,                 MakeWrapperWithDevice>(),
+    Entry<IDXGISwapChain1,             CanvasSwapChain,                   MakeWrapperWithDeviceAndDpi>(),
+    Entry<ID2D1Geometry,               CanvasGeometry,                    MakeWrapperWithDevice>(),
+    Entry<ID2D1GeometryRealization,    CanvasCachedGeometry,              MakeWrapperWithDevice>(),
+    Entry<DWriteTextLayoutType,        CanvasTextLayout,                  MakeWrapperWithDevice>(),
+    Entry<IDWriteTextFormat1,          CanvasTextFormat,                  MakeWrapper>(),
+    Entry<ID2D1StrokeStyle1,           CanvasStrokeStyle,                 MakeWrapper>(),
+    Entry<ID2D1SolidColorBrush,        CanvasSolidColorBrush,             MakeWrapperWithDevice>(),
+    Entry<ID2D1LinearGradientBrush,    CanvasLinearGradientBrush,         MakeWrapperWithDevice>(),
+    Entry<ID2D1RadialGradientBrush,    CanvasRadialGradientBrush,         MakeWrapperWithDevice>(),
+    Entry<ID2D1ImageBrush,             CanvasImageBrush,                  MakeWrapperWithDevice>(),
+    Entry<ID2D1BitmapBrush1,           CanvasImageBrush,                  MakeWrapperWithDevice>(),
 #if WINVER > _WIN32_WINNT_WINBLUE
-    TryCreate<ID2D1GradientMesh,           CanvasGradientMesh,                MakeWrapperWithDevice>,
-    TryCreate<ID2D1ImageSource,            CanvasVirtualBitmap,               MakeWrapperWithDevice>,
-    TryCreate<ID2D1TransformedImageSource, CanvasVirtualBitmap,               MakeWrapperWithDevice>,
-    TryCreate<ID2D1LookupTable3D,          EffectTransferTable3D,             MakeWrapperWithDevice>,
-    TryCreate<IDWriteRenderingParams3,     CanvasTextRenderingParameters,     MakeWrapper>,
-    TryCreate<IDWriteFontSet,              CanvasFontSet,                     MakeWrapper>,
-    TryCreate<IDWriteFontFaceReference,    CanvasFontFace,                    MakeWrapper>,
-    TryCreate<ID2D1SvgDocument,            CanvasSvgDocument,                 MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgElement,             CanvasSvgTextElement,              MakeWrapperWithDevice,  IsSvgTextElement>,
-    TryCreate<ID2D1SvgElement,             CanvasSvgNamedElement,             MakeWrapperWithDevice>,
-
-    TryCreate<ID2D1SvgPaint,               CanvasSvgPaintAttribute,           MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgPathData,            CanvasSvgPathAttribute,            MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgPointCollection,     CanvasSvgPointsAttribute,          MakeWrapperWithDevice>,
-    TryCreate<ID2D1SvgStrokeDashArray,     CanvasSvgStrokeDashArrayAttribute, MakeWrapperWithDevice>,
+    Entry<ID2D1GradientMesh,           CanvasGradientMesh,                MakeWrapperWithDevice>(),
+    Entry<ID2D1ImageSource,            CanvasVirtualBitmap,               MakeWrapperWithDevice>(),
+    Entry<ID2D1TransformedImageSource, CanvasVirtualBitmap,               MakeWrapperWithDevice>(),
+    Entry<ID2D1LookupTable3D,          EffectTransferTable3D,             MakeWrapperWithDevice>(),
+    Entry<IDWriteRenderingParams3,     CanvasTextRenderingParameters,     MakeWrapper>(),
+    Entry<IDWriteFontSet,              CanvasFontSet,                     MakeWrapper>(),
+    Entry<IDWriteFontFaceReference,    CanvasFontFace,                    MakeWrapper>(),
+    Entry<ID2D1SvgDocument,            CanvasSvgDocument,                 MakeWrapperWithDevice>(),
+    Entry<ID2D1SvgElement,             CanvasSvgTextElement,              MakeWrapperWithDevice,  IsSvgTextElement>(),
+    Entry<ID2D1SvgElement,             CanvasSvgNamedElement,             MakeWrapperWithDevice>(),
+
+    Entry<ID2D1SvgPaint,               CanvasSvgPaintAttribute,           MakeWrapperWithDevice>(),
+    Entry<ID2D1SvgPathData,            CanvasSvgPathAttribute,            MakeWrapperWithDevice>(),
+    Entry<ID2D1SvgPointCollection,     CanvasSvgPointsAttribute,          MakeWrapperWithDevice>(),
+    Entry<ID2D1SvgStrokeDashArray,     CanvasSvgStrokeDashArrayAttribute, MakeWrapperWithDevice>(),
 #else
-    TryCreate<IDWriteRenderingParams2,     CanvasTextRenderingParameters, MakeWrapper>,
-    TryCreate<IDWriteFontCollection,       CanvasFontSet,                 MakeWrapper>,
-    TryCreate<IDWriteFont2,                CanvasFontFace,                MakeWrapper>,
+    Entry<IDWriteRenderingParams2,     CanvasTextRenderingParameters, MakeWrapper>(),
+    Entry<IDWriteFontCollection,       CanvasFontSet,                 MakeWrapper>(),
+    Entry<IDWriteFont2,                CanvasFontFace,                MakeWrapper>(),
 #endif
-    TryCreate<IDWriteTypography,           CanvasTypography,              MakeWrapper>,
-    TryCreate<IDWriteNumberSubstitution,   CanvasNumberSubstitution,      MakeWrapper>,
-    TryCreate<ID2D1ColorContext,           ColorManagementProfile,        MakeWrapperWithDevice>,
+    Entry<IDWriteTypography,           CanvasTypography,              MakeWrapper>(),
+    Entry<IDWriteNumberSubstitution,   CanvasNumberSubstitution,      MakeWrapper>(),
+    Entry<ID2D1ColorContext,           ColorManagementProfile,        MakeWrapperWithDevice>(),
 
     // Effects get their very own try-create function. These are special because ID2D1Effect
     // can map to many different Win2D wrapper types depending on its D2D1_PROPERTY_CLSID.
-    CanvasEffect::TryCreateEffect
+    { CanvasEffect::TryCreateEffect, Probe<ID2D1Effect> }
 };
 
 
+ResourceManager::Shard& ResourceManager::GetShard(IUnknown* resourceIdentity)
+{
+    // Heap allocations are at least 16 byte aligned, so the low bits of the pointer carry no information.
+    auto value = reinterpret_cast<uintptr_t>(resourceIdentity) >> 4;
+
+    return m_shards[(value ^ (value >> 8)) % ShardCount];
+}
+
+
 // Called by the ResourceWrapper constructor, to add itself to the interop mapping table.
 void ResourceManager::Add(IUnknown* resource, IInspectable* wrapper)
 {
     ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
+    auto weakWrapper = AsWeak(wrapper);
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    auto& shard = GetShard(resourceIdentity.Get());
+    ExclusiveLock lock(shard.Lock);
 
-    auto result = m_resources.insert(std::make_pair(resourceIdentity.Get(), AsWeak(wrapper)));
+    auto result = shard.Resources.insert(std::make_pair(resourceIdentity.Get(), std::move(weakWrapper)));
 
     if (!result.second)
         ThrowHR(E_UNEXPECTED);
@@ -99,45 +113,97 @@ void ResourceManager::Remove(IUnknown* resource)
 {
     ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    auto& shard = GetShard(resourceIdentity.Get());
+    ExclusiveLock lock(shard.Lock);
 
-    auto result = m_resources.erase(resourceIdentity.Get());
+    auto result = shard.Resources.erase(resourceIdentity.Get());
 
     if (result != 1)
         ThrowHR(E_UNEXPECTED);
 }
 
 
-ComPtr<IInspectable> ResourceManager::GetOrCreate(ICanvasDevice* device, IUnknown* resource, float dpi)
+ComPtr<IInspectable> ResourceManager::TryGetExistingWrapper(IUnknown* resourceIdentity)
 {
-    ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
-    ComPtr<IInspectable> wrapper;
+    auto& shard = GetShard(resourceIdentity);
+    SharedLock lock(shard.Lock);
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    auto it = shard.Resources.find(resourceIdentity);
+
+    if (it == shard.Resources.end())
+        return nullptr;
+
+    return LockWeakRef<IInspectable>(it->second);
+}
 
-    // Do we already have a wrapper around this resource?
-    auto it = m_resources.find(resourceIdentity.Get());
 
-    if (it != m_resources.end())
+std::vector<size_t> ResourceManager::GetCandidateTypes(IUnknown* resourceIdentity)
+{
+    // All instances of the same COM class share a vtable, and implement the same set of interfaces.
+    auto vtable = *reinterpret_cast<void const* const*>(resourceIdentity);
+
     {
-        wrapper = LockWeakRef<IInspectable>(it->second);
+        SharedLock lock(m_probeCacheLock);
+
+        auto it = m_probeCache.find(vtable);
+
+        if (it != m_probeCache.end())
+            return it->second;
+    }
+
+    // First time we've seen this type of resource, so probe it against every entry in the type table.
+    std::vector<size_t> candidates;
+
+    for (size_t i = 0; i < m_typeTable.size(); ++i)
+    {
+        auto probe = m_typeTable[i].Probe;
+
+        if (!probe || probe(resourceIdentity))
+        {
+            candidates.push_back(i);
+        }
     }
 
+    ExclusiveLock lock(m_probeCacheLock);
+
+    m_probeCache.insert(std::make_pair(vtable, candidates));
+
+    return candidates;
+}
+
+
+ComPtr<IInspectable> ResourceManager::GetOrCreate(ICanvasDevice* device, IUnknown* resource, float dpi)
+{
+    ComPtr<IUnknown> resourceIdentity = AsUnknown(resource);
+
+    // Do we already have a wrapper around this resource?
+    auto wrapper = TryGetExistingWrapper(resourceIdentity.Get());
+
     // Create a new wrapper instance?
     if (!wrapper)
     {
-        for (auto& tryCreateFunction : tryCreateFunctions)
+        std::lock_guard<std::recursive_mutex> lock(m_creationMutex);
+
+        // Another thread may have created a wrapper while we were waiting for the lock.
+        wrapper = TryGetExistingWrapper(resourceIdentity.Get());
+
+        if (!wrapper)
         {
-            if (tryCreateFunction(device, resource, dpi, &wrapper))
+            // Only the try-create functions that accepted this type of resource when it was
+            // probed need to be called, in the same order as they appear in the type table.
+            for (auto typeIndex : GetCandidateTypes(resourceIdentity.Get()))
             {
-                break;
+                if (m_typeTable[typeIndex].TryCreate(device, resource, dpi, &wrapper))
+                {
+                    break;
+                }
             }
-        }
 
-        // Fail if we did not find a way to wrap this type.
-        if (!wrapper)
-        {
-            ThrowHR(E_NOINTERFACE, Strings::ResourceManagerUnknownType);
+            // Fail if we did not find a way to wrap this type.
+            if (!wrapper)
+            {
+                ThrowHR(E_NOINTERFACE, Strings::ResourceManagerUnknownType);
+            }
         }
     }
 
@@ -207,19 +273,29 @@ void ResourceManager::ValidateDpi(ICanvasResourceWrapperWithDpi* wrapper, float
 }
 
 
-void ResourceManager::RegisterType(TryCreateFunction tryCreate)
+void ResourceManager::RegisterType(TryCreateFunction tryCreate, ProbeFunction probe)
 {
-    assert(std::find(tryCreateFunctions.begin(), tryCreateFunctions.end(), tryCreate) == tryCreateFunctions.end());
+    std::lock_guard<std::recursive_mutex> lock(m_creationMutex);
+
+    assert(std::find_if(m_typeTable.begin(), m_typeTable.end(), [=](TypeEntry const& entry) { return entry.TryCreate == tryCreate; }) == m_typeTable.end());
+
+    m_typeTable.push_back(TypeEntry{ tryCreate, probe });
 
-    tryCreateFunctions.push_back(tryCreate);
+    ExclusiveLock probeCacheLock(m_probeCacheLock);
+    m_probeCache.clear();
 }
 
 
 void ResourceManager::UnregisterType(TryCreateFunction tryCreate)
 {
-    auto it = std::find(tryCreateFunctions.begin(), tryCreateFunctions.end(), tryCreate);
+    std::lock_guard<std::recursive_mutex> lock(m_creationMutex);
+
+    auto it = std::find_if(m_typeTable.begin(), m_typeTable.end(), [=](TypeEntry const& entry) { return entry.TryCreate == tryCreate; });
+
+    assert(it != m_typeTable.end());
 
-    assert(it != tryCreateFunctions.end());
+    m_typeTable.erase(it);
 
-    tryCreateFunctions.erase(it);
+    ExclusiveLock probeCacheLock(m_probeCacheLock);
+    m_probeCache.clear();
 }
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "utils/LockUtilities.h"
+
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 {
     class __declspec(uuid("D8CF19FE-8064-423E-B649-8B458BA86116"))
@@ -64,8 +66,24 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
         typedef bool(*TryCreateFunction)(ICanvasDevice* device, IUnknown* resource, float dpi, ComPtr<IInspectable>* result);
 
 
-        // Allow unit tests to inject additional try-create functions.
-        static void RegisterType(TryCreateFunction tryCreate);
+        // A probe function reports whether a try-create function could possibly accept a resource, looking only
+        // at which interfaces the resource implements (not at any per-instance state checked by a tester function).
+        // Probe results are cached per resource type, so after the first resource of a given type has been seen,
+        // wrapping others of that type only calls the handful of try-create functions that are worth trying.
+
+        typedef bool(*ProbeFunction)(IUnknown* resource);
+
+        template<typename TResource>
+        static bool Probe(IUnknown* resource)
+        {
+            ComPtr<TResource> myTypeOfResource;
+            return SUCCEEDED(resource->QueryInterface(IID_PPV_ARGS(&myTypeOfResource)));
+        }
+
+
+        // Allow unit tests to inject additional try-create functions. If no probe is specified the
+        // try-create function is considered a candidate for every type of resource.
+        static void RegisterType(TryCreateFunction tryCreate, ProbeFunction probe = nullptr);
         static void UnregisterType(TryCreateFunction tryCreate);
 
 
@@ -154,11 +172,46 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
 
 
     private:
-        // Native resource -> WinRT wrapper map, shared by all active resources.
-        static std::unordered_map<IUnknown*, WeakRef> m_resources;
-        static std::recursive_mutex m_mutex;
+        struct TypeEntry
+        {
+            TryCreateFunction TryCreate;
+            ProbeFunction Probe;
+        };
+
+        template<typename TResource, typename TWrapper, typename TMaker, bool TTester(TResource*) = DefaultTester<TResource>>
+        static TypeEntry Entry()
+        {
+            return TypeEntry{ TryCreate<TResource, TWrapper, TMaker, TTester>, Probe<TResource> };
+        }
+
+        // Native resource -> WinRT wrapper map, shared by all active resources. This is split into
+        // shards (picked by hashing the resource identity pointer) so that threads wrapping different
+        // resources don't contend on a single lock, and lookups only take a shared lock on one shard.
+        static const size_t ShardCount = 64;
+
+        struct Shard
+        {
+            ReaderWriterLock Lock;
+            std::unordered_map<IUnknown*, WeakRef> Resources;
+        };
+
+        static Shard m_shards[ShardCount];
+
+        static Shard& GetShard(IUnknown* resourceIdentity);
+
+        // Creating new wrappers is serialized, so that two threads can't race to wrap the same
+        // resource. This is recursive because wrapper constructors may themselves wrap other resources.
+        static std::recursive_mutex m_creationMutex;
 
         // Table of try-create functions, one per type.
-        static std::vector<TryCreateFunction> tryCreateFunctions;
+        static std::vector<TypeEntry> m_typeTable;
+
+        // Caches, for each type of native resource (identified by the vtable of its IUnknown identity),
+        // the indices of m_typeTable entries whose probe accepted that type.
+        static std::unordered_map<void const*, std::vector<size_t>> m_probeCache;
+        static ReaderWriterLock m_probeCacheLock;
+
+        static std::vector<size_t> GetCandidateTypes(IUnknown* resourceIdentity);
+        static ComPtr<IInspectable> TryGetExistingWrapper(IUnknown* resourceIdentity);
     };
 }}}}
@@ -59,6 +59,7 @@ STRING(NotSupportedOnThisVersionOfWindows, L"This API is not supported on this v
 STRING(PathBuilderAddGeometryMidFigure, L"CanvasPathBuilder.AddGeometry may not be called in the middle of a figure.")
 STRING(PathBuilderClosedMidFigure, L"There was an attempt to use a CanvasPathBuilder, which was missing a call to CanvasPathBuilder.EndFigure.")
 STRING(PixelColorsFormatRestriction, L"This method only supports resources with pixel format DirectXPixelFormat.B8G8R8A8UIntNormalized.")
+STRING(PixelReadbackWrongDevice, L"The bitmap is associated with a different device than this CanvasPixelReadback.")
 STRING(PoppedWrongLayer, L"Attempting to close a CanvasActiveLayer that is not top of the stack. The most recently created layer must be closed first.")
 STRING(RemoteFontUnavailable, L"The requested font is not locally available.")
 STRING(ResourceManagerNoDevice, L"To wrap this resource type, a device parameter must be passed to GetOrCreate.")
@@ -78,6 +79,7 @@ STRING(SvgNotAvailable, L"SVG features are not supported on this version of Wind
 STRING(SvgStrokeDashArrayMismatchingArraySizes, L"The two arrays used for setting CanvasStrokeDashArrayAttribute units and values must be the same size.")
 STRING(SvgTextShouldHaveNonZeroLength, L"The specified SVG string has length zero; a valid SVG string was expected.")
 STRING(SvgViewportSizeNotValid, L"The width and height of an SVG viewport must be positive, and nonzero.")
+STRING(TessellationBufferTooSmall, L"The buffer needs a capacity of %llu bytes to hold the tessellated triangles; actual capacity was %u bytes.")
 STRING(TextRendererNotValid, L"The application called a method on a text renderer, but this text renderer is no longer valid.")
 STRING(TwoBeginFigures, L"A call to CanvasPathBuilder.BeginFigure occurred, when the figure was already begun.")
 STRING(UnrecognizedImageFileExtension, L"When saving a CanvasBitmap without specifying a CanvasBitmapFileFormat, the file name must include a recognized file extension such as '.jpeg' or '.png'.")
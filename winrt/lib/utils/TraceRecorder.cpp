@@ -0,0 +1,273 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "TraceRecorder.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+std::atomic<ITraceSink*> Tracing::s_sink;
+
+
+//
+// TraceRecorder implementation
+//
+
+namespace
+{
+    // Session ids are unique across all recorders, so a single cached buffer
+    // per thread is enough to tell whether it belongs to the current recording.
+    std::atomic<uint64_t> g_nextSessionId(1);
+
+    struct ThreadBufferCache
+    {
+        uint64_t SessionId;
+        std::shared_ptr<TraceRecorder::ThreadBuffer> Buffer;
+    };
+
+    thread_local ThreadBufferCache t_threadBufferCache;
+
+    int64_t GetTimestamp()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    int64_t GetTimestampFrequency()
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return frequency.QuadPart;
+    }
+}
+
+
+TraceRecorder::ThreadBuffer::ThreadBuffer(uint32_t capacity)
+    : m_events(new Event[capacity])
+    , m_capacity(capacity)
+    , m_count(0)
+    , m_droppedCount(0)
+    , m_threadId(GetCurrentThreadId())
+{
+}
+
+
+void TraceRecorder::ThreadBuffer::Add(Event const& event)
+{
+    auto count = m_count.load(std::memory_order_relaxed);
+
+    if (count == m_capacity)
+    {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_events[count] = event;
+
+    // Publishes the event to readers on other threads.
+    m_count.store(count + 1, std::memory_order_release);
+}
+
+
+TraceRecorder::TraceRecorder(uint32_t eventsPerThread)
+    : m_eventsPerThread(eventsPerThread)
+    , m_sessionId(0)
+    , m_isRecording(false)
+    , m_startTime(0)
+{
+}
+
+
+void TraceRecorder::Start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Threads still holding buffers from an earlier recording keep them alive
+    // until they next write an event, so these can be released straight away.
+    m_buffers.clear();
+
+    m_startTime = GetTimestamp();
+    m_sessionId.store(g_nextSessionId.fetch_add(1), std::memory_order_release);
+    m_isRecording.store(true, std::memory_order_release);
+}
+
+
+void TraceRecorder::Stop()
+{
+    m_isRecording.store(false, std::memory_order_release);
+}
+
+
+bool TraceRecorder::IsRecording() const
+{
+    return m_isRecording.load(std::memory_order_acquire);
+}
+
+
+void TraceRecorder::WriteEvent(char const* name, TracePhase phase)
+{
+    if (!m_isRecording.load(std::memory_order_acquire))
+        return;
+
+    auto buffer = GetBufferForCurrentThread(m_sessionId.load(std::memory_order_acquire));
+
+    buffer->Add(Event{ GetTimestamp(), name, phase });
+}
+
+
+TraceRecorder::ThreadBuffer* TraceRecorder::GetBufferForCurrentThread(uint64_t sessionId)
+{
+    auto& cache = t_threadBufferCache;
+
+    if (cache.SessionId != sessionId || !cache.Buffer)
+    {
+        auto buffer = std::make_shared<ThreadBuffer>(m_eventsPerThread);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // If a new recording started in the meantime, this event belongs
+            // to the old one and is simply not kept.
+            if (m_sessionId.load(std::memory_order_relaxed) == sessionId)
+                m_buffers.push_back(buffer);
+        }
+
+        cache.SessionId = sessionId;
+        cache.Buffer = std::move(buffer);
+    }
+
+    return cache.Buffer.get();
+}
+
+
+std::wstring TraceRecorder::GetChromeTraceJson()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto microsecondsPerTick = 1000000.0 / GetTimestampFrequency();
+    auto processId = GetCurrentProcessId();
+
+    std::wstring json = L"{\"traceEvents\":[";
+    bool isFirst = true;
+
+    for (auto& buffer : m_buffers)
+    {
+        auto count = buffer->GetCount();
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto& event = buffer->GetEvent(i);
+
+            wchar_t entry[256];
+            ThrowIfFailed(StringCchPrintf(
+                entry,
+                _countof(entry),
+                L"%s\n{\"name\":\"%S\",\"ph\":\"%c\",%s\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+                isFirst ? L"" : L",",
+                event.Name,
+                static_cast<wchar_t>(event.Phase),
+                event.Phase == TracePhase::Instant ? L"\"s\":\"t\"," : L"",
+                processId,
+                buffer->GetThreadId(),
+                (event.Timestamp - m_startTime) * microsecondsPerTick));
+
+            json += entry;
+            isFirst = false;
+        }
+    }
+
+    uint32_t droppedCount = 0;
+    for (auto& buffer : m_buffers)
+        droppedCount += buffer->GetDroppedCount();
+
+    wchar_t footer[128];
+    ThrowIfFailed(StringCchPrintf(
+        footer,
+        _countof(footer),
+        L"\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":\"%u\"}}",
+        droppedCount));
+
+    json += footer;
+
+    return json;
+}
+
+
+uint32_t TraceRecorder::GetDroppedEventCount()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    uint32_t droppedCount = 0;
+    for (auto& buffer : m_buffers)
+        droppedCount += buffer->GetDroppedCount();
+
+    return droppedCount;
+}
+
+
+TraceRecorder& TraceRecorder::GetProcessRecorder()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+
+//
+// CanvasTraceRecorderStatics implementation
+//
+
+ActivatableStaticOnlyFactory(CanvasTraceRecorderStatics);
+
+IFACEMETHODIMP CanvasTraceRecorderStatics::Start()
+{
+    return ExceptionBoundary([&]
+    {
+        auto& recorder = TraceRecorder::GetProcessRecorder();
+
+        recorder.Start();
+        Tracing::SetSink(&recorder);
+    });
+}
+
+IFACEMETHODIMP CanvasTraceRecorderStatics::Stop()
+{
+    return ExceptionBoundary([&]
+    {
+        auto& recorder = TraceRecorder::GetProcessRecorder();
+
+        Tracing::ClearSink(&recorder);
+        recorder.Stop();
+    });
+}
+
+IFACEMETHODIMP CanvasTraceRecorderStatics::get_IsRecording(boolean* value)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(value);
+
+        *value = TraceRecorder::GetProcessRecorder().IsRecording();
+    });
+}
+
+IFACEMETHODIMP CanvasTraceRecorderStatics::get_DroppedEventCount(UINT32* value)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckInPointer(value);
+
+        *value = TraceRecorder::GetProcessRecorder().GetDroppedEventCount();
+    });
+}
+
+IFACEMETHODIMP CanvasTraceRecorderStatics::GetChromeTraceJson(HSTRING* value)
+{
+    return ExceptionBoundary([&]
+    {
+        CheckAndClearOutPointer(value);
+
+        WinString(TraceRecorder::GetProcessRecorder().GetChromeTraceJson()).CopyTo(value);
+    });
+}
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    //
+    // Records the events written through Tracing.h in memory, so that
+    // automated perf runs can capture traces without an ETW session.
+    //
+    // Each thread writes to its own fixed size buffer, so recording an event
+    // takes no locks.  The writing thread publishes each event by advancing
+    // the buffer's count, which lets GetChromeTraceJson read a consistent
+    // prefix of every buffer while recording continues.  Events that do not
+    // fit are dropped and counted.
+    //
+    class TraceRecorder : public ITraceSink
+    {
+    public:
+        static const uint32_t DefaultEventsPerThread = 64 * 1024;
+
+        struct Event
+        {
+            int64_t Timestamp;
+            char const* Name;
+            TracePhase Phase;
+        };
+
+        class ThreadBuffer
+        {
+            std::unique_ptr<Event[]> m_events;
+            uint32_t m_capacity;
+            std::atomic<uint32_t> m_count;
+            std::atomic<uint32_t> m_droppedCount;
+            DWORD m_threadId;
+
+        public:
+            ThreadBuffer(uint32_t capacity);
+
+            // Only called from the owning thread.
+            void Add(Event const& event);
+
+            uint32_t GetCount() const { return m_count.load(std::memory_order_acquire); }
+            Event const& GetEvent(uint32_t index) const { return m_events[index]; }
+            uint32_t GetDroppedCount() const { return m_droppedCount.load(std::memory_order_relaxed); }
+            DWORD GetThreadId() const { return m_threadId; }
+        };
+
+    private:
+        uint32_t m_eventsPerThread;
+
+        // Identifies the current recording, so that threads notice when the
+        // buffers they cached belong to an earlier one.
+        std::atomic<uint64_t> m_sessionId;
+        std::atomic<bool> m_isRecording;
+
+        std::mutex m_mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+        int64_t m_startTime;
+
+    public:
+        TraceRecorder(uint32_t eventsPerThread = DefaultEventsPerThread);
+
+        // Discards any previously recorded events.
+        void Start();
+        void Stop();
+        bool IsRecording() const;
+
+        virtual void WriteEvent(char const* name, TracePhase phase) override;
+
+        // Formats the recorded events as Chrome trace event JSON, which can be
+        // loaded into chrome://tracing or https://ui.perfetto.dev.
+        std::wstring GetChromeTraceJson();
+
+        uint32_t GetDroppedEventCount();
+
+        // The recorder behind the CanvasTraceRecorder statics.  It lives
+        // until the module unloads, so it can safely stay installed as the
+        // trace sink.
+        static TraceRecorder& GetProcessRecorder();
+
+    private:
+        ThreadBuffer* GetBufferForCurrentThread(uint64_t sessionId);
+    };
+
+
+    class CanvasTraceRecorderStatics
+        : public AgileActivationFactory<ICanvasTraceRecorderStatics>
+    {
+        InspectableClassStatic(RuntimeClass_Microsoft_Graphics_Canvas_CanvasTraceRecorder, BaseTrust);
+
+    public:
+        IFACEMETHODIMP Start() override;
+        IFACEMETHODIMP Stop() override;
+        IFACEMETHODIMP get_IsRecording(boolean* value) override;
+        IFACEMETHODIMP get_DroppedEventCount(UINT32* value) override;
+        IFACEMETHODIMP GetChromeTraceJson(HSTRING* value) override;
+    };
+}}}}
@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+//
+// Win2D's instrumentation is written with the EventWrite_* macros generated
+// from win2d.etw.xml, which only reach ETW.  This header, included straight
+// after win2d.etw.h, wraps each of those macros so that the same call sites
+// also feed an in-process trace sink (see TraceRecorder.h).  When no sink is
+// installed the extra cost is a single atomic load.
+//
+// When adding an event to win2d.etw.xml, add a matching wrapper below.
+//
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas
+{
+    // Matches the "ph" values of the Chrome trace event format.
+    enum class TracePhase : char
+    {
+        Begin = 'B',
+        End = 'E',
+        Instant = 'i'
+    };
+
+    class ITraceSink
+    {
+    public:
+        virtual ~ITraceSink() = default;
+
+        // Called from any thread.  Name must be a string literal.
+        virtual void WriteEvent(char const* name, TracePhase phase) = 0;
+    };
+
+    class Tracing
+    {
+        static std::atomic<ITraceSink*> s_sink;
+
+    public:
+        // The sink must stay alive until it has been replaced, and until any
+        // calls that were already in flight have returned.
+        static ITraceSink* SetSink(ITraceSink* sink)
+        {
+            return s_sink.exchange(sink, std::memory_order_acq_rel);
+        }
+
+        // Uninstalls the sink, unless it has already been replaced by another.
+        static void ClearSink(ITraceSink* sink)
+        {
+            s_sink.compare_exchange_strong(sink, nullptr, std::memory_order_acq_rel);
+        }
+
+        static ITraceSink* GetSink()
+        {
+            return s_sink.load(std::memory_order_acquire);
+        }
+
+        static void WriteEvent(char const* name, TracePhase phase)
+        {
+            if (auto sink = GetSink())
+                sink->WriteEvent(name, phase);
+        }
+    };
+}}}}
+
+#define WIN2D_TRACE(name, phase) \
+    ::ABI::Microsoft::Graphics::Canvas::Tracing::WriteEvent(name, ::ABI::Microsoft::Graphics::Canvas::TracePhase::phase)
+
+//
+// Each wrapper first captures the generated ETW macro in an inline function,
+// then redefines the macro to call both that and the trace sink.
+//
+
+#define WIN2D_TRACE_START_STOP(task)                                                            \
+    inline void EtwWrite_##task##_Start() { EventWrite_##task##_Start(); }                      \
+    inline void EtwWrite_##task##_Stop() { EventWrite_##task##_Stop(); }
+
+WIN2D_TRACE_START_STOP(CanvasAnimatedControl_Tick)
+#undef EventWrite_CanvasAnimatedControl_Tick_Start
+#undef EventWrite_CanvasAnimatedControl_Tick_Stop
+#define EventWrite_CanvasAnimatedControl_Tick_Start() (EtwWrite_CanvasAnimatedControl_Tick_Start(), WIN2D_TRACE("CanvasAnimatedControl_Tick", Begin))
+#define EventWrite_CanvasAnimatedControl_Tick_Stop()  (EtwWrite_CanvasAnimatedControl_Tick_Stop(),  WIN2D_TRACE("CanvasAnimatedControl_Tick", End))
+
+WIN2D_TRACE_START_STOP(CanvasAnimatedControl_WaitForVerticalBlank)
+#undef EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Start
+#undef EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Stop
+#define EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Start() (EtwWrite_CanvasAnimatedControl_WaitForVerticalBlank_Start(), WIN2D_TRACE("CanvasAnimatedControl_WaitForVerticalBlank", Begin))
+#define EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Stop()  (EtwWrite_CanvasAnimatedControl_WaitForVerticalBlank_Stop(),  WIN2D_TRACE("CanvasAnimatedControl_WaitForVerticalBlank", End))
+
+inline void EtwWrite_CanvasAnimatedControl_Update_Start(bool areResourcesCreated, bool isPaused) { EventWrite_CanvasAnimatedControl_Update_Start(areResourcesCreated, isPaused); }
+inline void EtwWrite_CanvasAnimatedControl_Update_Stop(bool updated) { EventWrite_CanvasAnimatedControl_Update_Stop(updated); }
+#undef EventWrite_CanvasAnimatedControl_Update_Start
+#undef EventWrite_CanvasAnimatedControl_Update_Stop
+#define EventWrite_CanvasAnimatedControl_Update_Start(areResourcesCreated, isPaused) (EtwWrite_CanvasAnimatedControl_Update_Start(areResourcesCreated, isPaused), WIN2D_TRACE("CanvasAnimatedControl_Update", Begin))
+#define EventWrite_CanvasAnimatedControl_Update_Stop(updated)                        (EtwWrite_CanvasAnimatedControl_Update_Stop(updated),                        WIN2D_TRACE("CanvasAnimatedControl_Update", End))
+
+inline void EtwWrite_CanvasAnimatedControl_Draw_Start(bool invokeDrawHandlers, bool isRunningSlowly) { EventWrite_CanvasAnimatedControl_Draw_Start(invokeDrawHandlers, isRunningSlowly); }
+inline void EtwWrite_CanvasAnimatedControl_Draw_Stop() { EventWrite_CanvasAnimatedControl_Draw_Stop(); }
+#undef EventWrite_CanvasAnimatedControl_Draw_Start
+#undef EventWrite_CanvasAnimatedControl_Draw_Stop
+#define EventWrite_CanvasAnimatedControl_Draw_Start(invokeDrawHandlers, isRunningSlowly) (EtwWrite_CanvasAnimatedControl_Draw_Start(invokeDrawHandlers, isRunningSlowly), WIN2D_TRACE("CanvasAnimatedControl_Draw", Begin))
+#define EventWrite_CanvasAnimatedControl_Draw_Stop()                                     (EtwWrite_CanvasAnimatedControl_Draw_Stop(),                                     WIN2D_TRACE("CanvasAnimatedControl_Draw", End))
+
+WIN2D_TRACE_START_STOP(CanvasAnimatedControl_Present)
+#undef EventWrite_CanvasAnimatedControl_Present_Start
+#undef EventWrite_CanvasAnimatedControl_Present_Stop
+#define EventWrite_CanvasAnimatedControl_Present_Start() (EtwWrite_CanvasAnimatedControl_Present_Start(), WIN2D_TRACE("CanvasAnimatedControl_Present", Begin))
+#define EventWrite_CanvasAnimatedControl_Present_Stop()  (EtwWrite_CanvasAnimatedControl_Present_Stop(),  WIN2D_TRACE("CanvasAnimatedControl_Present", End))
+
+WIN2D_TRACE_START_STOP(CanvasDrawingSession_Create)
+#undef EventWrite_CanvasDrawingSession_Create_Start
+#undef EventWrite_CanvasDrawingSession_Create_Stop
+#define EventWrite_CanvasDrawingSession_Create_Start() (EtwWrite_CanvasDrawingSession_Create_Start(), WIN2D_TRACE("CanvasDrawingSession_Create", Begin))
+#define EventWrite_CanvasDrawingSession_Create_Stop()  (EtwWrite_CanvasDrawingSession_Create_Stop(),  WIN2D_TRACE("CanvasDrawingSession_Create", End))
+
+WIN2D_TRACE_START_STOP(CanvasDrawingSession_Close)
+#undef EventWrite_CanvasDrawingSession_Close_Start
+#undef EventWrite_CanvasDrawingSession_Close_Stop
+#define EventWrite_CanvasDrawingSession_Close_Start() (EtwWrite_CanvasDrawingSession_Close_Start(), WIN2D_TRACE("CanvasDrawingSession_Close", Begin))
+#define EventWrite_CanvasDrawingSession_Close_Stop()  (EtwWrite_CanvasDrawingSession_Close_Stop(),  WIN2D_TRACE("CanvasDrawingSession_Close", End))
+
+WIN2D_TRACE_START_STOP(CanvasEffect_Realize)
+#undef EventWrite_CanvasEffect_Realize_Start
+#undef EventWrite_CanvasEffect_Realize_Stop
+#define EventWrite_CanvasEffect_Realize_Start() (EtwWrite_CanvasEffect_Realize_Start(), WIN2D_TRACE("CanvasEffect_Realize", Begin))
+#define EventWrite_CanvasEffect_Realize_Stop()  (EtwWrite_CanvasEffect_Realize_Stop(),  WIN2D_TRACE("CanvasEffect_Realize", End))
+
+WIN2D_TRACE_START_STOP(CanvasBitmap_Load)
+#undef EventWrite_CanvasBitmap_Load_Start
+#undef EventWrite_CanvasBitmap_Load_Stop
+#define EventWrite_CanvasBitmap_Load_Start() (EtwWrite_CanvasBitmap_Load_Start(), WIN2D_TRACE("CanvasBitmap_Load", Begin))
+#define EventWrite_CanvasBitmap_Load_Stop()  (EtwWrite_CanvasBitmap_Load_Stop(),  WIN2D_TRACE("CanvasBitmap_Load", End))
+
+WIN2D_TRACE_START_STOP(CanvasSwapChain_Present)
+#undef EventWrite_CanvasSwapChain_Present_Start
+#undef EventWrite_CanvasSwapChain_Present_Stop
+#define EventWrite_CanvasSwapChain_Present_Start() (EtwWrite_CanvasSwapChain_Present_Start(), WIN2D_TRACE("CanvasSwapChain_Present", Begin))
+#define EventWrite_CanvasSwapChain_Present_Stop()  (EtwWrite_CanvasSwapChain_Present_Stop(),  WIN2D_TRACE("CanvasSwapChain_Present", End))
+
+#undef WIN2D_TRACE_START_STOP
+
+// The StepTimer events mark points in time rather than spans.
+
+inline void EtwWrite_StepTimer_Tick(bool forceUpdate, int64_t timeSpentPaused) { EventWrite_StepTimer_Tick(forceUpdate, timeSpentPaused); }
+#undef EventWrite_StepTimer_Tick
+#define EventWrite_StepTimer_Tick(forceUpdate, timeSpentPaused) (EtwWrite_StepTimer_Tick(forceUpdate, timeSpentPaused), WIN2D_TRACE("StepTimer_Tick", Instant))
+
+inline void EtwWrite_StepTimer_CloseToTargetClamp(uint64_t timeDelta, uint64_t targetElapsedTicks) { EventWrite_StepTimer_CloseToTargetClamp(timeDelta, targetElapsedTicks); }
+#undef EventWrite_StepTimer_CloseToTargetClamp
+#define EventWrite_StepTimer_CloseToTargetClamp(timeDelta, targetElapsedTicks) (EtwWrite_StepTimer_CloseToTargetClamp(timeDelta, targetElapsedTicks), WIN2D_TRACE("StepTimer_CloseToTargetClamp", Instant))
+
+inline void EtwWrite_StepTimer_FixedTimeStep(uint64_t timeDelta, uint64_t leftOverTicks) { EventWrite_StepTimer_FixedTimeStep(timeDelta, leftOverTicks); }
+#undef EventWrite_StepTimer_FixedTimeStep
+#define EventWrite_StepTimer_FixedTimeStep(timeDelta, leftOverTicks) (EtwWrite_StepTimer_FixedTimeStep(timeDelta, leftOverTicks), WIN2D_TRACE("StepTimer_FixedTimeStep", Instant))
+
+inline void EtwWrite_StepTimer_Update(uint64_t elapsedTicks, uint64_t leftOverTicks, uint64_t totalTicks, uint32_t frameCount, bool forceUpdate) { EventWrite_StepTimer_Update(elapsedTicks, leftOverTicks, totalTicks, frameCount, forceUpdate); }
+#undef EventWrite_StepTimer_Update
+#define EventWrite_StepTimer_Update(elapsedTicks, leftOverTicks, totalTicks, frameCount, forceUpdate) (EtwWrite_StepTimer_Update(elapsedTicks, leftOverTicks, totalTicks, frameCount, forceUpdate), WIN2D_TRACE("StepTimer_Update", Instant))
@@ -147,6 +147,7 @@ CanvasAnimatedControl::CanvasAnimatedControl(std::shared_ptr<ICanvasAnimatedCont
     : BaseControlWithDrawHandler<CanvasAnimatedControlTraits>(adapter, false)
     , m_stepTimer(adapter)
     , m_hasUpdated(false)
+    , m_frameTimes(adapter)
 {
     CreateContentControl();
 
@@ -540,6 +541,99 @@ IFACEMETHODIMP CanvasAnimatedControl::RunOnGameLoopThreadAsync(
         });
 }
 
+IFACEMETHODIMP CanvasAnimatedControl::GetFrameTimeStatistics(
+    CanvasFrameTimePhase phase,
+    CanvasFrameTimeStatistics* statistics)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(statistics);
+
+            *statistics = m_frameTimes.GetStatistics(phase);
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::GetFrameTimeHistogram(
+    CanvasFrameTimePhase phase,
+    UINT32* valueCount,
+    UINT32** valueElements)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(valueCount);
+            CheckAndClearOutPointer(valueElements);
+
+            auto histogram = m_frameTimes.GetHistogram(phase);
+
+            ComArray<UINT32> array(histogram.begin(), histogram.end());
+            array.Detach(valueCount, valueElements);
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_MissedFrameCount(INT64* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            *value = static_cast<INT64>(m_frameTimes.GetMissedFrameCount());
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::ResetFrameTimeStatistics()
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            m_frameTimes.Reset();
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::get_FrameLatencyMode(CanvasFrameLatencyMode* value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            CheckInPointer(value);
+
+            auto lock = Lock(m_sharedStateMutex);
+            *value = m_sharedState.FrameLatencyMode;
+        });
+}
+
+IFACEMETHODIMP CanvasAnimatedControl::put_FrameLatencyMode(CanvasFrameLatencyMode value)
+{
+    return ExceptionBoundary(
+        [&]
+        {
+            switch (value)
+            {
+            case CanvasFrameLatencyMode::Default:
+            case CanvasFrameLatencyMode::LowLatency:
+                break;
+
+            default:
+                ThrowHR(E_INVALIDARG);
+            }
+
+            auto lock = Lock(m_sharedStateMutex);
+
+            if (m_sharedState.FrameLatencyMode == value)
+                return;
+
+            m_sharedState.FrameLatencyMode = value;
+
+            // The new swap chain will need to be drawn.
+            m_sharedState.NeedsDraw = true;
+
+            lock.unlock();
+            Changed(ChangeReason::Other);
+        });
+}
+
 void CanvasAnimatedControl::CreateOrUpdateRenderTarget(
     ICanvasDevice* device,
     CanvasAlphaMode newAlphaMode,
@@ -547,11 +641,16 @@ void CanvasAnimatedControl::CreateOrUpdateRenderTarget(
     Size newSize,
     RenderTarget* renderTarget)
 {
+    auto lock = Lock(m_sharedStateMutex);
+    auto maximumFrameLatency = GetMaximumFrameLatency(m_sharedState.FrameLatencyMode);
+    lock.unlock();
+
     bool needsTarget = (renderTarget->Target == nullptr);
     bool alphaModeChanged = (renderTarget->AlphaMode != newAlphaMode);
     bool dpiChanged = (renderTarget->Dpi != newDpi);
     bool sizeChanged = (renderTarget->Size != newSize);
-    bool needsCreate = needsTarget || alphaModeChanged;
+    bool frameLatencyChanged = !needsTarget && (renderTarget->Target->GetMaximumFrameLatency() != maximumFrameLatency);
+    bool needsCreate = needsTarget || alphaModeChanged || frameLatencyChanged;
 
     if (!needsCreate && !sizeChanged && !dpiChanged)
         return;
@@ -576,7 +675,8 @@ void CanvasAnimatedControl::CreateOrUpdateRenderTarget(
             newSize.Width,
             newSize.Height,
             newDpi,
-            newAlphaMode);
+            newAlphaMode,
+            maximumFrameLatency);
 
         renderTarget->AlphaMode = newAlphaMode;
         renderTarget->Dpi = newDpi;
@@ -617,6 +717,8 @@ void CanvasAnimatedControl::Unloaded()
 {    
     m_gameLoop.reset();
 
+    m_swapChainReadyForFrame.Reset();
+
     // Any remaining async actions won't get executed, so we cancel them
     CancelAsyncActions();
 }
@@ -1026,6 +1128,8 @@ bool CanvasAnimatedControl::Tick(
         m_stepTimer.ResetElapsedTime();
     }
 
+    auto frameLatencyMode = m_sharedState.FrameLatencyMode;
+
     bool deviceNeedsReCreationWithNewOptions = m_sharedState.DeviceNeedsReCreationWithNewOptions;
     m_sharedState.DeviceNeedsReCreationWithNewOptions = false;
     m_sharedState.ShouldResetElapsedTime = false;
@@ -1041,6 +1145,13 @@ bool CanvasAnimatedControl::Tick(
         return false;
     }
 
+    // Likewise for a change to the frame latency mode.
+    if (renderTarget->Target &&
+        renderTarget->Target->GetMaximumFrameLatency() != GetMaximumFrameLatency(frameLatencyMode))
+    {
+        return false;
+    }
+
     // If the device needs to be re-created with different options, this 
     // needs to happen before we can draw.
     if (deviceNeedsReCreationWithNewOptions)
@@ -1126,6 +1237,16 @@ bool CanvasAnimatedControl::Tick(
 
     UpdateResult updateResult{};
 
+    m_frameTimes.BeginFrame();
+
+    // In low latency mode we wait for the swap chain to be ready for another
+    // frame before updating, so that the update sees the latest input.
+    if (frameLatencyMode == CanvasFrameLatencyMode::LowLatency && renderTarget->Target)
+        WaitForFrameLatency(renderTarget->Target.Get());
+
+    m_frameTimes.BeginInputLatency();
+
+    m_frameTimes.BeginPhase();
     EventWrite_CanvasAnimatedControl_Update_Start(areResourcesCreated, isPaused);
     if (areResourcesCreated && !isPaused)
     {
@@ -1145,6 +1266,7 @@ bool CanvasAnimatedControl::Tick(
         m_hasUpdated |= updateResult.Updated;
     }
     EventWrite_CanvasAnimatedControl_Update_Stop(updateResult.Updated);
+    m_frameTimes.EndPhase(CanvasFrameTimePhase::Update);
 
     //
     // We only ever Draw/Present if an Update has actually happened.  This
@@ -1209,12 +1331,21 @@ bool CanvasAnimatedControl::Tick(
         {
             bool invokeDrawHandlers = (areResourcesCreated && (m_hasUpdated || invalidated));
 
+            m_frameTimes.BeginPhase();
             EventWrite_CanvasAnimatedControl_Draw_Start(invokeDrawHandlers, updateResult.IsRunningSlowly);
             Draw(renderTarget->Target.Get(), clearColor, invokeDrawHandlers, updateResult.IsRunningSlowly);
             EventWrite_CanvasAnimatedControl_Draw_Stop();
+            m_frameTimes.EndPhase(CanvasFrameTimePhase::Draw);
+
+            m_frameTimes.BeginPhase();
             EventWrite_CanvasAnimatedControl_Present_Start();            
             ThrowIfFailed(renderTarget->Target->Present());
             EventWrite_CanvasAnimatedControl_Present_Stop();
+            m_frameTimes.EndPhase(CanvasFrameTimePhase::Present);
+
+            m_frameTimes.EndInputLatency();
+
+            m_swapChainReadyForFrame.Reset();
 
             drew = true;
         }
@@ -1247,8 +1378,14 @@ bool CanvasAnimatedControl::Tick(
     //   - if there's no swap chain (eg the window is invisible) then we just
     //     sleep
     //
-    if (!drew || !m_stepTimer.IsFixedTimeStep())
+    // When the swap chain has a frame latency waitable object, waiting on
+    // that paces the loop instead, so there's no need to wait after drawing.
+    //
+    bool pacedByFrameLatency = drew && renderTarget->Target->GetMaximumFrameLatency() > 0;
+
+    if (!drew || (!m_stepTimer.IsFixedTimeStep() && !pacedByFrameLatency))
     {
+        m_frameTimes.BeginPhase();
         EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Start();
         if (swapChain)
         {
@@ -1259,7 +1396,12 @@ bool CanvasAnimatedControl::Tick(
             GetAdapter()->Sleep(static_cast<DWORD>(StepTimer::TicksToMilliseconds(StepTimer::DefaultTargetElapsedTime)));
         }
         EventWrite_CanvasAnimatedControl_WaitForVerticalBlank_Stop();
+        m_frameTimes.EndPhase(CanvasFrameTimePhase::WaitForVerticalBlank);
     }
+
+    // Idle ticks, such as those while paused, would only dilute the statistics.
+    if (updateResult.Updated || drew)
+        m_frameTimes.EndFrame(m_stepTimer.GetTargetElapsedTicks());
     
     return areResourcesCreated && !isPaused;
 }
@@ -1289,6 +1431,38 @@ CanvasAnimatedControl::UpdateResult CanvasAnimatedControl::Update(bool forceUpda
     return result;
 }
 
+// Long enough that only a hung GPU should hit it.
+static const DWORD FrameLatencyTimeoutInMs = 1000;
+
+void CanvasAnimatedControl::WaitForFrameLatency(CanvasSwapChain* swapChain)
+{
+    // Every wait must be matched by a Present, otherwise the swap chain stops
+    // handing out frames.  If a tick waits but then doesn't draw, the next
+    // tick uses the frame that was already waited for.
+    if (m_swapChainReadyForFrame.Get() == swapChain)
+        return;
+
+    m_frameTimes.BeginPhase();
+    bool isReady = GetAdapter()->WaitForFrameLatency(swapChain, FrameLatencyTimeoutInMs);
+    m_frameTimes.EndPhase(CanvasFrameTimePhase::WaitForFrameLatency);
+
+    // If the wait timed out then Present will block instead.
+    if (isReady)
+        m_swapChainReadyForFrame = swapChain;
+}
+
+uint32_t CanvasAnimatedControl::GetMaximumFrameLatency(CanvasFrameLatencyMode mode)
+{
+    switch (mode)
+    {
+    case CanvasFrameLatencyMode::LowLatency:
+        return 1;
+
+    default:
+        return 0;
+    }
+}
+
 CanvasTimingInformation CanvasAnimatedControl::GetTimingInformationFromTimer()
 {
     CanvasTimingInformation timing;
@@ -8,6 +8,7 @@
 #include "BaseControlAdapter.h"
 #include "CanvasGameLoop.h"
 #include "CanvasSwapChainPanel.h"
+#include "FrameTimeRecorder.h"
 #include "StepTimer.h"
 
 namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace UI { namespace Xaml
@@ -102,7 +103,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             float width, 
             float height, 
             float dpi,
-            CanvasAlphaMode alphaMode) = 0;
+            CanvasAlphaMode alphaMode,
+            uint32_t maximumFrameLatency) = 0;
 
         virtual ComPtr<CanvasSwapChainPanel> CreateCanvasSwapChainPanel() = 0;
 
@@ -113,6 +115,8 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             ISwapChainPanel* swapChainPanel) = 0;
 
         virtual void Sleep(DWORD timeInMs) = 0;
+
+        virtual bool WaitForFrameLatency(CanvasSwapChain* swapChain, DWORD timeoutInMs) = 0;
     };
 
     std::shared_ptr<ICanvasAnimatedControlAdapter> CreateCanvasAnimatedControlAdapter();
@@ -140,6 +144,14 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
         StepTimer m_stepTimer;
         bool m_hasUpdated;
 
+        // Written by the update/render thread, read from any thread.
+        FrameTimeRecorder m_frameTimes;
+
+        // Set once the frame latency object of this swap chain has been waited
+        // on, and cleared once a frame has been presented to it.  Only accessed
+        // by the update/render thread while it is running.
+        ComPtr<CanvasSwapChain> m_swapChainReadyForFrame;
+
         //
         // State shared between the UI thread and the update/render thread.
         // Access to this must be guarded using m_sharedStateMutex
@@ -158,6 +170,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
                 , DeviceNeedsReCreationWithNewOptions(false)
                 , SizeSeenByGameLoop{}
                 , IsInTick(false)
+                , FrameLatencyMode(CanvasFrameLatencyMode::Default)
             {}
 
             bool IsPaused;
@@ -171,6 +184,7 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             bool DeviceNeedsReCreationWithNewOptions;
             Size SizeSeenByGameLoop;
             bool IsInTick;
+            CanvasFrameLatencyMode FrameLatencyMode;
             std::vector<ComPtr<AnimatedControlAsyncAction>> PendingAsyncActions;
         };
 
@@ -241,6 +255,23 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
             IDispatchedHandler* callback,
             IAsyncAction** asyncAction) override;
 
+        IFACEMETHODIMP GetFrameTimeStatistics(
+            CanvasFrameTimePhase phase,
+            CanvasFrameTimeStatistics* statistics) override;
+
+        IFACEMETHODIMP GetFrameTimeHistogram(
+            CanvasFrameTimePhase phase,
+            UINT32* valueCount,
+            UINT32** valueElements) override;
+
+        IFACEMETHODIMP get_MissedFrameCount(INT64* value) override;
+
+        IFACEMETHODIMP ResetFrameTimeStatistics() override;
+
+        IFACEMETHODIMP get_FrameLatencyMode(CanvasFrameLatencyMode* value) override;
+
+        IFACEMETHODIMP put_FrameLatencyMode(CanvasFrameLatencyMode value) override;
+
         //
         // BaseControl
         //
@@ -286,6 +317,10 @@ namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { na
 
         UpdateResult Update(bool forceUpdate, int64_t timeSpentPaused);
 
+        void WaitForFrameLatency(CanvasSwapChain* swapChain);
+
+        static uint32_t GetMaximumFrameLatency(CanvasFrameLatencyMode mode);
+
         void ChangedImpl();
 
         CanvasTimingInformation GetTimingInformationFromTimer();
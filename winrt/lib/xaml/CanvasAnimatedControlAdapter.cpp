@@ -57,8 +57,24 @@ public:
         float width,
         float height,
         float dpi,
-        CanvasAlphaMode alphaMode) override
+        CanvasAlphaMode alphaMode,
+        uint32_t maximumFrameLatency) override
     {
+        if (maximumFrameLatency > 0)
+        {
+            // Frame latency waitable objects aren't exposed through the
+            // public factory.
+            return CanvasSwapChain::CreateNew(
+                device,
+                width,
+                height,
+                dpi,
+                PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                2,
+                alphaMode,
+                maximumFrameLatency);
+        }
+
         ComPtr<ICanvasSwapChain> swapChain;
 
         ThrowIfFailed(m_canvasSwapChainFactory->CreateWithAllOptions(
@@ -120,6 +136,11 @@ public:
         ::Sleep(timeInMs);
     }
 
+    virtual bool WaitForFrameLatency(CanvasSwapChain* swapChain, DWORD timeoutInMs) override
+    {
+        return swapChain->WaitForFrameLatency(timeoutInMs);
+    }
+
     virtual int64_t GetPerformanceCounter() override
     {
         LARGE_INTEGER counter;
@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "FrameTimeRecorder.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::UI::Xaml;
+
+FrameTimeRecorder::FrameTimeRecorder(std::shared_ptr<ICanvasTimingAdapter> adapter)
+    : m_adapter(adapter)
+    , m_frequency(adapter->GetPerformanceFrequency())
+    , m_slots(new Slot[Capacity])
+    , m_frameCount(0)
+    , m_firstVisibleFrame(0)
+    , m_missedFrameCount(0)
+    , m_currentFrame{}
+    , m_frameStart(0)
+    , m_phaseStart(0)
+    , m_inputLatencyStart(0)
+{
+    assert(m_frequency > 0);
+
+    for (uint32_t i = 0; i < Capacity; ++i)
+    {
+        m_slots[i].Sequence.store(0, std::memory_order_relaxed);
+
+        for (auto& duration : m_slots[i].Durations)
+            duration.store(0, std::memory_order_relaxed);
+    }
+}
+
+void FrameTimeRecorder::BeginFrame()
+{
+    m_currentFrame.fill(0);
+    m_frameStart = m_adapter->GetPerformanceCounter();
+}
+
+void FrameTimeRecorder::BeginPhase()
+{
+    m_phaseStart = m_adapter->GetPerformanceCounter();
+}
+
+void FrameTimeRecorder::EndPhase(CanvasFrameTimePhase phase)
+{
+    auto& duration = m_currentFrame[static_cast<uint32_t>(phase)];
+
+    duration = static_cast<uint32_t>(std::min<uint64_t>(UINT_MAX, static_cast<uint64_t>(duration) + TicksSince(m_phaseStart)));
+}
+
+void FrameTimeRecorder::EndFrame(uint64_t targetElapsedTicks)
+{
+    m_currentFrame[static_cast<uint32_t>(CanvasFrameTimePhase::Frame)] = TicksSince(m_frameStart);
+
+    Record(m_currentFrame, targetElapsedTicks);
+}
+
+void FrameTimeRecorder::BeginInputLatency()
+{
+    m_inputLatencyStart = m_adapter->GetPerformanceCounter();
+}
+
+void FrameTimeRecorder::EndInputLatency()
+{
+    m_currentFrame[static_cast<uint32_t>(CanvasFrameTimePhase::InputLatency)] = TicksSince(m_inputLatencyStart);
+}
+
+void FrameTimeRecorder::Record(FrameTimes const& frameTimes, uint64_t targetElapsedTicks)
+{
+    if (IsMissedFrame(frameTimes[static_cast<uint32_t>(CanvasFrameTimePhase::Frame)], targetElapsedTicks))
+        m_missedFrameCount.fetch_add(1, std::memory_order_relaxed);
+
+    auto frame = m_frameCount.load(std::memory_order_relaxed);
+    auto& slot = m_slots[frame % Capacity];
+
+    // An odd sequence number marks the slot as being written.
+    auto sequence = frame * 2 + 1;
+
+    slot.Sequence.store(sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (uint32_t i = 0; i < PhaseCount; ++i)
+        slot.Durations[i].store(frameTimes[i], std::memory_order_relaxed);
+
+    slot.Sequence.store(sequence + 1, std::memory_order_release);
+
+    m_frameCount.store(frame + 1, std::memory_order_release);
+}
+
+std::vector<uint32_t> FrameTimeRecorder::GetDurations(CanvasFrameTimePhase phase) const
+{
+    auto phaseIndex = static_cast<uint32_t>(phase);
+
+    if (phaseIndex >= PhaseCount)
+        ThrowHR(E_INVALIDARG);
+
+    auto end = m_frameCount.load(std::memory_order_acquire);
+    auto begin = std::max(m_firstVisibleFrame.load(std::memory_order_relaxed), end > Capacity ? end - Capacity : 0);
+
+    std::vector<uint32_t> durations;
+    durations.reserve(static_cast<size_t>(end - begin));
+
+    for (auto frame = begin; frame < end; ++frame)
+    {
+        auto& slot = m_slots[frame % Capacity];
+
+        auto expectedSequence = frame * 2 + 2;
+
+        if (slot.Sequence.load(std::memory_order_acquire) != expectedSequence)
+            continue;
+
+        auto duration = slot.Durations[phaseIndex].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // The game loop has started overwriting this slot with a newer frame.
+        if (slot.Sequence.load(std::memory_order_relaxed) != expectedSequence)
+            continue;
+
+        durations.push_back(duration);
+    }
+
+    return durations;
+}
+
+CanvasFrameTimeStatistics FrameTimeRecorder::GetStatistics(CanvasFrameTimePhase phase) const
+{
+    auto durations = GetDurations(phase);
+
+    CanvasFrameTimeStatistics statistics{};
+
+    if (durations.empty())
+        return statistics;
+
+    std::sort(durations.begin(), durations.end());
+
+    auto count = static_cast<uint32_t>(durations.size());
+
+    // Nearest-rank percentiles.
+    auto percentile = [&](uint32_t p)
+    {
+        auto rank = (count * p + 99) / 100;
+        return static_cast<INT64>(durations[std::max(rank, 1u) - 1]);
+    };
+
+    uint64_t total = 0;
+    for (auto duration : durations)
+        total += duration;
+
+    statistics.FrameCount = count;
+    statistics.Average.Duration = static_cast<INT64>(total / count);
+    statistics.Median.Duration = percentile(50);
+    statistics.Percentile95.Duration = percentile(95);
+    statistics.Percentile99.Duration = percentile(99);
+    statistics.Maximum.Duration = durations.back();
+
+    return statistics;
+}
+
+std::vector<uint32_t> FrameTimeRecorder::GetHistogram(CanvasFrameTimePhase phase) const
+{
+    std::vector<uint32_t> histogram(HistogramBucketCount);
+
+    for (auto duration : GetDurations(phase))
+    {
+        auto bucket = std::min<uint64_t>(duration / HistogramBucketWidth, HistogramBucketCount - 1);
+        ++histogram[static_cast<size_t>(bucket)];
+    }
+
+    return histogram;
+}
+
+uint64_t FrameTimeRecorder::GetMissedFrameCount() const
+{
+    return m_missedFrameCount.load(std::memory_order_relaxed);
+}
+
+void FrameTimeRecorder::Reset()
+{
+    m_firstVisibleFrame.store(m_frameCount.load(std::memory_order_acquire), std::memory_order_relaxed);
+    m_missedFrameCount.store(0, std::memory_order_relaxed);
+}
+
+uint32_t FrameTimeRecorder::TicksSince(int64_t start) const
+{
+    auto delta = static_cast<uint64_t>(std::max(0LL, m_adapter->GetPerformanceCounter() - start));
+
+    // Split the conversion so that long durations cannot overflow.
+    auto frequency = static_cast<uint64_t>(m_frequency);
+    auto ticks = (delta / frequency) * StepTimer::TicksPerSecond + (delta % frequency) * StepTimer::TicksPerSecond / frequency;
+
+    return static_cast<uint32_t>(std::min<uint64_t>(ticks, UINT_MAX));
+}
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+#include "StepTimer.h"
+
+namespace ABI { namespace Microsoft { namespace Graphics { namespace Canvas { namespace UI { namespace Xaml
+{
+    //
+    // Records how long each phase of the most recent frames took, so that
+    // CanvasAnimatedControl can report frame time percentiles and histograms.
+    //
+    // Frames are recorded by the game loop thread, while statistics may be
+    // requested from any thread.  The recorder keeps the most recent
+    // Capacity frames in a ring buffer.  Each slot is guarded by a sequence
+    // number (a seqlock), so neither side ever blocks: a reader skips any
+    // slot that the game loop overwrites while it is being read.
+    //
+    class FrameTimeRecorder
+    {
+    public:
+        static const uint32_t Capacity = 256;
+        static const uint32_t PhaseCount = static_cast<uint32_t>(CanvasFrameTimePhase::InputLatency) + 1;
+
+        static const uint32_t HistogramBucketCount = 64;
+        static const uint64_t HistogramBucketWidth = StepTimer::TicksPerSecond / 1000;
+
+        // Durations in StepTimer ticks.
+        typedef std::array<uint32_t, PhaseCount> FrameTimes;
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint64_t> Sequence;
+            std::atomic<uint32_t> Durations[PhaseCount];
+        };
+
+        std::shared_ptr<ICanvasTimingAdapter> m_adapter;
+        int64_t m_frequency;
+
+        std::unique_ptr<Slot[]> m_slots;
+
+        // Only ever written by the game loop thread.
+        std::atomic<uint64_t> m_frameCount;
+
+        // Frames before this one are hidden from readers.
+        std::atomic<uint64_t> m_firstVisibleFrame;
+
+        std::atomic<uint64_t> m_missedFrameCount;
+
+        // State of the frame currently being measured, owned by the game loop thread.
+        FrameTimes m_currentFrame;
+        int64_t m_frameStart;
+        int64_t m_phaseStart;
+        int64_t m_inputLatencyStart;
+
+    public:
+        FrameTimeRecorder(std::shared_ptr<ICanvasTimingAdapter> adapter);
+
+        //
+        // Game loop thread.  A frame that is begun but never ended, for
+        // instance because the tick returned early, is simply not recorded.
+        //
+        void BeginFrame();
+        void BeginPhase();
+        void EndPhase(CanvasFrameTimePhase phase);
+        void EndFrame(uint64_t targetElapsedTicks);
+
+        // InputLatency spans several phases, so is measured separately.
+        void BeginInputLatency();
+        void EndInputLatency();
+
+        void Record(FrameTimes const& frameTimes, uint64_t targetElapsedTicks);
+
+        //
+        // Any thread.
+        //
+        CanvasFrameTimeStatistics GetStatistics(CanvasFrameTimePhase phase) const;
+        std::vector<uint32_t> GetHistogram(CanvasFrameTimePhase phase) const;
+        uint64_t GetMissedFrameCount() const;
+        void Reset();
+
+        // True if a frame of the given length overran its target by more than
+        // half a frame, which means at least one vertical blank was missed.
+        static bool IsMissedFrame(uint64_t frameTicks, uint64_t targetElapsedTicks)
+        {
+            return targetElapsedTicks > 0 && frameTicks > targetElapsedTicks + targetElapsedTicks / 2;
+        }
+
+    private:
+        uint32_t TicksSince(int64_t start) const;
+        std::vector<uint32_t> GetDurations(CanvasFrameTimePhase phase) const;
+    };
+}}}}}}
@@ -151,6 +151,30 @@ public:
         uint64_t cacheSize;
         Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumCacheSize(&cacheSize));
         Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumCacheSize(0));
+
+        int32_t poolSize;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumDeviceContextPoolSize(&poolSize));
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumDeviceContextPoolSize(0));
+
+        uint64_t stagingCacheSize;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumStagingBitmapCacheSize(&stagingCacheSize));
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumStagingBitmapCacheSize(0));
+
+        uint32_t textLayoutCacheEntryCount;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumTextLayoutCacheEntryCount(&textLayoutCacheEntryCount));
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumTextLayoutCacheEntryCount(0));
+
+        uint64_t textLayoutCacheSize;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumTextLayoutCacheSize(&textLayoutCacheSize));
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumTextLayoutCacheSize(0));
+
+        uint64_t geometryRealizationCacheSize;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumGeometryRealizationCacheSize(&geometryRealizationCacheSize));
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumGeometryRealizationCacheSize(0));
+
+        uint32_t gradientStopCollectionCacheEntryCount;
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->get_MaximumGradientStopCollectionCacheEntryCount(&gradientStopCollectionCacheEntryCount));
+        Assert::AreEqual(RO_E_CLOSED, canvasDevice->put_MaximumGradientStopCollectionCacheEntryCount(0));
     }
 
     ComPtr<ID2D1Device1> GetD2DDevice(ComPtr<ICanvasDevice> const& canvasDevice)
@@ -351,6 +375,214 @@ public:
         Assert::IsFalse(!!isSupported);
     }
 
+    TEST_METHOD_EX(CanvasDevice_MaximumDeviceContextPoolSize)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        int32_t value;
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_MaximumDeviceContextPoolSize(nullptr));
+
+        ThrowIfFailed(canvasDevice->get_MaximumDeviceContextPoolSize(&value));
+        auto expectedDefault = std::min(std::max(std::thread::hardware_concurrency(), 1U), DeviceContextPool::MaxSlotCount);
+        Assert::AreEqual(static_cast<int32_t>(expectedDefault), value);
+
+        ThrowIfFailed(canvasDevice->put_MaximumDeviceContextPoolSize(3));
+        ThrowIfFailed(canvasDevice->get_MaximumDeviceContextPoolSize(&value));
+        Assert::AreEqual(3, value);
+
+        ThrowIfFailed(canvasDevice->put_MaximumDeviceContextPoolSize(0));
+        ThrowIfFailed(canvasDevice->get_MaximumDeviceContextPoolSize(&value));
+        Assert::AreEqual(0, value);
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->put_MaximumDeviceContextPoolSize(-1));
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->put_MaximumDeviceContextPoolSize(static_cast<int32_t>(DeviceContextPool::MaxSlotCount) + 1));
+    }
+
+    TEST_METHOD_EX(CanvasDevice_DeviceContextPoolStatistics)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        d2dDevice->MockCreateDeviceContext =
+            [] (D2D1_DEVICE_CONTEXT_OPTIONS, ID2D1DeviceContext1** value)
+            {
+                Make<MockD2DDeviceContext>().CopyTo(value);
+            };
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_DeviceContextPoolStatistics(nullptr));
+
+        for (int i = 0; i < 3; ++i)
+        {
+            canvasDevice->GetResourceCreationDeviceContext();
+        }
+
+        CanvasDeviceContextPoolStatistics statistics;
+        ThrowIfFailed(canvasDevice->get_DeviceContextPoolStatistics(&statistics));
+
+        Assert::AreEqual<uint64_t>(2, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(1, statistics.MissCount);
+        Assert::AreEqual<uint64_t>(1, statistics.CreateCount);
+        Assert::AreEqual<uint64_t>(0, statistics.DiscardCount);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_MaximumStagingBitmapCacheSize)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        uint64_t value;
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_MaximumStagingBitmapCacheSize(nullptr));
+
+        ThrowIfFailed(canvasDevice->get_MaximumStagingBitmapCacheSize(&value));
+        Assert::AreEqual(StagingBitmapCache::DefaultMaximumSizeInBytes, value);
+
+        ThrowIfFailed(canvasDevice->put_MaximumStagingBitmapCacheSize(1234));
+        ThrowIfFailed(canvasDevice->get_MaximumStagingBitmapCacheSize(&value));
+        Assert::AreEqual<uint64_t>(1234, value);
+
+        ThrowIfFailed(canvasDevice->put_MaximumStagingBitmapCacheSize(0));
+        ThrowIfFailed(canvasDevice->get_MaximumStagingBitmapCacheSize(&value));
+        Assert::AreEqual<uint64_t>(0, value);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_StagingBitmapCacheStatistics)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        auto deviceContext = Make<MockD2DDeviceContext>();
+        deviceContext->CreateBitmapMethod.SetExpectedCalls(1,
+            [] (D2D1_SIZE_U, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const*, ID2D1Bitmap1** bitmap)
+            {
+                return Make<MockD2DBitmap>().CopyTo(bitmap);
+            });
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_StagingBitmapCacheStatistics(nullptr));
+
+        auto cache = canvasDevice->GetStagingBitmapCache();
+        auto format = D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            cache->Acquire(deviceContext.Get(), format, D2D1_SIZE_U{ 10, 10 });
+        }
+
+        CanvasStagingBitmapCacheStatistics statistics;
+        ThrowIfFailed(canvasDevice->get_StagingBitmapCacheStatistics(&statistics));
+
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(1, statistics.MissCount);
+        Assert::AreEqual<uint64_t>(0, statistics.EvictionCount);
+        Assert::AreEqual<uint64_t>(64 * 64 * 4, statistics.SizeInBytes);
+
+        // Shrinking the cache evicts idle staging bitmaps.
+        ThrowIfFailed(canvasDevice->put_MaximumStagingBitmapCacheSize(0));
+        ThrowIfFailed(canvasDevice->get_StagingBitmapCacheStatistics(&statistics));
+        Assert::AreEqual<uint64_t>(1, statistics.EvictionCount);
+        Assert::AreEqual<uint64_t>(0, statistics.SizeInBytes);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_TextLayoutCacheLimits)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        uint32_t entryCount;
+        uint64_t size;
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_MaximumTextLayoutCacheEntryCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_MaximumTextLayoutCacheSize(nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_TextLayoutCacheStatistics(nullptr));
+
+        // The cache is disabled by default.
+        ThrowIfFailed(canvasDevice->get_MaximumTextLayoutCacheEntryCount(&entryCount));
+        Assert::AreEqual(0u, entryCount);
+
+        ThrowIfFailed(canvasDevice->get_MaximumTextLayoutCacheSize(&size));
+        Assert::AreEqual(TextLayoutCache::DefaultMaximumSizeInBytes, size);
+
+        ThrowIfFailed(canvasDevice->put_MaximumTextLayoutCacheEntryCount(100));
+        ThrowIfFailed(canvasDevice->get_MaximumTextLayoutCacheEntryCount(&entryCount));
+        Assert::AreEqual(100u, entryCount);
+
+        ThrowIfFailed(canvasDevice->put_MaximumTextLayoutCacheSize(1234));
+        ThrowIfFailed(canvasDevice->get_MaximumTextLayoutCacheSize(&size));
+        Assert::AreEqual<uint64_t>(1234, size);
+
+        CanvasTextLayoutCacheStatistics statistics;
+        ThrowIfFailed(canvasDevice->get_TextLayoutCacheStatistics(&statistics));
+        Assert::AreEqual<uint64_t>(0, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(0, statistics.MissCount);
+        Assert::AreEqual(0u, statistics.EntryCount);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_GeometryRealizationCacheLimits)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        uint64_t size;
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_MaximumGeometryRealizationCacheSize(nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_GeometryRealizationCacheStatistics(nullptr));
+
+        // The cache is disabled by default.
+        ThrowIfFailed(canvasDevice->get_MaximumGeometryRealizationCacheSize(&size));
+        Assert::AreEqual(GeometryRealizationCache::DefaultMaximumSizeInBytes, size);
+
+        ThrowIfFailed(canvasDevice->put_MaximumGeometryRealizationCacheSize(1234));
+        ThrowIfFailed(canvasDevice->get_MaximumGeometryRealizationCacheSize(&size));
+        Assert::AreEqual<uint64_t>(1234, size);
+
+        CanvasGeometryRealizationCacheStatistics statistics;
+        ThrowIfFailed(canvasDevice->get_GeometryRealizationCacheStatistics(&statistics));
+        Assert::AreEqual<uint64_t>(0, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(0, statistics.MissCount);
+        Assert::AreEqual(0u, statistics.RealizationCount);
+    }
+
+    TEST_METHOD_EX(CanvasDevice_GradientStopCollectionCacheLimits)
+    {
+        Fixture f;
+
+        auto d2dDevice = Make<MockD2DDevice>();
+        auto canvasDevice = Make<CanvasDevice>(d2dDevice.Get());
+
+        uint32_t entryCount;
+
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_MaximumGradientStopCollectionCacheEntryCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasDevice->get_GradientStopCollectionCacheStatistics(nullptr));
+
+        // The cache is disabled by default.
+        ThrowIfFailed(canvasDevice->get_MaximumGradientStopCollectionCacheEntryCount(&entryCount));
+        Assert::AreEqual(0u, entryCount);
+
+        ThrowIfFailed(canvasDevice->put_MaximumGradientStopCollectionCacheEntryCount(100));
+        ThrowIfFailed(canvasDevice->get_MaximumGradientStopCollectionCacheEntryCount(&entryCount));
+        Assert::AreEqual(100u, entryCount);
+
+        CanvasGradientStopCollectionCacheStatistics statistics;
+        ThrowIfFailed(canvasDevice->get_GradientStopCollectionCacheStatistics(&statistics));
+        Assert::AreEqual<uint64_t>(0, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(0, statistics.MissCount);
+        Assert::AreEqual(0u, statistics.EntryCount);
+    }
+
     TEST_METHOD_EX(CanvasDevice_LowPriority)
     {
         Fixture f;
@@ -3365,6 +3365,90 @@ public:
         ThrowIfFailed(f.DS->FillGeometryWithBrush(f.Geometry.Get(), f.DrawOffset, f.Brush.Get()));
     }
 
+    TEST_METHOD_EX(CanvasDrawingSession_FillAndDrawGeometry_WhenNoGeometryRealizationCacheIsEnabled_DoNotAskTheDeviceForIt)
+    {
+        CanvasDrawingSessionFixture f;
+
+        Assert::IsFalse(GeometryRealizationCache::IsAnyEnabled());
+
+        f.CanvasDevice->GetGeometryRealizationCacheMethod.SetExpectedCalls(0);
+        f.DeviceContext->FillGeometryMethod.SetExpectedCalls(1);
+        f.DeviceContext->DrawGeometryMethod.SetExpectedCalls(1);
+
+        ThrowIfFailed(f.DS->FillGeometryAtOriginWithBrush(f.Geometry.Get(), f.Brush.Get()));
+        ThrowIfFailed(f.DS->DrawGeometryAtOriginWithBrushAndStrokeWidth(f.Geometry.Get(), f.Brush.Get(), 5));
+    }
+
+    class FixtureWithGeometryRealizationCache : public CanvasDrawingSessionFixture
+    {
+    public:
+        ComPtr<ID2D1Geometry> D2DGeometry;
+
+        FixtureWithGeometryRealizationCache()
+            : D2DGeometry(Geometry->GetResource())
+        {
+            CanvasDevice->GetGeometryRealizationCache()->SetMaximumSize(1024 * 1024);
+
+            DeviceContext->GetTransformMethod.AllowAnyCall(
+                [] (D2D1_MATRIX_3X2_F* transform)
+                {
+                    *transform = D2D1::Matrix3x2F::Identity();
+                });
+        }
+    };
+
+    TEST_METHOD_EX(CanvasDrawingSession_FillGeometry_WhenGeometryRealizationCacheIsEnabled_DrawsRealizationTheSecondTime)
+    {
+        FixtureWithGeometryRealizationCache f;
+
+        ComPtr<ID2D1GeometryRealization> createdRealization;
+
+        f.DeviceContext->CreateFilledGeometryRealizationMethod.SetExpectedCalls(1,
+            [&] (ID2D1Geometry* geometry, FLOAT, ID2D1GeometryRealization** realization)
+            {
+                Assert::IsTrue(IsSameInstance(f.D2DGeometry.Get(), geometry));
+
+                createdRealization = Make<MockD2DGeometryRealization>();
+                return createdRealization.CopyTo(realization);
+            });
+
+        f.DeviceContext->FillGeometryMethod.SetExpectedCalls(1);
+
+        f.DeviceContext->DrawGeometryRealizationMethod.SetExpectedCalls(2,
+            [&] (ID2D1GeometryRealization* realization, ID2D1Brush* brush)
+            {
+                Assert::IsTrue(IsSameInstance(createdRealization.Get(), realization));
+                Assert::IsTrue(IsSameInstance(f.Brush->GetD2DBrush(nullptr, GetBrushFlags::None).Get(), brush));
+            });
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ThrowIfFailed(f.DS->FillGeometryAtOriginWithBrush(f.Geometry.Get(), f.Brush.Get()));
+        }
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawGeometry_WhenGeometryRealizationCacheIsEnabled_DrawsRealizationTheSecondTime)
+    {
+        FixtureWithGeometryRealizationCache f;
+
+        f.DeviceContext->CreateStrokedGeometryRealizationMethod.SetExpectedCalls(1,
+            [&] (ID2D1Geometry* geometry, FLOAT, FLOAT strokeWidth, ID2D1StrokeStyle*, ID2D1GeometryRealization** realization)
+            {
+                Assert::IsTrue(IsSameInstance(f.D2DGeometry.Get(), geometry));
+                Assert::AreEqual(5.0f, strokeWidth);
+
+                return Make<MockD2DGeometryRealization>().CopyTo(realization);
+            });
+
+        f.DeviceContext->DrawGeometryMethod.SetExpectedCalls(1);
+        f.DeviceContext->DrawGeometryRealizationMethod.SetExpectedCalls(2);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            ThrowIfFailed(f.DS->DrawGeometryAtOriginWithBrushAndStrokeWidth(f.Geometry.Get(), f.Brush.Get(), 5));
+        }
+    }
+
     class FillGeometryWithOpacityBrushFixture : public FixtureWithTemporaryTranslation
     {
     public:
@@ -4776,6 +4860,64 @@ TEST_CLASS(CanvasDrawingSession_DrawTextTests)
             Color{ 1, 2, 3, 4 },
             f.Format.Get()));
     }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawText_WhenNoTextLayoutCacheIsEnabled_DoesNotAskTheDeviceForIt)
+    {
+        Fixture f;
+
+        Assert::IsFalse(TextLayoutCache::IsAnyEnabled());
+
+        f.CanvasDevice->GetTextLayoutCacheMethod.SetExpectedCalls(0);
+        f.DeviceContext->DrawTextMethod.SetExpectedCalls(1);
+
+        ThrowIfFailed(f.DS->DrawTextAtRectWithBrushAndFormat(
+            HStringReference(L"test").Get(),
+            Rect{ 1, 2, 3, 4 },
+            f.Brush.Get(),
+            f.Format.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasDrawingSession_DrawText_WhenTextLayoutCacheIsEnabled_DrawsCachedLayout)
+    {
+        Fixture f;
+
+        auto cache = f.CanvasDevice->GetTextLayoutCache();
+        cache->SetMaximumEntryCount(16);
+
+        ThrowIfFailed(f.Format->put_Options(CanvasDrawTextOptions::Clip));
+
+        f.DeviceContext->DrawTextMethod.SetExpectedCalls(0);
+
+        ComPtr<IDWriteTextLayout> drawnLayout;
+
+        f.DeviceContext->DrawTextLayoutMethod.SetExpectedCalls(2,
+            [&] (D2D1_POINT_2F origin, IDWriteTextLayout* layout, ID2D1Brush* brush, D2D1_DRAW_TEXT_OPTIONS options)
+            {
+                Assert::AreEqual(D2D1_POINT_2F{ 1, 2 }, origin);
+                Assert::AreEqual(3.0f, layout->GetMaxWidth());
+                Assert::AreEqual(4.0f, layout->GetMaxHeight());
+                Assert::AreEqual(D2D1_DRAW_TEXT_OPTIONS_CLIP, options);
+                Assert::IsTrue(IsSameInstance(f.Brush->GetD2DBrush(nullptr, GetBrushFlags::None).Get(), brush));
+
+                if (drawnLayout)
+                    Assert::IsTrue(IsSameInstance(drawnLayout.Get(), layout));
+                else
+                    drawnLayout = layout;
+            });
+
+        for (int i = 0; i < 2; ++i)
+        {
+            ThrowIfFailed(f.DS->DrawTextAtRectWithBrushAndFormat(
+                HStringReference(L"test").Get(),
+                Rect{ 1, 2, 3, 4 },
+                f.Brush.Get(),
+                f.Format.Get()));
+        }
+
+        auto statistics = cache->GetStatistics();
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(1, statistics.MissCount);
+    }
 };
 
 TEST_CLASS(CanvasDrawingSession_CloseTests)
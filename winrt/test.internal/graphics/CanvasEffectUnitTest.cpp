@@ -455,6 +455,55 @@ public:
         CheckCallCount(mockEffects, 3, { 2, 2, 2 }, { 2, 2, 2 });
     }
 
+    TEST_METHOD_EX(CanvasEffect_WhenRealized_OnlyPropertiesThatWereSetAreTransferred)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        ComPtr<MockD2DEffectThatCountsCalls> mockEffect;
+
+        f.m_deviceContext->CreateEffectMethod.SetExpectedCalls(1,
+            [&](IID const&, ID2D1Effect** effect)
+            {
+                mockEffect = Make<MockD2DEffectThatCountsCalls>();
+
+                mockEffect->MockGetValue =
+                    [&](UINT32 index, D2D1_PROPERTY_TYPE, BYTE* data, UINT32 dataSize)
+                    {
+                        Assert::AreEqual<size_t>(dataSize, mockEffect->m_properties[index].size());
+                        memcpy(data, mockEffect->m_properties[index].data(), dataSize);
+                        return S_OK;
+                    };
+
+                return mockEffect.CopyTo(effect);
+            });
+
+        f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+        // Only one of the four properties is given a value.
+        auto testEffect = Make<TestEffect>(m_blurGuid, 4, 1, false);
+
+        ThrowIfFailed(testEffect->put_Source(stubBitmap.Get()));
+        ThrowIfFailed(testEffect->put_BlurAmount(1));
+        ThrowIfFailed(testEffect->put_BlurAmount(5));
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+
+        Assert::AreEqual(1, mockEffect->m_setValueCalls);
+        Assert::AreEqual(sizeof(float), mockEffect->m_properties[0].size());
+        Assert::AreEqual(5.0f, *reinterpret_cast<float*>(mockEffect->m_properties[0].data()));
+
+        // Once realized, values are written straight through to D2D.
+        ThrowIfFailed(testEffect->put_BlurAmount(7));
+
+        Assert::AreEqual(2, mockEffect->m_setValueCalls);
+
+        float value;
+        ThrowIfFailed(testEffect->get_BlurAmount(&value));
+        Assert::AreEqual(7.0f, value);
+    }
+
     static void CheckCallCount(std::vector<ComPtr<MockD2DEffectThatCountsCalls>> const& mockEffects,
                                size_t expectedEffectCount,
                                std::initializer_list<int> const& expectedSetInputCalls,
@@ -484,6 +533,260 @@ public:
         }
     }
 
+    static void CheckGraphStatistics(ICanvasEffect* effect, uint32_t expectedNodesVisited, uint32_t expectedNodesSkipped)
+    {
+        CanvasEffectGraphStatistics statistics;
+        ThrowIfFailed(effect->get_GraphStatistics(&statistics));
+
+        Assert::AreEqual(expectedNodesVisited, statistics.NodesVisited, L"nodes visited");
+        Assert::AreEqual(expectedNodesSkipped, statistics.NodesSkipped, L"nodes skipped");
+    }
+
+    TEST_METHOD_EX(CanvasEffect_GraphStatistics)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> mockEffects;
+
+        f.m_deviceContext->CreateEffectMethod.AllowAnyCall(
+            [&](IID const&, ID2D1Effect** effect)
+            {
+                mockEffects.push_back(Make<MockD2DEffectThatCountsCalls>());
+                return mockEffects.back().CopyTo(effect);
+            });
+
+        f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+        f.m_canvasDevice->GetResourceCreationDeviceContextMethod.AllowAnyCall(
+            [&]
+            {
+                return DeviceContextLease(As<ID2D1DeviceContext1>(f.m_deviceContext));
+            });
+
+        // A diamond shaped graph: the root has two sources, which share a common source.
+        auto shared = Make<TestEffect>(m_blurGuid, 1, 1, false);
+        auto left = Make<TestEffect>(m_blurGuid, 1, 1, false);
+        auto right = Make<TestEffect>(m_blurGuid, 1, 1, false);
+        auto root = Make<TestEffect>(m_blurGuid, 0, 2, false);
+
+        ThrowIfFailed(shared->put_BlurAmount(0));
+        ThrowIfFailed(left->put_BlurAmount(0));
+        ThrowIfFailed(right->put_BlurAmount(0));
+
+        ThrowIfFailed(shared->put_Source(stubBitmap.Get()));
+        ThrowIfFailed(left->put_Source(shared.Get()));
+        ThrowIfFailed(right->put_Source(shared.Get()));
+        root->SetSource(0, left.Get());
+        root->SetSource(1, right.Get());
+
+        // The first draw realizes every effect, but only walks the shared subgraph once.
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        Assert::AreEqual<size_t>(4, mockEffects.size());
+        CheckGraphStatistics(root.Get(), 4, 1);
+
+        // Drawing the unchanged graph again stops at the root.
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 0, 1);
+
+        // Property changes don't affect the shape of the graph.
+        ThrowIfFailed(left->put_BlurAmount(1));
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 0, 1);
+
+        // Changing a source only revalidates the effects above it.
+        ThrowIfFailed(right->put_Source(shared.Get()));
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 2, 2);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 0, 1);
+
+        // Drawing at a different DPI revalidates the graph.
+        f.m_dpi = DEFAULT_DPI * 2;
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 4, 1);
+
+        // Effects drawn as part of a larger graph don't update their own statistics.
+        CheckGraphStatistics(left.Get(), 0, 0);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(left.Get()));
+        CheckGraphStatistics(left.Get(), 0, 1);
+    }
+
+    TEST_METHOD_EX(CanvasEffect_GraphStatistics_WhenInputChangedViaInterop_EffectIsRevalidated)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+        auto stubBitmap2 = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> mockEffects;
+
+        f.m_deviceContext->CreateEffectMethod.AllowAnyCall(
+            [&](IID const&, ID2D1Effect** effect)
+            {
+                mockEffects.push_back(Make<MockD2DEffectThatCountsCalls>());
+                return mockEffects.back().CopyTo(effect);
+            });
+
+        f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+        auto testEffect = Make<TestEffect>(m_blurGuid, 0, 1, false);
+
+        ThrowIfFailed(testEffect->put_Source(stubBitmap.Get()));
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+        CheckGraphStatistics(testEffect.Get(), 0, 1);
+
+        // Swap the input directly on the D2D effect.
+        Assert::AreEqual<size_t>(1, mockEffects.size());
+        mockEffects[0]->SetInput(0, As<ICanvasImageInternal>(stubBitmap2)->GetD2DImage(nullptr, nullptr).Get());
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+        CheckGraphStatistics(testEffect.Get(), 1, 0);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(testEffect.Get()));
+        CheckGraphStatistics(testEffect.Get(), 0, 1);
+    }
+
+    TEST_METHOD_EX(CanvasEffect_GraphStatistics_WhenSourceChangedSeveralLevelsDeep_OnlyThatPathIsRevalidated)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+        auto stubBitmap2 = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> mockEffects;
+
+        f.m_deviceContext->CreateEffectMethod.AllowAnyCall(
+            [&](IID const& effectId, ID2D1Effect** effect)
+            {
+                mockEffects.push_back(Make<MockD2DEffectThatCountsCalls>(effectId));
+                return mockEffects.back().CopyTo(effect);
+            });
+
+        f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+        // root -> a -> b -> c -> bitmap, plus root -> sibling -> bitmap.
+        auto c = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        auto b = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        auto a = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        auto sibling = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        auto root = Make<TestEffect>(m_blurGuid, 0, 2, false);
+
+        ThrowIfFailed(c->put_Source(stubBitmap.Get()));
+        ThrowIfFailed(b->put_Source(c.Get()));
+        ThrowIfFailed(a->put_Source(b.Get()));
+        ThrowIfFailed(sibling->put_Source(stubBitmap.Get()));
+        root->SetSource(0, a.Get());
+        root->SetSource(1, sibling.Get());
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        Assert::AreEqual<size_t>(5, mockEffects.size());
+        CheckGraphStatistics(root.Get(), 5, 0);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 0, 1);
+
+        // Changing the source of the deepest effect revalidates it and everything above it, but not the sibling.
+        ThrowIfFailed(c->put_Source(stubBitmap2.Get()));
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 4, 1);
+
+        Assert::AreEqual<size_t>(5, mockEffects.size());
+        CheckEffectTypeAndInput(mockEffects[3].Get(), m_blurGuid, stubBitmap2.Get(), f.m_deviceContext.Get());
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 0, 1);
+
+        // Effects that don't use the changed one are unaffected.
+        ThrowIfFailed(c->put_Source(stubBitmap.Get()));
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(sibling.Get()));
+        CheckGraphStatistics(sibling.Get(), 0, 1);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(a.Get()));
+        CheckGraphStatistics(a.Get(), 3, 0);
+    }
+
+    TEST_METHOD_EX(CanvasEffect_GraphStatistics_WhenInputChangedViaInteropSeveralLevelsDeep_EffectIsRevalidated)
+    {
+        Fixture f;
+
+        auto stubBitmap = CreateStubCanvasBitmap(DEFAULT_DPI, f.m_canvasDevice.Get());
+
+        const float highDpi = 144;
+        auto highDpiBitmap = CreateStubCanvasBitmap(highDpi, f.m_canvasDevice.Get());
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> mockEffects;
+
+        f.m_deviceContext->CreateEffectMethod.AllowAnyCall(
+            [&](IID const& effectId, ID2D1Effect** effect)
+            {
+                mockEffects.push_back(Make<MockD2DEffectThatCountsCalls>(effectId));
+                return mockEffects.back().CopyTo(effect);
+            });
+
+        f.m_deviceContext->DrawImageMethod.AllowAnyCall();
+
+        // root -> mid -> leaf -> bitmap, plus root -> sibling -> bitmap.
+        auto leaf = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        auto mid = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        auto sibling = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        auto root = Make<TestEffect>(m_blurGuid, 0, 2, false);
+
+        ThrowIfFailed(leaf->put_Source(stubBitmap.Get()));
+        ThrowIfFailed(mid->put_Source(leaf.Get()));
+        ThrowIfFailed(sibling->put_Source(stubBitmap.Get()));
+        root->SetSource(0, mid.Get());
+        root->SetSource(1, sibling.Get());
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        Assert::AreEqual<size_t>(4, mockEffects.size());
+        CheckGraphStatistics(root.Get(), 4, 0);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 0, 1);
+
+        // Once the leaf is exposed through interop, it and everything above it are always revalidated.
+        ComPtr<ID2D1Effect> leafD2D;
+        ThrowIfFailed(As<ICanvasResourceWrapperNative>(leaf)->GetNativeResource(f.m_canvasDevice.Get(), DEFAULT_DPI, IID_PPV_ARGS(&leafD2D)));
+        Assert::IsTrue(IsSameInstance(mockEffects[2].Get(), leafD2D.Get()));
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 3, 1);
+
+        // Swap the leaf input directly on the D2D effect, to a bitmap that needs DPI compensation.
+        leafD2D->SetInput(0, As<ICanvasImageInternal>(highDpiBitmap)->GetD2DImage(nullptr, nullptr).Get());
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 3, 1);
+
+        Assert::AreEqual<size_t>(5, mockEffects.size());
+        CheckEffectTypeAndInput(mockEffects[2].Get(), m_blurGuid, mockEffects[4].Get());
+        CheckEffectTypeAndInput(mockEffects[4].Get(), CLSID_D2D1DpiCompensation, highDpiBitmap.Get(), f.m_deviceContext.Get(), highDpi);
+
+        // Once the exposed leaf is no longer part of the graph, the root can be skipped again.
+        auto replacement = Make<TestEffect>(m_blurGuid, 0, 1, false);
+        ThrowIfFailed(replacement->put_Source(stubBitmap.Get()));
+        root->SetSource(0, replacement.Get());
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 2, 1);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(root.Get()));
+        CheckGraphStatistics(root.Get(), 0, 1);
+
+        // The effects that still contain it are always revalidated.
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(mid.Get()));
+        CheckGraphStatistics(mid.Get(), 2, 0);
+
+        ThrowIfFailed(f.m_drawingSession->DrawImageAtOrigin(mid.Get()));
+        CheckGraphStatistics(mid.Get(), 2, 0);
+    }
+
     TEST_METHOD_EX(CanvasEffect_DpiCompensation)
     {
         Fixture f;
@@ -0,0 +1,507 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include <lib/geometry/CanvasGeometryIndex.h>
+#include <lib/geometry/GeometrySink.h>
+#include "mocks/MockD2DRectangleGeometry.h"
+
+//
+// These tests build the index without a D2D device, by streaming path data
+// through the same GeometrySink that CanvasGeometryIndex::CreateNew passes to
+// ID2D1Geometry::Simplify.
+//
+class GeometryIndexFixture
+{
+public:
+    GeometryIndex Index;
+    ComPtr<GeometrySink> Sink;
+
+    GeometryIndexFixture(float flatteningTolerance = D2D1_DEFAULT_FLATTENING_TOLERANCE)
+        : Index(flatteningTolerance)
+        , Sink(Make<GeometrySink>(Index.CreatePathReceiver()))
+    {
+    }
+
+    void AddFigure(
+        std::vector<D2D1_POINT_2F> const& points,
+        D2D1_FIGURE_BEGIN figureBegin = D2D1_FIGURE_BEGIN_FILLED,
+        D2D1_FIGURE_END figureEnd = D2D1_FIGURE_END_CLOSED)
+    {
+        Sink->BeginFigure(points[0], figureBegin);
+        Sink->AddLines(points.data() + 1, static_cast<uint32_t>(points.size() - 1));
+        Sink->EndFigure(figureEnd);
+    }
+
+    static std::vector<D2D1_POINT_2F> Rectangle(float left, float top, float right, float bottom)
+    {
+        return { { left, top }, { right, top }, { right, bottom }, { left, bottom } };
+    }
+
+    void AddFeature(std::function<void()> const& addFigures, D2D1_FILL_MODE fillMode = D2D1_FILL_MODE_ALTERNATE)
+    {
+        Index.BeginFeature();
+        Sink->SetFillMode(fillMode);
+        addFigures();
+        Assert::AreEqual(S_OK, Sink->Close());
+        Index.EndFeature();
+    }
+
+    void AddRectangleFeature(float left, float top, float right, float bottom)
+    {
+        AddFeature([&] { AddFigure(Rectangle(left, top, right, bottom)); });
+    }
+};
+
+// Deterministic pseudo-random numbers, so failures are reproducible.
+class TestRandom
+{
+    uint32_t m_state;
+
+public:
+    TestRandom(uint32_t seed)
+        : m_state(seed)
+    {
+    }
+
+    // Returns an integer in [0, range).
+    int Next(int range)
+    {
+        m_state = m_state * 1664525 + 1013904223;
+        return static_cast<int>((m_state >> 8) % static_cast<uint32_t>(range));
+    }
+};
+
+TEST_CLASS(CanvasGeometryIndexUnitTests)
+{
+    TEST_METHOD_EX(GeometryIndex_Empty)
+    {
+        GeometryIndexFixture f;
+        f.Index.Build();
+
+        Assert::AreEqual(0u, f.Index.GetFeatureCount());
+        Assert::AreEqual(-1, f.Index.FillContainsPoint(D2D1::Point2F(0, 0)));
+        Assert::AreEqual(-1, f.Index.StrokeContainsPoint(D2D1::Point2F(0, 0), 10));
+        Assert::AreEqual<size_t>(0, f.Index.GetFeaturesIntersectingRectangle(D2D1::RectF(-10, -10, 10, 10)).size());
+    }
+
+    TEST_METHOD_EX(GeometryIndex_FillContainsPoint_ReturnsTopmostFeature)
+    {
+        GeometryIndexFixture f;
+
+        f.AddRectangleFeature(0, 0, 10, 10);
+        f.AddRectangleFeature(5, 5, 15, 15);
+        f.AddFeature([] {});
+        f.Index.Build();
+
+        Assert::AreEqual(3u, f.Index.GetFeatureCount());
+
+        Assert::AreEqual(0, f.Index.FillContainsPoint(D2D1::Point2F(2, 2)));
+        Assert::AreEqual(1, f.Index.FillContainsPoint(D2D1::Point2F(7, 7)));
+        Assert::AreEqual(1, f.Index.FillContainsPoint(D2D1::Point2F(12, 12)));
+        Assert::AreEqual(-1, f.Index.FillContainsPoint(D2D1::Point2F(12, 2)));
+        Assert::AreEqual(-1, f.Index.FillContainsPoint(D2D1::Point2F(-1, 5)));
+    }
+
+    TEST_METHOD_EX(GeometryIndex_FillContainsPoint_UsesFillMode)
+    {
+        for (auto fillMode : { D2D1_FILL_MODE_ALTERNATE, D2D1_FILL_MODE_WINDING })
+        {
+            GeometryIndexFixture f;
+
+            // Two rectangles with the same winding direction, one inside the
+            // other.
+            f.AddFeature(
+                [&]
+                {
+                    f.AddFigure(GeometryIndexFixture::Rectangle(0, 0, 30, 30));
+                    f.AddFigure(GeometryIndexFixture::Rectangle(10, 10, 20, 20));
+                },
+                fillMode);
+
+            f.Index.Build();
+
+            Assert::AreEqual(0, f.Index.FillContainsPoint(D2D1::Point2F(5, 5)));
+            Assert::AreEqual(fillMode == D2D1_FILL_MODE_WINDING ? 0 : -1, f.Index.FillContainsPoint(D2D1::Point2F(15, 15)));
+        }
+    }
+
+    TEST_METHOD_EX(GeometryIndex_OpenAndHollowFigures)
+    {
+        GeometryIndexFixture f;
+
+        // Open figures are filled as if closed, but the closing edge (from
+        // 0,10 back to 0,0) is not stroked.
+        f.AddFeature([&] { f.AddFigure(GeometryIndexFixture::Rectangle(0, 0, 10, 10), D2D1_FIGURE_BEGIN_FILLED, D2D1_FIGURE_END_OPEN); });
+
+        // Hollow figures are stroked but not filled.
+        f.AddFeature([&] { f.AddFigure(GeometryIndexFixture::Rectangle(20, 0, 30, 10), D2D1_FIGURE_BEGIN_HOLLOW); });
+
+        f.Index.Build();
+
+        Assert::AreEqual(0, f.Index.FillContainsPoint(D2D1::Point2F(5, 5)));
+        Assert::AreEqual(0, f.Index.StrokeContainsPoint(D2D1::Point2F(10, 5), 1));
+        Assert::AreEqual(-1, f.Index.StrokeContainsPoint(D2D1::Point2F(0, 5), 1));
+
+        Assert::AreEqual(-1, f.Index.FillContainsPoint(D2D1::Point2F(25, 5)));
+        Assert::AreEqual(1, f.Index.StrokeContainsPoint(D2D1::Point2F(20, 5), 1));
+    }
+
+    TEST_METHOD_EX(GeometryIndex_StrokeContainsPoint)
+    {
+        GeometryIndexFixture f;
+
+        f.AddRectangleFeature(0, 0, 10, 10);
+
+        f.AddFeature(
+            [&]
+            {
+                f.Sink->BeginFigure(D2D1::Point2F(20, 0), D2D1_FIGURE_BEGIN_HOLLOW);
+                f.Sink->AddLine(D2D1::Point2F(30, 0));
+                f.Sink->SetSegmentFlags(D2D1_PATH_SEGMENT_FORCE_UNSTROKED);
+                f.Sink->AddLine(D2D1::Point2F(30, 10));
+                f.Sink->EndFigure(D2D1_FIGURE_END_OPEN);
+            });
+
+        f.Index.Build();
+
+        Assert::AreEqual(0, f.Index.StrokeContainsPoint(D2D1::Point2F(5, -1.5f), 4));
+        Assert::AreEqual(-1, f.Index.StrokeContainsPoint(D2D1::Point2F(5, -2.5f), 4));
+        Assert::AreEqual(-1, f.Index.StrokeContainsPoint(D2D1::Point2F(5, 5), 4));
+
+        // Joins and caps are round.
+        Assert::AreEqual(0, f.Index.StrokeContainsPoint(D2D1::Point2F(-1.4f, -1.4f), 4));
+        Assert::AreEqual(-1, f.Index.StrokeContainsPoint(D2D1::Point2F(-1.5f, -1.5f), 4));
+
+        Assert::AreEqual(1, f.Index.StrokeContainsPoint(D2D1::Point2F(25, 1), 4));
+        Assert::AreEqual(-1, f.Index.StrokeContainsPoint(D2D1::Point2F(31, 5), 4));
+    }
+
+    TEST_METHOD_EX(GeometryIndex_GetFeaturesIntersectingRectangle)
+    {
+        GeometryIndexFixture f;
+
+        // A square with a square hole.
+        f.AddFeature(
+            [&]
+            {
+                f.AddFigure(GeometryIndexFixture::Rectangle(0, 0, 30, 30));
+                f.AddFigure(GeometryIndexFixture::Rectangle(10, 10, 20, 20));
+            });
+
+        f.AddRectangleFeature(40, 0, 50, 10);
+        f.AddRectangleFeature(100, 100, 110, 110);
+
+        f.Index.Build();
+
+        auto inHole = f.Index.GetFeaturesIntersectingRectangle(D2D1::RectF(12, 12, 18, 18));
+        Assert::AreEqual<size_t>(0, inHole.size());
+
+        auto insideFill = f.Index.GetFeaturesIntersectingRectangle(D2D1::RectF(2, 2, 4, 4));
+        Assert::AreEqual<size_t>(1, insideFill.size());
+        Assert::AreEqual(0, insideFill[0]);
+
+        auto crossingEdges = f.Index.GetFeaturesIntersectingRectangle(D2D1::RectF(25, 5, 45, 6));
+        Assert::AreEqual<size_t>(2, crossingEdges.size());
+        Assert::AreEqual(0, crossingEdges[0]);
+        Assert::AreEqual(1, crossingEdges[1]);
+
+        auto containingAll = f.Index.GetFeaturesIntersectingRectangle(D2D1::RectF(-1, -1, 200, 200));
+        Assert::AreEqual<size_t>(3, containingAll.size());
+        Assert::AreEqual(2, containingAll[2]);
+    }
+
+    TEST_METHOD_EX(GeometryIndex_CurvesAreFlattenedWithinTolerance)
+    {
+        float const tolerance = 0.01f;
+
+        GeometryIndexFixture f(tolerance);
+
+        // A quadratic curve from 0,0 to 100,0 bulging up to y = -50 at x = 50.
+        f.AddFeature(
+            [&]
+            {
+                f.Sink->BeginFigure(D2D1::Point2F(0, 0), D2D1_FIGURE_BEGIN_FILLED);
+                f.Sink->AddQuadraticBezier(D2D1::QuadraticBezierSegment(D2D1::Point2F(50, -100), D2D1::Point2F(100, 0)));
+                f.Sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+            });
+
+        f.Index.Build();
+
+        for (float x = 5; x < 100; x += 5)
+        {
+            float t = x / 100;
+            float y = -200 * t * (1 - t);
+
+            Assert::AreEqual(0, f.Index.FillContainsPoint(D2D1::Point2F(x, y + 0.05f)));
+            Assert::AreEqual(-1, f.Index.FillContainsPoint(D2D1::Point2F(x, y - 0.05f)));
+        }
+    }
+
+    TEST_METHOD_EX(GeometryIndex_ArcsAreNotSupported)
+    {
+        GeometryIndex index;
+        auto receiver = index.CreatePathReceiver();
+
+        index.BeginFeature();
+        Assert::AreEqual(S_OK, receiver->BeginFigure(Vector2{ 0, 0 }, CanvasFigureFill::Default));
+        Assert::AreEqual(E_NOTIMPL, receiver->AddArc(Vector2{ 10, 0 }, 5, 5, 0, CanvasSweepDirection::Clockwise, CanvasArcSize::Small));
+    }
+
+    TEST_METHOD_EX(GeometryIndex_MatchesBruteForceResults)
+    {
+        GeometryIndexFixture f;
+        TestRandom random(1234);
+
+        // Rectangles on integer coordinates, queried at half-integer points
+        // so that no query lies exactly on an edge.
+        std::vector<D2D1_RECT_F> rectangles;
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            float left = static_cast<float>(random.Next(1000));
+            float top = static_cast<float>(random.Next(1000));
+            float right = left + 1 + random.Next(40);
+            float bottom = top + 1 + random.Next(40);
+
+            rectangles.push_back(D2D1::RectF(left, top, right, bottom));
+            f.AddRectangleFeature(left, top, right, bottom);
+        }
+
+        f.Index.Build();
+
+        // Distances from half-integer points to integer edges are never
+        // exactly half of this.
+        float const strokeWidth = 2.5f;
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            auto point = D2D1::Point2F(random.Next(1040) + 0.5f, random.Next(1040) + 0.5f);
+
+            int32_t expectedFill = -1;
+            int32_t expectedStroke = -1;
+
+            for (int32_t j = 0; j < static_cast<int32_t>(rectangles.size()); ++j)
+            {
+                auto& r = rectangles[j];
+
+                bool inside = point.x > r.left && point.x < r.right && point.y > r.top && point.y < r.bottom;
+
+                float distance;
+
+                if (inside)
+                {
+                    distance = std::min(std::min(point.x - r.left, r.right - point.x), std::min(point.y - r.top, r.bottom - point.y));
+                }
+                else
+                {
+                    float dx = std::max(std::max(r.left - point.x, point.x - r.right), 0.0f);
+                    float dy = std::max(std::max(r.top - point.y, point.y - r.bottom), 0.0f);
+                    distance = sqrtf(dx * dx + dy * dy);
+                }
+
+                if (inside)
+                    expectedFill = j;
+
+                if (distance <= strokeWidth / 2)
+                    expectedStroke = j;
+            }
+
+            Assert::AreEqual(expectedFill, f.Index.FillContainsPoint(point));
+            Assert::AreEqual(expectedStroke, f.Index.StrokeContainsPoint(point, strokeWidth));
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            float left = random.Next(1000) + 0.5f;
+            float top = random.Next(1000) + 0.5f;
+            auto query = D2D1::RectF(left, top, left + random.Next(100), top + random.Next(100));
+
+            std::vector<int32_t> expected;
+
+            for (int32_t j = 0; j < static_cast<int32_t>(rectangles.size()); ++j)
+            {
+                auto& r = rectangles[j];
+
+                if (query.left < r.right && r.left < query.right && query.top < r.bottom && r.top < query.bottom)
+                    expected.push_back(j);
+            }
+
+            auto actual = f.Index.GetFeaturesIntersectingRectangle(query);
+
+            Assert::AreEqual(expected.size(), actual.size());
+
+            for (size_t j = 0; j < expected.size(); ++j)
+            {
+                Assert::AreEqual(expected[j], actual[j]);
+            }
+        }
+    }
+
+    BENCHMARK_METHOD(GeometryIndex_Benchmark)
+    {
+        // Reports how long it takes to build an index of 50,000 octagons and
+        // hit-test it, for comparing changes.
+        int const columns = 250;
+        int const rows = 200;
+        int const queryCount = 100000;
+
+        GeometryIndexFixture f;
+
+        auto buildTime = TimeMilliseconds([&]
+        {
+            for (int y = 0; y < rows; ++y)
+            {
+                for (int x = 0; x < columns; ++x)
+                {
+                    f.AddFeature(
+                        [&]
+                        {
+                            std::vector<D2D1_POINT_2F> octagon;
+
+                            for (int i = 0; i < 8; ++i)
+                            {
+                                float angle = i * DirectX::XM_PIDIV4;
+                                octagon.push_back(D2D1::Point2F(x * 10 + 5 + 4 * cosf(angle), y * 10 + 5 + 4 * sinf(angle)));
+                            }
+
+                            f.AddFigure(octagon);
+                        });
+                }
+            }
+
+            f.Index.Build();
+        });
+
+        TestRandom random(5678);
+        int hitCount = 0;
+
+        auto queryTime = TimeMilliseconds([&]
+        {
+            for (int i = 0; i < queryCount; ++i)
+            {
+                int x = random.Next(columns);
+                int y = random.Next(rows);
+
+                auto result = f.Index.FillContainsPoint(D2D1::Point2F(x * 10 + 5.0f, y * 10 + 5.0f));
+
+                Assert::AreEqual(y * columns + x, result);
+                ++hitCount;
+
+                f.Index.StrokeContainsPoint(D2D1::Point2F(x * 10 + 1.0f, y * 10 + 5.0f), 1);
+            }
+        });
+
+        WriteBenchmarkResult(
+            L"%d features built in %.1fms, %d fill + stroke queries in %.1fms (%.0f ns/query)\n",
+            columns * rows,
+            buildTime,
+            hitCount,
+            queryTime,
+            queryTime * 1000000 / (hitCount * 2));
+    }
+
+    TEST_METHOD_EX(CanvasGeometryIndex_Create_SimplifiesEachGeometryOnceWithTransformAndTolerance)
+    {
+        auto device = Make<StubCanvasDevice>();
+
+        D2D1_MATRIX_3X2_F const expectedTransform = D2D1::Matrix3x2F::Scale(2, 2);
+        float const expectedTolerance = 0.5f;
+
+        std::vector<ComPtr<MockD2DRectangleGeometry>> d2dGeometries;
+        std::vector<ComPtr<ICanvasGeometry>> geometries;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            auto d2dGeometry = Make<MockD2DRectangleGeometry>();
+
+            d2dGeometry->SimplifyMethod.SetExpectedCalls(1,
+                [=](D2D1_GEOMETRY_SIMPLIFICATION_OPTION simplification, CONST D2D1_MATRIX_3X2_F* transform, FLOAT tol, ID2D1SimplifiedGeometrySink* sink)
+                {
+                    Assert::AreEqual(D2D1_GEOMETRY_SIMPLIFICATION_OPTION_LINES, simplification);
+                    Assert::AreEqual(expectedTransform, *transform);
+                    Assert::AreEqual(expectedTolerance, tol);
+
+                    // Overlapping squares, already transformed.
+                    float offset = i * 10.0f;
+                    D2D1_POINT_2F points[] = { { offset + 20, offset }, { offset + 20, offset + 20 }, { offset, offset + 20 } };
+
+                    sink->BeginFigure(D2D1::Point2F(offset, offset), D2D1_FIGURE_BEGIN_FILLED);
+                    sink->AddLines(points, _countof(points));
+                    sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+                    return S_OK;
+                });
+
+            d2dGeometries.push_back(d2dGeometry);
+            geometries.push_back(Make<CanvasGeometry>(device.Get(), d2dGeometry.Get()));
+        }
+
+        std::vector<ICanvasGeometry*> rawGeometries;
+        for (auto& g : geometries)
+            rawGeometries.push_back(g.Get());
+
+        auto factory = Make<CanvasGeometryIndexFactory>();
+
+        ComPtr<ICanvasGeometryIndex> geometryIndex;
+        Assert::AreEqual(S_OK, factory->CreateWithTransformAndFlatteningTolerance(
+            static_cast<uint32_t>(rawGeometries.size()),
+            rawGeometries.data(),
+            *ReinterpretAs<Matrix3x2 const*>(&expectedTransform),
+            expectedTolerance,
+            &geometryIndex));
+
+        int32_t count;
+        Assert::AreEqual(S_OK, geometryIndex->get_GeometryCount(&count));
+        Assert::AreEqual(3, count);
+
+        Vector2 points[] = { { 5, 5 }, { 15, 15 }, { 25, 25 }, { 35, 5 } };
+
+        ComArray<int32_t> fillResults;
+        Assert::AreEqual(S_OK, geometryIndex->FillContainsPoints(_countof(points), points, fillResults.GetAddressOfSize(), fillResults.GetAddressOfData()));
+
+        Assert::AreEqual(4u, fillResults.GetSize());
+        Assert::AreEqual(0, fillResults[0]);
+        Assert::AreEqual(1, fillResults[1]);
+        Assert::AreEqual(2, fillResults[2]);
+        Assert::AreEqual(-1, fillResults[3]);
+
+        ComArray<int32_t> strokeResults;
+        Assert::AreEqual(S_OK, geometryIndex->StrokeContainsPoints(_countof(points), points, 1, strokeResults.GetAddressOfSize(), strokeResults.GetAddressOfData()));
+
+        Assert::AreEqual(4u, strokeResults.GetSize());
+        for (uint32_t i = 0; i < strokeResults.GetSize(); ++i)
+            Assert::AreEqual(-1, strokeResults[i]);
+
+        ComArray<int32_t> rectangleResults;
+        Assert::AreEqual(S_OK, geometryIndex->GetGeometriesIntersectingRectangle(Rect{ 21, 21, 2, 2 }, rectangleResults.GetAddressOfSize(), rectangleResults.GetAddressOfData()));
+
+        Assert::AreEqual(2u, rectangleResults.GetSize());
+        Assert::AreEqual(1, rectangleResults[0]);
+        Assert::AreEqual(2, rectangleResults[1]);
+    }
+
+    TEST_METHOD_EX(CanvasGeometryIndex_InvalidArgs)
+    {
+        auto factory = Make<CanvasGeometryIndexFactory>();
+        ComPtr<ICanvasGeometryIndex> geometryIndex;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(0, nullptr, nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(1, nullptr, &geometryIndex));
+
+        ICanvasGeometry* nullGeometry = nullptr;
+        Assert::AreEqual(E_INVALIDARG, factory->Create(1, &nullGeometry, &geometryIndex));
+
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithTransformAndFlatteningTolerance(0, nullptr, Matrix3x2{ 1, 0, 0, 1, 0, 0 }, 0, &geometryIndex));
+
+        Assert::AreEqual(S_OK, factory->Create(0, nullptr, &geometryIndex));
+
+        uint32_t count;
+        ComArray<int32_t> results;
+        Assert::AreEqual(E_INVALIDARG, geometryIndex->FillContainsPoints(1, nullptr, results.GetAddressOfSize(), results.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, geometryIndex->FillContainsPoints(0, nullptr, nullptr, results.GetAddressOfData()));
+        Assert::AreEqual(E_INVALIDARG, geometryIndex->StrokeContainsPoints(0, nullptr, 1, &count, nullptr));
+        Assert::AreEqual(E_INVALIDARG, geometryIndex->GetGeometriesIntersectingRectangle(Rect{}, &count, nullptr));
+        Assert::AreEqual(E_INVALIDARG, geometryIndex->get_GeometryCount(nullptr));
+    }
+};
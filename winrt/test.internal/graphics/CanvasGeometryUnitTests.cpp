@@ -4,6 +4,7 @@
 
 #include "pch.h"
 #include <lib/geometry/CanvasPathBuilder.h>
+#include <lib/geometry/TessellationSink.h>
 #include <lib/text/CanvasFontFace.h>
 #include "mocks/MockD2DRectangleGeometry.h"
 #include "mocks/MockD2DEllipseGeometry.h"
@@ -15,6 +16,8 @@
 #include "mocks/MockDWriteFont.h"
 #include "mocks/MockGeometryAdapter.h"
 #include "stubs/StubGeometrySink.h"
+#include "stubs/StubBuffer.h"
+#include "stubs/StubTessellationReceiver.h"
 #include "stubs/StubCanvasTextLayoutAdapter.h"
 
 #if WINVER > _WIN32_WINNT_WINBLUE
@@ -1186,9 +1189,48 @@ public:
         {
             Assert::AreEqual(3u, triangles.GetSize());
 
-            Assert::AreEqual(sc_triangle1, *ReinterpretAs<D2D1_TRIANGLE const*>(&triangles[0]));
-            Assert::AreEqual(sc_triangle2, *ReinterpretAs<D2D1_TRIANGLE const*>(&triangles[1]));
-            Assert::AreEqual(sc_triangle3, *ReinterpretAs<D2D1_TRIANGLE const*>(&triangles[2]));
+            ValidateTessellatedTriangles(triangles.GetData());
+        }
+
+        void ValidateTessellatedTriangles(void const* triangles)
+        {
+            auto d2dTriangles = static_cast<D2D1_TRIANGLE const*>(triangles);
+
+            Assert::AreEqual(sc_triangle1, d2dTriangles[0]);
+            Assert::AreEqual(sc_triangle2, d2dTriangles[1]);
+            Assert::AreEqual(sc_triangle3, d2dTriangles[2]);
+        }
+
+        // Triangle i has its first vertex at (i, 0).  They are added in
+        // batches whose size does not divide the tessellation chunk size.
+        void ExpectManyTriangles(uint32_t triangleCount)
+        {
+            D2DRectangleGeometry->TessellateMethod.SetExpectedCalls(1,
+                [=](D2D1_MATRIX_3X2_F const*, float, ID2D1TessellationSink* sink)
+                {
+                    std::vector<D2D1_TRIANGLE> batch;
+
+                    for (uint32_t i = 0; i < triangleCount; ++i)
+                    {
+                        batch.push_back(D2D1_TRIANGLE{ { static_cast<float>(i), 0 } });
+
+                        if (batch.size() == 1000 || i == triangleCount - 1)
+                        {
+                            sink->AddTriangles(batch.data(), static_cast<UINT32>(batch.size()));
+                            batch.clear();
+                        }
+                    }
+
+                    return S_OK;
+                });
+        }
+
+        static void ValidateManyTriangles(CanvasTriangleVertices const* triangles, uint32_t firstIndex, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                Assert::AreEqual(static_cast<float>(firstIndex + i), triangles[i].Vertex1.X);
+            }
         }
     };
 
@@ -1230,6 +1272,154 @@ public:
         Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, t.GetAddressOfSize(), nullptr));
     }
 
+    TEST_METHOD_EX(CanvasGeometry_Tessellate_ManyTriangles)
+    {
+        TessellateFixture f;
+        ComArray<CanvasTriangleVertices> triangles;
+
+        const uint32_t triangleCount = 10000;
+
+        f.ExpectManyTriangles(triangleCount);
+
+        ThrowIfFailed(f.RectangleGeometry->Tessellate(triangles.GetAddressOfSize(), triangles.GetAddressOfData()));
+
+        Assert::AreEqual(triangleCount, triangles.GetSize());
+        f.ValidateManyTriangles(triangles.GetData(), 0, triangleCount);
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_ComputeTessellationTriangleCount)
+    {
+        TessellateFixture f;
+        UINT64 trianglesCount;
+
+        f.ExpectOneTessellateCall(sc_identityD2DTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE);
+
+        ThrowIfFailed(f.RectangleGeometry->ComputeTessellationTriangleCount(&trianglesCount));
+
+        Assert::AreEqual(3ULL, trianglesCount);
+
+        f.ExpectOneTessellateCall(sc_someD2DTransform, 23.0f);
+
+        ThrowIfFailed(f.RectangleGeometry->ComputeTessellationTriangleCountWithTransformAndFlatteningTolerance(sc_someTransform, 23.0f, &trianglesCount));
+
+        Assert::AreEqual(3ULL, trianglesCount);
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_TessellateToBuffer)
+    {
+        TessellateFixture f;
+        UINT32 trianglesCount;
+
+        // Deliberately larger than required.
+        auto buffer = Make<StubBuffer>(static_cast<uint32_t>(sizeof(CanvasTriangleVertices) * 3 + 5));
+
+        f.ExpectOneTessellateCall(sc_identityD2DTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE);
+
+        ThrowIfFailed(f.RectangleGeometry->TessellateToBuffer(buffer.Get(), &trianglesCount));
+
+        Assert::AreEqual(3u, trianglesCount);
+        Assert::AreEqual(static_cast<uint32_t>(sizeof(CanvasTriangleVertices) * 3), buffer->Length);
+        f.ValidateTessellatedTriangles(buffer->Data.data());
+
+        f.ExpectOneTessellateCall(sc_someD2DTransform, 23.0f);
+
+        ThrowIfFailed(f.RectangleGeometry->TessellateToBufferWithTransformAndFlatteningTolerance(sc_someTransform, 23.0f, buffer.Get(), &trianglesCount));
+
+        Assert::AreEqual(3u, trianglesCount);
+        f.ValidateTessellatedTriangles(buffer->Data.data());
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_TessellateToBuffer_FailsWhenBufferIsTooSmall)
+    {
+        TessellateFixture f;
+        UINT32 trianglesCount;
+
+        auto buffer = Make<StubBuffer>(static_cast<uint32_t>(sizeof(CanvasTriangleVertices) * 2));
+
+        f.ExpectOneTessellateCall(sc_identityD2DTransform, D2D1_DEFAULT_FLATTENING_TOLERANCE);
+
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateToBuffer(buffer.Get(), &trianglesCount));
+        Assert::AreEqual(0u, buffer->Length);
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_SendTrianglesTo)
+    {
+        TessellateFixture f;
+        auto receiver = Make<StubTessellationReceiver>();
+
+        f.ExpectOneTessellateCall(sc_someD2DTransform, 23.0f);
+
+        // The triangles arrive in two AddTriangles calls from D2D, but are
+        // forwarded to the receiver in a single chunk.
+        receiver->AddTrianglesMethod.SetExpectedCalls(1,
+            [&](UINT32 trianglesCount, CanvasTriangleVertices* triangles)
+            {
+                Assert::AreEqual(3u, trianglesCount);
+                f.ValidateTessellatedTriangles(triangles);
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.RectangleGeometry->SendTrianglesToWithTransformAndFlatteningTolerance(sc_someTransform, 23.0f, receiver.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_SendTrianglesTo_ManyTrianglesAreSentInChunks)
+    {
+        TessellateFixture f;
+        auto receiver = Make<StubTessellationReceiver>();
+
+        const uint32_t triangleCount = 10000;
+        uint32_t receivedCount = 0;
+
+        f.ExpectManyTriangles(triangleCount);
+
+        receiver->AddTrianglesMethod.SetExpectedCalls(3,
+            [&](UINT32 trianglesCount, CanvasTriangleVertices* triangles)
+            {
+                Assert::AreEqual(std::min(TessellationChunkSize, triangleCount - receivedCount), trianglesCount);
+                f.ValidateManyTriangles(triangles, receivedCount, trianglesCount);
+                receivedCount += trianglesCount;
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.RectangleGeometry->SendTrianglesTo(receiver.Get()));
+
+        Assert::AreEqual(triangleCount, receivedCount);
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_SendTrianglesTo_ReceiverFailureStopsTessellation)
+    {
+        TessellateFixture f;
+        auto receiver = Make<StubTessellationReceiver>();
+
+        f.ExpectManyTriangles(10000);
+
+        receiver->AddTrianglesMethod.SetExpectedCalls(1,
+            [](UINT32, CanvasTriangleVertices*)
+            {
+                return E_NOTIMPL;
+            });
+
+        Assert::AreEqual(E_NOTIMPL, f.RectangleGeometry->SendTrianglesTo(receiver.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasGeometry_StreamingTessellation_NullArgs)
+    {
+        GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
+        auto buffer = Make<StubBuffer>(1);
+        UINT32 count;
+
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->ComputeTessellationTriangleCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->ComputeTessellationTriangleCountWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateToBuffer(nullptr, &count));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateToBuffer(buffer.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateToBufferWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, nullptr, &count));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->TessellateToBufferWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, buffer.Get(), nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->SendTrianglesTo(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.RectangleGeometry->SendTrianglesToWithTransformAndFlatteningTolerance(Matrix3x2{}, 0, nullptr));
+    }
+
     TEST_METHOD_EX(CanvasGeometry_Closure)
     {
         GeometryOperationsFixture_DoesNotOutputToTempPathBuilder f;
@@ -1295,6 +1485,17 @@ public:
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->Tessellate(t.GetAddressOfSize(), t.GetAddressOfData()));
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->TessellateWithTransformAndFlatteningTolerance(m, 0, t.GetAddressOfSize(), t.GetAddressOfData()));
 
+        UINT64 triangleCount;
+        UINT32 bufferTriangleCount;
+        auto buffer = Make<StubBuffer>(1);
+        auto tessellationReceiver = Make<StubTessellationReceiver>();
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->ComputeTessellationTriangleCount(&triangleCount));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->ComputeTessellationTriangleCountWithTransformAndFlatteningTolerance(m, 0, &triangleCount));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->TessellateToBuffer(buffer.Get(), &bufferTriangleCount));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->TessellateToBufferWithTransformAndFlatteningTolerance(m, 0, buffer.Get(), &bufferTriangleCount));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->SendTrianglesTo(tessellationReceiver.Get()));
+        Assert::AreEqual(RO_E_CLOSED, canvasGeometry->SendTrianglesToWithTransformAndFlatteningTolerance(m, 0, tessellationReceiver.Get()));
+
         auto geometrySink = Make<StubGeometrySink>();
         Assert::AreEqual(RO_E_CLOSED, canvasGeometry->SendPathTo(geometrySink.Get()));
 
@@ -537,7 +537,7 @@ TEST_CLASS(CanvasGradientBrushTests)
                 };
         }
 
-        void ExpectCreateBrush(
+        ComPtr<MockD2DGradientStopCollection> ExpectCreateBrush(
             std::initializer_list<D2D1_GRADIENT_STOP> expectedStopsIl,
             D2D1_COLOR_SPACE expectedPreCS,
             D2D1_COLOR_SPACE expectedPostCS,
@@ -577,6 +577,8 @@ TEST_CLASS(CanvasGradientBrushTests)
                 });
 
             ExpectedD2DBrush = T::ExpectCreateBrush(D2DDeviceContext, collection);
+
+            return collection;
         }
 
         void Validate()
@@ -680,6 +682,44 @@ TEST_CLASS(CanvasGradientBrushTests)
         TestCreateSimple<T, Vector4>(&T::factory_t::CreateHdrSimple);
     }
 
+    template<typename T>
+    static void TestCreateSharesCachedStopCollection()
+    {
+        FactoryFixture<T> f;
+
+        ThrowIfFailed(f.Device->put_MaximumGradientStopCollectionCacheEntryCount(16));
+
+        auto startColor = Color{ 1, 2, 3, 4 };
+        auto endColor   = Color{ 5, 6, 7, 8 };
+
+        auto collection = f.ExpectCreateBrush(
+            {
+                D2D1_GRADIENT_STOP{ 0.0f, ToD2DColor(startColor) },
+                D2D1_GRADIENT_STOP{ 1.0f, ToD2DColor(endColor) }
+            },
+            D2D1_COLOR_SPACE_SRGB,
+            D2D1_COLOR_SPACE_SRGB,
+            D2D1_BUFFER_PRECISION_8BPC_UNORM,
+            D2D1_EXTEND_MODE_CLAMP,
+            D2D1_COLOR_INTERPOLATION_MODE_PREMULTIPLIED);
+
+        ThrowIfFailed(f.Factory->CreateSimple(f.Device.Get(), startColor, endColor, &f.Brush));
+        f.Validate();
+
+        // A second brush with the same stops gets the same stop collection.
+        f.D2DDeviceContext->CreateGradientStopCollectionMethod.SetExpectedCalls(0);
+        f.ExpectedD2DBrush = T::ExpectCreateBrush(f.D2DDeviceContext, collection);
+
+        ThrowIfFailed(f.Factory->CreateSimple(f.Device.Get(), startColor, endColor, &f.Brush));
+        f.Validate();
+
+        CanvasGradientStopCollectionCacheStatistics statistics;
+        ThrowIfFailed(f.Device->get_GradientStopCollectionCacheStatistics(&statistics));
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(1, statistics.MissCount);
+        Assert::AreEqual(1u, statistics.EntryCount);
+    }
+
 
     template<typename T, typename STOP>
     struct FactoryFixtureWithStops : FactoryFixture<T>
@@ -876,6 +916,8 @@ TEST_CLASS(CanvasGradientBrushTests)
     TEST_BRUSHES(CreateSimple);
     TEST_BRUSHES(CreateHdrSimple);
 
+    TEST_BRUSHES(CreateSharesCachedStopCollection);
+
     TEST_BRUSHES(CreateWithStops);
     TEST_BRUSHES(CreateHdrWithStops);
 
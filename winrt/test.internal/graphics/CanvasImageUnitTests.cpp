@@ -648,6 +648,37 @@ TEST_CLASS(CanvasImageHistogramUnitTests)
         Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogram(bitmap.Get(), rect, canvasDevice.Get(), EffectChannelSelect::Red, 1025, result.GetAddressOfSize(), result.GetAddressOfData()));
     }
 
+    TEST_METHOD_EX(CanvasImage_ComputeHistogramsAsync_InvalidArgs)
+    {
+        auto factory = Make<CanvasImageFactory>();
+        auto canvasDevice = Make<StubCanvasDevice>();
+        auto bitmap = CreateStubCanvasBitmap();
+        ComPtr<IAsyncOperation<IVectorView<float>*>> operation;
+
+        ICanvasImage* images[] = { bitmap.Get(), bitmap.Get() };
+        ICanvasImage* nullImages[] = { bitmap.Get(), nullptr };
+
+        CanvasHistogramRegion regions[] =
+        {
+            { Rect{ 1, 2, 3, 4 }, CanvasHistogramChannels::Red, 64 },
+            { Rect{ 1, 2, 3, 4 }, CanvasHistogramChannels::Green | CanvasHistogramChannels::Luminance, 64 },
+        };
+
+        CanvasHistogramRegion badRegions[] =
+        {
+            { Rect{ 1, 2, 3, 4 }, CanvasHistogramChannels::Red, 64 },
+            { Rect{ 1, 2, 3, 4 }, CanvasHistogramChannels::None, 64 },
+        };
+
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(nullptr,            2, images,     2, regions,    &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(canvasDevice.Get(), 2, images,     2, regions,    nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(canvasDevice.Get(), 2, images,     1, regions,    &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(canvasDevice.Get(), 2, nullptr,    2, regions,    &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(canvasDevice.Get(), 2, images,     2, nullptr,    &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(canvasDevice.Get(), 2, nullImages, 2, regions,    &operation));
+        Assert::AreEqual(E_INVALIDARG, factory->ComputeHistogramsAsync(canvasDevice.Get(), 2, images,     2, badRegions, &operation));
+    }
+
     static void TestComputeHistogram(float dpi)
     {
         auto factory = Make<CanvasImageFactory>();
@@ -926,17 +957,27 @@ TEST_CLASS(CanvasImageHistogramUnitTests)
         AssertExpectedRefCount(d2dAtlas1.Get(), 2);
         AssertExpectedRefCount(d2dAtlas2.Get(), 2);
 
-        // Releasing the second effects should swap them with the ones the device is currently holding.
+        // The device pools several sets of effects, so releasing the second ones keeps both.
         deviceInternal->ReleaseHistogramEffect(std::move(effects2));
 
         Assert::IsNull(effects2.HistogramEffect.Get());
         Assert::IsNull(effects2.AtlasEffect.Get());
 
-        AssertExpectedRefCount(d2dHistogram1.Get(), 1);
+        AssertExpectedRefCount(d2dHistogram1.Get(), 2);
         AssertExpectedRefCount(d2dHistogram2.Get(), 2);
-        AssertExpectedRefCount(d2dAtlas1.Get(), 1);
+        AssertExpectedRefCount(d2dAtlas1.Get(), 2);
         AssertExpectedRefCount(d2dAtlas2.Get(), 2);
 
+        // Both can now be leased again without creating new effects.
+        effects = deviceInternal->LeaseHistogramEffect(d2dContext.Get());
+        effects2 = deviceInternal->LeaseHistogramEffect(d2dContext.Get());
+
+        Assert::AreEqual<void*>(effects.HistogramEffect.Get(), d2dHistogram2.Get());
+        Assert::AreEqual<void*>(effects2.HistogramEffect.Get(), d2dHistogram1.Get());
+
+        deviceInternal->ReleaseHistogramEffect(std::move(effects));
+        deviceInternal->ReleaseHistogramEffect(std::move(effects2));
+
         // Closing the device should release everything.
         canvasDevice->Close();
 
@@ -0,0 +1,320 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/images/CanvasPixelReadback.h>
+
+TEST_CLASS(CanvasPixelReadbackUnitTests)
+{
+public:
+    //
+    // Each staging bitmap remembers the value that the source bitmap held when
+    // CopyFromBitmap was called.  The GPU is simulated as still working on a
+    // copy until the staging bitmap is mapped, so tests can check which frame
+    // a readback came from and when the CPU would have had to wait.
+    //
+    class StagingBitmap : public MockD2DBitmap
+    {
+    public:
+        std::vector<uint8_t> Pixels;
+
+        StagingBitmap(D2D1_SIZE_U size, uint8_t const* sourceValue)
+            : Pixels(size.width * size.height * 4)
+        {
+            CopyFromBitmapMethod.AllowAnyCall(
+                [=] (D2D1_POINT_2U const* destPoint, ID2D1Bitmap*, D2D1_RECT_U const*)
+                {
+                    Assert::IsNull(destPoint);
+                    std::fill(Pixels.begin(), Pixels.end(), *sourceValue);
+                    return S_OK;
+                });
+
+            MapMethod.AllowAnyCall(
+                [=] (D2D1_MAP_OPTIONS options, D2D1_MAPPED_RECT* mappedRect)
+                {
+                    Assert::AreEqual(D2D1_MAP_OPTIONS_READ, options);
+                    mappedRect->bits = Pixels.data();
+                    mappedRect->pitch = size.width * 4;
+                    return S_OK;
+                });
+
+            UnmapMethod.AllowAnyCall();
+        }
+    };
+
+    struct Fixture
+    {
+        ComPtr<MockD2DDeviceContext> DeviceContext;
+        ComPtr<StubCanvasDevice> Device;
+        ComPtr<StubD2DBitmap> D2DBitmap;
+        ComPtr<CanvasBitmap> Bitmap;
+
+        std::vector<ComPtr<StagingBitmap>> StagingBitmaps;
+
+        // Stands in for the contents of the source bitmap.
+        uint8_t SourceValue;
+
+        static const uint32_t Width = 8;
+        static const uint32_t Height = 4;
+
+        Fixture()
+            : DeviceContext(Make<MockD2DDeviceContext>())
+            , D2DBitmap(Make<StubD2DBitmap>())
+            , SourceValue(0)
+        {
+            auto d2dDevice = Make<MockD2DDevice>();
+
+            d2dDevice->MockCreateDeviceContext =
+                [=] (D2D1_DEVICE_CONTEXT_OPTIONS, ID2D1DeviceContext1** value)
+                {
+                    ThrowIfFailed(DeviceContext.CopyTo(value));
+                };
+
+            DeviceContext->CreateBitmapMethod.AllowAnyCall(
+                [=] (D2D1_SIZE_U size, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const*, ID2D1Bitmap1** bitmap)
+                {
+                    auto stagingBitmap = Make<StagingBitmap>(size, &SourceValue);
+                    StagingBitmaps.push_back(stagingBitmap);
+                    return stagingBitmap.CopyTo(bitmap);
+                });
+
+            Device = Make<StubCanvasDevice>(d2dDevice);
+
+            D2DBitmap->GetPixelSizeMethod.AllowAnyCall([] { return D2D1_SIZE_U{ Width, Height }; });
+            D2DBitmap->GetPixelFormatMethod.AllowAnyCall([] { return D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED); });
+
+            Bitmap = Make<CanvasBitmap>(Device.Get(), D2DBitmap.Get());
+        }
+
+        ComPtr<ICanvasPixelReadback> CreateReadback(int32_t latency = CanvasPixelReadback::DefaultLatency)
+        {
+            ComPtr<ICanvasPixelReadback> readback;
+            ThrowIfFailed(Make<CanvasPixelReadbackFactory>()->CreateWithLatency(Device.Get(), latency, &readback));
+            return readback;
+        }
+
+        void Enqueue(ICanvasPixelReadback* readback, uint8_t frameValue)
+        {
+            SourceValue = frameValue;
+            ThrowIfFailed(readback->Enqueue(Bitmap.Get()));
+        }
+
+        int GetMapCount()
+        {
+            int count = 0;
+            for (auto& stagingBitmap : StagingBitmaps)
+                count += stagingBitmap->MapMethod.GetCurrentCallCount();
+            return count;
+        }
+    };
+
+    static bool TryGetPixelBytes(ICanvasPixelReadback* readback, std::vector<uint8_t>* bytes)
+    {
+        ComArray<uint8_t> array;
+        boolean succeeded;
+        ThrowIfFailed(readback->TryGetPixelBytes(array.GetAddressOfSize(), array.GetAddressOfData(), &succeeded));
+
+        bytes->assign(array.begin(), array.end());
+        return !!succeeded;
+    }
+
+    static bool IsReady(ICanvasPixelReadback* readback)
+    {
+        boolean value;
+        ThrowIfFailed(readback->get_IsReady(&value));
+        return !!value;
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_Implements_Expected_Interfaces)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback();
+
+        ASSERT_IMPLEMENTS_INTERFACE(readback, ICanvasPixelReadback);
+        ASSERT_IMPLEMENTS_INTERFACE(readback, ICanvasResourceCreator);
+        ASSERT_IMPLEMENTS_INTERFACE(readback, ABI::Windows::Foundation::IClosable);
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_Create_ValidatesArguments)
+    {
+        Fixture f;
+        auto factory = Make<CanvasPixelReadbackFactory>();
+
+        ComPtr<ICanvasPixelReadback> readback;
+
+        Assert::AreEqual(E_INVALIDARG, factory->Create(nullptr, &readback));
+        Assert::AreEqual(E_INVALIDARG, factory->Create(f.Device.Get(), nullptr));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithLatency(f.Device.Get(), -1, &readback));
+        Assert::AreEqual(E_INVALIDARG, factory->CreateWithLatency(f.Device.Get(), CanvasPixelReadback::MaximumLatency + 1, &readback));
+
+        ThrowIfFailed(factory->Create(f.Device.Get(), &readback));
+
+        int32_t latency;
+        ThrowIfFailed(readback->get_Latency(&latency));
+        Assert::AreEqual(CanvasPixelReadback::DefaultLatency, latency);
+
+        ComPtr<ICanvasDevice> device;
+        ThrowIfFailed(As<ICanvasResourceCreator>(readback)->get_Device(&device));
+        Assert::IsTrue(IsSameInstance(f.Device.Get(), device.Get()));
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_Closed)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback();
+
+        Assert::AreEqual(S_OK, As<ABI::Windows::Foundation::IClosable>(readback)->Close());
+
+        int32_t latency;
+        boolean isReady;
+        ComArray<uint8_t> array;
+        boolean succeeded;
+        ComPtr<ICanvasDevice> device;
+
+        Assert::AreEqual(RO_E_CLOSED, readback->get_Latency(&latency));
+        Assert::AreEqual(RO_E_CLOSED, readback->get_IsReady(&isReady));
+        Assert::AreEqual(RO_E_CLOSED, readback->Enqueue(f.Bitmap.Get()));
+        Assert::AreEqual(RO_E_CLOSED, readback->EnqueueWithSubrectangle(f.Bitmap.Get(), 0, 0, 1, 1));
+        Assert::AreEqual(RO_E_CLOSED, readback->TryGetPixelBytes(array.GetAddressOfSize(), array.GetAddressOfData(), &succeeded));
+        Assert::AreEqual(RO_E_CLOSED, As<ICanvasResourceCreator>(readback)->get_Device(&device));
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_PixelsBecomeAvailableAfterLatencyFrames_WithoutMappingEarly)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback(2);
+
+        std::vector<uint8_t> bytes;
+
+        f.Enqueue(readback.Get(), 10);
+        Assert::IsFalse(IsReady(readback.Get()));
+        Assert::IsFalse(TryGetPixelBytes(readback.Get(), &bytes));
+        Assert::IsTrue(bytes.empty());
+
+        f.Enqueue(readback.Get(), 11);
+        Assert::IsFalse(IsReady(readback.Get()));
+        Assert::IsFalse(TryGetPixelBytes(readback.Get(), &bytes));
+
+        // Nothing has been mapped, so the CPU has never waited for the GPU.
+        Assert::AreEqual(0, f.GetMapCount());
+
+        f.Enqueue(readback.Get(), 12);
+        Assert::IsTrue(IsReady(readback.Get()));
+        Assert::AreEqual(0, f.GetMapCount());
+
+        // Frame 0's pixels are available at frame 2.
+        Assert::IsTrue(TryGetPixelBytes(readback.Get(), &bytes));
+        Assert::AreEqual<size_t>(Fixture::Width * Fixture::Height * 4, bytes.size());
+        Assert::IsTrue(std::all_of(bytes.begin(), bytes.end(), [](uint8_t b) { return b == 10; }));
+        Assert::AreEqual(1, f.GetMapCount());
+
+        // Each readback is only returned once.
+        Assert::IsFalse(IsReady(readback.Get()));
+        Assert::IsFalse(TryGetPixelBytes(readback.Get(), &bytes));
+
+        f.Enqueue(readback.Get(), 13);
+        Assert::IsTrue(TryGetPixelBytes(readback.Get(), &bytes));
+        Assert::AreEqual<uint8_t>(11, bytes[0]);
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_UnretrievedReadbacksAreSkipped)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback(1);
+
+        for (uint8_t frame = 0; frame < 5; ++frame)
+        {
+            f.Enqueue(readback.Get(), frame);
+        }
+
+        std::vector<uint8_t> bytes;
+        Assert::IsTrue(TryGetPixelBytes(readback.Get(), &bytes));
+        Assert::AreEqual<uint8_t>(3, bytes[0]);
+
+        // Only the retrieved readback was ever mapped.
+        Assert::AreEqual(1, f.GetMapCount());
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_StagingBitmapsAreReusedAcrossFrames)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback(2);
+
+        std::vector<uint8_t> bytes;
+
+        for (uint8_t frame = 0; frame < 20; ++frame)
+        {
+            f.Enqueue(readback.Get(), frame);
+            TryGetPixelBytes(readback.Get(), &bytes);
+        }
+
+        // One staging bitmap per frame in flight, plus the one being read.
+        Assert::AreEqual<size_t>(3, f.StagingBitmaps.size());
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_ZeroLatency_IsReadyImmediately)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback(0);
+
+        f.Enqueue(readback.Get(), 42);
+        Assert::IsTrue(IsReady(readback.Get()));
+
+        std::vector<uint8_t> bytes;
+        Assert::IsTrue(TryGetPixelBytes(readback.Get(), &bytes));
+        Assert::AreEqual<uint8_t>(42, bytes[0]);
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_EnqueueWithSubrectangle)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback(0);
+
+        f.DeviceContext->CreateBitmapMethod.SetExpectedCalls(1,
+            [&] (D2D1_SIZE_U, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const* properties, ID2D1Bitmap1** bitmap)
+            {
+                Assert::AreEqual(D2D1_BITMAP_OPTIONS_CPU_READ | D2D1_BITMAP_OPTIONS_CANNOT_DRAW, properties->bitmapOptions);
+
+                auto stagingBitmap = Make<StagingBitmap>(D2D1_SIZE_U{ 64, 64 }, &f.SourceValue);
+                stagingBitmap->CopyFromBitmapMethod.SetExpectedCalls(1,
+                    [] (D2D1_POINT_2U const*, ID2D1Bitmap*, D2D1_RECT_U const* sourceRect)
+                    {
+                        Assert::AreEqual(1U, sourceRect->left);
+                        Assert::AreEqual(2U, sourceRect->top);
+                        Assert::AreEqual(4U, sourceRect->right);
+                        Assert::AreEqual(3U, sourceRect->bottom);
+                        return S_OK;
+                    });
+                f.StagingBitmaps.push_back(stagingBitmap);
+                return stagingBitmap.CopyTo(bitmap);
+            });
+
+        ThrowIfFailed(readback->EnqueueWithSubrectangle(f.Bitmap.Get(), 1, 2, 3, 1));
+
+        std::vector<uint8_t> bytes;
+        Assert::IsTrue(TryGetPixelBytes(readback.Get(), &bytes));
+        Assert::AreEqual<size_t>(3 * 4, bytes.size());
+    }
+
+    TEST_METHOD_EX(CanvasPixelReadback_Enqueue_ValidatesArguments)
+    {
+        Fixture f;
+        auto readback = f.CreateReadback();
+
+        Assert::AreEqual(E_INVALIDARG, readback->Enqueue(nullptr));
+        Assert::AreEqual(E_INVALIDARG, readback->EnqueueWithSubrectangle(f.Bitmap.Get(), -1, 0, 1, 1));
+        Assert::AreEqual(E_INVALIDARG, readback->EnqueueWithSubrectangle(f.Bitmap.Get(), 0, 0, 0, 1));
+        Assert::AreEqual(E_INVALIDARG, readback->EnqueueWithSubrectangle(f.Bitmap.Get(), 0, 0, Fixture::Width + 1, 1));
+
+        auto otherDevice = Make<StubCanvasDevice>();
+        auto otherBitmap = Make<CanvasBitmap>(otherDevice.Get(), f.D2DBitmap.Get());
+
+        Assert::AreEqual(E_INVALIDARG, readback->Enqueue(otherBitmap.Get()));
+        ValidateStoredErrorState(E_INVALIDARG, Strings::PixelReadbackWrongDevice);
+
+        // Failed calls don't count as frames.
+        Assert::IsTrue(f.StagingBitmaps.empty());
+    }
+};
@@ -649,6 +649,113 @@ TEST_CLASS(CanvasPrintDocumentUnitTests)
         f.Adapter->RunNextAction();
     }
 
+    TEST_METHOD_EX(CanvasPrintDocument_MaximumConcurrentPages_DefaultsToOne_AndMustBeAtLeastOne)
+    {
+        Fixture f;
+        auto doc = f.Create();
+
+        uint32_t value = 0;
+        ThrowIfFailed(doc->get_MaximumConcurrentPages(&value));
+        Assert::AreEqual(1U, value);
+
+        Assert::AreEqual(E_INVALIDARG, doc->put_MaximumConcurrentPages(0));
+        Assert::AreEqual(E_INVALIDARG, doc->get_MaximumConcurrentPages(nullptr));
+
+        ThrowIfFailed(doc->put_MaximumConcurrentPages(4));
+        ThrowIfFailed(doc->get_MaximumConcurrentPages(&value));
+        Assert::AreEqual(4U, value);
+    }
+
+    TEST_METHOD_EX(CanvasPrintDocument_WhenMaximumConcurrentPagesIsSet_DeferredPreviewsOverlap_AndAreDrawnInOrder)
+    {
+        PrintPreviewFixture f;
+        f.RegisterPreview();
+
+        ThrowIfFailed(f.PageCollection->Paginate(AnyPageNumber, f.AnyPrintTaskOptions.Get()));
+        f.Adapter->RunNextAction();
+
+        ThrowIfFailed(f.Doc->put_MaximumConcurrentPages(2));
+
+        std::map<uint32_t, ComPtr<ICanvasPrintDeferral>> deferrals;
+        std::vector<uint32_t> previewedPages;
+        std::vector<uint32_t> drawnPages;
+
+        f.PreviewHandler.AllowAnyCall(
+            [&] (ICanvasPrintDocument*, ICanvasPreviewEventArgs* args)
+            {
+                uint32_t pageNumber;
+                ThrowIfFailed(args->get_PageNumber(&pageNumber));
+                ThrowIfFailed(args->GetDeferral(&deferrals[pageNumber]));
+                previewedPages.push_back(pageNumber);
+                return S_OK;
+            });
+
+        f.PreviewTarget->DrawPageMethod.AllowAnyCall(
+            [&] (uint32_t pageNumber, IDXGISurface*, float, float)
+            {
+                drawnPages.push_back(pageNumber);
+                return S_OK;
+            });
+
+        ThrowIfFailed(f.PageCollection->MakePage(1, AnyWidth, AnyHeight));
+        ThrowIfFailed(f.PageCollection->MakePage(2, AnyWidth, AnyHeight));
+        ThrowIfFailed(f.PageCollection->MakePage(3, AnyWidth, AnyHeight));
+        f.Adapter->Dispatcher->TickAll();
+
+        // Page 2 doesn't wait for page 1's deferral, but page 3 has to wait
+        // for one of them to finish.
+        Assert::AreEqual<size_t>(2, previewedPages.size());
+        Assert::AreEqual(1U, previewedPages[0]);
+        Assert::AreEqual(2U, previewedPages[1]);
+
+        // Page 2 finishing first isn't handed to the preview until page 1 is.
+        ThrowIfFailed(deferrals[2]->Complete());
+        f.Adapter->Dispatcher->TickAll();
+        Assert::IsTrue(drawnPages.empty());
+        Assert::AreEqual<size_t>(2, previewedPages.size());
+
+        ThrowIfFailed(deferrals[1]->Complete());
+        while (f.Adapter->Dispatcher->HasPendingActions())
+            f.Adapter->Dispatcher->TickAll();
+
+        Assert::AreEqual<size_t>(2, drawnPages.size());
+        Assert::AreEqual(1U, drawnPages[0]);
+        Assert::AreEqual(2U, drawnPages[1]);
+
+        Assert::AreEqual<size_t>(3, previewedPages.size());
+        Assert::AreEqual(3U, previewedPages[2]);
+    }
+
+    TEST_METHOD_EX(CanvasPrintDocument_WhenMaximumConcurrentPagesIsSet_AndAPageFails_TheNextMakePageReportsIt)
+    {
+        PrintPreviewFixture f;
+        f.RegisterPreview();
+
+        ThrowIfFailed(f.PageCollection->Paginate(AnyPageNumber, f.AnyPrintTaskOptions.Get()));
+        f.Adapter->RunNextAction();
+
+        ThrowIfFailed(f.Doc->put_MaximumConcurrentPages(2));
+
+        f.PreviewHandler.SetExpectedCalls(1,
+            [] (ICanvasPrintDocument*, ICanvasPreviewEventArgs*)
+            {
+                return E_UNEXPECTED;
+            });
+
+        // MakePage doesn't wait for the page, so can't fail yet.
+        ThrowIfFailed(f.PageCollection->MakePage(1, AnyWidth, AnyHeight));
+        f.Adapter->Dispatcher->TickAll();
+
+        f.PreviewHandler.SetExpectedCalls(0);
+        Assert::AreEqual(E_UNEXPECTED, f.PageCollection->MakePage(2, AnyWidth, AnyHeight));
+        f.Adapter->Dispatcher->TickAll();
+
+        // The failure is only reported once.
+        f.PreviewHandler.SetExpectedCalls(1);
+        ThrowIfFailed(f.PageCollection->MakePage(2, AnyWidth, AnyHeight));
+        f.Adapter->Dispatcher->TickAll();
+    }
+
     struct PrintFixture : public Fixture
     {
         ComPtr<ICanvasPrintDocument> Doc;
@@ -1158,6 +1265,49 @@ TEST_CLASS(CanvasPrintEventArgsUnitTests)
         ValidateStoredErrorState(E_FAIL, Strings::CannotCreateDrawingSessionUntilPreviousOneClosed);
     }
 
+    TEST_METHOD_EX(CanvasPrintEventArgs_WithConcurrentPages_SeveralDrawingSessionsCanBeOpen_AndPagesAreAddedInOrder)
+    {
+        Fixture f;
+
+        auto args = Make<CanvasPrintEventArgs>(f.Task.get(), f.Device, f.AnyTarget, f.PrintTaskOptions, AnyDpi, 2);
+
+        ComPtr<ICanvasDrawingSession> ds[3];
+        ComPtr<ID2D1Image> commandLists[2];
+
+        for (int i = 0; i < 2; ++i)
+        {
+            ThrowIfFailed(args->CreateDrawingSession(&ds[i]));
+            GetWrappedResource<ID2D1DeviceContext>(ds[i])->GetTarget(&commandLists[i]);
+        }
+
+        // Both pages are in flight, so a third can't be started yet.
+        Assert::AreEqual(E_FAIL, args->CreateDrawingSession(&ds[2]));
+
+        std::vector<ID2D1CommandList*> addedPages;
+        f.PrintControl->AddPageMethod.AllowAnyCall(
+            [&] (ID2D1CommandList* commandList, D2D_SIZE_F, IStream*, D2D1_TAG*, D2D1_TAG*)
+            {
+                addedPages.push_back(commandList);
+                return S_OK;
+            });
+
+        // The second page can't be added until the first has been.
+        ThrowIfFailed(As<IClosable>(ds[1])->Close());
+        Assert::IsTrue(addedPages.empty());
+
+        // ...and it still counts towards the limit until then.
+        Assert::AreEqual(E_FAIL, args->CreateDrawingSession(&ds[2]));
+
+        ThrowIfFailed(As<IClosable>(ds[0])->Close());
+        Assert::AreEqual<size_t>(2, addedPages.size());
+        Assert::IsTrue(IsSameInstance(commandLists[0].Get(), addedPages[0]));
+        Assert::IsTrue(IsSameInstance(commandLists[1].Get(), addedPages[1]));
+
+        ThrowIfFailed(args->CreateDrawingSession(&ds[2]));
+        ThrowIfFailed(As<IClosable>(ds[2])->Close());
+        Assert::AreEqual<size_t>(3, addedPages.size());
+    }
+
     TEST_METHOD_EX(CanvasPrintEventArgs_When_GetDeferralCalledMultipleTimes_SecondCallFails)
     {
         Fixture f;
@@ -1197,6 +1347,20 @@ TEST_CLASS(CanvasPrintDeferrableTaskUnitTests)
             return future;
         }
 
+        std::future<void> ScheduleConcurrent(uint32_t key, DeferrableFn&& fn)
+        {
+            auto task = Scheduler.CreateTask(std::move(fn));
+            auto future = task->GetFuture();
+            Scheduler.ScheduleConcurrent(std::move(task), key);
+            return future;
+        }
+
+        void TickDispatcherUntilDone()
+        {
+            while (Dispatcher->HasPendingActions())
+                Dispatcher->TickAll();
+        }
+
         void TickDispatcherOnOtherThreadUntilDone()
         {
             auto future = std::async(std::launch::async,
@@ -1313,7 +1477,153 @@ TEST_CLASS(CanvasPrintDeferrableTaskUnitTests)
         Assert::IsTrue(future.wait_for(Timeout) == std::future_status::ready);
         future.get();
     }
-};
 
+    //
+    // Records when each of a set of concurrent tasks is invoked and completes,
+    // and holds on to their deferrals so the test can complete them.
+    //
+    struct ConcurrentFixture : public Fixture
+    {
+        std::vector<uint32_t> Invoked;
+        std::vector<uint32_t> Completed;
+        std::map<uint32_t, ComPtr<CanvasPrintDeferral>> Deferrals;
 
+        void ScheduleDeferred(uint32_t key)
+        {
+            ScheduleConcurrent(key,
+                [=] (DeferrableTask* task)
+                {
+                    Invoked.push_back(key);
+                    Deferrals[key] = task->GetDeferral();
+                    task->SetCompletionFn([=] { Completed.push_back(key); });
+                });
+        }
+
+        void Complete(uint32_t key)
+        {
+            ThrowIfFailed(Deferrals[key]->Complete());
+            TickDispatcherUntilDone();
+        }
+    };
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTaskScheduler_ConcurrentTasks_StartWhileEarlierOnesAreDeferred_UpToTheMaximum)
+    {
+        ConcurrentFixture f;
+        f.Scheduler.SetMaximumConcurrentTasks(2);
+
+        f.ScheduleDeferred(1);
+        f.ScheduleDeferred(2);
+        f.ScheduleDeferred(3);
+        f.TickDispatcherUntilDone();
+
+        Assert::AreEqual<size_t>(2, f.Invoked.size());
+
+        f.Complete(1);
+        Assert::AreEqual<size_t>(3, f.Invoked.size());
+        Assert::AreEqual(3U, f.Invoked[2]);
+
+        // Raising the maximum starts pending tasks straight away.
+        f.ScheduleDeferred(4);
+        f.ScheduleDeferred(5);
+        f.TickDispatcherUntilDone();
+        Assert::AreEqual<size_t>(3, f.Invoked.size());
+
+        f.Scheduler.SetMaximumConcurrentTasks(4);
+        f.TickDispatcherUntilDone();
+        Assert::AreEqual<size_t>(5, f.Invoked.size());
+    }
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTaskScheduler_ConcurrentTasks_CompleteInTheOrderTheyStarted)
+    {
+        ConcurrentFixture f;
+        f.Scheduler.SetMaximumConcurrentTasks(3);
 
+        f.ScheduleDeferred(1);
+        f.ScheduleDeferred(2);
+        f.ScheduleDeferred(3);
+        f.TickDispatcherUntilDone();
+
+        f.Complete(3);
+        f.Complete(2);
+        Assert::IsTrue(f.Completed.empty());
+
+        f.Complete(1);
+        Assert::AreEqual<size_t>(3, f.Completed.size());
+        Assert::AreEqual(1U, f.Completed[0]);
+        Assert::AreEqual(2U, f.Completed[1]);
+        Assert::AreEqual(3U, f.Completed[2]);
+    }
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTaskScheduler_FailedConcurrentTask_DoesNotHoldUpLaterCompletions)
+    {
+        ConcurrentFixture f;
+        f.Scheduler.SetMaximumConcurrentTasks(2);
+
+        f.ScheduleDeferred(1);
+
+        auto failedFuture = f.ScheduleConcurrent(2,
+            [&] (DeferrableTask*)
+            {
+                ThrowHR(AnyHR);
+            });
+
+        f.TickDispatcherUntilDone();
+        ExpectHResultException(AnyHR, [&] { failedFuture.get(); });
+
+        f.Complete(1);
+        Assert::AreEqual<size_t>(1, f.Completed.size());
+    }
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTaskScheduler_PendingConcurrentTasks_StartNearestTheFocusFirst)
+    {
+        ConcurrentFixture f;
+
+        f.ScheduleDeferred(1);
+        f.ScheduleDeferred(2);
+        f.ScheduleDeferred(9);
+        f.ScheduleDeferred(5);
+        f.Scheduler.SetFocus(8);
+        f.TickDispatcherUntilDone();
+
+        f.Complete(1);
+        f.Complete(9);
+        f.Complete(5);
+        f.Complete(2);
+
+        Assert::AreEqual<size_t>(4, f.Invoked.size());
+        Assert::AreEqual(1U, f.Invoked[0]);
+        Assert::AreEqual(9U, f.Invoked[1]);
+        Assert::AreEqual(5U, f.Invoked[2]);
+        Assert::AreEqual(2U, f.Invoked[3]);
+    }
+
+    TEST_METHOD_EX(CanvasPrint_DeferrableTaskScheduler_ExclusiveTasks_WaitForConcurrentTasks_AndHoldBackLaterOnes)
+    {
+        ConcurrentFixture f;
+        f.Scheduler.SetMaximumConcurrentTasks(4);
+
+        bool exclusiveTaskInvoked = false;
+
+        f.ScheduleDeferred(1);
+        f.Schedule(
+            [&] (DeferrableTask* task)
+            {
+                exclusiveTaskInvoked = true;
+                task->SetCompletionFn([] {});
+                task->NonDeferredComplete();
+            });
+        f.ScheduleDeferred(2);
+        f.Scheduler.SetFocus(2);
+        f.TickDispatcherUntilDone();
+
+        // Even though task 2 is nearest the focus it can't start before the
+        // exclusive task scheduled ahead of it.
+        Assert::AreEqual<size_t>(1, f.Invoked.size());
+        Assert::IsFalse(exclusiveTaskInvoked);
+
+        f.Complete(1);
+        Assert::IsTrue(exclusiveTaskInvoked);
+        Assert::AreEqual<size_t>(2, f.Invoked.size());
+        Assert::AreEqual(2U, f.Invoked[1]);
+    }
+};
@@ -687,6 +687,12 @@ public:
         Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawFromSpriteSheetToRectWithTintAndFlip(nullptr, destRect, sourceRect, tint, flip)); 
         Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawFromSpriteSheetWithTransformAndTintAndFlip(nullptr, transform, sourceRect, tint, flip)); 
         Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawFromSpriteSheetAtOffsetWithTintAndTransform(nullptr, offset, sourceRect, tint, origin, rotation, scale, flip)); 
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyToRects(nullptr, 1, &destRect));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyWithTransforms(nullptr, 1, &transform));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyToRectsWithTints(nullptr, 1, &destRect, 1, &tint));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyWithTransformsAndTints(nullptr, 1, &transform, 1, &tint));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyFromSpriteSheetToRectsWithTints(nullptr, 1, &destRect, 1, &sourceRect, 1, &tint));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyFromSpriteSheetWithTransformsAndTints(nullptr, 1, &transform, 1, &sourceRect, 1, &tint));
     }
 
 
@@ -725,6 +731,12 @@ public:
         Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawFromSpriteSheetToRectWithTintAndFlip(bitmap, destRect, sourceRect, tint, flip)); 
         Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawFromSpriteSheetWithTransformAndTintAndFlip(bitmap, transform, sourceRect, tint, flip)); 
         Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawFromSpriteSheetAtOffsetWithTintAndTransform(bitmap, offset, sourceRect, tint, origin, rotation, scale, flip));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawManyToRects(bitmap, 1, &destRect));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawManyWithTransforms(bitmap, 1, &transform));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawManyToRectsWithTints(bitmap, 1, &destRect, 1, &tint));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawManyWithTransformsAndTints(bitmap, 1, &transform, 1, &tint));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawManyFromSpriteSheetToRectsWithTints(bitmap, 1, &destRect, 1, &sourceRect, 1, &tint));
+        Assert::AreEqual(RO_E_CLOSED, f.SpriteBatch->DrawManyFromSpriteSheetWithTransformsAndTints(bitmap, 1, &transform, 1, &sourceRect, 1, &tint));
 
         ComPtr<ICanvasDevice> device;
         Assert::AreEqual(RO_E_CLOSED, As<ICanvasResourceCreator>(f.SpriteBatch)->get_Device(&device));
@@ -1298,6 +1310,251 @@ public:
     }
 
 
+    //
+    // DrawMany
+    //
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawManyToRects)
+    {
+        DrawFixture f;
+
+        ThrowIfFailed(f.SpriteBatch->DrawManyToRects(f.Bitmap.Get(), _countof(gRects), gRects));
+
+        for (auto rect : gRects)
+            f.ExpectSprite(ToD2DRect(rect), f.FullBitmapSourceRect());
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawManyWithTransforms)
+    {
+        DrawFixture f;
+
+        ThrowIfFailed(f.SpriteBatch->DrawManyWithTransforms(f.Bitmap.Get(), _countof(gMatrices), gMatrices));
+
+        for (auto matrix : gMatrices)
+        {
+            f.ExpectSprite(
+                f.FullBitmapDestRect(float2::zero()),
+                f.FullBitmapSourceRect(),
+                D2D1_COLOR_F{ 1.0f, 1.0f, 1.0f, 1.0f },
+                *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&matrix));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawManyToRectsWithTints)
+    {
+        static_assert(_countof(gRects) == _countof(gTints), "test expects one tint per rect");
+
+        DrawFixture f;
+
+        // One tint per sprite
+        ThrowIfFailed(f.SpriteBatch->DrawManyToRectsWithTints(f.Bitmap.Get(), _countof(gRects), gRects, _countof(gTints), gTints));
+
+        for (size_t i = 0; i < _countof(gRects); ++i)
+            f.ExpectSprite(ToD2DRect(gRects[i]), f.FullBitmapSourceRect(), *ReinterpretAs<D2D1_COLOR_F*>(&gTints[i]));
+
+        // A single tint is used for every sprite
+        ThrowIfFailed(f.SpriteBatch->DrawManyToRectsWithTints(f.Bitmap.Get(), _countof(gRects), gRects, 1, &gAnyTint));
+
+        for (auto rect : gRects)
+            f.ExpectSprite(ToD2DRect(rect), f.FullBitmapSourceRect(), *ReinterpretAs<D2D1_COLOR_F*>(&gAnyTint));
+
+        // No tints means no tinting
+        ThrowIfFailed(f.SpriteBatch->DrawManyToRectsWithTints(f.Bitmap.Get(), _countof(gRects), gRects, 0, nullptr));
+
+        for (auto rect : gRects)
+            f.ExpectSprite(ToD2DRect(rect), f.FullBitmapSourceRect());
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawManyWithTransformsAndTints)
+    {
+        DrawFixture f;
+
+        ThrowIfFailed(f.SpriteBatch->DrawManyWithTransformsAndTints(f.Bitmap.Get(), _countof(gMatrices), gMatrices, 1, &gAnyTint));
+
+        for (auto matrix : gMatrices)
+        {
+            f.ExpectSprite(
+                f.FullBitmapDestRect(float2::zero()),
+                f.FullBitmapSourceRect(),
+                *ReinterpretAs<D2D1_COLOR_F*>(&gAnyTint),
+                *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&matrix));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawManyFromSpriteSheetToRectsWithTints)
+    {
+        DrawFixture f;
+
+        auto width = 30.0f;
+        auto height = 40.0f;
+        Rect sourceRects[] =
+        {
+            Rect{ 10.0f, 20.0f, width, height },
+            Rect{ 20.0f, 10.0f, width, height },
+            Rect{ 0.0f, 0.0f, width, height }
+        };
+
+        static_assert(_countof(gRects) == _countof(sourceRects), "test expects one source rect per dest rect");
+
+        ThrowIfFailed(f.SpriteBatch->DrawManyFromSpriteSheetToRectsWithTints(f.Bitmap.Get(), _countof(gRects), gRects, _countof(sourceRects), sourceRects, 1, &gAnyTint));
+
+        for (size_t i = 0; i < _countof(gRects); ++i)
+        {
+            auto left = static_cast<uint32_t>(sourceRects[i].X * 2);
+            auto top = static_cast<uint32_t>(sourceRects[i].Y * 2);
+
+            f.ExpectSprite(
+                ToD2DRect(gRects[i]),
+                D2D1_RECT_U{ left, top, static_cast<uint32_t>(left + width * 2), static_cast<uint32_t>(top + height * 2) },
+                *ReinterpretAs<D2D1_COLOR_F*>(&gAnyTint));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawManyFromSpriteSheetWithTransformsAndTints)
+    {
+        DrawFixture f;
+
+        Rect sourceRect{ 10.0f, 20.0f, 30.0f, 40.0f };
+        Rect sourceRects[] = { sourceRect, sourceRect };
+
+        static_assert(_countof(gMatrices) == _countof(sourceRects), "test expects one source rect per transform");
+
+        ThrowIfFailed(f.SpriteBatch->DrawManyFromSpriteSheetWithTransformsAndTints(f.Bitmap.Get(), _countof(gMatrices), gMatrices, _countof(sourceRects), sourceRects, 0, nullptr));
+
+        for (auto matrix : gMatrices)
+        {
+            f.ExpectSprite(
+                D2D1_RECT_F{ 0.0f, 0.0f, 30.0f, 40.0f },
+                D2D1_RECT_U{ 20, 40, 80, 120 },
+                D2D1_COLOR_F{ 1.0f, 1.0f, 1.0f, 1.0f },
+                *ReinterpretAs<D2D1_MATRIX_3X2_F*>(&matrix));
+        }
+
+        f.Validate();
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawMany_FailsWhenPassedInvalidArrays)
+    {
+        DrawFixture f;
+
+        auto bitmap = f.Bitmap.Get();
+        Rect rects[2]{};
+        Matrix3x2 transforms[2]{};
+        Vector4 tints[2]{};
+
+        // Null arrays
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyToRects(bitmap, 2, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyWithTransforms(bitmap, 2, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyToRectsWithTints(bitmap, 2, rects, 2, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyFromSpriteSheetToRectsWithTints(bitmap, 2, rects, 2, nullptr, 0, nullptr));
+
+        // Tints must be empty, a single value or one per sprite
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyWithTransformsAndTints(bitmap, 1, transforms, 2, tints));
+
+        // Source rects must be one per sprite
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyFromSpriteSheetToRectsWithTints(bitmap, 2, rects, 1, rects, 0, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.SpriteBatch->DrawManyFromSpriteSheetWithTransformsAndTints(bitmap, 2, transforms, 1, rects, 0, nullptr));
+
+        // Nothing was added, so closing the batch shouldn't draw anything
+        ThrowIfFailed(As<IClosable>(f.SpriteBatch)->Close());
+    }
+
+
+    TEST_METHOD_EX(CanvasSpriteBatch_DrawMany_WithNoSprites_DoesNothing)
+    {
+        DrawFixture f;
+
+        ThrowIfFailed(f.SpriteBatch->DrawManyToRects(f.Bitmap.Get(), 0, nullptr));
+        ThrowIfFailed(f.SpriteBatch->DrawManyWithTransformsAndTints(f.Bitmap.Get(), 0, nullptr, 0, nullptr));
+
+        ThrowIfFailed(As<IClosable>(f.SpriteBatch)->Close());
+    }
+
+
+    BENCHMARK_METHOD(CanvasSpriteBatch_DrawMany_SubmissionBenchmark)
+    {
+        //
+        // Compares adding sprites one at a time with adding them all in one
+        // call.  Only the relative timings are interesting; the assertions
+        // just make sure both paths produced the same number of sprites.
+        //
+
+        const uint32_t spriteCount = 20000;
+
+        std::vector<Matrix3x2> transforms(spriteCount);
+        std::vector<Vector4> tints(spriteCount);
+
+        for (uint32_t i = 0; i < spriteCount; ++i)
+        {
+            transforms[i] = Matrix3x2{ 1, 0, 0, 1, static_cast<float>(i % 100), static_cast<float>(i / 100) };
+            tints[i] = Vector4{ 1, 1, 1, static_cast<float>(i % 256) / 255.0f };
+        }
+
+        auto timeSubmission = [&] (std::function<void(ICanvasSpriteBatch*, ICanvasBitmap*)> submit)
+        {
+            Fixture f;
+
+            ComPtr<ICanvasSpriteBatch> spriteBatch;
+            ThrowIfFailed(f.DrawingSession->CreateSpriteBatch(&spriteBatch));
+
+            auto d2dSpriteBatch = f.ExpectCreateSpriteBatch();
+
+            uint32_t addedCount = 0;
+            d2dSpriteBatch->AddSpritesMethod.SetExpectedCalls(1,
+                [&] (uint32_t count, auto, auto, auto, auto, auto, auto, auto, auto)
+                {
+                    addedCount = count;
+                    return S_OK;
+                });
+
+            f.DeviceContext->DrawSpriteBatchMethod.SetExpectedCalls(1);
+
+            auto elapsed = TimeMilliseconds([&] { submit(spriteBatch.Get(), f.Bitmap.Get()); });
+
+            ThrowIfFailed(As<IClosable>(spriteBatch)->Close());
+            Assert::AreEqual(spriteCount, addedCount);
+
+            return elapsed;
+        };
+
+        auto perSpriteTime = timeSubmission(
+            [&] (ICanvasSpriteBatch* spriteBatch, ICanvasBitmap* bitmap)
+            {
+                for (uint32_t i = 0; i < spriteCount; ++i)
+                    ThrowIfFailed(spriteBatch->DrawWithTransformAndTint(bitmap, transforms[i], tints[i]));
+            });
+
+        auto drawManyTime = timeSubmission(
+            [&] (ICanvasSpriteBatch* spriteBatch, ICanvasBitmap* bitmap)
+            {
+                ThrowIfFailed(spriteBatch->DrawManyWithTransformsAndTints(bitmap, spriteCount, transforms.data(), spriteCount, tints.data()));
+            });
+
+        WriteBenchmarkResult(
+            L"%u sprites: per-sprite Draw %.2fms, DrawMany %.2fms (%.1fx)\n",
+            spriteCount,
+            perSpriteTime,
+            drawManyTime,
+            drawManyTime > 0 ? perSpriteTime / drawManyTime : 0.0);
+    }
+
+
     //
     // Multiple bitmaps and sorting
     //
@@ -1483,10 +1740,8 @@ public:
     {
         MultipleBitmapFixture f(CanvasSpriteSortMode::Bitmap);
 
-        // Ensure that f.Bitmaps is sorted by the D2D bitmap pointer (this is
-        // the default sort order)
-        std::sort(f.Bitmaps.begin(), f.Bitmaps.end());
-
+        // Sprites are grouped by bitmap, with the groups appearing in the
+        // order that each bitmap was first drawn.
         f.Add(f.Bitmaps[0], 0);
         f.Add(f.Bitmaps[1], 1);
         f.Add(f.Bitmaps[2], 2);
@@ -1522,6 +1777,37 @@ public:
         f.Validate();
     }
 
+    TEST_METHOD_EX(CanvasSpriteBatch_WhenSorted_BitmapsAppearInTheOrderTheyWereFirstDrawn)
+    {
+        MultipleBitmapFixture f(CanvasSpriteSortMode::Bitmap);
+
+        f.Add(f.Bitmaps[2], 0);
+        f.Add(f.Bitmaps[0], 1);
+        f.Add(f.Bitmaps[2], 2);
+        f.Add(f.Bitmaps[3], 3);
+        f.Add(f.Bitmaps[1], 4);
+        f.Add(f.Bitmaps[0], 5);
+        f.Add(f.Bitmaps[3], 6);
+
+        f.Expect(0); // 0: bitmap 2
+        f.Expect(2); // 1: bitmap 2
+        f.Expect(1); // 2: bitmap 0
+        f.Expect(5); // 3: bitmap 0
+        f.Expect(3); // 4: bitmap 3
+        f.Expect(6); // 5: bitmap 3
+        f.Expect(4); // 6: bitmap 1
+
+        f.ExpectBatches(
+        {
+            { f.Bitmaps[2], 0, 2 },
+            { f.Bitmaps[0], 2, 2 },
+            { f.Bitmaps[3], 4, 2 },
+            { f.Bitmaps[1], 6, 1 }
+        });
+
+        f.Validate();
+    }
+
     TEST_METHOD_EX(CanvasSpriteBatch_When_AntialiasingIsEnabled_ItMustBeDisabledAroundCallsToDrawSpriteBatch)
     {
         MultipleBitmapFixture f;
@@ -1612,6 +1898,37 @@ public:
             f.Validate();
         }
     }
+
+    TEST_METHOD_EX(CanvasSpriteBatch_StorageForLargeBatchesIsRecycled)
+    {
+        // Empty the recycle bin, so that what we get back below is ours.
+        auto recycled1 = SpriteBatchStorage::Acquire();
+        auto recycled2 = SpriteBatchStorage::Acquire();
+
+        const size_t spriteCount = 100000;
+
+        auto storage = SpriteBatchStorage::Acquire();
+        storage->Reserve(spriteCount);
+        auto storagePointer = storage.get();
+
+        SpriteBatchStorage::Recycle(std::move(storage));
+
+        auto reused = SpriteBatchStorage::Acquire();
+        Assert::IsTrue(storagePointer == reused.get());
+        Assert::IsTrue(reused->Empty());
+        Assert::IsTrue(reused->BitmapIndices.capacity() >= spriteCount);
+        Assert::IsTrue(reused->Transforms.capacity() >= spriteCount);
+
+        // Storage beyond the limit is released instead.
+        reused->Reserve(SpriteBatchStorage::MaxRecycledSpriteCount + 1);
+        SpriteBatchStorage::Recycle(std::move(reused));
+
+        auto notReused = SpriteBatchStorage::Acquire();
+        Assert::AreEqual<size_t>(0, notReused->BitmapIndices.capacity());
+
+        SpriteBatchStorage::Recycle(std::move(recycled1));
+        SpriteBatchStorage::Recycle(std::move(recycled2));
+    }
 };
 
 #endif
@@ -173,6 +173,115 @@ namespace canvas
             Assert::AreEqual(L"something", static_cast<wchar_t const*>(returnedXml));
         }
 
+        TEST_METHOD_EX(CanvasSvgDocumentTests_GetXml_ResultIncludesTrailingNullCharacter)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            f.m_createdDocument->SerializeMethod.SetExpectedCalls(1,
+                [=](IStream* stream, ID2D1SvgElement*)
+                {
+                    // Two chunks, neither of which is null terminated.
+                    char const documentText[] = { '<', 's', 'v', 'g' };
+                    char const moreDocumentText[] = { '/', '>' };
+
+                    Assert::AreEqual(S_OK, stream->Write(documentText, _countof(documentText), nullptr));
+                    Assert::AreEqual(S_OK, stream->Write(moreDocumentText, _countof(moreDocumentText), nullptr));
+
+                    return S_OK;
+                });
+
+            WinString returnedXml;
+            Assert::AreEqual(S_OK, svgDocument->GetXml(returnedXml.GetAddressOf()));
+
+            // The string contents are the document text followed by a null character.
+            uint32_t length;
+            auto buffer = WindowsGetStringRawBuffer(returnedXml, &length);
+
+            Assert::AreEqual(7u, length);
+            Assert::AreEqual(L"<svg/>", buffer);
+            Assert::AreEqual(L'\0', buffer[6]);
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_GetXml_ConvertsSequencesSplitAcrossWrites)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            f.m_createdDocument->SerializeMethod.SetExpectedCalls(1,
+                [=](IStream* stream, ID2D1SvgElement*)
+                {
+                    // "a", EURO SIGN, GRINNING FACE, "b", written a byte at a time so
+                    // that every multi-byte sequence is split between writes.
+                    unsigned char const documentText[] = { 'a', 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80, 'b' };
+
+                    for (auto value : documentText)
+                    {
+                        ULONG written;
+                        Assert::AreEqual(S_OK, stream->Write(&value, 1, &written));
+                        Assert::AreEqual(1u, static_cast<uint32_t>(written));
+                    }
+
+                    return S_OK;
+                });
+
+            WinString returnedXml;
+            Assert::AreEqual(S_OK, svgDocument->GetXml(returnedXml.GetAddressOf()));
+            Assert::AreEqual(L"a\u20AC\U0001F600b", static_cast<wchar_t const*>(returnedXml));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_GetXml_ReplacesIncompleteSequences)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            f.m_createdDocument->SerializeMethod.SetExpectedCalls(1,
+                [=](IStream* stream, ID2D1SvgElement*)
+                {
+                    // A three byte sequence cut short by "b", and another cut short by
+                    // the end of the document.
+                    unsigned char const documentText[] = { 'a', 0xE2, 0x82 };
+                    unsigned char const moreDocumentText[] = { 'b', 0xE2 };
+
+                    Assert::AreEqual(S_OK, stream->Write(documentText, _countof(documentText), nullptr));
+                    Assert::AreEqual(S_OK, stream->Write(moreDocumentText, _countof(moreDocumentText), nullptr));
+
+                    return S_OK;
+                });
+
+            WinString returnedXml;
+            Assert::AreEqual(S_OK, svgDocument->GetXml(returnedXml.GetAddressOf()));
+
+            std::wstring xml(static_cast<wchar_t const*>(returnedXml));
+            Assert::AreEqual(L'a', xml.front());
+            Assert::AreEqual(L'\uFFFD', xml.back());
+            Assert::AreNotEqual(std::wstring::npos, xml.find(L'b'));
+        }
+
+        TEST_METHOD_EX(CanvasSvgDocumentTests_GetXml_FailsWhenNothingIsWritten)
+        {
+            Fixture f;
+            auto svgDocument = f.CreateSvgDocument();
+
+            f.m_createdDocument->SerializeMethod.SetExpectedCalls(1,
+                [=](IStream* stream, ID2D1SvgElement*)
+                {
+                    // Only seeks that stay at the current position are supported.
+                    ULARGE_INTEGER position;
+                    Assert::AreEqual(S_OK, stream->Seek(LARGE_INTEGER{}, STREAM_SEEK_CUR, &position));
+                    Assert::AreEqual<uint64_t>(0, position.QuadPart);
+
+                    LARGE_INTEGER distance;
+                    distance.QuadPart = 1;
+                    Assert::AreEqual(STG_E_INVALIDFUNCTION, stream->Seek(distance, STREAM_SEEK_SET, nullptr));
+
+                    return S_OK;
+                });
+
+            WinString returnedXml;
+            Assert::AreEqual(E_INVALIDARG, svgDocument->GetXml(returnedXml.GetAddressOf()));
+        }
+
         static ComPtr<CanvasSvgDocumentStatics> GetSvgDocumentStatics()
         {
             ComPtr<CanvasSvgDocumentStatics> svgDocumentStatics;
@@ -6,6 +6,7 @@
 #include "mocks/MockCoreWindow.h"
 #include "mocks/MockDXGIAdapter.h"
 #include "mocks/MockDXGIFactory.h"
+#include "stubs/StubCanvasBrush.h"
 #include "stubs/StubDxgiDevice.h"
 #include "stubs/StubDxgiSwapChain.h"
 
@@ -19,7 +20,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         {
             m_canvasDevice = Make<StubCanvasDevice>();
             
-            m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+            m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
             {
                 auto dxgiSwapChain = Make<MockDxgiSwapChain>();
                 dxgiSwapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
@@ -47,7 +48,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         const int dpiScale = 2;
 
         f.m_canvasDevice->CreateSwapChainForCompositionMethod.SetExpectedCalls(1, 
-            [=](int32_t widthInPixels, int32_t heightInPixels, DirectXPixelFormat format, int32_t bufferCount, CanvasAlphaMode alphaMode)
+            [=](int32_t widthInPixels, int32_t heightInPixels, DirectXPixelFormat format, int32_t bufferCount, CanvasAlphaMode alphaMode, bool)
             {
                 Assert::AreEqual(23 * dpiScale, widthInPixels);
                 Assert::AreEqual(45 * dpiScale, heightInPixels);
@@ -342,6 +343,10 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->get_Device(&device));
 
         Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->WaitForVerticalBlank());
+
+        boolean b;
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->get_TrackDirtyRegions(&b));
+        Assert::AreEqual(RO_E_CLOSED, canvasSwapChain->put_TrackDirtyRegions(true));
     }
 
 
@@ -359,6 +364,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_BufferCount(nullptr));
         Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_AlphaMode(nullptr));
         Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_Device(nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->get_TrackDirtyRegions(nullptr));
     }
 
     void ResetForPropertyTest(ComPtr<MockDxgiSwapChain>& swapChain)
@@ -385,7 +391,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
 
         swapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             return swapChain;
         });
@@ -437,7 +443,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         auto swapChain = Make<MockDxgiSwapChain>();
         swapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             return swapChain;
         });
@@ -470,7 +476,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         auto swapChain = Make<MockDxgiSwapChain>();
         swapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             return swapChain;
         });
@@ -505,7 +511,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         auto swapChain = Make<MockDxgiSwapChain>();
         swapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             return swapChain;
         });
@@ -546,7 +552,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         auto swapChain = Make<MockDxgiSwapChain>();
         swapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             return swapChain;
         });
@@ -584,7 +590,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         auto swapChain = Make<MockDxgiSwapChain>();
         swapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             return swapChain;
         });
@@ -617,7 +623,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
     {
         StubDeviceFixture f;
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             auto swapChain = Make<StubDxgiSwapChain>();
 
@@ -644,13 +650,92 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         ThrowIfFailed(canvasSwapChain->ResizeBuffersWithAllOptions(555, 666, DEFAULT_DPI, PIXEL_FORMAT(R8G8B8A8UIntNormalized), 3));
     }
 
+    TEST_METHOD_EX(CanvasSwapChain_WithMaximumFrameLatency_UsesWaitableObject)
+    {
+        StubDeviceFixture f;
+
+        HANDLE waitableObject = nullptr;
+
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.SetExpectedCalls(1, [&](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool frameLatencyWaitable)
+        {
+            Assert::IsTrue(frameLatencyWaitable);
+
+            auto swapChain = Make<StubDxgiSwapChain>();
+
+            swapChain->SetMaximumFrameLatencyMethod.SetExpectedCalls(1,
+                [](UINT maxLatency)
+                {
+                    Assert::AreEqual(2u, maxLatency);
+                    return S_OK;
+                });
+
+            swapChain->GetFrameLatencyWaitableObjectMethod.SetExpectedCalls(1,
+                [&]
+                {
+                    waitableObject = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+                    return waitableObject;
+                });
+
+            // The flag has to be passed again whenever the buffers are resized.
+            swapChain->ResizeBuffersMethod.SetExpectedCalls(1,
+                [](UINT, UINT, UINT, DXGI_FORMAT, UINT swapChainFlags)
+                {
+                    Assert::AreEqual<UINT>(DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT, swapChainFlags);
+                    return S_OK;
+                });
+
+            return swapChain;
+        });
+
+        auto canvasSwapChain = CanvasSwapChain::CreateNew(
+            f.m_canvasDevice.Get(),
+            1.0f,
+            1.0f,
+            DEFAULT_DPI,
+            CanvasSwapChain::DefaultPixelFormat,
+            CanvasSwapChain::DefaultBufferCount,
+            CanvasSwapChain::DefaultCompositionAlphaMode,
+            2);
+
+        Assert::AreEqual(2u, canvasSwapChain->GetMaximumFrameLatency());
+
+        Assert::IsFalse(canvasSwapChain->WaitForFrameLatency(0));
+
+        SetEvent(waitableObject);
+        Assert::IsTrue(canvasSwapChain->WaitForFrameLatency(0));
+
+        ThrowIfFailed(canvasSwapChain->ResizeBuffersWithAllOptions(2, 2, DEFAULT_DPI, CanvasSwapChain::DefaultPixelFormat, CanvasSwapChain::DefaultBufferCount));
+
+        ThrowIfFailed(canvasSwapChain->Close());
+        ExpectHResultException(RO_E_CLOSED, [&] { canvasSwapChain->WaitForFrameLatency(0); });
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_WithoutMaximumFrameLatency_DoesNotUseWaitableObject)
+    {
+        StubDeviceFixture f;
+
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.SetExpectedCalls(1, [](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool frameLatencyWaitable)
+        {
+            Assert::IsFalse(frameLatencyWaitable);
+
+            auto swapChain = Make<StubDxgiSwapChain>();
+            swapChain->SetMaximumFrameLatencyMethod.SetExpectedCalls(0);
+            swapChain->GetFrameLatencyWaitableObjectMethod.SetExpectedCalls(0);
+            return swapChain;
+        });
+
+        auto canvasSwapChain = f.CreateTestSwapChain();
+
+        Assert::AreEqual(0u, canvasSwapChain->GetMaximumFrameLatency());
+    }
+
     void VerifyResizeBuffersDpiTestCase(int overloadIndex, float dpiScaling)
     {
         StubDeviceFixture f;
 
         const float newDpi = DEFAULT_DPI * dpiScaling;
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([&](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([&](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             auto swapChain = Make<StubDxgiSwapChain>();
 
@@ -713,7 +798,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
             const DirectXPixelFormat originalPixelFormat = PIXEL_FORMAT(R16G16B16A16Float);
             const int originalBufferCount = 7;
 
-            f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+            f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
             {
                 auto swapChain = Make<StubDxgiSwapChain>();
 
@@ -773,7 +858,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
     {
         StubDeviceFixture f;
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             auto swapChain = Make<MockDxgiSwapChain>();
 
@@ -807,7 +892,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
     {
         StubDeviceFixture f;
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             auto swapChain = Make<MockDxgiSwapChain>();
 
@@ -837,6 +922,246 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         ThrowIfFailed(canvasSwapChain->PresentWithSyncInterval(3));
     }
 
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRects)
+    {
+        StubDeviceFixture f;
+
+        auto dxgiSwapChain = Make<MockDxgiSwapChain>();
+        auto canvasSwapChain = Make<CanvasSwapChain>(f.m_canvasDevice.Get(), dxgiSwapChain.Get(), DEFAULT_DPI * 2, false);
+
+        dxgiSwapChain->Present1Method.SetExpectedCalls(1,
+            [](UINT syncInterval, UINT presentFlags, const DXGI_PRESENT_PARAMETERS* presentParameters)
+            {
+                Assert::AreEqual(2u, syncInterval);
+                Assert::AreEqual(0u, presentFlags);
+                Assert::AreEqual(2u, presentParameters->DirtyRectsCount);
+
+                // DIPs are converted to pixels, rounding outwards.
+                Assert::AreEqual(RECT{ 2, 4, 8, 12 }, presentParameters->pDirtyRects[0]);
+                Assert::AreEqual(RECT{ 0, 1, 3, 2 }, presentParameters->pDirtyRects[1]);
+
+                Assert::IsNull(presentParameters->pScrollRect);
+                Assert::IsNull(presentParameters->pScrollOffset);
+                return S_OK;
+            });
+
+        Rect dirtyRects[] =
+        {
+            Rect{ 1, 2, 3, 4 },
+            Rect{ 0.25f, 0.75f, 1.0f, 0.25f },
+        };
+
+        ThrowIfFailed(canvasSwapChain->PresentWithDirtyRects(2, _countof(dirtyRects), dirtyRects));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRects_EmptyArrayPresentsEverything)
+    {
+        StubDeviceFixture f;
+
+        auto dxgiSwapChain = Make<MockDxgiSwapChain>();
+        auto canvasSwapChain = Make<CanvasSwapChain>(f.m_canvasDevice.Get(), dxgiSwapChain.Get(), DEFAULT_DPI, false);
+
+        dxgiSwapChain->Present1Method.SetExpectedCalls(1,
+            [](UINT, UINT, const DXGI_PRESENT_PARAMETERS* presentParameters)
+            {
+                Assert::AreEqual(0u, presentParameters->DirtyRectsCount);
+                Assert::IsNull(presentParameters->pDirtyRects);
+                return S_OK;
+            });
+
+        ThrowIfFailed(canvasSwapChain->PresentWithDirtyRects(1, 0, nullptr));
+
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->PresentWithDirtyRects(1, 1, nullptr));
+        Assert::AreEqual(E_INVALIDARG, canvasSwapChain->PresentWithDirtyRectsAndScroll(1, 1, nullptr, Rect{}, Vector2{}));
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_PresentWithDirtyRectsAndScroll)
+    {
+        StubDeviceFixture f;
+
+        auto dxgiSwapChain = Make<MockDxgiSwapChain>();
+        auto canvasSwapChain = Make<CanvasSwapChain>(f.m_canvasDevice.Get(), dxgiSwapChain.Get(), DEFAULT_DPI * 2, false);
+
+        dxgiSwapChain->Present1Method.SetExpectedCalls(1,
+            [](UINT syncInterval, UINT, const DXGI_PRESENT_PARAMETERS* presentParameters)
+            {
+                Assert::AreEqual(1u, syncInterval);
+
+                Assert::AreEqual(1u, presentParameters->DirtyRectsCount);
+                Assert::AreEqual(RECT{ 0, 180, 200, 200 }, presentParameters->pDirtyRects[0]);
+
+                Assert::IsNotNull(presentParameters->pScrollRect);
+                Assert::AreEqual(RECT{ 0, 0, 200, 200 }, *presentParameters->pScrollRect);
+
+                Assert::IsNotNull(presentParameters->pScrollOffset);
+                Assert::AreEqual(0l, presentParameters->pScrollOffset->x);
+                Assert::AreEqual(-20l, presentParameters->pScrollOffset->y);
+                return S_OK;
+            });
+
+        Rect dirtyRect{ 0, 90, 100, 10 };
+
+        ThrowIfFailed(canvasSwapChain->PresentWithDirtyRectsAndScroll(1, 1, &dirtyRect, Rect{ 0, 0, 100, 100 }, Vector2{ 0, -10 }));
+    }
+
+    struct TrackDirtyRegionsFixture
+    {
+        ComPtr<StubCanvasDevice> CanvasDevice;
+        ComPtr<MockDxgiSwapChain> DxgiSwapChain;
+        ComPtr<StubD2DDeviceContext> DeviceContext;
+        ComPtr<CanvasSwapChain> SwapChain;
+
+        std::vector<RECT> PresentedDirtyRects;
+
+        TrackDirtyRegionsFixture(float dpi)
+            : CanvasDevice(Make<StubCanvasDevice>())
+            , DxgiSwapChain(Make<MockDxgiSwapChain>())
+            , DeviceContext(Make<StubD2DDeviceContext>())
+        {
+            DxgiSwapChain->GetDesc1Method.AllowAnyCall(
+                [](DXGI_SWAP_CHAIN_DESC1* desc)
+                {
+                    *desc = DXGI_SWAP_CHAIN_DESC1{};
+                    desc->Width = 200;
+                    desc->Height = 100;
+                    desc->Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+                    desc->AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
+                    return S_OK;
+                });
+
+            DxgiSwapChain->GetBufferMethod.AllowAnyCall(
+                [](UINT, REFIID riid, void** surface)
+                {
+                    return Make<MockDxgiSurface>().CopyTo(riid, surface);
+                });
+
+            DxgiSwapChain->Present1Method.AllowAnyCall(
+                [this](UINT, UINT, const DXGI_PRESENT_PARAMETERS* presentParameters)
+                {
+                    PresentedDirtyRects.assign(
+                        presentParameters->pDirtyRects,
+                        presentParameters->pDirtyRects + presentParameters->DirtyRectsCount);
+                    return S_OK;
+                });
+
+            CanvasDevice->CreateDeviceContextForDrawingSessionMethod.AllowAnyCall(
+                [this]
+                {
+                    return DeviceContext;
+                });
+
+            DeviceContext->GetTransformMethod.AllowAnyCall(
+                [](D2D1_MATRIX_3X2_F* transform)
+                {
+                    *transform = D2D1::Matrix3x2F::Identity();
+                });
+
+            DeviceContext->GetUnitModeMethod.AllowAnyCall(
+                []
+                {
+                    return D2D1_UNIT_MODE_DIPS;
+                });
+
+            DeviceContext->FillRectangleMethod.AllowAnyCall();
+            DeviceContext->DrawLineMethod.AllowAnyCall();
+
+            SwapChain = Make<CanvasSwapChain>(CanvasDevice.Get(), DxgiSwapChain.Get(), dpi, false);
+        }
+
+        ComPtr<ICanvasDrawingSession> CreateDrawingSession()
+        {
+            ComPtr<ICanvasDrawingSession> drawingSession;
+            ThrowIfFailed(SwapChain->CreateDrawingSession(Color{}, &drawingSession));
+            return drawingSession;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasSwapChain_TrackDirtyRegions_DefaultsToFalse)
+    {
+        TrackDirtyRegionsFixture f(DEFAULT_DPI);
+
+        boolean value;
+        ThrowIfFailed(f.SwapChain->get_TrackDirtyRegions(&value));
+        Assert::IsFalse(!!value);
+
+        auto drawingSession = f.CreateDrawingSession();
+        ThrowIfFailed(drawingSession->FillRectangleWithBrush(Rect{ 10, 10, 5, 5 }, Make<StubCanvasBrush>().Get()));
+        ThrowIfFailed(drawingSession->Close());
+
+        ThrowIfFailed(f.SwapChain->Present());
+        Assert::AreEqual<size_t>(0, f.PresentedDirtyRects.size());
+
+        ThrowIfFailed(f.SwapChain->put_TrackDirtyRegions(true));
+        ThrowIfFailed(f.SwapChain->get_TrackDirtyRegions(&value));
+        Assert::IsTrue(!!value);
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_TrackDirtyRegions_PresentsBoundsOfDrawing)
+    {
+        TrackDirtyRegionsFixture f(DEFAULT_DPI * 2);
+
+        ThrowIfFailed(f.SwapChain->put_TrackDirtyRegions(true));
+
+        // Nothing is known about the first frame.
+        ThrowIfFailed(f.SwapChain->Present());
+        Assert::AreEqual<size_t>(0, f.PresentedDirtyRects.size());
+
+        auto brush = Make<StubCanvasBrush>();
+
+        auto drawingSession = f.CreateDrawingSession();
+        ThrowIfFailed(drawingSession->FillRectangleWithBrush(Rect{ 10, 10, 5, 5 }, brush.Get()));
+        ThrowIfFailed(drawingSession->DrawLineWithBrushAndStrokeWidth(Vector2{ 50, 5 }, Vector2{ 60, 5 }, brush.Get(), 2));
+        ThrowIfFailed(drawingSession->Close());
+
+        ThrowIfFailed(f.SwapChain->Present());
+
+        // Bounds are scaled by the DPI and include a pixel for antialiasing.
+        Assert::AreEqual<size_t>(2, f.PresentedDirtyRects.size());
+        Assert::AreEqual(RECT{ 19, 19, 31, 31 }, f.PresentedDirtyRects[0]);
+
+        // Lines are inflated by the stroke width.
+        Assert::AreEqual(RECT{ 95, 5, 125, 15 }, f.PresentedDirtyRects[1]);
+
+        // Clear dirties everything.
+        drawingSession = f.CreateDrawingSession();
+        ThrowIfFailed(drawingSession->FillRectangleWithBrush(Rect{ 10, 10, 5, 5 }, brush.Get()));
+        ThrowIfFailed(drawingSession->Clear(Color{}));
+        ThrowIfFailed(drawingSession->Close());
+
+        ThrowIfFailed(f.SwapChain->Present());
+        Assert::AreEqual<size_t>(0, f.PresentedDirtyRects.size());
+    }
+
+    TEST_METHOD_EX(CanvasSwapChain_TrackDirtyRegions_ExplicitDirtyRectsReplaceTrackedOnes)
+    {
+        TrackDirtyRegionsFixture f(DEFAULT_DPI);
+
+        ThrowIfFailed(f.SwapChain->put_TrackDirtyRegions(true));
+        ThrowIfFailed(f.SwapChain->Present());
+
+        auto brush = Make<StubCanvasBrush>();
+
+        auto drawingSession = f.CreateDrawingSession();
+        ThrowIfFailed(drawingSession->FillRectangleWithBrush(Rect{ 10, 10, 5, 5 }, brush.Get()));
+        ThrowIfFailed(drawingSession->Close());
+
+        Rect dirtyRect{ 1, 2, 3, 4 };
+        ThrowIfFailed(f.SwapChain->PresentWithDirtyRects(1, 1, &dirtyRect));
+
+        Assert::AreEqual<size_t>(1, f.PresentedDirtyRects.size());
+        Assert::AreEqual(RECT{ 1, 2, 4, 6 }, f.PresentedDirtyRects[0]);
+
+        // The next frame starts with nothing dirty.
+        drawingSession = f.CreateDrawingSession();
+        ThrowIfFailed(drawingSession->FillRectangleWithBrush(Rect{ 20, 20, 10, 10 }, brush.Get()));
+        ThrowIfFailed(drawingSession->Close());
+
+        ThrowIfFailed(f.SwapChain->Present());
+
+        Assert::AreEqual<size_t>(1, f.PresentedDirtyRects.size());
+        Assert::AreEqual(RECT{ 19, 19, 31, 31 }, f.PresentedDirtyRects[0]);
+    }
+
     TEST_METHOD_EX(CanvasSwapChain_CreateDrawingSession)
     {
         StubDeviceFixture f;
@@ -1005,7 +1330,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
 
             m_canvasDevice = Make<StubCanvasDevice>(d2dDevice);
             
-            m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+            m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
             {
                 auto swapChain = Make<StubDxgiSwapChain>(expectedBackBufferSurface);
 
@@ -1175,7 +1500,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         StubDeviceFixture f;
 
         f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall(
-            [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+            [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
             {
                 auto dxgiSwapChain = Make<MockDxgiSwapChain>();
                 dxgiSwapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
@@ -1202,7 +1527,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
         StubDeviceFixture f;
 
         f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall(
-            [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+            [=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
             {
                 auto dxgiSwapChain = Make<MockDxgiSwapChain>();
                 dxgiSwapChain->SetMatrixTransformMethod.SetExpectedCalls(1);
@@ -1272,7 +1597,7 @@ TEST_CLASS(CanvasSwapChainUnitTests)
             return S_OK; 
         });
 
-        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+        f.m_canvasDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
         {
             return dxgiSwapChain;
         });
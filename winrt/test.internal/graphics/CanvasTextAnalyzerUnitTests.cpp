@@ -1118,6 +1118,11 @@ TEST_CLASS(CanvasTextAnalyzerTests)
             return analyzer;
         }
 
+        ComPtr<ICanvasTextAnalyzerStatics> GetStatics()
+        {
+            return As<ICanvasTextAnalyzerStatics>(m_textAnalyzerFactory);
+        }
+
         ComPtr<ICanvasTextAnalyzer> CreateWithNumberSubstitutionAndVerticalGlyphOrientationAndBidiLevel()
         {
             ComPtr<ICanvasTextAnalyzer> analyzer;
@@ -2207,6 +2212,213 @@ TEST_CLASS(CanvasTextAnalyzerTests)
             &glyphElements));
     }
 
+    static void AssertShapingCacheStatistics(ComPtr<ICanvasTextAnalyzerStatics> const& statics, uint64_t hits, uint64_t misses, uint32_t entries)
+    {
+        CanvasShapingCacheStatistics statistics;
+        ThrowIfFailed(statics->get_ShapingCacheStatistics(&statistics));
+
+        Assert::AreEqual(hits, statistics.HitCount);
+        Assert::AreEqual(misses, statistics.MissCount);
+        Assert::AreEqual(entries, statistics.EntryCount);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_ShapingCache_Properties)
+    {
+        Fixture f;
+        auto statics = f.GetStatics();
+
+        uint32_t entryCount;
+        ThrowIfFailed(statics->get_MaximumShapingCacheEntryCount(&entryCount));
+        Assert::AreEqual(0u, entryCount);
+
+        uint64_t size;
+        ThrowIfFailed(statics->get_MaximumShapingCacheSize(&size));
+        Assert::AreEqual<uint64_t>(4 * 1024 * 1024, size);
+
+        ThrowIfFailed(statics->put_MaximumShapingCacheEntryCount(12));
+        ThrowIfFailed(statics->get_MaximumShapingCacheEntryCount(&entryCount));
+        Assert::AreEqual(12u, entryCount);
+
+        ThrowIfFailed(statics->put_MaximumShapingCacheSize(3456));
+        ThrowIfFailed(statics->get_MaximumShapingCacheSize(&size));
+        Assert::AreEqual<uint64_t>(3456, size);
+
+        Assert::AreEqual(E_INVALIDARG, statics->get_MaximumShapingCacheEntryCount(nullptr));
+        Assert::AreEqual(E_INVALIDARG, statics->get_MaximumShapingCacheSize(nullptr));
+        Assert::AreEqual(E_INVALIDARG, statics->get_ShapingCacheStatistics(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetGlyphs_WhenShapingCacheIsDisabled_ShapesEveryTime)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        f.ExpectGetGlyphs(2, 2);
+        f.GetGlyphs(textAnalyzer);
+        f.GetGlyphs(textAnalyzer);
+
+        AssertShapingCacheStatistics(f.GetStatics(), 0, 0, 0);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetGlyphsWithAllOptions_UsesShapingCache)
+    {
+        Fixture f;
+        auto statics = f.GetStatics();
+
+        ThrowIfFailed(statics->put_MaximumShapingCacheEntryCount(16));
+
+        f.UseNumberSubstitution();
+        f.UseTypographyRanges();
+        f.Locale = L"xx-yy";
+
+        f.ExpectGetGlyphs(1, 1);
+
+        f.GetGlyphsWithAllOptions(f.Create());
+
+        // The cache is shared between analyzers, and returns the same results.
+        f.GetGlyphsWithAllOptions(f.Create());
+
+        AssertShapingCacheStatistics(statics, 1, 1, 1);
+
+        // A different font size needs new placements.
+        f.ExpectGetGlyphs(1, 1);
+        f.FontSize = 50.0f;
+        f.GetGlyphsWithAllOptions(f.Create());
+
+        AssertShapingCacheStatistics(statics, 1, 2, 2);
+
+        ThrowIfFailed(statics->ClearShapingCache());
+        AssertShapingCacheStatistics(statics, 1, 2, 0);
+    }
+
+    TEST_METHOD_EX(CanvasTextAnalyzer_GetGlyphs_ReusesScratchBuffersAfterResize)
+    {
+        Fixture f;
+        auto textAnalyzer = f.Create();
+
+        // The first call grows the scratch buffers; the second must still see
+        // correctly sized results when fewer glyphs are produced.
+        const int bufferSize = 3 * static_cast<int>(f.Text.length()) / 2 + 16;
+
+        f.ExpectGetGlyphs(2);
+        f.AdditionalGlyphsToAddDuringExpansion = bufferSize - static_cast<int>(f.Text.length()) + 1;
+        f.GetGlyphs(textAnalyzer);
+
+        f.ExpectGetGlyphs(1);
+        f.AdditionalGlyphsToAddDuringExpansion = 0;
+        f.GetGlyphsWithAllOptions(textAnalyzer);
+    }
+
+    BENCHMARK_METHOD(CanvasTextAnalyzer_GetGlyphs_ShapingBenchmark)
+    {
+        //
+        // Shapes many short runs over and over, as a custom text engine
+        // reshaping its visible lines each frame would.  This is timed with
+        // the shaping cache disabled and enabled.  The mock text analyzer
+        // makes shaping unrealistically cheap, so the times are mostly the
+        // overhead around shaping; compare the uncached time with a build
+        // of an earlier version to see the effect of changes to GetGlyphs.
+        //
+
+        const int runLength = 8;
+        const int runCount = 64;
+        const int frameCount = 100;
+
+        Fixture f;
+        f.Text.clear();
+
+        for (int i = 0; i < runCount; ++i)
+        {
+            auto word = std::to_wstring(10000000 + i);
+            f.Text.append(word, 0, runLength);
+        }
+
+        auto statics = f.GetStatics();
+        auto textAnalyzer = f.Create();
+
+        f.TextAnalyzer->GetGlyphsMethod.AllowAnyCall(
+            [](WCHAR const* text, uint32_t textLength, IDWriteFontFace*, BOOL, BOOL, DWRITE_SCRIPT_ANALYSIS const*, WCHAR const*, IDWriteNumberSubstitution*,
+               DWRITE_TYPOGRAPHIC_FEATURES const**, uint32_t const*, uint32_t, uint32_t, UINT16* clusterMap, DWRITE_SHAPING_TEXT_PROPERTIES* textProps,
+               UINT16* glyphIndices, DWRITE_SHAPING_GLYPH_PROPERTIES* glyphProps, uint32_t* actualGlyphCount)
+            {
+                for (uint32_t i = 0; i < textLength; ++i)
+                {
+                    clusterMap[i] = static_cast<UINT16>(i);
+                    textProps[i] = DWRITE_SHAPING_TEXT_PROPERTIES{};
+                    glyphIndices[i] = static_cast<UINT16>(text[i]);
+                    glyphProps[i] = DWRITE_SHAPING_GLYPH_PROPERTIES{};
+                }
+
+                *actualGlyphCount = textLength;
+                return S_OK;
+            });
+
+        f.TextAnalyzer->GetGlyphPlacementsMethod.AllowAnyCall(
+            [](WCHAR const*, UINT16 const*, DWRITE_SHAPING_TEXT_PROPERTIES*, uint32_t, UINT16 const*, DWRITE_SHAPING_GLYPH_PROPERTIES const*, uint32_t glyphCount,
+               IDWriteFontFace*, FLOAT fontEmSize, BOOL, BOOL, DWRITE_SCRIPT_ANALYSIS const*, WCHAR const*, DWRITE_TYPOGRAPHIC_FEATURES const**, uint32_t const*, uint32_t,
+               FLOAT* glyphAdvances, DWRITE_GLYPH_OFFSET* glyphOffsets)
+            {
+                for (uint32_t i = 0; i < glyphCount; ++i)
+                {
+                    glyphAdvances[i] = fontEmSize / 2;
+                    glyphOffsets[i] = DWRITE_GLYPH_OFFSET{};
+                }
+
+                return S_OK;
+            });
+
+        // The shaping cache is shared by the whole process, so leave it disabled for other tests.
+        auto disableCache = MakeScopeWarden([&] { statics->put_MaximumShapingCacheEntryCount(0); });
+
+        auto time = [&](std::function<void(int)> const& shapeRun)
+        {
+            return TimeMilliseconds([&]
+            {
+                for (int frame = 0; frame < frameCount; ++frame)
+                {
+                    for (int run = 0; run < runCount; ++run)
+                    {
+                        shapeRun(run);
+                    }
+                }
+            });
+        };
+
+        auto getGlyphs = [&](int run)
+        {
+            uint32_t glyphCount;
+            CanvasGlyph* glyphElements;
+
+            ThrowIfFailed(textAnalyzer->GetGlyphs(
+                CanvasCharacterRange{ run * runLength, runLength },
+                f.FontFace.Get(),
+                f.FontSize,
+                false,
+                false,
+                f.AnalyzedScript,
+                &glyphCount,
+                &glyphElements));
+
+            Assert::AreEqual<uint32_t>(runLength, glyphCount);
+            CoTaskMemFree(glyphElements);
+        };
+
+        auto uncachedTime = time(getGlyphs);
+
+        ThrowIfFailed(statics->put_MaximumShapingCacheEntryCount(runCount));
+
+        auto cachedTime = time(getGlyphs);
+
+        AssertShapingCacheStatistics(statics, runCount * (frameCount - 1), runCount, runCount);
+
+        WriteBenchmarkResult(
+            L"%d runs x %d frames: uncached %.2fms, cached %.2fms\n",
+            runCount,
+            frameCount,
+            uncachedTime,
+            cachedTime);
+    }
+
     TEST_METHOD_EX(CanvasTextAnalyzer_GetBidi_BadArg)
     {
         Fixture f;
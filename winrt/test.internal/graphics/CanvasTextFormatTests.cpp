@@ -1492,6 +1492,67 @@ namespace canvas
             Assert::AreEqual(CanvasTrimmingSign::None, sign);
         }
 
+        TEST_METHOD_EX(CanvasTextFormat_NoWrapClone_IsReusedUntilFormatChanges)
+        {
+            auto ctf = Make<CanvasTextFormat>();
+
+            auto initialCount = CanvasTextFormat::GetCreatedTextFormatCount();
+
+            auto clone1 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+            auto clone2 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+
+            Assert::IsTrue(IsSameInstance(clone1.Get(), clone2.Get()));
+            Assert::AreEqual(DWRITE_WORD_WRAPPING_NO_WRAP, clone1->GetWordWrapping());
+            Assert::AreEqual(initialCount + 1, CanvasTextFormat::GetCreatedTextFormatCount());
+
+            // Setting a property to its current value keeps the clone.
+            ThrowIfFailed(ctf->put_FontSize(20.0f));
+            Assert::IsTrue(IsSameInstance(clone1.Get(), ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap).Get()));
+
+            // Changing a property that requires unrealizing.
+            ThrowIfFailed(ctf->put_FontSize(30.0f));
+            auto clone3 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+
+            Assert::IsFalse(IsSameInstance(clone1.Get(), clone3.Get()));
+            Assert::AreEqual(30.0f, clone3->GetFontSize());
+
+            // Changing a property that is set directly on the realized format.
+            ctf->GetRealizedTextFormat();
+            ThrowIfFailed(ctf->put_HorizontalAlignment(CanvasHorizontalAlignment::Center));
+            auto clone4 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+
+            Assert::IsFalse(IsSameInstance(clone3.Get(), clone4.Get()));
+            Assert::AreEqual(DWRITE_TEXT_ALIGNMENT_CENTER, clone4->GetTextAlignment());
+        }
+
+        TEST_METHOD_EX(CanvasTextFormat_NoWrapClone_WhenRealizedFormatChangedViaInterop_CloneIsRecreated)
+        {
+            auto ctf = Make<CanvasTextFormat>();
+
+            auto realizedFormat = ctf->GetRealizedTextFormat();
+            auto clone1 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+
+            ThrowIfFailed(realizedFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_FAR));
+
+            auto clone2 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::NoWrap);
+
+            Assert::IsFalse(IsSameInstance(clone1.Get(), clone2.Get()));
+            Assert::AreEqual(DWRITE_PARAGRAPH_ALIGNMENT_FAR, clone2->GetParagraphAlignment());
+
+            // The realized format still uses its own word wrapping.
+            Assert::AreEqual(DWRITE_WORD_WRAPPING_WRAP, realizedFormat->GetWordWrapping());
+        }
+
+        TEST_METHOD_EX(CanvasTextFormat_WrappingClones_AreNotReused)
+        {
+            auto ctf = Make<CanvasTextFormat>();
+
+            auto clone1 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::Character);
+            auto clone2 = ctf->GetRealizedTextFormatClone(CanvasWordWrapping::Character);
+
+            Assert::IsFalse(IsSameInstance(clone1.Get(), clone2.Get()));
+        }
+
         TEST_METHOD_EX(CanvasTextFormat_TrimmingSign_ChangingSignDoesntCauseFormatReRealization)
         {
             auto ctf = Make<CanvasTextFormat>();
@@ -6,10 +6,10 @@
 
 class CountedD2DDeviceContext : public MockD2DDeviceContext
 {
-    int* m_counter;
+    std::atomic<int>* m_counter;
     
 public:
-    CountedD2DDeviceContext(int* counter)
+    CountedD2DDeviceContext(std::atomic<int>* counter)
         : m_counter(counter)
     {
         (*m_counter)++;
@@ -31,7 +31,7 @@ public:
         DeviceContextPool Pool;
 
         CALL_COUNTER(CreateDeviceContextMethod);
-        int NumberOfActiveDeviceContexts;
+        std::atomic<int> NumberOfActiveDeviceContexts;
 
         Fixture()
             : Device(Make<MockD2DDevice>())
@@ -128,7 +128,7 @@ public:
 
         f.PopulatePool();
         
-        Assert::AreEqual<int>(std::thread::hardware_concurrency(), f.NumberOfActiveDeviceContexts);
+        Assert::AreEqual<int>(std::thread::hardware_concurrency(), f.NumberOfActiveDeviceContexts.load());
     }
 
     TEST_METHOD_EX(DeviceContextPool_WhenClosed_PoolIsEmptied)
@@ -140,7 +140,7 @@ public:
         Assert::IsTrue(f.NumberOfActiveDeviceContexts > 0);
 
         f.Pool.Close();
-        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts);
+        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts.load());
     }
 
     TEST_METHOD_EX(DeviceContextPool_WhenClosed_AndLeaseIsReturned_DeviceContextIsDestroyed)
@@ -153,10 +153,10 @@ public:
             
             f.Pool.Close();
 
-            Assert::AreEqual(1, f.NumberOfActiveDeviceContexts);
+            Assert::AreEqual(1, f.NumberOfActiveDeviceContexts.load());
         }
 
-        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts);
+        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts.load());
     }
 
     TEST_METHOD_EX(DeviceContextPool_WhenClosed_TakeLease_Fails)
@@ -166,4 +166,205 @@ public:
 
         ExpectHResultException(RO_E_CLOSED, [&] { f.Pool.TakeLease(); });
     }
+
+    TEST_METHOD_EX(DeviceContextPool_WhenMaximumSizeIsReduced_ExcessContextsAreDestroyed)
+    {
+        Fixture f;
+
+        f.PopulatePool();
+
+        f.Pool.SetMaximumSize(1);
+        Assert::IsTrue(f.NumberOfActiveDeviceContexts.load() <= 1);
+
+        f.Pool.SetMaximumSize(0);
+        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts.load());
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_WhenMaximumSizeIsZero_ContextsAreNotPooled)
+    {
+        Fixture f;
+        f.Pool.SetMaximumSize(0);
+
+        f.CreateDeviceContextMethod.SetExpectedCalls(3);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            auto lease = f.Pool.TakeLease();
+            Assert::AreEqual(1, f.NumberOfActiveDeviceContexts.load());
+        }
+
+        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts.load());
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_SetMaximumSize_FailsWhenTooLarge)
+    {
+        Fixture f;
+
+        ExpectHResultException(E_INVALIDARG, [&] { f.Pool.SetMaximumSize(DeviceContextPool::MaxSlotCount + 1); });
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_Trim_DestroysIdleContexts)
+    {
+        Fixture f;
+
+        f.PopulatePool();
+        Assert::IsTrue(f.NumberOfActiveDeviceContexts.load() > 0);
+
+        f.Pool.Trim();
+        Assert::AreEqual(0, f.NumberOfActiveDeviceContexts.load());
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_AfterBurstOfConcurrentLeases_IdleContextsAreTrimmedOnceUsageDropsForTwoIntervals)
+    {
+        Fixture f;
+
+        f.PopulatePool();
+
+        auto pooledAfterBurst = f.NumberOfActiveDeviceContexts.load();
+
+        // One trim interval later the burst is still remembered...
+        for (uint32_t i = 0; i < DeviceContextPool::TrimInterval - 100; ++i)
+        {
+            f.Pool.TakeLease();
+        }
+
+        Assert::AreEqual(pooledAfterBurst, f.NumberOfActiveDeviceContexts.load());
+
+        // ...but once two whole intervals pass with only one lease at a time
+        // the pool shrinks.
+        for (uint32_t i = 0; i < DeviceContextPool::TrimInterval * 2; ++i)
+        {
+            f.Pool.TakeLease();
+        }
+
+        Assert::AreEqual(1, f.NumberOfActiveDeviceContexts.load());
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_Statistics_CountHitsMissesCreatesAndDiscards)
+    {
+        Fixture f;
+        f.Pool.SetMaximumSize(1);
+
+        f.CreateDeviceContextMethod.SetExpectedCalls(2);
+
+        {
+            auto lease1 = f.Pool.TakeLease();   // miss
+            auto lease2 = f.Pool.TakeLease();   // miss
+        }                                       // one returned to the pool, one discarded
+
+        f.Pool.TakeLease();                     // hit
+
+        auto statistics = f.Pool.GetStatistics();
+
+        Assert::AreEqual<uint64_t>(1, statistics.HitCount);
+        Assert::AreEqual<uint64_t>(2, statistics.MissCount);
+        Assert::AreEqual<uint64_t>(2, statistics.CreateCount);
+        Assert::AreEqual<uint64_t>(1, statistics.DiscardCount);
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_Statistics_DoNotCountTrimOrCloseAsDiscards)
+    {
+        Fixture f;
+
+        f.PopulatePool();
+
+        auto discardsAfterBurst = f.Pool.GetStatistics().DiscardCount;
+
+        f.Pool.Trim();
+        f.Pool.Close();
+
+        Assert::AreEqual(discardsAfterBurst, f.Pool.GetStatistics().DiscardCount);
+    }
+
+    TEST_METHOD_EX(DeviceContextPool_DiscardedReturns_CountTowardsTrimInterval)
+    {
+        Fixture f;
+        f.Pool.SetMaximumSize(2);
+
+        f.CreateDeviceContextMethod.SetExpectedCalls(3);
+
+        {
+            auto lease1 = f.Pool.TakeLease();
+            auto lease2 = f.Pool.TakeLease();
+            auto lease3 = f.Pool.TakeLease();
+        }
+
+        Assert::AreEqual(2, f.NumberOfActiveDeviceContexts.load());
+
+        // The burst is remembered for the rest of its interval and the whole
+        // of the next one.  The pool only gets back down to a single context
+        // at the end of the third interval if the discarded return above was
+        // counted along with the other two.
+        f.CreateDeviceContextMethod.SetExpectedCalls(0);
+
+        for (uint32_t i = 0; i < DeviceContextPool::TrimInterval * 3 - 3; ++i)
+        {
+            f.Pool.TakeLease();
+        }
+
+        Assert::AreEqual(1, f.NumberOfActiveDeviceContexts.load());
+    }
+
+    //
+    // Hammers the pool from many threads at once and reports the throughput,
+    // along with how well thread affinity worked.
+    //
+    BENCHMARK_METHOD(DeviceContextPool_ContentionBenchmark)
+    {
+        auto device = Make<MockD2DDevice>();
+        std::atomic<int> numberOfActiveDeviceContexts(0);
+
+        device->MockCreateDeviceContext =
+            [&] (D2D1_DEVICE_CONTEXT_OPTIONS, ID2D1DeviceContext1** deviceContext)
+            {
+                Make<CountedD2DDeviceContext>(&numberOfActiveDeviceContexts).CopyTo(deviceContext);
+            };
+
+        {
+            DeviceContextPool pool(device.Get());
+
+            auto const threadCount = std::max(std::thread::hardware_concurrency(), 1U) * 2;
+            int const leasesPerThread = 20000;
+
+            auto elapsed = TimeMilliseconds([&]
+            {
+                std::vector<std::future<void>> threads;
+
+                for (uint32_t i = 0; i < threadCount; ++i)
+                {
+                    threads.push_back(std::async(std::launch::async, [&]
+                    {
+                        for (int j = 0; j < leasesPerThread; ++j)
+                        {
+                            auto lease = pool.TakeLease();
+                            Assert::IsNotNull(lease.Get());
+                        }
+                    }));
+                }
+
+                for (auto& thread : threads)
+                {
+                    thread.get();
+                }
+            });
+
+            auto statistics = pool.GetStatistics();
+            auto totalLeases = static_cast<uint64_t>(threadCount) * leasesPerThread;
+
+            Assert::AreEqual(totalLeases, statistics.HitCount + statistics.MissCount);
+            Assert::AreEqual(statistics.MissCount, statistics.CreateCount);
+
+            WriteBenchmarkResult(
+                L"%u threads, %llu leases in %.1fms (%.0f ns/lease), hits: %llu, misses: %llu, discards: %llu\n",
+                threadCount,
+                totalLeases,
+                elapsed,
+                elapsed * 1000000.0 / totalLeases,
+                statistics.HitCount,
+                statistics.MissCount,
+                statistics.DiscardCount);
+        }
+
+        Assert::AreEqual(0, numberOfActiveDeviceContexts.load());
+    }
 };
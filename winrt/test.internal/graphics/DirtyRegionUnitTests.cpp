@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+TEST_CLASS(DirtyRegionUnitTests)
+{
+    TEST_METHOD_EX(DirtyRegion_NewRegion_IsEverything)
+    {
+        DirtyRegion region;
+
+        region.Add(D2D1_RECT_L{ 1, 2, 3, 4 });
+
+        Assert::AreEqual<size_t>(0, region.TakeRectangles(100, 100).size());
+
+        // Taking the rectangles resets the region.
+        region.Add(D2D1_RECT_L{ 1, 2, 3, 4 });
+
+        auto rectangles = region.TakeRectangles(100, 100);
+        Assert::AreEqual<size_t>(1, rectangles.size());
+        Assert::AreEqual(RECT{ 1, 2, 3, 4 }, rectangles[0]);
+    }
+
+    TEST_METHOD_EX(DirtyRegion_Add_MergesOverlappingAndTouchingRectangles)
+    {
+        DirtyRegion region;
+        region.Clear();
+
+        region.Add(D2D1_RECT_L{ 0, 0, 10, 10 });
+        region.Add(D2D1_RECT_L{ 50, 50, 60, 60 });
+        region.Add(D2D1_RECT_L{ 10, 0, 20, 10 });     // touches the first
+        region.Add(D2D1_RECT_L{ 30, 30, 40, 40 });
+        region.Add(D2D1_RECT_L{ 35, 35, 55, 55 });    // joins the last two
+        region.Add(D2D1_RECT_L{ 5, 5, 5, 20 });       // empty
+
+        auto rectangles = region.TakeRectangles(100, 100);
+
+        Assert::AreEqual<size_t>(2, rectangles.size());
+        Assert::AreEqual(RECT{ 0, 0, 20, 10 }, rectangles[0]);
+        Assert::AreEqual(RECT{ 30, 30, 60, 60 }, rectangles[1]);
+    }
+
+    TEST_METHOD_EX(DirtyRegion_Add_CollapsesTooManyRectanglesIntoTheirBounds)
+    {
+        DirtyRegion region;
+        region.Clear();
+
+        auto count = static_cast<LONG>(DirtyRegion::MaximumRectangleCount) + 1;
+
+        for (LONG i = 0; i < count; ++i)
+            region.Add(D2D1_RECT_L{ i * 10, 0, i * 10 + 5, 5 });
+
+        auto rectangles = region.TakeRectangles(1000, 1000);
+
+        Assert::AreEqual<size_t>(1, rectangles.size());
+        Assert::AreEqual(RECT{ 0, 0, (count - 1) * 10 + 5, 5 }, rectangles[0]);
+    }
+
+    TEST_METHOD_EX(DirtyRegion_TakeRectangles_ClipsToSurface)
+    {
+        DirtyRegion region;
+        region.Clear();
+
+        region.Add(D2D1_RECT_L{ -5, -5, 10, 10 });
+        region.Add(D2D1_RECT_L{ 90, 20, 120, 30 });
+        region.Add(D2D1_RECT_L{ 200, 200, 210, 210 });
+
+        auto rectangles = region.TakeRectangles(100, 50);
+
+        Assert::AreEqual<size_t>(2, rectangles.size());
+        Assert::AreEqual(RECT{ 0, 0, 10, 10 }, rectangles[0]);
+        Assert::AreEqual(RECT{ 90, 20, 100, 30 }, rectangles[1]);
+    }
+
+    TEST_METHOD_EX(DirtyRegion_TakeRectangles_WholeSurfaceIsReturnedAsEverything)
+    {
+        DirtyRegion region;
+        region.Clear();
+
+        region.Add(D2D1_RECT_L{ -1, -1, 101, 51 });
+
+        Assert::AreEqual<size_t>(0, region.TakeRectangles(100, 50).size());
+    }
+
+    TEST_METHOD_EX(DirtyRegion_AddEverything)
+    {
+        DirtyRegion region;
+        region.Clear();
+
+        region.Add(D2D1_RECT_L{ 1, 2, 3, 4 });
+        region.AddEverything();
+        region.Add(D2D1_RECT_L{ 5, 6, 7, 8 });
+
+        Assert::AreEqual<size_t>(0, region.TakeRectangles(100, 100).size());
+    }
+};
@@ -0,0 +1,199 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+TEST_CLASS(EffectPropertyStoreUnitTests)
+{
+    static ComPtr<IPropertyValueStatics> GetPropertyValueFactory()
+    {
+        ComPtr<IPropertyValueStatics> factory;
+        ThrowIfFailed(GetActivationFactory(HStringReference(RuntimeClass_Windows_Foundation_PropertyValue).Get(), &factory));
+        return factory;
+    }
+
+    TEST_METHOD_EX(EffectPropertyStore_NewStore_AllPropertiesAreUnset)
+    {
+        EffectPropertyStore store(3);
+
+        Assert::AreEqual(3u, store.GetCount());
+
+        for (unsigned i = 0; i < store.GetCount(); ++i)
+        {
+            Assert::IsTrue(store.GetType(i) == EffectPropertyType::Unset);
+            Assert::AreEqual(0u, store.GetValueSize(i));
+            Assert::IsNull(store.GetInspectable(i).Get());
+            Assert::IsNull(store.Box(GetPropertyValueFactory().Get(), i).Get());
+        }
+
+        // Unset values read back as zero.
+        float value = 123;
+        store.GetValue(0, &value, sizeof(value));
+        Assert::AreEqual(0.0f, value);
+    }
+
+    TEST_METHOD_EX(EffectPropertyStore_SetValue_SameSizeIsUpdatedInPlace)
+    {
+        EffectPropertyStore store(2);
+
+        float first = 1;
+        int32_t second = 2;
+
+        store.SetValue(0, EffectPropertyType::Single, &first, sizeof(first));
+        store.SetValue(1, EffectPropertyType::Int32, &second, sizeof(second));
+
+        auto firstData = store.GetValueData(0);
+        auto secondData = store.GetValueData(1);
+
+        first = 3;
+        store.SetValue(0, EffectPropertyType::Single, &first, sizeof(first));
+
+        Assert::IsTrue(firstData == store.GetValueData(0));
+        Assert::IsTrue(secondData == store.GetValueData(1));
+
+        float firstResult;
+        int32_t secondResult;
+
+        store.GetValue(0, &firstResult, sizeof(firstResult));
+        store.GetValue(1, &secondResult, sizeof(secondResult));
+
+        Assert::AreEqual(3.0f, firstResult);
+        Assert::AreEqual(2, secondResult);
+
+        Assert::IsTrue(store.GetType(0) == EffectPropertyType::Single);
+        Assert::IsTrue(store.GetType(1) == EffectPropertyType::Int32);
+    }
+
+    TEST_METHOD_EX(EffectPropertyStore_SetValue_GrowingAnArrayKeepsOtherValues)
+    {
+        EffectPropertyStore store(2);
+
+        float small[] = { 1, 2 };
+        float large[] = { 3, 4, 5, 6, 7, 8 };
+        uint32_t other = 42;
+
+        store.SetValue(0, EffectPropertyType::SingleArray, small, sizeof(small));
+        store.SetValue(1, EffectPropertyType::UInt32, &other, sizeof(other));
+        store.SetValue(0, EffectPropertyType::SingleArray, large, sizeof(large));
+
+        Assert::AreEqual<uint32_t>(sizeof(large), store.GetValueSize(0));
+
+        float largeResult[6];
+        uint32_t otherResult;
+
+        store.GetValue(0, largeResult, sizeof(largeResult));
+        store.GetValue(1, &otherResult, sizeof(otherResult));
+
+        for (int i = 0; i < 6; ++i)
+            Assert::AreEqual(large[i], largeResult[i]);
+
+        Assert::AreEqual(42u, otherResult);
+
+        // Shrinking it again reuses the same storage.
+        auto data = store.GetValueData(0);
+        store.SetValue(0, EffectPropertyType::SingleArray, small, sizeof(small));
+        Assert::IsTrue(data == store.GetValueData(0));
+        Assert::AreEqual<uint32_t>(sizeof(small), store.GetValueSize(0));
+    }
+
+    TEST_METHOD_EX(EffectPropertyStore_GetValue_WrongSizeThrows)
+    {
+        EffectPropertyStore store(1);
+
+        float value[] = { 1, 2, 3 };
+        store.SetValue(0, EffectPropertyType::SingleArray, value, sizeof(value));
+
+        ExpectHResultException(E_BOUNDS, [&]
+        {
+            float result[4];
+            store.GetValue(0, result, sizeof(result));
+        });
+    }
+
+    TEST_METHOD_EX(EffectPropertyStore_Inspectable)
+    {
+        EffectPropertyStore store(2);
+
+        ComPtr<IInspectable> inspectable = Make<Nullable<float>>(1.0f);
+
+        store.SetInspectable(1, inspectable.Get());
+
+        Assert::IsTrue(store.GetType(1) == EffectPropertyType::Inspectable);
+        Assert::IsTrue(IsSameInstance(inspectable.Get(), store.GetInspectable(1).Get()));
+
+        auto boxed = store.Box(GetPropertyValueFactory().Get(), 1);
+
+        ComArray<ComPtr<IInspectable>> array;
+        ThrowIfFailed(boxed->GetInspectableArray(array.GetAddressOfSize(), array.GetAddressOfData()));
+        Assert::AreEqual(1u, array.GetSize());
+        Assert::IsTrue(IsSameInstance(inspectable.Get(), array[0].Get()));
+
+        // Replacing an interface value with plain data releases the interface.
+        float value = 1;
+        store.SetValue(1, EffectPropertyType::Single, &value, sizeof(value));
+
+        Assert::IsTrue(store.GetType(1) == EffectPropertyType::Single);
+
+        array = ComArray<ComPtr<IInspectable>>();
+        boxed.Reset();
+
+        inspectable->AddRef();
+        Assert::AreEqual(1ul, inspectable->Release());
+    }
+
+    TEST_METHOD_EX(EffectPropertyStore_Box_UsesStoredType)
+    {
+        auto factory = GetPropertyValueFactory();
+
+        EffectPropertyStore store(5);
+
+        BOOL boolValue = TRUE;
+        int32_t intValue = -7;
+        uint32_t uintValue = 7;
+        float floatValue = 0.5f;
+        float arrayValue[] = { 1, 2, 3 };
+
+        store.SetValue(0, EffectPropertyType::Boolean, &boolValue, sizeof(boolValue));
+        store.SetValue(1, EffectPropertyType::Int32, &intValue, sizeof(intValue));
+        store.SetValue(2, EffectPropertyType::UInt32, &uintValue, sizeof(uintValue));
+        store.SetValue(3, EffectPropertyType::Single, &floatValue, sizeof(floatValue));
+        store.SetValue(4, EffectPropertyType::SingleArray, arrayValue, sizeof(arrayValue));
+
+        boolean booleanResult;
+        ThrowIfFailed(store.Box(factory.Get(), 0)->GetBoolean(&booleanResult));
+        Assert::IsTrue(!!booleanResult);
+
+        INT32 intResult;
+        ThrowIfFailed(store.Box(factory.Get(), 1)->GetInt32(&intResult));
+        Assert::AreEqual(-7, intResult);
+
+        UINT32 uintResult;
+        ThrowIfFailed(store.Box(factory.Get(), 2)->GetUInt32(&uintResult));
+        Assert::AreEqual(7u, uintResult);
+
+        float floatResult;
+        ThrowIfFailed(store.Box(factory.Get(), 3)->GetSingle(&floatResult));
+        Assert::AreEqual(0.5f, floatResult);
+
+        ComArray<float> arrayResult;
+        ThrowIfFailed(store.Box(factory.Get(), 4)->GetSingleArray(arrayResult.GetAddressOfSize(), arrayResult.GetAddressOfData()));
+        Assert::AreEqual(3u, arrayResult.GetSize());
+        Assert::AreEqual(3.0f, arrayResult[2]);
+    }
+
+    TEST_METHOD_EX(EffectPropertyStore_Clear_ResetsAllProperties)
+    {
+        EffectPropertyStore store(2);
+
+        float value = 1;
+        store.SetValue(0, EffectPropertyType::Single, &value, sizeof(value));
+        store.SetInspectable(1, Make<Nullable<float>>(1.0f).Get());
+
+        store.Clear();
+
+        Assert::IsTrue(store.GetType(0) == EffectPropertyType::Unset);
+        Assert::IsTrue(store.GetType(1) == EffectPropertyType::Unset);
+        Assert::IsNull(store.GetInspectable(1).Get());
+    }
+};
@@ -0,0 +1,443 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "mocks/MockD2DGeometryRealization.h"
+#include "mocks/MockD2DPathGeometry.h"
+#include "mocks/MockD2DRectangleGeometry.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Geometry;
+
+TEST_CLASS(GeometryRealizationCacheUnitTests)
+{
+public:
+    class StrokeStyleWithTransformType : public MockD2DStrokeStyle
+    {
+        D2D1_STROKE_TRANSFORM_TYPE m_transformType;
+
+    public:
+        StrokeStyleWithTransformType(D2D1_STROKE_TRANSFORM_TYPE transformType)
+            : m_transformType(transformType)
+        {
+        }
+
+        IFACEMETHODIMP_(D2D1_STROKE_TRANSFORM_TYPE) GetStrokeTransformType() CONST override
+        {
+            return m_transformType;
+        }
+    };
+
+    class CountedGeometryRealization : public MockD2DGeometryRealization
+    {
+        int* m_liveCount;
+
+    public:
+        CountedGeometryRealization(int* liveCount)
+            : m_liveCount(liveCount)
+        {
+            ++*m_liveCount;
+        }
+
+        virtual ~CountedGeometryRealization()
+        {
+            --*m_liveCount;
+        }
+    };
+
+    struct Fixture
+    {
+        std::shared_ptr<GeometryRealizationCache> Cache;
+        ComPtr<MockD2DDeviceContext> DeviceContext;
+        D2D1_MATRIX_3X2_F Transform;
+        float Dpi;
+
+        Fixture(uint64_t maximumSizeInBytes = 1024 * 1024)
+            : Cache(std::make_shared<GeometryRealizationCache>(maximumSizeInBytes))
+            , DeviceContext(Make<MockD2DDeviceContext>())
+            , Transform(D2D1::Matrix3x2F::Identity())
+            , Dpi(DEFAULT_DPI)
+        {
+            DeviceContext->GetTransformMethod.AllowAnyCall(
+                [=] (D2D1_MATRIX_3X2_F* transform)
+                {
+                    *transform = Transform;
+                });
+
+            DeviceContext->GetDpiMethod.AllowAnyCall(
+                [=] (float* dpiX, float* dpiY)
+                {
+                    *dpiX = Dpi;
+                    *dpiY = Dpi;
+                });
+        }
+
+        void ExpectCreateFilledGeometryRealization(int expectedCalls)
+        {
+            DeviceContext->CreateFilledGeometryRealizationMethod.SetExpectedCalls(expectedCalls,
+                [] (ID2D1Geometry*, FLOAT, ID2D1GeometryRealization** realization)
+                {
+                    return Make<MockD2DGeometryRealization>().CopyTo(realization);
+                });
+        }
+
+        void ExpectCreateStrokedGeometryRealization(int expectedCalls)
+        {
+            DeviceContext->CreateStrokedGeometryRealizationMethod.SetExpectedCalls(expectedCalls,
+                [] (ID2D1Geometry*, FLOAT, FLOAT, ID2D1StrokeStyle*, ID2D1GeometryRealization** realization)
+                {
+                    return Make<MockD2DGeometryRealization>().CopyTo(realization);
+                });
+        }
+
+        ComPtr<ID2D1GeometryRealization> Fill(ID2D1Geometry* geometry)
+        {
+            return Cache->GetFilledRealization(DeviceContext.Get(), geometry);
+        }
+
+        ComPtr<ID2D1GeometryRealization> Stroke(ID2D1Geometry* geometry, float strokeWidth = 1, ID2D1StrokeStyle* strokeStyle = nullptr)
+        {
+            return Cache->GetStrokedRealization(DeviceContext.Get(), geometry, strokeWidth, strokeStyle);
+        }
+
+        void AssertStatistics(uint64_t hits, uint64_t misses, uint64_t evictions, uint32_t realizations)
+        {
+            auto statistics = Cache->GetStatistics();
+
+            Assert::AreEqual(hits, statistics.HitCount);
+            Assert::AreEqual(misses, statistics.MissCount);
+            Assert::AreEqual(evictions, statistics.EvictionCount);
+            Assert::AreEqual(realizations, statistics.RealizationCount);
+        }
+    };
+
+    TEST_METHOD_EX(GeometryRealizationCache_IsDisabledByDefault)
+    {
+        Fixture f(GeometryRealizationCache::DefaultMaximumSizeInBytes);
+
+        // A disabled cache doesn't even look at the device context.
+        f.DeviceContext->GetTransformMethod.SetExpectedCalls(0);
+        f.DeviceContext->GetDpiMethod.SetExpectedCalls(0);
+        f.ExpectCreateFilledGeometryRealization(0);
+        f.ExpectCreateStrokedGeometryRealization(0);
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Assert::IsNull(f.Fill(geometry.Get()).Get());
+            Assert::IsNull(f.Stroke(geometry.Get()).Get());
+        }
+
+        f.AssertStatistics(0, 0, 0, 0);
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_IsAnyEnabled_TracksCachesWithANonZeroSize)
+    {
+        Assert::IsFalse(GeometryRealizationCache::IsAnyEnabled());
+
+        {
+            GeometryRealizationCache cache;
+            Assert::IsFalse(GeometryRealizationCache::IsAnyEnabled());
+
+            cache.SetMaximumSize(1024);
+            Assert::IsTrue(GeometryRealizationCache::IsAnyEnabled());
+
+            cache.SetMaximumSize(2048);
+            Assert::IsTrue(GeometryRealizationCache::IsAnyEnabled());
+
+            cache.SetMaximumSize(0);
+            Assert::IsFalse(GeometryRealizationCache::IsAnyEnabled());
+
+            cache.SetMaximumSize(1024);
+        }
+
+        Assert::IsFalse(GeometryRealizationCache::IsAnyEnabled());
+
+        {
+            GeometryRealizationCache cache1(1024);
+            GeometryRealizationCache cache2(1024);
+            Assert::IsTrue(GeometryRealizationCache::IsAnyEnabled());
+
+            cache1.SetMaximumSize(0);
+            Assert::IsTrue(GeometryRealizationCache::IsAnyEnabled());
+        }
+
+        Assert::IsFalse(GeometryRealizationCache::IsAnyEnabled());
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_GeometryIsRealizedTheSecondTimeItIsDrawn)
+    {
+        Fixture f;
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        f.ExpectCreateFilledGeometryRealization(0);
+        Assert::IsNull(f.Fill(geometry.Get()).Get());
+        f.AssertStatistics(0, 1, 0, 0);
+
+        ComPtr<ID2D1GeometryRealization> createdRealization;
+
+        f.DeviceContext->CreateFilledGeometryRealizationMethod.SetExpectedCalls(1,
+            [&] (ID2D1Geometry* actualGeometry, FLOAT flatteningTolerance, ID2D1GeometryRealization** realization)
+            {
+                Assert::IsTrue(IsSameInstance(geometry.Get(), actualGeometry));
+                Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE, flatteningTolerance);
+
+                createdRealization = Make<MockD2DGeometryRealization>();
+                return createdRealization.CopyTo(realization);
+            });
+
+        auto realization = f.Fill(geometry.Get());
+        Assert::IsTrue(IsSameInstance(createdRealization.Get(), realization.Get()));
+        f.AssertStatistics(0, 2, 0, 1);
+
+        f.ExpectCreateFilledGeometryRealization(0);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Assert::IsTrue(IsSameInstance(createdRealization.Get(), f.Fill(geometry.Get()).Get()));
+        }
+
+        f.AssertStatistics(3, 2, 0, 1);
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_FillsAndStrokesAreCachedSeparately)
+    {
+        Fixture f;
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        f.ExpectCreateFilledGeometryRealization(1);
+        f.Fill(geometry.Get());
+        auto filled = f.Fill(geometry.Get());
+
+        f.DeviceContext->CreateStrokedGeometryRealizationMethod.SetExpectedCalls(2,
+            [&] (ID2D1Geometry*, FLOAT, FLOAT strokeWidth, ID2D1StrokeStyle*, ID2D1GeometryRealization** realization)
+            {
+                Assert::IsTrue(strokeWidth == 1 || strokeWidth == 2);
+                return Make<MockD2DGeometryRealization>().CopyTo(realization);
+            });
+
+        f.Stroke(geometry.Get(), 1);
+        auto thin = f.Stroke(geometry.Get(), 1);
+
+        f.Stroke(geometry.Get(), 2);
+        auto thick = f.Stroke(geometry.Get(), 2);
+
+        Assert::IsFalse(IsSameInstance(filled.Get(), thin.Get()));
+        Assert::IsFalse(IsSameInstance(thin.Get(), thick.Get()));
+
+        f.ExpectCreateFilledGeometryRealization(0);
+        f.ExpectCreateStrokedGeometryRealization(0);
+
+        Assert::IsTrue(IsSameInstance(filled.Get(), f.Fill(geometry.Get()).Get()));
+        Assert::IsTrue(IsSameInstance(thin.Get(), f.Stroke(geometry.Get(), 1).Get()));
+        Assert::IsTrue(IsSameInstance(thick.Get(), f.Stroke(geometry.Get(), 2).Get()));
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_StrokesThatIgnoreTheTransformAreNotRealized)
+    {
+        Fixture f;
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        f.ExpectCreateStrokedGeometryRealization(0);
+
+        for (auto transformType : { D2D1_STROKE_TRANSFORM_TYPE_FIXED, D2D1_STROKE_TRANSFORM_TYPE_HAIRLINE })
+        {
+            auto strokeStyle = Make<StrokeStyleWithTransformType>(transformType);
+
+            for (int i = 0; i < 3; ++i)
+            {
+                Assert::IsNull(f.Stroke(geometry.Get(), 1, strokeStyle.Get()).Get());
+            }
+        }
+
+        f.AssertStatistics(0, 0, 0, 0);
+
+        auto normalStrokeStyle = Make<StrokeStyleWithTransformType>(D2D1_STROKE_TRANSFORM_TYPE_NORMAL);
+
+        f.ExpectCreateStrokedGeometryRealization(1);
+        f.Stroke(geometry.Get(), 1, normalStrokeStyle.Get());
+        Assert::IsNotNull(f.Stroke(geometry.Get(), 1, normalStrokeStyle.Get()).Get());
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_SmallScaleChangesReuseTheRealization)
+    {
+        Fixture f;
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        f.Transform = D2D1::Matrix3x2F::Scale(1.1f, 1.1f);
+
+        f.ExpectCreateFilledGeometryRealization(1);
+        f.Fill(geometry.Get());
+        auto realization = f.Fill(geometry.Get());
+
+        // 1.1 and 1.9 both round up to a scale of 2.
+        f.ExpectCreateFilledGeometryRealization(0);
+        f.Transform = D2D1::Matrix3x2F::Scale(1.9f, 1.9f) * D2D1::Matrix3x2F::Translation(100, 50);
+        Assert::IsTrue(IsSameInstance(realization.Get(), f.Fill(geometry.Get()).Get()));
+
+        // Doubling the DPI is the same as doubling the scale.
+        f.ExpectCreateFilledGeometryRealization(1);
+        f.Dpi = DEFAULT_DPI * 2;
+        f.Fill(geometry.Get());
+        Assert::IsFalse(IsSameInstance(realization.Get(), f.Fill(geometry.Get()).Get()));
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_DegenerateTransformsAreNotRealized)
+    {
+        Fixture f;
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        f.Transform = D2D1::Matrix3x2F::Scale(0, 0);
+        f.ExpectCreateFilledGeometryRealization(0);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Assert::IsNull(f.Fill(geometry.Get()).Get());
+        }
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_GetFlatteningTolerance)
+    {
+        auto identity = D2D1::Matrix3x2F::Identity();
+
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE, GeometryRealizationCache::GetFlatteningTolerance(identity, DEFAULT_DPI, DEFAULT_DPI));
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE / 2, GeometryRealizationCache::GetFlatteningTolerance(identity, DEFAULT_DPI * 2, DEFAULT_DPI * 2));
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE / 4, GeometryRealizationCache::GetFlatteningTolerance(D2D1::Matrix3x2F::Scale(3, 1), DEFAULT_DPI, DEFAULT_DPI));
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE * 2, GeometryRealizationCache::GetFlatteningTolerance(D2D1::Matrix3x2F::Scale(0.5f, 0.5f), DEFAULT_DPI, DEFAULT_DPI));
+        Assert::AreEqual(D2D1_DEFAULT_FLATTENING_TOLERANCE, GeometryRealizationCache::GetFlatteningTolerance(D2D1::Matrix3x2F::Rotation(45), DEFAULT_DPI, DEFAULT_DPI));
+
+        Assert::AreEqual(0.0f, GeometryRealizationCache::GetFlatteningTolerance(D2D1::Matrix3x2F::Scale(0, 0), DEFAULT_DPI, DEFAULT_DPI));
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_EstimatedSizeDependsOnSegmentCount)
+    {
+        auto pathGeometry = Make<MockD2DPathGeometry>();
+        uint32_t segmentCount = 10;
+
+        pathGeometry->GetSegmentCountMethod.AllowAnyCall(
+            [&] (UINT32* value)
+            {
+                *value = segmentCount;
+                return S_OK;
+            });
+
+        auto smallFill = GeometryRealizationCache::GetEstimatedSizeInBytes(pathGeometry.Get(), false);
+        auto smallStroke = GeometryRealizationCache::GetEstimatedSizeInBytes(pathGeometry.Get(), true);
+
+        segmentCount = 1000;
+
+        auto largeFill = GeometryRealizationCache::GetEstimatedSizeInBytes(pathGeometry.Get(), false);
+
+        Assert::IsTrue(smallFill < smallStroke);
+        Assert::IsTrue(smallFill < largeFill);
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_LeastRecentlyUsedRealizationsAreEvicted)
+    {
+        auto sizeInBytes = GeometryRealizationCache::GetEstimatedSizeInBytes(Make<MockD2DRectangleGeometry>().Get(), false);
+
+        // Room for two realizations, plus a candidate.
+        Fixture f(sizeInBytes * 2 + GeometryRealizationCache::CandidateSizeInBytes);
+
+        auto a = Make<MockD2DRectangleGeometry>();
+        auto b = Make<MockD2DRectangleGeometry>();
+        auto c = Make<MockD2DRectangleGeometry>();
+
+        f.ExpectCreateFilledGeometryRealization(2);
+        f.Fill(a.Get());
+        f.Fill(a.Get());
+        f.Fill(b.Get());
+        f.Fill(b.Get());
+        f.AssertStatistics(0, 4, 0, 2);
+
+        // Use a, so that b is the least recently used.
+        f.ExpectCreateFilledGeometryRealization(0);
+        f.Fill(a.Get());
+        f.AssertStatistics(1, 4, 0, 2);
+
+        f.ExpectCreateFilledGeometryRealization(1);
+        f.Fill(c.Get());
+        f.Fill(c.Get());
+        f.AssertStatistics(1, 6, 1, 2);
+
+        f.ExpectCreateFilledGeometryRealization(0);
+        Assert::IsNotNull(f.Fill(a.Get()).Get());
+        Assert::IsNotNull(f.Fill(c.Get()).Get());
+        Assert::IsNull(f.Fill(b.Get()).Get());
+
+        Assert::IsTrue(f.Cache->GetStatistics().SizeInBytes <= f.Cache->GetMaximumSize());
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_GeometriesTooLargeForTheCacheAreNotRealized)
+    {
+        auto sizeInBytes = GeometryRealizationCache::GetEstimatedSizeInBytes(Make<MockD2DRectangleGeometry>().Get(), false);
+
+        Fixture f(sizeInBytes - 1);
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        f.ExpectCreateFilledGeometryRealization(0);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            Assert::IsNull(f.Fill(geometry.Get()).Get());
+        }
+
+        Assert::AreEqual<uint64_t>(0, f.Cache->GetStatistics().SizeInBytes);
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_ReducingTheMaximumSizeEvicts)
+    {
+        Fixture f;
+
+        auto geometry = Make<MockD2DRectangleGeometry>();
+
+        f.ExpectCreateFilledGeometryRealization(1);
+        f.Fill(geometry.Get());
+        f.Fill(geometry.Get());
+        f.AssertStatistics(0, 2, 0, 1);
+
+        f.Cache->SetMaximumSize(0);
+
+        f.AssertStatistics(0, 2, 1, 0);
+        Assert::AreEqual<uint64_t>(0, f.Cache->GetStatistics().SizeInBytes);
+    }
+
+    TEST_METHOD_EX(GeometryRealizationCache_ClearReleasesRealizations)
+    {
+        Fixture f;
+
+        int liveRealizationCount = 0;
+
+        f.DeviceContext->CreateFilledGeometryRealizationMethod.SetExpectedCalls(2,
+            [&] (ID2D1Geometry*, FLOAT, ID2D1GeometryRealization** realization)
+            {
+                return Make<CountedGeometryRealization>(&liveRealizationCount).CopyTo(realization);
+            });
+
+        auto a = Make<MockD2DRectangleGeometry>();
+        auto b = Make<MockD2DRectangleGeometry>();
+
+        f.Fill(a.Get());
+        f.Fill(a.Get());
+        f.Fill(b.Get());
+        f.Fill(b.Get());
+
+        Assert::AreEqual(2, liveRealizationCount);
+
+        f.Cache->Clear();
+
+        Assert::AreEqual(0, liveRealizationCount);
+
+        auto statistics = f.Cache->GetStatistics();
+        Assert::AreEqual(0u, statistics.RealizationCount);
+        Assert::AreEqual<uint64_t>(0, statistics.SizeInBytes);
+    }
+};
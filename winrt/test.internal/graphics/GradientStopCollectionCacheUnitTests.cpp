@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Brushes;
+
+TEST_CLASS(GradientStopCollectionCacheUnitTests)
+{
+public:
+    typedef GradientStopCollectionCache::Key Key;
+
+    struct Fixture
+    {
+        std::shared_ptr<GradientStopCollectionCache> Cache;
+        int CreateCount;
+
+        Fixture(uint32_t maximumEntryCount = 16)
+            : Cache(std::make_shared<GradientStopCollectionCache>(maximumEntryCount))
+            , CreateCount(0)
+        {
+        }
+
+        static Key MakeKey(
+            float position = 0.5f,
+            D2D1_EXTEND_MODE extendMode = D2D1_EXTEND_MODE_CLAMP)
+        {
+            return Key
+            {
+                std::vector<D2D1_GRADIENT_STOP>
+                {
+                    D2D1_GRADIENT_STOP{ 0, D2D1::ColorF(1, 0, 0, 1) },
+                    D2D1_GRADIENT_STOP{ position, D2D1::ColorF(0, 1, 0, 1) },
+                    D2D1_GRADIENT_STOP{ 1, D2D1::ColorF(0, 0, 1, 1) },
+                },
+                D2D1_COLOR_SPACE_SRGB,
+                D2D1_COLOR_SPACE_SRGB,
+                D2D1_BUFFER_PRECISION_8BPC_UNORM,
+                extendMode,
+                D2D1_COLOR_INTERPOLATION_MODE_PREMULTIPLIED
+            };
+        }
+
+        ComPtr<ID2D1GradientStopCollection1> Get(Key key)
+        {
+            return Cache->GetOrCreate(std::move(key),
+                [&] (Key const&)
+                {
+                    ++CreateCount;
+                    return Make<MockD2DGradientStopCollection>();
+                });
+        }
+
+        void AssertStatistics(uint64_t hits, uint64_t misses, uint64_t evictions, uint32_t entries)
+        {
+            auto statistics = Cache->GetStatistics();
+
+            Assert::AreEqual(hits, statistics.HitCount);
+            Assert::AreEqual(misses, statistics.MissCount);
+            Assert::AreEqual(evictions, statistics.EvictionCount);
+            Assert::AreEqual(entries, statistics.EntryCount);
+        }
+    };
+
+    TEST_METHOD_EX(GradientStopCollectionCache_IsDisabledByDefault)
+    {
+        Fixture f(GradientStopCollectionCache::DefaultMaximumEntryCount);
+
+        Assert::IsFalse(f.Cache->IsEnabled());
+
+        auto a = f.Get(f.MakeKey());
+        auto b = f.Get(f.MakeKey());
+
+        Assert::AreEqual(2, f.CreateCount);
+        Assert::IsFalse(IsSameInstance(a.Get(), b.Get()));
+
+        f.AssertStatistics(0, 0, 0, 0);
+    }
+
+    TEST_METHOD_EX(GradientStopCollectionCache_IdenticalKeysShareOneCollection)
+    {
+        Fixture f;
+
+        auto a = f.Get(f.MakeKey());
+        auto b = f.Get(f.MakeKey());
+        auto c = f.Get(f.MakeKey());
+
+        Assert::AreEqual(1, f.CreateCount);
+        Assert::IsTrue(IsSameInstance(a.Get(), b.Get()));
+        Assert::IsTrue(IsSameInstance(a.Get(), c.Get()));
+
+        f.AssertStatistics(2, 1, 0, 1);
+    }
+
+    TEST_METHOD_EX(GradientStopCollectionCache_AnyDifferenceGivesANewCollection)
+    {
+        Fixture f;
+
+        auto original = f.MakeKey();
+        f.Get(original);
+
+        std::vector<Key> variations(8, original);
+
+        variations[0].Stops[1].position = 0.25f;
+        variations[1].Stops[1].color.a = 0.5f;
+        variations[2].Stops.pop_back();
+        variations[3].PreInterpolationSpace = D2D1_COLOR_SPACE_SCRGB;
+        variations[4].PostInterpolationSpace = D2D1_COLOR_SPACE_SCRGB;
+        variations[5].BufferPrecision = D2D1_BUFFER_PRECISION_32BPC_FLOAT;
+        variations[6].ExtendMode = D2D1_EXTEND_MODE_WRAP;
+        variations[7].InterpolationMode = D2D1_COLOR_INTERPOLATION_MODE_STRAIGHT;
+
+        for (auto& key : variations)
+        {
+            Assert::IsFalse(key == original);
+            f.Get(key);
+        }
+
+        Assert::AreEqual(9, f.CreateCount);
+        f.AssertStatistics(0, 9, 0, 9);
+    }
+
+    TEST_METHOD_EX(GradientStopCollectionCache_NegativeZeroMatchesZero)
+    {
+        auto a = Fixture::MakeKey();
+        auto b = Fixture::MakeKey();
+
+        a.Stops[0].position = 0.0f;
+        b.Stops[0].position = -0.0f;
+
+        Assert::IsTrue(a == b);
+        Assert::AreEqual(GradientStopCollectionCache::GetHash(a), GradientStopCollectionCache::GetHash(b));
+    }
+
+    TEST_METHOD_EX(GradientStopCollectionCache_LeastRecentlyUsedEntriesAreEvicted)
+    {
+        Fixture f(2);
+
+        auto a = f.Get(f.MakeKey(0.1f));
+        f.Get(f.MakeKey(0.2f));
+
+        // Use a, so that the 0.2 entry is the least recently used.
+        f.Get(f.MakeKey(0.1f));
+
+        f.Get(f.MakeKey(0.3f));
+        f.AssertStatistics(1, 3, 1, 2);
+
+        Assert::IsTrue(IsSameInstance(a.Get(), f.Get(f.MakeKey(0.1f)).Get()));
+        Assert::AreEqual(3, f.CreateCount);
+
+        f.Get(f.MakeKey(0.2f));
+        Assert::AreEqual(4, f.CreateCount);
+    }
+
+    TEST_METHOD_EX(GradientStopCollectionCache_ReducingTheMaximumEntryCountEvicts)
+    {
+        Fixture f;
+
+        for (int i = 0; i < 5; ++i)
+        {
+            f.Get(f.MakeKey(i / 10.0f));
+        }
+
+        f.Cache->SetMaximumEntryCount(2);
+        Assert::IsTrue(f.Cache->IsEnabled());
+        f.AssertStatistics(0, 5, 3, 2);
+
+        f.Cache->SetMaximumEntryCount(0);
+        Assert::IsFalse(f.Cache->IsEnabled());
+        f.AssertStatistics(0, 5, 5, 0);
+    }
+
+    TEST_METHOD_EX(GradientStopCollectionCache_ClearReleasesCollections)
+    {
+        Fixture f;
+
+        f.Get(f.MakeKey(0.1f));
+        f.Get(f.MakeKey(0.2f));
+
+        f.Cache->Clear();
+        f.AssertStatistics(0, 2, 0, 0);
+
+        f.Get(f.MakeKey(0.1f));
+        Assert::AreEqual(3, f.CreateCount);
+    }
+};
@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/images/HistogramBatch.h>
+
+TEST_CLASS(HistogramBatchUnitTests)
+{
+public:
+    typedef HistogramBatch::Region Region;
+
+    static ComPtr<MockD2DEffectThatCountsCalls> MakeEffect(IID const& effectId)
+    {
+        auto effect = Make<MockD2DEffectThatCountsCalls>(effectId);
+        auto rawEffect = effect.Get();
+
+        effect->MockGetOutput = [rawEffect](ID2D1Image** output)
+        {
+            rawEffect->AddRef();
+            *output = rawEffect;
+        };
+
+        return effect;
+    }
+
+    struct Fixture
+    {
+        ComPtr<StubCanvasDevice> Device;
+        ComPtr<MockD2DDeviceContext> DeviceContext;
+        ComPtr<StubD2DBitmap> Bitmap;
+
+        std::vector<CanvasDevice::HistogramAndAtlasEffects> LeasedChains;
+        int ReleasedCount;
+
+        // When set, leased chains already have a luminance effect.
+        ComPtr<MockD2DEffectThatCountsCalls> PooledLuminanceEffect;
+
+        std::vector<ComPtr<MockD2DEffectThatCountsCalls>> CreatedLuminanceEffects;
+
+        Fixture()
+            : Device(Make<StubCanvasDevice>())
+            , DeviceContext(Make<MockD2DDeviceContext>())
+            , Bitmap(Make<StubD2DBitmap>())
+            , ReleasedCount(0)
+        {
+            Device->LeaseHistogramEffectMethod.AllowAnyCall(
+                [=](ID2D1DeviceContext* context)
+                {
+                    Assert::IsTrue(IsSameInstance(DeviceContext.Get(), context));
+
+                    auto histogram = MakeEffect(CLSID_D2D1Histogram);
+                    auto rawHistogram = histogram.Get();
+
+                    // Fills every bin with the selected channel, so tests can
+                    // check where each histogram ended up.
+                    histogram->MockGetValue = [rawHistogram](UINT32 index, D2D1_PROPERTY_TYPE, BYTE* data, UINT32 dataSize)
+                    {
+                        Assert::AreEqual<uint32_t>(D2D1_HISTOGRAM_PROP_HISTOGRAM_OUTPUT, index);
+
+                        auto& numBins = rawHistogram->m_properties[D2D1_HISTOGRAM_PROP_NUM_BINS];
+                        Assert::AreEqual(*reinterpret_cast<int32_t const*>(numBins.data()) * sizeof(float), static_cast<size_t>(dataSize));
+
+                        auto channel = *reinterpret_cast<int32_t const*>(rawHistogram->m_properties[D2D1_HISTOGRAM_PROP_CHANNEL_SELECT].data());
+                        auto values = reinterpret_cast<float*>(data);
+
+                        std::fill(values, values + dataSize / sizeof(float), static_cast<float>(channel));
+
+                        return S_OK;
+                    };
+
+                    CanvasDevice::HistogramAndAtlasEffects chain{ histogram, MakeEffect(CLSID_D2D1Atlas), PooledLuminanceEffect };
+                    LeasedChains.push_back(chain);
+                    return chain;
+                });
+
+            Device->ReleaseHistogramEffectMethod.AllowAnyCall(
+                [=](CanvasDevice::HistogramAndAtlasEffects chain)
+                {
+                    auto atlas = static_cast<MockD2DEffectThatCountsCalls*>(chain.AtlasEffect.Get());
+                    Assert::IsNull(atlas->m_inputs[0].Get());
+
+                    ++ReleasedCount;
+                });
+
+            DeviceContext->CreateEffectMethod.AllowAnyCall(
+                [=](IID const& effectId, ID2D1Effect** effect)
+                {
+                    Assert::AreEqual(CLSID_D2D1ColorMatrix, effectId);
+
+                    auto luminance = MakeEffect(effectId);
+                    CreatedLuminanceEffects.push_back(luminance);
+                    return luminance.CopyTo(effect);
+                });
+        }
+
+        Region MakeRegion(CanvasHistogramChannels channels, int32_t numberOfBins = 16)
+        {
+            return Region{ Bitmap, DEFAULT_DPI, D2D1_RECT_F{ 1, 2, 3, 4 }, channels, numberOfBins };
+        }
+
+        std::vector<float> Evaluate(std::vector<Region>&& regions)
+        {
+            HistogramBatch batch(Device, std::move(regions));
+
+            auto results = batch.Evaluate(DeviceContext.Get());
+
+            Assert::AreEqual(batch.GetResultCount(), results.size());
+            return results;
+        }
+
+        MockD2DEffectThatCountsCalls* GetHistogram(size_t index)
+        {
+            return static_cast<MockD2DEffectThatCountsCalls*>(LeasedChains[index].HistogramEffect.Get());
+        }
+
+        MockD2DEffectThatCountsCalls* GetAtlas(size_t index)
+        {
+            return static_cast<MockD2DEffectThatCountsCalls*>(LeasedChains[index].AtlasEffect.Get());
+        }
+    };
+
+    static void AssertBins(std::vector<float> const& results, size_t offset, size_t numberOfBins, float expected)
+    {
+        for (size_t i = 0; i < numberOfBins; ++i)
+        {
+            Assert::AreEqual(expected, results[offset + i]);
+        }
+    }
+
+    TEST_METHOD_EX(HistogramBatch_ComputesEachSelectedChannelInOnePass)
+    {
+        Fixture f;
+
+        f.DeviceContext->BeginDrawMethod.SetExpectedCalls(1);
+        f.DeviceContext->EndDrawMethod.SetExpectedCalls(1);
+
+        int drawCount = 0;
+
+        f.DeviceContext->DrawImageMethod.SetExpectedCalls(3,
+            [&](ID2D1Image* image, D2D1_POINT_2F const*, D2D1_RECT_F const*, D2D1_INTERPOLATION_MODE, D2D1_COMPOSITE_MODE)
+            {
+                Assert::IsTrue(IsSameInstance(f.LeasedChains[drawCount++].HistogramEffect.Get(), image));
+            });
+
+        auto results = f.Evaluate({ f.MakeRegion(CanvasHistogramChannels::Red | CanvasHistogramChannels::Blue | CanvasHistogramChannels::Luminance) });
+
+        Assert::AreEqual<size_t>(3, f.LeasedChains.size());
+        Assert::AreEqual(3, f.ReleasedCount);
+
+        Assert::AreEqual<size_t>(48, results.size());
+        AssertBins(results, 0, 16, D2D1_CHANNEL_SELECTOR_R);
+        AssertBins(results, 16, 16, D2D1_CHANNEL_SELECTOR_B);
+        AssertBins(results, 32, 16, D2D1_CHANNEL_SELECTOR_R);
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            auto atlas = f.GetAtlas(i);
+
+            // Set to the bitmap, then cleared before release.
+            Assert::AreEqual(2, atlas->m_setInputCalls);
+
+            Assert::AreEqual(D2D1_RECT_F{ 1, 2, 3, 4 }, *reinterpret_cast<D2D1_RECT_F*>(atlas->m_properties[D2D1_ATLAS_PROP_INPUT_RECT].data()));
+        }
+
+        // The color channels read the atlas directly.
+        Assert::IsTrue(IsSameInstance(f.GetAtlas(0), f.GetHistogram(0)->m_inputs[0].Get()));
+        Assert::IsTrue(IsSameInstance(f.GetAtlas(1), f.GetHistogram(1)->m_inputs[0].Get()));
+
+        // Luminance goes through a color matrix.
+        Assert::AreEqual<size_t>(1, f.CreatedLuminanceEffects.size());
+
+        auto luminance = f.CreatedLuminanceEffects[0];
+
+        Assert::IsTrue(IsSameInstance(luminance.Get(), f.LeasedChains[2].LuminanceEffect.Get()));
+        Assert::IsTrue(IsSameInstance(luminance.Get(), f.GetHistogram(2)->m_inputs[0].Get()));
+        Assert::IsTrue(IsSameInstance(f.GetAtlas(2), luminance->m_inputs[0].Get()));
+
+        auto matrix = reinterpret_cast<D2D1_MATRIX_5X4_F*>(luminance->m_properties[D2D1_COLORMATRIX_PROP_COLOR_MATRIX].data());
+        Assert::AreEqual(0.2126f, matrix->_11);
+        Assert::AreEqual(0.7152f, matrix->_21);
+        Assert::AreEqual(0.0722f, matrix->_31);
+        Assert::AreEqual(1.0f, matrix->_44);
+    }
+
+    TEST_METHOD_EX(HistogramBatch_ReusesLuminanceEffectOfPooledChain)
+    {
+        Fixture f;
+
+        f.PooledLuminanceEffect = MakeEffect(CLSID_D2D1ColorMatrix);
+
+        f.DeviceContext->BeginDrawMethod.SetExpectedCalls(1);
+        f.DeviceContext->EndDrawMethod.SetExpectedCalls(1);
+        f.DeviceContext->DrawImageMethod.SetExpectedCalls(1);
+
+        f.Evaluate({ f.MakeRegion(CanvasHistogramChannels::Luminance) });
+
+        Assert::AreEqual<size_t>(0, f.CreatedLuminanceEffects.size());
+        Assert::IsTrue(IsSameInstance(f.PooledLuminanceEffect.Get(), f.GetHistogram(0)->m_inputs[0].Get()));
+    }
+
+    TEST_METHOD_EX(HistogramBatch_SplitsLargeBatchesIntoSeveralPasses)
+    {
+        Fixture f;
+
+        auto allColors = CanvasHistogramChannels::Red | CanvasHistogramChannels::Green | CanvasHistogramChannels::Blue | CanvasHistogramChannels::Alpha;
+        const int regionCount = 3;
+        const int numBins = 8;
+
+        static_assert(regionCount * 4 > CanvasDevice::MaximumPooledHistogramEffects, "test needs more than one pass");
+
+        f.DeviceContext->BeginDrawMethod.SetExpectedCalls(2);
+        f.DeviceContext->EndDrawMethod.SetExpectedCalls(2);
+        f.DeviceContext->DrawImageMethod.SetExpectedCalls(regionCount * 4);
+
+        std::vector<Region> regions;
+
+        for (int i = 0; i < regionCount; ++i)
+        {
+            regions.push_back(f.MakeRegion(allColors, numBins));
+        }
+
+        auto results = f.Evaluate(std::move(regions));
+
+        Assert::AreEqual<size_t>(regionCount * 4, f.LeasedChains.size());
+        Assert::AreEqual(regionCount * 4, f.ReleasedCount);
+
+        Assert::AreEqual<size_t>(regionCount * 4 * numBins, results.size());
+
+        for (int region = 0; region < regionCount; ++region)
+        {
+            for (int channel = 0; channel < 4; ++channel)
+            {
+                AssertBins(results, (region * 4 + channel) * numBins, numBins, static_cast<float>(channel));
+            }
+        }
+    }
+
+    TEST_METHOD_EX(HistogramBatch_ReleasesChainsWhenEndDrawFails)
+    {
+        Fixture f;
+
+        f.DeviceContext->BeginDrawMethod.SetExpectedCalls(1);
+        f.DeviceContext->DrawImageMethod.SetExpectedCalls(2);
+        f.DeviceContext->EndDrawMethod.SetExpectedCalls(1, [](D2D1_TAG*, D2D1_TAG*) { return D2DERR_RECREATE_TARGET; });
+
+        ExpectHResultException(D2DERR_RECREATE_TARGET,
+            [&]
+            {
+                f.Evaluate({ f.MakeRegion(CanvasHistogramChannels::Red | CanvasHistogramChannels::Green) });
+            });
+
+        Assert::AreEqual(2, f.ReleasedCount);
+    }
+
+    TEST_METHOD_EX(HistogramBatch_ValidateRegion)
+    {
+        auto validate = [](CanvasHistogramChannels channels, int32_t numberOfBins)
+        {
+            HistogramBatch::ValidateRegion(CanvasHistogramRegion{ Rect{ 0, 0, 1, 1 }, channels, numberOfBins });
+        };
+
+        validate(CanvasHistogramChannels::Red, 2);
+        validate(CanvasHistogramChannels::Luminance, 1024);
+
+        ExpectHResultException(E_INVALIDARG, [&] { validate(CanvasHistogramChannels::None, 64); });
+        ExpectHResultException(E_INVALIDARG, [&] { validate(static_cast<CanvasHistogramChannels>(0x20), 64); });
+        ExpectHResultException(E_INVALIDARG, [&] { validate(CanvasHistogramChannels::Red, 1); });
+        ExpectHResultException(E_INVALIDARG, [&] { validate(CanvasHistogramChannels::Red, 1025); });
+    }
+};
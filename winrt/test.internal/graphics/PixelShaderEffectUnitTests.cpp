@@ -9,6 +9,7 @@
 #include <lib/effects/shader/PixelShaderTransform.h>
 #include <lib/effects/shader/ClipTransform.h>
 #include <lib/effects/shader/SharedShaderState.h>
+#include <lib/effects/shader/InternedShaderTable.h>
 
 #include "mocks/MockD2DDrawInfo.h"
 #include "mocks/MockD2DEffectContext.h"
@@ -1359,18 +1360,53 @@ TEST_CLASS(SharedShaderStateUnitTests)
         Assert::AreEqual(coordinateMapping.MaxOffset, originalState->CoordinateMapping().MaxOffset);
         Assert::AreEqual<int>(sourceInterpolation.Filter[0], originalState->SourceInterpolation().Filter[0]);
 
+        auto statisticsBefore = SharedShaderState::GetCloneStatistics();
+
         auto clone = originalState->Clone();
 
+        auto statisticsAfter = SharedShaderState::GetCloneStatistics();
+
         Assert::AreEqual(desc.InputCount, clone->Shader().InputCount);
         Assert::AreEqual<size_t>(1, clone->Constants().size());
         Assert::AreEqual(constants[0], clone->Constants()[0]);
         Assert::AreEqual(coordinateMapping.MaxOffset, clone->CoordinateMapping().MaxOffset);
         Assert::AreEqual<int>(sourceInterpolation.Filter[0], clone->SourceInterpolation().Filter[0]);
 
-        Assert::AreNotEqual<void const*>(&originalState->Shader(), &clone->Shader());
+        // The shader is shared, while the app-specified state is copied.
+        Assert::AreEqual<void const*>(&originalState->Shader(), &clone->Shader());
         Assert::AreNotEqual<void const*>(&originalState->Constants(), &clone->Constants());
         Assert::AreNotEqual<void const*>(&originalState->CoordinateMapping(), &clone->CoordinateMapping());
         Assert::AreNotEqual<void const*>(&originalState->SourceInterpolation(), &clone->SourceInterpolation());
+
+        Assert::AreEqual<uint64_t>(1, statisticsAfter.CloneCount - statisticsBefore.CloneCount);
+        Assert::AreEqual<uint64_t>(sizeof(ShaderDescription), statisticsAfter.SharedBytes - statisticsBefore.SharedBytes);
+        Assert::AreEqual<uint64_t>(sizeof(SharedShaderState) + constants.size(), statisticsAfter.DuplicatedBytes - statisticsBefore.DuplicatedBytes);
+    };
+
+
+    TEST_METHOD_EX(SharedShaderState_CloneCountsSharedShaderCode)
+    {
+        auto originalState = Make<SharedShaderState>(compiledShader1.data(), static_cast<unsigned>(compiledShader1.size()));
+
+        auto statisticsBefore = SharedShaderState::GetCloneStatistics();
+
+        auto clone = originalState->Clone();
+
+        auto statisticsAfter = SharedShaderState::GetCloneStatistics();
+
+        auto sharedBytes = statisticsAfter.SharedBytes - statisticsBefore.SharedBytes;
+        auto duplicatedBytes = statisticsAfter.DuplicatedBytes - statisticsBefore.DuplicatedBytes;
+
+        Assert::IsTrue(sharedBytes > compiledShader1.size());
+        Assert::AreEqual<uint64_t>(sizeof(SharedShaderState) + originalState->Constants().size(), duplicatedBytes);
+
+        // Changing the clone's constants must not affect the original.
+        auto originalConstants = originalState->Constants();
+
+        clone->SetProperty(HStringReference(L"f").Get(), Make<Nullable<float>>(42.0f).Get());
+
+        Assert::AreEqual(originalConstants, originalState->Constants());
+        Assert::AreNotEqual(originalConstants, clone->Constants());
     };
 
 
@@ -1386,6 +1422,73 @@ TEST_CLASS(SharedShaderStateUnitTests)
         Assert::AreEqual(state2a->Shader().Hash, state2b->Shader().Hash);
 
         Assert::AreNotEqual(state1a->Shader().Hash, state2a->Shader().Hash);
+
+        // States created from the same code share a single interned description.
+        Assert::AreEqual<void const*>(&state1a->Shader(), &state1b->Shader());
+        Assert::AreEqual<void const*>(&state2a->Shader(), &state2b->Shader());
+        Assert::AreNotEqual<void const*>(&state1a->Shader(), &state2a->Shader());
+
+        // But each gets its own constant buffer.
+        Assert::AreNotEqual<void const*>(&state1a->Constants(), &state1b->Constants());
+        Assert::IsTrue(state1a->Constants() == state1b->Constants());
+    };
+
+
+    TEST_METHOD_EX(InternedShaderTable_ReflectsEachShaderOnce)
+    {
+        auto table = InternedShaderTable::GetInstance();
+
+        std::vector<BYTE> code1 = { 1, 2, 3 };
+        std::vector<BYTE> code2 = { 1, 2, 4 };
+
+        int reflectCount = 0;
+
+        auto getOrCreate = [&](std::vector<BYTE> const& code)
+        {
+            return table->GetOrCreate(code.data(), code.size(),
+                [&]
+                {
+                    ++reflectCount;
+
+                    auto shader = std::make_shared<ReflectedShader>();
+                    shader->Shader.Code = code;
+                    return shader;
+                });
+        };
+
+        auto shader1a = getOrCreate(code1);
+        auto shader1b = getOrCreate(code1);
+        auto shader2 = getOrCreate(code2);
+
+        Assert::AreEqual(2, reflectCount);
+        Assert::IsTrue(shader1a == shader1b);
+        Assert::IsFalse(shader1a == shader2);
+        Assert::AreEqual<size_t>(2, table->GetShaderCount());
+
+        // Shaders are dropped from the table once nothing is using them.
+        shader1a.reset();
+        shader1b.reset();
+
+        Assert::AreEqual<size_t>(1, table->GetShaderCount());
+
+        getOrCreate(code1);
+        Assert::AreEqual(3, reflectCount);
+    };
+
+
+    TEST_METHOD_EX(InternedShaderTable_FailedReflectionIsNotAdded)
+    {
+        auto table = InternedShaderTable::GetInstance();
+
+        BYTE code[] = { 5, 6, 7 };
+
+        ExpectHResultException(E_INVALIDARG,
+            [&]
+            {
+                table->GetOrCreate(code, sizeof(code), [&]() -> std::shared_ptr<ReflectedShader> { ThrowHR(E_INVALIDARG); });
+            });
+
+        Assert::AreEqual<size_t>(0, table->GetShaderCount());
     };
 
 
@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/text/ShapingCache.h>
+
+#include "mocks/MockDWriteFontFace.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Text;
+
+TEST_CLASS(ShapingCacheUnitTests)
+{
+public:
+    struct Fixture
+    {
+        std::shared_ptr<ShapingCache> Cache;
+        ComPtr<IDWriteFontFace> FontFace;
+
+        Fixture(uint32_t maximumEntryCount = 16, uint64_t maximumSizeInBytes = ShapingCache::DefaultMaximumSizeInBytes)
+            : Cache(std::make_shared<ShapingCache>(maximumEntryCount, maximumSizeInBytes))
+            , FontFace(Make<MockDWriteFontFace>())
+        {
+        }
+
+        ShapingParameters MakeParameters(std::wstring const& text)
+        {
+            ShapingParameters parameters{};
+            parameters.Text = text.c_str();
+            parameters.TextLength = static_cast<uint32_t>(text.size());
+            parameters.FontFace = FontFace.Get();
+            parameters.FontSize = 20.0f;
+            parameters.Script.script = 123;
+            parameters.Locale = L"en-us";
+            return parameters;
+        }
+
+        // Makes a run with one glyph per character, plus some unused
+        // capacity as left over by RetryWithIncreasingGlyphCount.
+        static ShapedGlyphRun MakeRun(uint32_t textLength, uint16_t firstGlyphIndex = 1)
+        {
+            ShapedGlyphRun run;
+            run.ClusterMap.resize(textLength);
+            run.TextProperties.resize(textLength);
+            run.GlyphIndices.resize(textLength + 16);
+            run.GlyphProperties.resize(textLength + 16);
+            run.GlyphAdvances.resize(textLength);
+            run.GlyphOffsets.resize(textLength);
+            run.GlyphCount = textLength;
+
+            for (uint32_t i = 0; i < textLength; ++i)
+            {
+                run.ClusterMap[i] = static_cast<uint16_t>(i);
+                run.GlyphIndices[i] = static_cast<uint16_t>(firstGlyphIndex + i);
+                run.GlyphAdvances[i] = static_cast<float>(i) * 10;
+            }
+
+            return run;
+        }
+
+        std::shared_ptr<ShapedGlyphRun const> Get(ShapingParameters const& parameters)
+        {
+            return Cache->TryGet(ShapingCache::GetHash(parameters), parameters);
+        }
+
+        void Add(ShapingParameters const& parameters, ShapedGlyphRun const& run)
+        {
+            Cache->Add(ShapingCache::GetHash(parameters), parameters, run);
+        }
+
+        void AssertStatistics(uint64_t hits, uint64_t misses, uint64_t evictions, uint32_t entries)
+        {
+            auto statistics = Cache->GetStatistics();
+
+            Assert::AreEqual(hits, statistics.HitCount);
+            Assert::AreEqual(misses, statistics.MissCount);
+            Assert::AreEqual(evictions, statistics.EvictionCount);
+            Assert::AreEqual(entries, statistics.EntryCount);
+        }
+    };
+
+    TEST_METHOD_EX(ShapingCache_IsDisabledByDefault)
+    {
+        Fixture f(ShapingCache::DefaultMaximumEntryCount);
+
+        Assert::IsFalse(f.Cache->IsEnabled());
+
+        std::wstring text = L"hello";
+        auto parameters = f.MakeParameters(text);
+
+        f.Add(parameters, Fixture::MakeRun(5));
+
+        f.AssertStatistics(0, 0, 0, 0);
+    }
+
+    TEST_METHOD_EX(ShapingCache_ReturnsTrimmedCopyOfAddedRun)
+    {
+        Fixture f;
+
+        std::wstring text = L"hello";
+        auto parameters = f.MakeParameters(text);
+
+        Assert::IsNull(f.Get(parameters).get());
+
+        f.Add(parameters, Fixture::MakeRun(5));
+
+        auto run = f.Get(parameters);
+        Assert::IsNotNull(run.get());
+
+        Assert::AreEqual(5u, run->GlyphCount);
+        Assert::AreEqual<size_t>(5, run->ClusterMap.size());
+        Assert::AreEqual<size_t>(5, run->GlyphIndices.size());
+        Assert::AreEqual<size_t>(5, run->GlyphProperties.size());
+        Assert::AreEqual<uint16_t>(5, run->GlyphIndices[4]);
+        Assert::AreEqual(40.0f, run->GlyphAdvances[4]);
+
+        // The text is compared by value, not by pointer.
+        std::wstring sameText = L"hello";
+        Assert::IsTrue(run == f.Get(f.MakeParameters(sameText)));
+
+        f.AssertStatistics(2, 1, 0, 1);
+    }
+
+    TEST_METHOD_EX(ShapingCache_DifferentParametersMiss)
+    {
+        Fixture f;
+
+        std::wstring text = L"hello";
+        auto parameters = f.MakeParameters(text);
+
+        f.Add(parameters, Fixture::MakeRun(5));
+
+        std::vector<std::function<void(ShapingParameters&)>> changes
+        {
+            [] (ShapingParameters& p) { p.TextLength = 4; },
+            [] (ShapingParameters& p) { p.FontSize = 21.0f; },
+            [] (ShapingParameters& p) { p.IsSideways = true; },
+            [] (ShapingParameters& p) { p.IsRightToLeft = true; },
+            [] (ShapingParameters& p) { p.Script.script = 124; },
+            [] (ShapingParameters& p) { p.Script.shapes = DWRITE_SCRIPT_SHAPES_NO_VISUAL; },
+            [] (ShapingParameters& p) { p.Locale = L"en-gb"; },
+        };
+
+        for (auto& change : changes)
+        {
+            auto changedParameters = parameters;
+            change(changedParameters);
+            Assert::IsNull(f.Get(changedParameters).get());
+        }
+
+        auto otherFontFace = Make<MockDWriteFontFace>();
+        auto changedParameters = parameters;
+        changedParameters.FontFace = otherFontFace.Get();
+        Assert::IsNull(f.Get(changedParameters).get());
+
+        Assert::IsNotNull(f.Get(parameters).get());
+    }
+
+    TEST_METHOD_EX(ShapingCache_MatchesTypographyFeaturesByValue)
+    {
+        Fixture f;
+
+        std::wstring text = L"hello";
+        auto parameters = f.MakeParameters(text);
+
+        DWRITE_FONT_FEATURE features[] = { { DWRITE_FONT_FEATURE_TAG_KERNING, 1 }, { DWRITE_FONT_FEATURE_TAG_STANDARD_LIGATURES, 0 } };
+        DWRITE_TYPOGRAPHIC_FEATURES typographicFeatures{ features, 2 };
+        DWRITE_TYPOGRAPHIC_FEATURES const* featurePointers[] = { &typographicFeatures, nullptr };
+        uint32_t featureRangeLengths[] = { 5, 0 };
+
+        parameters.Features = featurePointers;
+        parameters.FeatureRangeLengths = featureRangeLengths;
+        parameters.FeatureRangeCount = 2;
+
+        f.Add(parameters, Fixture::MakeRun(5));
+
+        // Equal features in different memory still match.
+        DWRITE_FONT_FEATURE sameFeatures[] = { { DWRITE_FONT_FEATURE_TAG_KERNING, 1 }, { DWRITE_FONT_FEATURE_TAG_STANDARD_LIGATURES, 0 } };
+        DWRITE_TYPOGRAPHIC_FEATURES sameTypographicFeatures{ sameFeatures, 2 };
+        DWRITE_TYPOGRAPHIC_FEATURES const* sameFeaturePointers[] = { &sameTypographicFeatures, nullptr };
+
+        auto sameParameters = parameters;
+        sameParameters.Features = sameFeaturePointers;
+        Assert::IsNotNull(f.Get(sameParameters).get());
+
+        // A different feature parameter doesn't.
+        sameFeatures[1].parameter = 1;
+        Assert::IsNull(f.Get(sameParameters).get());
+
+        // Nor do different range lengths.
+        uint32_t otherRangeLengths[] = { 4, 1 };
+        auto otherParameters = parameters;
+        otherParameters.FeatureRangeLengths = otherRangeLengths;
+        Assert::IsNull(f.Get(otherParameters).get());
+
+        // Nor does leaving the features out.
+        auto noFeatures = f.MakeParameters(text);
+        Assert::IsNull(f.Get(noFeatures).get());
+    }
+
+    static ULONG GetRefCount(ComPtr<IDWriteFontFace> const& object)
+    {
+        object->AddRef();
+        return object->Release();
+    }
+
+    TEST_METHOD_EX(ShapingCache_HoldsReferenceToFontFace)
+    {
+        Fixture f;
+
+        std::wstring text = L"hello";
+        auto parameters = f.MakeParameters(text);
+
+        f.Add(parameters, Fixture::MakeRun(5));
+
+        Assert::AreEqual(2ul, GetRefCount(f.FontFace));
+
+        f.Cache->Clear();
+
+        Assert::AreEqual(1ul, GetRefCount(f.FontFace));
+        f.AssertStatistics(0, 0, 0, 0);
+    }
+
+    TEST_METHOD_EX(ShapingCache_EvictsLeastRecentlyUsedPastEntryCount)
+    {
+        Fixture f(2);
+
+        std::wstring a = L"a", b = L"b", c = L"c";
+
+        f.Add(f.MakeParameters(a), Fixture::MakeRun(1));
+        f.Add(f.MakeParameters(b), Fixture::MakeRun(1));
+
+        // Touching "a" makes "b" the least recently used.
+        Assert::IsNotNull(f.Get(f.MakeParameters(a)).get());
+
+        f.Add(f.MakeParameters(c), Fixture::MakeRun(1));
+
+        Assert::IsNotNull(f.Get(f.MakeParameters(a)).get());
+        Assert::IsNull(f.Get(f.MakeParameters(b)).get());
+        Assert::IsNotNull(f.Get(f.MakeParameters(c)).get());
+
+        f.AssertStatistics(3, 1, 1, 2);
+
+        f.Cache->SetMaximumEntryCount(1);
+        f.AssertStatistics(3, 1, 2, 1);
+
+        f.Cache->SetMaximumEntryCount(0);
+        Assert::IsFalse(f.Cache->IsEnabled());
+        f.AssertStatistics(3, 1, 3, 0);
+    }
+
+    TEST_METHOD_EX(ShapingCache_EvictsPastMaximumSize)
+    {
+        const uint64_t entrySize = ShapingCache::GetSizeInBytes(4, 4, 0);
+
+        Fixture f(16, entrySize * 2);
+
+        std::wstring a = L"aaaa", b = L"bbbb", c = L"cccc";
+
+        f.Add(f.MakeParameters(a), Fixture::MakeRun(4));
+        f.Add(f.MakeParameters(b), Fixture::MakeRun(4));
+        f.Add(f.MakeParameters(c), Fixture::MakeRun(4));
+
+        f.AssertStatistics(0, 0, 1, 2);
+        Assert::AreEqual(entrySize * 2, f.Cache->GetStatistics().SizeInBytes);
+
+        // Runs that could never fit aren't added.
+        std::wstring longText(64, L'x');
+        f.Add(f.MakeParameters(longText), Fixture::MakeRun(64));
+
+        f.AssertStatistics(0, 0, 1, 2);
+    }
+
+    TEST_METHOD_EX(ShapingCache_AddingExistingRunKeepsTheFirst)
+    {
+        Fixture f;
+
+        std::wstring text = L"hello";
+        auto parameters = f.MakeParameters(text);
+
+        f.Add(parameters, Fixture::MakeRun(5, 1));
+        f.Add(parameters, Fixture::MakeRun(5, 100));
+
+        auto run = f.Get(parameters);
+        Assert::AreEqual<uint16_t>(1, run->GlyphIndices[0]);
+
+        f.AssertStatistics(1, 0, 0, 1);
+    }
+};
@@ -0,0 +1,230 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+TEST_CLASS(StagingBitmapCacheUnitTests)
+{
+public:
+    struct Fixture
+    {
+        std::shared_ptr<StagingBitmapCache> Cache;
+        ComPtr<MockD2DDeviceContext> DeviceContext;
+
+        D2D1_PIXEL_FORMAT Format;
+
+        Fixture(uint64_t maximumSizeInBytes = StagingBitmapCache::DefaultMaximumSizeInBytes)
+            : Cache(std::make_shared<StagingBitmapCache>(maximumSizeInBytes))
+            , DeviceContext(Make<MockD2DDeviceContext>())
+            , Format(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED))
+        {
+        }
+
+        void ExpectCreateBitmap(int expectedCalls)
+        {
+            DeviceContext->CreateBitmapMethod.SetExpectedCalls(expectedCalls,
+                [] (D2D1_SIZE_U, void const*, UINT32, D2D1_BITMAP_PROPERTIES1 const*, ID2D1Bitmap1** bitmap)
+                {
+                    return Make<MockD2DBitmap>().CopyTo(bitmap);
+                });
+        }
+
+        StagingBitmapCache::Lease Acquire(uint32_t width, uint32_t height)
+        {
+            return Cache->Acquire(DeviceContext.Get(), Format, D2D1_SIZE_U{ width, height });
+        }
+
+        void AssertStatistics(uint64_t hits, uint64_t misses, uint64_t evictions, uint64_t sizeInBytes)
+        {
+            auto statistics = Cache->GetStatistics();
+
+            Assert::AreEqual(hits, statistics.HitCount);
+            Assert::AreEqual(misses, statistics.MissCount);
+            Assert::AreEqual(evictions, statistics.EvictionCount);
+            Assert::AreEqual(sizeInBytes, statistics.SizeInBytes);
+        }
+    };
+
+    static uint64_t BucketBytes(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint64_t>(width) * height * 4;
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_GetBucketSize)
+    {
+        Assert::AreEqual(64U, StagingBitmapCache::GetBucketSize(0));
+        Assert::AreEqual(64U, StagingBitmapCache::GetBucketSize(1));
+        Assert::AreEqual(64U, StagingBitmapCache::GetBucketSize(64));
+        Assert::AreEqual(128U, StagingBitmapCache::GetBucketSize(65));
+        Assert::AreEqual(512U, StagingBitmapCache::GetBucketSize(300));
+        Assert::AreEqual(1024U, StagingBitmapCache::GetBucketSize(1024));
+        Assert::AreEqual(1280U, StagingBitmapCache::GetBucketSize(1025));
+        Assert::AreEqual(16384U, StagingBitmapCache::GetBucketSize(16384));
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_CreatesBitmapsWithBucketSizeAndCpuReadOptions)
+    {
+        Fixture f;
+
+        f.DeviceContext->CreateBitmapMethod.SetExpectedCalls(1,
+            [&] (D2D1_SIZE_U size, void const* sourceData, UINT32 pitch, D2D1_BITMAP_PROPERTIES1 const* bitmapProperties, ID2D1Bitmap1** bitmap)
+            {
+                Assert::AreEqual(128U, size.width);
+                Assert::AreEqual(1280U, size.height);
+                Assert::IsNull(sourceData);
+                Assert::AreEqual(0U, pitch);
+                Assert::AreEqual(D2D1_BITMAP_OPTIONS_CPU_READ | D2D1_BITMAP_OPTIONS_CANNOT_DRAW, bitmapProperties->bitmapOptions);
+                Assert::AreEqual(f.Format.format, bitmapProperties->pixelFormat.format);
+                Assert::AreEqual(f.Format.alphaMode, bitmapProperties->pixelFormat.alphaMode);
+                return Make<MockD2DBitmap>().CopyTo(bitmap);
+            });
+
+        f.Acquire(100, 1100);
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_ReleasedBitmapIsReusedForRequestsInTheSameBucket)
+    {
+        Fixture f;
+        f.ExpectCreateBitmap(1);
+
+        ComPtr<ID2D1Bitmap1> first;
+
+        {
+            auto lease = f.Acquire(10, 20);
+            first = lease.Get();
+        }
+
+        f.AssertStatistics(0, 1, 0, BucketBytes(64, 64));
+
+        auto lease = f.Acquire(64, 1);
+        Assert::IsTrue(IsSameInstance(first.Get(), lease.Get()));
+
+        f.AssertStatistics(1, 1, 0, 0);
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_OutstandingBitmapIsNotHandedOutTwice)
+    {
+        Fixture f;
+        f.ExpectCreateBitmap(2);
+
+        auto lease1 = f.Acquire(10, 10);
+        auto lease2 = f.Acquire(10, 10);
+
+        Assert::IsFalse(IsSameInstance(lease1.Get(), lease2.Get()));
+        f.AssertStatistics(0, 2, 0, 0);
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_DifferentBucketsOrFormatsDoNotShareBitmaps)
+    {
+        Fixture f;
+        f.ExpectCreateBitmap(3);
+
+        f.Acquire(10, 10);
+        f.Acquire(100, 10);
+
+        f.Format.alphaMode = D2D1_ALPHA_MODE_IGNORE;
+        f.Acquire(10, 10);
+
+        f.AssertStatistics(0, 3, 0, BucketBytes(64, 64) * 2 + BucketBytes(128, 64));
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_LeastRecentlyUsedBitmapsAreEvictedWhenOverBudget)
+    {
+        Fixture f(BucketBytes(64, 64) * 2);
+        f.ExpectCreateBitmap(3);
+
+        ComPtr<ID2D1Bitmap1> bitmaps[3];
+
+        {
+            auto lease0 = f.Acquire(10, 10);
+            auto lease1 = f.Acquire(10, 10);
+            auto lease2 = f.Acquire(10, 10);
+
+            bitmaps[0] = lease0.Get();
+            bitmaps[1] = lease1.Get();
+            bitmaps[2] = lease2.Get();
+
+            // Leases are released in reverse order, so lease0 is returned last.
+        }
+
+        // The first bitmap returned (lease2) was least recently used.
+        f.AssertStatistics(0, 3, 1, BucketBytes(64, 64) * 2);
+
+        auto lease = f.Acquire(10, 10);
+        Assert::IsTrue(IsSameInstance(bitmaps[0].Get(), lease.Get()));
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_ZeroBudgetDisablesCaching)
+    {
+        Fixture f(0);
+        f.ExpectCreateBitmap(2);
+
+        f.Acquire(10, 10);
+        f.Acquire(10, 10);
+
+        f.AssertStatistics(0, 2, 2, 0);
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_ReducingMaximumSizeEvictsIdleBitmaps)
+    {
+        Fixture f;
+        f.ExpectCreateBitmap(2);
+
+        {
+            auto lease1 = f.Acquire(10, 10);
+            auto lease2 = f.Acquire(10, 10);
+        }
+
+        f.Cache->SetMaximumSize(BucketBytes(64, 64));
+
+        Assert::AreEqual(BucketBytes(64, 64), f.Cache->GetMaximumSize());
+        f.AssertStatistics(0, 2, 1, BucketBytes(64, 64));
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_Clear_ReleasesIdleBitmaps)
+    {
+        Fixture f;
+        f.ExpectCreateBitmap(2);
+
+        f.Acquire(10, 10);
+        f.Cache->Clear();
+
+        f.AssertStatistics(0, 1, 0, 0);
+
+        f.Acquire(10, 10);
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_DiscardedBitmapIsNotReturned)
+    {
+        Fixture f;
+        f.ExpectCreateBitmap(2);
+
+        {
+            auto lease = f.Acquire(10, 10);
+            lease.Discard();
+            Assert::IsNull(lease.Get());
+        }
+
+        f.AssertStatistics(0, 1, 0, 0);
+
+        f.Acquire(10, 10);
+    }
+
+    TEST_METHOD_EX(StagingBitmapCache_LeaseKeepsCacheAlive)
+    {
+        Fixture f;
+        f.ExpectCreateBitmap(1);
+
+        auto lease = f.Acquire(10, 10);
+
+        std::weak_ptr<StagingBitmapCache> weakCache = f.Cache;
+        f.Cache.reset();
+
+        Assert::IsFalse(weakCache.expired());
+
+        lease = StagingBitmapCache::Lease();
+
+        Assert::IsTrue(weakCache.expired());
+    }
+};
@@ -0,0 +1,357 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include "mocks/MockDWriteFactory.h"
+#include "mocks/MockDWriteTextLayout.h"
+#include "stubs/StubDWriteTextFormat.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::Text;
+
+TEST_CLASS(TextLayoutCacheUnitTests)
+{
+public:
+    struct Fixture
+    {
+        std::shared_ptr<TextLayoutCache> Cache;
+        ComPtr<MockDWriteFactory> Factory;
+        ComPtr<StubDWriteTextFormat> Format;
+
+        Fixture(uint32_t maximumEntryCount = 16, uint64_t maximumSizeInBytes = TextLayoutCache::DefaultMaximumSizeInBytes)
+            : Cache(std::make_shared<TextLayoutCache>(maximumEntryCount, maximumSizeInBytes))
+            , Factory(Make<MockDWriteFactory>())
+            , Format(MakeFormat())
+        {
+        }
+
+        static ComPtr<StubDWriteTextFormat> MakeFormat()
+        {
+            auto format = Make<StubDWriteTextFormat>(
+                L"Segoe UI",
+                nullptr,
+                DWRITE_FONT_WEIGHT_NORMAL,
+                DWRITE_FONT_STYLE_NORMAL,
+                DWRITE_FONT_STRETCH_NORMAL,
+                20.0f,
+                L"en-us");
+
+            // The stub doesn't initialize its properties.
+            DWRITE_TRIMMING trimming{ DWRITE_TRIMMING_GRANULARITY_NONE, 0, 0 };
+
+            ThrowIfFailed(format->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING));
+            ThrowIfFailed(format->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR));
+            ThrowIfFailed(format->SetWordWrapping(DWRITE_WORD_WRAPPING_WRAP));
+            ThrowIfFailed(format->SetReadingDirection(DWRITE_READING_DIRECTION_LEFT_TO_RIGHT));
+            ThrowIfFailed(format->SetFlowDirection(DWRITE_FLOW_DIRECTION_TOP_TO_BOTTOM));
+            ThrowIfFailed(format->SetIncrementalTabStop(80.0f));
+            ThrowIfFailed(format->SetTrimming(&trimming, nullptr));
+            ThrowIfFailed(format->SetLineSpacing(DWRITE_LINE_SPACING_METHOD_DEFAULT, 0.0f, 0.0f));
+            ThrowIfFailed(format->SetVerticalGlyphOrientation(DWRITE_VERTICAL_GLYPH_ORIENTATION_DEFAULT));
+            ThrowIfFailed(format->SetOpticalAlignment(DWRITE_OPTICAL_ALIGNMENT_NONE));
+            ThrowIfFailed(format->SetLastLineWrapping(TRUE));
+
+            return format;
+        }
+
+        void ExpectCreateTextLayout(int expectedCalls)
+        {
+            Factory->CreateTextLayoutMethod.SetExpectedCalls(expectedCalls,
+                [] (WCHAR const*, uint32_t, IDWriteTextFormat*, FLOAT, FLOAT, IDWriteTextLayout** layout)
+                {
+                    return MakeLayout().CopyTo(layout);
+                });
+        }
+
+        static ComPtr<MockDWriteTextLayout> MakeLayout()
+        {
+            auto layout = Make<MockDWriteTextLayout>();
+
+            layout->GetMetrics_BaseFormat_Method.AllowAnyCall(
+                [] (DWRITE_TEXT_METRICS* metrics)
+                {
+                    *metrics = DWRITE_TEXT_METRICS{};
+                    return S_OK;
+                });
+
+            return layout;
+        }
+
+        ComPtr<IDWriteTextLayout> Get(std::wstring const& text, float width = 100, float height = 50, IDWriteTextFormat* format = nullptr)
+        {
+            return Cache->GetOrCreateLayout(
+                Factory.Get(),
+                text.c_str(),
+                static_cast<uint32_t>(text.size()),
+                format ? format : Format.Get(),
+                width,
+                height);
+        }
+
+        void AssertStatistics(uint64_t hits, uint64_t misses, uint64_t evictions, uint32_t entries)
+        {
+            auto statistics = Cache->GetStatistics();
+
+            Assert::AreEqual(hits, statistics.HitCount);
+            Assert::AreEqual(misses, statistics.MissCount);
+            Assert::AreEqual(evictions, statistics.EvictionCount);
+            Assert::AreEqual(entries, statistics.EntryCount);
+        }
+    };
+
+    TEST_METHOD_EX(TextLayoutCache_IsDisabledByDefault)
+    {
+        Fixture f(TextLayoutCache::DefaultMaximumEntryCount);
+
+        f.ExpectCreateTextLayout(0);
+
+        Assert::IsNull(f.Get(L"hello").Get());
+
+        f.AssertStatistics(0, 0, 0, 0);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_IsAnyEnabled_TracksCachesWithANonZeroEntryCount)
+    {
+        Assert::IsFalse(TextLayoutCache::IsAnyEnabled());
+
+        {
+            TextLayoutCache cache;
+            Assert::IsFalse(TextLayoutCache::IsAnyEnabled());
+
+            cache.SetMaximumEntryCount(4);
+            Assert::IsTrue(TextLayoutCache::IsAnyEnabled());
+
+            cache.SetMaximumEntryCount(8);
+            Assert::IsTrue(TextLayoutCache::IsAnyEnabled());
+
+            cache.SetMaximumEntryCount(0);
+            Assert::IsFalse(TextLayoutCache::IsAnyEnabled());
+
+            cache.SetMaximumEntryCount(2);
+        }
+
+        Assert::IsFalse(TextLayoutCache::IsAnyEnabled());
+
+        {
+            TextLayoutCache cache1(4);
+            TextLayoutCache cache2(4);
+            Assert::IsTrue(TextLayoutCache::IsAnyEnabled());
+
+            cache1.SetMaximumEntryCount(0);
+            Assert::IsTrue(TextLayoutCache::IsAnyEnabled());
+        }
+
+        Assert::IsFalse(TextLayoutCache::IsAnyEnabled());
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_RepeatedRequestsReuseTheLayout)
+    {
+        Fixture f;
+
+        f.Factory->CreateTextLayoutMethod.SetExpectedCalls(1,
+            [&] (WCHAR const* text, uint32_t textLength, IDWriteTextFormat* format, FLOAT width, FLOAT height, IDWriteTextLayout** layout)
+            {
+                Assert::AreEqual(L"hello", std::wstring(text, textLength).c_str());
+                Assert::IsTrue(IsSameInstance(f.Format.Get(), format));
+                Assert::AreEqual(100.0f, width);
+                Assert::AreEqual(50.0f, height);
+                return Fixture::MakeLayout().CopyTo(layout);
+            });
+
+        auto first = f.Get(L"hello");
+        auto second = f.Get(L"hello");
+
+        Assert::IsNotNull(first.Get());
+        Assert::IsTrue(IsSameInstance(first.Get(), second.Get()));
+
+        f.AssertStatistics(1, 1, 0, 1);
+        Assert::AreEqual(TextLayoutCache::GetEstimatedSizeInBytes(5), f.Cache->GetStatistics().SizeInBytes);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_TextFormatAndSizeAreAllPartOfTheKey)
+    {
+        Fixture f;
+
+        auto otherFormat = Fixture::MakeFormat();
+
+        f.ExpectCreateTextLayout(5);
+
+        auto original = f.Get(L"hello");
+
+        Assert::IsFalse(IsSameInstance(original.Get(), f.Get(L"hellO").Get()));
+        Assert::IsFalse(IsSameInstance(original.Get(), f.Get(L"hello", 101, 50).Get()));
+        Assert::IsFalse(IsSameInstance(original.Get(), f.Get(L"hello", 100, 51).Get()));
+        Assert::IsFalse(IsSameInstance(original.Get(), f.Get(L"hello", 100, 50, otherFormat.Get()).Get()));
+
+        Assert::IsTrue(IsSameInstance(original.Get(), f.Get(L"hello").Get()));
+
+        f.AssertStatistics(1, 5, 0, 5);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_WhenFormatIsModifiedInPlace_LayoutIsRecreated)
+    {
+        Fixture f;
+
+        f.ExpectCreateTextLayout(3);
+
+        auto original = f.Get(L"hello");
+
+        ThrowIfFailed(f.Format->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER));
+        auto centered = f.Get(L"hello");
+        Assert::IsFalse(IsSameInstance(original.Get(), centered.Get()));
+        Assert::IsTrue(IsSameInstance(centered.Get(), f.Get(L"hello").Get()));
+
+        ThrowIfFailed(f.Format->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP));
+        Assert::IsFalse(IsSameInstance(centered.Get(), f.Get(L"hello").Get()));
+
+        f.AssertStatistics(1, 3, 0, 3);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_WhenEntryCountIsExceeded_LeastRecentlyUsedIsEvicted)
+    {
+        Fixture f(2);
+
+        f.ExpectCreateTextLayout(4);
+
+        auto a = f.Get(L"a");
+        auto b = f.Get(L"b");
+
+        f.Get(L"a");            // a is now the most recently used
+        f.Get(L"c");            // evicts b
+
+        f.AssertStatistics(1, 3, 1, 2);
+
+        Assert::IsTrue(IsSameInstance(a.Get(), f.Get(L"a").Get()));
+        Assert::IsFalse(IsSameInstance(b.Get(), f.Get(L"b").Get()));
+
+        f.AssertStatistics(2, 4, 2, 2);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_WhenSizeIsExceeded_LeastRecentlyUsedIsEvicted)
+    {
+        Fixture f(16, TextLayoutCache::GetEstimatedSizeInBytes(1) * 2);
+
+        f.ExpectCreateTextLayout(3);
+
+        f.Get(L"a");
+        f.Get(L"b");
+        f.Get(L"c");
+
+        f.AssertStatistics(0, 3, 1, 2);
+        Assert::AreEqual(TextLayoutCache::GetEstimatedSizeInBytes(1) * 2, f.Cache->GetStatistics().SizeInBytes);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_TextThatCanNeverFitIsNotCached)
+    {
+        Fixture f(16, TextLayoutCache::GetEstimatedSizeInBytes(4));
+
+        f.ExpectCreateTextLayout(1);
+
+        f.Get(L"abcd");
+
+        Assert::IsNull(f.Get(L"abcde").Get());
+
+        f.AssertStatistics(0, 1, 0, 1);
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_ReducingTheLimitsEvictsEntries)
+    {
+        Fixture f;
+
+        f.ExpectCreateTextLayout(3);
+
+        f.Get(L"a");
+        f.Get(L"b");
+        f.Get(L"c");
+
+        f.Cache->SetMaximumEntryCount(1);
+        f.AssertStatistics(0, 3, 2, 1);
+
+        f.Cache->SetMaximumEntryCount(0);
+        f.AssertStatistics(0, 3, 3, 0);
+
+        Assert::IsNull(f.Get(L"a").Get());
+    }
+
+    TEST_METHOD_EX(TextLayoutCache_Clear_ReleasesAllLayouts)
+    {
+        Fixture f;
+
+        f.ExpectCreateTextLayout(2);
+
+        auto layout = f.Get(L"hello");
+
+        f.Cache->Clear();
+
+        Assert::AreEqual<uint64_t>(0, f.Cache->GetStatistics().SizeInBytes);
+        f.AssertStatistics(0, 1, 0, 0);
+
+        layout->AddRef();
+        Assert::AreEqual(1ul, layout->Release());
+
+        Assert::IsFalse(IsSameInstance(layout.Get(), f.Get(L"hello").Get()));
+    }
+
+    BENCHMARK_METHOD(TextLayoutCache_LookupBenchmark)
+    {
+        //
+        // Compares creating a layout for every draw, as DrawText does, with
+        // looking it up in the cache.  The stub factory makes layout creation
+        // unrealistically cheap, so this measures the overhead of a cache
+        // lookup rather than the savings from skipping DWrite layout.
+        //
+
+        const int labelCount = 64;
+        const int frameCount = 200;
+
+        std::vector<std::wstring> labels;
+        for (int i = 0; i < labelCount; ++i)
+            labels.push_back(L"Label number " + std::to_wstring(i));
+
+        Fixture f(labelCount);
+
+        f.Factory->CreateTextLayoutMethod.AllowAnyCall(
+            [] (WCHAR const*, uint32_t, IDWriteTextFormat*, FLOAT, FLOAT, IDWriteTextLayout** layout)
+            {
+                return Fixture::MakeLayout().CopyTo(layout);
+            });
+
+        auto time = [&] (std::function<void(std::wstring const&)> draw)
+        {
+            return TimeMilliseconds([&]
+            {
+                for (int frame = 0; frame < frameCount; ++frame)
+                {
+                    for (auto& label : labels)
+                        draw(label);
+                }
+            });
+        };
+
+        auto uncachedTime = time(
+            [&] (std::wstring const& label)
+            {
+                ComPtr<IDWriteTextLayout> layout;
+                ThrowIfFailed(f.Factory->CreateTextLayout(label.c_str(), static_cast<uint32_t>(label.size()), f.Format.Get(), 100, 50, &layout));
+
+                DWRITE_TEXT_METRICS metrics;
+                ThrowIfFailed(layout->GetMetrics(&metrics));
+            });
+
+        auto cachedTime = time(
+            [&] (std::wstring const& label)
+            {
+                Assert::IsNotNull(f.Get(label).Get());
+            });
+
+        f.AssertStatistics(labelCount * (frameCount - 1), labelCount, 0, labelCount);
+
+        WriteBenchmarkResult(
+            L"%d labels x %d frames: uncached %.2fms, cached %.2fms\n",
+            labelCount,
+            frameCount,
+            uncachedTime,
+            cachedTime);
+    }
+};
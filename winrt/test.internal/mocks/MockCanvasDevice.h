@@ -42,7 +42,7 @@ namespace canvas
         CALL_COUNTER_WITH_MOCK(CreateBitmapFromBytesMethod, ComPtr<ID2D1Bitmap1>(uint8_t*, uint32_t, int32_t, int32_t, float, DirectXPixelFormat, CanvasAlphaMode));
         CALL_COUNTER_WITH_MOCK(CreateBitmapFromSurfaceMethod, ComPtr<ID2D1Bitmap1>(IDirect3DSurface*, float, CanvasAlphaMode));
         CALL_COUNTER_WITH_MOCK(CreateRenderTargetBitmapMethod, ComPtr<ID2D1Bitmap1>(float, float, float, DirectXPixelFormat, CanvasAlphaMode));
-        CALL_COUNTER_WITH_MOCK(CreateSwapChainForCompositionMethod, ComPtr<IDXGISwapChain1>(int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode));
+        CALL_COUNTER_WITH_MOCK(CreateSwapChainForCompositionMethod, ComPtr<IDXGISwapChain1>(int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool));
         CALL_COUNTER_WITH_MOCK(CreateSwapChainForCoreWindowMethod, ComPtr<IDXGISwapChain1>(ICoreWindow*, int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode));
         CALL_COUNTER_WITH_MOCK(CreateCommandListMethod, ComPtr<ID2D1CommandList>());
 
@@ -53,6 +53,12 @@ namespace canvas
         
         CALL_COUNTER_WITH_MOCK(GetResourceCreationDeviceContextMethod, DeviceContextLease());
 
+        CALL_COUNTER_WITH_MOCK(GetStagingBitmapCacheMethod, std::shared_ptr<StagingBitmapCache>());
+
+        CALL_COUNTER_WITH_MOCK(GetTextLayoutCacheMethod, std::shared_ptr<TextLayoutCache>());
+
+        CALL_COUNTER_WITH_MOCK(GetGeometryRealizationCacheMethod, std::shared_ptr<GeometryRealizationCache>());
+
         CALL_COUNTER_WITH_MOCK(GetPrimaryDisplayOutputMethod, ComPtr<IDXGIOutput>());
 
         CALL_COUNTER_WITH_MOCK(LeaseHistogramEffectMethod, HistogramAndAtlasEffects(ID2D1DeviceContext*));
@@ -129,6 +135,108 @@ namespace canvas
             return E_NOTIMPL;
         }
 
+        IFACEMETHODIMP get_MaximumDeviceContextPoolSize(int32_t* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumDeviceContextPoolSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumDeviceContextPoolSize(int32_t value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumDeviceContextPoolSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_DeviceContextPoolStatistics(CanvasDeviceContextPoolStatistics* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_DeviceContextPoolStatistics");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumStagingBitmapCacheSize(UINT64* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumStagingBitmapCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumStagingBitmapCacheSize(UINT64 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumStagingBitmapCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_StagingBitmapCacheStatistics(CanvasStagingBitmapCacheStatistics* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_StagingBitmapCacheStatistics");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumTextLayoutCacheEntryCount(UINT32* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumTextLayoutCacheEntryCount");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumTextLayoutCacheEntryCount(UINT32 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumTextLayoutCacheEntryCount");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumTextLayoutCacheSize(UINT64* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumTextLayoutCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumTextLayoutCacheSize(UINT64 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumTextLayoutCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_TextLayoutCacheStatistics(CanvasTextLayoutCacheStatistics* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_TextLayoutCacheStatistics");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumGeometryRealizationCacheSize(UINT64* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumGeometryRealizationCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumGeometryRealizationCacheSize(UINT64 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumGeometryRealizationCacheSize");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_GeometryRealizationCacheStatistics(CanvasGeometryRealizationCacheStatistics* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_GeometryRealizationCacheStatistics");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_MaximumGradientStopCollectionCacheEntryCount(UINT32* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_MaximumGradientStopCollectionCacheEntryCount");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP put_MaximumGradientStopCollectionCacheEntryCount(UINT32 value) override
+        {
+            Assert::Fail(L"Unexpected call to put_MaximumGradientStopCollectionCacheEntryCount");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHODIMP get_GradientStopCollectionCacheStatistics(CanvasGradientStopCollectionCacheStatistics* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_GradientStopCollectionCacheStatistics");
+            return E_NOTIMPL;
+        }
+
         IFACEMETHODIMP add_DeviceLost(
             DeviceLostHandlerType* value,
             EventRegistrationToken* token)
@@ -340,9 +448,10 @@ namespace canvas
             int32_t heightInPixels,
             DirectXPixelFormat format,
             int32_t bufferCount,
-            CanvasAlphaMode alphaMode) override
+            CanvasAlphaMode alphaMode,
+            bool frameLatencyWaitable) override
         {
-            return CreateSwapChainForCompositionMethod.WasCalled(widthInPixels, heightInPixels, format, bufferCount, alphaMode);
+            return CreateSwapChainForCompositionMethod.WasCalled(widthInPixels, heightInPixels, format, bufferCount, alphaMode, frameLatencyWaitable);
         }
 
         virtual ComPtr<IDXGISwapChain1> CreateSwapChainForCoreWindow(
@@ -385,6 +494,21 @@ namespace canvas
             return GetResourceCreationDeviceContextMethod.WasCalled();
         }
 
+        virtual std::shared_ptr<StagingBitmapCache> GetStagingBitmapCache() override
+        {
+            return GetStagingBitmapCacheMethod.WasCalled();
+        }
+
+        virtual std::shared_ptr<TextLayoutCache> GetTextLayoutCache() override
+        {
+            return GetTextLayoutCacheMethod.WasCalled();
+        }
+
+        virtual std::shared_ptr<GeometryRealizationCache> GetGeometryRealizationCache() override
+        {
+            return GetGeometryRealizationCacheMethod.WasCalled();
+        }
+
         virtual ComPtr<IDXGIOutput> GetPrimaryDisplayOutput() override
         {
             return GetPrimaryDisplayOutputMethod.WasCalled();
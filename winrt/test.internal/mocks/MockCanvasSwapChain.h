@@ -129,6 +129,30 @@ namespace canvas
             return E_NOTIMPL;
         }
 
+        IFACEMETHOD(PresentWithDirtyRects)(int32_t syncInterval, uint32_t dirtyRectCount, Rect* dirtyRects) override
+        {
+            Assert::Fail(L"Unexpected call to PresentWithDirtyRects");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHOD(PresentWithDirtyRectsAndScroll)(int32_t syncInterval, uint32_t dirtyRectCount, Rect* dirtyRects, Rect scrollRect, Vector2 scrollOffset) override
+        {
+            Assert::Fail(L"Unexpected call to PresentWithDirtyRectsAndScroll");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHOD(get_TrackDirtyRegions)(boolean* value) override
+        {
+            Assert::Fail(L"Unexpected call to get_TrackDirtyRegions");
+            return E_NOTIMPL;
+        }
+
+        IFACEMETHOD(put_TrackDirtyRegions)(boolean value) override
+        {
+            Assert::Fail(L"Unexpected call to put_TrackDirtyRegions");
+            return E_NOTIMPL;
+        }
+
         IFACEMETHOD(ResizeBuffersWithSize)(
             Size newSize) override
         {
@@ -16,6 +16,8 @@ namespace canvas
         CALL_COUNTER_WITH_MOCK(GetPixelFormatMethod, D2D1_PIXEL_FORMAT());
         CALL_COUNTER_WITH_MOCK(GetDpiMethod, HRESULT(float*, float*));
         CALL_COUNTER_WITH_MOCK(CopyFromBitmapMethod, HRESULT(D2D1_POINT_2U const*, ID2D1Bitmap*, D2D1_RECT_U const*));
+        CALL_COUNTER_WITH_MOCK(MapMethod, HRESULT(D2D1_MAP_OPTIONS, D2D1_MAPPED_RECT*));
+        CALL_COUNTER_WITH_MOCK(UnmapMethod, HRESULT());
 
         //
         // ID2D1Bitmap1
@@ -50,14 +52,12 @@ namespace canvas
             _Out_ D2D1_MAPPED_RECT *mappedRect
             )
         {
-            Assert::Fail(L"Unexpected call to Map");
-            return E_NOTIMPL;
+            return MapMethod.WasCalled(options, mappedRect);
         }
 
         STDMETHOD(Unmap)()
         {
-            Assert::Fail(L"Unexpected call to Unmap");
-            return E_NOTIMPL;
+            return UnmapMethod.WasCalled();
         }
 
         //
@@ -32,6 +32,27 @@
     }                                                                           \
     void METHOD_NAME##_()
 
+//
+// BENCHMARK_METHOD is TEST_METHOD_EX for tests that time a workload rather
+// than check behavior.  These are all in the "Benchmark" category and are
+// ignored unless the tests are built with WIN2D_RUN_BENCHMARKS defined, so
+// they don't slow down every test run.  Use TimeMilliseconds and
+// WriteBenchmarkResult (see utils/Helpers.h) to report the results.
+//
+
+#ifdef WIN2D_RUN_BENCHMARKS
+#define BENCHMARK_IGNORE()
+#else
+#define BENCHMARK_IGNORE() TEST_IGNORE()
+#endif
+
+#define BENCHMARK_METHOD(METHOD_NAME)                                           \
+    BEGIN_TEST_METHOD_ATTRIBUTE(METHOD_NAME)                                    \
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")                    \
+        BENCHMARK_IGNORE()                                                      \
+    END_TEST_METHOD_ATTRIBUTE()                                                 \
+    TEST_METHOD_EX(METHOD_NAME)
+
 //
 // CALL_COUNTER defines a member variable that can be used to count how many
 // times a method is called. eg:
@@ -11,6 +11,7 @@
 
 // Standard C++
 #include <array>
+#include <chrono>
 
 // UnitTest
 #include <CppUnitTest.h>
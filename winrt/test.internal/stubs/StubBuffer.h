@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+namespace canvas
+{
+    // A fixed capacity in-memory IBuffer, for testing methods that write to buffers.
+    class StubBuffer : public RuntimeClass<
+        RuntimeClassFlags<WinRtClassicComMix>,
+        ABI::Windows::Storage::Streams::IBuffer,
+        ::Windows::Storage::Streams::IBufferByteAccess>
+    {
+    public:
+        std::vector<uint8_t> Data;
+        uint32_t Length;
+
+        StubBuffer(uint32_t capacity)
+            : Data(capacity)
+            , Length(0)
+        {
+        }
+
+        IFACEMETHODIMP get_Capacity(UINT32* value) override
+        {
+            *value = static_cast<UINT32>(Data.size());
+            return S_OK;
+        }
+
+        IFACEMETHODIMP get_Length(UINT32* value) override
+        {
+            *value = Length;
+            return S_OK;
+        }
+
+        IFACEMETHODIMP put_Length(UINT32 value) override
+        {
+            if (value > Data.size())
+                return E_INVALIDARG;
+
+            Length = value;
+            return S_OK;
+        }
+
+        IFACEMETHODIMP Buffer(byte** value) override
+        {
+            *value = Data.data();
+            return S_OK;
+        }
+    };
+}
@@ -24,6 +24,9 @@ namespace canvas
         ComPtr<MockD3D11Device> m_d3dDevice;
         ComPtr<MockEventSource<DeviceLostHandlerType>> m_deviceLostEventSource;
         DeviceContextPool m_deviceContextPool;
+        std::shared_ptr<StagingBitmapCache> m_stagingBitmapCache;
+        std::shared_ptr<TextLayoutCache> m_textLayoutCache;
+        std::shared_ptr<GeometryRealizationCache> m_geometryRealizationCache;
         
     public:
         StubCanvasDevice(ComPtr<ID2D1Device1> device = Make<StubD2DDevice>(), ComPtr<MockD3D11Device> d3dDevice = nullptr)
@@ -31,6 +34,9 @@ namespace canvas
             , m_d3dDevice(d3dDevice)
             , m_deviceLostEventSource(Make<MockEventSource<DeviceLostHandlerType>>(L"DeviceLost"))
             , m_deviceContextPool(m_d2DDevice.Get())
+            , m_stagingBitmapCache(std::make_shared<StagingBitmapCache>())
+            , m_textLayoutCache(std::make_shared<TextLayoutCache>())
+            , m_geometryRealizationCache(std::make_shared<GeometryRealizationCache>())
         {
             GetInterfaceMethod.AllowAnyCall();
             
@@ -60,6 +66,24 @@ namespace canvas
                     return m_deviceContextPool.TakeLease();
                 });
 
+            GetStagingBitmapCacheMethod.AllowAnyCall(
+                [=]
+                {
+                    return m_stagingBitmapCache;
+                });
+
+            GetTextLayoutCacheMethod.AllowAnyCall(
+                [=]
+                {
+                    return m_textLayoutCache;
+                });
+
+            GetGeometryRealizationCacheMethod.AllowAnyCall(
+                [=]
+                {
+                    return m_geometryRealizationCache;
+                });
+
             GetPrimaryDisplayOutputMethod.AllowAnyCall(
                 [=]
                 {
@@ -1829,6 +1829,7 @@ namespace Microsoft
             TO_STRING_AS_INT(DirectXPixelFormat);
             TO_STRING_AS_INT(DXGI_FORMAT);
             TO_STRING_AS_INT(D2D1_BITMAP_OPTIONS);
+            TO_STRING_AS_INT(D2D1_MAP_OPTIONS);
             TO_STRING_AS_INT(D2D1_ALPHA_MODE);
             TO_STRING_AS_INT(D2D1_DEVICE_CONTEXT_OPTIONS);
         }
@@ -2080,6 +2081,28 @@ inline bool operator==(D2D1_POINT_2U const& a, D2D1_POINT_2U const& b)
     }
 
 
+template<typename FN>
+inline double TimeMilliseconds(FN&& fn)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+
+inline void WriteBenchmarkResult(wchar_t const* format, ...)
+{
+    wchar_t message[256];
+
+    va_list args;
+    va_start(args, format);
+    StringCchVPrintf(message, _countof(message), format, args);
+    va_end(args);
+
+    Logger::WriteMessage(message);
+}
+
+
 template<typename T>
 inline void ExpectHResultException(HRESULT expectedHR, T&& lambda)
 {
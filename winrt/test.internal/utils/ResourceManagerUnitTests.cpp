@@ -120,6 +120,58 @@ namespace
             return S_OK;
         }
     };
+
+
+    class __declspec(uuid("0F1E7C52-5C8B-4F42-9A8E-2B7C1D6A4E93"))
+    IDummyFlaggedResource : public IUnknown
+    {
+    public:
+        virtual bool IsFlagged() = 0;
+    };
+
+
+    class DummyFlaggedResource : public RuntimeClass<RuntimeClassFlags<ClassicCom>, IDummyResource, IDummyFlaggedResource>
+    {
+        bool m_isFlagged;
+
+    public:
+        DummyFlaggedResource(bool isFlagged)
+            : m_isFlagged(isFlagged)
+        {
+        }
+
+        virtual bool IsFlagged() override
+        {
+            return m_isFlagged;
+        }
+    };
+
+
+    bool IsFlaggedResource(IDummyFlaggedResource* resource)
+    {
+        return resource->IsFlagged();
+    }
+
+
+    class FlaggedDummyWrapper : RESOURCE_WRAPPER_RUNTIME_CLASS(
+        IDummyFlaggedResource,
+        FlaggedDummyWrapper,
+        IDummyWrapper)
+    {
+        InspectableClass(L"FlaggedDummyWrapper", BaseTrust);
+
+    public:
+        FlaggedDummyWrapper(IDummyFlaggedResource* resource)
+            : ResourceWrapper(resource)
+        {
+        }
+
+        // Distinguishes this from DummyWrapper, whose ids are always positive.
+        virtual int GetId() override
+        {
+            return -1;
+        }
+    };
 }
 
 
@@ -378,6 +430,142 @@ TEST_CLASS(ResourceManagerUnitTests)
         ValidateStoredErrorState(E_INVALIDARG, Strings::ResourceManagerWrongDpi);
     }
 
+    TEST_METHOD_EX(ResourceManager_GetOrCreate_WhenProbeResultsAreCached_TesterFunctionsStillRunPerInstance)
+    {
+        // Both types accept the same kind of resource, but the first only wants flagged instances.
+        auto tryCreateFlagged = ResourceManager::TryCreate<IDummyFlaggedResource, FlaggedDummyWrapper, ResourceManager::MakeWrapper, IsFlaggedResource>;
+        ResourceManager::RegisterType(tryCreateFlagged, ResourceManager::Probe<IDummyFlaggedResource>);
+        auto restoreFlaggedType = MakeScopeWarden([&] { ResourceManager::UnregisterType(tryCreateFlagged); });
+
+        auto tryCreateDummyResource = ResourceManager::TryCreate<IDummyResource, DummyWrapper, ResourceManager::MakeWrapper>;
+        ResourceManager::RegisterType(tryCreateDummyResource, ResourceManager::Probe<IDummyResource>);
+        auto restoreDummyType = MakeScopeWarden([&] { ResourceManager::UnregisterType(tryCreateDummyResource); });
+
+        for (int i = 0; i < 4; ++i)
+        {
+            bool isFlagged = (i % 2) == 0;
+
+            auto resource = Make<DummyFlaggedResource>(isFlagged);
+            auto wrapper = ResourceManager::GetOrCreate<IDummyWrapper>(As<IDummyResource>(resource).Get());
+
+            if (isFlagged)
+                Assert::AreEqual(-1, wrapper->GetId());
+            else
+                Assert::IsTrue(wrapper->GetId() > 0);
+        }
+    }
+
+    TEST_METHOD_EX(ResourceManager_GetOrCreate_ConcurrentCallsForTheSameResources_ReturnTheSameWrappers)
+    {
+        auto tryCreateDummyResource = ResourceManager::TryCreate<IDummyResource, DummyWrapper, ResourceManager::MakeWrapper>;
+        ResourceManager::RegisterType(tryCreateDummyResource, ResourceManager::Probe<IDummyResource>);
+        auto restoreTypeTable = MakeScopeWarden([&] { ResourceManager::UnregisterType(tryCreateDummyResource); });
+
+        int const resourceCount = 500;
+        int const threadCount = 8;
+
+        std::vector<ComPtr<IDummyResource>> resources;
+
+        for (int i = 0; i < resourceCount; ++i)
+        {
+            resources.push_back(Make<DummyResource>());
+        }
+
+        std::vector<std::vector<ComPtr<IDummyWrapper>>> wrappersPerThread(threadCount);
+        std::vector<std::future<void>> threads;
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.push_back(std::async(std::launch::async, [&, t]
+            {
+                for (auto& resource : resources)
+                {
+                    wrappersPerThread[t].push_back(ResourceManager::GetOrCreate<IDummyWrapper>(resource.Get()));
+                }
+            }));
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.get();
+        }
+
+        for (int i = 0; i < resourceCount; ++i)
+        {
+            for (int t = 1; t < threadCount; ++t)
+            {
+                Assert::AreEqual(wrappersPerThread[0][i].Get(), wrappersPerThread[t][i].Get());
+            }
+        }
+    }
+
+    //
+    // Measures how quickly many threads can map between native resources and
+    // their existing wrappers.
+    //
+    BENCHMARK_METHOD(ResourceManager_ConcurrentWrapAndUnwrapBenchmark)
+    {
+        auto tryCreateDummyResource = ResourceManager::TryCreate<IDummyResource, DummyWrapper, ResourceManager::MakeWrapper>;
+        ResourceManager::RegisterType(tryCreateDummyResource, ResourceManager::Probe<IDummyResource>);
+        auto restoreTypeTable = MakeScopeWarden([&] { ResourceManager::UnregisterType(tryCreateDummyResource); });
+
+        int const resourceCount = 4096;
+        int const lookupsPerThread = 100000;
+        auto const threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+
+        std::vector<ComPtr<IDummyResource>> resources;
+        std::vector<ComPtr<IDummyWrapper>> wrappers;
+
+        for (int i = 0; i < resourceCount; ++i)
+        {
+            resources.push_back(Make<DummyResource>());
+            wrappers.push_back(ResourceManager::GetOrCreate<IDummyWrapper>(resources.back().Get()));
+        }
+
+        auto elapsed = TimeMilliseconds([&]
+        {
+            std::vector<std::future<void>> threads;
+
+            for (uint32_t t = 0; t < threadCount; ++t)
+            {
+                threads.push_back(std::async(std::launch::async, [&, t]
+                {
+                    for (int i = 0; i < lookupsPerThread; ++i)
+                    {
+                        auto index = (i * 7919 + t * 131) % resourceCount;
+
+                        // Wrap
+                        auto wrapper = ResourceManager::GetOrCreate<IDummyWrapper>(resources[index].Get());
+
+                        if (wrapper != wrappers[index])
+                            Assert::Fail(L"Wrong wrapper returned");
+
+                        // Unwrap
+                        ComPtr<IDummyResource> resource;
+                        ThrowIfFailed(As<ICanvasResourceWrapperNative>(wrapper)->GetNativeResource(nullptr, 0, IID_PPV_ARGS(&resource)));
+
+                        if (resource != resources[index])
+                            Assert::Fail(L"Wrong resource returned");
+                    }
+                }));
+            }
+
+            for (auto& thread : threads)
+            {
+                thread.get();
+            }
+        });
+
+        auto totalLookups = static_cast<double>(threadCount) * lookupsPerThread;
+
+        WriteBenchmarkResult(
+            L"%u threads, %.0f wrap/unwrap pairs in %.1fms (%.0f ns per pair)\n",
+            threadCount,
+            totalLookups,
+            elapsed,
+            elapsed * 1000000.0 / totalLookups);
+    }
+
     TEST_METHOD_EX(ResourceManager_GetOrCreate_UnknownType_Fails)
     {
         // For this test we do NOT register IDummyResource via ResourceManager::RegisterType.
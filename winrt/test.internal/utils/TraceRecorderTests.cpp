@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+#include "../lib/utils/TraceRecorder.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+TEST_CLASS(TraceRecorderTests)
+{
+    static size_t CountOccurrences(std::wstring const& json, wchar_t const* value)
+    {
+        size_t count = 0;
+
+        for (auto position = json.find(value); position != std::wstring::npos; position = json.find(value, position + 1))
+            ++count;
+
+        return count;
+    }
+
+    TEST_METHOD_EX(TraceRecorder_WhenNotStarted_EventsAreIgnored)
+    {
+        TraceRecorder recorder;
+
+        recorder.WriteEvent("Ignored", TracePhase::Begin);
+
+        Assert::AreEqual<size_t>(0, CountOccurrences(recorder.GetChromeTraceJson(), L"Ignored"));
+    }
+
+    TEST_METHOD_EX(TraceRecorder_RecordsBeginAndEndEventsAsChromeTraceJson)
+    {
+        TraceRecorder recorder;
+
+        recorder.Start();
+        Assert::IsTrue(recorder.IsRecording());
+
+        recorder.WriteEvent("Outer", TracePhase::Begin);
+        recorder.WriteEvent("Mark", TracePhase::Instant);
+        recorder.WriteEvent("Outer", TracePhase::End);
+
+        recorder.Stop();
+        Assert::IsFalse(recorder.IsRecording());
+
+        recorder.WriteEvent("AfterStop", TracePhase::Begin);
+
+        auto json = recorder.GetChromeTraceJson();
+
+        Assert::AreEqual<size_t>(0, json.find(L"{\"traceEvents\":["));
+        Assert::AreEqual<size_t>(1, CountOccurrences(json, L"\"name\":\"Outer\",\"ph\":\"B\""));
+        Assert::AreEqual<size_t>(1, CountOccurrences(json, L"\"name\":\"Outer\",\"ph\":\"E\""));
+        Assert::AreEqual<size_t>(1, CountOccurrences(json, L"\"name\":\"Mark\",\"ph\":\"i\",\"s\":\"t\""));
+        Assert::AreEqual<size_t>(0, CountOccurrences(json, L"AfterStop"));
+
+        // Events are written in the order they happened.
+        Assert::IsTrue(json.find(L"\"ph\":\"B\"") < json.find(L"\"ph\":\"E\""));
+    }
+
+    TEST_METHOD_EX(TraceRecorder_EachThreadHasItsOwnBuffer)
+    {
+        TraceRecorder recorder(4);
+
+        recorder.Start();
+
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([&]
+            {
+                for (int j = 0; j < 4; ++j)
+                    recorder.WriteEvent("Work", TracePhase::Instant);
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        auto json = recorder.GetChromeTraceJson();
+
+        Assert::AreEqual<size_t>(16, CountOccurrences(json, L"\"name\":\"Work\""));
+        Assert::AreEqual(0u, recorder.GetDroppedEventCount());
+    }
+
+    TEST_METHOD_EX(TraceRecorder_WhenBufferIsFull_EventsAreDroppedAndCounted)
+    {
+        TraceRecorder recorder(3);
+
+        recorder.Start();
+
+        for (int i = 0; i < 5; ++i)
+            recorder.WriteEvent("Event", TracePhase::Instant);
+
+        auto json = recorder.GetChromeTraceJson();
+
+        Assert::AreEqual<size_t>(3, CountOccurrences(json, L"\"name\":\"Event\""));
+        Assert::AreEqual(2u, recorder.GetDroppedEventCount());
+        Assert::AreEqual<size_t>(1, CountOccurrences(json, L"\"droppedEvents\":\"2\""));
+    }
+
+    TEST_METHOD_EX(TraceRecorder_Start_DiscardsPreviousEvents)
+    {
+        TraceRecorder recorder(3);
+
+        recorder.Start();
+        for (int i = 0; i < 5; ++i)
+            recorder.WriteEvent("First", TracePhase::Instant);
+        recorder.Stop();
+
+        recorder.Start();
+        recorder.WriteEvent("Second", TracePhase::Instant);
+
+        auto json = recorder.GetChromeTraceJson();
+
+        Assert::AreEqual<size_t>(0, CountOccurrences(json, L"First"));
+        Assert::AreEqual<size_t>(1, CountOccurrences(json, L"Second"));
+        Assert::AreEqual(0u, recorder.GetDroppedEventCount());
+    }
+
+    TEST_METHOD_EX(TraceRecorder_ReceivesEventsWrittenWithEtwMacros)
+    {
+        TraceRecorder recorder;
+        recorder.Start();
+
+        auto previousSink = Tracing::SetSink(&recorder);
+        auto restoreSink = MakeScopeWarden([&] { Tracing::SetSink(previousSink); });
+
+        EventWrite_CanvasSwapChain_Present_Start();
+        EventWrite_CanvasSwapChain_Present_Stop();
+        EventWrite_CanvasAnimatedControl_Update_Start(true, false);
+        EventWrite_CanvasAnimatedControl_Update_Stop(true);
+
+        auto json = recorder.GetChromeTraceJson();
+
+        Assert::AreEqual<size_t>(2, CountOccurrences(json, L"\"name\":\"CanvasSwapChain_Present\""));
+        Assert::AreEqual<size_t>(2, CountOccurrences(json, L"\"name\":\"CanvasAnimatedControl_Update\""));
+    }
+
+    TEST_METHOD_EX(TraceRecorder_ClearSink_OnlyRemovesTheGivenSink)
+    {
+        TraceRecorder first;
+        TraceRecorder second;
+
+        auto previousSink = Tracing::SetSink(&first);
+        auto restoreSink = MakeScopeWarden([&] { Tracing::SetSink(previousSink); });
+
+        Tracing::ClearSink(&second);
+        Assert::IsTrue(Tracing::GetSink() == &first);
+
+        Tracing::ClearSink(&first);
+        Assert::IsNull(Tracing::GetSink());
+    }
+};
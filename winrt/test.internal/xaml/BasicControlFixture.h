@@ -110,7 +110,7 @@ inline void BasicControlFixture<CanvasControlTraits>::PrepareAdapterForRendering
 inline void BasicControlFixture<CanvasAnimatedControlTraits>::PrepareAdapterForRenderingResource()
 {
     Adapter->CreateCanvasSwapChainMethod.AllowAnyCall(
-        [=](ICanvasDevice*, float, float, float, CanvasAlphaMode)
+        [=](ICanvasDevice*, float, float, float, CanvasAlphaMode, uint32_t)
         {
             auto mockSwapChain = Make<MockCanvasSwapChain>();
             mockSwapChain->CreateDrawingSessionMethod.AllowAnyCall(
@@ -208,7 +208,7 @@ struct ControlFixture<CanvasAnimatedControlTraits> : public Animated_BasicContro
     void ExpectOneCreateSwapChain()
     {
         Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(1,
-            [](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode)
+            [](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t)
             {
                 return CreateTestSwapChain(device);
             });
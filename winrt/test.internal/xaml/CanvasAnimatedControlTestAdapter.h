@@ -92,7 +92,7 @@ class CanvasAnimatedControlTestAdapter : public BaseControlTestAdapter<CanvasAni
     ComPtr<MockShape> m_shape;
 
 public:
-    CALL_COUNTER_WITH_MOCK(CreateCanvasSwapChainMethod, ComPtr<CanvasSwapChain>(ICanvasDevice*, float, float, float, CanvasAlphaMode));
+    CALL_COUNTER_WITH_MOCK(CreateCanvasSwapChainMethod, ComPtr<CanvasSwapChain>(ICanvasDevice*, float, float, float, CanvasAlphaMode, uint32_t));
     ComPtr<StubCanvasDevice> InitialDevice;
 
     CanvasAnimatedControlTestAdapter(StubCanvasDevice* initialDevice = nullptr)
@@ -114,9 +114,10 @@ public:
         float width,
         float height,
         float dpi,
-        CanvasAlphaMode alphaMode) override
+        CanvasAlphaMode alphaMode,
+        uint32_t maximumFrameLatency) override
     {
-        return CreateCanvasSwapChainMethod.WasCalled(device, width, height, dpi, alphaMode);
+        return CreateCanvasSwapChainMethod.WasCalled(device, width, height, dpi, alphaMode, maximumFrameLatency);
     }
 
     virtual ComPtr<CanvasSwapChainPanel> CreateCanvasSwapChainPanel() override
@@ -219,6 +220,15 @@ public:
         if (m_sleepFn) m_sleepFn(timeInMs);
     }
 
+    std::function<bool(CanvasSwapChain*, DWORD)> m_waitForFrameLatencyFn;
+    virtual bool WaitForFrameLatency(CanvasSwapChain* swapChain, DWORD timeoutInMs) override
+    {
+        if (m_waitForFrameLatencyFn)
+            return m_waitForFrameLatencyFn(swapChain, timeoutInMs);
+        else
+            return true;
+    }
+
     void SetTime(int64_t time)
     {
         m_performanceCounter = time;
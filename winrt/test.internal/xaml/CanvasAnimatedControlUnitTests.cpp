@@ -60,11 +60,11 @@ public:
             });
 
         Adapter->CreateCanvasSwapChainMethod.AllowAnyCall(
-            [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode)
+            [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t)
             {
                 StubCanvasDevice* stubDevice = static_cast<StubCanvasDevice*>(device); // Ensured by test construction
 
-                stubDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+                stubDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
                 {
                     return m_dxgiSwapChain;
                 });
@@ -320,7 +320,7 @@ TEST_CLASS(CanvasAnimatedControlTests)
         f.Adapter->DoChanged();
         
         f.Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(1, 
-            [](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode)
+            [](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t)
             {
                 Assert::AreEqual(CanvasAlphaMode::Ignore, alphaMode);
                 return CanvasAnimatedControlFixture::CreateTestSwapChain(device);
@@ -331,7 +331,7 @@ TEST_CLASS(CanvasAnimatedControlTests)
         f.Adapter->DoChanged();
 
         f.Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(1,
-            [](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode)
+            [](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t)
             {
                 Assert::AreEqual(CanvasAlphaMode::Premultiplied, alphaMode);
                 return CanvasAnimatedControlFixture::CreateTestSwapChain(device);
@@ -1383,6 +1383,268 @@ TEST_CLASS(CanvasAnimatedControlTests)
         f.Adapter->Tick();
     }
 
+    TEST_METHOD_EX(CanvasAnimatedControl_FrameTimeStatistics_MeasureUpdateAndDraw)
+    {
+        UpdateRenderFixture f;
+        f.GetIntoSteadyState();
+
+        ThrowIfFailed(f.Control->ResetFrameTimeStatistics());
+
+        f.OnUpdate.SetExpectedCalls(1,
+            [&] (ICanvasAnimatedControl*, ICanvasAnimatedUpdateEventArgs*)
+            {
+                f.Adapter->ProgressTime(30000);
+                return S_OK;
+            });
+
+        f.OnDraw.SetExpectedCalls(1,
+            [&] (ICanvasAnimatedControl*, ICanvasAnimatedDrawEventArgs*)
+            {
+                f.Adapter->ProgressTime(TicksPerFrame * 2);
+                return S_OK;
+            });
+
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.RenderSingleFrame();
+
+        CanvasFrameTimeStatistics update;
+        ThrowIfFailed(f.Control->GetFrameTimeStatistics(CanvasFrameTimePhase::Update, &update));
+        Assert::AreEqual(1u, update.FrameCount);
+        Assert::AreEqual(30000LL, update.Maximum.Duration);
+
+        CanvasFrameTimeStatistics draw;
+        ThrowIfFailed(f.Control->GetFrameTimeStatistics(CanvasFrameTimePhase::Draw, &draw));
+        Assert::AreEqual(static_cast<INT64>(TicksPerFrame * 2), draw.Maximum.Duration);
+
+        CanvasFrameTimeStatistics frame;
+        ThrowIfFailed(f.Control->GetFrameTimeStatistics(CanvasFrameTimePhase::Frame, &frame));
+        Assert::AreEqual(static_cast<INT64>(30000 + TicksPerFrame * 2), frame.Maximum.Duration);
+
+        ComArray<UINT32> histogram;
+        ThrowIfFailed(f.Control->GetFrameTimeHistogram(CanvasFrameTimePhase::Frame, histogram.GetAddressOfSize(), histogram.GetAddressOfData()));
+        Assert::AreEqual(64u, histogram.GetSize());
+        Assert::AreEqual(1u, histogram[static_cast<uint32_t>((30000 + TicksPerFrame * 2) / 10000)]);
+
+        // The frame took more than one and a half target frames.
+        INT64 missedFrameCount;
+        ThrowIfFailed(f.Control->get_MissedFrameCount(&missedFrameCount));
+        Assert::AreEqual(1LL, missedFrameCount);
+
+        ThrowIfFailed(f.Control->ResetFrameTimeStatistics());
+
+        ThrowIfFailed(f.Control->GetFrameTimeStatistics(CanvasFrameTimePhase::Frame, &frame));
+        Assert::AreEqual(0u, frame.FrameCount);
+
+        ThrowIfFailed(f.Control->get_MissedFrameCount(&missedFrameCount));
+        Assert::AreEqual(0LL, missedFrameCount);
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_FrameTimeStatistics_NullArgs)
+    {
+        CanvasAnimatedControlFixture f;
+
+        UINT32 count;
+        UINT32* values;
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->GetFrameTimeStatistics(CanvasFrameTimePhase::Frame, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Control->GetFrameTimeHistogram(CanvasFrameTimePhase::Frame, nullptr, &values));
+        Assert::AreEqual(E_INVALIDARG, f.Control->GetFrameTimeHistogram(CanvasFrameTimePhase::Frame, &count, nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_MissedFrameCount(nullptr));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_FrameLatencyMode_Properties)
+    {
+        CanvasAnimatedControlFixture f;
+
+        CanvasFrameLatencyMode mode;
+        ThrowIfFailed(f.Control->get_FrameLatencyMode(&mode));
+        Assert::AreEqual(CanvasFrameLatencyMode::Default, mode);
+
+        ThrowIfFailed(f.Control->put_FrameLatencyMode(CanvasFrameLatencyMode::LowLatency));
+        ThrowIfFailed(f.Control->get_FrameLatencyMode(&mode));
+        Assert::AreEqual(CanvasFrameLatencyMode::LowLatency, mode);
+
+        Assert::AreEqual(E_INVALIDARG, f.Control->get_FrameLatencyMode(nullptr));
+        Assert::AreEqual(E_INVALIDARG, f.Control->put_FrameLatencyMode(static_cast<CanvasFrameLatencyMode>(2)));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_WhenFrameLatencyModeChanges_SwapChainIsRecreated)
+    {
+        UpdateRenderFixture f;
+        f.GetIntoSteadyState();
+
+        auto expectSwapChain = [&](uint32_t expectedMaximumFrameLatency)
+        {
+            f.Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(1,
+                [=](ICanvasDevice* device, float, float, float, CanvasAlphaMode, uint32_t maximumFrameLatency)
+                {
+                    Assert::AreEqual(expectedMaximumFrameLatency, maximumFrameLatency);
+
+                    return CanvasSwapChain::CreateNew(
+                        device,
+                        1.0f,
+                        1.0f,
+                        DEFAULT_DPI,
+                        PIXEL_FORMAT(B8G8R8A8UIntNormalized),
+                        2,
+                        CanvasAlphaMode::Premultiplied,
+                        maximumFrameLatency);
+                });
+        };
+
+        expectSwapChain(1);
+        ThrowIfFailed(f.Control->put_FrameLatencyMode(CanvasFrameLatencyMode::LowLatency));
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+        Expectations::Instance()->Validate();
+
+        expectSwapChain(0);
+        ThrowIfFailed(f.Control->put_FrameLatencyMode(CanvasFrameLatencyMode::Default));
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+        Expectations::Instance()->Validate();
+
+        // Setting the same mode again does nothing.
+        f.Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(0);
+        ThrowIfFailed(f.Control->put_FrameLatencyMode(CanvasFrameLatencyMode::Default));
+        f.Adapter->Tick();
+        f.Adapter->DoChanged();
+    }
+
+    struct FrameLatencyFixture : public UpdateRenderFixture
+    {
+        std::vector<std::wstring> Calls;
+
+        static const int64_t WaitTicks = 1000;
+        static const int64_t UpdateTicks = 2000;
+        static const int64_t DrawTicks = 4000;
+
+        FrameLatencyFixture(CanvasFrameLatencyMode mode)
+        {
+            ThrowIfFailed(Control->put_FrameLatencyMode(mode));
+            GetIntoSteadyState();
+
+            ThrowIfFailed(Control->ResetFrameTimeStatistics());
+
+            Adapter->m_waitForFrameLatencyFn =
+                [=](CanvasSwapChain* swapChain, DWORD)
+                {
+                    Assert::IsNotNull(swapChain);
+                    Assert::IsTrue(swapChain->GetMaximumFrameLatency() > 0);
+
+                    Calls.push_back(L"Wait");
+                    Adapter->ProgressTime(WaitTicks);
+                    return true;
+                };
+
+            OnUpdate.AllowAnyCall(
+                [=](ICanvasAnimatedControl*, ICanvasAnimatedUpdateEventArgs*)
+                {
+                    Calls.push_back(L"Update");
+                    Adapter->ProgressTime(UpdateTicks);
+                    return S_OK;
+                });
+
+            OnDraw.AllowAnyCall(
+                [=](ICanvasAnimatedControl*, ICanvasAnimatedDrawEventArgs*)
+                {
+                    Calls.push_back(L"Draw");
+                    Adapter->ProgressTime(DrawTicks);
+                    return S_OK;
+                });
+        }
+
+        INT64 GetMaximum(CanvasFrameTimePhase phase)
+        {
+            CanvasFrameTimeStatistics statistics;
+            ThrowIfFailed(Control->GetFrameTimeStatistics(phase, &statistics));
+            return statistics.Maximum.Duration;
+        }
+    };
+
+    TEST_METHOD_EX(CanvasAnimatedControl_LowLatencyMode_WaitsBeforeUpdate)
+    {
+        FrameLatencyFixture f(CanvasFrameLatencyMode::LowLatency);
+
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.RenderSingleFrame();
+
+        Assert::AreEqual<size_t>(3, f.Calls.size());
+        Assert::AreEqual(std::wstring(L"Wait"), f.Calls[0]);
+        Assert::AreEqual(std::wstring(L"Update"), f.Calls[1]);
+        Assert::AreEqual(std::wstring(L"Draw"), f.Calls[2]);
+
+        Assert::AreEqual(FrameLatencyFixture::WaitTicks, f.GetMaximum(CanvasFrameTimePhase::WaitForFrameLatency));
+
+        // Input latency doesn't include the wait.
+        Assert::AreEqual(FrameLatencyFixture::UpdateTicks + FrameLatencyFixture::DrawTicks, f.GetMaximum(CanvasFrameTimePhase::InputLatency));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_DefaultMode_DoesNotWaitForFrameLatency)
+    {
+        FrameLatencyFixture f(CanvasFrameLatencyMode::Default);
+
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.RenderSingleFrame();
+
+        Assert::AreEqual<size_t>(2, f.Calls.size());
+        Assert::AreEqual(std::wstring(L"Update"), f.Calls[0]);
+        Assert::AreEqual(std::wstring(L"Draw"), f.Calls[1]);
+
+        Assert::AreEqual(0LL, f.GetMaximum(CanvasFrameTimePhase::WaitForFrameLatency));
+        Assert::AreEqual(FrameLatencyFixture::UpdateTicks + FrameLatencyFixture::DrawTicks, f.GetMaximum(CanvasFrameTimePhase::InputLatency));
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_LowLatencyMode_WhenTickDoesNotDraw_WaitIsNotRepeated)
+    {
+        FrameLatencyFixture f(CanvasFrameLatencyMode::LowLatency);
+
+        // Not enough time has passed for a fixed step update, so nothing is
+        // drawn, but the loop has still waited for the next frame.
+        f.RenderSingleFrame();
+        f.RenderSingleFrame();
+
+        Assert::AreEqual<size_t>(1, f.Calls.size());
+        Assert::AreEqual(std::wstring(L"Wait"), f.Calls[0]);
+
+        // The frame that was waited for is used by the next draw.
+        f.Calls.clear();
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.RenderSingleFrame();
+
+        Assert::AreEqual<size_t>(2, f.Calls.size());
+        Assert::AreEqual(std::wstring(L"Update"), f.Calls[0]);
+        Assert::AreEqual(std::wstring(L"Draw"), f.Calls[1]);
+
+        // After presenting we wait again.
+        f.Calls.clear();
+        f.Adapter->ProgressTime(TicksPerFrame);
+        f.RenderSingleFrame();
+
+        Assert::AreEqual<size_t>(3, f.Calls.size());
+        Assert::AreEqual(std::wstring(L"Wait"), f.Calls[0]);
+    }
+
+    TEST_METHOD_EX(CanvasAnimatedControl_LowLatencyMode_WhenWaitTimesOut_WaitsAgainNextTick)
+    {
+        FrameLatencyFixture f(CanvasFrameLatencyMode::LowLatency);
+
+        int waitCount = 0;
+
+        f.Adapter->m_waitForFrameLatencyFn =
+            [&](CanvasSwapChain*, DWORD timeoutInMs)
+            {
+                Assert::IsTrue(timeoutInMs > 0 && timeoutInMs != INFINITE);
+                ++waitCount;
+                return false;
+            };
+
+        f.RenderSingleFrame();
+        f.RenderSingleFrame();
+
+        Assert::AreEqual(2, waitCount);
+    }
+
     TEST_METHOD_EX(CanvasAnimatedControl_WhenDeviceLost_DrawIsNotCalledUntilUpdateHasCompleted)
     {
         UpdateRenderFixture f;
@@ -2132,7 +2394,7 @@ TEST_CLASS(CanvasAnimatedControlChangedAction)
             CreateControl();
             
             Adapter->CreateCanvasSwapChainMethod.AllowAnyCall(
-                [=] (ICanvasDevice*, float, float, float, CanvasAlphaMode)
+                [=] (ICanvasDevice*, float, float, float, CanvasAlphaMode, uint32_t)
                 {
                     return Make<MockCanvasSwapChain>();
                 });
@@ -2235,7 +2497,7 @@ TEST_CLASS(CanvasAnimatedControlRenderLoop)
             CreateAdapter();
 
             Adapter->CreateCanvasSwapChainMethod.AllowAnyCall(
-                [=] (ICanvasDevice*, float, float, float, CanvasAlphaMode)
+                [=] (ICanvasDevice*, float, float, float, CanvasAlphaMode, uint32_t)
                 {
                     return SwapChain;
                 });
@@ -3379,10 +3641,10 @@ TEST_CLASS(CanvasAnimatedControl_DpiScaling)
         void ExpectCreateSwapChainWithDpi(float expectedDpi)
         {
             Adapter->CreateCanvasSwapChainMethod.SetExpectedCalls(1, 
-                [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode)
+                [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t)
                 {
                     StubCanvasDevice* stubDevice = static_cast<StubCanvasDevice*>(device); // Ensured by test construction
-                    stubDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode)
+                    stubDevice->CreateSwapChainForCompositionMethod.AllowAnyCall([=](int32_t, int32_t, DirectXPixelFormat, int32_t, CanvasAlphaMode, bool)
                     {
                         return m_dxgiSwapChain;
                     });
@@ -294,7 +294,7 @@ TEST_CLASS(CanvasSharedControlTests_InteractionWithRecreatableDeviceManager)
         void PrepareAdapter<CanvasAnimatedControlTraits>()
         {
             Adapter->CreateCanvasSwapChainMethod.AllowAnyCall(
-                [=] (ICanvasDevice*, float, float, float, CanvasAlphaMode)
+                [=] (ICanvasDevice*, float, float, float, CanvasAlphaMode, uint32_t)
                 { 
                     auto mockSwapChain = Make<MockCanvasSwapChain>();
                     mockSwapChain->CreateDrawingSessionMethod.AllowAnyCall(
@@ -24,12 +24,24 @@ std::shared_ptr<CanvasAnimatedControlTestAdapter> CreateAnimatedControlTestAdapt
         int32_t heightInPixels,
         DirectXPixelFormat format,
         int32_t bufferCount,
-        CanvasAlphaMode alphaMode)
+        CanvasAlphaMode alphaMode,
+        bool frameLatencyWaitable)
         {
             auto dxgiSwapChain = Make<StubDxgiSwapChain>();
 
             dxgiSwapChain->Present1Method.AllowAnyCall();
             dxgiSwapChain->SetMatrixTransformMethod.AllowAnyCall();
+
+            if (frameLatencyWaitable)
+            {
+                dxgiSwapChain->SetMaximumFrameLatencyMethod.AllowAnyCall();
+
+                dxgiSwapChain->GetFrameLatencyWaitableObjectMethod.AllowAnyCall(
+                    []
+                    {
+                        return CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+                    });
+            }
             
             dxgiSwapChain->GetDesc1Method.AllowAnyCall(
                 [=](DXGI_SWAP_CHAIN_DESC1* desc)
@@ -87,7 +99,7 @@ std::shared_ptr<CanvasAnimatedControlTestAdapter> CreateAnimatedControlTestAdapt
         });
 
     adapter->CreateCanvasSwapChainMethod.AllowAnyCall(
-        [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode)
+        [=](ICanvasDevice* device, float width, float height, float dpi, CanvasAlphaMode alphaMode, uint32_t maximumFrameLatency)
         {
             auto swapChain = CanvasSwapChain::CreateNew(
                 device,
@@ -96,7 +108,8 @@ std::shared_ptr<CanvasAnimatedControlTestAdapter> CreateAnimatedControlTestAdapt
                 DEFAULT_DPI,
                 PIXEL_FORMAT(B8G8R8A8UIntNormalized),
                 2,
-                CanvasAlphaMode::Premultiplied);
+                CanvasAlphaMode::Premultiplied,
+                maximumFrameLatency);
 
             return swapChain;
         });
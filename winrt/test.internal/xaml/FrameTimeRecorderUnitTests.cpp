@@ -0,0 +1,255 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#include "pch.h"
+
+#include <lib/xaml/FrameTimeRecorder.h>
+
+class FakeTimingAdapter : public ICanvasTimingAdapter
+{
+public:
+    int64_t Counter;
+
+    FakeTimingAdapter()
+        : Counter(0)
+    {
+    }
+
+    virtual int64_t GetPerformanceCounter() override
+    {
+        return Counter;
+    }
+
+    virtual int64_t GetPerformanceFrequency() override
+    {
+        return StepTimer::TicksPerSecond;
+    }
+};
+
+TEST_CLASS(FrameTimeRecorderTests)
+{
+    struct Fixture
+    {
+        std::shared_ptr<FakeTimingAdapter> Adapter;
+        FrameTimeRecorder Recorder;
+
+        Fixture()
+            : Adapter(std::make_shared<FakeTimingAdapter>())
+            , Recorder(Adapter)
+        {
+        }
+
+        void RecordFrame(uint32_t frameTicks, uint64_t targetTicks = 0)
+        {
+            FrameTimeRecorder::FrameTimes frameTimes{};
+            frameTimes[static_cast<uint32_t>(CanvasFrameTimePhase::Frame)] = frameTicks;
+            Recorder.Record(frameTimes, targetTicks);
+        }
+
+        CanvasFrameTimeStatistics GetFrameStatistics()
+        {
+            return Recorder.GetStatistics(CanvasFrameTimePhase::Frame);
+        }
+    };
+
+    TEST_METHOD_EX(FrameTimeRecorder_WhenNothingRecorded_StatisticsAreEmpty)
+    {
+        Fixture f;
+
+        auto statistics = f.GetFrameStatistics();
+
+        Assert::AreEqual(0u, statistics.FrameCount);
+        Assert::AreEqual(0LL, statistics.Average.Duration);
+        Assert::AreEqual(0LL, statistics.Maximum.Duration);
+
+        auto histogram = f.Recorder.GetHistogram(CanvasFrameTimePhase::Frame);
+        Assert::AreEqual<size_t>(FrameTimeRecorder::HistogramBucketCount, histogram.size());
+        Assert::IsTrue(std::all_of(histogram.begin(), histogram.end(), [](uint32_t count) { return count == 0; }));
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_Statistics_UseNearestRankPercentiles)
+    {
+        Fixture f;
+
+        // Recorded out of order, to check that they are sorted.
+        for (uint32_t i = 100; i >= 1; --i)
+            f.RecordFrame(i * 1000);
+
+        auto statistics = f.GetFrameStatistics();
+
+        Assert::AreEqual(100u, statistics.FrameCount);
+        Assert::AreEqual(50500LL, statistics.Average.Duration);
+        Assert::AreEqual(50000LL, statistics.Median.Duration);
+        Assert::AreEqual(95000LL, statistics.Percentile95.Duration);
+        Assert::AreEqual(99000LL, statistics.Percentile99.Duration);
+        Assert::AreEqual(100000LL, statistics.Maximum.Duration);
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_Statistics_SingleFrame)
+    {
+        Fixture f;
+
+        f.RecordFrame(1234);
+
+        auto statistics = f.GetFrameStatistics();
+
+        Assert::AreEqual(1u, statistics.FrameCount);
+        Assert::AreEqual(1234LL, statistics.Average.Duration);
+        Assert::AreEqual(1234LL, statistics.Median.Duration);
+        Assert::AreEqual(1234LL, statistics.Percentile99.Duration);
+        Assert::AreEqual(1234LL, statistics.Maximum.Duration);
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_Histogram_UsesOneMillisecondBuckets)
+    {
+        Fixture f;
+
+        auto const millisecond = static_cast<uint32_t>(FrameTimeRecorder::HistogramBucketWidth);
+
+        f.RecordFrame(0);
+        f.RecordFrame(millisecond - 1);
+        f.RecordFrame(millisecond);
+        f.RecordFrame(millisecond * 16 + 5);
+        f.RecordFrame(millisecond * 1000);   // overflows into the last bucket
+
+        auto histogram = f.Recorder.GetHistogram(CanvasFrameTimePhase::Frame);
+
+        Assert::AreEqual(2u, histogram[0]);
+        Assert::AreEqual(1u, histogram[1]);
+        Assert::AreEqual(1u, histogram[16]);
+        Assert::AreEqual(1u, histogram.back());
+
+        uint32_t total = 0;
+        for (auto count : histogram)
+            total += count;
+        Assert::AreEqual(5u, total);
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_OnlyTheMostRecentFramesAreKept)
+    {
+        Fixture f;
+
+        for (uint32_t i = 0; i < FrameTimeRecorder::Capacity * 2 + 10; ++i)
+            f.RecordFrame(i);
+
+        auto statistics = f.GetFrameStatistics();
+
+        Assert::AreEqual(FrameTimeRecorder::Capacity, statistics.FrameCount);
+        Assert::AreEqual(static_cast<INT64>(FrameTimeRecorder::Capacity * 2 + 9), statistics.Maximum.Duration);
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_Reset_HidesEarlierFramesAndMissedFrames)
+    {
+        Fixture f;
+
+        f.RecordFrame(1000, 100);
+        f.RecordFrame(2000, 100);
+        Assert::AreEqual(2ULL, f.Recorder.GetMissedFrameCount());
+
+        f.Recorder.Reset();
+
+        Assert::AreEqual(0u, f.GetFrameStatistics().FrameCount);
+        Assert::AreEqual(0ULL, f.Recorder.GetMissedFrameCount());
+
+        f.RecordFrame(50, 100);
+
+        auto statistics = f.GetFrameStatistics();
+        Assert::AreEqual(1u, statistics.FrameCount);
+        Assert::AreEqual(50LL, statistics.Maximum.Duration);
+        Assert::AreEqual(0ULL, f.Recorder.GetMissedFrameCount());
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_IsMissedFrame_WhenOverrunByMoreThanHalfAFrame)
+    {
+        Assert::IsFalse(FrameTimeRecorder::IsMissedFrame(100, 100));
+        Assert::IsFalse(FrameTimeRecorder::IsMissedFrame(150, 100));
+        Assert::IsTrue(FrameTimeRecorder::IsMissedFrame(151, 100));
+
+        // Without a target there is nothing to miss.
+        Assert::IsFalse(FrameTimeRecorder::IsMissedFrame(1000, 0));
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_Phases_AreMeasuredWithTheTimingAdapter)
+    {
+        Fixture f;
+
+        f.Recorder.BeginFrame();
+
+        f.Recorder.BeginPhase();
+        f.Adapter->Counter += 10;
+        f.Recorder.EndPhase(CanvasFrameTimePhase::Update);
+
+        f.Recorder.BeginPhase();
+        f.Adapter->Counter += 20;
+        f.Recorder.EndPhase(CanvasFrameTimePhase::Draw);
+
+        // A phase that runs more than once per frame accumulates.
+        f.Recorder.BeginPhase();
+        f.Adapter->Counter += 5;
+        f.Recorder.EndPhase(CanvasFrameTimePhase::Update);
+
+        f.Adapter->Counter += 100;
+        f.Recorder.EndFrame(1000);
+
+        Assert::AreEqual(15LL, f.Recorder.GetStatistics(CanvasFrameTimePhase::Update).Maximum.Duration);
+        Assert::AreEqual(20LL, f.Recorder.GetStatistics(CanvasFrameTimePhase::Draw).Maximum.Duration);
+        Assert::AreEqual(0LL, f.Recorder.GetStatistics(CanvasFrameTimePhase::Present).Maximum.Duration);
+        Assert::AreEqual(135LL, f.Recorder.GetStatistics(CanvasFrameTimePhase::Frame).Maximum.Duration);
+        Assert::AreEqual(0ULL, f.Recorder.GetMissedFrameCount());
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_InputLatencySpansPhases)
+    {
+        Fixture f;
+
+        f.Recorder.BeginFrame();
+
+        f.Recorder.BeginPhase();
+        f.Adapter->Counter += 10;
+        f.Recorder.EndPhase(CanvasFrameTimePhase::WaitForFrameLatency);
+
+        f.Recorder.BeginInputLatency();
+
+        f.Recorder.BeginPhase();
+        f.Adapter->Counter += 20;
+        f.Recorder.EndPhase(CanvasFrameTimePhase::Update);
+
+        f.Adapter->Counter += 5;
+
+        f.Recorder.BeginPhase();
+        f.Adapter->Counter += 30;
+        f.Recorder.EndPhase(CanvasFrameTimePhase::Present);
+
+        f.Recorder.EndInputLatency();
+
+        f.Adapter->Counter += 100;
+        f.Recorder.EndFrame(1000);
+
+        Assert::AreEqual(10LL, f.Recorder.GetStatistics(CanvasFrameTimePhase::WaitForFrameLatency).Maximum.Duration);
+        Assert::AreEqual(55LL, f.Recorder.GetStatistics(CanvasFrameTimePhase::InputLatency).Maximum.Duration);
+        Assert::AreEqual(165LL, f.Recorder.GetStatistics(CanvasFrameTimePhase::Frame).Maximum.Duration);
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_WhenFrameNotEnded_NothingIsRecorded)
+    {
+        Fixture f;
+
+        f.Recorder.BeginFrame();
+        f.Recorder.BeginPhase();
+        f.Adapter->Counter += 10;
+        f.Recorder.EndPhase(CanvasFrameTimePhase::Update);
+
+        Assert::AreEqual(0u, f.Recorder.GetStatistics(CanvasFrameTimePhase::Update).FrameCount);
+    }
+
+    TEST_METHOD_EX(FrameTimeRecorder_InvalidPhase_Throws)
+    {
+        Fixture f;
+
+        auto invalidPhase = static_cast<CanvasFrameTimePhase>(FrameTimeRecorder::PhaseCount);
+
+        ExpectHResultException(E_INVALIDARG, [&] { f.Recorder.GetStatistics(invalidPhase); });
+        ExpectHResultException(E_INVALIDARG, [&] { f.Recorder.GetHistogram(invalidPhase); });
+    }
+};
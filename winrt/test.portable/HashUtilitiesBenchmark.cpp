@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+//
+// Times SHA-1 over buffers the size of typical compiled pixel shaders, and
+// over one large buffer for raw throughput.  Not a pass/fail test, so ctest
+// doesn't run it.
+//
+
+#include "pch.h"
+#include "utils/HashUtilities.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+// Stops the optimizer discarding the hashes.
+static volatile BYTE g_checksum;
+
+int main()
+{
+    BYTE checksum = 0;
+
+    printf("SHA-1\n");
+
+    for (size_t size : { 512, 4096, 32768, 16 * 1024 * 1024 })
+    {
+        std::vector<BYTE> data(size);
+
+        for (auto& value : data)
+            value = static_cast<BYTE>(rand());
+
+        // Hash roughly 256MB in total at each size.
+        auto iterations = std::max<size_t>(4, (256 * 1024 * 1024) / size);
+
+        checksum ^= GetSha1Hash(data.data(), data.size())[0];
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (size_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            checksum ^= GetSha1Hash(data.data(), data.size())[0];
+        }
+
+        auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        printf("  %8zu bytes: %8.2fus per hash, %7.1fMB/s\n",
+            size,
+            seconds * 1e6 / iterations,
+            static_cast<double>(size) * iterations / seconds / (1024 * 1024));
+    }
+
+    static const IID namespaceId{ 0xA911588C, 0xDB0A, 0x41D2, { 0xAF, 0x64, 0xEB, 0xEC, 0x03, 0x72, 0x94, 0xD0 } };
+    const BYTE name[] = "Microsoft.Graphics.Canvas.Effects.PixelShaderEffect";
+    const int uuidIterations = 1000000;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int iteration = 0; iteration < uuidIterations; ++iteration)
+    {
+        checksum ^= static_cast<BYTE>(GetVersion5Uuid(namespaceId, name, sizeof(name)).Data1);
+    }
+
+    auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    printf("GetVersion5Uuid: %.0fns per call\n", seconds * 1e9 / uuidIterations);
+
+    g_checksum = checksum;
+
+    return 0;
+}
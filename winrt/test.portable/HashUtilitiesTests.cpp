@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+//
+// Known-answer tests for the SHA-1 and version 5 UUID code that
+// PixelShaderEffect uses to identify shaders.  test.internal keeps the
+// Version5UuidTest that runs against the Windows IID type.
+//
+
+#include "pch.h"
+#include "utils/HashUtilities.h"
+#include "TestRunner.h"
+
+#include <string>
+
+using namespace ABI::Microsoft::Graphics::Canvas;
+
+int g_failureCount = 0;
+
+static std::string ToHex(Sha1Hash const& hash)
+{
+    std::string result;
+
+    for (auto value : hash)
+    {
+        char digits[3];
+        snprintf(digits, sizeof(digits), "%02x", value);
+        result += digits;
+    }
+
+    return result;
+}
+
+static Sha1Hash HashString(std::string const& value)
+{
+    return GetSha1Hash(reinterpret_cast<BYTE const*>(value.data()), value.size());
+}
+
+
+static void Sha1_KnownAnswers()
+{
+    // Test vectors from FIPS 180 and RFC 3174.
+    CHECK(ToHex(HashString("")) == "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    CHECK(ToHex(HashString("abc")) == "a9993e364706816aba3e25717850c26c9cd0d89d");
+    CHECK(ToHex(HashString("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")) == "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+    CHECK(ToHex(HashString(std::string(1000000, 'a'))) == "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+
+    // Messages that leave exactly enough, and one byte too little, room for the length.
+    CHECK(ToHex(HashString(std::string(55, 'a'))) == "c1c8bbdc22796e28c0e15163d20899b65621d65a");
+    CHECK(ToHex(HashString(std::string(56, 'a'))) == "c2db330f6083854c99d4b5bfb6e8f29f201be699");
+
+    // Exactly one and two blocks.
+    CHECK(ToHex(HashString(std::string(64, 'a'))) == "0098ba824b5c16427bd7a1122a5a442a25ec644d");
+    CHECK(ToHex(HashString(std::string(128, 'a'))) == "ad5b3fdbcb526778c2839d2f151ea753995e26a0");
+}
+
+
+static void Sha1Hasher_GivesTheSameResultHoweverTheDataIsSplit()
+{
+    std::vector<BYTE> data(1000);
+
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<BYTE>(i * 7);
+    }
+
+    auto expected = GetSha1Hash(data.data(), data.size());
+
+    for (size_t pieceSize : { 1, 3, 63, 64, 65, 500 })
+    {
+        Sha1Hasher hasher;
+
+        for (size_t i = 0; i < data.size(); i += pieceSize)
+        {
+            hasher.Append(data.data() + i, std::min(pieceSize, data.size() - i));
+        }
+
+        CHECK(expected == hasher.Finish());
+    }
+}
+
+
+static void Version5Uuid_KnownAnswer()
+{
+    // The same vector as Version5UuidTest in test.internal.
+    static const IID salt{ 0xA911588C, 0xDB0A, 0x41D2, { 0xAF, 0x64, 0xEB, 0xEC, 0x03, 0x72, 0x94, 0xD0 } };
+    static const IID expected{ 0xC3091B3B, 0x5718, 0x5928, { 0x8C, 0xBF, 0x41, 0x29, 0x8E, 0xF7, 0xC6, 0x14 } };
+
+    const BYTE name[] = { 'H', 'e', 'l', 'l', 'o' };
+
+    auto result = GetVersion5Uuid(salt, name, sizeof(name));
+
+    CHECK(memcmp(&expected, &result, sizeof(IID)) == 0);
+}
+
+
+int main()
+{
+    Test const tests[] =
+    {
+        { "Sha1_KnownAnswers",                                  Sha1_KnownAnswers },
+        { "Sha1Hasher_GivesTheSameResultHoweverTheDataIsSplit", Sha1Hasher_GivesTheSameResultHoweverTheDataIsSplit },
+        { "Version5Uuid_KnownAnswer",                           Version5Uuid_KnownAnswer },
+    };
+
+    return RunTests(tests);
+}
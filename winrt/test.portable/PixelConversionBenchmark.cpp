@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+//
+// Times each kernel for each supported instruction set converting a 3840x2160
+// frame.  Not a pass/fail test, so ctest doesn't run it.
+//
+
+#include "pch.h"
+#include "utils/PixelConversion.h"
+
+#include <functional>
+
+using namespace ABI::Microsoft::Graphics::Canvas::PixelConversion;
+
+int main()
+{
+    const uint32_t width = 3840;
+    const uint32_t height = 2160;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    const int iterations = 20;
+
+    std::vector<uint8_t> source(pixelCount * 4);
+
+    for (auto& value : source)
+        value = static_cast<uint8_t>(rand());
+
+    std::vector<uint8_t> destination(source.size());
+
+    auto timeMilliseconds = [&](std::function<void(uint8_t const*, uint8_t*)> const& convert)
+    {
+        // Warm up, so the first iteration doesn't pay to fault in the pages.
+        convert(source.data(), destination.data());
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            convert(source.data(), destination.data());
+        }
+
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / iterations;
+    };
+
+    // The per-pixel loop that GetPixelColors used before these kernels.
+    auto perPixelLoop = [](uint8_t const* source, uint8_t* destination)
+    {
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            uint32_t pixel;
+            memcpy(&pixel, source + i * 4, 4);
+
+            destination[i * 4 + 0] = static_cast<uint8_t>(pixel >> 24);
+            destination[i * 4 + 1] = static_cast<uint8_t>(pixel >> 16);
+            destination[i * 4 + 2] = static_cast<uint8_t>(pixel >> 8);
+            destination[i * 4 + 3] = static_cast<uint8_t>(pixel);
+        }
+    };
+
+    printf("%ux%u, average of %d iterations\n", width, height, iterations);
+    printf("  per-pixel loop: %.2fms\n", timeMilliseconds(perPixelLoop));
+
+    static char const* const names[] = { "Scalar", "Sse2", "Avx2" };
+
+    for (auto instructionSet : { InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2 })
+    {
+        if (!IsSupported(instructionSet))
+            continue;
+
+        auto& kernels = GetKernels(instructionSet);
+
+        auto timeKernel = [&](void (*kernel)(uint8_t const*, uint8_t*, size_t))
+        {
+            return timeMilliseconds([=](uint8_t const* source, uint8_t* destination)
+            {
+                kernel(source, destination, pixelCount);
+            });
+        };
+
+        printf("  %-14s  swap %.2fms, premultiply %.2fms, unpremultiply %.2fms\n",
+            names[static_cast<int>(instructionSet)],
+            timeKernel(kernels.SwapByteOrder),
+            timeKernel(kernels.Premultiply),
+            timeKernel(kernels.Unpremultiply));
+    }
+
+    printf("  CopyRows:       %.2fms\n", timeMilliseconds([](uint8_t const* source, uint8_t* destination)
+    {
+        CopyRows(source, width * 4, destination, width * 4, width * 4, height);
+    }));
+
+    return 0;
+}
@@ -0,0 +1,351 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+//
+// Checks that every instruction set supported by this CPU gives exactly the
+// same results as the scalar kernels, and that the alpha kernels round
+// exactly for every color and alpha pair.
+//
+
+#include "pch.h"
+#include "utils/PixelConversion.h"
+#include "TestRunner.h"
+
+using namespace ABI::Microsoft::Graphics::Canvas::PixelConversion;
+
+int g_failureCount = 0;
+
+static char const* GetName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case InstructionSet::Scalar: return "Scalar";
+    case InstructionSet::Sse2:   return "Sse2";
+    case InstructionSet::Avx2:   return "Avx2";
+    default:                     return "Unknown";
+    }
+}
+
+static std::vector<InstructionSet> GetSupportedInstructionSets()
+{
+    std::vector<InstructionSet> result;
+
+    for (auto instructionSet : { InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2 })
+    {
+        if (IsSupported(instructionSet))
+            result.push_back(instructionSet);
+    }
+
+    return result;
+}
+
+static std::vector<uint8_t> MakeRandomPixels(size_t byteCount)
+{
+    std::vector<uint8_t> result(byteCount);
+
+    for (auto& value : result)
+        value = static_cast<uint8_t>(rand());
+
+    return result;
+}
+
+// One pixel for every combination of color and alpha, with the color value
+// placed in a different channel for each third of the pixels.
+static std::vector<uint8_t> MakeAllColorAlphaPairs()
+{
+    std::vector<uint8_t> pixels(256 * 256 * 4);
+
+    for (uint32_t alpha = 0; alpha < 256; ++alpha)
+    {
+        for (uint32_t color = 0; color < 256; ++color)
+        {
+            auto pixel = &pixels[(alpha * 256 + color) * 4];
+
+            pixel[0] = static_cast<uint8_t>(color);
+            pixel[1] = static_cast<uint8_t>(255 - color);
+            pixel[2] = static_cast<uint8_t>(color * 7);
+            pixel[3] = static_cast<uint8_t>(alpha);
+        }
+    }
+
+    return pixels;
+}
+
+static uint8_t ExpectedPremultiply(uint32_t color, uint32_t alpha)
+{
+    return static_cast<uint8_t>((color * alpha + 127) / 255);
+}
+
+static uint8_t ExpectedUnpremultiply(uint32_t color, uint32_t alpha)
+{
+    if (alpha == 0)
+        return 0;
+
+    return static_cast<uint8_t>(std::min(255.0, floor(color * 255.0 / alpha + 0.5)));
+}
+
+typedef void (*KernelFunction)(uint8_t const*, uint8_t*, size_t);
+
+static void VerifyAllColorAlphaPairs(
+    KernelFunction Kernels::* kernel,
+    uint8_t (*expected)(uint32_t, uint32_t))
+{
+    auto source = MakeAllColorAlphaPairs();
+    auto pixelCount = source.size() / 4;
+
+    for (auto instructionSet : GetSupportedInstructionSets())
+    {
+        // Offset the destination by one byte to exercise unaligned access.
+        std::vector<uint8_t> destination(source.size() + 1);
+
+        (GetKernels(instructionSet).*kernel)(source.data(), destination.data() + 1, pixelCount);
+
+        int mismatchCount = 0;
+
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            auto s = &source[i * 4];
+            auto d = &destination[i * 4 + 1];
+
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                if (d[channel] != expected(s[channel], s[3]) && mismatchCount++ < 10)
+                {
+                    printf("  %s: color %u, alpha %u gave %u\n",
+                        GetName(instructionSet), s[channel], s[3], d[channel]);
+                }
+            }
+
+            CHECK(s[3] == d[3]);
+        }
+
+        CHECK(mismatchCount == 0);
+    }
+}
+
+
+static void ScalarIsAlwaysSupported()
+{
+    CHECK(IsSupported(InstructionSet::Scalar));
+    CHECK(IsSupported(GetBestInstructionSet()));
+}
+
+
+static void SwapByteOrder_ReversesEachPixel()
+{
+    uint8_t const bgra[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t const expected[] = { 4, 3, 2, 1, 8, 7, 6, 5 };
+
+    for (auto instructionSet : GetSupportedInstructionSets())
+    {
+        uint8_t actual[8] = {};
+        GetKernels(instructionSet).SwapByteOrder(bgra, actual, 2);
+
+        CHECK(memcmp(expected, actual, sizeof(expected)) == 0);
+    }
+}
+
+
+static void SwapByteOrder_AllInstructionSetsMatchScalarForEveryLength()
+{
+    auto& reference = GetKernels(InstructionSet::Scalar);
+
+    // Lengths either side of the vector widths, so every tail is covered.
+    // The buffers are offset by one byte to exercise unaligned access.
+    for (size_t pixelCount = 0; pixelCount < 40; ++pixelCount)
+    {
+        auto source = MakeRandomPixels(pixelCount * 4 + 1);
+
+        std::vector<uint8_t> expected(source.size());
+        reference.SwapByteOrder(source.data() + 1, expected.data() + 1, pixelCount);
+
+        for (auto instructionSet : GetSupportedInstructionSets())
+        {
+            std::vector<uint8_t> actual(source.size());
+            GetKernels(instructionSet).SwapByteOrder(source.data() + 1, actual.data() + 1, pixelCount);
+
+            CHECK(expected == actual);
+
+            // Converting in place gives the same result.
+            auto inPlace = source;
+            GetKernels(instructionSet).SwapByteOrder(inPlace.data() + 1, inPlace.data() + 1, pixelCount);
+
+            CHECK(std::equal(expected.begin() + 1, expected.end(), inPlace.begin() + 1));
+        }
+    }
+}
+
+
+static void Premultiply_IsBitExactForAllColorAlphaPairs()
+{
+    VerifyAllColorAlphaPairs(&Kernels::Premultiply, ExpectedPremultiply);
+}
+
+
+static void Unpremultiply_IsBitExactForAllColorAlphaPairs()
+{
+    VerifyAllColorAlphaPairs(&Kernels::Unpremultiply, ExpectedUnpremultiply);
+}
+
+
+static void AlphaKernels_AllInstructionSetsMatchScalarForEveryLength()
+{
+    auto& reference = GetKernels(InstructionSet::Scalar);
+
+    for (size_t pixelCount = 0; pixelCount < 40; ++pixelCount)
+    {
+        auto source = MakeRandomPixels(pixelCount * 4 + 1);
+
+        for (auto kernel : { &Kernels::Premultiply, &Kernels::Unpremultiply })
+        {
+            std::vector<uint8_t> expected(source.size());
+            (reference.*kernel)(source.data() + 1, expected.data() + 1, pixelCount);
+
+            for (auto instructionSet : GetSupportedInstructionSets())
+            {
+                std::vector<uint8_t> actual(source.size());
+                (GetKernels(instructionSet).*kernel)(source.data() + 1, actual.data() + 1, pixelCount);
+
+                CHECK(expected == actual);
+
+                auto inPlace = source;
+                (GetKernels(instructionSet).*kernel)(inPlace.data() + 1, inPlace.data() + 1, pixelCount);
+
+                CHECK(std::equal(expected.begin() + 1, expected.end(), inPlace.begin() + 1));
+            }
+        }
+    }
+}
+
+
+static void Unpremultiply_ClearsTransparentPixels()
+{
+    uint8_t const source[] = { 10, 20, 30, 0 };
+
+    for (auto instructionSet : GetSupportedInstructionSets())
+    {
+        uint8_t actual[4] = { 0xCD, 0xCD, 0xCD, 0xCD };
+        GetKernels(instructionSet).Unpremultiply(source, actual, 1);
+
+        CHECK(actual[0] == 0 && actual[1] == 0 && actual[2] == 0 && actual[3] == 0);
+    }
+}
+
+
+static void SwapByteOrder_AllInstructionSetsMatchScalarForEveryPixelValue()
+{
+    // Each byte value appears in each channel of some pixel.
+    std::vector<uint8_t> source(256 * 4);
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        source[i * 4 + 0] = static_cast<uint8_t>(i);
+        source[i * 4 + 1] = static_cast<uint8_t>(i + 64);
+        source[i * 4 + 2] = static_cast<uint8_t>(i + 128);
+        source[i * 4 + 3] = static_cast<uint8_t>(i + 192);
+    }
+
+    std::vector<uint8_t> expected(source.size());
+    GetKernels(InstructionSet::Scalar).SwapByteOrder(source.data(), expected.data(), 256);
+
+    for (auto instructionSet : GetSupportedInstructionSets())
+    {
+        std::vector<uint8_t> actual(source.size());
+        GetKernels(instructionSet).SwapByteOrder(source.data(), actual.data(), 256);
+
+        if (expected != actual)
+            printf("  %s differs from Scalar\n", GetName(instructionSet));
+
+        CHECK(expected == actual);
+    }
+}
+
+
+static void CopyRows_HonorsStrides()
+{
+    auto source = MakeRandomPixels(16 * 10);
+    std::vector<uint8_t> destination(20 * 10, 0xCD);
+
+    CopyRows(source.data(), 16, destination.data(), 20, 12, 10);
+
+    for (int row = 0; row < 10; ++row)
+    {
+        CHECK(std::equal(source.begin() + row * 16, source.begin() + row * 16 + 12, destination.begin() + row * 20));
+        CHECK(std::all_of(destination.begin() + row * 20 + 12, destination.begin() + row * 20 + 20, [](uint8_t b) { return b == 0xCD; }));
+    }
+}
+
+
+static void CopyRows_ContiguousRows()
+{
+    auto source = MakeRandomPixels(16 * 10);
+    std::vector<uint8_t> destination(source.size());
+
+    CopyRows(source.data(), 16, destination.data(), 16, 16, 10);
+
+    CHECK(source == destination);
+}
+
+
+static void SwapByteOrderRows_HonorsStrides()
+{
+    auto source = MakeRandomPixels(28 * 5);
+    std::vector<uint8_t> destination(24 * 5, 0xCD);
+
+    SwapByteOrderRows(source.data(), 28, destination.data(), 24, 5, 5);
+
+    for (int row = 0; row < 5; ++row)
+    {
+        for (int x = 0; x < 5; ++x)
+        {
+            for (int b = 0; b < 4; ++b)
+            {
+                CHECK(source[row * 28 + x * 4 + 3 - b] == destination[row * 24 + x * 4 + b]);
+            }
+        }
+
+        CHECK(destination[row * 24 + 20] == 0xCD);
+    }
+}
+
+
+static void SwapByteOrderRows_ContiguousRowsMatchScalar()
+{
+    auto source = MakeRandomPixels(37 * 4 * 3);
+
+    std::vector<uint8_t> expected(source.size());
+    GetKernels(InstructionSet::Scalar).SwapByteOrder(source.data(), expected.data(), 37 * 3);
+
+    std::vector<uint8_t> actual(source.size());
+    SwapByteOrderRows(source.data(), 37 * 4, actual.data(), 37 * 4, 37, 3);
+
+    CHECK(expected == actual);
+}
+
+
+int main()
+{
+    Test const tests[] =
+    {
+        { "ScalarIsAlwaysSupported",                                      ScalarIsAlwaysSupported },
+        { "SwapByteOrder_ReversesEachPixel",                              SwapByteOrder_ReversesEachPixel },
+        { "SwapByteOrder_AllInstructionSetsMatchScalarForEveryLength",    SwapByteOrder_AllInstructionSetsMatchScalarForEveryLength },
+        { "SwapByteOrder_AllInstructionSetsMatchScalarForEveryPixelValue", SwapByteOrder_AllInstructionSetsMatchScalarForEveryPixelValue },
+        { "Premultiply_IsBitExactForAllColorAlphaPairs",                  Premultiply_IsBitExactForAllColorAlphaPairs },
+        { "Unpremultiply_IsBitExactForAllColorAlphaPairs",                Unpremultiply_IsBitExactForAllColorAlphaPairs },
+        { "AlphaKernels_AllInstructionSetsMatchScalarForEveryLength",     AlphaKernels_AllInstructionSetsMatchScalarForEveryLength },
+        { "Unpremultiply_ClearsTransparentPixels",                        Unpremultiply_ClearsTransparentPixels },
+        { "CopyRows_HonorsStrides",                                       CopyRows_HonorsStrides },
+        { "CopyRows_ContiguousRows",                                      CopyRows_ContiguousRows },
+        { "SwapByteOrderRows_HonorsStrides",                              SwapByteOrderRows_HonorsStrides },
+        { "SwapByteOrderRows_ContiguousRowsMatchScalar",                  SwapByteOrderRows_ContiguousRowsMatchScalar },
+    };
+
+    printf("Supported instruction sets:");
+    for (auto instructionSet : GetSupportedInstructionSets())
+        printf(" %s", GetName(instructionSet));
+    printf("\n");
+
+    return RunTests(tests);
+}
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//
+// Licensed under the MIT License. See LICENSE.txt in the project root for license information.
+
+#pragma once
+
+//
+// A minimal stand-in for the MSTest framework used by test.internal.  Each
+// test executable defines its tests as plain functions, checks conditions
+// with CHECK, and passes a table of them to RunTests from main.
+//
+
+extern int g_failureCount;
+
+#define CHECK(condition)                                                       \
+    do                                                                         \
+    {                                                                          \
+        if (!(condition))                                                      \
+        {                                                                      \
+            printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++g_failureCount;                                                  \
+        }                                                                      \
+    } while (false)
+
+struct Test
+{
+    char const* Name;
+    void (*Run)();
+};
+
+// Runs each test, printing PASS or FAIL, and returns the process exit code.
+template<size_t N>
+int RunTests(Test const (&tests)[N])
+{
+    for (auto& test : tests)
+    {
+        auto failuresBefore = g_failureCount;
+
+        test.Run();
+
+        printf("%s %s\n", g_failureCount == failuresBefore ? "PASS" : "FAIL", test.Name);
+    }
+
+    return g_failureCount == 0 ? 0 : 1;
+}